@@ -30,7 +30,7 @@ ezResult ezEditorProcessCommunicationChannel::StartClientProcess(const char* szP
   }
   else
   {
-    m_pChannel = ezIpcChannel::CreatePipeChannel(sMemName, ezIpcChannel::Mode::Server);
+    m_pChannel = ezIpcChannel::CreateSharedMemoryChannel(sMemName, ezIpcChannel::Mode::Server);
   }
   m_pProtocol = EZ_DEFAULT_NEW(ezIpcProcessMessageProtocol, m_pChannel.Borrow());
   m_pProtocol->m_MessageEvent.AddEventHandler(ezMakeDelegate(&ezProcessCommunicationChannel::MessageFunc, this));
@@ -165,6 +165,10 @@ ezStatus ezTextureAssetDocument::RunTexConv(const char* szTargetFile, const ezAs
   arguments << "-out";
   arguments << szTargetFile;
 
+  // lets TexConv reuse its outputs, when the same texture is transformed again with identical settings
+  arguments << "-cache";
+  arguments << QString::fromUtf8(ezOSFile::GetTempDataFolder("ezEditor/TexConvCache").GetData());
+
   const ezStringBuilder sThumbnail = GetThumbnailFilePath();
   if (bUpdateThumbnail)
   {
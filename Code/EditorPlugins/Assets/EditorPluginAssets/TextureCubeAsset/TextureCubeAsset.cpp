@@ -55,6 +55,9 @@ ezStatus ezTextureCubeAssetDocument::RunTexConv(const char* szTargetFile, const
   arguments << "-out";
   arguments << szTargetFile;
 
+  arguments << "-cache";
+  arguments << QString::fromUtf8(ezOSFile::GetTempDataFolder("ezEditor/TexConvCache").GetData());
+
   const ezStringBuilder sThumbnail = GetThumbnailFilePath();
   if (bUpdateThumbnail)
   {
@@ -17,6 +17,7 @@
 #include <Foundation/Time/Clock.h>
 #include <Foundation/Time/Stopwatch.h>
 #include <Foundation/Time/Timestamp.h>
+#include <Foundation/Utilities/Metrics.h>
 #include <Texture/Image/Image.h>
 
 ezGameApplicationBase* ezGameApplicationBase::s_pGameApplicationBaseInstance = nullptr;
@@ -545,6 +546,7 @@ void ezGameApplicationBase::Run_FinishFrame()
   ezTelemetry::PerFrameUpdate();
   ezResourceManager::PerFrameUpdate();
   ezTaskSystem::FinishFrameTasks();
+  ezMetrics::Snapshot();
   ezFrameAllocator::Swap();
   ezProfilingSystem::StartNewFrame();
 
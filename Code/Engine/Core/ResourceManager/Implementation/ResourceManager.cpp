@@ -495,6 +495,11 @@ void ezResourceManager::PerFrameUpdate()
     s_pState->m_ResourcesToUnloadOnMainThread.Clear();
   }
 
+  {
+    EZ_LOCK(s_ResourceMutex);
+    EZ_PROFILE_COUNTER("Resources/Loading Queue", s_pState->m_LoadingQueue.GetCount());
+  }
+
   if (s_pState->m_AutoFreeUnusedTimeout.IsPositive())
   {
     FreeUnusedResources(s_pState->m_AutoFreeUnusedTimeout, s_pState->m_AutoFreeUnusedThreshold);
@@ -2,11 +2,15 @@
 
 #include <Core/ResourceManager/Resource.h>
 #include <Core/ResourceManager/ResourceTypeLoader.h>
+#include <Foundation/Configuration/CVar.h>
 #include <Foundation/Containers/Blob.h>
 #include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/MemoryStream.h>
-#include <Foundation/IO/OSFile.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/System/SystemInformation.h>
+#include <Foundation/Threading/DelegateTask.h>
+
+ezCVarInt cvar_ResourcePrefetchFiles("Resource.PrefetchFiles", 1, ezCVarFlags::Default, "Whether upcoming resource files are read ahead of time: 0 = never, 1 = only on machines with multiple cores, 2 = always");
 
 struct FileResourceLoadData
 {
@@ -14,17 +18,39 @@ struct FileResourceLoadData
   ezRawMemoryStreamReader m_Reader;
 };
 
+ezResourceLoaderFromFile::ezResourceLoaderFromFile() = default;
+
+ezResourceLoaderFromFile::~ezResourceLoaderFromFile()
+{
+  // the resolve task accesses the prefetched files and starts reads, so it has to be done before the reader waits for those
+  ezTaskSystem::WaitForGroup(m_ResolveTaskGroup);
+
+  // a previous resolve task may still be about to return
+  EZ_LOCK(m_PrefetchMutex);
+}
+
 ezResourceLoadData ezResourceLoaderFromFile::OpenDataStream(const ezResource* pResource)
 {
   EZ_PROFILE_SCOPE("ReadResourceFile");
 
   ezResourceLoadData res;
 
+  ezUniquePtr<PrefetchedFile> pPrefetched;
   ezFileReader File;
-  if (File.Open(pResource->GetResourceID()).Failed())
-    return res;
 
-  res.m_sResourceDescription = File.GetFilePathRelative().GetData();
+  if (TakePrefetchedFile(pResource->GetResourceID(), pPrefetched).Succeeded())
+  {
+    res.m_sResourceDescription = pPrefetched->m_sDataDirRelativePath;
+  }
+  else
+  {
+    pPrefetched.Clear();
+
+    if (File.Open(pResource->GetResourceID()).Failed())
+      return res;
+
+    res.m_sResourceDescription = File.GetFilePathRelative().GetData();
+  }
 
 #if EZ_ENABLED(EZ_SUPPORTS_FILE_STATS)
   ezFileStats stat;
@@ -37,9 +63,10 @@ ezResourceLoadData ezResourceLoaderFromFile::OpenDataStream(const ezResource* pR
 
   FileResourceLoadData* pData = EZ_DEFAULT_NEW(FileResourceLoadData);
 
-  const ezUInt64 uiFileSize = File.GetFileSize();
+  const ezStringView sAbsolutePath = pPrefetched ? pPrefetched->m_sAbsolutePath.GetView() : File.GetFilePathAbsolute().GetView();
+  const ezUInt64 uiFileSize = pPrefetched ? pPrefetched->m_Data.GetCount() : File.GetFileSize();
 
-  const ezUInt64 uiBlobCapacity = uiFileSize + File.GetFilePathAbsolute().GetElementCount() + 8; // +8 for the string overhead
+  const ezUInt64 uiBlobCapacity = uiFileSize + sAbsolutePath.GetElementCount() + 8; // +8 for the string overhead
   pData->m_Storage.SetCountUninitialized(uiBlobCapacity);
 
   ezUInt8* pBlobPtr = pData->m_Storage.GetBlobPtr<ezUInt8>().GetPtr();
@@ -47,11 +74,18 @@ ezResourceLoadData ezResourceLoaderFromFile::OpenDataStream(const ezResource* pR
   ezRawMemoryStreamWriter w(pBlobPtr, uiBlobCapacity);
 
   // write the absolute path to the read file into the memory stream
-  w << File.GetFilePathAbsolute();
+  w << sAbsolutePath;
 
   const ezUInt64 uiOffset = w.GetNumWrittenBytes();
 
-  File.ReadBytes(pBlobPtr + uiOffset, uiFileSize);
+  if (pPrefetched)
+  {
+    ezMemoryUtils::Copy(pBlobPtr + uiOffset, pPrefetched->m_Data.GetData(), static_cast<size_t>(uiFileSize));
+  }
+  else
+  {
+    File.ReadBytes(pBlobPtr + uiOffset, uiFileSize);
+  }
 
   pData->m_Reader.Reset(pBlobPtr, w.GetNumWrittenBytes() + uiFileSize);
   res.m_pDataStream = &pData->m_Reader;
@@ -91,6 +125,141 @@ bool ezResourceLoaderFromFile::IsResourceOutdated(const ezResource* pResource) c
   return true;
 }
 
+void ezResourceLoaderFromFile::PrefetchData(ezArrayPtr<const ezString> resourceIDs)
+{
+  // on a single core nothing runs concurrently to the load worker, reading ahead then only adds the overhead of the async reads
+  const ezInt32 iPrefetchMode = cvar_ResourcePrefetchFiles;
+  if (iPrefetchMode <= 0 || (iPrefetchMode == 1 && ezSystemInformation::Get().GetCPUCoreCount() < 2))
+    return;
+
+  // limits the memory that is used for files that were read ahead of time
+  constexpr ezUInt32 uiMaxPrefetchedFiles = 64;
+
+  // resources that were removed from the loading queue never pick up their data
+  constexpr ezTime tMaxPrefetchAge = ezTime::MakeFromSeconds(10);
+
+  EZ_LOCK(m_PrefetchMutex);
+
+  const ezTime tNow = ezTime::Now();
+  for (auto it = m_PrefetchedFiles.GetIterator(); it.IsValid();)
+  {
+    if (it.Value()->m_bFinished && tNow - it.Value()->m_StartTime > tMaxPrefetchAge)
+      it = m_PrefetchedFiles.Remove(it);
+    else
+      ++it;
+  }
+
+  // the entries are added right away, so that nobody else starts reading the same files
+  for (const ezString& sResourceID : resourceIDs)
+  {
+    if (m_PrefetchedFiles.GetCount() >= uiMaxPrefetchedFiles)
+      break;
+
+    if (m_PrefetchedFiles.Contains(sResourceID))
+      continue;
+
+    ezUniquePtr<PrefetchedFile> pFile = EZ_DEFAULT_NEW(PrefetchedFile);
+    pFile->m_sResourceID = sResourceID;
+    pFile->m_StartTime = tNow;
+
+    m_FilesToResolve.PushBack(pFile.Borrow());
+    m_PrefetchedFiles.Insert(sResourceID, std::move(pFile));
+  }
+
+  // resolving the paths accesses the file system, which must not delay the load worker
+  if (!m_FilesToResolve.IsEmpty() && !m_bResolveTaskRunning)
+  {
+    m_bResolveTaskRunning = true;
+
+    ezSharedPtr<ezTask> pTask = EZ_DEFAULT_NEW(ezDelegateTask<void>, "ResolvePrefetchedFiles", ezTaskNesting::Never, ezMakeDelegate(&ezResourceLoaderFromFile::ResolvePrefetchedFiles, this));
+    m_ResolveTaskGroup = ezTaskSystem::StartSingleTask(pTask, ezTaskPriority::LongRunning);
+  }
+}
+
+void ezResourceLoaderFromFile::ResolvePrefetchedFiles()
+{
+  ezDynamicArray<PrefetchedFile*> files;
+  ezHybridArray<ezAsyncFileReadRequest, 32> requests;
+  ezStringBuilder sAbsolutePath, sRelativePath;
+
+  while (true)
+  {
+    {
+      EZ_LOCK(m_PrefetchMutex);
+
+      if (m_FilesToResolve.IsEmpty())
+      {
+        m_bResolveTaskRunning = false;
+        return;
+      }
+
+      files.Swap(m_FilesToResolve);
+    }
+
+    for (PrefetchedFile* pFile : files)
+    {
+      // Files in archives resolve to paths that don't exist, opening those fails right away and the file is read through ezFileReader as usual.
+      // This is cheaper than checking whether each file exists first.
+      if (ezFileSystem::ResolvePath(pFile->m_sResourceID, &sAbsolutePath, &sRelativePath).Failed())
+      {
+        EZ_LOCK(m_PrefetchMutex);
+        pFile->m_bFinished = true;
+        continue;
+      }
+
+      pFile->m_sAbsolutePath = sAbsolutePath;
+      pFile->m_sDataDirRelativePath = sRelativePath;
+
+      ezAsyncFileReadRequest& request = requests.ExpandAndGetRef();
+      request.m_sAbsolutePath = sAbsolutePath;
+      request.m_OnFinished = [this, pFile](ezAsyncFileReadResult& ref_result)
+      {
+        EZ_LOCK(m_PrefetchMutex);
+        pFile->m_Result = ref_result.m_Result;
+        pFile->m_Data = std::move(ref_result.m_Data);
+        pFile->m_bFinished = true;
+      };
+    }
+
+    if (!requests.IsEmpty())
+    {
+      m_PrefetchReader.ReadBatch(requests);
+    }
+
+    files.Clear();
+    requests.Clear();
+  }
+}
+
+ezResult ezResourceLoaderFromFile::TakePrefetchedFile(ezStringView sResourceID, ezUniquePtr<PrefetchedFile>& out_pFile)
+{
+  PrefetchedFile* pFile = nullptr;
+
+  {
+    EZ_LOCK(m_PrefetchMutex);
+
+    ezUniquePtr<PrefetchedFile>* pEntry = nullptr;
+    if (!m_PrefetchedFiles.TryGetValue(sResourceID, pEntry))
+      return EZ_FAILURE;
+
+    pFile = pEntry->Borrow();
+  }
+
+  // only wait for this file, not for the whole batch, entries that are still in flight are never removed by anyone else
+  ezTaskSystem::WaitForCondition([this, pFile]()
+    {
+      EZ_LOCK(m_PrefetchMutex);
+      return pFile->m_bFinished; });
+
+  EZ_LOCK(m_PrefetchMutex);
+
+  if (!m_PrefetchedFiles.Remove(sResourceID, &out_pFile))
+    return EZ_FAILURE;
+
+  // if the prefetch failed, the file is read again the usual way, which also takes care of the error handling
+  return out_pFile->m_Result;
+}
+
 //////////////////////////////////////////////////////////////////////////
 
 ezResourceLoadData ezResourceLoaderFromMemory::OpenDataStream(const ezResource* pResource)
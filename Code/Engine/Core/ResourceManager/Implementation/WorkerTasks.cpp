@@ -38,8 +38,18 @@ void ezResourceManagerWorkerDataLoad::Execute()
       pResourceToLoad->m_Flags.Remove(ezResourceFlags::HasCustomDataLoader);
       pResourceToLoad->m_Flags.Add(ezResourceFlags::PreventFileReload);
     }
+
+    GatherResourcesToPrefetch();
+  }
+
+  // the loaders can read the data of the next resources concurrently, while this one is loaded
+  for (PrefetchBatch& batch : m_PrefetchBatches)
+  {
+    batch.m_pLoader->PrefetchData(batch.m_ResourceIDs);
   }
 
+  m_PrefetchBatches.Clear();
+
   if (pLoader == nullptr)
     pLoader = ezResourceManager::GetResourceTypeLoader(pResourceToLoad->GetDynamicRTTI());
 
@@ -107,6 +117,49 @@ void ezResourceManagerWorkerDataLoad::Execute()
   }
 }
 
+void ezResourceManagerWorkerDataLoad::GatherResourcesToPrefetch()
+{
+  // how far the loaders may look ahead in the loading queue
+  constexpr ezUInt32 uiMaxResourcesToPrefetch = 32;
+
+  auto AddResource = [&](const ezResource* pResource)
+  {
+    ezResourceTypeLoader* pLoader = ezResourceManager::GetResourceTypeLoader(pResource->GetDynamicRTTI());
+
+    if (pLoader == nullptr)
+      pLoader = pResource->GetDefaultResourceTypeLoader();
+
+    if (pLoader == nullptr)
+      return;
+
+    PrefetchBatch* pBatch = nullptr;
+    for (PrefetchBatch& batch : m_PrefetchBatches)
+    {
+      if (batch.m_pLoader == pLoader)
+        pBatch = &batch;
+    }
+
+    if (pBatch == nullptr)
+    {
+      pBatch = &m_PrefetchBatches.ExpandAndGetRef();
+      pBatch->m_pLoader = pLoader;
+    }
+
+    pBatch->m_ResourceIDs.PushBack(pResource->GetResourceID());
+  };
+
+  // The resource that is loaded right now is not included, it is read directly, since prefetching it would only delay it.
+  // Resources with a custom loader have nothing to read ahead of time, since those loaders are only used once.
+  const auto& queue = ezResourceManager::s_pState->m_LoadingQueue;
+
+  for (ezUInt32 i = 0; i < ezMath::Min(queue.GetCount(), uiMaxResourcesToPrefetch); ++i)
+  {
+    if (!queue[i].m_pResource->m_Flags.IsSet(ezResourceFlags::HasCustomDataLoader))
+    {
+      AddResource(queue[i].m_pResource);
+    }
+  }
+}
 
 //////////////////////////////////////////////////////////////////////////
 
@@ -18,6 +18,17 @@ private:
   ezResourceManagerWorkerDataLoad();
 
   virtual void Execute() override;
+
+  /// \brief Collects the IDs of the next resources in the loading queue, grouped by their loader. Must be called with the resource mutex held.
+  void GatherResourcesToPrefetch();
+
+  struct PrefetchBatch
+  {
+    ezResourceTypeLoader* m_pLoader = nullptr;
+    ezHybridArray<ezString, 16> m_ResourceIDs;
+  };
+
+  ezHybridArray<PrefetchBatch, 2> m_PrefetchBatches;
 };
 
 /// \brief [internal] Worker task for uploading resource data.
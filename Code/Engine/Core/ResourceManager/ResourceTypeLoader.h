@@ -1,6 +1,8 @@
 #pragma once
 
 #include <Core/ResourceManager/Implementation/Declarations.h>
+#include <Foundation/Containers/HashTable.h>
+#include <Foundation/IO/AsyncFileReader.h>
 #include <Foundation/IO/MemoryStream.h>
 #include <Foundation/IO/Stream.h>
 #include <Foundation/Time/Timestamp.h>
@@ -53,6 +55,12 @@ public:
     EZ_IGNORE_UNUSED(pResource);
     return false;
   }
+
+  /// \brief Called with the IDs of resources that are going to be loaded with this loader soon.
+  ///
+  /// A loader can use this to start reading their data in the background, such that OpenDataStream() does not need to wait for it.
+  /// The default implementation does nothing.
+  virtual void PrefetchData(ezArrayPtr<const ezString> resourceIDs) { EZ_IGNORE_UNUSED(resourceIDs); }
 };
 
 /// \brief A default implementation of ezResourceTypeLoader for standard file loading.
@@ -60,12 +68,47 @@ public:
 /// The loader will interpret the ezResource 'resource ID' as a path, read that full file into a memory stream.
 /// The file modification data is stored as well.
 /// Resources that use this loader can update their data as if they were reading the file directly.
+///
+/// PrefetchData() reads the files of the upcoming resources concurrently with an ezAsyncFileReader, as long as they are plain files
+/// in a folder data directory. OpenDataStream() then only waits for the prefetched data, instead of reading the file itself.
+/// The paths are resolved by a separate task, so the calling load worker is not delayed. The cvar 'Resource.PrefetchFiles' controls
+/// whether files are prefetched at all, by default this is only done on machines with multiple cores.
 class EZ_CORE_DLL ezResourceLoaderFromFile : public ezResourceTypeLoader
 {
 public:
+  ezResourceLoaderFromFile();
+  ~ezResourceLoaderFromFile();
+
   virtual ezResourceLoadData OpenDataStream(const ezResource* pResource) override;
   virtual void CloseDataStream(const ezResource* pResource, const ezResourceLoadData& loaderData) override;
   virtual bool IsResourceOutdated(const ezResource* pResource) const override;
+  virtual void PrefetchData(ezArrayPtr<const ezString> resourceIDs) override;
+
+private:
+  struct PrefetchedFile
+  {
+    ezString m_sResourceID;
+    ezString m_sAbsolutePath;
+    ezString m_sDataDirRelativePath;
+    ezTime m_StartTime;
+    bool m_bFinished = false;
+    ezResult m_Result = EZ_FAILURE;
+    ezDynamicArray<ezUInt8> m_Data;
+  };
+
+  ezResult TakePrefetchedFile(ezStringView sResourceID, ezUniquePtr<PrefetchedFile>& out_pFile);
+  void ResolvePrefetchedFiles();
+
+  ezMutex m_PrefetchMutex;
+  ezHashTable<ezString, ezUniquePtr<PrefetchedFile>> m_PrefetchedFiles;
+
+  // files whose paths still need to be resolved by the resolve task, only one such task runs at a time
+  ezDynamicArray<PrefetchedFile*> m_FilesToResolve;
+  bool m_bResolveTaskRunning = false;
+  ezTaskGroupID m_ResolveTaskGroup;
+
+  // declared last, so that it waits for the reads in flight before the prefetched files are destroyed
+  ezAsyncFileReader m_PrefetchReader;
 };
 
 
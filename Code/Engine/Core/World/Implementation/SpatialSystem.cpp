@@ -47,6 +47,14 @@ void ezSpatialSystem::FindObjectsInBox(const ezBoundingBox& box, const QueryPara
     });
 }
 
+ezUInt64 ezSpatialSystem::GetChangeCounter(const ezBoundingBox& box, ezUInt32 uiCategoryBitmask) const
+{
+  EZ_IGNORE_UNUSED(box);
+  EZ_IGNORE_UNUSED(uiCategoryBitmask);
+
+  return m_uiFrameCounter;
+}
+
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
 void ezSpatialSystem::GetInternalStats(ezStringBuilder& ref_sSb) const
 {
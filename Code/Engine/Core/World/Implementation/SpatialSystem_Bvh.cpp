@@ -0,0 +1,1399 @@
+#include <Core/CorePCH.h>
+
+#include <Core/World/SpatialSystem_Bvh.h>
+#include <Foundation/Configuration/CVar.h>
+#include <Foundation/Profiling/Profiling.h>
+#include <Foundation/SimdMath/SimdConversion.h>
+#include <Foundation/System/SystemInformation.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Time/Stopwatch.h>
+
+ezCVarBool cvar_SpatialBvhParallelQueries("Spatial.Bvh.ParallelQueries", true, ezCVarFlags::Default, "Whether large visibility queries of the BVH spatial system are split into sub-trees that are processed in parallel");
+ezCVarFloat cvar_SpatialBvhRebuildThreshold("Spatial.Bvh.RebuildThreshold", 1.3f, ezCVarFlags::Default, "A BVH is rebuilt once the SAH cost of its refitted nodes exceeds the cost after the last build by this factor");
+
+namespace
+{
+  enum
+  {
+    EMPTY_CHILD = 0xFFFFFFFF,
+    LEAF_FLAG = 0x80000000,
+
+    NUM_SAH_BINS = 16,
+    MAX_SAH_DEPTH = 48,
+
+    // a tree needs at least this many objects before visibility queries are split into parallel sub-trees
+    MIN_DATA_FOR_PARALLEL_QUERY = 4096,
+    NUM_SUBTREES_PER_WORKER = 4,
+
+    MAX_NUM_TREES = (sizeof(ezSpatialData::Category::m_uiValue) * 8),
+  };
+
+  constexpr float s_fBvhEmptyMin = ezMath::MaxValue<float>();
+  constexpr float s_fBvhEmptyMax = -ezMath::MaxValue<float>();
+} // namespace
+
+struct ezSpatialSystem_Bvh::Node
+{
+  EZ_DECLARE_POD_TYPE();
+
+  // The bounds of the 4 children in SoA layout, so that they can be tested together.
+  // Empty slots have inverted bounds, which fail every overlap test.
+  float m_MinX[4];
+  float m_MinY[4];
+  float m_MinZ[4];
+  float m_MaxX[4];
+  float m_MaxY[4];
+  float m_MaxZ[4];
+
+  // Either EMPTY_CHILD, LEAF_FLAG | data index or the index of another node
+  ezUInt32 m_Children[4];
+
+  ezUInt32 m_uiParent;
+  ezUInt32 m_uiParentSlot;
+
+  void Clear(ezUInt32 uiParent, ezUInt32 uiParentSlot)
+  {
+    for (ezUInt32 i = 0; i < 4; ++i)
+    {
+      ClearSlot(i);
+    }
+
+    m_uiParent = uiParent;
+    m_uiParentSlot = uiParentSlot;
+  }
+
+  void ClearSlot(ezUInt32 uiSlot)
+  {
+    m_MinX[uiSlot] = m_MinY[uiSlot] = m_MinZ[uiSlot] = s_fBvhEmptyMin;
+    m_MaxX[uiSlot] = m_MaxY[uiSlot] = m_MaxZ[uiSlot] = s_fBvhEmptyMax;
+    m_Children[uiSlot] = EMPTY_CHILD;
+  }
+
+  ezBoundingBox GetSlotBox(ezUInt32 uiSlot) const
+  {
+    return ezBoundingBox::MakeFromMinMax(ezVec3(m_MinX[uiSlot], m_MinY[uiSlot], m_MinZ[uiSlot]), ezVec3(m_MaxX[uiSlot], m_MaxY[uiSlot], m_MaxZ[uiSlot]));
+  }
+
+  void SetSlotBox(ezUInt32 uiSlot, const ezBoundingBox& box)
+  {
+    m_MinX[uiSlot] = box.m_vMin.x;
+    m_MinY[uiSlot] = box.m_vMin.y;
+    m_MinZ[uiSlot] = box.m_vMin.z;
+    m_MaxX[uiSlot] = box.m_vMax.x;
+    m_MaxY[uiSlot] = box.m_vMax.y;
+    m_MaxZ[uiSlot] = box.m_vMax.z;
+  }
+
+  /// \brief Computes the bounds of all children. Empty slots don't contribute due to their inverted bounds.
+  ezBoundingBox ComputeBox() const
+  {
+    ezSimdVec4f minX, minY, minZ, maxX, maxY, maxZ;
+    minX.Load<4>(m_MinX);
+    minY.Load<4>(m_MinY);
+    minZ.Load<4>(m_MinZ);
+    maxX.Load<4>(m_MaxX);
+    maxY.Load<4>(m_MaxY);
+    maxZ.Load<4>(m_MaxZ);
+
+    const ezVec3 vMin(minX.HorizontalMin<4>(), minY.HorizontalMin<4>(), minZ.HorizontalMin<4>());
+    const ezVec3 vMax(maxX.HorizontalMax<4>(), maxY.HorizontalMax<4>(), maxZ.HorizontalMax<4>());
+    return ezBoundingBox::MakeFromMinMax(vMin, vMax);
+  }
+
+  bool IsEmpty() const
+  {
+    return (m_Children[0] & m_Children[1] & m_Children[2] & m_Children[3]) == EMPTY_CHILD;
+  }
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+struct ezSpatialSystem_Bvh::Tree
+{
+  Tree(ezSpatialSystem_Bvh& ref_system)
+    : m_System(ref_system)
+    , m_Nodes(&ref_system.m_Allocator)
+    , m_FreeNodes(&ref_system.m_Allocator)
+    , m_DataLocations(&ref_system.m_Allocator)
+    , m_AlwaysVisibleData(&ref_system.m_Allocator)
+  {
+  }
+
+  static EZ_ALWAYS_INLINE float GetSurfaceArea(const ezBoundingBox& box)
+  {
+    if (!box.IsValid())
+      return 0.0f;
+
+    const ezVec3 e = box.GetExtents();
+    return 2.0f * (e.x * e.y + e.y * e.z + e.z * e.x);
+  }
+
+  /// \brief The box that is stored in the tree. It has to enclose the bounding sphere as well, since the queries test against the sphere.
+  static ezBoundingBox GetTreeBox(const ezSimdBBoxSphere& bounds)
+  {
+    ezSimdBBox box = bounds.GetBox();
+    box.ExpandToInclude(ezSimdBBox::MakeFromCenterAndHalfExtents(bounds.m_CenterAndRadius, bounds.m_CenterAndRadius.Get<ezSwizzle::WWWW>()));
+
+    return ezSimdConversion::ToBBox(box);
+  }
+
+  ezUInt32 AllocateNode(ezUInt32 uiParent, ezUInt32 uiParentSlot)
+  {
+    ezUInt32 uiNodeIndex;
+    if (!m_FreeNodes.IsEmpty())
+    {
+      uiNodeIndex = m_FreeNodes.PeekBack();
+      m_FreeNodes.PopBack();
+    }
+    else
+    {
+      uiNodeIndex = m_Nodes.GetCount();
+      m_Nodes.ExpandAndGetRef();
+    }
+
+    m_Nodes[uiNodeIndex].Clear(uiParent, uiParentSlot);
+    return uiNodeIndex;
+  }
+
+  void SetSlot(ezUInt32 uiNodeIndex, ezUInt32 uiSlot, ezUInt32 uiChild, const ezBoundingBox& box)
+  {
+    Node& node = m_Nodes[uiNodeIndex];
+    node.m_Children[uiSlot] = uiChild;
+    node.SetSlotBox(uiSlot, box);
+
+    if (uiChild & LEAF_FLAG)
+    {
+      m_DataLocations[uiChild & ~LEAF_FLAG] = (uiNodeIndex << 2) | uiSlot;
+    }
+    else
+    {
+      m_Nodes[uiChild].m_uiParent = uiNodeIndex;
+      m_Nodes[uiChild].m_uiParentSlot = uiSlot;
+    }
+  }
+
+  /// \brief Propagates the bounds of the given node up to the root, which also shrinks them, and frees nodes that became empty.
+  void Refit(ezUInt32 uiNodeIndex)
+  {
+    while (uiNodeIndex != m_uiRootNode)
+    {
+      const Node& node = m_Nodes[uiNodeIndex];
+      const ezUInt32 uiParent = node.m_uiParent;
+      const ezUInt32 uiParentSlot = node.m_uiParentSlot;
+
+      if (node.IsEmpty())
+      {
+        m_Nodes[uiParent].ClearSlot(uiParentSlot);
+        m_FreeNodes.PushBack(uiNodeIndex);
+      }
+      else
+      {
+        const ezBoundingBox box = node.ComputeBox();
+
+        Node& parent = m_Nodes[uiParent];
+        if (parent.GetSlotBox(uiParentSlot) == box)
+          return;
+
+        parent.SetSlotBox(uiParentSlot, box);
+      }
+
+      uiNodeIndex = uiParent;
+    }
+  }
+
+  /// \brief Grows the bounds of the ancestors of the given node until they contain the given box.
+  ///
+  /// Bounds are never shrunk here, RebuildIfNecessary() takes care of that once the tree has degraded enough.
+  void Enlarge(ezUInt32 uiNodeIndex, const ezBoundingBox& box)
+  {
+    while (uiNodeIndex != m_uiRootNode)
+    {
+      const Node& node = m_Nodes[uiNodeIndex];
+      Node& parent = m_Nodes[node.m_uiParent];
+
+      ezBoundingBox slotBox = parent.GetSlotBox(node.m_uiParentSlot);
+      if (slotBox.Contains(box))
+        return;
+
+      slotBox.ExpandToInclude(box);
+      parent.SetSlotBox(node.m_uiParentSlot, slotBox);
+
+      uiNodeIndex = node.m_uiParent;
+    }
+  }
+
+  void Insert(ezUInt32 uiDataIndex, const ezBoundingBox& box)
+  {
+    if (uiDataIndex >= m_DataLocations.GetCount())
+    {
+      m_DataLocations.SetCount(uiDataIndex + 1, EMPTY_CHILD);
+    }
+
+    ++m_uiNumData;
+    ++m_uiNumChangesSinceBuild;
+    ++m_uiChangeCounter;
+
+    if (m_uiRootNode == EMPTY_CHILD)
+    {
+      m_uiRootNode = AllocateNode(EMPTY_CHILD, 0);
+    }
+
+    ezUInt32 uiNodeIndex = m_uiRootNode;
+    while (true)
+    {
+      const Node& node = m_Nodes[uiNodeIndex];
+
+      ezUInt32 uiBestSlot = 0;
+      float fBestGrowth = ezMath::MaxValue<float>();
+      float fBestArea = ezMath::MaxValue<float>();
+
+      for (ezUInt32 i = 0; i < 4; ++i)
+      {
+        if (node.m_Children[i] == EMPTY_CHILD)
+        {
+          SetSlot(uiNodeIndex, i, LEAF_FLAG | uiDataIndex, box);
+          Enlarge(uiNodeIndex, box);
+          return;
+        }
+
+        const ezBoundingBox slotBox = node.GetSlotBox(i);
+        ezBoundingBox mergedBox = slotBox;
+        mergedBox.ExpandToInclude(box);
+
+        const float fArea = GetSurfaceArea(slotBox);
+        const float fGrowth = GetSurfaceArea(mergedBox) - fArea;
+
+        if (fGrowth < fBestGrowth || (fGrowth == fBestGrowth && fArea < fBestArea))
+        {
+          uiBestSlot = i;
+          fBestGrowth = fGrowth;
+          fBestArea = fArea;
+        }
+      }
+
+      const ezUInt32 uiChild = node.m_Children[uiBestSlot];
+      if ((uiChild & LEAF_FLAG) == 0)
+      {
+        uiNodeIndex = uiChild;
+        continue;
+      }
+
+      // replace the leaf with a new node that holds both the old and the new data
+      const ezBoundingBox leafBox = node.GetSlotBox(uiBestSlot);
+      ezBoundingBox mergedBox = leafBox;
+      mergedBox.ExpandToInclude(box);
+
+      const ezUInt32 uiNewNodeIndex = AllocateNode(uiNodeIndex, uiBestSlot);
+      SetSlot(uiNewNodeIndex, 0, uiChild, leafBox);
+      SetSlot(uiNewNodeIndex, 1, LEAF_FLAG | uiDataIndex, box);
+      SetSlot(uiNodeIndex, uiBestSlot, uiNewNodeIndex, mergedBox);
+
+      Enlarge(uiNodeIndex, mergedBox);
+      return;
+    }
+  }
+
+  void Remove(ezUInt32 uiDataIndex)
+  {
+    const ezUInt32 uiLocation = m_DataLocations[uiDataIndex];
+    m_DataLocations[uiDataIndex] = EMPTY_CHILD;
+    --m_uiNumData;
+    ++m_uiNumChangesSinceBuild;
+    ++m_uiChangeCounter;
+
+    const ezUInt32 uiNodeIndex = uiLocation >> 2;
+    m_Nodes[uiNodeIndex].ClearSlot(uiLocation & 3);
+    Refit(uiNodeIndex);
+
+    if (m_uiNumData == 0)
+    {
+      // start from scratch, so that an emptied tree doesn't keep its nodes
+      m_Nodes.Clear();
+      m_FreeNodes.Clear();
+      m_uiRootNode = EMPTY_CHILD;
+      m_fCostAfterBuild = 0.0f;
+    }
+  }
+
+  void Update(ezUInt32 uiDataIndex, const ezBoundingBox& box)
+  {
+    const ezUInt32 uiLocation = m_DataLocations[uiDataIndex];
+    const ezUInt32 uiNodeIndex = uiLocation >> 2;
+
+    Node& node = m_Nodes[uiNodeIndex];
+    const ezBoundingBox oldBox = node.GetSlotBox(uiLocation & 3);
+
+    // counts as a change even if the tree is not touched below
+    ++m_uiChangeCounter;
+
+    // Moving data is stored with a margin of its last displacement, so that the following small movements don't touch the tree at all.
+    // The margin is limited relative to the size of the data, so that teleporting doesn't produce huge boxes.
+    if (oldBox.Contains(box))
+      return;
+
+    const ezVec3 vHalfExtents = box.GetHalfExtents();
+    const float fMargin = ezMath::Min((box.GetCenter() - oldBox.GetCenter()).GetLength(), 4.0f * ezMath::Max(vHalfExtents.x, vHalfExtents.y, vHalfExtents.z));
+
+    ezBoundingBox fatBox = box;
+    fatBox.Grow(ezVec3(fMargin));
+
+    node.SetSlotBox(uiLocation & 3, fatBox);
+    Enlarge(uiNodeIndex, fatBox);
+
+    ++m_uiNumChangesSinceBuild;
+  }
+
+  void InsertAlwaysVisible(ezUInt32 uiDataIndex)
+  {
+    m_AlwaysVisibleData.PushBack(uiDataIndex);
+    ++m_uiChangeCounter;
+  }
+
+  void RemoveAlwaysVisible(ezUInt32 uiDataIndex)
+  {
+    m_AlwaysVisibleData.RemoveAndSwap(uiDataIndex);
+    ++m_uiChangeCounter;
+  }
+
+  /// \brief The SAH cost of the tree, i.e. the summed surface area of all child bounds.
+  float ComputeCost() const
+  {
+    float fCost = 0.0f;
+    for (const Node& node : m_Nodes)
+    {
+      for (ezUInt32 i = 0; i < 4; ++i)
+      {
+        if (node.m_Children[i] != EMPTY_CHILD)
+        {
+          fCost += GetSurfaceArea(node.GetSlotBox(i));
+        }
+      }
+    }
+    return fCost;
+  }
+
+  /// \brief Rebuilds the tree if refitting and incremental inserts have degraded it too much.
+  void RebuildIfNecessary()
+  {
+    // checking the cost is linear in the number of nodes, so only do it once enough data has changed
+    if (m_uiNumChangesSinceBuild < ezMath::Max(m_uiNumData / 4, 64u))
+      return;
+
+    m_uiNumChangesSinceBuild = 0;
+
+    if (ComputeCost() > m_fCostAfterBuild * cvar_SpatialBvhRebuildThreshold.GetValue())
+    {
+      Rebuild();
+    }
+  }
+
+  struct BuildItem
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezBoundingBox m_Box;
+    ezVec3 m_vCentroid;
+    ezUInt32 m_uiDataIndex;
+  };
+
+  void Rebuild()
+  {
+    EZ_PROFILE_SCOPE("RebuildBvh");
+
+    ezDynamicArray<BuildItem> items;
+    items.Reserve(m_uiNumData);
+
+    for (ezUInt32 i = 0; i < m_DataLocations.GetCount(); ++i)
+    {
+      if (m_DataLocations[i] == EMPTY_CHILD)
+        continue;
+
+      BuildItem& item = items.ExpandAndGetRef();
+      item.m_Box = GetTreeBox(m_System.m_Bounds[i]);
+      item.m_vCentroid = item.m_Box.GetCenter();
+      item.m_uiDataIndex = i;
+    }
+
+    m_Nodes.Clear();
+    m_FreeNodes.Clear();
+    m_uiRootNode = EMPTY_CHILD;
+    m_uiNumChangesSinceBuild = 0;
+
+    if (!items.IsEmpty())
+    {
+      m_uiRootNode = AllocateNode(EMPTY_CHILD, 0);
+      BuildNode(m_uiRootNode, items, 0, items.GetCount(), 0);
+    }
+
+    m_fCostAfterBuild = ComputeCost();
+  }
+
+  void BuildNode(ezUInt32 uiNodeIndex, ezDynamicArray<BuildItem>& ref_items, ezUInt32 uiBegin, ezUInt32 uiEnd, ezUInt32 uiDepth)
+  {
+    if (uiEnd - uiBegin <= 4)
+    {
+      for (ezUInt32 i = uiBegin; i < uiEnd; ++i)
+      {
+        SetSlot(uiNodeIndex, i - uiBegin, LEAF_FLAG | ref_items[i].m_uiDataIndex, ref_items[i].m_Box);
+      }
+      return;
+    }
+
+    // split twice to get the ranges for the 4 children
+    ezUInt32 ranges[5];
+    ranges[0] = uiBegin;
+    ranges[2] = Split(ref_items, uiBegin, uiEnd, uiDepth);
+    ranges[4] = uiEnd;
+    ranges[1] = (ranges[2] - ranges[0] > 1) ? Split(ref_items, ranges[0], ranges[2], uiDepth) : ranges[2];
+    ranges[3] = (ranges[4] - ranges[2] > 1) ? Split(ref_items, ranges[2], ranges[4], uiDepth) : ranges[4];
+
+    ezUInt32 uiSlot = 0;
+    for (ezUInt32 r = 0; r < 4; ++r)
+    {
+      const ezUInt32 uiRangeBegin = ranges[r];
+      const ezUInt32 uiRangeEnd = ranges[r + 1];
+
+      if (uiRangeBegin == uiRangeEnd)
+        continue;
+
+      if (uiRangeEnd - uiRangeBegin == 1)
+      {
+        SetSlot(uiNodeIndex, uiSlot, LEAF_FLAG | ref_items[uiRangeBegin].m_uiDataIndex, ref_items[uiRangeBegin].m_Box);
+      }
+      else
+      {
+        ezBoundingBox box = ezBoundingBox::MakeInvalid();
+        for (ezUInt32 i = uiRangeBegin; i < uiRangeEnd; ++i)
+        {
+          box.ExpandToInclude(ref_items[i].m_Box);
+        }
+
+        // allocating may move the nodes in memory, so don't hold on to references
+        const ezUInt32 uiChildIndex = AllocateNode(uiNodeIndex, uiSlot);
+        SetSlot(uiNodeIndex, uiSlot, uiChildIndex, box);
+        BuildNode(uiChildIndex, ref_items, uiRangeBegin, uiRangeEnd, uiDepth + 1);
+      }
+
+      ++uiSlot;
+    }
+  }
+
+  /// \brief Partitions the given range with a binned SAH along the longest centroid axis and returns the split position.
+  static ezUInt32 Split(ezDynamicArray<BuildItem>& ref_items, ezUInt32 uiBegin, ezUInt32 uiEnd, ezUInt32 uiDepth)
+  {
+    ezBoundingBox centroidBox = ezBoundingBox::MakeInvalid();
+    for (ezUInt32 i = uiBegin; i < uiEnd; ++i)
+    {
+      centroidBox.ExpandToInclude(ref_items[i].m_vCentroid);
+    }
+
+    const ezVec3 vExtents = centroidBox.GetExtents();
+    const ezUInt32 uiAxis = (vExtents.x >= vExtents.y && vExtents.x >= vExtents.z) ? 0 : (vExtents.y >= vExtents.z ? 1 : 2);
+    const float fMin = centroidBox.m_vMin.GetData()[uiAxis];
+    const float fExtent = vExtents.GetData()[uiAxis];
+
+    const ezUInt32 uiMedian = uiBegin + (uiEnd - uiBegin) / 2;
+
+    // all centroids at the same position
+    if (fExtent <= 0.0f)
+      return uiMedian;
+
+    auto GetBin = [&](const BuildItem& item)
+    {
+      const float f = (item.m_vCentroid.GetData()[uiAxis] - fMin) * (NUM_SAH_BINS / fExtent);
+      return ezMath::Min(static_cast<ezUInt32>(f), static_cast<ezUInt32>(NUM_SAH_BINS - 1));
+    };
+
+    ezUInt32 uiSplitBin = NUM_SAH_BINS;
+
+    // very deep trees are a sign of degenerated input, fall back to median splits to bound the recursion
+    if (uiDepth < MAX_SAH_DEPTH)
+    {
+      ezBoundingBox binBoxes[NUM_SAH_BINS];
+      ezUInt32 binCounts[NUM_SAH_BINS] = {};
+      for (ezUInt32 b = 0; b < NUM_SAH_BINS; ++b)
+      {
+        binBoxes[b] = ezBoundingBox::MakeInvalid();
+      }
+
+      for (ezUInt32 i = uiBegin; i < uiEnd; ++i)
+      {
+        const ezUInt32 uiBin = GetBin(ref_items[i]);
+        binBoxes[uiBin].ExpandToInclude(ref_items[i].m_Box);
+        ++binCounts[uiBin];
+      }
+
+      // sweep from the right to get the cost of everything after each split
+      float rightCosts[NUM_SAH_BINS];
+      {
+        ezBoundingBox box = ezBoundingBox::MakeInvalid();
+        ezUInt32 uiCount = 0;
+        for (ezUInt32 b = NUM_SAH_BINS; b-- > 1;)
+        {
+          box.ExpandToInclude(binBoxes[b]);
+          uiCount += binCounts[b];
+          rightCosts[b] = GetSurfaceArea(box) * uiCount;
+        }
+      }
+
+      ezBoundingBox leftBox = ezBoundingBox::MakeInvalid();
+      ezUInt32 uiLeftCount = 0;
+      float fBestCost = ezMath::MaxValue<float>();
+
+      for (ezUInt32 b = 0; b < NUM_SAH_BINS - 1; ++b)
+      {
+        leftBox.ExpandToInclude(binBoxes[b]);
+        uiLeftCount += binCounts[b];
+
+        if (uiLeftCount == 0 || uiLeftCount == uiEnd - uiBegin)
+          continue;
+
+        const float fCost = GetSurfaceArea(leftBox) * uiLeftCount + rightCosts[b + 1];
+        if (fCost < fBestCost)
+        {
+          fBestCost = fCost;
+          uiSplitBin = b + 1;
+        }
+      }
+    }
+
+    if (uiSplitBin == NUM_SAH_BINS)
+    {
+      ezArrayPtr<BuildItem> range = ref_items.GetArrayPtr().GetSubArray(uiBegin, uiEnd - uiBegin);
+      ezSorting::QuickSort(range, [&](const BuildItem& a, const BuildItem& b)
+        { return a.m_vCentroid.GetData()[uiAxis] < b.m_vCentroid.GetData()[uiAxis]; });
+
+      return uiMedian;
+    }
+
+    ezUInt32 uiMid = uiBegin;
+    for (ezUInt32 i = uiBegin; i < uiEnd; ++i)
+    {
+      if (GetBin(ref_items[i]) < uiSplitBin)
+      {
+        ezMath::Swap(ref_items[i], ref_items[uiMid]);
+        ++uiMid;
+      }
+    }
+
+    return uiMid;
+  }
+
+  ezSpatialSystem_Bvh& m_System;
+
+  ezDynamicArray<Node> m_Nodes;
+  ezDynamicArray<ezUInt32> m_FreeNodes;
+  ezUInt32 m_uiRootNode = EMPTY_CHILD;
+
+  // Indexed by data index, (node index << 2) | slot
+  ezDynamicArray<ezUInt32> m_DataLocations;
+  ezDynamicArray<ezUInt32> m_AlwaysVisibleData;
+
+  ezUInt32 m_uiNumData = 0;
+  ezUInt32 m_uiNumChangesSinceBuild = 0;
+  float m_fCostAfterBuild = 0.0f;
+
+  // Incremented whenever data is added, removed or moved, unlike m_uiNumChangesSinceBuild it is never reset.
+  ezUInt32 m_uiChangeCounter = 0;
+};
+
+template <typename Functor>
+EZ_FORCE_INLINE void ezSpatialSystem_Bvh::ForEachTree(ezUInt32 uiCategoryBitmask, Functor func) const
+{
+  while (uiCategoryBitmask > 0)
+  {
+    const ezUInt32 uiTreeIndex = ezMath::FirstBitLow(uiCategoryBitmask);
+    uiCategoryBitmask &= uiCategoryBitmask - 1;
+
+    Tree* pTree = m_Trees[uiTreeIndex].Borrow();
+    if (pTree == nullptr)
+      continue;
+
+    if (func(*pTree) == ezVisitorExecution::Stop)
+      break;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace ezInternal
+{
+  struct BvhQueryHelper
+  {
+    using Node = ezSpatialSystem_Bvh::Node;
+    using Tree = ezSpatialSystem_Bvh::Tree;
+
+    struct Stats
+    {
+      ezUInt32 m_uiNumObjectsTested = 0;
+      ezUInt32 m_uiNumObjectsPassed = 0;
+
+      void operator+=(const Stats& other)
+      {
+        m_uiNumObjectsTested += other.m_uiNumObjectsTested;
+        m_uiNumObjectsPassed += other.m_uiNumObjectsPassed;
+      }
+    };
+
+    struct StackEntry
+    {
+      EZ_DECLARE_POD_TYPE();
+
+      ezUInt32 m_uiNodeIndex;
+      bool m_bInside;
+    };
+
+    struct NodeBounds
+    {
+      ezSimdVec4f m_MinX, m_MinY, m_MinZ;
+      ezSimdVec4f m_MaxX, m_MaxY, m_MaxZ;
+
+      EZ_ALWAYS_INLINE explicit NodeBounds(const Node& node)
+      {
+        m_MinX.Load<4>(node.m_MinX);
+        m_MinY.Load<4>(node.m_MinY);
+        m_MinZ.Load<4>(node.m_MinZ);
+        m_MaxX.Load<4>(node.m_MaxX);
+        m_MaxY.Load<4>(node.m_MaxY);
+        m_MaxZ.Load<4>(node.m_MaxZ);
+      }
+    };
+
+    static EZ_ALWAYS_INLINE ezUInt32 ToMask(const ezSimdVec4b& v)
+    {
+      const ezSimdVec4f bits = ezSimdVec4f::Select(v, ezSimdVec4f(1.0f, 2.0f, 4.0f, 8.0f), ezSimdVec4f::MakeZero());
+      return static_cast<ezUInt32>(static_cast<float>(bits.HorizontalSum<4>()));
+    }
+
+    static EZ_ALWAYS_INLINE ezSimdBBox GetSlotBox(const Node& node, ezUInt32 uiSlot)
+    {
+      return ezSimdBBox(ezSimdVec4f(node.m_MinX[uiSlot], node.m_MinY[uiSlot], node.m_MinZ[uiSlot]), ezSimdVec4f(node.m_MaxX[uiSlot], node.m_MaxY[uiSlot], node.m_MaxZ[uiSlot]));
+    }
+
+    static EZ_ALWAYS_INLINE bool FilterByTags(const ezTagSet& tags, const ezTagSet* pIncludeTags, const ezTagSet* pExcludeTags)
+    {
+      if (pExcludeTags != nullptr && !pExcludeTags->IsEmpty() && pExcludeTags->IsAnySet(tags))
+        return true;
+
+      if (pIncludeTags != nullptr && !pIncludeTags->IsEmpty() && !pIncludeTags->IsAnySet(tags))
+        return true;
+
+      return false;
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Shape queries
+
+    struct BoxOverlap
+    {
+      ezSimdBBox m_Shape;
+      ezSimdVec4f m_MinX, m_MinY, m_MinZ;
+      ezSimdVec4f m_MaxX, m_MaxY, m_MaxZ;
+
+      explicit BoxOverlap(const ezSimdBBox& box)
+        : m_Shape(box)
+      {
+        m_MinX = box.m_Min.Get<ezSwizzle::XXXX>();
+        m_MinY = box.m_Min.Get<ezSwizzle::YYYY>();
+        m_MinZ = box.m_Min.Get<ezSwizzle::ZZZZ>();
+        m_MaxX = box.m_Max.Get<ezSwizzle::XXXX>();
+        m_MaxY = box.m_Max.Get<ezSwizzle::YYYY>();
+        m_MaxZ = box.m_Max.Get<ezSwizzle::ZZZZ>();
+      }
+
+      EZ_ALWAYS_INLINE ezUInt32 TestChildren(const NodeBounds& b) const
+      {
+        const ezSimdVec4b overlapX = (b.m_MinX <= m_MaxX) && (b.m_MaxX >= m_MinX);
+        const ezSimdVec4b overlapY = (b.m_MinY <= m_MaxY) && (b.m_MaxY >= m_MinY);
+        const ezSimdVec4b overlapZ = (b.m_MinZ <= m_MaxZ) && (b.m_MaxZ >= m_MinZ);
+        return ToMask(overlapX && overlapY && overlapZ);
+      }
+    };
+
+    struct SphereOverlap
+    {
+      ezSimdBSphere m_Shape;
+      ezSimdVec4f m_X, m_Y, m_Z, m_RadiusSquared;
+
+      explicit SphereOverlap(const ezSimdBSphere& sphere)
+        : m_Shape(sphere)
+      {
+        m_X = sphere.m_CenterAndRadius.Get<ezSwizzle::XXXX>();
+        m_Y = sphere.m_CenterAndRadius.Get<ezSwizzle::YYYY>();
+        m_Z = sphere.m_CenterAndRadius.Get<ezSwizzle::ZZZZ>();
+
+        const ezSimdVec4f r = sphere.m_CenterAndRadius.Get<ezSwizzle::WWWW>();
+        m_RadiusSquared = r.CompMul(r);
+      }
+
+      EZ_ALWAYS_INLINE ezUInt32 TestChildren(const NodeBounds& b) const
+      {
+        const ezSimdVec4f zero = ezSimdVec4f::MakeZero();
+
+        // distance from the sphere center to the closest point of each box
+        const ezSimdVec4f dx = (b.m_MinX - m_X).CompMax(m_X - b.m_MaxX).CompMax(zero);
+        const ezSimdVec4f dy = (b.m_MinY - m_Y).CompMax(m_Y - b.m_MaxY).CompMax(zero);
+        const ezSimdVec4f dz = (b.m_MinZ - m_Z).CompMax(m_Z - b.m_MaxZ).CompMax(zero);
+
+        const ezSimdVec4f distSquared = ezSimdVec4f::MulAdd(dx, dx, ezSimdVec4f::MulAdd(dy, dy, dz.CompMul(dz)));
+        return ToMask(distSquared <= m_RadiusSquared);
+      }
+    };
+
+    template <typename Overlap, bool UseTagsFilter>
+    static ezVisitorExecution::Enum ShapeQuery(const ezSpatialSystem_Bvh& system, const Tree& tree, const Overlap& overlap, const ezSpatialSystem::QueryParams& queryParams, ezSpatialSystem::QueryCallback& callback, Stats& ref_stats)
+    {
+      for (ezUInt32 uiDataIndex : tree.m_AlwaysVisibleData)
+      {
+        ezVisitorExecution::Enum res = AddShapeQueryResult<UseTagsFilter>(system, uiDataIndex, queryParams, callback, ref_stats);
+        if (res == ezVisitorExecution::Stop)
+          return res;
+      }
+
+      if (tree.m_uiRootNode == EMPTY_CHILD)
+        return ezVisitorExecution::Continue;
+
+      ezHybridArray<ezUInt32, 64> stack;
+      stack.PushBack(tree.m_uiRootNode);
+
+      while (!stack.IsEmpty())
+      {
+        const Node& node = tree.m_Nodes[stack.PeekBack()];
+        stack.PopBack();
+
+        ezUInt32 uiMask = overlap.TestChildren(NodeBounds(node));
+        while (uiMask > 0)
+        {
+          const ezUInt32 uiSlot = ezMath::FirstBitLow(uiMask);
+          uiMask &= uiMask - 1;
+
+          const ezUInt32 uiChild = node.m_Children[uiSlot];
+          if ((uiChild & LEAF_FLAG) == 0)
+          {
+            stack.PushBack(uiChild);
+            continue;
+          }
+
+          const ezUInt32 uiDataIndex = uiChild & ~LEAF_FLAG;
+          ++ref_stats.m_uiNumObjectsTested;
+
+          if (!overlap.m_Shape.Overlaps(system.m_Bounds[uiDataIndex].GetSphere()))
+            continue;
+
+          if (AddShapeQueryResult<UseTagsFilter>(system, uiDataIndex, queryParams, callback, ref_stats) == ezVisitorExecution::Stop)
+            return ezVisitorExecution::Stop;
+        }
+      }
+
+      return ezVisitorExecution::Continue;
+    }
+
+    template <bool UseTagsFilter>
+    EZ_FORCE_INLINE static ezVisitorExecution::Enum AddShapeQueryResult(const ezSpatialSystem_Bvh& system, ezUInt32 uiDataIndex, const ezSpatialSystem::QueryParams& queryParams, ezSpatialSystem::QueryCallback& callback, Stats& ref_stats)
+    {
+      if constexpr (UseTagsFilter)
+      {
+        if (FilterByTags(system.m_TagSets[uiDataIndex], queryParams.m_pIncludeTags, queryParams.m_pExcludeTags))
+          return ezVisitorExecution::Continue;
+      }
+
+      ref_stats.m_uiNumObjectsPassed++;
+      return callback(system.m_ObjectPointers[uiDataIndex]);
+    }
+
+    // Unlike FindVisibleObjects, box and sphere queries are not split into parallel sub-tree traversals.
+    // The callback may stop the query at any object and callers rely on it being invoked serially on the calling thread.
+    // Gathering in parallel first would visit the whole region even if the callback stops at the first object,
+    // and these queries usually cover small regions with few results, where the task overhead would dominate.
+    template <typename Overlap>
+    static void FindObjectsInShape(const ezSpatialSystem_Bvh& system, const Overlap& overlap, const ezSpatialSystem::QueryParams& queryParams, ezSpatialSystem::QueryCallback& callback)
+    {
+      const bool useTagsFilter = (queryParams.m_pIncludeTags && queryParams.m_pIncludeTags->IsEmpty() == false) || (queryParams.m_pExcludeTags && queryParams.m_pExcludeTags->IsEmpty() == false);
+
+      Stats stats;
+      system.ForEachTree(queryParams.m_uiCategoryBitmask, [&](const Tree& tree)
+        {
+          if (useTagsFilter)
+            return ShapeQuery<Overlap, true>(system, tree, overlap, queryParams, callback, stats);
+          else
+            return ShapeQuery<Overlap, false>(system, tree, overlap, queryParams, callback, stats);
+          //
+        });
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+      if (queryParams.m_pStats != nullptr)
+      {
+        queryParams.m_pStats->m_uiTotalNumObjects = system.m_DataTable.GetCount();
+        queryParams.m_pStats->m_uiNumObjectsTested += stats.m_uiNumObjectsTested;
+        queryParams.m_pStats->m_uiNumObjectsPassed += stats.m_uiNumObjectsPassed;
+      }
+#endif
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Visibility queries
+
+    struct FrustumQueryData
+    {
+      // each plane component broadcast to all lanes, to test the 4 children of a node at once
+      ezSimdVec4f m_PlaneX[ezFrustum::PLANE_COUNT];
+      ezSimdVec4f m_PlaneY[ezFrustum::PLANE_COUNT];
+      ezSimdVec4f m_PlaneZ[ezFrustum::PLANE_COUNT];
+      ezSimdVec4f m_PlaneW[ezFrustum::PLANE_COUNT];
+
+      // the planes transposed, to test a single sphere against 4 planes at once
+      ezSimdVec4f m_x0x1x2x3, m_y0y1y2y3, m_z0z1z2z3, m_w0w1w2w3;
+      ezSimdVec4f m_x4x5x4x5, m_y4y5y4y5, m_z4z5z4z5, m_w4w5w4w5;
+
+      const ezSpatialSystem_Bvh* m_pSystem;
+      const ezSpatialSystem::QueryParams* m_pQueryParams;
+      ezSpatialSystem::IsOccludedFunc m_IsOccludedCB;
+      ezUInt64 m_uiFrameIdxAndType;
+    };
+
+    static void InitFrustumQueryData(const ezFrustum& frustum, FrustumQueryData& out_data)
+    {
+      ezSimdVec4f planes[ezFrustum::PLANE_COUNT];
+      for (ezUInt8 i = 0; i < ezFrustum::PLANE_COUNT; ++i)
+      {
+        planes[i] = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(i).m_vNormal.x)));
+
+        out_data.m_PlaneX[i] = planes[i].Get<ezSwizzle::XXXX>();
+        out_data.m_PlaneY[i] = planes[i].Get<ezSwizzle::YYYY>();
+        out_data.m_PlaneZ[i] = planes[i].Get<ezSwizzle::ZZZZ>();
+        out_data.m_PlaneW[i] = planes[i].Get<ezSwizzle::WWWW>();
+      }
+
+      ezSimdMat4f helperMat;
+      helperMat.SetRows(planes[0], planes[1], planes[2], planes[3]);
+
+      out_data.m_x0x1x2x3 = helperMat.m_col0;
+      out_data.m_y0y1y2y3 = helperMat.m_col1;
+      out_data.m_z0z1z2z3 = helperMat.m_col2;
+      out_data.m_w0w1w2w3 = helperMat.m_col3;
+
+      helperMat.SetRows(planes[4], planes[5], planes[4], planes[5]);
+
+      out_data.m_x4x5x4x5 = helperMat.m_col0;
+      out_data.m_y4y5y4y5 = helperMat.m_col1;
+      out_data.m_z4z5z4z5 = helperMat.m_col2;
+      out_data.m_w4w5w4w5 = helperMat.m_col3;
+    }
+
+    static EZ_ALWAYS_INLINE bool IsSphereOutside(const ezSimdBSphere& sphere, const FrustumQueryData& data)
+    {
+      const ezSimdVec4f x = sphere.m_CenterAndRadius.Get<ezSwizzle::XXXX>();
+      const ezSimdVec4f y = sphere.m_CenterAndRadius.Get<ezSwizzle::YYYY>();
+      const ezSimdVec4f z = sphere.m_CenterAndRadius.Get<ezSwizzle::ZZZZ>();
+      const ezSimdVec4f r = sphere.m_CenterAndRadius.Get<ezSwizzle::WWWW>();
+
+      ezSimdVec4f d0 = ezSimdVec4f::MulAdd(data.m_x0x1x2x3, x, data.m_w0w1w2w3);
+      d0 = ezSimdVec4f::MulAdd(data.m_y0y1y2y3, y, d0);
+      d0 = ezSimdVec4f::MulAdd(data.m_z0z1z2z3, z, d0);
+
+      ezSimdVec4f d1 = ezSimdVec4f::MulAdd(data.m_x4x5x4x5, x, data.m_w4w5w4w5);
+      d1 = ezSimdVec4f::MulAdd(data.m_y4y5y4y5, y, d1);
+      d1 = ezSimdVec4f::MulAdd(data.m_z4z5z4z5, z, d1);
+
+      return ((d0 > r) || (d1 > r)).AnySet<4>();
+    }
+
+    /// \brief Classifies the 4 children of a node against the frustum. Returns the mask of visible children and the subset of those that are fully inside.
+    static EZ_ALWAYS_INLINE ezUInt32 TestChildren(const NodeBounds& b, const FrustumQueryData& data, ezUInt32& out_uiInsideMask)
+    {
+      const ezSimdVec4f zero = ezSimdVec4f::MakeZero();
+
+      ezSimdVec4b outside(false);
+      ezSimdVec4b inside(true);
+
+      for (ezUInt32 i = 0; i < ezFrustum::PLANE_COUNT; ++i)
+      {
+        const ezSimdVec4b posX = data.m_PlaneX[i] > zero;
+        const ezSimdVec4b posY = data.m_PlaneY[i] > zero;
+        const ezSimdVec4b posZ = data.m_PlaneZ[i] > zero;
+
+        // the planes point outwards, so the corner with the smallest distance decides whether a box is outside
+        ezSimdVec4f nearDist = ezSimdVec4f::MulAdd(data.m_PlaneX[i], ezSimdVec4f::Select(posX, b.m_MinX, b.m_MaxX), data.m_PlaneW[i]);
+        nearDist = ezSimdVec4f::MulAdd(data.m_PlaneY[i], ezSimdVec4f::Select(posY, b.m_MinY, b.m_MaxY), nearDist);
+        nearDist = ezSimdVec4f::MulAdd(data.m_PlaneZ[i], ezSimdVec4f::Select(posZ, b.m_MinZ, b.m_MaxZ), nearDist);
+
+        ezSimdVec4f farDist = ezSimdVec4f::MulAdd(data.m_PlaneX[i], ezSimdVec4f::Select(posX, b.m_MaxX, b.m_MinX), data.m_PlaneW[i]);
+        farDist = ezSimdVec4f::MulAdd(data.m_PlaneY[i], ezSimdVec4f::Select(posY, b.m_MaxY, b.m_MinY), farDist);
+        farDist = ezSimdVec4f::MulAdd(data.m_PlaneZ[i], ezSimdVec4f::Select(posZ, b.m_MaxZ, b.m_MinZ), farDist);
+
+        outside = outside || (nearDist > zero);
+        inside = inside && (farDist <= zero);
+      }
+
+      // empty slots are always outside
+      const ezSimdVec4b visible = !outside;
+      out_uiInsideMask = ToMask(visible && inside);
+      return ToMask(visible);
+    }
+
+    template <bool UseTagsFilter, bool UseOcclusionCallback>
+    EZ_FORCE_INLINE static void AddVisibleObject(ezUInt32 uiDataIndex, bool bInside, const FrustumQueryData& data, Stats& ref_stats, ezDynamicArray<const ezGameObject*>& out_objects)
+    {
+      const ezSpatialSystem_Bvh& system = *data.m_pSystem;
+      const ezSimdBBoxSphere& bounds = system.m_Bounds[uiDataIndex];
+
+      ++ref_stats.m_uiNumObjectsTested;
+
+      if (!bInside && IsSphereOutside(bounds.GetSphere(), data))
+        return;
+
+      if constexpr (UseTagsFilter)
+      {
+        if (FilterByTags(system.m_TagSets[uiDataIndex], data.m_pQueryParams->m_pIncludeTags, data.m_pQueryParams->m_pExcludeTags))
+          return;
+      }
+
+      if constexpr (UseOcclusionCallback)
+      {
+        const ezSimdBBox bbox = ezSimdBBox::MakeFromCenterAndHalfExtents(bounds.m_CenterAndRadius, bounds.m_BoxHalfExtents);
+        if (data.m_IsOccludedCB(bbox))
+          return;
+      }
+
+      system.m_LastVisibleFrameIdxAndVisType[uiDataIndex].Max(data.m_uiFrameIdxAndType);
+      out_objects.PushBack(system.m_ObjectPointers[uiDataIndex]);
+
+      ++ref_stats.m_uiNumObjectsPassed;
+    }
+
+    /// \brief Tests the children of one node, adds the visible leaves to the output and passes the visible inner nodes to pushChild.
+    template <bool UseTagsFilter, bool UseOcclusionCallback, typename PushChild>
+    EZ_FORCE_INLINE static void VisitNode(const Tree& tree, const StackEntry& entry, const FrustumQueryData& data, Stats& ref_stats, ezDynamicArray<const ezGameObject*>& out_objects, PushChild pushChild)
+    {
+      const Node& node = tree.m_Nodes[entry.m_uiNodeIndex];
+
+      ezUInt32 uiVisibleMask = 0;
+      ezUInt32 uiInsideMask = 0;
+
+      if (entry.m_bInside)
+      {
+        for (ezUInt32 i = 0; i < 4; ++i)
+        {
+          uiVisibleMask |= (node.m_Children[i] != EMPTY_CHILD) ? EZ_BIT(i) : 0;
+        }
+        uiInsideMask = uiVisibleMask;
+      }
+      else
+      {
+        uiVisibleMask = TestChildren(NodeBounds(node), data, uiInsideMask);
+      }
+
+      while (uiVisibleMask > 0)
+      {
+        const ezUInt32 uiSlot = ezMath::FirstBitLow(uiVisibleMask);
+        uiVisibleMask &= uiVisibleMask - 1;
+
+        const ezUInt32 uiChild = node.m_Children[uiSlot];
+        const bool bInside = (uiInsideMask & EZ_BIT(uiSlot)) != 0;
+
+        if (uiChild & LEAF_FLAG)
+        {
+          AddVisibleObject<UseTagsFilter, UseOcclusionCallback>(uiChild & ~LEAF_FLAG, bInside, data, ref_stats, out_objects);
+          continue;
+        }
+
+        if constexpr (UseOcclusionCallback)
+        {
+          if (data.m_IsOccludedCB(GetSlotBox(node, uiSlot)))
+            continue;
+        }
+
+        pushChild(StackEntry{uiChild, bInside});
+      }
+    }
+
+    template <bool UseTagsFilter, bool UseOcclusionCallback>
+    static void TraverseSubTree(const Tree& tree, const StackEntry& root, const FrustumQueryData& data, Stats& ref_stats, ezDynamicArray<const ezGameObject*>& out_objects)
+    {
+      ezHybridArray<StackEntry, 64> stack;
+      stack.PushBack(root);
+
+      while (!stack.IsEmpty())
+      {
+        const StackEntry entry = stack.PeekBack();
+        stack.PopBack();
+
+        VisitNode<UseTagsFilter, UseOcclusionCallback>(tree, entry, data, ref_stats, out_objects, [&](const StackEntry& child)
+          { stack.PushBack(child); });
+      }
+    }
+
+    template <bool UseTagsFilter, bool UseOcclusionCallback>
+    static void TraverseSubTreesInParallel(const Tree& tree, const FrustumQueryData& data, Stats& ref_stats, ezDynamicArray<const ezGameObject*>& out_objects)
+    {
+      const ezUInt32 uiNumSubTrees = ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks) * NUM_SUBTREES_PER_WORKER;
+
+      // expand the top of the tree breadth first until there are enough independent sub-trees
+      ezHybridArray<StackEntry, 128> subTrees;
+      subTrees.PushBack({tree.m_uiRootNode, false});
+
+      ezUInt32 uiFirstSubTree = 0;
+      while (uiFirstSubTree < subTrees.GetCount() && subTrees.GetCount() - uiFirstSubTree < uiNumSubTrees)
+      {
+        const StackEntry entry = subTrees[uiFirstSubTree++];
+
+        VisitNode<UseTagsFilter, UseOcclusionCallback>(tree, entry, data, ref_stats, out_objects, [&](const StackEntry& child)
+          { subTrees.PushBack(child); });
+      }
+
+      struct SubTreeResult
+      {
+        ezDynamicArray<const ezGameObject*> m_Objects;
+        Stats m_Stats;
+      };
+
+      struct Context
+      {
+        const Tree* m_pTree;
+        const FrustumQueryData* m_pData;
+        const StackEntry* m_pSubTrees;
+        SubTreeResult* m_pResults;
+      };
+
+      ezDynamicArray<SubTreeResult> results;
+      results.SetCount(subTrees.GetCount() - uiFirstSubTree);
+
+      Context ctx = {&tree, &data, subTrees.GetData() + uiFirstSubTree, results.GetData()};
+
+      ezParallelForParams params;
+      params.m_uiBinSize = 1;
+      params.m_uiMaxTasksPerThread = NUM_SUBTREES_PER_WORKER;
+
+      ezTaskSystem::ParallelForIndexed(
+        0, results.GetCount(), [&ctx](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex)
+        {
+          for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+          {
+            SubTreeResult& result = ctx.m_pResults[i];
+            TraverseSubTree<UseTagsFilter, UseOcclusionCallback>(*ctx.m_pTree, ctx.m_pSubTrees[i], *ctx.m_pData, result.m_Stats, result.m_Objects);
+          }
+          //
+        },
+        "FindVisibleObjectsBvh", ezTaskNesting::Never, params);
+
+      for (const SubTreeResult& result : results)
+      {
+        out_objects.PushBackRange(result.m_Objects);
+        ref_stats += result.m_Stats;
+      }
+    }
+
+    template <bool UseTagsFilter, bool UseOcclusionCallback>
+    static void FindVisibleObjects(const FrustumQueryData& data, Stats& ref_stats, ezDynamicArray<const ezGameObject*>& out_objects)
+    {
+      const ezSpatialSystem_Bvh& system = *data.m_pSystem;
+      // on a single core the task overhead can't be hidden
+      const bool bParallel = cvar_SpatialBvhParallelQueries.GetValue() && ezSystemInformation::Get().GetCPUCoreCount() > 1 && ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks) > 1;
+
+      system.ForEachTree(data.m_pQueryParams->m_uiCategoryBitmask, [&](const Tree& tree)
+        {
+          for (ezUInt32 uiDataIndex : tree.m_AlwaysVisibleData)
+          {
+            if constexpr (UseTagsFilter)
+            {
+              if (FilterByTags(system.m_TagSets[uiDataIndex], data.m_pQueryParams->m_pIncludeTags, data.m_pQueryParams->m_pExcludeTags))
+                continue;
+            }
+
+            out_objects.PushBack(system.m_ObjectPointers[uiDataIndex]);
+            ++ref_stats.m_uiNumObjectsPassed;
+          }
+
+          if (tree.m_uiRootNode == EMPTY_CHILD)
+            return ezVisitorExecution::Continue;
+
+          if (bParallel && tree.m_uiNumData >= MIN_DATA_FOR_PARALLEL_QUERY)
+          {
+            TraverseSubTreesInParallel<UseTagsFilter, UseOcclusionCallback>(tree, data, ref_stats, out_objects);
+          }
+          else
+          {
+            TraverseSubTree<UseTagsFilter, UseOcclusionCallback>(tree, {tree.m_uiRootNode, false}, data, ref_stats, out_objects);
+          }
+
+          return ezVisitorExecution::Continue;
+          //
+        });
+    }
+  };
+} // namespace ezInternal
+
+//////////////////////////////////////////////////////////////////////////
+
+// clang-format off
+EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezSpatialSystem_Bvh, 1, ezRTTINoAllocator)
+EZ_END_DYNAMIC_REFLECTED_TYPE;
+// clang-format on
+
+ezSpatialSystem_Bvh::ezSpatialSystem_Bvh()
+  : m_AlignedAllocator("Spatial System Aligned", ezFoundation::GetAlignedAllocator())
+  , m_DataTable(&m_Allocator)
+  , m_Bounds(&m_AlignedAllocator)
+  , m_TagSets(&m_Allocator)
+  , m_ObjectPointers(&m_Allocator)
+  , m_LastVisibleFrameIdxAndVisType(&m_Allocator)
+  , m_Trees(&m_Allocator)
+{
+  static_assert(sizeof(Data) == 8);
+
+  m_Trees.SetCount(MAX_NUM_TREES);
+}
+
+ezSpatialSystem_Bvh::~ezSpatialSystem_Bvh() = default;
+
+void ezSpatialSystem_Bvh::StartNewFrame()
+{
+  SUPER::StartNewFrame();
+
+  for (auto& pTree : m_Trees)
+  {
+    if (pTree != nullptr)
+    {
+      pTree->RebuildIfNecessary();
+    }
+  }
+}
+
+ezSpatialDataHandle ezSpatialSystem_Bvh::CreateSpatialData(const ezSimdBBoxSphere& bounds, ezGameObject* pObject, ezUInt32 uiCategoryBitmask, const ezTagSet& tags)
+{
+  if (uiCategoryBitmask == 0)
+    return ezSpatialDataHandle();
+
+  return AddSpatialData(bounds, pObject, uiCategoryBitmask, tags, false);
+}
+
+ezSpatialDataHandle ezSpatialSystem_Bvh::CreateSpatialDataAlwaysVisible(ezGameObject* pObject, ezUInt32 uiCategoryBitmask, const ezTagSet& tags)
+{
+  if (uiCategoryBitmask == 0)
+    return ezSpatialDataHandle();
+
+  const ezSimdBBoxSphere hugeBounds = ezSimdBBox::MakeFromCenterAndHalfExtents(ezSimdVec4f::MakeZero(), ezSimdVec4f(ezMath::MaxValue<float>() * 0.25f));
+
+  return AddSpatialData(hugeBounds, pObject, uiCategoryBitmask, tags, true);
+}
+
+void ezSpatialSystem_Bvh::DeleteSpatialData(const ezSpatialDataHandle& hData)
+{
+  Data oldData;
+  EZ_VERIFY(m_DataTable.Remove(hData.GetInternalID(), &oldData), "Invalid spatial data handle");
+
+  const ezUInt32 uiDataIndex = hData.GetInternalID().m_InstanceIndex;
+
+  ForEachTree(oldData.m_uiCategoryBitmask, [&](Tree& ref_tree)
+    {
+      if (oldData.m_bAlwaysVisible)
+        ref_tree.RemoveAlwaysVisible(uiDataIndex);
+      else
+        ref_tree.Remove(uiDataIndex);
+
+      return ezVisitorExecution::Continue;
+      //
+    });
+
+  m_ObjectPointers[uiDataIndex] = nullptr;
+}
+
+void ezSpatialSystem_Bvh::UpdateSpatialDataBounds(const ezSpatialDataHandle& hData, const ezSimdBBoxSphere& bounds)
+{
+  Data* pData = nullptr;
+  EZ_VERIFY(m_DataTable.TryGetValue(hData.GetInternalID(), pData), "Invalid spatial data handle");
+
+  // No need to update bounds for always visible data
+  if (pData->m_bAlwaysVisible)
+    return;
+
+  const ezUInt32 uiDataIndex = hData.GetInternalID().m_InstanceIndex;
+  m_Bounds[uiDataIndex] = bounds;
+
+  const ezBoundingBox box = Tree::GetTreeBox(bounds);
+
+  ForEachTree(pData->m_uiCategoryBitmask, [&](Tree& ref_tree)
+    {
+      ref_tree.Update(uiDataIndex, box);
+      return ezVisitorExecution::Continue;
+      //
+    });
+}
+
+void ezSpatialSystem_Bvh::UpdateSpatialDataObject(const ezSpatialDataHandle& hData, ezGameObject* pObject)
+{
+  EZ_VERIFY(m_DataTable.Contains(hData.GetInternalID()), "Invalid spatial data handle");
+
+  m_ObjectPointers[hData.GetInternalID().m_InstanceIndex] = pObject;
+}
+
+void ezSpatialSystem_Bvh::FindObjectsInSphere(const ezBoundingSphere& sphere, const QueryParams& queryParams, QueryCallback callback) const
+{
+  EZ_PROFILE_SCOPE("FindObjectsInSphere");
+
+  const ezSimdBSphere simdSphere(ezSimdConversion::ToVec3(sphere.m_vCenter), sphere.m_fRadius);
+
+  ezInternal::BvhQueryHelper::FindObjectsInShape(*this, ezInternal::BvhQueryHelper::SphereOverlap(simdSphere), queryParams, callback);
+}
+
+void ezSpatialSystem_Bvh::FindObjectsInBox(const ezBoundingBox& box, const QueryParams& queryParams, QueryCallback callback) const
+{
+  EZ_PROFILE_SCOPE("FindObjectsInBox");
+
+  const ezSimdBBox simdBox(ezSimdConversion::ToVec3(box.m_vMin), ezSimdConversion::ToVec3(box.m_vMax));
+
+  ezInternal::BvhQueryHelper::FindObjectsInShape(*this, ezInternal::BvhQueryHelper::BoxOverlap(simdBox), queryParams, callback);
+}
+
+void ezSpatialSystem_Bvh::FindVisibleObjects(const ezFrustum& frustum, const QueryParams& queryParams, ezDynamicArray<const ezGameObject*>& out_Objects, ezSpatialSystem::IsOccludedFunc IsOccluded, ezVisibilityState visType) const
+{
+  EZ_PROFILE_SCOPE("FindVisibleObjects");
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  ezStopwatch timer;
+#endif
+
+  ezInternal::BvhQueryHelper::FrustumQueryData queryData;
+  ezInternal::BvhQueryHelper::InitFrustumQueryData(frustum, queryData);
+  queryData.m_pSystem = this;
+  queryData.m_pQueryParams = &queryParams;
+  queryData.m_IsOccludedCB = IsOccluded;
+  queryData.m_uiFrameIdxAndType = (m_uiFrameCounter << 4) | static_cast<ezUInt64>(visType);
+
+  const bool useTagsFilter = (queryParams.m_pIncludeTags && queryParams.m_pIncludeTags->IsEmpty() == false) || (queryParams.m_pExcludeTags && queryParams.m_pExcludeTags->IsEmpty() == false);
+
+  ezInternal::BvhQueryHelper::Stats stats;
+
+  if (IsOccluded.IsValid())
+  {
+    if (useTagsFilter)
+      ezInternal::BvhQueryHelper::FindVisibleObjects<true, true>(queryData, stats, out_Objects);
+    else
+      ezInternal::BvhQueryHelper::FindVisibleObjects<false, true>(queryData, stats, out_Objects);
+  }
+  else
+  {
+    if (useTagsFilter)
+      ezInternal::BvhQueryHelper::FindVisibleObjects<true, false>(queryData, stats, out_Objects);
+    else
+      ezInternal::BvhQueryHelper::FindVisibleObjects<false, false>(queryData, stats, out_Objects);
+  }
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  if (queryParams.m_pStats != nullptr)
+  {
+    queryParams.m_pStats->m_uiTotalNumObjects = m_DataTable.GetCount();
+    queryParams.m_pStats->m_uiNumObjectsTested += stats.m_uiNumObjectsTested;
+    queryParams.m_pStats->m_uiNumObjectsPassed += stats.m_uiNumObjectsPassed;
+    queryParams.m_pStats->m_TimeTaken = timer.GetRunningTotal();
+  }
+#endif
+}
+
+ezVisibilityState ezSpatialSystem_Bvh::GetVisibilityState(const ezSpatialDataHandle& hData, ezUInt32 uiNumFramesBeforeInvisible) const
+{
+  Data* pData = nullptr;
+  EZ_VERIFY(m_DataTable.TryGetValue(hData.GetInternalID(), pData), "Invalid spatial data handle");
+
+  if (pData->m_bAlwaysVisible)
+    return ezVisibilityState::Direct;
+
+  const ezUInt64 uiLastVisibleFrameIdxAndVisType = m_LastVisibleFrameIdxAndVisType[hData.GetInternalID().m_InstanceIndex];
+  const ezUInt64 uiLastVisibleFrameIdx = (uiLastVisibleFrameIdxAndVisType >> 4);
+  const ezUInt64 uiLastVisibilityType = (uiLastVisibleFrameIdxAndVisType & static_cast<ezUInt64>(15)); // mask out lower 4 bits
+
+  if (m_uiFrameCounter > uiLastVisibleFrameIdx + uiNumFramesBeforeInvisible)
+    return ezVisibilityState::Invisible;
+
+  return static_cast<ezVisibilityState>(uiLastVisibilityType);
+}
+
+ezUInt64 ezSpatialSystem_Bvh::GetChangeCounter(const ezBoundingBox& box, ezUInt32 uiCategoryBitmask) const
+{
+  EZ_IGNORE_UNUSED(box);
+
+  // The trees don't track where the changes happened, so this reports changes anywhere in the matching categories.
+  ezUInt64 uiChangeCounter = 0;
+  ForEachTree(uiCategoryBitmask, [&](const Tree& tree)
+    {
+      uiChangeCounter += tree.m_uiChangeCounter;
+      return ezVisitorExecution::Continue;
+      //
+    });
+
+  return uiChangeCounter;
+}
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+void ezSpatialSystem_Bvh::GetInternalStats(ezStringBuilder& sb) const
+{
+  ezUInt32 uiNumActiveTrees = 0;
+  for (auto& pTree : m_Trees)
+  {
+    uiNumActiveTrees += (pTree != nullptr) ? 1 : 0;
+  }
+
+  sb.SetFormat("Num Trees: {}\n", uiNumActiveTrees);
+
+  for (ezUInt32 i = 0; i < m_Trees.GetCount(); ++i)
+  {
+    const Tree* pTree = m_Trees[i].Borrow();
+    if (pTree == nullptr)
+      continue;
+
+    const float fCost = pTree->ComputeCost();
+    const float fDegradation = pTree->m_fCostAfterBuild > 0.0f ? fCost / pTree->m_fCostAfterBuild : 1.0f;
+
+    sb.AppendFormat(" \nCategory: {}\nObjects: {}, Always Visible: {}, Nodes: {}, Free Nodes: {}\nCost relative to last build: {}\n",
+      ezSpatialData::GetCategoryName(ezSpatialData::Category(static_cast<ezUInt16>(i))), pTree->m_uiNumData, pTree->m_AlwaysVisibleData.GetCount(),
+      pTree->m_Nodes.GetCount(), pTree->m_FreeNodes.GetCount(), ezArgF(fDegradation, 2));
+  }
+}
+#endif
+
+ezSpatialDataHandle ezSpatialSystem_Bvh::AddSpatialData(const ezSimdBBoxSphere& bounds, ezGameObject* pObject, ezUInt32 uiCategoryBitmask, const ezTagSet& tags, bool bAlwaysVisible)
+{
+  Data data;
+  data.m_uiCategoryBitmask = uiCategoryBitmask;
+  data.m_bAlwaysVisible = bAlwaysVisible;
+
+  auto hData = ezSpatialDataHandle(m_DataTable.Insert(data));
+  const ezUInt32 uiDataIndex = hData.GetInternalID().m_InstanceIndex;
+
+  if (uiDataIndex >= m_Bounds.GetCount())
+  {
+    m_Bounds.SetCount(uiDataIndex + 1);
+    m_TagSets.SetCount(uiDataIndex + 1);
+    m_ObjectPointers.SetCount(uiDataIndex + 1);
+    m_LastVisibleFrameIdxAndVisType.SetCount(uiDataIndex + 1);
+  }
+
+  m_Bounds[uiDataIndex] = bounds;
+  m_TagSets[uiDataIndex] = tags;
+  m_ObjectPointers[uiDataIndex] = pObject;
+  m_LastVisibleFrameIdxAndVisType[uiDataIndex] = 0;
+
+  const ezBoundingBox box = Tree::GetTreeBox(bounds);
+
+  ezUInt32 uiTreeBitmask = uiCategoryBitmask;
+  while (uiTreeBitmask > 0)
+  {
+    const ezUInt32 uiTreeIndex = ezMath::FirstBitLow(uiTreeBitmask);
+    uiTreeBitmask &= uiTreeBitmask - 1;
+
+    auto& pTree = m_Trees[uiTreeIndex];
+    if (pTree == nullptr)
+    {
+      pTree = EZ_NEW(&m_Allocator, Tree, *this);
+    }
+
+    if (bAlwaysVisible)
+      pTree->InsertAlwaysVisible(uiDataIndex);
+    else
+      pTree->Insert(uiDataIndex, box);
+  }
+
+  return hData;
+}
+
+EZ_STATICLINK_FILE(Core, Core_World_Implementation_SpatialSystem_Bvh);
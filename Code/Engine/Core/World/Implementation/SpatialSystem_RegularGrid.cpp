@@ -7,6 +7,7 @@
 #include <Foundation/Time/Stopwatch.h>
 
 ezCVarInt cvar_SpatialQueriesCachingThreshold("Spatial.Queries.CachingThreshold", 100, ezCVarFlags::Default, "Number of objects that are tested for a query before it is considered for caching");
+ezCVarInt cvar_SpatialQueriesCoherentRevalidationFrames("Spatial.Queries.CoherentRevalidationFrames", 16, ezCVarFlags::Default, "Max number of frames that a coherent visibility query reuses the result of an unchanged cell before testing it again");
 
 struct PlaneData
 {
@@ -173,6 +174,40 @@ namespace
 
     return result;
   }
+
+  enum class FrustumOverlap
+  {
+    Outside,
+    Intersecting,
+    Inside
+  };
+
+  EZ_FORCE_INLINE FrustumOverlap ClassifySphereFrustum(const ezSimdBSphere& sphere, const PlaneData& planeData)
+  {
+    ezSimdVec4f pos_xxxx(sphere.m_CenterAndRadius.x());
+    ezSimdVec4f pos_yyyy(sphere.m_CenterAndRadius.y());
+    ezSimdVec4f pos_zzzz(sphere.m_CenterAndRadius.z());
+    ezSimdVec4f pos_rrrr(sphere.m_CenterAndRadius.w());
+
+    ezSimdVec4f dot_0123;
+    dot_0123 = ezSimdVec4f::MulAdd(pos_xxxx, planeData.m_x0x1x2x3, planeData.m_w0w1w2w3);
+    dot_0123 = ezSimdVec4f::MulAdd(pos_yyyy, planeData.m_y0y1y2y3, dot_0123);
+    dot_0123 = ezSimdVec4f::MulAdd(pos_zzzz, planeData.m_z0z1z2z3, dot_0123);
+
+    ezSimdVec4f dot_4545;
+    dot_4545 = ezSimdVec4f::MulAdd(pos_xxxx, planeData.m_x4x5x4x5, planeData.m_w4w5w4w5);
+    dot_4545 = ezSimdVec4f::MulAdd(pos_yyyy, planeData.m_y4y5y4y5, dot_4545);
+    dot_4545 = ezSimdVec4f::MulAdd(pos_zzzz, planeData.m_z4z5z4z5, dot_4545);
+
+    if ((dot_0123 > pos_rrrr || dot_4545 > pos_rrrr).AnySet<4>())
+      return FrustumOverlap::Outside;
+
+    const ezSimdVec4f neg_rrrr = ezSimdVec4f::MakeZero() - pos_rrrr;
+    if ((dot_0123 < neg_rrrr && dot_4545 < neg_rrrr).AllSet<4>())
+      return FrustumOverlap::Inside;
+
+    return FrustumOverlap::Intersecting;
+  }
 } // namespace
 
 //////////////////////////////////////////////////////////////////////////
@@ -205,6 +240,8 @@ struct ezSpatialSystem_RegularGrid::Cell
     m_DataIndices.PushBack(uiDataIndex);
     m_LastVisibleFrameIdxAndVisType.PushBack(uiLastVisibleFrameIdxAndVisType);
 
+    ++m_uiChangeCounter;
+
     return m_BoundingSpheres.GetCount() - 1;
   }
 
@@ -220,6 +257,8 @@ struct ezSpatialSystem_RegularGrid::Cell
     m_DataIndices.RemoveAtAndSwap(uiCellDataIndex);
     m_LastVisibleFrameIdxAndVisType.RemoveAtAndSwap(uiCellDataIndex);
 
+    ++m_uiChangeCounter;
+
     EZ_ASSERT_DEBUG(m_DataIndices.GetCount() == uiCellDataIndex || m_DataIndices[uiCellDataIndex] == uiMovedDataIndex, "Implementation error");
 
     return uiMovedDataIndex;
@@ -235,6 +274,9 @@ struct ezSpatialSystem_RegularGrid::Cell
   ezDynamicArray<ezGameObject*> m_ObjectPointers;
   mutable ezDynamicArray<ezAtomicInteger64> m_LastVisibleFrameIdxAndVisType;
   ezDynamicArray<ezUInt32> m_DataIndices;
+
+  // Incremented whenever data is added, removed or changes its bounds. Used to detect static cells for coherent visibility queries.
+  ezUInt32 m_uiChangeCounter = 0;
 };
 
 //////////////////////////////////////////////////////////////////////////
@@ -477,6 +519,35 @@ struct ezSpatialSystem_RegularGrid::Stats
 
 //////////////////////////////////////////////////////////////////////////
 
+struct ezSpatialSystem_RegularGrid::CoherentQuery
+{
+  struct CellResult
+  {
+    ezUInt64 m_uiValidUntilFrame = 0;
+    ezUInt32 m_uiChangeCounter = 0;
+    ezUInt32 m_uiFirstIndex = 0;
+    ezUInt32 m_uiNumIndices = 0;
+    bool m_bInsideFrustum = false;
+    bool m_bAllObjects = false; // no indices are stored, if all objects of the cell are visible
+  };
+
+  // The visible cells of the last and the current query. The results are stored as indices into the cell data.
+  ezHashTable<const Cell*, CellResult> m_Cells;
+  ezHashTable<const Cell*, CellResult> m_PrevCells;
+  ezDynamicArray<ezUInt32> m_CellDataIndices;
+  ezDynamicArray<ezUInt32> m_PrevCellDataIndices;
+
+  ezFrustum m_Frustum;
+  ezUInt32 m_uiCategoryBitmask = 0;
+  ezTagSet m_IncludeTags;
+  ezTagSet m_ExcludeTags;
+  bool m_bUseOcclusion = false;
+
+  ezUInt64 m_uiLastQueryFrame = 0;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
 namespace ezInternal
 {
   struct QueryHelper
@@ -536,31 +607,61 @@ namespace ezInternal
       ezDynamicArray<const ezGameObject*>* m_pOutObjects;
       ezUInt64 m_uiFrameCounter;
       ezSpatialSystem::IsOccludedFunc m_IsOccludedCB;
+
+      // only set for coherent queries
+      ezSpatialSystem_RegularGrid::CoherentQuery* m_pCoherentQuery = nullptr;
+      bool m_bFrustumChanged = true;
     };
 
     template <bool UseTagsFilter, bool UseOcclusionCallback>
-    static ezVisitorExecution::Enum FrustumQueryCallback(const ezSpatialSystem_RegularGrid::Cell& cell, const ezSpatialSystem::QueryParams& queryParams, ezSpatialSystem_RegularGrid::Stats& ref_stats, void* pUserData, ezVisibilityState visType)
+    EZ_FORCE_INLINE static void AddVisibleObject(const ezSpatialSystem_RegularGrid::Cell& cell, ezUInt32 i, const ezSpatialSystem::QueryParams& queryParams, ezSpatialSystem_RegularGrid::Stats& ref_stats, FrustumQueryData* pQueryData, ezUInt64 uiFrameIdxAndType)
     {
-      auto pQueryData = static_cast<FrustumQueryData*>(pUserData);
-      PlaneData planeData = pQueryData->m_PlaneData;
-
-      ezSimdBSphere cellSphere = cell.m_Bounds.GetSphere();
-      if (!SphereFrustumIntersect(cellSphere, planeData))
-        return ezVisitorExecution::Continue;
+      if constexpr (UseTagsFilter)
+      {
+        if (FilterByTags(cell.m_TagSets[i], queryParams.m_pIncludeTags, queryParams.m_pExcludeTags))
+        {
+          ref_stats.m_uiNumObjectsFiltered++;
+          return;
+        }
+      }
 
       if constexpr (UseOcclusionCallback)
       {
-        if (pQueryData->m_IsOccludedCB(cell.m_Bounds.GetBox()))
+        const ezSimdBBox bbox = ezSimdBBox::MakeFromCenterAndHalfExtents(cell.m_BoundingSpheres[i].GetCenter(), cell.m_BoundingBoxHalfExtents[i]);
+        if (pQueryData->m_IsOccludedCB(bbox))
         {
-          return ezVisitorExecution::Continue;
+          return;
         }
       }
 
+      cell.m_LastVisibleFrameIdxAndVisType[i].Max(uiFrameIdxAndType);
+      pQueryData->m_pOutObjects->PushBack(cell.m_ObjectPointers[i]);
+
+      if (pQueryData->m_pCoherentQuery != nullptr)
+      {
+        pQueryData->m_pCoherentQuery->m_CellDataIndices.PushBack(i);
+      }
+
+      ref_stats.m_uiNumObjectsPassed++;
+    }
+
+    EZ_FORCE_INLINE static void AddAllCellObjects(const ezSpatialSystem_RegularGrid::Cell& cell, ezSpatialSystem_RegularGrid::Stats& ref_stats, FrustumQueryData* pQueryData, ezUInt64 uiFrameIdxAndType)
+    {
+      for (auto& lastVisibleFrameIdxAndVisType : cell.m_LastVisibleFrameIdxAndVisType)
+      {
+        lastVisibleFrameIdxAndVisType.Max(uiFrameIdxAndType);
+      }
+
+      pQueryData->m_pOutObjects->PushBackRange(ezArrayPtr<const ezGameObject* const>(cell.m_ObjectPointers.GetData(), cell.m_ObjectPointers.GetCount()));
+
+      ref_stats.m_uiNumObjectsPassed += cell.m_ObjectPointers.GetCount();
+    }
+
+    template <bool UseTagsFilter, bool UseOcclusionCallback>
+    static void TestCellObjects(const ezSpatialSystem_RegularGrid::Cell& cell, const ezSpatialSystem::QueryParams& queryParams, ezSpatialSystem_RegularGrid::Stats& ref_stats, FrustumQueryData* pQueryData, ezVisibilityState visType)
+    {
+      const PlaneData& planeData = pQueryData->m_PlaneData;
       auto boundingSpheres = cell.m_BoundingSpheres.GetData();
-      auto boundingBoxHalfExtents = cell.m_BoundingBoxHalfExtents.GetData();
-      auto tagSets = cell.m_TagSets.GetData();
-      auto objectPointers = cell.m_ObjectPointers.GetData();
-      auto lastVisibleFrameIdxAndVisType = cell.m_LastVisibleFrameIdxAndVisType.GetData();
 
       const ezUInt32 numSpheres = cell.m_BoundingSpheres.GetCount();
       ref_stats.m_uiNumObjectsTested += numSpheres;
@@ -587,28 +688,7 @@ namespace ezInternal
             ezUInt32 i = ezMath::FirstBitLow(mask) + currentIndex;
             mask &= mask - 1;
 
-            if constexpr (UseTagsFilter)
-            {
-              if (FilterByTags(tagSets[i], queryParams.m_pIncludeTags, queryParams.m_pExcludeTags))
-              {
-                ref_stats.m_uiNumObjectsFiltered++;
-                continue;
-              }
-            }
-
-            if constexpr (UseOcclusionCallback)
-            {
-              const ezSimdBBox bbox = ezSimdBBox::MakeFromCenterAndHalfExtents(boundingSpheres[i].GetCenter(), boundingBoxHalfExtents[i]);
-              if (pQueryData->m_IsOccludedCB(bbox))
-              {
-                continue;
-              }
-            }
-
-            lastVisibleFrameIdxAndVisType[i].Max(uiFrameIdxAndType);
-            pQueryData->m_pOutObjects->PushBack(objectPointers[i]);
-
-            ref_stats.m_uiNumObjectsPassed++;
+            AddVisibleObject<UseTagsFilter, UseOcclusionCallback>(cell, i, queryParams, ref_stats, pQueryData, uiFrameIdxAndType);
           }
 
           currentIndex += 32;
@@ -621,32 +701,130 @@ namespace ezInternal
           if (!SphereFrustumIntersect(boundingSpheres[i], planeData))
             continue;
 
-          if constexpr (UseTagsFilter)
+          AddVisibleObject<UseTagsFilter, UseOcclusionCallback>(cell, i, queryParams, ref_stats, pQueryData, uiFrameIdxAndType);
+        }
+      }
+    }
+
+    template <bool UseTagsFilter, bool UseOcclusionCallback>
+    static ezVisitorExecution::Enum FrustumQueryCallback(const ezSpatialSystem_RegularGrid::Cell& cell, const ezSpatialSystem::QueryParams& queryParams, ezSpatialSystem_RegularGrid::Stats& ref_stats, void* pUserData, ezVisibilityState visType)
+    {
+      auto pQueryData = static_cast<FrustumQueryData*>(pUserData);
+
+      ezSimdBSphere cellSphere = cell.m_Bounds.GetSphere();
+      if (!SphereFrustumIntersect(cellSphere, pQueryData->m_PlaneData))
+        return ezVisitorExecution::Continue;
+
+      if constexpr (UseOcclusionCallback)
+      {
+        if (pQueryData->m_IsOccludedCB(cell.m_Bounds.GetBox()))
+        {
+          return ezVisitorExecution::Continue;
+        }
+      }
+
+      TestCellObjects<UseTagsFilter, UseOcclusionCallback>(cell, queryParams, ref_stats, pQueryData, visType);
+
+      return ezVisitorExecution::Continue;
+    }
+
+    /// Reuses the result of the previous query for a cell, if its content did not change and the new frustum does not change the result.
+    /// That is the case if the frustum is the same, or if the cell is entirely inside of both frustums and there is no occlusion culling.
+    /// Occlusion results are only reused for an unchanged frustum, and only for a limited number of frames, since occluders may move.
+    template <bool UseTagsFilter, bool UseOcclusionCallback>
+    static ezVisitorExecution::Enum CoherentFrustumQueryCallback(const ezSpatialSystem_RegularGrid::Cell& cell, const ezSpatialSystem::QueryParams& queryParams, ezSpatialSystem_RegularGrid::Stats& ref_stats, void* pUserData, ezVisibilityState visType)
+    {
+      using CellResult = ezSpatialSystem_RegularGrid::CoherentQuery::CellResult;
+
+      auto pQueryData = static_cast<FrustumQueryData*>(pUserData);
+      auto& query = *pQueryData->m_pCoherentQuery;
+      const ezUInt64 uiFrameCounter = pQueryData->m_uiFrameCounter;
+
+      const FrustumOverlap overlap = ClassifySphereFrustum(cell.m_Bounds.GetSphere(), pQueryData->m_PlaneData);
+      if (overlap == FrustumOverlap::Outside)
+        return ezVisitorExecution::Continue;
+
+      const bool bInsideFrustum = (overlap == FrustumOverlap::Inside);
+
+      const CellResult* pPrevResult = query.m_PrevCells.GetValue(&cell);
+      if (pPrevResult != nullptr && pPrevResult->m_uiChangeCounter == cell.m_uiChangeCounter && pPrevResult->m_uiValidUntilFrame > uiFrameCounter)
+      {
+        const bool bCanReuse = pQueryData->m_bFrustumChanged ? (!UseOcclusionCallback && bInsideFrustum && pPrevResult->m_bInsideFrustum) : true;
+
+        if (bCanReuse)
+        {
+          CellResult& result = query.m_Cells[&cell];
+          result = *pPrevResult;
+          result.m_uiFirstIndex = query.m_CellDataIndices.GetCount();
+          result.m_bInsideFrustum = bInsideFrustum;
+
+          const ezUInt64 uiFrameIdxAndType = (uiFrameCounter << 4) | static_cast<ezUInt64>(visType);
+
+          if (pPrevResult->m_bAllObjects)
           {
-            if (FilterByTags(tagSets[i], queryParams.m_pIncludeTags, queryParams.m_pExcludeTags))
-            {
-              ref_stats.m_uiNumObjectsFiltered++;
-              continue;
-            }
+            AddAllCellObjects(cell, ref_stats, pQueryData, uiFrameIdxAndType);
+            return ezVisitorExecution::Continue;
           }
 
-          if constexpr (UseOcclusionCallback)
+          for (ezUInt32 i : query.m_PrevCellDataIndices.GetArrayPtr().GetSubArray(pPrevResult->m_uiFirstIndex, pPrevResult->m_uiNumIndices))
           {
-            const ezSimdBBox bbox = ezSimdBBox::MakeFromCenterAndHalfExtents(boundingSpheres[i].GetCenter(), boundingBoxHalfExtents[i]);
-
-            if (pQueryData->m_IsOccludedCB(bbox))
-            {
-              continue;
-            }
+            cell.m_LastVisibleFrameIdxAndVisType[i].Max(uiFrameIdxAndType);
+            pQueryData->m_pOutObjects->PushBack(cell.m_ObjectPointers[i]);
+            query.m_CellDataIndices.PushBack(i);
           }
 
-          lastVisibleFrameIdxAndVisType[i].Max(uiFrameIdxAndType);
-          pQueryData->m_pOutObjects->PushBack(objectPointers[i]);
+          ref_stats.m_uiNumObjectsPassed += pPrevResult->m_uiNumIndices;
+          return ezVisitorExecution::Continue;
+        }
+      }
 
-          ref_stats.m_uiNumObjectsPassed++;
+      if constexpr (UseOcclusionCallback)
+      {
+        if (pQueryData->m_IsOccludedCB(cell.m_Bounds.GetBox()))
+        {
+          return ezVisitorExecution::Continue;
         }
       }
 
+      CellResult& result = query.m_Cells[&cell];
+      result.m_uiChangeCounter = cell.m_uiChangeCounter;
+      result.m_uiFirstIndex = query.m_CellDataIndices.GetCount();
+      result.m_bInsideFrustum = bInsideFrustum;
+      result.m_bAllObjects = false;
+
+      // spread the revalidation of newly visible cells over several frames to avoid spikes
+      const ezUInt32 uiRevalidationFrames = static_cast<ezUInt32>(ezMath::Max(cvar_SpatialQueriesCoherentRevalidationFrames.GetValue(), 1));
+      const ezUInt32 uiDelay = (pPrevResult != nullptr) ? uiRevalidationFrames : 1 + CellKeyHashHelper::Hash(reinterpret_cast<ezUInt64>(&cell)) % uiRevalidationFrames;
+      result.m_uiValidUntilFrame = uiFrameCounter + uiDelay;
+
+      if (bInsideFrustum)
+      {
+        // all objects are fully contained in the cell, so they are inside the frustum as well
+        const ezUInt32 uiNumObjects = cell.m_BoundingSpheres.GetCount();
+        ref_stats.m_uiNumObjectsTested += uiNumObjects;
+
+        const ezUInt64 uiFrameIdxAndType = (uiFrameCounter << 4) | static_cast<ezUInt64>(visType);
+
+        if constexpr (!UseTagsFilter && !UseOcclusionCallback)
+        {
+          AddAllCellObjects(cell, ref_stats, pQueryData, uiFrameIdxAndType);
+          result.m_bAllObjects = true;
+        }
+        else
+        {
+          for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+          {
+            AddVisibleObject<UseTagsFilter, UseOcclusionCallback>(cell, i, queryParams, ref_stats, pQueryData, uiFrameIdxAndType);
+          }
+        }
+      }
+      else
+      {
+        TestCellObjects<UseTagsFilter, UseOcclusionCallback>(cell, queryParams, ref_stats, pQueryData, visType);
+      }
+
+      result.m_uiNumIndices = query.m_CellDataIndices.GetCount() - result.m_uiFirstIndex;
+
       return ezVisitorExecution::Continue;
     }
   };
@@ -778,6 +956,23 @@ void ezSpatialSystem_RegularGrid::StartNewFrame()
   {
     MigrateCachedGrid(m_SortedCacheCandidates[i].m_uiIndex);
   }
+
+  // Remove the results of coherent queries that have not been issued for a while, e.g. because their view was destroyed
+  {
+    EZ_LOCK(m_CoherentQueriesMutex);
+
+    for (auto it = m_CoherentQueries.GetIterator(); it.IsValid();)
+    {
+      if (it.Value()->m_uiLastQueryFrame + 10 < m_uiFrameCounter)
+      {
+        it = m_CoherentQueries.Remove(it);
+      }
+      else
+      {
+        ++it;
+      }
+    }
+  }
 }
 
 ezSpatialDataHandle ezSpatialSystem_RegularGrid::CreateSpatialData(const ezSimdBBoxSphere& bounds, ezGameObject* pObject, ezUInt32 uiCategoryBitmask, const ezTagSet& tags)
@@ -830,6 +1025,7 @@ void ezSpatialSystem_RegularGrid::UpdateSpatialDataBounds(const ezSpatialDataHan
       {
         pOldCell->m_BoundingSpheres[mapping.m_uiCellDataIndex] = bounds.GetSphere();
         pOldCell->m_BoundingBoxHalfExtents[mapping.m_uiCellDataIndex] = bounds.m_BoxHalfExtents;
+        ++pOldCell->m_uiChangeCounter;
       }
       else
       {
@@ -941,7 +1137,26 @@ void ezSpatialSystem_RegularGrid::FindVisibleObjects(const ezFrustum& frustum, c
     queryData.m_IsOccludedCB = IsOccluded;
   }
 
-  if (IsOccluded.IsValid())
+  if (queryParams.m_pCoherentVisibilityKey != nullptr)
+  {
+    queryData.m_pCoherentQuery = GetCoherentQuery(frustum, queryParams, IsOccluded.IsValid(), queryData.m_bFrustumChanged);
+
+    if (IsOccluded.IsValid())
+    {
+      ForEachCellInBoxInMatchingGrids(simdBox, queryParams,
+        &ezInternal::QueryHelper::CoherentFrustumQueryCallback<false, true>,
+        &ezInternal::QueryHelper::CoherentFrustumQueryCallback<true, true>,
+        &queryData, visType);
+    }
+    else
+    {
+      ForEachCellInBoxInMatchingGrids(simdBox, queryParams,
+        &ezInternal::QueryHelper::CoherentFrustumQueryCallback<false, false>,
+        &ezInternal::QueryHelper::CoherentFrustumQueryCallback<true, false>,
+        &queryData, visType);
+    }
+  }
+  else if (IsOccluded.IsValid())
   {
     ForEachCellInBoxInMatchingGrids(simdBox, queryParams,
       &ezInternal::QueryHelper::FrustumQueryCallback<false, true>,
@@ -990,6 +1205,30 @@ ezVisibilityState ezSpatialSystem_RegularGrid::GetVisibilityState(const ezSpatia
   return static_cast<ezVisibilityState>(uiLastVisibilityType);
 }
 
+ezUInt64 ezSpatialSystem_RegularGrid::GetChangeCounter(const ezBoundingBox& box, ezUInt32 uiCategoryBitmask) const
+{
+  ezSimdBBox simdBox(ezSimdConversion::ToVec3(box.m_vMin), ezSimdConversion::ToVec3(box.m_vMax));
+
+  // Cells are never removed and their counters only increase, so the sum changes whenever any of the overlapping cells changes.
+  // Only the regular grids are used since cached grids can be created and removed at any time.
+  ezUInt64 uiChangeCounter = 0;
+  for (ezUInt32 uiGridIndex = 0; uiGridIndex < MAX_NUM_REGULAR_GRIDS; ++uiGridIndex)
+  {
+    auto& pGrid = m_Grids[uiGridIndex];
+    if (pGrid == nullptr || (pGrid->m_Category.GetBitmask() & uiCategoryBitmask) == 0)
+      continue;
+
+    pGrid->ForEachCellInBox(simdBox,
+      [&](const Cell& cell)
+      {
+        uiChangeCounter += cell.m_uiChangeCounter;
+        return ezVisitorExecution::Continue;
+      });
+  }
+
+  return uiChangeCounter;
+}
+
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
 void ezSpatialSystem_RegularGrid::GetInternalStats(ezStringBuilder& sb) const
 {
@@ -1280,6 +1519,9 @@ void ezSpatialSystem_RegularGrid::RemoveCachedGrid(ezUInt32 uiCandidateIndex)
     cacheCandidate.m_uiGridIndex = ezInvalidIndex;
   }
 
+  // coherent queries reference the cells of the grid
+  InvalidateCoherentQueries();
+
   m_Grids[uiGridIndex] = nullptr;
 }
 
@@ -1332,4 +1574,64 @@ void ezSpatialSystem_RegularGrid::UpdateCacheCandidate(const ezTagSet* pIncludeT
   }
 }
 
+ezSpatialSystem_RegularGrid::CoherentQuery* ezSpatialSystem_RegularGrid::GetCoherentQuery(const ezFrustum& frustum, const QueryParams& queryParams, bool bUseOcclusion, bool& out_bFrustumChanged) const
+{
+  CoherentQuery* pQuery = nullptr;
+  {
+    EZ_LOCK(m_CoherentQueriesMutex);
+
+    auto& pQueryStorage = m_CoherentQueries[queryParams.m_pCoherentVisibilityKey];
+    if (pQueryStorage == nullptr)
+    {
+      pQueryStorage = EZ_DEFAULT_NEW(CoherentQuery);
+    }
+
+    pQuery = pQueryStorage.Borrow();
+  }
+
+  pQuery->m_PrevCells.Swap(pQuery->m_Cells);
+  pQuery->m_PrevCellDataIndices.Swap(pQuery->m_CellDataIndices);
+  pQuery->m_Cells.Clear();
+  pQuery->m_CellDataIndices.Clear();
+
+  // the previous results can't be reused if the query changed in any other way than the frustum
+  if (pQuery->m_uiCategoryBitmask != queryParams.m_uiCategoryBitmask ||
+      AreTagSetsEqual(pQuery->m_IncludeTags, queryParams.m_pIncludeTags) == false ||
+      AreTagSetsEqual(pQuery->m_ExcludeTags, queryParams.m_pExcludeTags) == false ||
+      pQuery->m_bUseOcclusion != bUseOcclusion)
+  {
+    pQuery->m_PrevCells.Clear();
+
+    pQuery->m_uiCategoryBitmask = queryParams.m_uiCategoryBitmask;
+    pQuery->m_IncludeTags = queryParams.m_pIncludeTags != nullptr ? *queryParams.m_pIncludeTags : ezTagSet();
+    pQuery->m_ExcludeTags = queryParams.m_pExcludeTags != nullptr ? *queryParams.m_pExcludeTags : ezTagSet();
+    pQuery->m_bUseOcclusion = bUseOcclusion;
+  }
+
+  out_bFrustumChanged = false;
+  for (ezUInt8 i = 0; i < ezFrustum::PLANE_COUNT; ++i)
+  {
+    if (pQuery->m_Frustum.GetPlane(i) != frustum.GetPlane(i))
+    {
+      out_bFrustumChanged = true;
+      break;
+    }
+  }
+
+  pQuery->m_Frustum = frustum;
+  pQuery->m_uiLastQueryFrame = m_uiFrameCounter;
+
+  return pQuery;
+}
+
+void ezSpatialSystem_RegularGrid::InvalidateCoherentQueries()
+{
+  EZ_LOCK(m_CoherentQueriesMutex);
+
+  for (auto it = m_CoherentQueries.GetIterator(); it.IsValid(); ++it)
+  {
+    it.Value()->m_Cells.Clear();
+  }
+}
+
 EZ_STATICLINK_FILE(Core, Core_World_Implementation_SpatialSystem_RegularGrid);
@@ -576,6 +576,30 @@ void ezWorld::Update()
   m_Data.m_StackAllocator.Swap();
 }
 
+// static
+void ezWorld::UpdateWorlds(ezArrayPtr<ezWorld*> worlds, bool bInParallel)
+{
+  if (bInParallel)
+  {
+    ezTaskGroupID updateWorldsTaskID = ezTaskSystem::CreateTaskGroup(ezTaskPriority::EarlyThisFrame);
+    for (ezWorld* pWorld : worlds)
+    {
+      ezTaskSystem::AddTaskToGroup(updateWorldsTaskID, pWorld->GetUpdateTask());
+    }
+    ezTaskSystem::StartTaskGroup(updateWorldsTaskID);
+    ezTaskSystem::WaitForGroup(updateWorldsTaskID);
+  }
+  else
+  {
+    for (ezWorld* pWorld : worlds)
+    {
+      EZ_LOCK(pWorld->GetWriteMarker());
+
+      pWorld->Update();
+    }
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 ezWorldModule* ezWorld::GetOrCreateModule(const ezRTTI* pRtti)
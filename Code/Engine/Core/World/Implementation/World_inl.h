@@ -457,6 +457,11 @@ EZ_ALWAYS_INLINE ezDoubleBufferedLinearAllocator* ezWorld::GetStackAllocator()
   return &m_Data.m_StackAllocator;
 }
 
+EZ_ALWAYS_INLINE ezAllocator* ezWorld::GetFrameAllocator() const
+{
+  return m_Data.m_StackAllocator.GetCurrentAllocator();
+}
+
 EZ_ALWAYS_INLINE ezInternal::WorldData::ReadMarker& ezWorld::GetReadMarker() const
 {
   return m_Data.m_ReadMarker;
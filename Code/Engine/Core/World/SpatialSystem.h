@@ -48,6 +48,12 @@ public:
     ezUInt32 m_uiCategoryBitmask = 0;
     const ezTagSet* m_pIncludeTags = nullptr;
     const ezTagSet* m_pExcludeTags = nullptr;
+
+    /// \brief Opts FindVisibleObjects() into coherent visibility, if not null.
+    ///
+    /// Consecutive queries with the same key may reuse the previous result for parts of the scene that did not change.
+    /// Use a unique key per view, e.g. a pointer to the view. Queries with the same key must not run concurrently.
+    const void* m_pCoherentVisibilityKey = nullptr;
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
     QueryStats* m_pStats = nullptr;
 #endif
@@ -74,6 +80,13 @@ public:
   /// \param uiNumFramesBeforeInvisible Used to treat an object that was visible and just became invisible as visible for a few more frames.
   virtual ezVisibilityState GetVisibilityState(const ezSpatialDataHandle& hData, ezUInt32 uiNumFramesBeforeInvisible) const = 0;
 
+  /// \brief Returns a counter that changes whenever spatial data of the given categories is added, removed or moved inside the given box.
+  ///
+  /// The value has no meaning by itself, it can only be compared to the result of a previous call with the same parameters.
+  /// This allows to cache results that only depend on e.g. the static objects in a certain region.
+  /// Implementations may be conservative and also report changes outside of the box. The default implementation reports a change every frame.
+  virtual ezUInt64 GetChangeCounter(const ezBoundingBox& box, ezUInt32 uiCategoryBitmask) const;
+
   ///@}
 
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <Core/World/SpatialSystem.h>
+#include <Foundation/Containers/IdTable.h>
+#include <Foundation/Types/UniquePtr.h>
+
+namespace ezInternal
+{
+  struct BvhQueryHelper;
+}
+
+/// \brief A spatial system that stores the spatial data of each category in a bounding volume hierarchy with 4-wide nodes.
+///
+/// Compared to ezSpatialSystem_RegularGrid, the BVH adapts to scenes with very non-uniform object sizes and densities,
+/// e.g. huge terrain chunks mixed with dense clusters of small props, since it has no fixed cell size and no overflow cell.
+///
+/// Moving data is stored with a small margin and only grows the bounds of its ancestors once it leaves that margin.
+/// Inserting data descends into the child with the smallest growth. Once the SAH cost of a tree has degraded too much,
+/// it is rebuilt with a binned SAH in StartNewFrame(), see 'Spatial.Bvh.RebuildThreshold'.
+/// The children of a node are always tested against the query shape together using SIMD.
+/// Large visibility queries are additionally split into sub-trees that are processed in parallel, see 'Spatial.Bvh.ParallelQueries'.
+/// The occlusion callback is then called from multiple threads at once.
+///
+/// To use it, create an instance with the aligned allocator and pass it to the world through ezWorldDesc::m_pSpatialSystem.
+class EZ_CORE_DLL ezSpatialSystem_Bvh : public ezSpatialSystem
+{
+  EZ_ADD_DYNAMIC_REFLECTION(ezSpatialSystem_Bvh, ezSpatialSystem);
+
+public:
+  ezSpatialSystem_Bvh();
+  ~ezSpatialSystem_Bvh();
+
+private:
+  friend ezInternal::BvhQueryHelper;
+
+  // ezSpatialSystem implementation
+  virtual void StartNewFrame() override;
+
+  ezSpatialDataHandle CreateSpatialData(const ezSimdBBoxSphere& bounds, ezGameObject* pObject, ezUInt32 uiCategoryBitmask, const ezTagSet& tags) override;
+  ezSpatialDataHandle CreateSpatialDataAlwaysVisible(ezGameObject* pObject, ezUInt32 uiCategoryBitmask, const ezTagSet& tags) override;
+
+  void DeleteSpatialData(const ezSpatialDataHandle& hData) override;
+
+  void UpdateSpatialDataBounds(const ezSpatialDataHandle& hData, const ezSimdBBoxSphere& bounds) override;
+  void UpdateSpatialDataObject(const ezSpatialDataHandle& hData, ezGameObject* pObject) override;
+
+  void FindObjectsInSphere(const ezBoundingSphere& sphere, const QueryParams& queryParams, QueryCallback callback) const override;
+  void FindObjectsInBox(const ezBoundingBox& box, const QueryParams& queryParams, QueryCallback callback) const override;
+
+  void FindVisibleObjects(const ezFrustum& frustum, const QueryParams& queryParams, ezDynamicArray<const ezGameObject*>& out_Objects, ezSpatialSystem::IsOccludedFunc IsOccluded, ezVisibilityState visType) const override;
+
+  ezVisibilityState GetVisibilityState(const ezSpatialDataHandle& hData, ezUInt32 uiNumFramesBeforeInvisible) const override;
+
+  ezUInt64 GetChangeCounter(const ezBoundingBox& box, ezUInt32 uiCategoryBitmask) const override;
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  virtual void GetInternalStats(ezStringBuilder& sb) const override;
+#endif
+
+  ezProxyAllocator m_AlignedAllocator;
+
+  struct Data
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt32 m_uiCategoryBitmask;
+    bool m_bAlwaysVisible;
+  };
+
+  ezIdTable<ezSpatialDataId, Data, ezLocalAllocatorWrapper> m_DataTable;
+
+  // Indexed by the instance index of the spatial data handle, shared by the trees of all categories
+  ezDynamicArray<ezSimdBBoxSphere> m_Bounds;
+  ezDynamicArray<ezTagSet> m_TagSets;
+  ezDynamicArray<ezGameObject*> m_ObjectPointers;
+  mutable ezDynamicArray<ezAtomicInteger64> m_LastVisibleFrameIdxAndVisType;
+
+  struct Node;
+  struct Tree;
+  ezDynamicArray<ezUniquePtr<Tree>> m_Trees;
+
+  ezSpatialDataHandle AddSpatialData(const ezSimdBBoxSphere& bounds, ezGameObject* pObject, ezUInt32 uiCategoryBitmask, const ezTagSet& tags, bool bAlwaysVisible);
+
+  template <typename Functor>
+  void ForEachTree(ezUInt32 uiCategoryBitmask, Functor func) const;
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Core/World/SpatialSystem.h>
+#include <Foundation/Containers/HashTable.h>
 #include <Foundation/Containers/IdTable.h>
 #include <Foundation/SimdMath/SimdVec4i.h>
 #include <Foundation/Types/UniquePtr.h>
@@ -45,6 +46,8 @@ private:
 
   ezVisibilityState GetVisibilityState(const ezSpatialDataHandle& hData, ezUInt32 uiNumFramesBeforeInvisible) const override;
 
+  ezUInt64 GetChangeCounter(const ezBoundingBox& box, ezUInt32 uiCategoryBitmask) const override;
+
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
   virtual void GetInternalStats(ezStringBuilder& sb) const override;
 #endif
@@ -124,4 +127,11 @@ private:
   void RemoveAllCachedGrids();
 
   void UpdateCacheCandidate(const ezTagSet* pIncludeTags, const ezTagSet* pExcludeTags, ezSpatialData::Category category, float filteredRatio) const;
+
+  struct CoherentQuery;
+  mutable ezHashTable<const void*, ezUniquePtr<CoherentQuery>> m_CoherentQueries;
+  mutable ezMutex m_CoherentQueriesMutex;
+
+  CoherentQuery* GetCoherentQuery(const ezFrustum& frustum, const QueryParams& queryParams, bool bUseOcclusion, bool& out_bFrustumChanged) const;
+  void InvalidateCoherentQueries();
 };
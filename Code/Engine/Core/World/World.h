@@ -263,6 +263,14 @@ public:
   /// \brief Returns a task implementation that calls Update on this world.
   const ezSharedPtr<ezTask>& GetUpdateTask();
 
+  /// \brief Updates all given worlds and returns once all of them are done.
+  ///
+  /// If bInParallel is set, every world is updated in its own task, so independent worlds (e.g. the match worlds of a dedicated server)
+  /// can be stepped concurrently. Each world owns its clock, frame allocator (see GetFrameAllocator()), message queues, spatial system and
+  /// update tasks, and the global state that is touched during an update (stats, clock events, ezFrameAllocator, the task system) is
+  /// synchronized, so no additional locking is needed as long as component code does not share mutable state between worlds.
+  static void UpdateWorlds(ezArrayPtr<ezWorld*> worlds, bool bInParallel);
+
   /// \brief Returns the number of update calls. Can be used to determine whether an operation has already been done during a frame.
   ezUInt32 GetUpdateCounter() const;
 
@@ -308,6 +316,13 @@ public:
   /// \brief Returns the stack allocator used by this world.
   ezDoubleBufferedLinearAllocator* GetStackAllocator();
 
+  /// \brief Returns an allocator for temporary memory that is only needed while this world is updated.
+  ///
+  /// This is the per-world counterpart to ezFrameAllocator. Allocations stay valid until the end of the next update of this world.
+  /// Update code should prefer it over ezFrameAllocator, so that worlds that are updated concurrently don't contend for the same allocator.
+  /// Memory that is handed over to the renderer still has to come from ezFrameAllocator.
+  ezAllocator* GetFrameAllocator() const;
+
   /// \brief Mark the world for reading by using EZ_LOCK(world.GetReadMarker()). Multiple threads can read simultaneously if none is
   /// writing.
   ezInternal::WorldData::ReadMarker& GetReadMarker() const;
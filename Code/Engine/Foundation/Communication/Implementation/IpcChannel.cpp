@@ -10,6 +10,10 @@
 #  include <PipeChannel_Platform.h>
 #endif
 
+#if EZ_ENABLED(EZ_PLATFORM_LINUX)
+#  include <Foundation/Platform/Linux/SharedMemoryChannel_Platform.h>
+#endif
+
 static_assert((ezInt32)ezIpcChannel::ConnectionState::Disconnected == (ezInt32)ezIpcChannelEvent::Disconnected);
 static_assert((ezInt32)ezIpcChannel::ConnectionState::Connecting == (ezInt32)ezIpcChannelEvent::Connecting);
 static_assert((ezInt32)ezIpcChannel::ConnectionState::Connected == (ezInt32)ezIpcChannelEvent::Connected);
@@ -45,6 +49,20 @@ ezInternal::NewInstance<ezIpcChannel> ezIpcChannel::CreatePipeChannel(ezStringVi
 #endif
 }
 
+ezInternal::NewInstance<ezIpcChannel> ezIpcChannel::CreateSharedMemoryChannel(ezStringView sAddress, Mode::Enum mode)
+{
+#if EZ_ENABLED(EZ_PLATFORM_LINUX)
+  if (sAddress.IsEmpty() || sAddress.GetElementCount() > 200)
+  {
+    ezLog::Error("Failed to create shared memory channel '{0}', name is not valid", sAddress);
+    return nullptr;
+  }
+
+  return EZ_DEFAULT_NEW(ezSharedMemoryChannel_linux, sAddress, mode);
+#else
+  return CreatePipeChannel(sAddress, mode);
+#endif
+}
 
 ezInternal::NewInstance<ezIpcChannel> ezIpcChannel::CreateNetworkChannel(ezStringView sAddress, Mode::Enum mode)
 {
@@ -78,6 +96,11 @@ bool ezIpcChannel::Send(ezArrayPtr<const ezUInt8> data)
 {
   {
     EZ_LOCK(m_OutputQueueMutex);
+
+    // messages must not overtake the ones that are still queued
+    if (m_OutputQueue.IsEmpty() && IsConnected() && InternalSendImmediately(data))
+      return true;
+
     ezMemoryStreamStorageInterface& storage = m_OutputQueue.ExpandAndGetRef();
     ezMemoryStreamWriter writer(&storage);
     ezUInt32 uiSize = data.GetCount() + HEADER_SIZE;
@@ -143,9 +166,32 @@ void ezIpcChannel::ReceiveData(ezArrayPtr<const ezUInt8> data)
     return;
   }
 
+  auto DispatchMessage = [this](ezArrayPtr<const ezUInt8> message)
+  {
+    m_ReceiveCallback(message);
+    m_IncomingMessages.RaiseSignal();
+    m_Events.Broadcast(ezIpcChannelEvent(ezIpcChannelEvent::NewMessages, this));
+  };
+
   ezArrayPtr<const ezUInt8> remainingData = data;
   while (true)
   {
+    // Messages that are completely contained in the data are passed on directly, only split messages are assembled in the accumulator
+    if (m_MessageAccumulator.IsEmpty() && remainingData.GetCount() >= HEADER_SIZE)
+    {
+      ezUInt32 uiHeader[2];
+      memcpy(uiHeader, remainingData.GetPtr(), HEADER_SIZE);
+      EZ_ASSERT_DEBUG(uiHeader[0] == MAGIC_VALUE, "Message received with wrong magic value.");
+      EZ_ASSERT_DEBUG(uiHeader[1] < MAX_MESSAGE_SIZE, "Message too big: {0}! Either the stream got corrupted or you need to increase MAX_MESSAGE_SIZE.", uiHeader[1]);
+
+      if (uiHeader[1] <= remainingData.GetCount())
+      {
+        DispatchMessage(remainingData.GetSubArray(HEADER_SIZE, uiHeader[1] - HEADER_SIZE));
+        remainingData = remainingData.GetSubArray(uiHeader[1]);
+        continue;
+      }
+    }
+
     if (m_MessageAccumulator.GetCount() < HEADER_SIZE)
     {
       if (remainingData.GetCount() + m_MessageAccumulator.GetCount() < HEADER_SIZE)
@@ -187,9 +233,7 @@ void ezIpcChannel::ReceiveData(ezArrayPtr<const ezUInt8> data)
     remainingData = remainingData.GetSubArray(remainingMessageData);
 
     {
-      m_ReceiveCallback(ezArrayPtr<const ezUInt8>(m_MessageAccumulator.GetData() + HEADER_SIZE, uiMessageSize - HEADER_SIZE));
-      m_IncomingMessages.RaiseSignal();
-      m_Events.Broadcast(ezIpcChannelEvent(ezIpcChannelEvent::NewMessages, this));
+      DispatchMessage(ezArrayPtr<const ezUInt8>(m_MessageAccumulator.GetData() + HEADER_SIZE, uiMessageSize - HEADER_SIZE));
       m_MessageAccumulator.Clear();
     }
   }
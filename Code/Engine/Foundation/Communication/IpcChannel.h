@@ -39,6 +39,7 @@ struct EZ_FOUNDATION_DLL ezIpcChannelEvent
 ///  A client should only try to connect to a server once the server has changed to ConnectionState::Connecting as this indicates the server is ready to be conneccted to.
 ///
 ///  Use ezIpcChannel:::CreatePipeChannel to create an IPC pipe instance.
+///  Use ezIpcChannel::CreateSharedMemoryChannel when large amounts of data need to be exchanged between processes on the same machine.
 ///  To send more complex messages accross, you can create a ezIpcProcessMessageProtocol on top of the channel.
 class EZ_FOUNDATION_DLL ezIpcChannel
 {
@@ -75,6 +76,16 @@ public:
 
   static ezInternal::NewInstance<ezIpcChannel> CreateNetworkChannel(ezStringView sAddress, Mode::Enum mode);
 
+  /// \brief Creates an IPC communication channel that exchanges the messages through ring buffers in shared memory.
+  ///
+  /// The pipe is only used to establish the connection and to detect when the other side goes away.
+  /// Messages are written directly into the shared memory, which avoids copying them through the kernel.
+  /// On platforms that don't support this, a regular pipe channel is created instead.
+  /// Both sides of the connection have to use the same channel type.
+  /// \param szAddress Name of the pipe, must be unique on a system and less than 200 characters.
+  /// \param mode Whether to run in client or server mode.
+  static ezInternal::NewInstance<ezIpcChannel> CreateSharedMemoryChannel(ezStringView sAddress, Mode::Enum mode);
+
 
   /// \brief Connects async. On success, m_Events will be broadcasted.
   void Connect();
@@ -113,6 +124,14 @@ protected:
   virtual void InternalSend() = 0;
   /// \brief Called by Send to determine whether the message loop need to be woken up.
   virtual bool NeedWakeup() const = 0;
+  /// \brief Called by Send with m_OutputQueueMutex locked, while connected and no other messages are queued.
+  ///  Can write the message (including its header) to the other side right away, instead of queuing it for the worker thread.
+  ///  Returns false, if the message should be queued as usual.
+  virtual bool InternalSendImmediately(ezArrayPtr<const ezUInt8> data)
+  {
+    EZ_IGNORE_UNUSED(data);
+    return false;
+  }
 
   void SetConnectionState(ezEnum<ConnectionState> state);
   /// \brief Implementation needs to call this when new data has been received.
@@ -0,0 +1,385 @@
+#pragma once
+
+#include <Foundation/Algorithm/HashingUtils.h>
+#include <Foundation/Containers/Implementation/FlatHashGroup.h>
+#include <Foundation/Math/Math.h>
+#include <Foundation/Memory/AllocatorWrapper.h>
+
+template <typename KeyType, typename ValueType, typename Hasher>
+class ezFlatHashMapBase;
+
+/// \brief Const iterator.
+template <typename KeyType, typename ValueType, typename Hasher>
+struct ezFlatHashMapBaseConstIterator
+{
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = ezFlatHashMapBaseConstIterator;
+  using difference_type = std::ptrdiff_t;
+  using pointer = ezFlatHashMapBaseConstIterator*;
+  using reference = ezFlatHashMapBaseConstIterator&;
+
+  EZ_DECLARE_POD_TYPE();
+
+  ezFlatHashMapBaseConstIterator() = default;
+
+  /// \brief Checks whether this iterator points to a valid element.
+  bool IsValid() const; // [tested]
+
+  /// \brief Checks whether the two iterators point to the same element.
+  bool operator==(const ezFlatHashMapBaseConstIterator& rhs) const;
+  EZ_ADD_DEFAULT_OPERATOR_NOTEQUAL(const ezFlatHashMapBaseConstIterator&);
+
+  /// \brief Returns the 'key' of the element that this iterator points to.
+  const KeyType& Key() const; // [tested]
+
+  /// \brief Returns the 'value' of the element that this iterator points to.
+  const ValueType& Value() const; // [tested]
+
+  /// \brief Advances the iterator to the next element in the map. The iterator will not be valid anymore, if the end is reached.
+  void Next(); // [tested]
+
+  /// \brief Shorthand for 'Next'
+  void operator++(); // [tested]
+
+  /// \brief Returns '*this' to enable foreach
+  EZ_ALWAYS_INLINE ezFlatHashMapBaseConstIterator& operator*() { return *this; } // [tested]
+
+protected:
+  friend class ezFlatHashMapBase<KeyType, ValueType, Hasher>;
+
+  explicit ezFlatHashMapBaseConstIterator(const ezFlatHashMapBase<KeyType, ValueType, Hasher>& map);
+  void SetToBegin();
+  void SetToEnd();
+
+  const ezFlatHashMapBase<KeyType, ValueType, Hasher>* m_pMap = nullptr;
+  ezUInt32 m_uiCurrentIndex = 0; // current element index that this iterator points to.
+  ezUInt32 m_uiCurrentCount = 0; // current number of valid elements that this iterator has found so far.
+
+#if EZ_ENABLED(EZ_USE_CPP20_OPERATORS)
+public:
+  struct Pointer
+  {
+    std::pair<const KeyType&, const ValueType&> value;
+    const std::pair<const KeyType&, const ValueType&>* operator->() const { return &value; }
+  };
+
+  EZ_ALWAYS_INLINE Pointer operator->() const
+  {
+    return Pointer{.value = {Key(), Value()}};
+  }
+
+  // These function is used to return the values for structured bindings.
+  // The number and type of type of each slot are defined in the inl file.
+  template <std::size_t Index>
+  std::tuple_element_t<Index, ezFlatHashMapBaseConstIterator>& get() const
+  {
+    if constexpr (Index == 0)
+      return Key();
+    if constexpr (Index == 1)
+      return Value();
+  }
+#endif
+};
+
+/// \brief Iterator with write access.
+template <typename KeyType, typename ValueType, typename Hasher>
+struct ezFlatHashMapBaseIterator : public ezFlatHashMapBaseConstIterator<KeyType, ValueType, Hasher>
+{
+  EZ_DECLARE_POD_TYPE();
+
+  /// \brief Creates a new iterator from another.
+  EZ_ALWAYS_INLINE ezFlatHashMapBaseIterator(const ezFlatHashMapBaseIterator& rhs); // [tested]
+
+  /// \brief Assigns one iterator no another.
+  EZ_ALWAYS_INLINE void operator=(const ezFlatHashMapBaseIterator& rhs); // [tested]
+
+  // this is required to pull in the const version of this function
+  using ezFlatHashMapBaseConstIterator<KeyType, ValueType, Hasher>::Value;
+
+  /// \brief Returns the 'value' of the element that this iterator points to.
+  EZ_FORCE_INLINE ValueType& Value(); // [tested]
+
+  /// \brief Returns the 'value' of the element that this iterator points to.
+  EZ_FORCE_INLINE ValueType& Value() const;
+
+  /// \brief Returns '*this' to enable foreach
+  EZ_ALWAYS_INLINE ezFlatHashMapBaseIterator& operator*() { return *this; } // [tested]
+
+private:
+  friend class ezFlatHashMapBase<KeyType, ValueType, Hasher>;
+
+  explicit ezFlatHashMapBaseIterator(const ezFlatHashMapBase<KeyType, ValueType, Hasher>& map);
+
+#if EZ_ENABLED(EZ_USE_CPP20_OPERATORS)
+public:
+  struct Pointer
+  {
+    std::pair<const KeyType&, ValueType&> value;
+    const std::pair<const KeyType&, ValueType&>* operator->() const { return &value; }
+  };
+
+  EZ_ALWAYS_INLINE Pointer operator->() const
+  {
+    return Pointer{.value = {ezFlatHashMapBaseConstIterator<KeyType, ValueType, Hasher>::Key(), Value()}};
+  }
+
+  // These functions are used to return the values for structured bindings.
+  // The number and type of type of each slot are defined in the inl file.
+  template <std::size_t Index>
+  std::tuple_element_t<Index, ezFlatHashMapBaseIterator>& get()
+  {
+    if constexpr (Index == 0)
+      return ezFlatHashMapBaseConstIterator<KeyType, ValueType, Hasher>::Key();
+    if constexpr (Index == 1)
+      return Value();
+  }
+
+  template <std::size_t Index>
+  std::tuple_element_t<Index, ezFlatHashMapBaseIterator>& get() const
+  {
+    if constexpr (Index == 0)
+      return ezFlatHashMapBaseConstIterator<KeyType, ValueType, Hasher>::Key();
+    if constexpr (Index == 1)
+      return Value();
+  }
+#endif
+};
+
+/// \brief Implementation of a hashmap which stores key/value pairs in a flat array, using SIMD probing of control bytes.
+///
+/// In contrast to ezHashTable, every slot has a one byte control value that stores 7 bits of the key's hash.
+/// Lookups compare the control bytes of a group of 16 slots at once (SSE2 or NEON) and only look at keys whose hash fragment matches,
+/// which typically means a lookup touches one cache line of control bytes and one cache line of entries.
+/// Groups are probed quadratically, and the table grows when the load (including deleted slots) exceeds 87.5%.
+/// The API is the same as that of ezHashTable, so the two can be swapped easily.
+///
+/// The hash function can be customized by providing a Hasher helper class like ezHashHelper.
+
+/// \see ezHashHelper, ezHashTable
+template <typename KeyType, typename ValueType, typename Hasher>
+class ezFlatHashMapBase
+{
+public:
+  using Iterator = ezFlatHashMapBaseIterator<KeyType, ValueType, Hasher>;
+  using ConstIterator = ezFlatHashMapBaseConstIterator<KeyType, ValueType, Hasher>;
+
+protected:
+  /// \brief Creates an empty hashmap. Does not allocate any data yet.
+  explicit ezFlatHashMapBase(ezAllocator* pAllocator); // [tested]
+
+  /// \brief Creates a copy of the given hashmap.
+  ezFlatHashMapBase(const ezFlatHashMapBase<KeyType, ValueType, Hasher>& rhs, ezAllocator* pAllocator); // [tested]
+
+  /// \brief Moves data from an existing hashmap into this one.
+  ezFlatHashMapBase(ezFlatHashMapBase<KeyType, ValueType, Hasher>&& rhs, ezAllocator* pAllocator); // [tested]
+
+  /// \brief Destructor.
+  ~ezFlatHashMapBase(); // [tested]
+
+  /// \brief Copies the data from another hashmap into this one.
+  void operator=(const ezFlatHashMapBase<KeyType, ValueType, Hasher>& rhs); // [tested]
+
+  /// \brief Moves data from an existing hashmap into this one.
+  void operator=(ezFlatHashMapBase<KeyType, ValueType, Hasher>&& rhs); // [tested]
+
+public:
+  /// \brief Compares this map to another map.
+  bool operator==(const ezFlatHashMapBase<KeyType, ValueType, Hasher>& rhs) const; // [tested]
+  EZ_ADD_DEFAULT_OPERATOR_NOTEQUAL(const ezFlatHashMapBase<KeyType, ValueType, Hasher>&);
+
+  /// \brief Expands the hashmap by over-allocating the internal storage so that the load factor is lower or equal to 87.5% when inserting the
+  /// given number of entries.
+  void Reserve(ezUInt32 uiCapacity); // [tested]
+
+  /// \brief Tries to compact the hashmap to avoid wasting memory. This also gets rid of all deleted slots.
+  ///
+  /// The resulting capacity is at least 'GetCount' (no elements get removed).
+  /// Will deallocate all data, if the hashmap is empty.
+  void Compact(); // [tested]
+
+  /// \brief Returns the number of active entries in the map.
+  ezUInt32 GetCount() const; // [tested]
+
+  /// \brief Returns true, if the hashmap does not contain any elements.
+  bool IsEmpty() const; // [tested]
+
+  /// \brief Clears the map.
+  void Clear(); // [tested]
+
+  /// \brief Inserts the key value pair or replaces value if an entry with the given key already exists.
+  ///
+  /// Returns true if an existing value was replaced and optionally writes out the old value to out_oldValue.
+  template <typename CompatibleKeyType, typename CompatibleValueType>
+  bool Insert(CompatibleKeyType&& key, CompatibleValueType&& value, ValueType* out_pOldValue = nullptr); // [tested]
+
+  /// \brief Removes the entry with the given key. Returns whether an entry was removed and optionally writes out the old value to out_oldValue.
+  template <typename CompatibleKeyType>
+  bool Remove(const CompatibleKeyType& key, ValueType* out_pOldValue = nullptr); // [tested]
+
+  /// \brief Erases the key/value pair at the given Iterator. Returns an iterator to the element after the given iterator.
+  Iterator Remove(const Iterator& pos); // [tested]
+
+  /// \brief Cannot remove an element with just a ezFlatHashMapBaseConstIterator
+  void Remove(const ConstIterator& pos) = delete;
+
+  /// \brief Returns whether an entry with the given key was found and if found writes out the corresponding value to out_value.
+  template <typename CompatibleKeyType>
+  bool TryGetValue(const CompatibleKeyType& key, ValueType& out_value) const; // [tested]
+
+  /// \brief Returns whether an entry with the given key was found and if found writes out the pointer to the corresponding value to out_pValue.
+  template <typename CompatibleKeyType>
+  bool TryGetValue(const CompatibleKeyType& key, const ValueType*& out_pValue) const; // [tested]
+
+  /// \brief Returns whether an entry with the given key was found and if found writes out the pointer to the corresponding value to out_pValue.
+  template <typename CompatibleKeyType>
+  bool TryGetValue(const CompatibleKeyType& key, ValueType*& out_pValue) const; // [tested]
+
+  /// \brief Searches for key, returns a ezFlatHashMapBaseConstIterator to it or an invalid iterator, if no such key is found. O(1) operation.
+  template <typename CompatibleKeyType>
+  ConstIterator Find(const CompatibleKeyType& key) const;
+
+  /// \brief Searches for key, returns an Iterator to it or an invalid iterator, if no such key is found. O(1) operation.
+  template <typename CompatibleKeyType>
+  Iterator Find(const CompatibleKeyType& key);
+
+  /// \brief Returns a pointer to the value of the entry with the given key if found, otherwise returns nullptr.
+  template <typename CompatibleKeyType>
+  const ValueType* GetValue(const CompatibleKeyType& key) const; // [tested]
+
+  /// \brief Returns a pointer to the value of the entry with the given key if found, otherwise returns nullptr.
+  template <typename CompatibleKeyType>
+  ValueType* GetValue(const CompatibleKeyType& key); // [tested]
+
+  /// \brief Returns the value to the given key if found or creates a new entry with the given key and a default constructed value.
+  ValueType& operator[](const KeyType& key); // [tested]
+
+  /// \brief Returns the value stored at the given key. If none exists, one is created. \a bExisted indicates whether an element needed to be created.
+  ValueType& FindOrAdd(const KeyType& key, bool* out_pExisted = nullptr); // [tested]
+
+  /// \brief Returns if an entry with given key exists in the map.
+  template <typename CompatibleKeyType>
+  bool Contains(const CompatibleKeyType& key) const; // [tested]
+
+  /// \brief Returns an Iterator to the very first element.
+  Iterator GetIterator(); // [tested]
+
+  /// \brief Returns an Iterator to the first element that is not part of the hashmap. Needed to support range based for loops.
+  Iterator GetEndIterator(); // [tested]
+
+  /// \brief Returns a constant Iterator to the very first element.
+  ConstIterator GetIterator() const; // [tested]
+
+  /// \brief Returns a ezFlatHashMapBaseConstIterator to the first element that is not part of the hashmap. Needed to support range based for loops.
+  ConstIterator GetEndIterator() const; // [tested]
+
+  /// \brief Returns the allocator that is used by this instance.
+  ezAllocator* GetAllocator() const;
+
+  /// \brief Returns the amount of bytes that are currently allocated on the heap.
+  ezUInt64 GetHeapMemoryUsage() const; // [tested]
+
+  /// \brief Swaps this map with the other one.
+  void Swap(ezFlatHashMapBase<KeyType, ValueType, Hasher>& other); // [tested]
+
+private:
+  friend struct ezFlatHashMapBaseConstIterator<KeyType, ValueType, Hasher>;
+  friend struct ezFlatHashMapBaseIterator<KeyType, ValueType, Hasher>;
+
+  struct Entry
+  {
+    KeyType key;
+    ValueType value;
+  };
+
+  Entry* m_pEntries = nullptr;
+  ezUInt8* m_pControl = nullptr;
+
+  ezUInt32 m_uiCount = 0;
+  ezUInt32 m_uiCapacity = 0;
+  ezUInt32 m_uiGrowthLeft = 0; // number of empty slots that may still be filled before the table needs to be rehashed
+
+  ezAllocator* m_pAllocator = nullptr;
+
+  using Group = ezInternal::ezFlatHashGroup;
+
+  void SetCapacity(ezUInt32 uiCapacity);
+
+  void RemoveInternal(ezUInt32 uiIndex);
+
+  template <typename CompatibleKeyType>
+  ezUInt32 FindEntry(const CompatibleKeyType& key) const;
+
+  template <typename CompatibleKeyType>
+  ezUInt32 FindEntry(ezUInt32 uiHash, const CompatibleKeyType& key) const;
+
+  /// \brief Returns the first empty or deleted slot in the probe sequence of the given hash.
+  ezUInt32 FindFreeSlot(ezUInt32 uiHash) const;
+
+  /// \brief Finds a free slot for a new entry with the given hash, grows the table if necessary and marks the slot as valid.
+  ezUInt32 PrepareInsert(ezUInt32 uiHash);
+
+  bool IsValidEntry(ezUInt32 uiEntryIndex) const;
+};
+
+/// \brief \see ezFlatHashMapBase
+template <typename KeyType, typename ValueType, typename Hasher = ezHashHelper<KeyType>, typename AllocatorWrapper = ezDefaultAllocatorWrapper>
+class ezFlatHashMap : public ezFlatHashMapBase<KeyType, ValueType, Hasher>
+{
+public:
+  ezFlatHashMap();
+  explicit ezFlatHashMap(ezAllocator* pAllocator);
+
+  ezFlatHashMap(const ezFlatHashMap<KeyType, ValueType, Hasher, AllocatorWrapper>& other);
+  ezFlatHashMap(const ezFlatHashMapBase<KeyType, ValueType, Hasher>& other);
+
+  ezFlatHashMap(ezFlatHashMap<KeyType, ValueType, Hasher, AllocatorWrapper>&& other);
+  ezFlatHashMap(ezFlatHashMapBase<KeyType, ValueType, Hasher>&& other);
+
+
+  void operator=(const ezFlatHashMap<KeyType, ValueType, Hasher, AllocatorWrapper>& rhs);
+  void operator=(const ezFlatHashMapBase<KeyType, ValueType, Hasher>& rhs);
+
+  void operator=(ezFlatHashMap<KeyType, ValueType, Hasher, AllocatorWrapper>&& rhs);
+  void operator=(ezFlatHashMapBase<KeyType, ValueType, Hasher>&& rhs);
+};
+
+//////////////////////////////////////////////////////////////////////////
+// begin() /end() for range-based for-loop support
+
+template <typename KeyType, typename ValueType, typename Hasher>
+typename ezFlatHashMapBase<KeyType, ValueType, Hasher>::Iterator begin(ezFlatHashMapBase<KeyType, ValueType, Hasher>& ref_container)
+{
+  return ref_container.GetIterator();
+}
+
+template <typename KeyType, typename ValueType, typename Hasher>
+typename ezFlatHashMapBase<KeyType, ValueType, Hasher>::ConstIterator begin(const ezFlatHashMapBase<KeyType, ValueType, Hasher>& container)
+{
+  return container.GetIterator();
+}
+
+template <typename KeyType, typename ValueType, typename Hasher>
+typename ezFlatHashMapBase<KeyType, ValueType, Hasher>::ConstIterator cbegin(const ezFlatHashMapBase<KeyType, ValueType, Hasher>& container)
+{
+  return container.GetIterator();
+}
+
+template <typename KeyType, typename ValueType, typename Hasher>
+typename ezFlatHashMapBase<KeyType, ValueType, Hasher>::Iterator end(ezFlatHashMapBase<KeyType, ValueType, Hasher>& ref_container)
+{
+  return ref_container.GetEndIterator();
+}
+
+template <typename KeyType, typename ValueType, typename Hasher>
+typename ezFlatHashMapBase<KeyType, ValueType, Hasher>::ConstIterator end(const ezFlatHashMapBase<KeyType, ValueType, Hasher>& container)
+{
+  return container.GetEndIterator();
+}
+
+template <typename KeyType, typename ValueType, typename Hasher>
+typename ezFlatHashMapBase<KeyType, ValueType, Hasher>::ConstIterator cend(const ezFlatHashMapBase<KeyType, ValueType, Hasher>& container)
+{
+  return container.GetEndIterator();
+}
+
+#include <Foundation/Containers/Implementation/FlatHashMap_inl.h>
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <Foundation/Math/Math.h>
+
+#if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE
+#  include <emmintrin.h>
+#elif EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_NEON
+#  include <arm_neon.h>
+#endif
+
+namespace ezInternal
+{
+  /// \brief Helper for the control bytes of ezFlatHashMap and ezFlatHashSet.
+  ///
+  /// Each slot in a flat hash container has one control byte. The high bit is set for empty and deleted slots,
+  /// valid slots store the top 7 bits of the key's hash instead. The control bytes of 16 consecutive slots form a group,
+  /// which can be compared against a hash fragment with a single SIMD instruction.
+  struct ezFlatHashGroup
+  {
+    enum : ezUInt8
+    {
+      EMPTY = 0x80,
+      DELETED = 0xFE,
+    };
+
+    static constexpr ezUInt32 WIDTH = 16;
+
+    /// \brief Returns the 7 bit hash fragment that is stored in the control byte of a valid slot.
+    EZ_ALWAYS_INLINE static ezUInt8 GetHashFragment(ezUInt32 uiHash) { return static_cast<ezUInt8>(uiHash >> 25); }
+
+    EZ_ALWAYS_INLINE static bool IsFull(ezUInt8 uiControl) { return (uiControl & 0x80) == 0; }
+
+    EZ_ALWAYS_INLINE explicit ezFlatHashGroup(const ezUInt8* pControl)
+    {
+#if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE
+      m_Control = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pControl));
+#elif EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_NEON
+      m_Control = vld1q_u8(pControl);
+#else
+      ezMemoryUtils::RawByteCopy(m_Control, pControl, WIDTH);
+#endif
+    }
+
+    /// \brief Returns a bit mask of all slots in this group whose control byte equals the given hash fragment.
+    EZ_ALWAYS_INLINE ezUInt32 Match(ezUInt8 uiHashFragment) const
+    {
+#if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE
+      return static_cast<ezUInt32>(_mm_movemask_epi8(_mm_cmpeq_epi8(m_Control, _mm_set1_epi8(static_cast<char>(uiHashFragment)))));
+#elif EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_NEON
+      return ToBitMask(vceqq_u8(m_Control, vdupq_n_u8(uiHashFragment)));
+#else
+      ezUInt32 uiMask = 0;
+      for (ezUInt32 i = 0; i < WIDTH; ++i)
+      {
+        uiMask |= (m_Control[i] == uiHashFragment) ? (1u << i) : 0u;
+      }
+      return uiMask;
+#endif
+    }
+
+    /// \brief Returns a bit mask of all empty slots in this group.
+    EZ_ALWAYS_INLINE ezUInt32 MatchEmpty() const { return Match(EMPTY); }
+
+    /// \brief Returns a bit mask of all slots in this group that are either empty or deleted.
+    EZ_ALWAYS_INLINE ezUInt32 MatchEmptyOrDeleted() const
+    {
+#if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE
+      return static_cast<ezUInt32>(_mm_movemask_epi8(m_Control));
+#elif EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_NEON
+      return ToBitMask(vcltzq_s8(vreinterpretq_s8_u8(m_Control)));
+#else
+      ezUInt32 uiMask = 0;
+      for (ezUInt32 i = 0; i < WIDTH; ++i)
+      {
+        uiMask |= IsFull(m_Control[i]) ? 0u : (1u << i);
+      }
+      return uiMask;
+#endif
+    }
+
+  private:
+#if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE
+    __m128i m_Control;
+#elif EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_NEON
+    uint8x16_t m_Control;
+
+    EZ_ALWAYS_INLINE static ezUInt32 ToBitMask(uint8x16_t compareResult)
+    {
+      // NEON has no movemask, so weight each lane with its bit and sum up each half
+      static constexpr ezUInt8 s_BitWeights[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+      const uint8x16_t masked = vandq_u8(compareResult, vld1q_u8(s_BitWeights));
+      return static_cast<ezUInt32>(vaddv_u8(vget_low_u8(masked))) | (static_cast<ezUInt32>(vaddv_u8(vget_high_u8(masked))) << 8);
+    }
+#else
+    ezUInt8 m_Control[WIDTH];
+#endif
+  };
+} // namespace ezInternal
@@ -0,0 +1,817 @@
+
+/// \brief Value used by containers for indices to indicate an invalid index.
+#ifndef ezInvalidIndex
+#  define ezInvalidIndex 0xFFFFFFFF
+#endif
+
+// ***** Const Iterator *****
+
+template <typename K, typename V, typename H>
+ezFlatHashMapBaseConstIterator<K, V, H>::ezFlatHashMapBaseConstIterator(const ezFlatHashMapBase<K, V, H>& map)
+  : m_pMap(&map)
+{
+}
+
+template <typename K, typename V, typename H>
+void ezFlatHashMapBaseConstIterator<K, V, H>::SetToBegin()
+{
+  if (m_pMap->IsEmpty())
+  {
+    m_uiCurrentIndex = m_pMap->m_uiCapacity;
+    return;
+  }
+  while (!m_pMap->IsValidEntry(m_uiCurrentIndex))
+  {
+    ++m_uiCurrentIndex;
+  }
+}
+
+template <typename K, typename V, typename H>
+inline void ezFlatHashMapBaseConstIterator<K, V, H>::SetToEnd()
+{
+  m_uiCurrentCount = m_pMap->m_uiCount;
+  m_uiCurrentIndex = m_pMap->m_uiCapacity;
+}
+
+
+template <typename K, typename V, typename H>
+EZ_FORCE_INLINE bool ezFlatHashMapBaseConstIterator<K, V, H>::IsValid() const
+{
+  return m_uiCurrentCount < m_pMap->m_uiCount;
+}
+
+template <typename K, typename V, typename H>
+EZ_FORCE_INLINE bool ezFlatHashMapBaseConstIterator<K, V, H>::operator==(const ezFlatHashMapBaseConstIterator<K, V, H>& rhs) const
+{
+  return m_uiCurrentIndex == rhs.m_uiCurrentIndex && m_pMap->m_pEntries == rhs.m_pMap->m_pEntries;
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE const K& ezFlatHashMapBaseConstIterator<K, V, H>::Key() const
+{
+  return m_pMap->m_pEntries[m_uiCurrentIndex].key;
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE const V& ezFlatHashMapBaseConstIterator<K, V, H>::Value() const
+{
+  return m_pMap->m_pEntries[m_uiCurrentIndex].value;
+}
+
+template <typename K, typename V, typename H>
+void ezFlatHashMapBaseConstIterator<K, V, H>::Next()
+{
+  // if we already iterated over the amount of valid elements that the hash-table stores, early out
+  if (m_uiCurrentCount >= m_pMap->m_uiCount)
+    return;
+
+  // increase the counter of how many elements we have seen
+  ++m_uiCurrentCount;
+  // increase the index of the element to look at
+  ++m_uiCurrentIndex;
+
+  // check that we don't leave the valid range of element indices
+  while (m_uiCurrentIndex < m_pMap->m_uiCapacity)
+  {
+    if (m_pMap->IsValidEntry(m_uiCurrentIndex))
+      return;
+
+    ++m_uiCurrentIndex;
+  }
+
+  // if we fell through this loop, we reached the end of all elements in the container
+  // set the m_uiCurrentCount to maximum, to enable early-out in the future and to make 'IsValid' return 'false'
+  m_uiCurrentCount = m_pMap->m_uiCount;
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE void ezFlatHashMapBaseConstIterator<K, V, H>::operator++()
+{
+  Next();
+}
+
+#if EZ_ENABLED(EZ_USE_CPP20_OPERATORS)
+// These functions are used for structured bindings.
+// They describe how many elements can be accessed in the binding and which type they are.
+namespace std
+{
+  template <typename K, typename V, typename H>
+  struct tuple_size<ezFlatHashMapBaseConstIterator<K, V, H>> : integral_constant<size_t, 2>
+  {
+  };
+
+  template <typename K, typename V, typename H>
+  struct tuple_element<0, ezFlatHashMapBaseConstIterator<K, V, H>>
+  {
+    using type = const K&;
+  };
+
+  template <typename K, typename V, typename H>
+  struct tuple_element<1, ezFlatHashMapBaseConstIterator<K, V, H>>
+  {
+    using type = const V&;
+  };
+} // namespace std
+#endif
+
+// ***** Iterator *****
+
+template <typename K, typename V, typename H>
+ezFlatHashMapBaseIterator<K, V, H>::ezFlatHashMapBaseIterator(const ezFlatHashMapBase<K, V, H>& map)
+  : ezFlatHashMapBaseConstIterator<K, V, H>(map)
+{
+}
+
+template <typename K, typename V, typename H>
+ezFlatHashMapBaseIterator<K, V, H>::ezFlatHashMapBaseIterator(const ezFlatHashMapBaseIterator<K, V, H>& rhs)
+  : ezFlatHashMapBaseConstIterator<K, V, H>(*rhs.m_pMap)
+{
+  this->m_uiCurrentIndex = rhs.m_uiCurrentIndex;
+  this->m_uiCurrentCount = rhs.m_uiCurrentCount;
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE void ezFlatHashMapBaseIterator<K, V, H>::operator=(const ezFlatHashMapBaseIterator& rhs) // [tested]
+{
+  this->m_pMap = rhs.m_pMap;
+  this->m_uiCurrentIndex = rhs.m_uiCurrentIndex;
+  this->m_uiCurrentCount = rhs.m_uiCurrentCount;
+}
+
+template <typename K, typename V, typename H>
+EZ_FORCE_INLINE V& ezFlatHashMapBaseIterator<K, V, H>::Value()
+{
+  return this->m_pMap->m_pEntries[this->m_uiCurrentIndex].value;
+}
+
+template <typename K, typename V, typename H>
+EZ_FORCE_INLINE V& ezFlatHashMapBaseIterator<K, V, H>::Value() const
+{
+  return this->m_pMap->m_pEntries[this->m_uiCurrentIndex].value;
+}
+
+
+#if EZ_ENABLED(EZ_USE_CPP20_OPERATORS)
+// These functions are used for structured bindings.
+// They describe how many elements can be accessed in the binding and which type they are.
+namespace std
+{
+  template <typename K, typename V, typename H>
+  struct tuple_size<ezFlatHashMapBaseIterator<K, V, H>> : integral_constant<size_t, 2>
+  {
+  };
+
+  template <typename K, typename V, typename H>
+  struct tuple_element<0, ezFlatHashMapBaseIterator<K, V, H>>
+  {
+    using type = const K&;
+  };
+
+  template <typename K, typename V, typename H>
+  struct tuple_element<1, ezFlatHashMapBaseIterator<K, V, H>>
+  {
+    using type = V&;
+  };
+} // namespace std
+#endif
+
+// ***** ezFlatHashMapBase *****
+
+template <typename K, typename V, typename H>
+ezFlatHashMapBase<K, V, H>::ezFlatHashMapBase(ezAllocator* pAllocator)
+{
+  m_pAllocator = pAllocator;
+}
+
+template <typename K, typename V, typename H>
+ezFlatHashMapBase<K, V, H>::ezFlatHashMapBase(const ezFlatHashMapBase<K, V, H>& other, ezAllocator* pAllocator)
+{
+  m_pAllocator = pAllocator;
+
+  *this = other;
+}
+
+template <typename K, typename V, typename H>
+ezFlatHashMapBase<K, V, H>::ezFlatHashMapBase(ezFlatHashMapBase<K, V, H>&& other, ezAllocator* pAllocator)
+{
+  m_pAllocator = pAllocator;
+
+  *this = std::move(other);
+}
+
+template <typename K, typename V, typename H>
+ezFlatHashMapBase<K, V, H>::~ezFlatHashMapBase()
+{
+  Clear();
+  EZ_DELETE_RAW_BUFFER(m_pAllocator, m_pEntries);
+  EZ_DELETE_RAW_BUFFER(m_pAllocator, m_pControl);
+  m_uiCapacity = 0;
+  m_uiGrowthLeft = 0;
+}
+
+template <typename K, typename V, typename H>
+void ezFlatHashMapBase<K, V, H>::operator=(const ezFlatHashMapBase<K, V, H>& rhs)
+{
+  Clear();
+  Reserve(rhs.GetCount());
+
+  ezUInt32 uiCopied = 0;
+  for (ezUInt32 i = 0; uiCopied < rhs.GetCount(); ++i)
+  {
+    if (rhs.IsValidEntry(i))
+    {
+      Insert(rhs.m_pEntries[i].key, rhs.m_pEntries[i].value);
+      ++uiCopied;
+    }
+  }
+}
+
+template <typename K, typename V, typename H>
+void ezFlatHashMapBase<K, V, H>::operator=(ezFlatHashMapBase<K, V, H>&& rhs)
+{
+  // Clear any existing data (calls destructors if necessary)
+  Clear();
+
+  if (m_pAllocator != rhs.m_pAllocator)
+  {
+    Reserve(rhs.m_uiCount);
+
+    ezUInt32 uiCopied = 0;
+    for (ezUInt32 i = 0; uiCopied < rhs.GetCount(); ++i)
+    {
+      if (rhs.IsValidEntry(i))
+      {
+        Insert(std::move(rhs.m_pEntries[i].key), std::move(rhs.m_pEntries[i].value));
+        ++uiCopied;
+      }
+    }
+
+    rhs.Clear();
+  }
+  else
+  {
+    EZ_DELETE_RAW_BUFFER(m_pAllocator, m_pEntries);
+    EZ_DELETE_RAW_BUFFER(m_pAllocator, m_pControl);
+
+    // Move all data over.
+    m_pEntries = rhs.m_pEntries;
+    m_pControl = rhs.m_pControl;
+    m_uiCount = rhs.m_uiCount;
+    m_uiCapacity = rhs.m_uiCapacity;
+    m_uiGrowthLeft = rhs.m_uiGrowthLeft;
+
+    // Temp copy forgets all its state.
+    rhs.m_pEntries = nullptr;
+    rhs.m_pControl = nullptr;
+    rhs.m_uiCount = 0;
+    rhs.m_uiCapacity = 0;
+    rhs.m_uiGrowthLeft = 0;
+  }
+}
+
+template <typename K, typename V, typename H>
+bool ezFlatHashMapBase<K, V, H>::operator==(const ezFlatHashMapBase<K, V, H>& rhs) const
+{
+  if (m_uiCount != rhs.m_uiCount)
+    return false;
+
+  ezUInt32 uiCompared = 0;
+  for (ezUInt32 i = 0; uiCompared < m_uiCount; ++i)
+  {
+    if (IsValidEntry(i))
+    {
+      const V* pRhsValue = nullptr;
+      if (!rhs.TryGetValue(m_pEntries[i].key, pRhsValue))
+        return false;
+
+      if (m_pEntries[i].value != *pRhsValue)
+        return false;
+
+      ++uiCompared;
+    }
+  }
+
+  return true;
+}
+
+template <typename K, typename V, typename H>
+void ezFlatHashMapBase<K, V, H>::Reserve(ezUInt32 uiCapacity)
+{
+  const ezUInt64 uiCap64 = static_cast<ezUInt64>(uiCapacity);
+  ezUInt64 uiNewCapacity64 = uiCap64 + (uiCap64 / 7) + 1;                  // ensure a maximum load of 87.5%
+
+  uiNewCapacity64 = ezMath::Min<ezUInt64>(uiNewCapacity64, 0x80000000llu); // the largest power-of-two in 32 bit
+
+  ezUInt32 uiNewCapacity32 = static_cast<ezUInt32>(uiNewCapacity64 & 0xFFFFFFFF);
+  EZ_ASSERT_DEBUG(uiCapacity <= uiNewCapacity32, "ezFlatHashSet/Map do not support more than 2 billion entries.");
+
+  if (m_uiCapacity >= uiNewCapacity32)
+    return;
+
+  uiNewCapacity32 = ezMath::Max<ezUInt32>(ezMath::PowerOfTwo_Ceil(uiNewCapacity32), Group::WIDTH);
+  SetCapacity(uiNewCapacity32);
+}
+
+template <typename K, typename V, typename H>
+void ezFlatHashMapBase<K, V, H>::Compact()
+{
+  if (IsEmpty())
+  {
+    // completely deallocate all data, if the table is empty.
+    EZ_DELETE_RAW_BUFFER(m_pAllocator, m_pEntries);
+    EZ_DELETE_RAW_BUFFER(m_pAllocator, m_pControl);
+    m_uiCapacity = 0;
+    m_uiGrowthLeft = 0;
+  }
+  else
+  {
+    const ezUInt32 uiNewCapacity = ezMath::Max<ezUInt32>(ezMath::PowerOfTwo_Ceil(m_uiCount + (m_uiCount / 7) + 1), Group::WIDTH);
+
+    // rehashing at the same capacity gets rid of all deleted slots
+    SetCapacity(uiNewCapacity);
+  }
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE ezUInt32 ezFlatHashMapBase<K, V, H>::GetCount() const
+{
+  return m_uiCount;
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE bool ezFlatHashMapBase<K, V, H>::IsEmpty() const
+{
+  return m_uiCount == 0;
+}
+
+template <typename K, typename V, typename H>
+void ezFlatHashMapBase<K, V, H>::Clear()
+{
+  for (ezUInt32 i = 0; i < m_uiCapacity; ++i)
+  {
+    if (IsValidEntry(i))
+    {
+      ezMemoryUtils::Destruct(&m_pEntries[i].key, 1);
+      ezMemoryUtils::Destruct(&m_pEntries[i].value, 1);
+    }
+  }
+
+  ezMemoryUtils::PatternFill(m_pControl, Group::EMPTY, m_uiCapacity);
+  m_uiCount = 0;
+  m_uiGrowthLeft = m_uiCapacity - (m_uiCapacity / 8);
+}
+
+template <typename K, typename V, typename H>
+template <typename CompatibleKeyType, typename CompatibleValueType>
+bool ezFlatHashMapBase<K, V, H>::Insert(CompatibleKeyType&& key, CompatibleValueType&& value, V* out_pOldValue /*= nullptr*/)
+{
+  const ezUInt32 uiHash = H::Hash(key);
+  ezUInt32 uiIndex = FindEntry(uiHash, key);
+
+  if (uiIndex != ezInvalidIndex)
+  {
+    if (out_pOldValue != nullptr)
+      *out_pOldValue = std::move(m_pEntries[uiIndex].value);
+
+    m_pEntries[uiIndex].value = std::forward<CompatibleValueType>(value); // Either move or copy assignment.
+    return true;
+  }
+
+  // new entry
+  uiIndex = PrepareInsert(uiHash);
+
+  // Both constructions might either be a move or a copy.
+  ezMemoryUtils::CopyOrMoveConstruct(&m_pEntries[uiIndex].key, std::forward<CompatibleKeyType>(key));
+  ezMemoryUtils::CopyOrMoveConstruct(&m_pEntries[uiIndex].value, std::forward<CompatibleValueType>(value));
+  ++m_uiCount;
+
+  return false;
+}
+
+template <typename K, typename V, typename H>
+template <typename CompatibleKeyType>
+bool ezFlatHashMapBase<K, V, H>::Remove(const CompatibleKeyType& key, V* out_pOldValue /*= nullptr*/)
+{
+  ezUInt32 uiIndex = FindEntry(key);
+  if (uiIndex != ezInvalidIndex)
+  {
+    if (out_pOldValue != nullptr)
+      *out_pOldValue = std::move(m_pEntries[uiIndex].value);
+
+    RemoveInternal(uiIndex);
+    return true;
+  }
+
+  return false;
+}
+
+template <typename K, typename V, typename H>
+typename ezFlatHashMapBase<K, V, H>::Iterator ezFlatHashMapBase<K, V, H>::Remove(const typename ezFlatHashMapBase<K, V, H>::Iterator& pos)
+{
+  EZ_ASSERT_DEBUG(pos.m_pMap == this, "Iterator from wrong hashmap");
+  Iterator it = pos;
+  ezUInt32 uiIndex = pos.m_uiCurrentIndex;
+  ++it;
+  --it.m_uiCurrentCount;
+  RemoveInternal(uiIndex);
+  return it;
+}
+
+template <typename K, typename V, typename H>
+void ezFlatHashMapBase<K, V, H>::RemoveInternal(ezUInt32 uiIndex)
+{
+  ezMemoryUtils::Destruct(&m_pEntries[uiIndex].key, 1);
+  ezMemoryUtils::Destruct(&m_pEntries[uiIndex].value, 1);
+
+  // if the group still has an empty slot, no probe sequence ever continued past it
+  // and the slot can be marked as empty again, otherwise it has to stay a tombstone
+  const Group group(m_pControl + (uiIndex & ~(Group::WIDTH - 1)));
+  if (group.MatchEmpty() != 0)
+  {
+    m_pControl[uiIndex] = Group::EMPTY;
+    ++m_uiGrowthLeft;
+  }
+  else
+  {
+    m_pControl[uiIndex] = Group::DELETED;
+  }
+
+  --m_uiCount;
+}
+
+template <typename K, typename V, typename H>
+template <typename CompatibleKeyType>
+inline bool ezFlatHashMapBase<K, V, H>::TryGetValue(const CompatibleKeyType& key, V& out_value) const
+{
+  ezUInt32 uiIndex = FindEntry(key);
+  if (uiIndex != ezInvalidIndex)
+  {
+    EZ_ASSERT_DEBUG(m_pEntries != nullptr, "No entries present"); // To fix static analysis
+    out_value = m_pEntries[uiIndex].value;
+    return true;
+  }
+
+  return false;
+}
+
+template <typename K, typename V, typename H>
+template <typename CompatibleKeyType>
+inline bool ezFlatHashMapBase<K, V, H>::TryGetValue(const CompatibleKeyType& key, const V*& out_pValue) const
+{
+  ezUInt32 uiIndex = FindEntry(key);
+  if (uiIndex != ezInvalidIndex)
+  {
+    out_pValue = &m_pEntries[uiIndex].value;
+    EZ_ANALYSIS_ASSUME(out_pValue != nullptr);
+    return true;
+  }
+
+  return false;
+}
+
+template <typename K, typename V, typename H>
+template <typename CompatibleKeyType>
+inline bool ezFlatHashMapBase<K, V, H>::TryGetValue(const CompatibleKeyType& key, V*& out_pValue) const
+{
+  ezUInt32 uiIndex = FindEntry(key);
+  if (uiIndex != ezInvalidIndex)
+  {
+    out_pValue = &m_pEntries[uiIndex].value;
+    EZ_ANALYSIS_ASSUME(out_pValue != nullptr);
+    return true;
+  }
+
+  return false;
+}
+
+template <typename K, typename V, typename H>
+template <typename CompatibleKeyType>
+inline typename ezFlatHashMapBase<K, V, H>::ConstIterator ezFlatHashMapBase<K, V, H>::Find(const CompatibleKeyType& key) const
+{
+  ezUInt32 uiIndex = FindEntry(key);
+  if (uiIndex == ezInvalidIndex)
+  {
+    return GetEndIterator();
+  }
+
+  ConstIterator it(*this);
+  it.m_uiCurrentIndex = uiIndex;
+  it.m_uiCurrentCount = 0; // we do not know the 'count' (which is used as an optimization), so we just use 0
+
+  return it;
+}
+
+template <typename K, typename V, typename H>
+template <typename CompatibleKeyType>
+inline typename ezFlatHashMapBase<K, V, H>::Iterator ezFlatHashMapBase<K, V, H>::Find(const CompatibleKeyType& key)
+{
+  ezUInt32 uiIndex = FindEntry(key);
+  if (uiIndex == ezInvalidIndex)
+  {
+    return GetEndIterator();
+  }
+
+  Iterator it(*this);
+  it.m_uiCurrentIndex = uiIndex;
+  it.m_uiCurrentCount = 0; // we do not know the 'count' (which is used as an optimization), so we just use 0
+  return it;
+}
+
+template <typename K, typename V, typename H>
+template <typename CompatibleKeyType>
+inline const V* ezFlatHashMapBase<K, V, H>::GetValue(const CompatibleKeyType& key) const
+{
+  ezUInt32 uiIndex = FindEntry(key);
+  return (uiIndex != ezInvalidIndex) ? &m_pEntries[uiIndex].value : nullptr;
+}
+
+template <typename K, typename V, typename H>
+template <typename CompatibleKeyType>
+inline V* ezFlatHashMapBase<K, V, H>::GetValue(const CompatibleKeyType& key)
+{
+  ezUInt32 uiIndex = FindEntry(key);
+  return (uiIndex != ezInvalidIndex) ? &m_pEntries[uiIndex].value : nullptr;
+}
+
+template <typename K, typename V, typename H>
+inline V& ezFlatHashMapBase<K, V, H>::operator[](const K& key)
+{
+  return FindOrAdd(key, nullptr);
+}
+
+template <typename K, typename V, typename H>
+V& ezFlatHashMapBase<K, V, H>::FindOrAdd(const K& key, bool* out_pExisted)
+{
+  const ezUInt32 uiHash = H::Hash(key);
+  ezUInt32 uiIndex = FindEntry(uiHash, key);
+
+  if (out_pExisted)
+  {
+    *out_pExisted = uiIndex != ezInvalidIndex;
+  }
+
+  if (uiIndex == ezInvalidIndex)
+  {
+    uiIndex = PrepareInsert(uiHash);
+
+    // new entry
+    ezMemoryUtils::CopyConstruct(&m_pEntries[uiIndex].key, key, 1);
+    ezMemoryUtils::Construct<ConstructAll>(&m_pEntries[uiIndex].value, 1);
+    ++m_uiCount;
+  }
+
+  EZ_ASSERT_DEBUG(m_pEntries != nullptr, "Entries should be present");
+  return m_pEntries[uiIndex].value;
+}
+
+template <typename K, typename V, typename H>
+template <typename CompatibleKeyType>
+EZ_FORCE_INLINE bool ezFlatHashMapBase<K, V, H>::Contains(const CompatibleKeyType& key) const
+{
+  return FindEntry(key) != ezInvalidIndex;
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE typename ezFlatHashMapBase<K, V, H>::Iterator ezFlatHashMapBase<K, V, H>::GetIterator()
+{
+  Iterator iterator(*this);
+  iterator.SetToBegin();
+  return iterator;
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE typename ezFlatHashMapBase<K, V, H>::Iterator ezFlatHashMapBase<K, V, H>::GetEndIterator()
+{
+  Iterator iterator(*this);
+  iterator.SetToEnd();
+  return iterator;
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE typename ezFlatHashMapBase<K, V, H>::ConstIterator ezFlatHashMapBase<K, V, H>::GetIterator() const
+{
+  ConstIterator iterator(*this);
+  iterator.SetToBegin();
+  return iterator;
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE typename ezFlatHashMapBase<K, V, H>::ConstIterator ezFlatHashMapBase<K, V, H>::GetEndIterator() const
+{
+  ConstIterator iterator(*this);
+  iterator.SetToEnd();
+  return iterator;
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE ezAllocator* ezFlatHashMapBase<K, V, H>::GetAllocator() const
+{
+  return m_pAllocator;
+}
+
+template <typename K, typename V, typename H>
+ezUInt64 ezFlatHashMapBase<K, V, H>::GetHeapMemoryUsage() const
+{
+  return (ezUInt64)m_uiCapacity * (sizeof(Entry) + sizeof(ezUInt8));
+}
+
+template <typename KeyType, typename ValueType, typename Hasher>
+void ezFlatHashMapBase<KeyType, ValueType, Hasher>::Swap(ezFlatHashMapBase<KeyType, ValueType, Hasher>& other)
+{
+  ezMath::Swap(this->m_pEntries, other.m_pEntries);
+  ezMath::Swap(this->m_pControl, other.m_pControl);
+  ezMath::Swap(this->m_uiCount, other.m_uiCount);
+  ezMath::Swap(this->m_uiCapacity, other.m_uiCapacity);
+  ezMath::Swap(this->m_uiGrowthLeft, other.m_uiGrowthLeft);
+  ezMath::Swap(this->m_pAllocator, other.m_pAllocator);
+}
+
+// private methods
+template <typename K, typename V, typename H>
+void ezFlatHashMapBase<K, V, H>::SetCapacity(ezUInt32 uiCapacity)
+{
+  EZ_ASSERT_DEBUG(ezMath::IsPowerOf2(uiCapacity) && uiCapacity >= Group::WIDTH, "uiCapacity must be a power of two and at least one group.");
+  const ezUInt32 uiOldCapacity = m_uiCapacity;
+  m_uiCapacity = uiCapacity;
+
+  Entry* pOldEntries = m_pEntries;
+  ezUInt8* pOldControl = m_pControl;
+
+  m_pEntries = EZ_NEW_RAW_BUFFER(m_pAllocator, Entry, m_uiCapacity);
+  m_pControl = EZ_NEW_RAW_BUFFER(m_pAllocator, ezUInt8, m_uiCapacity);
+  ezMemoryUtils::PatternFill(m_pControl, Group::EMPTY, m_uiCapacity);
+  m_uiGrowthLeft = m_uiCapacity - (m_uiCapacity / 8) - m_uiCount;
+
+  // the keys are known to be unique, so they can be placed without any comparisons
+  for (ezUInt32 i = 0; i < uiOldCapacity; ++i)
+  {
+    if (Group::IsFull(pOldControl[i]))
+    {
+      const ezUInt32 uiHash = H::Hash(pOldEntries[i].key);
+      const ezUInt32 uiIndex = FindFreeSlot(uiHash);
+      m_pControl[uiIndex] = Group::GetHashFragment(uiHash);
+
+      ezMemoryUtils::RelocateConstruct(&m_pEntries[uiIndex].key, &pOldEntries[i].key, 1);
+      ezMemoryUtils::RelocateConstruct(&m_pEntries[uiIndex].value, &pOldEntries[i].value, 1);
+    }
+  }
+
+  EZ_DELETE_RAW_BUFFER(m_pAllocator, pOldEntries);
+  EZ_DELETE_RAW_BUFFER(m_pAllocator, pOldControl);
+}
+
+template <typename K, typename V, typename H>
+template <typename CompatibleKeyType>
+EZ_ALWAYS_INLINE ezUInt32 ezFlatHashMapBase<K, V, H>::FindEntry(const CompatibleKeyType& key) const
+{
+  return FindEntry(H::Hash(key), key);
+}
+
+template <typename K, typename V, typename H>
+template <typename CompatibleKeyType>
+inline ezUInt32 ezFlatHashMapBase<K, V, H>::FindEntry(ezUInt32 uiHash, const CompatibleKeyType& key) const
+{
+  if (m_uiCapacity > 0)
+  {
+    const ezUInt8 uiHashFragment = Group::GetHashFragment(uiHash);
+    const ezUInt32 uiGroupMask = (m_uiCapacity / Group::WIDTH) - 1;
+    ezUInt32 uiGroup = uiHash & uiGroupMask;
+
+    // quadratic probing over the groups, visits every group exactly once
+    for (ezUInt32 uiProbe = 1; uiProbe <= uiGroupMask + 1; ++uiProbe)
+    {
+      const ezUInt32 uiFirstIndex = uiGroup * Group::WIDTH;
+      const Group group(m_pControl + uiFirstIndex);
+
+      for (ezUInt32 uiMatches = group.Match(uiHashFragment); uiMatches != 0; uiMatches &= uiMatches - 1)
+      {
+        const ezUInt32 uiIndex = uiFirstIndex + ezMath::FirstBitLow(uiMatches);
+        if (H::Equal(m_pEntries[uiIndex].key, key))
+          return uiIndex;
+      }
+
+      if (group.MatchEmpty() != 0)
+        break;
+
+      uiGroup = (uiGroup + uiProbe) & uiGroupMask;
+    }
+  }
+
+  // not found
+  return ezInvalidIndex;
+}
+
+template <typename K, typename V, typename H>
+ezUInt32 ezFlatHashMapBase<K, V, H>::FindFreeSlot(ezUInt32 uiHash) const
+{
+  const ezUInt32 uiGroupMask = (m_uiCapacity / Group::WIDTH) - 1;
+  ezUInt32 uiGroup = uiHash & uiGroupMask;
+
+  for (ezUInt32 uiProbe = 1;; ++uiProbe)
+  {
+    EZ_ASSERT_DEBUG(uiProbe <= uiGroupMask + 1, "Implementation error: hashmap has no free slot");
+
+    const ezUInt32 uiFirstIndex = uiGroup * Group::WIDTH;
+    const ezUInt32 uiFree = Group(m_pControl + uiFirstIndex).MatchEmptyOrDeleted();
+    if (uiFree != 0)
+      return uiFirstIndex + ezMath::FirstBitLow(uiFree);
+
+    uiGroup = (uiGroup + uiProbe) & uiGroupMask;
+  }
+}
+
+template <typename K, typename V, typename H>
+ezUInt32 ezFlatHashMapBase<K, V, H>::PrepareInsert(ezUInt32 uiHash)
+{
+  if (m_uiCapacity == 0)
+  {
+    SetCapacity(Group::WIDTH);
+  }
+
+  ezUInt32 uiIndex = FindFreeSlot(uiHash);
+
+  // reusing a deleted slot never needs to grow the table
+  if (m_uiGrowthLeft == 0 && m_pControl[uiIndex] != Group::DELETED)
+  {
+    // if more than half of the load is made up of deleted slots, rehash at the same size, otherwise grow
+    const ezUInt32 uiMaxLoad = m_uiCapacity - (m_uiCapacity / 8);
+    SetCapacity(m_uiCount <= uiMaxLoad / 2 ? m_uiCapacity : m_uiCapacity * 2);
+
+    uiIndex = FindFreeSlot(uiHash);
+  }
+
+  if (m_pControl[uiIndex] == Group::EMPTY)
+  {
+    --m_uiGrowthLeft;
+  }
+
+  m_pControl[uiIndex] = Group::GetHashFragment(uiHash);
+  return uiIndex;
+}
+
+template <typename K, typename V, typename H>
+EZ_FORCE_INLINE bool ezFlatHashMapBase<K, V, H>::IsValidEntry(ezUInt32 uiEntryIndex) const
+{
+  return Group::IsFull(m_pControl[uiEntryIndex]);
+}
+
+
+template <typename K, typename V, typename H, typename A>
+ezFlatHashMap<K, V, H, A>::ezFlatHashMap()
+  : ezFlatHashMapBase<K, V, H>(A::GetAllocator())
+{
+}
+
+template <typename K, typename V, typename H, typename A>
+ezFlatHashMap<K, V, H, A>::ezFlatHashMap(ezAllocator* pAllocator)
+  : ezFlatHashMapBase<K, V, H>(pAllocator)
+{
+}
+
+template <typename K, typename V, typename H, typename A>
+ezFlatHashMap<K, V, H, A>::ezFlatHashMap(const ezFlatHashMap<K, V, H, A>& other)
+  : ezFlatHashMapBase<K, V, H>(other, A::GetAllocator())
+{
+}
+
+template <typename K, typename V, typename H, typename A>
+ezFlatHashMap<K, V, H, A>::ezFlatHashMap(const ezFlatHashMapBase<K, V, H>& other)
+  : ezFlatHashMapBase<K, V, H>(other, A::GetAllocator())
+{
+}
+
+template <typename K, typename V, typename H, typename A>
+ezFlatHashMap<K, V, H, A>::ezFlatHashMap(ezFlatHashMap<K, V, H, A>&& other)
+  : ezFlatHashMapBase<K, V, H>(std::move(other), other.GetAllocator())
+{
+}
+
+template <typename K, typename V, typename H, typename A>
+ezFlatHashMap<K, V, H, A>::ezFlatHashMap(ezFlatHashMapBase<K, V, H>&& other)
+  : ezFlatHashMapBase<K, V, H>(std::move(other), other.GetAllocator())
+{
+}
+
+template <typename K, typename V, typename H, typename A>
+void ezFlatHashMap<K, V, H, A>::operator=(const ezFlatHashMap<K, V, H, A>& rhs)
+{
+  ezFlatHashMapBase<K, V, H>::operator=(rhs);
+}
+
+template <typename K, typename V, typename H, typename A>
+void ezFlatHashMap<K, V, H, A>::operator=(const ezFlatHashMapBase<K, V, H>& rhs)
+{
+  ezFlatHashMapBase<K, V, H>::operator=(rhs);
+}
+
+template <typename K, typename V, typename H, typename A>
+void ezFlatHashMap<K, V, H, A>::operator=(ezFlatHashMap<K, V, H, A>&& rhs)
+{
+  ezFlatHashMapBase<K, V, H>::operator=(std::move(rhs));
+}
+
+template <typename K, typename V, typename H, typename A>
+void ezFlatHashMap<K, V, H, A>::operator=(ezFlatHashMapBase<K, V, H>&& rhs)
+{
+  ezFlatHashMapBase<K, V, H>::operator=(std::move(rhs));
+}
@@ -0,0 +1,620 @@
+
+/// \brief Value used by containers for indices to indicate an invalid index.
+#ifndef ezInvalidIndex
+#  define ezInvalidIndex 0xFFFFFFFF
+#endif
+
+// ***** Const Iterator *****
+
+template <typename K, typename H>
+ezFlatHashSetBase<K, H>::ConstIterator::ConstIterator(const ezFlatHashSetBase<K, H>& set)
+  : m_pSet(&set)
+{
+}
+
+template <typename K, typename H>
+void ezFlatHashSetBase<K, H>::ConstIterator::SetToBegin()
+{
+  if (m_pSet->IsEmpty())
+  {
+    m_uiCurrentIndex = m_pSet->m_uiCapacity;
+    return;
+  }
+  while (!m_pSet->IsValidEntry(m_uiCurrentIndex))
+  {
+    ++m_uiCurrentIndex;
+  }
+}
+
+template <typename K, typename H>
+inline void ezFlatHashSetBase<K, H>::ConstIterator::SetToEnd()
+{
+  m_uiCurrentCount = m_pSet->m_uiCount;
+  m_uiCurrentIndex = m_pSet->m_uiCapacity;
+}
+
+template <typename K, typename H>
+EZ_ALWAYS_INLINE bool ezFlatHashSetBase<K, H>::ConstIterator::IsValid() const
+{
+  return m_uiCurrentCount < m_pSet->m_uiCount;
+}
+
+template <typename K, typename H>
+EZ_ALWAYS_INLINE bool ezFlatHashSetBase<K, H>::ConstIterator::operator==(const typename ezFlatHashSetBase<K, H>::ConstIterator& rhs) const
+{
+  return m_uiCurrentIndex == rhs.m_uiCurrentIndex && m_pSet->m_pEntries == rhs.m_pSet->m_pEntries;
+}
+
+template <typename K, typename H>
+EZ_FORCE_INLINE const K& ezFlatHashSetBase<K, H>::ConstIterator::Key() const
+{
+  return m_pSet->m_pEntries[m_uiCurrentIndex];
+}
+
+template <typename K, typename H>
+void ezFlatHashSetBase<K, H>::ConstIterator::Next()
+{
+  ++m_uiCurrentCount;
+  if (m_uiCurrentCount == m_pSet->m_uiCount)
+  {
+    m_uiCurrentIndex = m_pSet->m_uiCapacity;
+    return;
+  }
+
+  for (++m_uiCurrentIndex; m_uiCurrentIndex < m_pSet->m_uiCapacity; ++m_uiCurrentIndex)
+  {
+    if (m_pSet->IsValidEntry(m_uiCurrentIndex))
+    {
+      return;
+    }
+  }
+  SetToEnd();
+}
+
+template <typename K, typename H>
+EZ_ALWAYS_INLINE void ezFlatHashSetBase<K, H>::ConstIterator::operator++()
+{
+  Next();
+}
+
+
+// ***** ezFlatHashSetBase *****
+
+template <typename K, typename H>
+ezFlatHashSetBase<K, H>::ezFlatHashSetBase(ezAllocator* pAllocator)
+{
+  m_pAllocator = pAllocator;
+}
+
+template <typename K, typename H>
+ezFlatHashSetBase<K, H>::ezFlatHashSetBase(const ezFlatHashSetBase<K, H>& other, ezAllocator* pAllocator)
+{
+  m_pAllocator = pAllocator;
+
+  *this = other;
+}
+
+template <typename K, typename H>
+ezFlatHashSetBase<K, H>::ezFlatHashSetBase(ezFlatHashSetBase<K, H>&& other, ezAllocator* pAllocator)
+{
+  m_pAllocator = pAllocator;
+
+  *this = std::move(other);
+}
+
+template <typename K, typename H>
+ezFlatHashSetBase<K, H>::~ezFlatHashSetBase()
+{
+  Clear();
+  EZ_DELETE_RAW_BUFFER(m_pAllocator, m_pEntries);
+  EZ_DELETE_RAW_BUFFER(m_pAllocator, m_pControl);
+  m_uiCapacity = 0;
+  m_uiGrowthLeft = 0;
+}
+
+template <typename K, typename H>
+void ezFlatHashSetBase<K, H>::operator=(const ezFlatHashSetBase<K, H>& rhs)
+{
+  Clear();
+  Reserve(rhs.GetCount());
+
+  ezUInt32 uiCopied = 0;
+  for (ezUInt32 i = 0; uiCopied < rhs.GetCount(); ++i)
+  {
+    if (rhs.IsValidEntry(i))
+    {
+      Insert(rhs.m_pEntries[i]);
+      ++uiCopied;
+    }
+  }
+}
+
+template <typename K, typename H>
+void ezFlatHashSetBase<K, H>::operator=(ezFlatHashSetBase<K, H>&& rhs)
+{
+  // Clear any existing data (calls destructors if necessary)
+  Clear();
+
+  if (m_pAllocator != rhs.m_pAllocator)
+  {
+    Reserve(rhs.m_uiCount);
+
+    ezUInt32 uiCopied = 0;
+    for (ezUInt32 i = 0; uiCopied < rhs.GetCount(); ++i)
+    {
+      if (rhs.IsValidEntry(i))
+      {
+        Insert(std::move(rhs.m_pEntries[i]));
+        ++uiCopied;
+      }
+    }
+
+    rhs.Clear();
+  }
+  else
+  {
+    EZ_DELETE_RAW_BUFFER(m_pAllocator, m_pEntries);
+    EZ_DELETE_RAW_BUFFER(m_pAllocator, m_pControl);
+
+    // Move all data over.
+    m_pEntries = rhs.m_pEntries;
+    m_pControl = rhs.m_pControl;
+    m_uiCount = rhs.m_uiCount;
+    m_uiCapacity = rhs.m_uiCapacity;
+    m_uiGrowthLeft = rhs.m_uiGrowthLeft;
+
+    // Temp copy forgets all its state.
+    rhs.m_pEntries = nullptr;
+    rhs.m_pControl = nullptr;
+    rhs.m_uiCount = 0;
+    rhs.m_uiCapacity = 0;
+    rhs.m_uiGrowthLeft = 0;
+  }
+}
+
+template <typename K, typename H>
+bool ezFlatHashSetBase<K, H>::operator==(const ezFlatHashSetBase<K, H>& rhs) const
+{
+  if (m_uiCount != rhs.m_uiCount)
+    return false;
+
+  ezUInt32 uiCompared = 0;
+  for (ezUInt32 i = 0; uiCompared < m_uiCount; ++i)
+  {
+    if (IsValidEntry(i))
+    {
+      if (!rhs.Contains(m_pEntries[i]))
+        return false;
+
+      ++uiCompared;
+    }
+  }
+
+  return true;
+}
+
+template <typename K, typename H>
+void ezFlatHashSetBase<K, H>::Reserve(ezUInt32 uiCapacity)
+{
+  const ezUInt64 uiCap64 = static_cast<ezUInt64>(uiCapacity);
+  ezUInt64 uiNewCapacity64 = uiCap64 + (uiCap64 / 7) + 1;                  // ensure a maximum load of 87.5%
+
+  uiNewCapacity64 = ezMath::Min<ezUInt64>(uiNewCapacity64, 0x80000000llu); // the largest power-of-two in 32 bit
+
+  ezUInt32 uiNewCapacity32 = static_cast<ezUInt32>(uiNewCapacity64 & 0xFFFFFFFF);
+  EZ_ASSERT_DEBUG(uiCapacity <= uiNewCapacity32, "ezFlatHashSet/Map do not support more than 2 billion entries.");
+
+  if (m_uiCapacity >= uiNewCapacity32)
+    return;
+
+  uiNewCapacity32 = ezMath::Max<ezUInt32>(ezMath::PowerOfTwo_Ceil(uiNewCapacity32), Group::WIDTH);
+  SetCapacity(uiNewCapacity32);
+}
+
+template <typename K, typename H>
+void ezFlatHashSetBase<K, H>::Compact()
+{
+  if (IsEmpty())
+  {
+    // completely deallocate all data, if the table is empty.
+    EZ_DELETE_RAW_BUFFER(m_pAllocator, m_pEntries);
+    EZ_DELETE_RAW_BUFFER(m_pAllocator, m_pControl);
+    m_uiCapacity = 0;
+    m_uiGrowthLeft = 0;
+  }
+  else
+  {
+    const ezUInt32 uiNewCapacity = ezMath::Max<ezUInt32>(ezMath::PowerOfTwo_Ceil(m_uiCount + (m_uiCount / 7) + 1), Group::WIDTH);
+
+    // rehashing at the same capacity gets rid of all deleted slots
+    SetCapacity(uiNewCapacity);
+  }
+}
+
+template <typename K, typename H>
+EZ_ALWAYS_INLINE ezUInt32 ezFlatHashSetBase<K, H>::GetCount() const
+{
+  return m_uiCount;
+}
+
+template <typename K, typename H>
+EZ_ALWAYS_INLINE bool ezFlatHashSetBase<K, H>::IsEmpty() const
+{
+  return m_uiCount == 0;
+}
+
+template <typename K, typename H>
+void ezFlatHashSetBase<K, H>::Clear()
+{
+  for (ezUInt32 i = 0; i < m_uiCapacity; ++i)
+  {
+    if (IsValidEntry(i))
+    {
+      ezMemoryUtils::Destruct(&m_pEntries[i], 1);
+    }
+  }
+
+  ezMemoryUtils::PatternFill(m_pControl, Group::EMPTY, m_uiCapacity);
+  m_uiCount = 0;
+  m_uiGrowthLeft = m_uiCapacity - (m_uiCapacity / 8);
+}
+
+template <typename K, typename H>
+template <typename CompatibleKeyType>
+bool ezFlatHashSetBase<K, H>::Insert(CompatibleKeyType&& key)
+{
+  const ezUInt32 uiHash = H::Hash(key);
+  if (FindEntry(uiHash, key) != ezInvalidIndex)
+    return true;
+
+  // new entry
+  const ezUInt32 uiIndex = PrepareInsert(uiHash);
+
+  // Either move or copy.
+  ezMemoryUtils::CopyOrMoveConstruct(&m_pEntries[uiIndex], std::forward<CompatibleKeyType>(key));
+  ++m_uiCount;
+
+  return false;
+}
+
+template <typename K, typename H>
+template <typename CompatibleKeyType>
+bool ezFlatHashSetBase<K, H>::Remove(const CompatibleKeyType& key)
+{
+  ezUInt32 uiIndex = FindEntry(key);
+  if (uiIndex != ezInvalidIndex)
+  {
+    RemoveInternal(uiIndex);
+    return true;
+  }
+
+  return false;
+}
+
+template <typename K, typename H>
+typename ezFlatHashSetBase<K, H>::ConstIterator ezFlatHashSetBase<K, H>::Remove(const typename ezFlatHashSetBase<K, H>::ConstIterator& pos)
+{
+  EZ_ASSERT_DEBUG(pos.m_pSet == this, "Iterator from wrong hashset");
+  ConstIterator it = pos;
+  ezUInt32 uiIndex = pos.m_uiCurrentIndex;
+  ++it;
+  --it.m_uiCurrentCount;
+  RemoveInternal(uiIndex);
+  return it;
+}
+
+template <typename K, typename H>
+void ezFlatHashSetBase<K, H>::RemoveInternal(ezUInt32 uiIndex)
+{
+  ezMemoryUtils::Destruct(&m_pEntries[uiIndex], 1);
+
+  // if the group still has an empty slot, no probe sequence ever continued past it
+  // and the slot can be marked as empty again, otherwise it has to stay a tombstone
+  const Group group(m_pControl + (uiIndex & ~(Group::WIDTH - 1)));
+  if (group.MatchEmpty() != 0)
+  {
+    m_pControl[uiIndex] = Group::EMPTY;
+    ++m_uiGrowthLeft;
+  }
+  else
+  {
+    m_pControl[uiIndex] = Group::DELETED;
+  }
+
+  --m_uiCount;
+}
+
+template <typename K, typename H>
+template <typename CompatibleKeyType>
+EZ_FORCE_INLINE typename ezFlatHashSetBase<K, H>::ConstIterator ezFlatHashSetBase<K, H>::Find(const CompatibleKeyType& key) const
+{
+  ezUInt32 uiIndex = FindEntry(key);
+  if (uiIndex == ezInvalidIndex)
+  {
+    return GetEndIterator();
+  }
+
+  ConstIterator it(*this);
+  it.m_uiCurrentIndex = uiIndex;
+  it.m_uiCurrentCount = 0; // we do not know the 'count' (which is used as an optimization), so we just use 0
+
+  return it;
+}
+
+template <typename K, typename H>
+template <typename CompatibleKeyType>
+EZ_FORCE_INLINE bool ezFlatHashSetBase<K, H>::Contains(const CompatibleKeyType& key) const
+{
+  return FindEntry(key) != ezInvalidIndex;
+}
+
+template <typename K, typename H>
+bool ezFlatHashSetBase<K, H>::ContainsSet(const ezFlatHashSetBase<K, H>& operand) const
+{
+  for (const K& key : operand)
+  {
+    if (!Contains(key))
+      return false;
+  }
+
+  return true;
+}
+
+template <typename K, typename H>
+void ezFlatHashSetBase<K, H>::Union(const ezFlatHashSetBase<K, H>& operand)
+{
+  Reserve(GetCount() + operand.GetCount());
+  for (const auto& key : operand)
+  {
+    Insert(key);
+  }
+}
+
+template <typename K, typename H>
+void ezFlatHashSetBase<K, H>::Difference(const ezFlatHashSetBase<K, H>& operand)
+{
+  for (const auto& key : operand)
+  {
+    Remove(key);
+  }
+}
+
+template <typename K, typename H>
+void ezFlatHashSetBase<K, H>::Intersection(const ezFlatHashSetBase<K, H>& operand)
+{
+  for (auto it = GetIterator(); it.IsValid();)
+  {
+    if (!operand.Contains(it.Key()))
+      it = Remove(it);
+    else
+      ++it;
+  }
+}
+
+template <typename K, typename H>
+EZ_ALWAYS_INLINE typename ezFlatHashSetBase<K, H>::ConstIterator ezFlatHashSetBase<K, H>::GetIterator() const
+{
+  ConstIterator iterator(*this);
+  iterator.SetToBegin();
+  return iterator;
+}
+
+template <typename K, typename H>
+EZ_ALWAYS_INLINE typename ezFlatHashSetBase<K, H>::ConstIterator ezFlatHashSetBase<K, H>::GetEndIterator() const
+{
+  ConstIterator iterator(*this);
+  iterator.SetToEnd();
+  return iterator;
+}
+
+template <typename K, typename H>
+EZ_ALWAYS_INLINE ezAllocator* ezFlatHashSetBase<K, H>::GetAllocator() const
+{
+  return m_pAllocator;
+}
+
+template <typename K, typename H>
+ezUInt64 ezFlatHashSetBase<K, H>::GetHeapMemoryUsage() const
+{
+  return (ezUInt64)m_uiCapacity * (sizeof(K) + sizeof(ezUInt8));
+}
+
+template <typename KeyType, typename Hasher>
+void ezFlatHashSetBase<KeyType, Hasher>::Swap(ezFlatHashSetBase<KeyType, Hasher>& other)
+{
+  ezMath::Swap(this->m_pEntries, other.m_pEntries);
+  ezMath::Swap(this->m_pControl, other.m_pControl);
+  ezMath::Swap(this->m_uiCount, other.m_uiCount);
+  ezMath::Swap(this->m_uiCapacity, other.m_uiCapacity);
+  ezMath::Swap(this->m_uiGrowthLeft, other.m_uiGrowthLeft);
+  ezMath::Swap(this->m_pAllocator, other.m_pAllocator);
+}
+
+// private methods
+template <typename K, typename H>
+void ezFlatHashSetBase<K, H>::SetCapacity(ezUInt32 uiCapacity)
+{
+  EZ_ASSERT_DEBUG(ezMath::IsPowerOf2(uiCapacity) && uiCapacity >= Group::WIDTH, "uiCapacity must be a power of two and at least one group.");
+  const ezUInt32 uiOldCapacity = m_uiCapacity;
+  m_uiCapacity = uiCapacity;
+
+  K* pOldEntries = m_pEntries;
+  ezUInt8* pOldControl = m_pControl;
+
+  m_pEntries = EZ_NEW_RAW_BUFFER(m_pAllocator, K, m_uiCapacity);
+  m_pControl = EZ_NEW_RAW_BUFFER(m_pAllocator, ezUInt8, m_uiCapacity);
+  ezMemoryUtils::PatternFill(m_pControl, Group::EMPTY, m_uiCapacity);
+  m_uiGrowthLeft = m_uiCapacity - (m_uiCapacity / 8) - m_uiCount;
+
+  // the keys are known to be unique, so they can be placed without any comparisons
+  for (ezUInt32 i = 0; i < uiOldCapacity; ++i)
+  {
+    if (Group::IsFull(pOldControl[i]))
+    {
+      const ezUInt32 uiHash = H::Hash(pOldEntries[i]);
+      const ezUInt32 uiIndex = FindFreeSlot(uiHash);
+      m_pControl[uiIndex] = Group::GetHashFragment(uiHash);
+
+      ezMemoryUtils::RelocateConstruct(&m_pEntries[uiIndex], &pOldEntries[i], 1);
+    }
+  }
+
+  EZ_DELETE_RAW_BUFFER(m_pAllocator, pOldEntries);
+  EZ_DELETE_RAW_BUFFER(m_pAllocator, pOldControl);
+}
+
+template <typename K, typename H>
+template <typename CompatibleKeyType>
+EZ_ALWAYS_INLINE ezUInt32 ezFlatHashSetBase<K, H>::FindEntry(const CompatibleKeyType& key) const
+{
+  return FindEntry(H::Hash(key), key);
+}
+
+template <typename K, typename H>
+template <typename CompatibleKeyType>
+inline ezUInt32 ezFlatHashSetBase<K, H>::FindEntry(ezUInt32 uiHash, const CompatibleKeyType& key) const
+{
+  if (m_uiCapacity > 0)
+  {
+    const ezUInt8 uiHashFragment = Group::GetHashFragment(uiHash);
+    const ezUInt32 uiGroupMask = (m_uiCapacity / Group::WIDTH) - 1;
+    ezUInt32 uiGroup = uiHash & uiGroupMask;
+
+    // quadratic probing over the groups, visits every group exactly once
+    for (ezUInt32 uiProbe = 1; uiProbe <= uiGroupMask + 1; ++uiProbe)
+    {
+      const ezUInt32 uiFirstIndex = uiGroup * Group::WIDTH;
+      const Group group(m_pControl + uiFirstIndex);
+
+      for (ezUInt32 uiMatches = group.Match(uiHashFragment); uiMatches != 0; uiMatches &= uiMatches - 1)
+      {
+        const ezUInt32 uiIndex = uiFirstIndex + ezMath::FirstBitLow(uiMatches);
+        if (H::Equal(m_pEntries[uiIndex], key))
+          return uiIndex;
+      }
+
+      if (group.MatchEmpty() != 0)
+        break;
+
+      uiGroup = (uiGroup + uiProbe) & uiGroupMask;
+    }
+  }
+
+  // not found
+  return ezInvalidIndex;
+}
+
+template <typename K, typename H>
+ezUInt32 ezFlatHashSetBase<K, H>::FindFreeSlot(ezUInt32 uiHash) const
+{
+  const ezUInt32 uiGroupMask = (m_uiCapacity / Group::WIDTH) - 1;
+  ezUInt32 uiGroup = uiHash & uiGroupMask;
+
+  for (ezUInt32 uiProbe = 1;; ++uiProbe)
+  {
+    EZ_ASSERT_DEBUG(uiProbe <= uiGroupMask + 1, "Implementation error: hashset has no free slot");
+
+    const ezUInt32 uiFirstIndex = uiGroup * Group::WIDTH;
+    const ezUInt32 uiFree = Group(m_pControl + uiFirstIndex).MatchEmptyOrDeleted();
+    if (uiFree != 0)
+      return uiFirstIndex + ezMath::FirstBitLow(uiFree);
+
+    uiGroup = (uiGroup + uiProbe) & uiGroupMask;
+  }
+}
+
+template <typename K, typename H>
+ezUInt32 ezFlatHashSetBase<K, H>::PrepareInsert(ezUInt32 uiHash)
+{
+  if (m_uiCapacity == 0)
+  {
+    SetCapacity(Group::WIDTH);
+  }
+
+  ezUInt32 uiIndex = FindFreeSlot(uiHash);
+
+  // reusing a deleted slot never needs to grow the table
+  if (m_uiGrowthLeft == 0 && m_pControl[uiIndex] != Group::DELETED)
+  {
+    // if more than half of the load is made up of deleted slots, rehash at the same size, otherwise grow
+    const ezUInt32 uiMaxLoad = m_uiCapacity - (m_uiCapacity / 8);
+    SetCapacity(m_uiCount <= uiMaxLoad / 2 ? m_uiCapacity : m_uiCapacity * 2);
+
+    uiIndex = FindFreeSlot(uiHash);
+  }
+
+  if (m_pControl[uiIndex] == Group::EMPTY)
+  {
+    --m_uiGrowthLeft;
+  }
+
+  m_pControl[uiIndex] = Group::GetHashFragment(uiHash);
+  return uiIndex;
+}
+
+template <typename K, typename H>
+EZ_FORCE_INLINE bool ezFlatHashSetBase<K, H>::IsValidEntry(ezUInt32 uiEntryIndex) const
+{
+  return Group::IsFull(m_pControl[uiEntryIndex]);
+}
+
+
+template <typename K, typename H, typename A>
+ezFlatHashSet<K, H, A>::ezFlatHashSet()
+  : ezFlatHashSetBase<K, H>(A::GetAllocator())
+{
+}
+
+template <typename K, typename H, typename A>
+ezFlatHashSet<K, H, A>::ezFlatHashSet(ezAllocator* pAllocator)
+  : ezFlatHashSetBase<K, H>(pAllocator)
+{
+}
+
+template <typename K, typename H, typename A>
+ezFlatHashSet<K, H, A>::ezFlatHashSet(const ezFlatHashSet<K, H, A>& other)
+  : ezFlatHashSetBase<K, H>(other, A::GetAllocator())
+{
+}
+
+template <typename K, typename H, typename A>
+ezFlatHashSet<K, H, A>::ezFlatHashSet(const ezFlatHashSetBase<K, H>& other)
+  : ezFlatHashSetBase<K, H>(other, A::GetAllocator())
+{
+}
+
+template <typename K, typename H, typename A>
+ezFlatHashSet<K, H, A>::ezFlatHashSet(ezFlatHashSet<K, H, A>&& other)
+  : ezFlatHashSetBase<K, H>(std::move(other), other.GetAllocator())
+{
+}
+
+template <typename K, typename H, typename A>
+ezFlatHashSet<K, H, A>::ezFlatHashSet(ezFlatHashSetBase<K, H>&& other)
+  : ezFlatHashSetBase<K, H>(std::move(other), other.GetAllocator())
+{
+}
+
+template <typename K, typename H, typename A>
+void ezFlatHashSet<K, H, A>::operator=(const ezFlatHashSet<K, H, A>& rhs)
+{
+  ezFlatHashSetBase<K, H>::operator=(rhs);
+}
+
+template <typename K, typename H, typename A>
+void ezFlatHashSet<K, H, A>::operator=(const ezFlatHashSetBase<K, H>& rhs)
+{
+  ezFlatHashSetBase<K, H>::operator=(rhs);
+}
+
+template <typename K, typename H, typename A>
+void ezFlatHashSet<K, H, A>::operator=(ezFlatHashSet<K, H, A>&& rhs)
+{
+  ezFlatHashSetBase<K, H>::operator=(std::move(rhs));
+}
+
+template <typename K, typename H, typename A>
+void ezFlatHashSet<K, H, A>::operator=(ezFlatHashSetBase<K, H>&& rhs)
+{
+  ezFlatHashSetBase<K, H>::operator=(std::move(rhs));
+}
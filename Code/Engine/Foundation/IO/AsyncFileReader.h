@@ -0,0 +1,89 @@
+#pragma once
+
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Strings/String.h>
+#include <Foundation/Threading/Mutex.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Types/Delegate.h>
+#include <Foundation/Types/UniquePtr.h>
+
+struct ezAsyncFileReadResult;
+struct ezAsyncFileReaderImpl;
+
+/// \brief Describes a single read that is passed to ezAsyncFileReader::ReadBatch().
+struct ezAsyncFileReadRequest
+{
+  /// The OS path of the file to read. Paths of the ezFileSystem need to be resolved first, see ezFileSystem::ResolvePath().
+  ezString m_sAbsolutePath;
+
+  /// The byte offset in the file at which to start reading.
+  ezUInt64 m_uiOffset = 0;
+
+  /// The number of bytes to read. By default everything from m_uiOffset until the end of the file is read.
+  /// If the file is shorter, the result only contains the bytes that are available.
+  ezUInt64 m_uiSize = ezMath::MaxValue<ezUInt64>();
+
+  /// Called once the read has finished or failed. It may be called from any thread, also from multiple threads at the same time.
+  ezDelegate<void(ezAsyncFileReadResult&)> m_OnFinished;
+};
+
+/// \brief Passed to ezAsyncFileReadRequest::m_OnFinished.
+struct ezAsyncFileReadResult
+{
+  /// EZ_FAILURE, if the file could not be opened or reading from it failed.
+  ezResult m_Result = EZ_FAILURE;
+
+  /// The index of the request in the array that was passed to ezAsyncFileReader::ReadBatch().
+  ezUInt32 m_uiRequestIndex = 0;
+
+  /// The path of the request.
+  ezStringView m_sAbsolutePath;
+
+  /// The content that was read. The callback may take it over with std::move(), otherwise it is deallocated afterwards.
+  ezDynamicArray<ezUInt8> m_Data;
+};
+
+/// \brief Reads many files concurrently, such that the storage device gets a deep queue of requests instead of one blocking read at a time.
+///
+/// Reads are passed in batches to ReadBatch(), which returns a task group that finishes once all reads of the batch and their callbacks
+/// are done. Other task groups can depend on it, or it can be waited for with ezTaskSystem::WaitForGroup().
+///
+/// On Linux, the reads of a batch are submitted to an io_uring by a single task, which keeps up to GetMaxReadsInFlight() reads queued in
+/// the kernel and resubmits short reads. If io_uring is not available, e.g. because the kernel is too old or it is blocked by a seccomp
+/// filter, and on all other platforms, each batch uses a task with a multiplicity of up to GetMaxReadsInFlight() that reads the files
+/// with blocking ezOSFile calls instead. IsUsingNativeQueue() returns which of the two is used.
+class EZ_FOUNDATION_DLL ezAsyncFileReader
+{
+  EZ_DISALLOW_COPY_AND_ASSIGN(ezAsyncFileReader);
+
+public:
+  ezAsyncFileReader();
+
+  /// \brief Waits for all batches that are still in flight.
+  ~ezAsyncFileReader();
+
+  /// \brief Limits how many reads of a single batch are in flight at the same time. The default is 64.
+  void SetMaxReadsInFlight(ezUInt32 uiMaxReadsInFlight);
+  ezUInt32 GetMaxReadsInFlight() const { return m_uiMaxReadsInFlight; }
+
+  /// \brief Starts reading all the given requests and returns the task group that finishes once all of them are done.
+  ///
+  /// The requests are copied, the array does not need to stay alive.
+  /// The task group uses the given priority, which should be one of the long running or file access priorities.
+  ezTaskGroupID ReadBatch(ezArrayPtr<const ezAsyncFileReadRequest> requests, ezTaskPriority::Enum priority = ezTaskPriority::LongRunning);
+
+  /// \brief Blocks until all batches that were started so far are finished.
+  void WaitForAll();
+
+  /// \brief Returns whether the reads are queued in the kernel (io_uring on Linux), instead of being executed by blocking reads on
+  /// worker threads.
+  bool IsUsingNativeQueue() const;
+
+private:
+  ezUInt32 m_uiMaxReadsInFlight = 64;
+
+  ezMutex m_Mutex;
+  ezDynamicArray<ezTaskGroupID> m_Batches;
+
+  ezUniquePtr<ezAsyncFileReaderImpl> m_pImpl;
+};
@@ -0,0 +1,184 @@
+#include <Foundation/FoundationPCH.h>
+
+#include <Foundation/IO/AsyncFileReader.h>
+#include <Foundation/IO/OSFile.h>
+#include <Foundation/Profiling/Profiling.h>
+
+struct ezAsyncFileReadBatch
+{
+  ezDynamicArray<ezAsyncFileReadRequest> m_Requests;
+  ezUInt32 m_uiMaxReadsInFlight = 0;
+
+  /// \brief Clamps the requested range to the file size. Fails, if the range does not fit into a single array.
+  static ezResult ComputeReadRange(const ezAsyncFileReadRequest& request, ezUInt64 uiFileSize, ezUInt64& out_uiOffset, ezUInt32& out_uiSize)
+  {
+    out_uiOffset = ezMath::Min(request.m_uiOffset, uiFileSize);
+    const ezUInt64 uiSize = ezMath::Min(request.m_uiSize, uiFileSize - out_uiOffset);
+
+    if (uiSize > ezMath::MaxValue<ezUInt32>())
+      return EZ_FAILURE;
+
+    out_uiSize = static_cast<ezUInt32>(uiSize);
+    return EZ_SUCCESS;
+  }
+
+  void FinishRead(ezUInt32 uiRequest, ezResult result, ezDynamicArray<ezUInt8>& ref_data) const
+  {
+    const ezAsyncFileReadRequest& request = m_Requests[uiRequest];
+
+    if (!request.m_OnFinished.IsValid())
+      return;
+
+    ezAsyncFileReadResult res;
+    res.m_Result = result;
+    res.m_uiRequestIndex = uiRequest;
+    res.m_sAbsolutePath = request.m_sAbsolutePath;
+
+    if (result.Succeeded())
+    {
+      res.m_Data = std::move(ref_data);
+    }
+
+    request.m_OnFinished(res);
+  }
+
+  void ReadBlocking(ezUInt32 uiRequest) const
+  {
+    const ezAsyncFileReadRequest& request = m_Requests[uiRequest];
+
+    ezDynamicArray<ezUInt8> data;
+    ezResult result = EZ_FAILURE;
+
+    ezOSFile file;
+    if (file.Open(request.m_sAbsolutePath, ezFileOpenMode::Read).Succeeded())
+    {
+      ezUInt64 uiOffset = 0;
+      ezUInt32 uiSize = 0;
+      if (ComputeReadRange(request, file.GetFileSize(), uiOffset, uiSize).Succeeded())
+      {
+        data.SetCountUninitialized(uiSize);
+        file.SetFilePosition(static_cast<ezInt64>(uiOffset), ezFileSeekMode::FromStart);
+
+        // the file may have been truncated in the meantime
+        data.SetCountUninitialized(static_cast<ezUInt32>(file.Read(data.GetData(), uiSize)));
+        result = EZ_SUCCESS;
+      }
+    }
+
+    FinishRead(uiRequest, result, data);
+  }
+};
+
+#include <AsyncFileReader_Platform.inl>
+
+class ezAsyncFileReadTask final : public ezTask
+{
+public:
+  ezAsyncFileReadTask(ezAsyncFileReaderImpl* pImpl, ezAsyncFileReadBatch&& batch)
+    : m_pImpl(pImpl)
+    , m_Batch(std::move(batch))
+  {
+    ConfigureTask("ezAsyncFileReader", ezTaskNesting::Never);
+
+    if (!m_pImpl->IsNativeQueueAvailable())
+    {
+      SetMultiplicity(ezMath::Min(m_Batch.m_Requests.GetCount(), m_Batch.m_uiMaxReadsInFlight));
+    }
+  }
+
+private:
+  virtual void Execute() override
+  {
+    EZ_PROFILE_SCOPE("AsyncFileReadBatch");
+    m_pImpl->ReadBatch(m_Batch);
+  }
+
+  virtual void ExecuteWithMultiplicity(ezUInt32 uiInvocation) const override
+  {
+    EZ_IGNORE_UNUSED(uiInvocation);
+    EZ_PROFILE_SCOPE("AsyncFileReadBlocking");
+
+    // every invocation takes the next request that nobody has started yet, this keeps all invocations busy until the end
+    while (true)
+    {
+      const ezUInt32 uiRequest = static_cast<ezUInt32>(m_iNextRequest.Increment() - 1);
+
+      if (uiRequest >= m_Batch.m_Requests.GetCount())
+        return;
+
+      m_Batch.ReadBlocking(uiRequest);
+    }
+  }
+
+  ezAsyncFileReaderImpl* m_pImpl = nullptr;
+  ezAsyncFileReadBatch m_Batch;
+  mutable ezAtomicInteger32 m_iNextRequest;
+};
+
+ezAsyncFileReader::ezAsyncFileReader()
+{
+  m_pImpl = EZ_DEFAULT_NEW(ezAsyncFileReaderImpl);
+}
+
+ezAsyncFileReader::~ezAsyncFileReader()
+{
+  WaitForAll();
+}
+
+void ezAsyncFileReader::SetMaxReadsInFlight(ezUInt32 uiMaxReadsInFlight)
+{
+  m_uiMaxReadsInFlight = ezMath::Clamp(uiMaxReadsInFlight, 1u, 4096u);
+}
+
+ezTaskGroupID ezAsyncFileReader::ReadBatch(ezArrayPtr<const ezAsyncFileReadRequest> requests, ezTaskPriority::Enum priority)
+{
+  ezTaskGroupID group = ezTaskSystem::CreateTaskGroup(priority);
+
+  if (!requests.IsEmpty())
+  {
+    ezAsyncFileReadBatch batch;
+    batch.m_Requests = requests;
+    batch.m_uiMaxReadsInFlight = m_uiMaxReadsInFlight;
+
+    ezTaskSystem::AddTaskToGroup(group, EZ_DEFAULT_NEW(ezAsyncFileReadTask, m_pImpl.Borrow(), std::move(batch)));
+  }
+
+  {
+    EZ_LOCK(m_Mutex);
+
+    // forget about the batches that are done, so that the array does not grow forever
+    for (ezUInt32 i = m_Batches.GetCount(); i > 0; --i)
+    {
+      if (ezTaskSystem::IsTaskGroupFinished(m_Batches[i - 1]))
+      {
+        m_Batches.RemoveAtAndSwap(i - 1);
+      }
+    }
+
+    m_Batches.PushBack(group);
+  }
+
+  ezTaskSystem::StartTaskGroup(group);
+  return group;
+}
+
+void ezAsyncFileReader::WaitForAll()
+{
+  ezHybridArray<ezTaskGroupID, 16> batches;
+
+  {
+    EZ_LOCK(m_Mutex);
+    batches = m_Batches;
+    m_Batches.Clear();
+  }
+
+  for (const ezTaskGroupID& group : batches)
+  {
+    ezTaskSystem::WaitForGroup(group);
+  }
+}
+
+bool ezAsyncFileReader::IsUsingNativeQueue() const
+{
+  return m_pImpl->IsNativeQueueAvailable();
+}
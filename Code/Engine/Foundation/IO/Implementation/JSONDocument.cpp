@@ -0,0 +1,1062 @@
+#include <Foundation/FoundationPCH.h>
+
+#include <Foundation/IO/JSONDocument.h>
+#include <Foundation/IO/StreamUtils.h>
+#include <Foundation/Logging/Log.h>
+#include <Foundation/Strings/StringBuilder.h>
+#include <Foundation/Types/Variant.h>
+#include <Foundation/Utilities/ConversionUtils.h>
+
+#if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE
+#  include <emmintrin.h>
+#elif EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_NEON
+#  include <arm_neon.h>
+#endif
+
+namespace
+{
+  /// Bit masks for one block of 64 bytes, bit i stands for byte i of the block.
+  struct ezJSONBlockMasks
+  {
+    ezUInt64 m_uiQuotes = 0;
+    ezUInt64 m_uiBackslashes = 0;
+    ezUInt64 m_uiWhitespace = 0;
+    ezUInt64 m_uiOperators = 0; // { } [ ] : ,
+    ezUInt64 m_uiSlashes = 0;
+  };
+
+#if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_NEON
+  EZ_ALWAYS_INLINE ezUInt64 ezJSONToBitMask(uint8x16_t compareResult)
+  {
+    // NEON has no movemask, so weight each lane with its bit and sum up each half
+    static constexpr ezUInt8 s_BitWeights[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    const uint8x16_t masked = vandq_u8(compareResult, vld1q_u8(s_BitWeights));
+    return static_cast<ezUInt64>(vaddv_u8(vget_low_u8(masked))) | (static_cast<ezUInt64>(vaddv_u8(vget_high_u8(masked))) << 8);
+  }
+#endif
+
+  EZ_ALWAYS_INLINE void ClassifyBlock(const char* pBlock, ezJSONBlockMasks& out_masks)
+  {
+#if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE
+    for (ezUInt32 i = 0; i < 4; ++i)
+    {
+      const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pBlock + i * 16));
+      auto Equal = [&](char c)
+      { return _mm_cmpeq_epi8(chars, _mm_set1_epi8(c)); };
+      auto ToMask = [&](__m128i compareResult)
+      { return static_cast<ezUInt64>(static_cast<ezUInt32>(_mm_movemask_epi8(compareResult))) << (i * 16); };
+
+      const __m128i whitespace = _mm_or_si128(_mm_or_si128(Equal(' '), Equal('\t')), _mm_or_si128(Equal('\n'), Equal('\r')));
+      const __m128i operators = _mm_or_si128(_mm_or_si128(_mm_or_si128(Equal('{'), Equal('}')), _mm_or_si128(Equal('['), Equal(']'))), _mm_or_si128(Equal(':'), Equal(',')));
+
+      out_masks.m_uiQuotes |= ToMask(Equal('"'));
+      out_masks.m_uiBackslashes |= ToMask(Equal('\\'));
+      out_masks.m_uiWhitespace |= ToMask(whitespace);
+      out_masks.m_uiOperators |= ToMask(operators);
+      out_masks.m_uiSlashes |= ToMask(Equal('/'));
+    }
+#elif EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_NEON
+    for (ezUInt32 i = 0; i < 4; ++i)
+    {
+      const uint8x16_t chars = vld1q_u8(reinterpret_cast<const ezUInt8*>(pBlock + i * 16));
+      auto Equal = [&](char c)
+      { return vceqq_u8(chars, vdupq_n_u8(static_cast<ezUInt8>(c))); };
+      auto ToMask = [&](uint8x16_t compareResult)
+      { return ezJSONToBitMask(compareResult) << (i * 16); };
+
+      const uint8x16_t whitespace = vorrq_u8(vorrq_u8(Equal(' '), Equal('\t')), vorrq_u8(Equal('\n'), Equal('\r')));
+      const uint8x16_t operators = vorrq_u8(vorrq_u8(vorrq_u8(Equal('{'), Equal('}')), vorrq_u8(Equal('['), Equal(']'))), vorrq_u8(Equal(':'), Equal(',')));
+
+      out_masks.m_uiQuotes |= ToMask(Equal('"'));
+      out_masks.m_uiBackslashes |= ToMask(Equal('\\'));
+      out_masks.m_uiWhitespace |= ToMask(whitespace);
+      out_masks.m_uiOperators |= ToMask(operators);
+      out_masks.m_uiSlashes |= ToMask(Equal('/'));
+    }
+#else
+    for (ezUInt32 i = 0; i < 64; ++i)
+    {
+      const ezUInt64 uiBit = 1ull << i;
+      switch (pBlock[i])
+      {
+        case '"':
+          out_masks.m_uiQuotes |= uiBit;
+          break;
+        case '\\':
+          out_masks.m_uiBackslashes |= uiBit;
+          break;
+        case ' ':
+        case '\t':
+        case '\n':
+        case '\r':
+          out_masks.m_uiWhitespace |= uiBit;
+          break;
+        case '{':
+        case '}':
+        case '[':
+        case ']':
+        case ':':
+        case ',':
+          out_masks.m_uiOperators |= uiBit;
+          break;
+        case '/':
+          out_masks.m_uiSlashes |= uiBit;
+          break;
+      }
+    }
+#endif
+  }
+
+  /// Returns a mask of all characters that follow an odd number of backslashes, i.e. that are escaped.
+  /// A run of backslashes may continue from the previous block, which is tracked in ref_uiPrevEndsOddBackslash.
+  EZ_ALWAYS_INLINE ezUInt64 FindEscapedCharacters(ezUInt64 uiBackslashes, ezUInt64& ref_uiPrevEndsOddBackslash)
+  {
+    constexpr ezUInt64 uiEvenBits = 0x5555555555555555ull;
+    constexpr ezUInt64 uiOddBits = ~uiEvenBits;
+
+    // Adding the start of a run of backslashes to the run carries over into the first bit after the run.
+    // Whether the run has an odd length then follows from the parity of its start and end position.
+    const ezUInt64 uiStartEdges = uiBackslashes & ~(uiBackslashes << 1);
+    const ezUInt64 uiEvenStartMask = uiEvenBits ^ ref_uiPrevEndsOddBackslash;
+    const ezUInt64 uiEvenStarts = uiStartEdges & uiEvenStartMask;
+    const ezUInt64 uiOddStarts = uiStartEdges & ~uiEvenStartMask;
+
+    const ezUInt64 uiEvenCarries = uiBackslashes + uiEvenStarts;
+    ezUInt64 uiOddCarries = uiBackslashes + uiOddStarts;
+    const bool bEndsOddBackslash = uiOddCarries < uiBackslashes; // overflow, the run continues in the next block
+
+    uiOddCarries |= ref_uiPrevEndsOddBackslash;
+    ref_uiPrevEndsOddBackslash = bEndsOddBackslash ? 1 : 0;
+
+    const ezUInt64 uiEvenCarryEnds = uiEvenCarries & ~uiBackslashes;
+    const ezUInt64 uiOddCarryEnds = uiOddCarries & ~uiBackslashes;
+
+    return (uiEvenCarryEnds & uiOddBits) | (uiOddCarryEnds & uiEvenBits);
+  }
+
+  /// Bit i of the result is the XOR of the bits 0 to i of the input.
+  EZ_ALWAYS_INLINE ezUInt64 PrefixXor(ezUInt64 uiBits)
+  {
+    uiBits ^= uiBits << 1;
+    uiBits ^= uiBits << 2;
+    uiBits ^= uiBits << 4;
+    uiBits ^= uiBits << 8;
+    uiBits ^= uiBits << 16;
+    uiBits ^= uiBits << 32;
+    return uiBits;
+  }
+
+  EZ_ALWAYS_INLINE bool IsEndOfScalar(char c)
+  {
+    switch (c)
+    {
+      case ' ':
+      case '\t':
+      case '\n':
+      case '\r':
+      case '{':
+      case '}':
+      case '[':
+      case ']':
+      case ':':
+      case ',':
+      case '"':
+        return true;
+    }
+
+    return false;
+  }
+
+  EZ_ALWAYS_INLINE bool IsDigit(char c)
+  {
+    return c >= '0' && c <= '9';
+  }
+
+  /// Parses a number in the format [+-]digits[.digits][(e|E)[+-]digits], like ezJSONParser a leading '+' or '.' is accepted as well.
+  bool ParseJSONNumber(const char* pStart, const char* pEnd, double& out_fValue)
+  {
+    static constexpr double s_PowersOfTen[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+    const char* p = pStart;
+
+    bool bNegative = false;
+    if (p < pEnd && (*p == '-' || *p == '+'))
+    {
+      bNegative = (*p == '-');
+      ++p;
+    }
+
+    ezUInt64 uiMantissa = 0;
+    ezUInt32 uiSignificantDigits = 0;
+    ezInt32 iExponent = 0;
+    bool bAnyDigit = false;
+    bool bExact = true;
+
+    auto AddDigit = [&](char c, bool bFraction)
+    {
+      bAnyDigit = true;
+
+      if (uiMantissa == 0 && c == '0')
+      {
+        // leading zeros are not significant
+        iExponent -= bFraction ? 1 : 0;
+        return;
+      }
+
+      if (uiSignificantDigits < 19)
+      {
+        uiMantissa = uiMantissa * 10 + (c - '0');
+        ++uiSignificantDigits;
+        iExponent -= bFraction ? 1 : 0;
+      }
+      else
+      {
+        // the digit doesn't fit into the mantissa anymore
+        iExponent += bFraction ? 0 : 1;
+        bExact = false;
+      }
+    };
+
+    while (p < pEnd && IsDigit(*p))
+    {
+      AddDigit(*p, false);
+      ++p;
+    }
+
+    if (p < pEnd && *p == '.')
+    {
+      ++p;
+
+      while (p < pEnd && IsDigit(*p))
+      {
+        AddDigit(*p, true);
+        ++p;
+      }
+    }
+
+    if (!bAnyDigit)
+      return false;
+
+    if (p < pEnd && (*p == 'e' || *p == 'E'))
+    {
+      ++p;
+
+      bool bNegativeExponent = false;
+      if (p < pEnd && (*p == '-' || *p == '+'))
+      {
+        bNegativeExponent = (*p == '-');
+        ++p;
+      }
+
+      if (p == pEnd || !IsDigit(*p))
+        return false;
+
+      ezInt32 iExplicitExponent = 0;
+      while (p < pEnd && IsDigit(*p))
+      {
+        iExplicitExponent = ezMath::Min(iExplicitExponent * 10 + (*p - '0'), 100000);
+        ++p;
+      }
+
+      iExponent += bNegativeExponent ? -iExplicitExponent : iExplicitExponent;
+    }
+
+    if (p != pEnd)
+      return false;
+
+    if (bExact && uiMantissa <= (1ull << 53) && iExponent >= -22 && iExponent <= 22)
+    {
+      // both the mantissa and the power of ten are exactly representable, so a single multiplication or division is correctly rounded
+      double fValue = static_cast<double>(uiMantissa);
+      fValue = (iExponent < 0) ? fValue / s_PowersOfTen[-iExponent] : fValue * s_PowersOfTen[iExponent];
+      out_fValue = bNegative ? -fValue : fValue;
+      return true;
+    }
+
+    if (uiMantissa == 0)
+    {
+      out_fValue = bNegative ? -0.0 : 0.0;
+      return true;
+    }
+
+    // not exact anymore, but only off by a few ULPs, which is still more precise than what ezJSONParser gets
+    // the power of ten is split into two factors, so that neither overflows or underflows on its own for denormals and huge mantissas
+    const ezInt32 iHalfExponent = iExponent / 2;
+    double fValue = static_cast<double>(uiMantissa);
+    fValue *= ezMath::Pow(10.0, static_cast<double>(iHalfExponent));
+    fValue *= ezMath::Pow(10.0, static_cast<double>(iExponent - iHalfExponent));
+    out_fValue = bNegative ? -fValue : fValue;
+    return true;
+  }
+
+  bool ReadUtf16CodeUnit(const char*& ref_p, const char* pEnd, ezUInt16& out_uiCodeUnit)
+  {
+    if (pEnd - ref_p < 4)
+      return false;
+
+    ezUInt32 uiValue = 0;
+    for (ezUInt32 i = 0; i < 4; ++i)
+    {
+      const char c = ref_p[i];
+      if (!IsDigit(c) && (c < 'a' || c > 'f') && (c < 'A' || c > 'F'))
+        return false;
+    }
+
+    if (ezConversionUtils::ConvertHexStringToUInt32(ezStringView(ref_p, ref_p + 4), uiValue).Failed())
+      return false;
+
+    out_uiCodeUnit = static_cast<ezUInt16>(uiValue);
+    ref_p += 4;
+    return true;
+  }
+
+  /// Resolves all escape sequences. On failure returns false and points ref_pErrorPos at the offending escape sequence.
+  bool DecodeJSONString(ezStringView sRaw, ezStringBuilder& out_sDecoded, const char*& out_pErrorPos)
+  {
+    out_sDecoded.Clear();
+
+    const char* p = sRaw.GetStartPointer();
+    const char* pEnd = sRaw.GetEndPointer();
+
+    while (p < pEnd)
+    {
+      const char* pBackslash = p;
+      while (pBackslash < pEnd && *pBackslash != '\\')
+      {
+        ++pBackslash;
+      }
+
+      out_sDecoded.Append(ezStringView(p, pBackslash));
+
+      if (pBackslash == pEnd)
+        break;
+
+      out_pErrorPos = pBackslash;
+      p = pBackslash + 1;
+
+      if (p == pEnd)
+        return false;
+
+      switch (*p++)
+      {
+        case '"':
+          out_sDecoded.Append('"');
+          break;
+        case '\\':
+          out_sDecoded.Append('\\');
+          break;
+        case '/':
+          out_sDecoded.Append('/');
+          break;
+        case 'b':
+          out_sDecoded.Append('\b');
+          break;
+        case 'f':
+          out_sDecoded.Append('\f');
+          break;
+        case 'n':
+          out_sDecoded.Append('\n');
+          break;
+        case 'r':
+          out_sDecoded.Append('\r');
+          break;
+        case 't':
+          out_sDecoded.Append('\t');
+          break;
+        case 'u':
+        {
+          ezUInt16 codeUnits[2] = {0, 0};
+          if (!ReadUtf16CodeUnit(p, pEnd, codeUnits[0]))
+            return false;
+
+          const ezUInt16* pCodeUnits = codeUnits;
+          if (ezUnicodeUtils::IsUtf16Surrogate(pCodeUnits))
+          {
+            // a surrogate must be followed by the second half of the pair
+            if (pEnd - p < 2 || p[0] != '\\' || p[1] != 'u')
+              return false;
+
+            p += 2;
+            if (!ReadUtf16CodeUnit(p, pEnd, codeUnits[1]))
+              return false;
+          }
+
+          out_sDecoded.Append(ezUnicodeUtils::DecodeUtf16ToUtf32(pCodeUnits));
+        }
+        break;
+
+        default:
+          return false;
+      }
+    }
+
+    return true;
+  }
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+
+ezJSONDocument::ezJSONDocument() = default;
+ezJSONDocument::~ezJSONDocument() = default;
+
+void ezJSONDocument::Clear()
+{
+  m_sJson = {};
+  m_OwnedBuffer.Clear();
+  m_StructuralIndex.Clear();
+  m_Nodes.Clear();
+  m_bCommentsRemoved = false;
+}
+
+ezResult ezJSONDocument::Parse(ezStringView sJson, ezLogInterface* pLog)
+{
+  Clear();
+
+  m_sJson = sJson;
+  return ParseText(pLog);
+}
+
+ezResult ezJSONDocument::Parse(ezStreamReader& inout_stream, ezLogInterface* pLog)
+{
+  Clear();
+
+  ezStreamUtils::ReadAllAndAppend(inout_stream, m_OwnedBuffer);
+
+  const char* pData = reinterpret_cast<const char*>(m_OwnedBuffer.GetData());
+  m_sJson = ezStringView(pData, pData + m_OwnedBuffer.GetCount());
+  return ParseText(pLog);
+}
+
+ezResult ezJSONDocument::ParseText(ezLogInterface* pLog)
+{
+  EZ_ASSERT_DEV(m_sJson.GetElementCount() < 0xFFFFFFFFu - 64, "JSON documents larger than 4 GB are not supported.");
+
+  bool bFoundComments = false;
+  ezResult res = BuildStructuralIndex(pLog, bFoundComments);
+
+  if (res.Succeeded() && bFoundComments)
+  {
+    RemoveComments();
+    res = BuildStructuralIndex(pLog, bFoundComments);
+  }
+
+  if (res.Succeeded())
+  {
+    res = BuildNodes(pLog);
+  }
+
+  m_StructuralIndex.Clear();
+
+  if (res.Failed())
+  {
+    m_Nodes.Clear();
+  }
+
+  return res;
+}
+
+ezResult ezJSONDocument::BuildStructuralIndex(ezLogInterface* pLog, bool& out_bFoundComments)
+{
+  out_bFoundComments = false;
+
+  const char* pData = m_sJson.GetStartPointer();
+  const ezUInt32 uiSize = m_sJson.GetElementCount();
+
+  m_StructuralIndex.Clear();
+  ezUInt32 uiNumIndices = 0;
+
+  ezUInt64 uiPrevEndsOddBackslash = 0;
+  ezUInt64 uiPrevInString = 0;  // all bits set, if the previous block ended inside a string
+  ezUInt64 uiPrevEndsScalar = 0; // 1, if the last byte of the previous block belongs to a number or literal
+
+  char padding[64];
+
+  for (ezUInt32 uiBlockStart = 0; uiBlockStart < uiSize; uiBlockStart += 64)
+  {
+    const char* pBlock = pData + uiBlockStart;
+
+    if (uiSize - uiBlockStart < 64)
+    {
+      // the last block is padded with whitespace, which never produces a structural character
+      ezMemoryUtils::PatternFill(reinterpret_cast<ezUInt8*>(padding), ' ', 64);
+      ezMemoryUtils::Copy(padding, pBlock, uiSize - uiBlockStart);
+      pBlock = padding;
+    }
+
+    ezJSONBlockMasks masks;
+    ClassifyBlock(pBlock, masks);
+
+    const ezUInt64 uiEscaped = FindEscapedCharacters(masks.m_uiBackslashes, uiPrevEndsOddBackslash);
+    const ezUInt64 uiQuotes = masks.m_uiQuotes & ~uiEscaped;
+
+    // includes the opening quote, but not the closing quote
+    const ezUInt64 uiInString = PrefixXor(uiQuotes) ^ uiPrevInString;
+    uiPrevInString = static_cast<ezUInt64>(static_cast<ezInt64>(uiInString) >> 63);
+
+    if ((masks.m_uiSlashes & ~uiInString) != 0 && !m_bCommentsRemoved)
+    {
+      out_bFoundComments = true;
+      return EZ_SUCCESS;
+    }
+
+    // everything outside of strings that is not whitespace, an operator or a quote belongs to a number or a literal
+    const ezUInt64 uiScalars = ~(masks.m_uiOperators | masks.m_uiWhitespace | masks.m_uiQuotes | uiInString);
+    const ezUInt64 uiScalarStarts = uiScalars & ~((uiScalars << 1) | uiPrevEndsScalar);
+    uiPrevEndsScalar = uiScalars >> 63;
+
+    ezUInt64 uiStructurals = (masks.m_uiOperators & ~uiInString) | uiQuotes | uiScalarStarts;
+
+    if (m_StructuralIndex.GetCount() < uiNumIndices + 64)
+    {
+      m_StructuralIndex.SetCountUninitialized(ezMath::Max(m_StructuralIndex.GetCount() * 2, uiNumIndices + 64));
+    }
+
+    ezUInt32* pIndices = m_StructuralIndex.GetData() + uiNumIndices;
+    while (uiStructurals != 0)
+    {
+      *pIndices = uiBlockStart + ezMath::CountTrailingZeros(uiStructurals);
+      ++pIndices;
+      uiStructurals &= uiStructurals - 1;
+    }
+
+    uiNumIndices = static_cast<ezUInt32>(pIndices - m_StructuralIndex.GetData());
+  }
+
+  m_StructuralIndex.SetCountUninitialized(uiNumIndices);
+
+  if (uiPrevInString != 0)
+  {
+    ReportError(pLog, m_StructuralIndex.PeekBack(), "Reached end of document before end of string was found.");
+    return EZ_FAILURE;
+  }
+
+  return EZ_SUCCESS;
+}
+
+void ezJSONDocument::RemoveComments()
+{
+  if (m_OwnedBuffer.IsEmpty() || reinterpret_cast<const char*>(m_OwnedBuffer.GetData()) != m_sJson.GetStartPointer())
+  {
+    m_OwnedBuffer.SetCountUninitialized(m_sJson.GetElementCount());
+    ezMemoryUtils::Copy(m_OwnedBuffer.GetData(), reinterpret_cast<const ezUInt8*>(m_sJson.GetStartPointer()), m_sJson.GetElementCount());
+  }
+
+  char* p = reinterpret_cast<char*>(m_OwnedBuffer.GetData());
+  char* pEnd = p + m_OwnedBuffer.GetCount();
+
+  // comments are replaced by spaces, line breaks are kept so that errors still report the correct line
+  while (p < pEnd)
+  {
+    if (*p == '"')
+    {
+      for (++p; p < pEnd && *p != '"'; ++p)
+      {
+        p += (*p == '\\') ? 1 : 0;
+      }
+
+      ++p;
+    }
+    else if (*p == '/' && p + 1 < pEnd && p[1] == '/')
+    {
+      for (; p < pEnd && *p != '\n'; ++p)
+      {
+        *p = ' ';
+      }
+    }
+    else if (*p == '/' && p + 1 < pEnd && p[1] == '*')
+    {
+      p[0] = ' ';
+      p[1] = ' ';
+
+      for (p += 2; p < pEnd && !(p[0] == '*' && p + 1 < pEnd && p[1] == '/'); ++p)
+      {
+        *p = (*p == '\n') ? '\n' : ' ';
+      }
+
+      for (ezUInt32 i = 0; i < 2 && p < pEnd; ++i, ++p)
+      {
+        *p = ' ';
+      }
+    }
+    else
+    {
+      ++p;
+    }
+  }
+
+  const char* pData = reinterpret_cast<const char*>(m_OwnedBuffer.GetData());
+  m_sJson = ezStringView(pData, pData + m_OwnedBuffer.GetCount());
+  m_bCommentsRemoved = true;
+}
+
+ezResult ezJSONDocument::BuildNodes(ezLogInterface* pLog)
+{
+  enum class State
+  {
+    Value,        // expects any value
+    ObjectMember, // after '{' or ',' in an object: expects a member name or '}'
+    ArrayElement, // after '[' or ',' in an array: expects a value or ']'
+    AfterValue,   // expects ',' or the end of the current container
+  };
+
+  const char* pData = m_sJson.GetStartPointer();
+  const char* pDataEnd = m_sJson.GetEndPointer();
+  const ezUInt32* pIndices = m_StructuralIndex.GetData();
+  const ezUInt32 uiNumIndices = m_StructuralIndex.GetCount();
+
+  if (uiNumIndices == 0)
+    return EZ_SUCCESS;
+
+  // a document has at most one node per structural character
+  m_Nodes.Reserve(uiNumIndices);
+
+  ezHybridArray<ezUInt32, 64> openContainers;
+  ezStringBuilder sTemp;
+
+  ezUInt32 i = 0;
+  State state = State::Value;
+
+  auto Fail = [&](ezUInt32 uiOffset, ezStringView sMessage)
+  {
+    ReportError(pLog, uiOffset, sMessage);
+    return EZ_FAILURE;
+  };
+
+  auto AddString = [&]() -> ezResult
+  {
+    // the closing quote is always the next structural character
+    const ezUInt32 uiOpening = pIndices[i];
+    const ezUInt32 uiClosing = pIndices[i + 1];
+    i += 2;
+
+    Node& node = m_Nodes.ExpandAndGetRef();
+    node.m_uiType = ezJSONValueType::String;
+    node.m_uiFlags = Node::None;
+    node.m_uiReserved = 0;
+    node.m_uiOffset = uiOpening + 1;
+    node.m_Extent.m_uiLength = uiClosing - uiOpening - 1;
+    node.m_Extent.m_uiNext = 0;
+
+    const ezStringView sRaw(pData + node.m_uiOffset, pData + uiClosing);
+    if (memchr(sRaw.GetStartPointer(), '\\', sRaw.GetElementCount()) != nullptr)
+    {
+      node.m_uiFlags = Node::HasEscapeSequences;
+
+      const char* pErrorPos = nullptr;
+      if (!DecodeJSONString(sRaw, sTemp, pErrorPos))
+      {
+        return Fail(static_cast<ezUInt32>(pErrorPos - pData), "Invalid escape sequence in string.");
+      }
+    }
+
+    return EZ_SUCCESS;
+  };
+
+  auto AddContainer = [&](ezJSONValueType::Enum type)
+  {
+    openContainers.PushBack(m_Nodes.GetCount());
+
+    Node& node = m_Nodes.ExpandAndGetRef();
+    node.m_uiType = type;
+    node.m_uiFlags = Node::None;
+    node.m_uiReserved = 0;
+    node.m_uiOffset = pIndices[i];
+    node.m_Extent.m_uiLength = 0;
+    node.m_Extent.m_uiNext = 0;
+
+    ++i;
+  };
+
+  auto CloseContainer = [&]()
+  {
+    m_Nodes[openContainers.PeekBack()].m_Extent.m_uiNext = m_Nodes.GetCount();
+    openContainers.PopBack();
+
+    ++i;
+  };
+
+  auto AddScalar = [&]() -> ezResult
+  {
+    const ezUInt32 uiOffset = pIndices[i];
+    const char* pStart = pData + uiOffset;
+    const char* pEnd = pStart;
+    while (pEnd < pDataEnd && !IsEndOfScalar(*pEnd))
+    {
+      ++pEnd;
+    }
+
+    const ezStringView sText(pStart, pEnd);
+
+    Node& node = m_Nodes.ExpandAndGetRef();
+    node.m_uiFlags = Node::None;
+    node.m_uiReserved = 0;
+    node.m_uiOffset = uiOffset;
+    node.m_fNumber = 0.0;
+
+    ++i;
+
+    if (sText == "true")
+    {
+      node.m_uiType = ezJSONValueType::Bool;
+      node.m_uiFlags = Node::True;
+    }
+    else if (sText == "false")
+    {
+      node.m_uiType = ezJSONValueType::Bool;
+    }
+    else if (sText == "null")
+    {
+      node.m_uiType = ezJSONValueType::Null;
+    }
+    else
+    {
+      node.m_uiType = ezJSONValueType::Number;
+
+      if (!ParseJSONNumber(pStart, pEnd, node.m_fNumber))
+      {
+        sTemp.SetFormat("Parsing value: Expected a number, a string, an object, an array, true, false or null. Got '{0}' instead.", sText);
+        return Fail(uiOffset, sTemp);
+      }
+    }
+
+    return EZ_SUCCESS;
+  };
+
+  while (true)
+  {
+    const char c = (i < uiNumIndices) ? pData[pIndices[i]] : '\0';
+    const ezUInt32 uiOffset = (i < uiNumIndices) ? pIndices[i] : m_sJson.GetElementCount();
+
+    switch (state)
+    {
+      case State::Value:
+      {
+        switch (c)
+        {
+          case '{':
+            AddContainer(ezJSONValueType::Object);
+            state = State::ObjectMember;
+            break;
+
+          case '[':
+            AddContainer(ezJSONValueType::Array);
+            state = State::ArrayElement;
+            break;
+
+          case '"':
+            EZ_SUCCEED_OR_RETURN(AddString());
+            state = State::AfterValue;
+            break;
+
+          case '\0':
+            return Fail(uiOffset, "Reached end of document while expecting a value.");
+
+          case '}':
+          case ']':
+          case ':':
+          case ',':
+            sTemp.SetFormat("Parsing value: Expected a value, got '{0}' instead.", ezArgC(c));
+            return Fail(uiOffset, sTemp);
+
+          default:
+            EZ_SUCCEED_OR_RETURN(AddScalar());
+            state = State::AfterValue;
+            break;
+        }
+      }
+      break;
+
+      case State::ObjectMember:
+      {
+        if (c == '}')
+        {
+          // also accepts a trailing comma, just like ezJSONParser
+          CloseContainer();
+          state = State::AfterValue;
+          break;
+        }
+
+        if (c != '"')
+        {
+          sTemp.SetFormat("Parsing object: Expected a member name or }, got '{0}' instead.", ezArgC(c));
+          return Fail(uiOffset, sTemp);
+        }
+
+        ++m_Nodes[openContainers.PeekBack()].m_Extent.m_uiLength;
+        EZ_SUCCEED_OR_RETURN(AddString());
+
+        if (i >= uiNumIndices || pData[pIndices[i]] != ':')
+        {
+          return Fail(i < uiNumIndices ? pIndices[i] : uiOffset, "After parsing member name: Expected : to separate name and value.");
+        }
+
+        ++i;
+        state = State::Value;
+      }
+      break;
+
+      case State::ArrayElement:
+      {
+        if (c == ']')
+        {
+          CloseContainer();
+          state = State::AfterValue;
+          break;
+        }
+
+        ++m_Nodes[openContainers.PeekBack()].m_Extent.m_uiLength;
+        state = State::Value;
+      }
+      break;
+
+      case State::AfterValue:
+      {
+        if (openContainers.IsEmpty())
+        {
+          if (c != '\0')
+          {
+            sTemp.SetFormat("Expected the end of the document, got '{0}' instead.", ezArgC(c));
+            return Fail(uiOffset, sTemp);
+          }
+
+          return EZ_SUCCESS;
+        }
+
+        const bool bInObject = m_Nodes[openContainers.PeekBack()].m_uiType == ezJSONValueType::Object;
+
+        if (c == ',')
+        {
+          ++i;
+          state = bInObject ? State::ObjectMember : State::ArrayElement;
+        }
+        else if (c == (bInObject ? '}' : ']'))
+        {
+          CloseContainer();
+        }
+        else if (c == '\0')
+        {
+          return Fail(uiOffset, "Reached end of document before all objects and arrays were closed.");
+        }
+        else
+        {
+          sTemp.SetFormat("After parsing value: Expected a comma or {0}, got '{1}' instead.", bInObject ? "}" : "]", ezArgC(c));
+          return Fail(uiOffset, sTemp);
+        }
+      }
+      break;
+    }
+  }
+}
+
+void ezJSONDocument::ReportError(ezLogInterface* pLog, ezUInt32 uiOffset, ezStringView sMessage) const
+{
+  // only computed in case of an error, to not slow down parsing
+  ezUInt32 uiLine = 1;
+  ezUInt32 uiColumn = 1;
+
+  const char* pData = m_sJson.GetStartPointer();
+  const ezUInt32 uiEnd = ezMath::Min(uiOffset, m_sJson.GetElementCount());
+  for (ezUInt32 i = 0; i < uiEnd; ++i)
+  {
+    if (pData[i] == '\n')
+    {
+      ++uiLine;
+      uiColumn = 1;
+    }
+    else
+    {
+      ++uiColumn;
+    }
+  }
+
+  ezLog::Error(pLog, "Line {0} ({1}): {2}", uiLine, uiColumn, sMessage);
+}
+
+ezJSONValue ezJSONDocument::GetRoot() const
+{
+  if (m_Nodes.IsEmpty())
+    return ezJSONValue();
+
+  return ezJSONValue(this, 0);
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+ezJSONValueType::Enum ezJSONValue::GetType() const
+{
+  if (m_pDocument == nullptr)
+    return ezJSONValueType::Invalid;
+
+  return static_cast<ezJSONValueType::Enum>(m_pDocument->m_Nodes[m_uiNode].m_uiType);
+}
+
+bool ezJSONValue::GetBool(bool bDefault) const
+{
+  if (!IsBool())
+    return bDefault;
+
+  return (m_pDocument->m_Nodes[m_uiNode].m_uiFlags & ezJSONDocument::Node::True) != 0;
+}
+
+double ezJSONValue::GetNumber(double fDefault) const
+{
+  if (!IsNumber())
+    return fDefault;
+
+  return m_pDocument->m_Nodes[m_uiNode].m_fNumber;
+}
+
+ezStringView ezJSONValue::GetRawString() const
+{
+  if (!IsString())
+    return {};
+
+  const auto& node = m_pDocument->m_Nodes[m_uiNode];
+  const char* pStart = m_pDocument->m_sJson.GetStartPointer() + node.m_uiOffset;
+  return ezStringView(pStart, pStart + node.m_Extent.m_uiLength);
+}
+
+bool ezJSONValue::HasEscapeSequences() const
+{
+  return IsString() && (m_pDocument->m_Nodes[m_uiNode].m_uiFlags & ezJSONDocument::Node::HasEscapeSequences) != 0;
+}
+
+ezStringView ezJSONValue::GetString(ezStringBuilder& ref_sStorage) const
+{
+  if (!HasEscapeSequences())
+    return GetRawString();
+
+  // the escape sequences were validated during parsing, so this can't fail
+  const char* pErrorPos = nullptr;
+  DecodeJSONString(GetRawString(), ref_sStorage, pErrorPos);
+  return ref_sStorage;
+}
+
+ezUInt32 ezJSONValue::GetCount() const
+{
+  if (!IsArray() && !IsObject())
+    return 0;
+
+  return m_pDocument->m_Nodes[m_uiNode].m_Extent.m_uiLength;
+}
+
+ezJSONValue ezJSONValue::GetElement(ezUInt32 uiIndex) const
+{
+  if (!IsArray() || uiIndex >= GetCount())
+    return ezJSONValue();
+
+  ezUInt32 uiNode = m_uiNode + 1;
+  for (ezUInt32 i = 0; i < uiIndex; ++i)
+  {
+    uiNode = m_pDocument->GetNextNode(uiNode);
+  }
+
+  return ezJSONValue(m_pDocument, uiNode);
+}
+
+ezJSONValue ezJSONValue::FindMember(ezStringView sName) const
+{
+  ezJSONValue result;
+  ezStringBuilder sStorage;
+
+  for (const ezJSONMember& member : GetMembers())
+  {
+    if (member.m_Name.GetString(sStorage) == sName)
+    {
+      result = member.m_Value;
+    }
+  }
+
+  return result;
+}
+
+ezVariant ezJSONValue::ToVariant() const
+{
+  switch (GetType())
+  {
+    case ezJSONValueType::Bool:
+      return GetBool();
+
+    case ezJSONValueType::Number:
+      return GetNumber();
+
+    case ezJSONValueType::String:
+    {
+      ezStringBuilder sStorage;
+      return ezString(GetString(sStorage));
+    }
+
+    case ezJSONValueType::Array:
+    {
+      ezVariantArray elements;
+      elements.Reserve(GetCount());
+
+      for (ezJSONValue element : GetElements())
+      {
+        elements.PushBack(element.ToVariant());
+      }
+
+      return elements;
+    }
+
+    case ezJSONValueType::Object:
+    {
+      ezVariantDictionary members;
+      members.Reserve(GetCount());
+
+      ezStringBuilder sStorage;
+      for (const ezJSONMember& member : GetMembers())
+      {
+        members[member.m_Name.GetString(sStorage)] = member.m_Value.ToVariant();
+      }
+
+      return members;
+    }
+
+    default:
+      return ezVariant();
+  }
+}
+
+ezJSONRange<ezJSONElementIterator> ezJSONValue::GetElements() const
+{
+  ezJSONRange<ezJSONElementIterator> range;
+
+  if (IsArray())
+  {
+    range.m_Begin.m_pDocument = m_pDocument;
+    range.m_Begin.m_uiNode = m_uiNode + 1;
+    range.m_Begin.m_uiRemaining = GetCount();
+  }
+
+  return range;
+}
+
+ezJSONRange<ezJSONMemberIterator> ezJSONValue::GetMembers() const
+{
+  ezJSONRange<ezJSONMemberIterator> range;
+
+  if (IsObject())
+  {
+    range.m_Begin.m_pDocument = m_pDocument;
+    range.m_Begin.m_uiNode = m_uiNode + 1;
+    range.m_Begin.m_uiRemaining = GetCount();
+  }
+
+  return range;
+}
+
+void ezJSONElementIterator::operator++()
+{
+  m_uiNode = m_pDocument->GetNextNode(m_uiNode);
+  --m_uiRemaining;
+}
+
+void ezJSONMemberIterator::operator++()
+{
+  // skip the name and the value
+  m_uiNode = m_pDocument->GetNextNode(m_uiNode + 1);
+  --m_uiRemaining;
+}
+
+EZ_STATICLINK_FILE(Foundation, Foundation_IO_Implementation_JSONDocument);
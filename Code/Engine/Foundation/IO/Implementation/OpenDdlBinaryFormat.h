@@ -0,0 +1,63 @@
+#pragma once
+
+#include <Foundation/IO/OpenDdlParser.h>
+
+// The binary OpenDDL encoding, as written by ezOpenDdlWriter in binary mode and read by ezOpenDdlReader.
+//
+// The document starts with an 8 byte header. Its first byte is zero, which can never be the start of a text document.
+// After that follows a flat sequence of records, each starting with one token byte:
+//
+//   Object:        token, flags, type string, name string, ... child records ..., EndObject token
+//   PrimitiveList: token, primitive type, flags, name string, uint32 count, padding, data
+//
+// Strings are stored as a uint32 byte count, followed by the bytes and a terminating zero, which is not included in the count.
+// The data of a primitive list is padded, such that it is aligned to the size of the primitive type relative to the start of the document.
+// That allows the reader to point directly into the document for all primitive data, as long as the document itself is 8 byte aligned.
+// Strings in primitive lists are stored one after another, in the same way as names.
+namespace ezOpenDdlBinaryFormat
+{
+  static constexpr ezUInt8 s_Magic[7] = {0, 'e', 'z', 'D', 'D', 'L', 'b'};
+  static constexpr ezUInt8 s_uiVersion = 1;
+  static constexpr ezUInt32 s_uiHeaderSize = 8;
+  static constexpr ezUInt32 s_uiDocumentAlignment = 8;
+
+  enum Token : ezUInt8
+  {
+    BeginObject = 'O',
+    EndObject = 'E',
+    PrimitiveList = 'P',
+  };
+
+  enum Flags : ezUInt8
+  {
+    None = 0,
+    GlobalName = EZ_BIT(0),
+  };
+
+  /// \brief Returns the size of a single primitive, which is also its alignment. Zero for strings and custom types.
+  EZ_ALWAYS_INLINE ezUInt32 GetPrimitiveSize(ezOpenDdlPrimitiveType type)
+  {
+    switch (type)
+    {
+      case ezOpenDdlPrimitiveType::Bool:
+      case ezOpenDdlPrimitiveType::Int8:
+      case ezOpenDdlPrimitiveType::UInt8:
+        return 1;
+      case ezOpenDdlPrimitiveType::Int16:
+      case ezOpenDdlPrimitiveType::UInt16:
+        return 2;
+      case ezOpenDdlPrimitiveType::Int32:
+      case ezOpenDdlPrimitiveType::UInt32:
+      case ezOpenDdlPrimitiveType::Float:
+        return 4;
+      case ezOpenDdlPrimitiveType::Int64:
+      case ezOpenDdlPrimitiveType::UInt64:
+      case ezOpenDdlPrimitiveType::Double:
+        return 8;
+      default:
+        return 0;
+    }
+  }
+
+  static_assert(sizeof(bool) == 1, "The binary OpenDDL format stores bools as single bytes");
+} // namespace ezOpenDdlBinaryFormat
@@ -1,6 +1,173 @@
 #include <Foundation/FoundationPCH.h>
 
+#include <Foundation/IO/Implementation/OpenDdlBinaryFormat.h>
 #include <Foundation/IO/OpenDdlReader.h>
+#include <Foundation/IO/StreamUtils.h>
+
+namespace
+{
+  /// Returns the bytes that were read to detect a binary document, before it continues with the actual stream.
+  class ezOpenDdlPrefixedStreamReader : public ezStreamReader
+  {
+  public:
+    ezOpenDdlPrefixedStreamReader(ezConstByteArrayPtr prefix, ezStreamReader& inout_stream)
+      : m_Prefix(prefix)
+      , m_pStream(&inout_stream)
+    {
+    }
+
+    virtual ezUInt64 ReadBytes(void* pReadBuffer, ezUInt64 uiBytesToRead) override
+    {
+      if (m_Prefix.IsEmpty())
+        return m_pStream->ReadBytes(pReadBuffer, uiBytesToRead);
+
+      const ezUInt32 uiFromPrefix = static_cast<ezUInt32>(ezMath::Min<ezUInt64>(uiBytesToRead, m_Prefix.GetCount()));
+      ezMemoryUtils::RawByteCopy(pReadBuffer, m_Prefix.GetPtr(), uiFromPrefix);
+      m_Prefix = m_Prefix.GetSubArray(uiFromPrefix);
+
+      if (uiFromPrefix == uiBytesToRead)
+        return uiFromPrefix;
+
+      return uiFromPrefix + m_pStream->ReadBytes(ezMemoryUtils::AddByteOffset(pReadBuffer, uiFromPrefix), uiBytesToRead - uiFromPrefix);
+    }
+
+  private:
+    ezConstByteArrayPtr m_Prefix;
+    ezStreamReader* m_pStream;
+  };
+
+  /// Goes through all records of a binary document, checks that they are valid and reports them to the given callbacks.
+  template <typename BEGIN_OBJECT, typename END_OBJECT, typename PRIMITIVE_LIST, typename STRING>
+  ezResult WalkBinaryDdlDocument(ezConstByteArrayPtr data, ezLogInterface* pLog, BEGIN_OBJECT onBeginObject, END_OBJECT onEndObject, PRIMITIVE_LIST onPrimitiveList, STRING onString)
+  {
+    const ezUInt8* pData = data.GetPtr();
+    const ezUInt64 uiSize = data.GetCount();
+    ezUInt64 uiOffset = ezOpenDdlBinaryFormat::s_uiHeaderSize;
+    ezUInt32 uiDepth = 0;
+
+    auto ReadUInt8 = [&](ezUInt8& out_uiValue) -> bool
+    {
+      if (uiOffset + 1 > uiSize)
+        return false;
+
+      out_uiValue = pData[uiOffset++];
+      return true;
+    };
+
+    auto ReadUInt32 = [&](ezUInt32& out_uiValue) -> bool
+    {
+      if (uiOffset + sizeof(ezUInt32) > uiSize)
+        return false;
+
+      ezMemoryUtils::RawByteCopy(&out_uiValue, pData + uiOffset, sizeof(ezUInt32));
+      uiOffset += sizeof(ezUInt32);
+      return true;
+    };
+
+    auto ReadString = [&](ezStringView& out_sValue) -> bool
+    {
+      ezUInt32 uiLength = 0;
+      if (!ReadUInt32(uiLength) || uiOffset + uiLength + 1 > uiSize || pData[uiOffset + uiLength] != 0)
+        return false;
+
+      const char* szString = reinterpret_cast<const char*>(pData + uiOffset);
+      out_sValue = (uiLength > 0) ? ezStringView(szString, uiLength) : ezStringView();
+      uiOffset += uiLength + 1;
+      return true;
+    };
+
+    auto Fail = [&](ezStringView sMessage) -> ezResult
+    {
+      ezLog::Error(pLog, "Binary OpenDDL document, offset {0}: {1}", uiOffset, sMessage);
+      return EZ_FAILURE;
+    };
+
+    while (uiOffset < uiSize)
+    {
+      const ezUInt8 uiToken = pData[uiOffset++];
+
+      switch (uiToken)
+      {
+        case ezOpenDdlBinaryFormat::BeginObject:
+        {
+          ezUInt8 uiFlags = 0;
+          ezStringView sType, sName;
+          if (!ReadUInt8(uiFlags) || !ReadString(sType) || !ReadString(sName))
+            return Fail("Object header is truncated.");
+
+          onBeginObject(sType, sName, (uiFlags & ezOpenDdlBinaryFormat::GlobalName) != 0);
+          ++uiDepth;
+        }
+        break;
+
+        case ezOpenDdlBinaryFormat::EndObject:
+        {
+          if (uiDepth == 0)
+            return Fail("Closing an object that was never opened.");
+
+          onEndObject();
+          --uiDepth;
+        }
+        break;
+
+        case ezOpenDdlBinaryFormat::PrimitiveList:
+        {
+          ezUInt8 uiType = 0;
+          ezUInt8 uiFlags = 0;
+          ezStringView sName;
+          ezUInt32 uiCount = 0;
+          if (!ReadUInt8(uiType) || !ReadUInt8(uiFlags) || !ReadString(sName) || !ReadUInt32(uiCount))
+            return Fail("Primitive list header is truncated.");
+
+          const ezOpenDdlPrimitiveType type = static_cast<ezOpenDdlPrimitiveType>(uiType);
+          if (uiType >= static_cast<ezUInt8>(ezOpenDdlPrimitiveType::Custom))
+            return Fail("Invalid primitive type.");
+
+          if (uiCount >= EZ_BIT(31))
+            return Fail("Too many primitives.");
+
+          const bool bGlobalName = (uiFlags & ezOpenDdlBinaryFormat::GlobalName) != 0;
+
+          if (type == ezOpenDdlPrimitiveType::String)
+          {
+            onPrimitiveList(type, sName, bGlobalName, uiCount, nullptr);
+
+            for (ezUInt32 i = 0; i < uiCount; ++i)
+            {
+              ezStringView sValue;
+              if (!ReadString(sValue))
+                return Fail("String is truncated.");
+
+              onString(sValue);
+            }
+          }
+          else
+          {
+            const ezUInt32 uiPrimitiveSize = ezOpenDdlBinaryFormat::GetPrimitiveSize(type);
+            uiOffset = ezMemoryUtils::AlignSize<ezUInt64>(uiOffset, uiPrimitiveSize);
+
+            const ezUInt64 uiDataSize = static_cast<ezUInt64>(uiCount) * uiPrimitiveSize;
+            if (uiOffset + uiDataSize > uiSize)
+              return Fail("Primitive data is truncated.");
+
+            onPrimitiveList(type, sName, bGlobalName, uiCount, (uiCount > 0) ? pData + uiOffset : nullptr);
+            uiOffset += uiDataSize;
+          }
+        }
+        break;
+
+        default:
+          --uiOffset;
+          return Fail("Unknown record type.");
+      }
+    }
+
+    if (uiDepth != 0)
+      return Fail("Document ends inside of an object.");
+
+    return EZ_SUCCESS;
+  }
+} // namespace
 
 ezOpenDdlReader::ezOpenDdlReader()
 {
@@ -17,9 +184,24 @@ ezResult ezOpenDdlReader::ParseDocument(ezStreamReader& inout_stream, ezUInt32 u
 {
   EZ_ASSERT_DEBUG(m_ObjectStack.IsEmpty(), "A reader can only be used once.");
 
+  // a binary document starts with a zero byte, which would be an empty text document, so this can't be ambiguous
+  ezUInt8 header[ezOpenDdlBinaryFormat::s_uiHeaderSize];
+  const ezUInt32 uiHeaderSize = static_cast<ezUInt32>(inout_stream.ReadBytes(header, sizeof(header)));
+
+  if (IsBinaryDocument(ezMakeArrayPtr(header, uiHeaderSize)))
+  {
+    m_BinaryDocument.Clear();
+    m_BinaryDocument.PushBackRange(ezMakeArrayPtr(header, uiHeaderSize));
+    ezStreamUtils::ReadAllAndAppend(inout_stream, m_BinaryDocument);
+
+    return ParseBinaryData(m_BinaryDocument, pLog);
+  }
+
+  ezOpenDdlPrefixedStreamReader stream(ezMakeArrayPtr(header, uiHeaderSize), inout_stream);
+
   SetLogInterface(pLog);
   SetCacheSize(uiCacheSizeInKB);
-  SetInputStream(inout_stream, uiFirstLineOffset);
+  SetInputStream(stream, uiFirstLineOffset);
 
   m_TempCache.Reserve(s_uiChunkSize);
 
@@ -37,6 +219,115 @@ ezResult ezOpenDdlReader::ParseDocument(ezStreamReader& inout_stream, ezUInt32 u
   return ParseAll();
 }
 
+ezResult ezOpenDdlReader::ParseBinaryDocument(ezConstByteArrayPtr data, ezLogInterface* pLog)
+{
+  EZ_ASSERT_DEBUG(m_ObjectStack.IsEmpty(), "A reader can only be used once.");
+
+  if (!IsBinaryDocument(data))
+  {
+    ezLog::Error(pLog, "The data is not a binary OpenDDL document.");
+    return EZ_FAILURE;
+  }
+
+  if (!ezMemoryUtils::IsAligned(data.GetPtr(), ezOpenDdlBinaryFormat::s_uiDocumentAlignment))
+  {
+    m_BinaryDocument.Clear();
+    m_BinaryDocument.PushBackRange(data);
+    return ParseBinaryData(m_BinaryDocument, pLog);
+  }
+
+  return ParseBinaryData(data, pLog);
+}
+
+bool ezOpenDdlReader::IsBinaryDocument(ezConstByteArrayPtr data)
+{
+  return data.GetCount() >= ezOpenDdlBinaryFormat::s_uiHeaderSize && ezMemoryUtils::IsEqual(data.GetPtr(), ezOpenDdlBinaryFormat::s_Magic, sizeof(ezOpenDdlBinaryFormat::s_Magic));
+}
+
+ezResult ezOpenDdlReader::ParseBinaryData(ezConstByteArrayPtr data, ezLogInterface* pLog)
+{
+  const ezUInt8 uiVersion = data[sizeof(ezOpenDdlBinaryFormat::s_Magic)];
+  if (uiVersion > ezOpenDdlBinaryFormat::s_uiVersion)
+  {
+    ezLog::Error(pLog, "Binary OpenDDL document has unsupported version {0}.", uiVersion);
+    return EZ_FAILURE;
+  }
+
+  // the first pass only validates the document and counts everything, so that all elements can be allocated at once
+  ezUInt32 uiNumElements = 1;
+  ezUInt32 uiNumStrings = 0;
+
+  EZ_SUCCEED_OR_RETURN(WalkBinaryDdlDocument(
+    data, pLog,
+    [&](ezStringView, ezStringView, bool)
+    { ++uiNumElements; },
+    []() {},
+    [&](ezOpenDdlPrimitiveType, ezStringView, bool, ezUInt32, const ezUInt8*)
+    { ++uiNumElements; },
+    [&](ezStringView)
+    { ++uiNumStrings; }));
+
+  m_BinaryElements.Clear();
+  m_BinaryElements.SetCount(uiNumElements);
+  m_BinaryStrings.SetCountUninitialized(uiNumStrings);
+
+  ezOpenDdlReaderElement* pRoot = &m_BinaryElements[0];
+  pRoot->m_sCustomType = "root";
+
+  ezUInt32 uiNextElement = 1;
+  ezUInt32 uiNextString = 0;
+  m_ObjectStack.PushBack(pRoot);
+
+  // elements are never added to the stack as primitive lists, so the top of the stack is always the parent of the next element
+  auto AddElement = [&](ezOpenDdlPrimitiveType type, ezStringView sType, ezStringView sName, bool bGlobalName) -> ezOpenDdlReaderElement*
+  {
+    ezOpenDdlReaderElement* pElement = &m_BinaryElements[uiNextElement++];
+    pElement->m_PrimitiveType = type;
+    pElement->m_sCustomType = sType;
+    pElement->m_sName = sName;
+
+    if (bGlobalName)
+    {
+      pElement->m_uiNumChildElements = EZ_BIT(31);
+      m_GlobalNames[sName] = pElement;
+    }
+
+    ezOpenDdlReaderElement* pParent = m_ObjectStack.PeekBack();
+    pParent->m_uiNumChildElements++;
+
+    if (pParent->m_pFirstChild == nullptr)
+    {
+      pParent->m_pFirstChild = pElement;
+    }
+    else
+    {
+      const_cast<ezOpenDdlReaderElement*>(pParent->m_pLastChild)->m_pSiblingElement = pElement;
+    }
+
+    pParent->m_pLastChild = pElement;
+    return pElement;
+  };
+
+  return WalkBinaryDdlDocument(
+    data, pLog,
+    [&](ezStringView sType, ezStringView sName, bool bGlobalName)
+    { m_ObjectStack.PushBack(AddElement(ezOpenDdlPrimitiveType::Custom, sType, sName, bGlobalName)); },
+    [&]()
+    { m_ObjectStack.PopBack(); },
+    [&](ezOpenDdlPrimitiveType type, ezStringView sName, bool bGlobalName, ezUInt32 uiCount, const ezUInt8* pPrimitives)
+    {
+      ezOpenDdlReaderElement* pElement = AddElement(type, {}, sName, bGlobalName);
+      pElement->m_uiNumChildElements += uiCount;
+
+      if (type == ezOpenDdlPrimitiveType::String)
+        pElement->m_pFirstChild = (uiCount > 0) ? &m_BinaryStrings[uiNextString] : nullptr;
+      else
+        pElement->m_pFirstChild = pPrimitives;
+    },
+    [&](ezStringView sValue)
+    { m_BinaryStrings[uiNextString++] = sValue; });
+}
+
 const ezOpenDdlReaderElement* ezOpenDdlReader::GetRootElement() const
 {
   EZ_ASSERT_DEBUG(!m_ObjectStack.IsEmpty(), "The reader has not parsed any document yet or an error occurred during parsing.");
@@ -1633,3 +1633,123 @@ EZ_FOUNDATION_DLL void ezOpenDdlUtils::StoreInvalid(ezOpenDdlWriter& ref_writer,
   ref_writer.BeginObject("Invalid", sName, bGlobalName, true);
   ref_writer.EndObject();
 }
+
+void ezOpenDdlUtils::StoreElement(ezOpenDdlWriter& ref_writer, const ezOpenDdlReaderElement* pElement)
+{
+  const bool bGlobalName = pElement->IsNameGlobal();
+  const ezUInt32 uiCount = pElement->GetNumPrimitives();
+
+  switch (pElement->GetPrimitivesType())
+  {
+    case ezOpenDdlPrimitiveType::Custom:
+    {
+      ref_writer.BeginObject(pElement->GetCustomType(), pElement->GetName(), bGlobalName);
+
+      for (const ezOpenDdlReaderElement* pChild = pElement->GetFirstChild(); pChild != nullptr; pChild = pChild->GetSibling())
+      {
+        StoreElement(ref_writer, pChild);
+      }
+
+      ref_writer.EndObject();
+      return;
+    }
+
+    case ezOpenDdlPrimitiveType::String:
+    {
+      ref_writer.BeginPrimitiveList(ezOpenDdlPrimitiveType::String, pElement->GetName(), bGlobalName);
+
+      for (ezUInt32 i = 0; i < uiCount; ++i)
+      {
+        ref_writer.WriteString(pElement->GetPrimitivesString()[i]);
+      }
+
+      ref_writer.EndPrimitiveList();
+      return;
+    }
+
+    default:
+      break;
+  }
+
+  ref_writer.BeginPrimitiveList(pElement->GetPrimitivesType(), pElement->GetName(), bGlobalName);
+
+  // the writer doesn't accept empty arrays
+  if (uiCount > 0)
+  {
+    switch (pElement->GetPrimitivesType())
+    {
+      case ezOpenDdlPrimitiveType::Bool:
+        ref_writer.WriteBool(pElement->GetPrimitivesBool(), uiCount);
+        break;
+      case ezOpenDdlPrimitiveType::Int8:
+        ref_writer.WriteInt8(pElement->GetPrimitivesInt8(), uiCount);
+        break;
+      case ezOpenDdlPrimitiveType::Int16:
+        ref_writer.WriteInt16(pElement->GetPrimitivesInt16(), uiCount);
+        break;
+      case ezOpenDdlPrimitiveType::Int32:
+        ref_writer.WriteInt32(pElement->GetPrimitivesInt32(), uiCount);
+        break;
+      case ezOpenDdlPrimitiveType::Int64:
+        ref_writer.WriteInt64(pElement->GetPrimitivesInt64(), uiCount);
+        break;
+      case ezOpenDdlPrimitiveType::UInt8:
+        ref_writer.WriteUInt8(pElement->GetPrimitivesUInt8(), uiCount);
+        break;
+      case ezOpenDdlPrimitiveType::UInt16:
+        ref_writer.WriteUInt16(pElement->GetPrimitivesUInt16(), uiCount);
+        break;
+      case ezOpenDdlPrimitiveType::UInt32:
+        ref_writer.WriteUInt32(pElement->GetPrimitivesUInt32(), uiCount);
+        break;
+      case ezOpenDdlPrimitiveType::UInt64:
+        ref_writer.WriteUInt64(pElement->GetPrimitivesUInt64(), uiCount);
+        break;
+      case ezOpenDdlPrimitiveType::Float:
+        ref_writer.WriteFloat(pElement->GetPrimitivesFloat(), uiCount);
+        break;
+      case ezOpenDdlPrimitiveType::Double:
+        ref_writer.WriteDouble(pElement->GetPrimitivesDouble(), uiCount);
+        break;
+
+      default:
+        EZ_ASSERT_NOT_IMPLEMENTED;
+        break;
+    }
+  }
+
+  ref_writer.EndPrimitiveList();
+}
+
+static ezResult ConvertDdlDocument(ezStreamReader& inout_input, ezOpenDdlWriter& ref_writer)
+{
+  ezOpenDdlReader reader;
+  EZ_SUCCEED_OR_RETURN(reader.ParseDocument(inout_input));
+
+  // the root element is implicit
+  for (const ezOpenDdlReaderElement* pChild = reader.GetRootElement()->GetFirstChild(); pChild != nullptr; pChild = pChild->GetSibling())
+  {
+    ezOpenDdlUtils::StoreElement(ref_writer, pChild);
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezOpenDdlUtils::ConvertToBinary(ezStreamReader& inout_input, ezStreamWriter& inout_output)
+{
+  ezOpenDdlWriter writer;
+  writer.SetOutputStream(&inout_output);
+  writer.SetBinaryMode(true);
+
+  return ConvertDdlDocument(inout_input, writer);
+}
+
+ezResult ezOpenDdlUtils::ConvertToText(ezStreamReader& inout_input, ezStreamWriter& inout_output, bool bCompactMode /*= false*/)
+{
+  ezOpenDdlWriter writer;
+  writer.SetOutputStream(&inout_output);
+  writer.SetCompactMode(bCompactMode);
+  writer.SetFloatPrecisionMode(ezOpenDdlWriter::FloatPrecisionMode::Exact);
+
+  return ConvertDdlDocument(inout_input, writer);
+}
@@ -1,5 +1,6 @@
 #include <Foundation/FoundationPCH.h>
 
+#include <Foundation/IO/Implementation/OpenDdlBinaryFormat.h>
 #include <Foundation/IO/OpenDdlWriter.h>
 #include <Foundation/Logging/Log.h>
 #include <Foundation/Utilities/ConversionUtils.h>
@@ -186,6 +187,106 @@ void ezOpenDdlWriter::OutputPrimitiveTypeNameShortest(ezOpenDdlPrimitiveType typ
   }
 }
 
+namespace
+{
+  ezUInt8 GetBinaryNameFlags(ezStringView sName, bool bGlobalName)
+  {
+    // the text format can't express a global name without a name either
+    return (bGlobalName && !sName.IsEmpty()) ? ezOpenDdlBinaryFormat::GlobalName : ezOpenDdlBinaryFormat::None;
+  }
+
+  void AppendBinaryString(ezDynamicArray<ezUInt8>& ref_data, ezStringView s)
+  {
+    const ezUInt32 uiLength = s.GetElementCount();
+    const ezUInt32 uiOffset = ref_data.GetCount();
+
+    ref_data.SetCountUninitialized(uiOffset + sizeof(ezUInt32) + uiLength + 1);
+    ezMemoryUtils::RawByteCopy(&ref_data[uiOffset], &uiLength, sizeof(ezUInt32));
+    ezMemoryUtils::RawByteCopy(&ref_data[uiOffset + sizeof(ezUInt32)], s.GetStartPointer(), uiLength);
+    ref_data[uiOffset + sizeof(ezUInt32) + uiLength] = 0;
+  }
+} // namespace
+
+void ezOpenDdlWriter::OutputBinary(const void* pData, ezUInt32 uiBytes)
+{
+  if (m_uiBinaryBytesWritten == 0)
+  {
+    ezUInt8 header[ezOpenDdlBinaryFormat::s_uiHeaderSize];
+    ezMemoryUtils::RawByteCopy(header, ezOpenDdlBinaryFormat::s_Magic, sizeof(ezOpenDdlBinaryFormat::s_Magic));
+    header[sizeof(ezOpenDdlBinaryFormat::s_Magic)] = ezOpenDdlBinaryFormat::s_uiVersion;
+
+    m_pOutput->WriteBytes(header, sizeof(header)).IgnoreResult();
+    m_uiBinaryBytesWritten = sizeof(header);
+  }
+
+  m_pOutput->WriteBytes(pData, uiBytes).IgnoreResult();
+  m_uiBinaryBytesWritten += uiBytes;
+}
+
+void ezOpenDdlWriter::OutputBinaryString(ezStringView s)
+{
+  m_BinaryPrimitives.Clear();
+  AppendBinaryString(m_BinaryPrimitives, s);
+  OutputBinary(m_BinaryPrimitives.GetData(), m_BinaryPrimitives.GetCount());
+  m_BinaryPrimitives.Clear();
+}
+
+void ezOpenDdlWriter::BeginBinaryPrimitiveList(ezOpenDdlPrimitiveType type, ezStringView sName, bool bGlobalName)
+{
+  const auto state = m_StateStack.PeekBack().m_State;
+  EZ_IGNORE_UNUSED(state);
+  EZ_ASSERT_DEBUG(state == State::Empty || state == State::ObjectMultiLine, "DDL Writer is in a state where no primitive list may be created");
+
+  const ezUInt8 header[3] = {ezOpenDdlBinaryFormat::PrimitiveList, static_cast<ezUInt8>(type), GetBinaryNameFlags(sName, bGlobalName)};
+  OutputBinary(header, sizeof(header));
+  OutputBinaryString(sName);
+
+  m_BinaryPrimitives.Clear();
+  m_uiBinaryNumPrimitives = 0;
+
+  m_StateStack.ExpandAndGetRef().m_State = static_cast<State>(type);
+}
+
+void ezOpenDdlWriter::EndBinaryPrimitiveList()
+{
+  const auto state = m_StateStack.PeekBack().m_State;
+  EZ_ASSERT_DEBUG(state >= State::PrimitivesBool && state <= State::PrimitivesString, "No primitive list is open");
+
+  m_StateStack.PopBack();
+
+  OutputBinary(&m_uiBinaryNumPrimitives, sizeof(ezUInt32));
+
+  // pad the data, so that the reader can access it in place
+  const ezUInt32 uiAlignment = ezOpenDdlBinaryFormat::GetPrimitiveSize(static_cast<ezOpenDdlPrimitiveType>(state));
+  if (uiAlignment > 1)
+  {
+    const ezUInt8 padding[8] = {};
+    const ezUInt32 uiMisalignment = static_cast<ezUInt32>(m_uiBinaryBytesWritten % uiAlignment);
+
+    if (uiMisalignment != 0)
+    {
+      OutputBinary(padding, uiAlignment - uiMisalignment);
+    }
+  }
+
+  if (!m_BinaryPrimitives.IsEmpty())
+  {
+    OutputBinary(m_BinaryPrimitives.GetData(), m_BinaryPrimitives.GetCount());
+  }
+
+  m_BinaryPrimitives.Clear();
+  m_uiBinaryNumPrimitives = 0;
+}
+
+void ezOpenDdlWriter::WriteBinaryPrimitives(ezOpenDdlWriter::State exp, const void* pData, ezUInt32 uiBytes, ezUInt32 uiCount)
+{
+  EZ_IGNORE_UNUSED(exp);
+  EZ_ASSERT_DEBUG(m_StateStack.PeekBack().m_State == exp, "Cannot write thie primitive type without have the correct primitive list open");
+
+  m_BinaryPrimitives.PushBackRange(ezMakeArrayPtr(static_cast<const ezUInt8*>(pData), uiBytes));
+  m_uiBinaryNumPrimitives += uiCount;
+}
+
 ezOpenDdlWriter::ezOpenDdlWriter()
 {
   static_assert((int)ezOpenDdlWriter::State::PrimitivesBool == (int)ezOpenDdlPrimitiveType::Bool);
@@ -213,6 +314,22 @@ ezOpenDdlWriter::ezOpenDdlWriter()
 
 void ezOpenDdlWriter::BeginObject(ezStringView sType, ezStringView sName /*= {}*/, bool bGlobalName /*= false*/, bool bSingleLine /*= false*/)
 {
+  if (m_bBinaryMode)
+  {
+    const auto state = m_StateStack.PeekBack().m_State;
+    EZ_IGNORE_UNUSED(state);
+    EZ_ASSERT_DEBUG(state == State::Empty || state == State::ObjectMultiLine, "DDL Writer is in a state where no further objects may be created");
+
+    const ezUInt8 header[2] = {ezOpenDdlBinaryFormat::BeginObject, GetBinaryNameFlags(sName, bGlobalName)};
+    OutputBinary(header, sizeof(header));
+    OutputBinaryString(sType);
+    OutputBinaryString(sName);
+
+    // binary objects don't need to distinguish between the start and the rest of an object
+    m_StateStack.ExpandAndGetRef().m_State = State::ObjectMultiLine;
+    return;
+  }
+
   {
     const auto state = m_StateStack.PeekBack().m_State;
     EZ_IGNORE_UNUSED(state);
@@ -329,6 +446,17 @@ void ezOpenDdlWriter::OutputObjectName(ezStringView sName, bool bGlobalName)
 
 void ezOpenDdlWriter::EndObject()
 {
+  if (m_bBinaryMode)
+  {
+    EZ_ASSERT_DEBUG(m_StateStack.PeekBack().m_State == State::ObjectMultiLine, "No object is open");
+
+    const ezUInt8 token = ezOpenDdlBinaryFormat::EndObject;
+    OutputBinary(&token, 1);
+
+    m_StateStack.PopBack();
+    return;
+  }
+
   const auto state = m_StateStack.PeekBack().m_State;
   EZ_ASSERT_DEBUG(state == State::ObjectSingleLine || state == State::ObjectMultiLine || state == State::ObjectStart, "No object is open");
 
@@ -369,6 +497,12 @@ void ezOpenDdlWriter::EndObject()
 
 void ezOpenDdlWriter::BeginPrimitiveList(ezOpenDdlPrimitiveType type, ezStringView sName /*= {}*/, bool bGlobalName /*= false*/)
 {
+  if (m_bBinaryMode)
+  {
+    BeginBinaryPrimitiveList(type, sName, bGlobalName);
+    return;
+  }
+
   OutputObjectBeginning();
 
   const auto state = m_StateStack.PeekBack().m_State;
@@ -400,6 +534,12 @@ void ezOpenDdlWriter::BeginPrimitiveList(ezOpenDdlPrimitiveType type, ezStringVi
 
 void ezOpenDdlWriter::EndPrimitiveList()
 {
+  if (m_bBinaryMode)
+  {
+    EndBinaryPrimitiveList();
+    return;
+  }
+
   const auto state = m_StateStack.PeekBack().m_State;
   EZ_IGNORE_UNUSED(state);
   EZ_ASSERT_DEBUG(state >= State::PrimitivesBool && state <= State::PrimitivesString, "No primitive list is open");
@@ -454,6 +594,12 @@ void ezOpenDdlWriter::WriteBool(const bool* pValues, ezUInt32 uiCount /*= 1*/)
   EZ_ASSERT_DEBUG(pValues != nullptr, "Invalid value array");
   EZ_ASSERT_DEBUG(uiCount > 0, "This is pointless");
 
+  if (m_bBinaryMode)
+  {
+    WriteBinaryPrimitives(State::PrimitivesBool, pValues, sizeof(bool) * uiCount, uiCount);
+    return;
+  }
+
   WritePrimitiveType(State::PrimitivesBool);
 
   if (m_bCompactMode || m_TypeStringMode == TypeStringMode::Shortest)
@@ -495,6 +641,12 @@ void ezOpenDdlWriter::WriteInt8(const ezInt8* pValues, ezUInt32 uiCount /*= 1*/)
   EZ_ASSERT_DEBUG(pValues != nullptr, "Invalid value array");
   EZ_ASSERT_DEBUG(uiCount > 0, "This is pointless");
 
+  if (m_bBinaryMode)
+  {
+    WriteBinaryPrimitives(State::PrimitivesInt8, pValues, sizeof(ezInt8) * uiCount, uiCount);
+    return;
+  }
+
   WritePrimitiveType(State::PrimitivesInt8);
 
   m_sTemp.SetFormat("{0}", pValues[0]);
@@ -512,6 +664,12 @@ void ezOpenDdlWriter::WriteInt16(const ezInt16* pValues, ezUInt32 uiCount /*= 1*
   EZ_ASSERT_DEBUG(pValues != nullptr, "Invalid value array");
   EZ_ASSERT_DEBUG(uiCount > 0, "This is pointless");
 
+  if (m_bBinaryMode)
+  {
+    WriteBinaryPrimitives(State::PrimitivesInt16, pValues, sizeof(ezInt16) * uiCount, uiCount);
+    return;
+  }
+
   WritePrimitiveType(State::PrimitivesInt16);
 
   m_sTemp.SetFormat("{0}", pValues[0]);
@@ -529,6 +687,12 @@ void ezOpenDdlWriter::WriteInt32(const ezInt32* pValues, ezUInt32 uiCount /*= 1*
   EZ_ASSERT_DEBUG(pValues != nullptr, "Invalid value array");
   EZ_ASSERT_DEBUG(uiCount > 0, "This is pointless");
 
+  if (m_bBinaryMode)
+  {
+    WriteBinaryPrimitives(State::PrimitivesInt32, pValues, sizeof(ezInt32) * uiCount, uiCount);
+    return;
+  }
+
   WritePrimitiveType(State::PrimitivesInt32);
 
   m_sTemp.SetFormat("{0}", pValues[0]);
@@ -546,6 +710,12 @@ void ezOpenDdlWriter::WriteInt64(const ezInt64* pValues, ezUInt32 uiCount /*= 1*
   EZ_ASSERT_DEBUG(pValues != nullptr, "Invalid value array");
   EZ_ASSERT_DEBUG(uiCount > 0, "This is pointless");
 
+  if (m_bBinaryMode)
+  {
+    WriteBinaryPrimitives(State::PrimitivesInt64, pValues, sizeof(ezInt64) * uiCount, uiCount);
+    return;
+  }
+
   WritePrimitiveType(State::PrimitivesInt64);
 
   m_sTemp.SetFormat("{0}", pValues[0]);
@@ -564,6 +734,12 @@ void ezOpenDdlWriter::WriteUInt8(const ezUInt8* pValues, ezUInt32 uiCount /*= 1*
   EZ_ASSERT_DEBUG(pValues != nullptr, "Invalid value array");
   EZ_ASSERT_DEBUG(uiCount > 0, "This is pointless");
 
+  if (m_bBinaryMode)
+  {
+    WriteBinaryPrimitives(State::PrimitivesUInt8, pValues, sizeof(ezUInt8) * uiCount, uiCount);
+    return;
+  }
+
   WritePrimitiveType(State::PrimitivesUInt8);
 
   m_sTemp.SetFormat("{0}", pValues[0]);
@@ -581,6 +757,12 @@ void ezOpenDdlWriter::WriteUInt16(const ezUInt16* pValues, ezUInt32 uiCount /*=
   EZ_ASSERT_DEBUG(pValues != nullptr, "Invalid value array");
   EZ_ASSERT_DEBUG(uiCount > 0, "This is pointless");
 
+  if (m_bBinaryMode)
+  {
+    WriteBinaryPrimitives(State::PrimitivesUInt16, pValues, sizeof(ezUInt16) * uiCount, uiCount);
+    return;
+  }
+
   WritePrimitiveType(State::PrimitivesUInt16);
 
   m_sTemp.SetFormat("{0}", pValues[0]);
@@ -598,6 +780,12 @@ void ezOpenDdlWriter::WriteUInt32(const ezUInt32* pValues, ezUInt32 uiCount /*=
   EZ_ASSERT_DEBUG(pValues != nullptr, "Invalid value array");
   EZ_ASSERT_DEBUG(uiCount > 0, "This is pointless");
 
+  if (m_bBinaryMode)
+  {
+    WriteBinaryPrimitives(State::PrimitivesUInt32, pValues, sizeof(ezUInt32) * uiCount, uiCount);
+    return;
+  }
+
   WritePrimitiveType(State::PrimitivesUInt32);
 
   m_sTemp.SetFormat("{0}", pValues[0]);
@@ -615,6 +803,12 @@ void ezOpenDdlWriter::WriteUInt64(const ezUInt64* pValues, ezUInt32 uiCount /*=
   EZ_ASSERT_DEBUG(pValues != nullptr, "Invalid value array");
   EZ_ASSERT_DEBUG(uiCount > 0, "This is pointless");
 
+  if (m_bBinaryMode)
+  {
+    WriteBinaryPrimitives(State::PrimitivesUInt64, pValues, sizeof(ezUInt64) * uiCount, uiCount);
+    return;
+  }
+
   WritePrimitiveType(State::PrimitivesUInt64);
 
   m_sTemp.SetFormat("{0}", pValues[0]);
@@ -632,6 +826,12 @@ void ezOpenDdlWriter::WriteFloat(const float* pValues, ezUInt32 uiCount /*= 1*/)
   EZ_ASSERT_DEBUG(pValues != nullptr, "Invalid value array");
   EZ_ASSERT_DEBUG(uiCount > 0, "This is pointless");
 
+  if (m_bBinaryMode)
+  {
+    WriteBinaryPrimitives(State::PrimitivesFloat, pValues, sizeof(float) * uiCount, uiCount);
+    return;
+  }
+
   WritePrimitiveType(State::PrimitivesFloat);
 
   if (m_FloatPrecisionMode == FloatPrecisionMode::Readable)
@@ -679,6 +879,12 @@ void ezOpenDdlWriter::WriteDouble(const double* pValues, ezUInt32 uiCount /*= 1*
   EZ_ASSERT_DEBUG(pValues != nullptr, "Invalid value array");
   EZ_ASSERT_DEBUG(uiCount > 0, "This is pointless");
 
+  if (m_bBinaryMode)
+  {
+    WriteBinaryPrimitives(State::PrimitivesDouble, pValues, sizeof(double) * uiCount, uiCount);
+    return;
+  }
+
   WritePrimitiveType(State::PrimitivesDouble);
 
   if (m_FloatPrecisionMode == FloatPrecisionMode::Readable)
@@ -723,6 +929,15 @@ void ezOpenDdlWriter::WriteDouble(const double* pValues, ezUInt32 uiCount /*= 1*
 
 void ezOpenDdlWriter::WriteString(const ezStringView& sString)
 {
+  if (m_bBinaryMode)
+  {
+    EZ_ASSERT_DEBUG(m_StateStack.PeekBack().m_State == State::PrimitivesString, "Cannot write thie primitive type without have the correct primitive list open");
+
+    AppendBinaryString(m_BinaryPrimitives, sString);
+    ++m_uiBinaryNumPrimitives;
+    return;
+  }
+
   WritePrimitiveType(State::PrimitivesString);
 
   OutputEscapedString(sString);
@@ -732,6 +947,18 @@ void ezOpenDdlWriter::WriteBinaryAsString(const void* pData, ezUInt32 uiBytes)
 {
   /// \test ezOpenDdlWriter::WriteBinaryAsString
 
+  if (m_bBinaryMode)
+  {
+    m_sTemp.Clear();
+    for (ezUInt32 i = 0; i < uiBytes; ++i)
+    {
+      m_sTemp.AppendFormat("{}", ezArgU(static_cast<const ezUInt8*>(pData)[i], 2, true, 16, true));
+    }
+
+    WriteString(m_sTemp);
+    return;
+  }
+
   WritePrimitiveType(State::PrimitivesString);
 
   OutputString("\"", 1);
@@ -0,0 +1,259 @@
+#pragma once
+
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Strings/StringView.h>
+
+class ezJSONDocument;
+class ezJSONElementIterator;
+class ezJSONMemberIterator;
+class ezLogInterface;
+class ezStreamReader;
+class ezStringBuilder;
+class ezVariant;
+
+/// \brief The type of a value in an ezJSONDocument.
+struct ezJSONValueType
+{
+  using StorageType = ezUInt8;
+
+  enum Enum : StorageType
+  {
+    Invalid, ///< The value does not exist, e.g. a member that was not found or the root of an empty document.
+    Null,
+    Bool,
+    Number,
+    String,
+    Array,
+    Object,
+
+    Default = Invalid
+  };
+};
+
+template <typename ITERATOR>
+struct ezJSONRange
+{
+  ITERATOR m_Begin;
+  ITERATOR m_End;
+
+  ITERATOR begin() const { return m_Begin; }
+  ITERATOR end() const { return m_End; }
+};
+
+/// \brief A lightweight reference to a value inside an ezJSONDocument.
+///
+/// Values are only valid as long as the document they come from is alive and was not parsed again.
+/// Strings are returned as views into the parsed buffer, so reading a document never copies strings unless they contain escape sequences.
+class EZ_FOUNDATION_DLL ezJSONValue
+{
+public:
+  ezJSONValue() = default;
+
+  bool IsValid() const { return m_pDocument != nullptr; }
+
+  ezJSONValueType::Enum GetType() const;
+
+  bool IsNull() const { return GetType() == ezJSONValueType::Null; }
+  bool IsBool() const { return GetType() == ezJSONValueType::Bool; }
+  bool IsNumber() const { return GetType() == ezJSONValueType::Number; }
+  bool IsString() const { return GetType() == ezJSONValueType::String; }
+  bool IsArray() const { return GetType() == ezJSONValueType::Array; }
+  bool IsObject() const { return GetType() == ezJSONValueType::Object; }
+
+  /// \brief Returns the value of a bool, or \a bDefault if this is not a bool.
+  bool GetBool(bool bDefault = false) const;
+
+  /// \brief Returns the value of a number, or \a fDefault if this is not a number.
+  double GetNumber(double fDefault = 0.0) const;
+
+  /// \brief Returns the text of a string as it is stored in the document, i.e. without the quotes, but with escape sequences.
+  ///
+  /// Returns an empty view, if this is not a string.
+  ezStringView GetRawString() const;
+
+  /// \brief Whether the string contains escape sequences, which means GetRawString() differs from the actual string.
+  bool HasEscapeSequences() const;
+
+  /// \brief Returns the string with all escape sequences resolved.
+  ///
+  /// If the string does not contain any escape sequences, the returned view points into the document and \a ref_sStorage is not touched.
+  /// Otherwise the string is decoded into \a ref_sStorage and the returned view points there.
+  ezStringView GetString(ezStringBuilder& ref_sStorage) const;
+
+  /// \brief Returns the number of elements of an array or the number of members of an object. Zero for all other types.
+  ezUInt32 GetCount() const;
+
+  /// \brief Returns the element of an array with the given index. Arrays store their elements sequentially, so this is O(index).
+  ///
+  /// Use the iterator returned by GetElements() to go through all elements.
+  ezJSONValue GetElement(ezUInt32 uiIndex) const;
+
+  /// \brief Returns the member of an object with the given name, or an invalid value if there is no such member.
+  ///
+  /// Members are searched linearly. If an object contains the same name multiple times, the last one is returned,
+  /// which is the one that ezJSONReader would keep.
+  ezJSONValue FindMember(ezStringView sName) const;
+
+  ezJSONValue operator[](ezUInt32 uiIndex) const { return GetElement(uiIndex); }
+  ezJSONValue operator[](ezStringView sName) const { return FindMember(sName); }
+
+  /// \brief Converts the value into the same ezVariant structure that ezJSONReader creates.
+  ///
+  /// Objects become ezVariantDictionary, arrays become ezVariantArray, numbers are stored as double and null as an invalid ezVariant.
+  /// This copies everything, so it is mostly meant for code that is migrated from ezJSONReader step by step.
+  ezVariant ToVariant() const;
+
+  /// \brief Allows to iterate over the elements of an array with a range-based for loop. Empty, if this is not an array.
+  ezJSONRange<ezJSONElementIterator> GetElements() const;
+
+  /// \brief Allows to iterate over the members of an object with a range-based for loop. Empty, if this is not an object.
+  ezJSONRange<ezJSONMemberIterator> GetMembers() const;
+
+private:
+  friend class ezJSONDocument;
+  friend class ezJSONElementIterator;
+  friend class ezJSONMemberIterator;
+
+  ezJSONValue(const ezJSONDocument* pDocument, ezUInt32 uiNode)
+    : m_pDocument(pDocument)
+    , m_uiNode(uiNode)
+  {
+  }
+
+  const ezJSONDocument* m_pDocument = nullptr;
+  ezUInt32 m_uiNode = 0;
+};
+
+/// \brief Iterates over the elements of an array, see ezJSONValue::GetElements().
+class EZ_FOUNDATION_DLL ezJSONElementIterator
+{
+public:
+  ezJSONValue operator*() const { return ezJSONValue(m_pDocument, m_uiNode); }
+  void operator++();
+  bool operator!=(const ezJSONElementIterator& rhs) const { return m_uiRemaining != rhs.m_uiRemaining; }
+
+private:
+  friend class ezJSONValue;
+  const ezJSONDocument* m_pDocument = nullptr;
+  ezUInt32 m_uiNode = 0;
+  ezUInt32 m_uiRemaining = 0;
+};
+
+/// \brief A member of an object.
+struct ezJSONMember
+{
+  ezJSONValue m_Name; ///< Always a string, use GetRawString() or GetString() to read it.
+  ezJSONValue m_Value;
+};
+
+/// \brief Iterates over the members of an object, see ezJSONValue::GetMembers().
+class EZ_FOUNDATION_DLL ezJSONMemberIterator
+{
+public:
+  ezJSONMember operator*() const { return {ezJSONValue(m_pDocument, m_uiNode), ezJSONValue(m_pDocument, m_uiNode + 1)}; }
+  void operator++();
+  bool operator!=(const ezJSONMemberIterator& rhs) const { return m_uiRemaining != rhs.m_uiRemaining; }
+
+private:
+  friend class ezJSONValue;
+  const ezJSONDocument* m_pDocument = nullptr;
+  ezUInt32 m_uiNode = 0;
+  ezUInt32 m_uiRemaining = 0;
+};
+
+/// \brief Parses an entire JSON document from memory into a compact, read-only tree.
+///
+/// Contrary to ezJSONParser, which reads one character at a time from a stream, this works on a buffer in memory in two stages.
+/// The first stage finds all structural characters (braces, brackets, colons, commas, quotes and the start of every other value)
+/// with SIMD instructions, 64 bytes at a time, while keeping track of which bytes are inside of strings.
+/// The second stage walks only over these positions to validate the document and to build a flat array of 16 byte nodes.
+/// Nodes reference their text in the buffer instead of copying it, so parsing performs only a handful of allocations,
+/// no matter how large the document is.
+///
+/// The accepted syntax is the same as for ezJSONParser, i.e. comments and trailing commas are allowed.
+/// Documents with comments are copied once to blank out the comments.
+///
+/// Use ezMemoryMappedFile to parse a large file without reading it into memory first.
+class EZ_FOUNDATION_DLL ezJSONDocument
+{
+  EZ_DISALLOW_COPY_AND_ASSIGN(ezJSONDocument);
+
+public:
+  ezJSONDocument();
+  ~ezJSONDocument();
+
+  /// \brief Parses the given JSON text. The text is not copied, so it has to stay valid as long as the document is used.
+  ///
+  /// Returns EZ_FAILURE and logs an error with the line and column, if the document is malformed.
+  /// An empty document (or one that only contains whitespace) is valid and has an invalid root value.
+  ezResult Parse(ezStringView sJson, ezLogInterface* pLog = nullptr);
+
+  /// \brief Reads the entire stream into a buffer that is owned by the document and parses it.
+  ezResult Parse(ezStreamReader& inout_stream, ezLogInterface* pLog = nullptr);
+
+  /// \brief Removes all data. The memory of the internal arrays is kept to parse another document.
+  void Clear();
+
+  /// \brief Returns the top-level value of the document.
+  ezJSONValue GetRoot() const;
+
+  /// \brief Returns the number of values (including member names) in the document.
+  ezUInt32 GetNumNodes() const { return m_Nodes.GetCount(); }
+
+private:
+  friend class ezJSONValue;
+  friend class ezJSONElementIterator;
+  friend class ezJSONMemberIterator;
+
+  struct Node
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    enum Flags : ezUInt8
+    {
+      None = 0,
+      True = EZ_BIT(0),
+      HasEscapeSequences = EZ_BIT(1),
+    };
+
+    struct Extent
+    {
+      ezUInt32 m_uiLength; // strings: the number of bytes, containers: the number of elements or members
+      ezUInt32 m_uiNext;   // containers: the index of the first node after the container
+    };
+
+    ezUInt8 m_uiType;
+    ezUInt8 m_uiFlags;
+    ezUInt16 m_uiReserved;
+
+    // strings: the offset of the first character after the quote, all other values: the offset of their first character
+    ezUInt32 m_uiOffset;
+
+    union
+    {
+      double m_fNumber;
+      Extent m_Extent;
+    };
+  };
+
+  static_assert(sizeof(Node) == 16);
+
+  /// \brief Returns the index of the node that follows the given node and all of its children.
+  EZ_ALWAYS_INLINE ezUInt32 GetNextNode(ezUInt32 uiNode) const
+  {
+    const Node& node = m_Nodes[uiNode];
+    return (node.m_uiType == ezJSONValueType::Array || node.m_uiType == ezJSONValueType::Object) ? node.m_Extent.m_uiNext : uiNode + 1;
+  }
+
+  ezResult ParseText(ezLogInterface* pLog);
+  ezResult BuildStructuralIndex(ezLogInterface* pLog, bool& out_bFoundComments);
+  ezResult BuildNodes(ezLogInterface* pLog);
+  void RemoveComments();
+  void ReportError(ezLogInterface* pLog, ezUInt32 uiOffset, ezStringView sMessage) const;
+
+  ezStringView m_sJson;
+  ezDynamicArray<ezUInt8> m_OwnedBuffer;      // holds the text, if it was read from a stream or if comments had to be removed
+  ezDynamicArray<ezUInt32> m_StructuralIndex; // the result of the first stage, only needed during parsing
+  ezDynamicArray<Node> m_Nodes;
+  bool m_bCommentsRemoved = false;
+};
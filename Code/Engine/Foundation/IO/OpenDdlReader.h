@@ -114,6 +114,10 @@ private:
 };
 
 /// \brief An OpenDDL reader parses an entire DDL document and creates an in-memory representation of the document structure.
+///
+/// The reader accepts text documents as well as the binary encoding that ezOpenDdlWriter writes in binary mode.
+/// For binary documents all elements are created in a single array and all names, strings and primitives point directly into the document,
+/// so reading them performs no per-element allocations and no parsing of values.
 class EZ_FOUNDATION_DLL ezOpenDdlReader : public ezOpenDdlParser
 {
 public:
@@ -122,6 +126,8 @@ public:
 
   /// \brief Parses the given document, returns EZ_FAILURE if an unrecoverable parsing error was encountered.
   ///
+  /// Binary documents are detected automatically. They are read into a buffer owned by the reader, the callbacks of ezOpenDdlParser are not used for them.
+  ///
   /// \param stream is the input data.
   /// \param uiFirstLineOffset allows to adjust the reported line numbers in error messages, in case the given stream represents a sub-section of a
   /// larger file. \param pLog is used for outputting details about parsing errors. If nullptr is given, no details are logged. \param uiCacheSizeInKB
@@ -130,6 +136,15 @@ public:
   ezResult ParseDocument(ezStreamReader& inout_stream, ezUInt32 uiFirstLineOffset = 0, ezLogInterface* pLog = ezLog::GetThreadLocalLogSystem(),
     ezUInt32 uiCacheSizeInKB = 4); // [tested]
 
+  /// \brief Reads a binary document directly from memory, e.g. from an ezMemoryMappedFile.
+  ///
+  /// The data is not copied, so it has to stay valid as long as the elements of this reader are used.
+  /// If the data is not 8 byte aligned, it is copied once, because the primitives are accessed in place.
+  ezResult ParseBinaryDocument(ezConstByteArrayPtr data, ezLogInterface* pLog = ezLog::GetThreadLocalLogSystem());
+
+  /// \brief Returns whether the given data starts with the header of a binary OpenDDL document.
+  static bool IsBinaryDocument(ezConstByteArrayPtr data); // [tested]
+
   /// \brief Every document has exactly one root element.
   const ezOpenDdlReaderElement* GetRootElement() const; // [tested]
 
@@ -167,6 +182,8 @@ protected:
   ezStringView CopyString(const ezStringView& string);
   void StorePrimitiveData(bool bThisIsAll, ezUInt32 bytecount, const ezUInt8* pData);
 
+  ezResult ParseBinaryData(ezConstByteArrayPtr data, ezLogInterface* pLog);
+
   void ClearDataChunks();
   ezUInt8* AllocateBytes(ezUInt32 uiNumBytes);
 
@@ -184,4 +201,8 @@ protected:
   ezDeque<ezString> m_Strings;
 
   ezMap<ezString, ezOpenDdlReaderElement*> m_GlobalNames;
+
+  ezDynamicArray<ezUInt8> m_BinaryDocument;                // only used when a binary document is read from a stream or is misaligned
+  ezDynamicArray<ezOpenDdlReaderElement> m_BinaryElements; // all elements of a binary document, including the root
+  ezDynamicArray<ezStringView> m_BinaryStrings;            // the strings of all string primitive lists in a binary document
 };
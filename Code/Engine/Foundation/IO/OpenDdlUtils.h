@@ -252,4 +252,21 @@ namespace ezOpenDdlUtils
 
   /// \brief Writes an invalid variant and an optional name.
   EZ_FOUNDATION_DLL void StoreInvalid(ezOpenDdlWriter& ref_writer, ezStringView sName = {}, bool bGlobalName = false);
+
+  /// \brief Writes the given element and all its children, e.g. to copy parts of one document into another.
+  EZ_FOUNDATION_DLL void StoreElement(ezOpenDdlWriter& ref_writer, const ezOpenDdlReaderElement* pElement); // [tested]
+
+  //////////////////////////////////////////////////////////////////////////
+  //////////////////////////////////////////////////////////////////////////
+  //////////////////////////////////////////////////////////////////////////
+
+  /// \brief Reads a text or binary OpenDDL document and writes it in the binary encoding.
+  ///
+  /// All objects, names and primitives are preserved exactly, only whitespace and comments of text documents are lost.
+  EZ_FOUNDATION_DLL ezResult ConvertToBinary(ezStreamReader& inout_input, ezStreamWriter& inout_output); // [tested]
+
+  /// \brief Reads a text or binary OpenDDL document and writes it as text.
+  ///
+  /// Floats are written as HEX (ezOpenDdlWriter::FloatPrecisionMode::Exact), so converting a binary document to text and back is lossless.
+  EZ_FOUNDATION_DLL ezResult ConvertToText(ezStreamReader& inout_input, ezStreamWriter& inout_output, bool bCompactMode = false); // [tested]
 } // namespace ezOpenDdlUtils
@@ -46,6 +46,21 @@ public:
   /// \brief Returns how float values are output.
   FloatPrecisionMode GetFloatPrecisionMode() const { return m_FloatPrecisionMode; }
 
+  /// \brief Switches the writer to the binary OpenDDL encoding. Must be set before anything is written.
+  ///
+  /// A binary document contains exactly the same information as a text document, but all primitive lists are stored as raw, aligned data.
+  /// ezOpenDdlReader detects binary documents automatically and doesn't need to parse or copy any of the primitives.
+  /// Compact mode, type string mode, float precision mode and indentation have no effect on binary output.
+  /// Use ezOpenDdlUtils::ConvertToText() and ezOpenDdlUtils::ConvertToBinary() to convert between the two forms.
+  void SetBinaryMode(bool bBinary)
+  {
+    EZ_ASSERT_DEV(m_uiBinaryBytesWritten == 0 && m_StateStack.GetCount() == 2, "The output format cannot be changed after writing has started");
+    m_bBinaryMode = bBinary;
+  }
+
+  /// \brief Returns whether the binary OpenDDL encoding is written.
+  bool IsBinaryMode() const { return m_bBinaryMode; }
+
   /// \brief Allows to set the indentation. Negative values are possible.
   /// This makes it possible to set the indentation e.g. to -2, thus the output will only have indentation after a level of 3 has been reached.
   void SetIndentation(ezInt8 iIndentation) { m_iIndentation = iIndentation; }
@@ -142,6 +157,12 @@ protected:
   void WriteBinaryAsHex(const void* pData, ezUInt32 uiBytes);
   void OutputObjectBeginning();
 
+  void OutputBinary(const void* pData, ezUInt32 uiBytes);
+  void OutputBinaryString(ezStringView s);
+  void BeginBinaryPrimitiveList(ezOpenDdlPrimitiveType type, ezStringView sName, bool bGlobalName);
+  void EndBinaryPrimitiveList();
+  void WriteBinaryPrimitives(ezOpenDdlWriter::State exp, const void* pData, ezUInt32 uiBytes, ezUInt32 uiCount);
+
   ezInt32 m_iIndentation = 0;
   bool m_bCompactMode = false;
   TypeStringMode m_TypeStringMode = TypeStringMode::ShortenedUnsignedInt;
@@ -150,4 +171,9 @@ protected:
   ezStringBuilder m_sTemp;
 
   ezHybridArray<DdlState, 16> m_StateStack;
+
+  bool m_bBinaryMode = false;
+  ezUInt64 m_uiBinaryBytesWritten = 0;
+  ezUInt32 m_uiBinaryNumPrimitives = 0;
+  ezDynamicArray<ezUInt8> m_BinaryPrimitives; // the data of the open primitive list, it is written in one piece once the count is known
 };
@@ -0,0 +1,466 @@
+#if __has_include(<linux/io_uring.h>)
+
+#  include <Foundation/Logging/Log.h>
+#  include <Foundation/Threading/Lock.h>
+
+#  include <errno.h>
+#  include <fcntl.h>
+#  include <linux/io_uring.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <sys/syscall.h>
+#  include <sys/uio.h>
+#  include <unistd.h>
+
+/// \brief A minimal io_uring, set up with the raw system calls, so that there is no dependency on liburing.
+class ezIoUring
+{
+  EZ_DISALLOW_COPY_AND_ASSIGN(ezIoUring);
+
+public:
+  ezIoUring() = default;
+  ~ezIoUring()
+  {
+    if (m_pSqes != nullptr)
+      munmap(m_pSqes, m_uiSqesSize);
+    if (m_pCqRing != nullptr && m_pCqRing != m_pSqRing)
+      munmap(m_pCqRing, m_uiCqRingSize);
+    if (m_pSqRing != nullptr)
+      munmap(m_pSqRing, m_uiSqRingSize);
+    if (m_iFd >= 0)
+      close(m_iFd);
+  }
+
+  ezResult Setup(ezUInt32 uiEntries)
+  {
+    io_uring_params params = {};
+    m_iFd = static_cast<int>(syscall(__NR_io_uring_setup, uiEntries, &params));
+    if (m_iFd < 0)
+      return EZ_FAILURE;
+
+    m_uiEntries = params.sq_entries;
+    m_uiSqRingSize = params.sq_off.array + params.sq_entries * sizeof(__u32);
+    m_uiCqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    m_uiSqesSize = params.sq_entries * sizeof(io_uring_sqe);
+
+    const bool bSingleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (bSingleMap)
+    {
+      m_uiSqRingSize = ezMath::Max(m_uiSqRingSize, m_uiCqRingSize);
+    }
+
+    m_pSqRing = Map(m_uiSqRingSize, IORING_OFF_SQ_RING);
+    if (m_pSqRing == nullptr)
+      return EZ_FAILURE;
+
+    m_pCqRing = bSingleMap ? m_pSqRing : Map(m_uiCqRingSize, IORING_OFF_CQ_RING);
+    if (m_pCqRing == nullptr)
+      return EZ_FAILURE;
+
+    m_pSqes = static_cast<io_uring_sqe*>(Map(m_uiSqesSize, IORING_OFF_SQES));
+    if (m_pSqes == nullptr)
+      return EZ_FAILURE;
+
+    ezUInt8* pSq = static_cast<ezUInt8*>(m_pSqRing);
+    m_pSqHead = reinterpret_cast<__u32*>(pSq + params.sq_off.head);
+    m_pSqTail = reinterpret_cast<__u32*>(pSq + params.sq_off.tail);
+    m_uiSqMask = *reinterpret_cast<__u32*>(pSq + params.sq_off.ring_mask);
+    m_pSqArray = reinterpret_cast<__u32*>(pSq + params.sq_off.array);
+
+    ezUInt8* pCq = static_cast<ezUInt8*>(m_pCqRing);
+    m_pCqHead = reinterpret_cast<__u32*>(pCq + params.cq_off.head);
+    m_pCqTail = reinterpret_cast<__u32*>(pCq + params.cq_off.tail);
+    m_uiCqMask = *reinterpret_cast<__u32*>(pCq + params.cq_off.ring_mask);
+    m_pCqes = reinterpret_cast<io_uring_cqe*>(pCq + params.cq_off.cqes);
+
+    return EZ_SUCCESS;
+  }
+
+  ezUInt32 GetNumEntries() const { return m_uiEntries; }
+
+  /// \brief Queues a read into the submission ring. The caller has to make sure that no more than GetNumEntries() reads are in flight.
+  void QueueRead(int iFd, iovec* pBuffer, ezUInt64 uiOffset, ezUInt64 uiUserData)
+  {
+    const __u32 uiTail = *m_pSqTail;
+    const __u32 uiIndex = uiTail & m_uiSqMask;
+
+    io_uring_sqe& sqe = m_pSqes[uiIndex];
+    memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_READV;
+    sqe.fd = iFd;
+    sqe.addr = reinterpret_cast<__u64>(pBuffer);
+    sqe.len = 1;
+    sqe.off = uiOffset;
+    sqe.user_data = uiUserData;
+
+    m_pSqArray[uiIndex] = uiIndex;
+    __atomic_store_n(m_pSqTail, uiTail + 1, __ATOMIC_RELEASE);
+
+    ++m_uiToSubmit;
+  }
+
+  /// \brief Returns how many more requests can be queued before the kernel has to consume the submission ring.
+  ezUInt32 GetNumFreeSubmissionEntries() const
+  {
+    const __u32 uiHead = __atomic_load_n(m_pSqHead, __ATOMIC_ACQUIRE);
+    return m_uiEntries - (*m_pSqTail - uiHead);
+  }
+
+  /// \brief Queues the cancellation of the request with the given user data. The cancellation itself completes with uiUserData.
+  void QueueCancel(ezUInt64 uiUserDataToCancel, ezUInt64 uiUserData)
+  {
+    const __u32 uiTail = *m_pSqTail;
+    const __u32 uiIndex = uiTail & m_uiSqMask;
+
+    io_uring_sqe& sqe = m_pSqes[uiIndex];
+    memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_ASYNC_CANCEL;
+    sqe.fd = -1;
+    sqe.addr = uiUserDataToCancel;
+    sqe.user_data = uiUserData;
+
+    m_pSqArray[uiIndex] = uiIndex;
+    __atomic_store_n(m_pSqTail, uiTail + 1, __ATOMIC_RELEASE);
+
+    ++m_uiToSubmit;
+  }
+
+  /// \brief Submits all queued reads and blocks until at least one read has completed.
+  ezResult SubmitAndWait()
+  {
+    while (true)
+    {
+      const int iResult = static_cast<int>(syscall(__NR_io_uring_enter, m_iFd, m_uiToSubmit, 1, IORING_ENTER_GETEVENTS, nullptr, 0));
+
+      if (iResult >= 0)
+      {
+        m_uiToSubmit -= ezMath::Min<ezUInt32>(m_uiToSubmit, iResult);
+        return EZ_SUCCESS;
+      }
+
+      if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+        return EZ_FAILURE;
+    }
+  }
+
+  /// \brief Calls func(uiUserData, iResult) for every completed read.
+  template <typename Func>
+  void ReapCompletions(Func func)
+  {
+    __u32 uiHead = *m_pCqHead;
+    const __u32 uiTail = __atomic_load_n(m_pCqTail, __ATOMIC_ACQUIRE);
+
+    for (; uiHead != uiTail; ++uiHead)
+    {
+      const io_uring_cqe& cqe = m_pCqes[uiHead & m_uiCqMask];
+      func(cqe.user_data, cqe.res);
+    }
+
+    __atomic_store_n(m_pCqHead, uiHead, __ATOMIC_RELEASE);
+  }
+
+private:
+  void* Map(ezUInt64 uiSize, ezUInt64 uiOffset)
+  {
+    void* pPtr = mmap(nullptr, uiSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_iFd, uiOffset);
+    return pPtr != MAP_FAILED ? pPtr : nullptr;
+  }
+
+  int m_iFd = -1;
+  ezUInt32 m_uiEntries = 0;
+  ezUInt32 m_uiToSubmit = 0;
+
+  void* m_pSqRing = nullptr;
+  void* m_pCqRing = nullptr;
+  io_uring_sqe* m_pSqes = nullptr;
+  ezUInt64 m_uiSqRingSize = 0;
+  ezUInt64 m_uiCqRingSize = 0;
+  ezUInt64 m_uiSqesSize = 0;
+
+  __u32* m_pSqHead = nullptr;
+  __u32* m_pSqTail = nullptr;
+  __u32* m_pSqArray = nullptr;
+  __u32 m_uiSqMask = 0;
+
+  __u32* m_pCqHead = nullptr;
+  __u32* m_pCqTail = nullptr;
+  __u32 m_uiCqMask = 0;
+  io_uring_cqe* m_pCqes = nullptr;
+};
+
+struct ezAsyncFileReaderImpl
+{
+  ezAsyncFileReaderImpl()
+  {
+    // io_uring may be missing or blocked, e.g. by the seccomp filter of a container, in that case all reads use the fallback
+    ezUniquePtr<ezIoUring> pRing = EZ_DEFAULT_NEW(ezIoUring);
+    if (pRing->Setup(64).Succeeded())
+    {
+      m_bAvailable = true;
+      m_FreeRings.PushBack(std::move(pRing));
+    }
+  }
+
+  bool IsNativeQueueAvailable() const { return m_bAvailable; }
+
+  void ReadBatch(const ezAsyncFileReadBatch& batch)
+  {
+    const ezUInt32 uiNumSlots = ezMath::Min(batch.m_Requests.GetCount(), batch.m_uiMaxReadsInFlight);
+
+    ezUniquePtr<ezIoUring> pRing = AcquireRing(uiNumSlots);
+    if (pRing == nullptr)
+    {
+      for (ezUInt32 i = 0; i < batch.m_Requests.GetCount(); ++i)
+      {
+        batch.ReadBlocking(i);
+      }
+      return;
+    }
+
+    // a ring that failed is not reused
+    if (ReadWithRing(batch, *pRing, ezMath::Min(uiNumSlots, pRing->GetNumEntries())).Failed())
+      return;
+
+    EZ_LOCK(m_Mutex);
+    m_FreeRings.PushBack(std::move(pRing));
+  }
+
+private:
+  struct Slot
+  {
+    int m_iFd = -1;
+    ezUInt32 m_uiRequest = 0;
+    ezUInt32 m_uiBytesRead = 0;
+    ezUInt64 m_uiOffset = 0;
+    iovec m_Buffer = {};
+    ezDynamicArray<ezUInt8> m_Data;
+  };
+
+  ezUniquePtr<ezIoUring> AcquireRing(ezUInt32 uiEntries)
+  {
+    {
+      EZ_LOCK(m_Mutex);
+
+      for (ezUInt32 i = 0; i < m_FreeRings.GetCount(); ++i)
+      {
+        if (m_FreeRings[i]->GetNumEntries() >= uiEntries)
+        {
+          ezUniquePtr<ezIoUring> pRing = std::move(m_FreeRings[i]);
+          m_FreeRings.RemoveAtAndSwap(i);
+          return pRing;
+        }
+      }
+    }
+
+    ezUniquePtr<ezIoUring> pRing = EZ_DEFAULT_NEW(ezIoUring);
+    if (pRing->Setup(uiEntries).Failed())
+      return nullptr;
+
+    return pRing;
+  }
+
+  static void QueueRemainder(ezIoUring& ref_ring, Slot& ref_slot, ezUInt32 uiSlot)
+  {
+    ref_slot.m_Buffer.iov_base = ref_slot.m_Data.GetData() + ref_slot.m_uiBytesRead;
+    ref_slot.m_Buffer.iov_len = ref_slot.m_Data.GetCount() - ref_slot.m_uiBytesRead;
+    ref_ring.QueueRead(ref_slot.m_iFd, &ref_slot.m_Buffer, ref_slot.m_uiOffset + ref_slot.m_uiBytesRead, uiSlot);
+  }
+
+  static void FinishSlot(const ezAsyncFileReadBatch& batch, Slot& ref_slot, ezResult result)
+  {
+    close(ref_slot.m_iFd);
+    ref_slot.m_iFd = -1;
+
+    ref_slot.m_Data.SetCountUninitialized(ref_slot.m_uiBytesRead);
+    batch.FinishRead(ref_slot.m_uiRequest, result, ref_slot.m_Data);
+    ref_slot.m_Data.Clear();
+  }
+
+  /// \brief Cancels all reads in flight and waits until the kernel has completed them, then reads them again with the fallback.
+  ///
+  /// Until its completion was reaped, the kernel may still write into the buffer of a read, so the buffers are only released afterwards.
+  static void AbortInFlightReads(const ezAsyncFileReadBatch& batch, ezIoUring& ref_ring, ezDynamicArray<Slot>& ref_slots)
+  {
+    constexpr ezUInt64 uiCancelUserData = ~0ull;
+
+    ezHybridArray<bool, 64> inFlight;
+    inFlight.SetCount(ref_slots.GetCount());
+
+    ezUInt32 uiNumInFlight = 0;
+    for (ezUInt32 i = 0; i < ref_slots.GetCount(); ++i)
+    {
+      if (ref_slots[i].m_iFd < 0)
+        continue;
+
+      inFlight[i] = true;
+      ++uiNumInFlight;
+
+      // reads of regular files complete on their own, the cancellation only speeds things up and is skipped if there is no room for it
+      if (ref_ring.GetNumFreeSubmissionEntries() > 0)
+      {
+        ref_ring.QueueCancel(i, uiCancelUserData);
+      }
+    }
+
+    bool bDrained = true;
+    while (uiNumInFlight > 0)
+    {
+      if (ref_ring.SubmitAndWait().Failed())
+      {
+        bDrained = false;
+        break;
+      }
+
+      ref_ring.ReapCompletions([&](ezUInt64 uiSlot, ezInt32 iResult)
+        {
+          EZ_IGNORE_UNUSED(iResult);
+
+          if (uiSlot != uiCancelUserData && inFlight[static_cast<ezUInt32>(uiSlot)])
+          {
+            inFlight[static_cast<ezUInt32>(uiSlot)] = false;
+            --uiNumInFlight;
+          }
+          //
+        });
+    }
+
+    if (!bDrained)
+    {
+      // the buffers can't be freed safely anymore, leaking them is the only option left
+      ezLog::Error("io_uring failed and {0} reads in flight could not be completed. Their buffers are leaked.", uiNumInFlight);
+    }
+
+    for (ezUInt32 i = 0; i < ref_slots.GetCount(); ++i)
+    {
+      Slot& slot = ref_slots[i];
+      if (slot.m_iFd < 0)
+        continue;
+
+      // the ring holds its own reference to the file, so closing it is safe even if the read is still in flight
+      close(slot.m_iFd);
+      slot.m_iFd = -1;
+
+      if (inFlight[i])
+      {
+        ezDynamicArray<ezUInt8>* pLeakedData = EZ_DEFAULT_NEW(ezDynamicArray<ezUInt8>);
+        pLeakedData->Swap(slot.m_Data);
+      }
+      else
+      {
+        slot.m_Data.Clear();
+      }
+
+      batch.ReadBlocking(slot.m_uiRequest);
+    }
+  }
+
+  static ezResult ReadWithRing(const ezAsyncFileReadBatch& batch, ezIoUring& ref_ring, ezUInt32 uiNumSlots)
+  {
+    ezDynamicArray<Slot> slots;
+    slots.SetCount(uiNumSlots);
+
+    ezHybridArray<ezUInt32, 64> freeSlots;
+    for (ezUInt32 i = uiNumSlots; i > 0; --i)
+    {
+      freeSlots.PushBack(i - 1);
+    }
+
+    ezUInt32 uiNextRequest = 0;
+
+    while (uiNextRequest < batch.m_Requests.GetCount() || freeSlots.GetCount() < uiNumSlots)
+    {
+      // opening the files is synchronous, only the reads go through the ring
+      while (uiNextRequest < batch.m_Requests.GetCount() && !freeSlots.IsEmpty())
+      {
+        const ezUInt32 uiRequest = uiNextRequest++;
+        const ezAsyncFileReadRequest& request = batch.m_Requests[uiRequest];
+
+        Slot& slot = slots[freeSlots.PeekBack()];
+        slot.m_uiRequest = uiRequest;
+        slot.m_uiBytesRead = 0;
+        slot.m_iFd = open(request.m_sAbsolutePath.GetData(), O_RDONLY | O_CLOEXEC);
+
+        struct stat stats;
+        ezUInt32 uiSize = 0;
+        if (slot.m_iFd < 0 || fstat(slot.m_iFd, &stats) != 0 || ezAsyncFileReadBatch::ComputeReadRange(request, static_cast<ezUInt64>(stats.st_size), slot.m_uiOffset, uiSize).Failed())
+        {
+          if (slot.m_iFd >= 0)
+          {
+            FinishSlot(batch, slot, EZ_FAILURE);
+          }
+          else
+          {
+            batch.FinishRead(uiRequest, EZ_FAILURE, slot.m_Data);
+          }
+          continue;
+        }
+
+        slot.m_Data.SetCountUninitialized(uiSize);
+
+        if (uiSize == 0)
+        {
+          FinishSlot(batch, slot, EZ_SUCCESS);
+          continue;
+        }
+
+        QueueRemainder(ref_ring, slot, freeSlots.PeekBack());
+        freeSlots.PopBack();
+      }
+
+      if (freeSlots.GetCount() == uiNumSlots)
+        break;
+
+      if (ref_ring.SubmitAndWait().Failed())
+      {
+        // should not happen with a working ring, but never leave a request without an answer
+        AbortInFlightReads(batch, ref_ring, slots);
+
+        for (; uiNextRequest < batch.m_Requests.GetCount(); ++uiNextRequest)
+        {
+          batch.ReadBlocking(uiNextRequest);
+        }
+
+        return EZ_FAILURE;
+      }
+
+      ref_ring.ReapCompletions([&](ezUInt64 uiSlot, ezInt32 iResult)
+        {
+          Slot& slot = slots[static_cast<ezUInt32>(uiSlot)];
+
+          if (iResult == -EINTR || iResult == -EAGAIN)
+          {
+            QueueRemainder(ref_ring, slot, static_cast<ezUInt32>(uiSlot));
+            return;
+          }
+
+          if (iResult > 0)
+          {
+            slot.m_uiBytesRead += iResult;
+
+            // short reads happen, e.g. when a read crosses the page cache boundary, continue where it stopped
+            if (slot.m_uiBytesRead < slot.m_Data.GetCount())
+            {
+              QueueRemainder(ref_ring, slot, static_cast<ezUInt32>(uiSlot));
+              return;
+            }
+          }
+
+          // a result of zero means the file was truncated in the meantime
+          FinishSlot(batch, slot, iResult >= 0 ? EZ_SUCCESS : EZ_FAILURE);
+          freeSlots.PushBack(static_cast<ezUInt32>(uiSlot)); });
+    }
+
+    return EZ_SUCCESS;
+  }
+
+  bool m_bAvailable = false;
+
+  ezMutex m_Mutex;
+  ezDynamicArray<ezUniquePtr<ezIoUring>> m_FreeRings;
+};
+
+#else
+
+#  include <Foundation/Platform/NoImpl/AsyncFileReader_NoImpl.inl>
+
+#endif
@@ -88,6 +88,9 @@ bool ezMessageLoop_linux::WaitForMessages(ezInt32 iTimeout, ezIpcChannel* pFilte
             m_pollInfos.RemoveAtAndSwap(i);
             m_waitInfos.RemoveAtAndSwap(i);
             continue;
+          case WaitType::Signal:
+            waitInfo.m_pChannel->ProcessSignal();
+            break;
         }
         pollInfo.revents = 0;
       }
@@ -119,6 +122,9 @@ void ezMessageLoop_linux::RegisterWait(ezPipeChannel_linux* pChannel, WaitType t
     case WaitType::Send:
       waitFlags = POLLOUT;
       break;
+    case WaitType::Signal:
+      waitFlags = POLLIN;
+      break;
   }
 
   m_numPendingPollModifications.Increment();
@@ -32,13 +32,15 @@ protected:
 
 private:
   friend class ezPipeChannel_linux;
+  friend class ezSharedMemoryChannel_linux;
 
   enum class WaitType
   {
     Accept,
     IncomingMessage,
     Connect,
-    Send
+    Send,
+    Signal ///< Stays registered like IncomingMessage, calls ezPipeChannel_linux::ProcessSignal when the fd becomes readable.
   };
 
   void RegisterWait(ezPipeChannel_linux* pChannel, WaitType type, int fd);
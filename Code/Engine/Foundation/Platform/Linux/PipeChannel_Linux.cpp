@@ -217,9 +217,7 @@ void ezPipeChannel_linux::AcceptIncomingConnection()
   }
   else
   {
-    SetConnectionState(ConnectionState::Connected);
-    // We are connected. Register for incoming messages events.
-    static_cast<ezMessageLoop_linux*>(m_pOwner)->RegisterWait(this, ezMessageLoop_linux::WaitType::IncomingMessage, m_clientSocketFd);
+    OnConnectionEstablished();
   }
 }
 
@@ -229,6 +227,11 @@ bool ezPipeChannel_linux::NeedWakeup() const
 }
 
 void ezPipeChannel_linux::ProcessConnectSuccessfull()
+{
+  OnConnectionEstablished();
+}
+
+void ezPipeChannel_linux::OnConnectionEstablished()
 {
   SetConnectionState(ConnectionState::Connected);
 
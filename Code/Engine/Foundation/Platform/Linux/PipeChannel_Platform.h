@@ -18,7 +18,7 @@ public:
   ezPipeChannel_linux(ezStringView sAddress, Mode::Enum mode);
   ~ezPipeChannel_linux();
 
-private:
+protected:
   friend class ezMessageLoop;
   friend class ezMessageLoop_linux;
 
@@ -29,11 +29,16 @@ private:
   virtual bool NeedWakeup() const override;
 
   // These are called from MessageLoop_linux on OS events
-  void AcceptIncomingConnection();
-  void ProcessIncomingPackages();
-  void ProcessConnectSuccessfull();
+  virtual void AcceptIncomingConnection();
+  virtual void ProcessIncomingPackages();
+  virtual void ProcessConnectSuccessfull();
+  /// \brief Called for waits of type ezMessageLoop_linux::WaitType::Signal, which derived channels can register for additional file descriptors.
+  virtual void ProcessSignal() {}
 
-private:
+  /// \brief Called once the socket connection between server and client is established. Switches to the connected state.
+  virtual void OnConnectionEstablished();
+
+protected:
   ezString m_serverSocketPath;
   ezString m_clientSocketPath;
   int m_serverSocketFd = -1;
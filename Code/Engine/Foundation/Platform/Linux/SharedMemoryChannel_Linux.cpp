@@ -0,0 +1,452 @@
+#include <Foundation/FoundationPCH.h>
+
+#if EZ_ENABLED(EZ_PLATFORM_LINUX)
+#  include <Foundation/Logging/Log.h>
+#  include <Foundation/Platform/Linux/MessageLoop_Platform.h>
+#  include <Foundation/Platform/Linux/SharedMemoryChannel_Platform.h>
+
+#  include <sys/eventfd.h>
+#  include <sys/mman.h>
+#  include <sys/socket.h>
+#  include <unistd.h>
+
+/// \brief Lives at the start of each ring in the shared memory, the ring data follows directly after it.
+///
+/// The positions only ever increase, the offset into the ring is the position modulo the capacity.
+/// Each member is on its own cache line, so that sender and receiver don't invalidate each others cache lines all the time.
+struct ezSharedMemoryRingHeader
+{
+  alignas(64) ezUInt64 m_uiWritePos;       ///< Written by the sender only.
+  alignas(64) ezUInt64 m_uiReadPos;        ///< Written by the receiver only.
+  alignas(64) ezUInt32 m_uiReceiverWaiting; ///< Set by the receiver before it goes to sleep, the sender resets it and wakes it up.
+  alignas(64) ezUInt32 m_uiSenderWaiting;   ///< Set by the sender when the ring is full, the receiver resets it and wakes it up.
+
+  ezUInt8* GetData() { return reinterpret_cast<ezUInt8*>(this + 1); }
+};
+
+/// \brief Sent by the server together with the file descriptors of the shared memory and the eventfds.
+struct ezSharedMemoryChannelHandshake
+{
+  enum : ezUInt32
+  {
+    MAGIC_VALUE = 'SHMC',
+    NUM_FDS = 3, ///< Shared memory, server wakeup, client wakeup
+  };
+
+  ezUInt32 m_uiMagic = MAGIC_VALUE;
+  ezUInt32 m_uiRingCapacity = 0;
+};
+
+ezSharedMemoryChannel_linux::ezSharedMemoryChannel_linux(ezStringView sAddress, Mode::Enum mode)
+  : ezPipeChannel_linux(sAddress, mode)
+{
+}
+
+ezSharedMemoryChannel_linux::~ezSharedMemoryChannel_linux()
+{
+  // the message loop must not call ProcessSignal anymore, once the shared memory is gone
+  if (m_pOwner)
+  {
+    static_cast<ezMessageLoop_linux*>(m_pOwner)->RemovePendingWaits(this);
+  }
+
+  ReleaseSharedMemory();
+}
+
+void ezSharedMemoryChannel_linux::InternalDisconnect()
+{
+  if (GetConnectionState() == ConnectionState::Disconnected)
+    return;
+
+  ezPipeChannel_linux::InternalDisconnect();
+  ReleaseSharedMemory();
+}
+
+void ezSharedMemoryChannel_linux::OnConnectionEstablished()
+{
+  ezMessageLoop_linux* pLoop = static_cast<ezMessageLoop_linux*>(m_pOwner);
+
+  if (m_Mode == Mode::Client)
+  {
+    // the server sends the shared memory right after accepting the connection
+    m_bWaitingForSharedMemory = true;
+    pLoop->RegisterWait(this, ezMessageLoop_linux::WaitType::IncomingMessage, m_clientSocketFd);
+    return;
+  }
+
+  if (CreateSharedMemory().Failed())
+  {
+    InternalDisconnect();
+    return;
+  }
+
+  pLoop->RegisterWait(this, ezMessageLoop_linux::WaitType::Signal, m_iWakeupFd);
+  pLoop->RegisterWait(this, ezMessageLoop_linux::WaitType::IncomingMessage, m_clientSocketFd);
+  SetConnectionState(ConnectionState::Connected);
+}
+
+ezResult ezSharedMemoryChannel_linux::CreateSharedMemory()
+{
+  EZ_ASSERT_DEV(ezMath::IsPowerOf2(s_uiRingCapacity), "The ring capacity must be a power of two");
+
+  const int iMemoryFd = memfd_create("ezSharedMemoryChannel", MFD_CLOEXEC);
+  if (iMemoryFd < 0)
+  {
+    ezLog::Error("[IPC]Failed to create shared memory. Error {}", errno);
+    return EZ_FAILURE;
+  }
+
+  EZ_SCOPE_EXIT(close(iMemoryFd));
+
+  if (ftruncate(iMemoryFd, 2 * (sizeof(ezSharedMemoryRingHeader) + s_uiRingCapacity)) != 0)
+  {
+    ezLog::Error("[IPC]Failed to resize shared memory. Error {}", errno);
+    return EZ_FAILURE;
+  }
+
+  const int iServerWakeupFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  const int iClientWakeupFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  m_iWakeupFd = iServerWakeupFd;
+  m_iPeerWakeupFd = iClientWakeupFd;
+
+  if (iServerWakeupFd < 0 || iClientWakeupFd < 0)
+  {
+    ezLog::Error("[IPC]Failed to create eventfd. Error {}", errno);
+    ReleaseSharedMemory();
+    return EZ_FAILURE;
+  }
+
+  if (MapSharedMemory(iMemoryFd, s_uiRingCapacity).Failed())
+  {
+    ReleaseSharedMemory();
+    return EZ_FAILURE;
+  }
+
+  // both sides start out waiting, so that the first message wakes up the receiver
+  m_pSendRing->m_uiReceiverWaiting = 1;
+  m_pReceiveRing->m_uiReceiverWaiting = 1;
+
+  ezSharedMemoryChannelHandshake handshake;
+  handshake.m_uiRingCapacity = s_uiRingCapacity;
+
+  const int fds[ezSharedMemoryChannelHandshake::NUM_FDS] = {iMemoryFd, iServerWakeupFd, iClientWakeupFd};
+
+  struct iovec iov = {};
+  iov.iov_base = &handshake;
+  iov.iov_len = sizeof(handshake);
+
+  alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(fds))] = {};
+
+  struct msghdr msg = {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+
+  struct cmsghdr* pControl = CMSG_FIRSTHDR(&msg);
+  pControl->cmsg_level = SOL_SOCKET;
+  pControl->cmsg_type = SCM_RIGHTS;
+  pControl->cmsg_len = CMSG_LEN(sizeof(fds));
+  memcpy(CMSG_DATA(pControl), fds, sizeof(fds));
+
+  if (sendmsg(m_clientSocketFd, &msg, MSG_NOSIGNAL) != sizeof(handshake))
+  {
+    ezLog::Error("[IPC]Failed to send shared memory to the client. Error {}", errno);
+    ReleaseSharedMemory();
+    return EZ_FAILURE;
+  }
+
+  return EZ_SUCCESS;
+}
+
+void ezSharedMemoryChannel_linux::ReceiveSharedMemory()
+{
+  ezSharedMemoryChannelHandshake handshake;
+  handshake.m_uiMagic = 0;
+
+  struct iovec iov = {};
+  iov.iov_base = &handshake;
+  iov.iov_len = sizeof(handshake);
+
+  alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int) * ezSharedMemoryChannelHandshake::NUM_FDS)] = {};
+
+  struct msghdr msg = {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+
+  const ssize_t receiveResult = recvmsg(m_clientSocketFd, &msg, MSG_CMSG_CLOEXEC);
+  if (receiveResult < 0 && errno == EWOULDBLOCK)
+    return;
+
+  int fds[ezSharedMemoryChannelHandshake::NUM_FDS] = {-1, -1, -1};
+  ezUInt32 uiNumFds = 0;
+
+  for (struct cmsghdr* pControl = CMSG_FIRSTHDR(&msg); pControl != nullptr; pControl = CMSG_NXTHDR(&msg, pControl))
+  {
+    if (pControl->cmsg_level == SOL_SOCKET && pControl->cmsg_type == SCM_RIGHTS)
+    {
+      uiNumFds = ezMath::Min<ezUInt32>((pControl->cmsg_len - CMSG_LEN(0)) / sizeof(int), ezSharedMemoryChannelHandshake::NUM_FDS);
+      memcpy(fds, CMSG_DATA(pControl), uiNumFds * sizeof(int));
+    }
+  }
+
+  m_bWaitingForSharedMemory = false;
+  m_iPeerWakeupFd = fds[1];
+  m_iWakeupFd = fds[2];
+
+  EZ_SCOPE_EXIT(if (fds[0] >= 0) close(fds[0]));
+
+  if (receiveResult == 0)
+  {
+    // the server closed the connection before sending the shared memory
+    InternalDisconnect();
+    return;
+  }
+
+  if (receiveResult != sizeof(handshake) || handshake.m_uiMagic != ezSharedMemoryChannelHandshake::MAGIC_VALUE ||
+      uiNumFds != ezSharedMemoryChannelHandshake::NUM_FDS || !ezMath::IsPowerOf2(handshake.m_uiRingCapacity))
+  {
+    ezLog::Error("[IPC]Failed to receive shared memory from the server. Error {}", receiveResult < 0 ? errno : 0);
+    InternalDisconnect();
+    return;
+  }
+
+  if (MapSharedMemory(fds[0], handshake.m_uiRingCapacity).Failed())
+  {
+    InternalDisconnect();
+    return;
+  }
+
+  static_cast<ezMessageLoop_linux*>(m_pOwner)->RegisterWait(this, ezMessageLoop_linux::WaitType::Signal, m_iWakeupFd);
+  SetConnectionState(ConnectionState::Connected);
+}
+
+ezResult ezSharedMemoryChannel_linux::MapSharedMemory(int iMemoryFd, ezUInt32 uiRingCapacity)
+{
+  const ezUInt64 uiRingSize = sizeof(ezSharedMemoryRingHeader) + uiRingCapacity;
+
+  void* pMemory = mmap(nullptr, 2 * uiRingSize, PROT_READ | PROT_WRITE, MAP_SHARED, iMemoryFd, 0);
+  if (pMemory == MAP_FAILED)
+  {
+    ezLog::Error("[IPC]Failed to map shared memory. Error {}", errno);
+    return EZ_FAILURE;
+  }
+
+  // the first ring is written by the server, the second one by the client
+  ezSharedMemoryRingHeader* pServerRing = static_cast<ezSharedMemoryRingHeader*>(pMemory);
+  ezSharedMemoryRingHeader* pClientRing = reinterpret_cast<ezSharedMemoryRingHeader*>(static_cast<ezUInt8*>(pMemory) + uiRingSize);
+
+  EZ_LOCK(m_OutputQueueMutex);
+  m_pSharedMemory = pMemory;
+  m_uiSharedMemorySize = 2 * uiRingSize;
+  m_uiRingCapacity = uiRingCapacity;
+  m_pSendRing = (m_Mode == Mode::Server) ? pServerRing : pClientRing;
+  m_pReceiveRing = (m_Mode == Mode::Server) ? pClientRing : pServerRing;
+  return EZ_SUCCESS;
+}
+
+void ezSharedMemoryChannel_linux::ReleaseSharedMemory()
+{
+  // Send may write into the ring from other threads while holding the output queue mutex
+  EZ_LOCK(m_OutputQueueMutex);
+
+  if (m_pSharedMemory != nullptr)
+  {
+    munmap(m_pSharedMemory, m_uiSharedMemorySize);
+    m_pSharedMemory = nullptr;
+    m_pSendRing = nullptr;
+    m_pReceiveRing = nullptr;
+  }
+
+  if (m_iWakeupFd >= 0)
+  {
+    close(m_iWakeupFd);
+    m_iWakeupFd = -1;
+  }
+
+  if (m_iPeerWakeupFd >= 0)
+  {
+    close(m_iPeerWakeupFd);
+    m_iPeerWakeupFd = -1;
+  }
+
+  m_bWaitingForSharedMemory = false;
+  m_previousSendOffset = 0;
+}
+
+bool ezSharedMemoryChannel_linux::InternalSendImmediately(ezArrayPtr<const ezUInt8> data)
+{
+  if (m_pSendRing == nullptr)
+    return false;
+
+  const ezUInt32 header[2] = {MAGIC_VALUE, data.GetCount() + HEADER_SIZE};
+  if (GetFreeSendSpace() < header[1])
+    return false;
+
+  WriteToRing(ezArrayPtr<const ezUInt8>(reinterpret_cast<const ezUInt8*>(header), HEADER_SIZE));
+  WriteToRing(data);
+  NotifyReceiver();
+  return true;
+}
+
+void ezSharedMemoryChannel_linux::InternalSend()
+{
+  EZ_LOCK(m_OutputQueueMutex);
+
+  if (m_pSendRing == nullptr)
+    return;
+
+  bool bWroteData = false;
+
+  while (!m_OutputQueue.IsEmpty())
+  {
+    const ezMemoryStreamStorageInterface& storage = m_OutputQueue.PeekFront();
+
+    while (m_previousSendOffset < storage.GetStorageSize64())
+    {
+      const ezUInt32 uiFreeSpace = GetFreeSendSpace();
+
+      if (uiFreeSpace == 0)
+      {
+        // Ask the receiver to wake us up once it made room and check again, in case it already did so in the meantime.
+        __atomic_store_n(&m_pSendRing->m_uiSenderWaiting, 1, __ATOMIC_SEQ_CST);
+
+        if (GetFreeSendSpace() == 0)
+        {
+          if (bWroteData)
+          {
+            NotifyReceiver();
+          }
+          return;
+        }
+
+        continue;
+      }
+
+      ezArrayPtr<const ezUInt8> range = storage.GetContiguousMemoryRange(m_previousSendOffset);
+      range = range.GetSubArray(0, ezMath::Min(range.GetCount(), uiFreeSpace));
+
+      WriteToRing(range);
+      m_previousSendOffset += range.GetCount();
+      bWroteData = true;
+    }
+
+    m_previousSendOffset = 0;
+    m_OutputQueue.PopFront();
+  }
+
+  if (bWroteData)
+  {
+    NotifyReceiver();
+  }
+}
+
+ezUInt32 ezSharedMemoryChannel_linux::GetFreeSendSpace() const
+{
+  const ezUInt64 uiWritePos = __atomic_load_n(&m_pSendRing->m_uiWritePos, __ATOMIC_RELAXED);
+  const ezUInt64 uiReadPos = __atomic_load_n(&m_pSendRing->m_uiReadPos, __ATOMIC_SEQ_CST);
+  return m_uiRingCapacity - static_cast<ezUInt32>(uiWritePos - uiReadPos);
+}
+
+void ezSharedMemoryChannel_linux::WriteToRing(ezArrayPtr<const ezUInt8> data)
+{
+  if (data.IsEmpty())
+    return;
+
+  // The receiver may read the data as soon as the write position is updated. It only gets woken up by NotifyReceiver, though.
+  const ezUInt64 uiWritePos = __atomic_load_n(&m_pSendRing->m_uiWritePos, __ATOMIC_RELAXED);
+  const ezUInt32 uiStart = static_cast<ezUInt32>(uiWritePos & (m_uiRingCapacity - 1));
+  const ezUInt32 uiFirstPart = ezMath::Min(data.GetCount(), m_uiRingCapacity - uiStart);
+
+  ezUInt8* pRingData = m_pSendRing->GetData();
+  memcpy(pRingData + uiStart, data.GetPtr(), uiFirstPart);
+  memcpy(pRingData, data.GetPtr() + uiFirstPart, data.GetCount() - uiFirstPart);
+
+  __atomic_store_n(&m_pSendRing->m_uiWritePos, uiWritePos + data.GetCount(), __ATOMIC_RELEASE);
+}
+
+void ezSharedMemoryChannel_linux::NotifyReceiver()
+{
+  // Pairs with ReadFromRing: either the receiver sees the new write position before it goes to sleep, or we see that it is waiting.
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+  if (__atomic_exchange_n(&m_pSendRing->m_uiReceiverWaiting, 0, __ATOMIC_SEQ_CST) != 0)
+  {
+    WakeUpPeer();
+  }
+}
+
+void ezSharedMemoryChannel_linux::ReadFromRing()
+{
+  if (m_pReceiveRing == nullptr)
+    return;
+
+  const ezUInt8* pRingData = m_pReceiveRing->GetData();
+  ezUInt64 uiReadPos = __atomic_load_n(&m_pReceiveRing->m_uiReadPos, __ATOMIC_RELAXED);
+
+  while (true)
+  {
+    const ezUInt64 uiWritePos = __atomic_load_n(&m_pReceiveRing->m_uiWritePos, __ATOMIC_ACQUIRE);
+
+    if (uiWritePos == uiReadPos)
+    {
+      // Tell the sender that we are about to sleep and check once more, in case it wrote something in the meantime.
+      __atomic_store_n(&m_pReceiveRing->m_uiReceiverWaiting, 1, __ATOMIC_SEQ_CST);
+
+      if (__atomic_load_n(&m_pReceiveRing->m_uiWritePos, __ATOMIC_SEQ_CST) == uiReadPos)
+        return;
+
+      continue;
+    }
+
+    // Complete messages are passed to the receive callback straight from the shared memory.
+    // Only messages that wrap around the end of the ring are assembled in the message accumulator.
+    const ezUInt32 uiStart = static_cast<ezUInt32>(uiReadPos & (m_uiRingCapacity - 1));
+    const ezUInt32 uiCount = static_cast<ezUInt32>(ezMath::Min<ezUInt64>(uiWritePos - uiReadPos, m_uiRingCapacity - uiStart));
+
+    ReceiveData(ezArrayPtr<const ezUInt8>(pRingData + uiStart, uiCount));
+
+    uiReadPos += uiCount;
+    __atomic_store_n(&m_pReceiveRing->m_uiReadPos, uiReadPos, __ATOMIC_SEQ_CST);
+
+    if (__atomic_exchange_n(&m_pReceiveRing->m_uiSenderWaiting, 0, __ATOMIC_SEQ_CST) != 0)
+    {
+      WakeUpPeer();
+    }
+  }
+}
+
+void ezSharedMemoryChannel_linux::WakeUpPeer()
+{
+  const ezUInt64 uiValue = 1;
+  const ssize_t writeResult = write(m_iPeerWakeupFd, &uiValue, sizeof(uiValue));
+  EZ_IGNORE_UNUSED(writeResult);
+}
+
+void ezSharedMemoryChannel_linux::ProcessSignal()
+{
+  ezUInt64 uiValue = 0;
+  const ssize_t readResult = read(m_iWakeupFd, &uiValue, sizeof(uiValue));
+  EZ_IGNORE_UNUSED(readResult);
+
+  ReadFromRing();
+
+  // the other side may have made room for queued messages
+  InternalSend();
+}
+
+void ezSharedMemoryChannel_linux::ProcessIncomingPackages()
+{
+  if (m_bWaitingForSharedMemory)
+  {
+    ReceiveSharedMemory();
+    return;
+  }
+
+  // Nothing is sent over the socket after the handshake, the pipe channel only has to notice when it gets closed.
+  ezPipeChannel_linux::ProcessIncomingPackages();
+}
+
+#endif
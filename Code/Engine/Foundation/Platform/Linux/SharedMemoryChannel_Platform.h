@@ -0,0 +1,63 @@
+#pragma once
+
+#include <Foundation/FoundationInternal.h>
+EZ_FOUNDATION_INTERNAL_HEADER
+
+#if EZ_ENABLED(EZ_PLATFORM_LINUX)
+
+#  include <Foundation/Platform/Linux/PipeChannel_Platform.h>
+
+struct ezSharedMemoryRingHeader;
+
+/// \brief IPC channel that transfers the messages through two single producer / single consumer ring buffers in shared memory.
+///
+/// The unix domain socket of ezPipeChannel_linux is used to connect the two processes. Once a client is accepted, the server creates
+/// the shared memory (memfd) and one eventfd per side and passes the file descriptors to the client over the socket.
+/// From then on the socket is only used to detect that the other side went away.
+///
+/// Each side writes into one ring and reads from the other one. Send writes a message directly into the ring, if there is enough
+/// free space and nothing else is queued, otherwise the message is queued and streamed into the ring by the message loop thread.
+/// The eventfds are only signaled when the other side actually waits for data or free space,
+/// so a busy connection runs mostly without system calls.
+class EZ_FOUNDATION_DLL ezSharedMemoryChannel_linux : public ezPipeChannel_linux
+{
+public:
+  ezSharedMemoryChannel_linux(ezStringView sAddress, Mode::Enum mode);
+  ~ezSharedMemoryChannel_linux();
+
+  /// \brief Size of each of the two ring buffers, must be a power of two.
+  static constexpr ezUInt32 s_uiRingCapacity = 8 * 1024 * 1024;
+
+protected:
+  virtual void InternalDisconnect() override;
+  virtual void InternalSend() override;
+  virtual bool InternalSendImmediately(ezArrayPtr<const ezUInt8> data) override;
+
+  virtual void ProcessIncomingPackages() override;
+  virtual void ProcessSignal() override;
+  virtual void OnConnectionEstablished() override;
+
+private:
+  ezResult CreateSharedMemory();
+  void ReceiveSharedMemory();
+  ezResult MapSharedMemory(int iMemoryFd, ezUInt32 uiRingCapacity);
+  void ReleaseSharedMemory();
+
+  ezUInt32 GetFreeSendSpace() const;
+  void WriteToRing(ezArrayPtr<const ezUInt8> data);
+  void NotifyReceiver();
+  void ReadFromRing();
+  void WakeUpPeer();
+
+  int m_iWakeupFd = -1;     ///< Signaled by the other side when there is new data or free space for us.
+  int m_iPeerWakeupFd = -1; ///< Signaled by us to wake up the other side.
+  bool m_bWaitingForSharedMemory = false;
+
+  void* m_pSharedMemory = nullptr;
+  ezUInt64 m_uiSharedMemorySize = 0;
+  ezUInt32 m_uiRingCapacity = 0;
+  ezSharedMemoryRingHeader* m_pSendRing = nullptr;
+  ezSharedMemoryRingHeader* m_pReceiveRing = nullptr;
+};
+
+#endif
@@ -0,0 +1,11 @@
+
+struct ezAsyncFileReaderImpl
+{
+  bool IsNativeQueueAvailable() const { return false; }
+
+  void ReadBatch(const ezAsyncFileReadBatch& batch)
+  {
+    EZ_IGNORE_UNUSED(batch);
+    EZ_REPORT_FAILURE("No native file read queue available on this platform.");
+  }
+};
@@ -0,0 +1,2 @@
+// redirect to shared implementation
+#include <Foundation/Platform/NoImpl/AsyncFileReader_NoImpl.inl>
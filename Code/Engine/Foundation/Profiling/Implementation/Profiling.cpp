@@ -6,11 +6,90 @@
 #include <Foundation/Configuration/Startup.h>
 #include <Foundation/Containers/IdTable.h>
 #include <Foundation/Containers/StaticRingBuffer.h>
+#include <Foundation/Containers/Deque.h>
+#include <Foundation/IO/FileSystem/FileWriter.h>
 #include <Foundation/IO/JSONWriter.h>
+#include <Foundation/IO/OSFile.h>
 #include <Foundation/Memory/CommonAllocators.h>
+#include <Foundation/Memory/MemoryTracker.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Profiling/ProfilingTrace.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Threading/Thread.h>
+#include <Foundation/Threading/ThreadSignal.h>
 #include <Foundation/Threading/ThreadUtils.h>
 
+#include <atomic>
+
+namespace
+{
+  struct InternedNameCacheEntry
+  {
+    const char* m_szSource = nullptr;
+    ezUInt32 m_uiLength = 0;
+    const char* m_szInterned = nullptr;
+  };
+
+  enum
+  {
+    INTERNED_NAME_CACHE_SIZE = 64,
+    INTERNED_NAME_CHUNK_SIZE = 16 * 1024,
+  };
+
+  static thread_local InternedNameCacheEntry s_InternedNameCache[INTERNED_NAME_CACHE_SIZE];
+
+  static ezMutex s_InternedNamesMutex;
+  static ezHashTable<ezStringView, const char*> s_InternedNames; // the keys point to the interned strings themselves
+  static char* s_pInternedNameChunk = nullptr;
+  static ezUInt32 s_uiInternedNameChunkRemaining = 0;
+} // namespace
+
+// static
+const char* ezProfilingSystem::InternName(ezStringView sName)
+{
+  const ezUInt32 uiLength = sName.GetElementCount();
+
+  // Most names are string literals, so the address is a good key for the cache. The content still has to be compared,
+  // though, since the name might also come from a buffer that is reused for different strings.
+  InternedNameCacheEntry& cacheEntry = s_InternedNameCache[((reinterpret_cast<size_t>(sName.GetStartPointer()) >> 3) ^ uiLength) % INTERNED_NAME_CACHE_SIZE];
+  if (cacheEntry.m_szSource == sName.GetStartPointer() && cacheEntry.m_uiLength == uiLength && ezMemoryUtils::IsEqual(cacheEntry.m_szInterned, sName.GetStartPointer(), uiLength))
+  {
+    return cacheEntry.m_szInterned;
+  }
+
+  const char* szInterned = nullptr;
+  {
+    EZ_LOCK(s_InternedNamesMutex);
+
+    if (!s_InternedNames.TryGetValue(sName, szInterned))
+    {
+      if (uiLength + 1 > s_uiInternedNameChunkRemaining)
+      {
+        // interned names are never freed, captures and the per-thread caches may reference them at any time
+        const ezUInt32 uiChunkSize = ezMath::Max<ezUInt32>(INTERNED_NAME_CHUNK_SIZE, uiLength + 1);
+        s_pInternedNameChunk = EZ_NEW_RAW_BUFFER(ezFoundation::GetStaticsAllocator(), char, uiChunkSize);
+        s_uiInternedNameChunkRemaining = uiChunkSize;
+      }
+
+      char* szCopy = s_pInternedNameChunk;
+      ezMemoryUtils::Copy(szCopy, sName.GetStartPointer(), uiLength);
+      szCopy[uiLength] = '\0';
+
+      s_pInternedNameChunk += uiLength + 1;
+      s_uiInternedNameChunkRemaining -= uiLength + 1;
+
+      szInterned = szCopy;
+      s_InternedNames.Insert(ezStringView(szCopy, uiLength), szInterned);
+    }
+  }
+
+  cacheEntry.m_szSource = sName.GetStartPointer();
+  cacheEntry.m_uiLength = uiLength;
+  cacheEntry.m_szInterned = szInterned;
+
+  return szInterned;
+}
+
 #if EZ_ENABLED(EZ_USE_PROFILING)
 
 class ezProfileCaptureDataTransfer : public ezDataTransfer
@@ -62,6 +141,7 @@ EZ_BEGIN_SUBSYSTEM_DECLARATION(Foundation, ProfilingSystem)
   {
     s_ProfileCaptureDataTransfer.DisableDataTransfer();
     ezPlugin::Events().RemoveEventHandler(s_PluginEventSubscription);
+    ezProfilingSystem::StopStreaming();
     ezProfilingSystem::Reset();
   }
 
@@ -81,35 +161,212 @@ namespace
     BUFFER_SIZE_FRAMES = 120 * 60,
   };
 
+  enum
+  {
+    COPIED_NAME_MAX_SIZE = 64, ///< Names of scopes that are not interned are truncated to this size, including the terminator.
+  };
+
   using GPUScopesBuffer = ezStaticRingBuffer<ezProfilingSystem::GPUScope, BUFFER_SIZE_OTHER_THREAD / sizeof(ezProfilingSystem::GPUScope)>;
+  using CounterSamplesBuffer = ezStaticRingBuffer<ezProfilingSystem::CounterSample, BUFFER_SIZE_OTHER_THREAD / sizeof(ezProfilingSystem::CounterSample)>;
 
-  static ezUInt64 s_MainThreadId = 0;
+  constexpr ezUInt32 RoundDownToPowerOfTwo(ezUInt32 uiValue)
+  {
+    ezUInt32 uiResult = 1;
+    while (uiResult * 2 <= uiValue)
+    {
+      uiResult *= 2;
+    }
+    return uiResult;
+  }
 
   struct CpuScopesBufferBase
   {
     virtual ~CpuScopesBufferBase() = default;
 
     ezUInt64 m_uiThreadId = 0;
-    bool IsMainThread() const { return m_uiThreadId == s_MainThreadId; }
+
+    ezProfilingSystem::CPUScope* m_pScopes = nullptr;
+    ezUInt32 m_uiCapacityMask = 0;
+
+    // Total number of scopes that were ever recorded into this buffer. Only the owning thread writes to it.
+    // Scope i is stored at m_pScopes[i & m_uiCapacityMask] until it gets overwritten by scope i + capacity.
+    std::atomic<ezUInt64> m_uiNumRecorded = 0;
+
+    // Scopes before this index were removed by ezProfilingSystem::Clear(). Protected by s_AllCpuScopesMutex.
+    ezUInt64 m_uiFirstValid = 0;
+
+    // Scopes before this index were already written by the streaming thread. Protected by s_AllCpuScopesMutex.
+    ezUInt64 m_uiNumStreamed = 0;
+
+    // Names that are not interned are copied into this ring by RecordName(). Only the owning thread writes to it.
+    // A name never wraps around the end of the ring. The (truncated) byte offset of the name of scope i is stored in m_pNameOffsets[i & m_uiCapacityMask].
+    char* m_pNames = nullptr;
+    ezUInt32 m_uiNamesMask = 0;
+    ezUInt32* m_pNameOffsets = nullptr;
+    std::atomic<ezUInt64> m_uiNumNameBytes = 0;
+
+    EZ_ALWAYS_INLINE ezUInt32 GetCapacity() const { return m_uiCapacityMask + 1; }
+    EZ_ALWAYS_INLINE ezUInt32 GetNamesCapacity() const { return m_uiNamesMask + 1; }
+
+    /// Whether the given name points into the ring of copied names, as opposed to being interned.
+    EZ_ALWAYS_INLINE bool IsCopiedName(const char* szName) const { return szName >= m_pNames && szName < m_pNames + GetNamesCapacity(); }
+
+    /// Returns the index of the oldest scope that is still in the buffer, assuming \a uiNumRecorded scopes were recorded.
+    EZ_ALWAYS_INLINE ezUInt64 GetFirstAvailable(ezUInt64 uiNumRecorded) const
+    {
+      return uiNumRecorded - ezMath::Min<ezUInt64>(uiNumRecorded, GetCapacity());
+    }
+
+    /// Returns the index of the oldest scope that was certainly not touched by the owning thread while the caller copied scopes out of the buffer.
+    ///
+    /// This is the read side of a seqlock: it must be called after the copy. The fence keeps the re-read of m_uiNumRecorded from moving up
+    /// before the copy. If m_uiNumRecorded is N afterwards, the slot of scope N may currently be written, which overwrites scope N - capacity,
+    /// so only scopes from N + 1 - capacity on are intact.
+    /// The same applies to the copied names, \a out_uiNumNameBytes is needed for IsNameIntact().
+    EZ_ALWAYS_INLINE ezUInt64 GetFirstIntactAfterCopy(ezUInt64& out_uiNumNameBytes) const
+    {
+      std::atomic_thread_fence(std::memory_order_acquire);
+      const ezUInt64 uiNumRecorded = m_uiNumRecorded.load(std::memory_order_relaxed);
+      out_uiNumNameBytes = m_uiNumNameBytes.load(std::memory_order_relaxed);
+      return GetFirstAvailable(uiNumRecorded + 1);
+    }
+
+    /// Whether a copied name at the given offset was certainly not touched while it was copied, see GetFirstIntactAfterCopy().
+    /// The owning thread may currently skip to the start of the ring and write a name, which touches up to two maximum name sizes.
+    EZ_ALWAYS_INLINE bool IsNameIntact(ezUInt32 uiNameOffset, ezUInt64 uiNumNameBytes) const
+    {
+      return static_cast<ezUInt32>(uiNumNameBytes) - uiNameOffset <= GetNamesCapacity() - 2 * COPIED_NAME_MAX_SIZE;
+    }
+
+    /// Copies the name into the ring of names and returns the copy. Names longer than COPIED_NAME_MAX_SIZE - 1 bytes are truncated.
+    const char* RecordName(ezStringView sName, ezUInt32& out_uiNameOffset)
+    {
+      ezUInt64 uiOffset = m_uiNumNameBytes.load(std::memory_order_relaxed);
+
+      const ezUInt32 uiRingPos = static_cast<ezUInt32>(uiOffset) & m_uiNamesMask;
+      if (uiRingPos + COPIED_NAME_MAX_SIZE > GetNamesCapacity())
+      {
+        uiOffset += GetNamesCapacity() - uiRingPos;
+      }
+
+      // same as in Record()
+      std::atomic_thread_fence(std::memory_order_release);
+
+      char* szName = m_pNames + (static_cast<ezUInt32>(uiOffset) & m_uiNamesMask);
+      const ezUInt32 uiLength = ezStringUtils::Copy(szName, COPIED_NAME_MAX_SIZE, sName.GetStartPointer(), sName.GetEndPointer());
+      m_uiNumNameBytes.store(uiOffset + uiLength + 1, std::memory_order_release);
+
+      out_uiNameOffset = static_cast<ezUInt32>(uiOffset);
+      return szName;
+    }
+
+    EZ_ALWAYS_INLINE void Record(const ezProfilingSystem::CPUScope& scope, ezUInt32 uiNameOffset)
+    {
+      const ezUInt64 uiIndex = m_uiNumRecorded.load(std::memory_order_relaxed);
+
+      // Pairs with the fence in GetFirstIntactAfterCopy(): a reader that sees any part of the new slot content also sees uiIndex as the count.
+      std::atomic_thread_fence(std::memory_order_release);
+
+      m_pScopes[uiIndex & m_uiCapacityMask] = scope;
+      m_pNameOffsets[uiIndex & m_uiCapacityMask] = uiNameOffset;
+      m_uiNumRecorded.store(uiIndex + 1, std::memory_order_release);
+    }
+
+    /// Copies the scopes [uiFirst, uiNumRecorded) while the owning thread may keep recording, and appends the ones that are intact to \a out_Scopes.
+    /// Copied names are appended to \a inout_Names and the scopes point into it, so it must not be modified anymore while the scopes are in use.
+    /// Returns the number of scopes that were dropped, because they or their names were overwritten during the copy.
+    ezUInt64 CopyScopes(ezUInt64 uiFirst, ezUInt64 uiNumRecorded, ezDynamicArray<ezProfilingSystem::CPUScope>& out_Scopes, ezDynamicArray<char>& inout_Names) const
+    {
+      const ezUInt32 uiFirstScope = out_Scopes.GetCount();
+      const ezUInt32 uiCount = static_cast<ezUInt32>(uiNumRecorded - uiFirst);
+
+      struct CopiedName
+      {
+        EZ_DECLARE_POD_TYPE();
+
+        ezUInt32 m_uiOffset; // in the ring
+        ezUInt32 m_uiIndex;  // in inout_Names
+      };
+
+      ezHybridArray<CopiedName, 256> copiedNames;
+      copiedNames.SetCountUninitialized(uiCount);
+
+      out_Scopes.SetCountUninitialized(uiFirstScope + uiCount);
+      for (ezUInt32 i = 0; i < uiCount; ++i)
+      {
+        const ezUInt32 uiSlot = static_cast<ezUInt32>(uiFirst + i) & m_uiCapacityMask;
+        ezProfilingSystem::CPUScope& scope = out_Scopes[uiFirstScope + i];
+        scope = m_pScopes[uiSlot];
+
+        if (IsCopiedName(scope.m_szName))
+        {
+          // the content may be overwritten at any time, so neither the terminator nor the end of the ring can be relied on
+          const ezUInt32 uiMaxLength = ezMath::Min<ezUInt32>(COPIED_NAME_MAX_SIZE - 1, static_cast<ezUInt32>(m_pNames + GetNamesCapacity() - scope.m_szName));
+
+          copiedNames[i].m_uiOffset = m_pNameOffsets[uiSlot];
+          copiedNames[i].m_uiIndex = inout_Names.GetCount();
+
+          for (ezUInt32 c = 0; c < uiMaxLength && scope.m_szName[c] != '\0'; ++c)
+          {
+            inout_Names.PushBack(scope.m_szName[c]);
+          }
+          inout_Names.PushBack('\0');
+        }
+      }
+
+      ezUInt64 uiNumNameBytes = 0;
+      const ezUInt64 uiFirstIntact = GetFirstIntactAfterCopy(uiNumNameBytes);
+
+      // only now inout_Names doesn't grow anymore
+      ezUInt32 uiNumKept = 0;
+      for (ezUInt32 i = 0; i < uiCount; ++i)
+      {
+        ezProfilingSystem::CPUScope scope = out_Scopes[uiFirstScope + i];
+
+        if (uiFirst + i < uiFirstIntact)
+          continue;
+
+        if (IsCopiedName(scope.m_szName))
+        {
+          if (!IsNameIntact(copiedNames[i].m_uiOffset, uiNumNameBytes))
+            continue;
+
+          scope.m_szName = inout_Names.GetData() + copiedNames[i].m_uiIndex;
+        }
+
+        out_Scopes[uiFirstScope + uiNumKept] = scope;
+        ++uiNumKept;
+      }
+
+      out_Scopes.SetCountUninitialized(uiFirstScope + uiNumKept);
+      return uiCount - uiNumKept;
+    }
   };
 
   template <ezUInt32 SizeInBytes>
   struct CpuScopesBuffer : public CpuScopesBufferBase
   {
-    ezStaticRingBuffer<ezProfilingSystem::CPUScope, SizeInBytes / sizeof(ezProfilingSystem::CPUScope)> m_Data;
-  };
+    // the capacity is rounded down to a power of two, so that the ring buffer index is a simple mask
+    static constexpr ezUInt32 CAPACITY = RoundDownToPowerOfTwo(SizeInBytes / sizeof(ezProfilingSystem::CPUScope));
 
-  CpuScopesBuffer<BUFFER_SIZE_MAIN_THREAD>* CastToMainThreadEventBuffer(CpuScopesBufferBase* pEventBuffer)
-  {
-    EZ_ASSERT_DEV(pEventBuffer->IsMainThread(), "Implementation error");
-    return static_cast<CpuScopesBuffer<BUFFER_SIZE_MAIN_THREAD>*>(pEventBuffer);
-  }
+    // copied names are usually short, a quarter of the size is enough for most threads, even if none of their names are interned
+    static constexpr ezUInt32 NAMES_CAPACITY = RoundDownToPowerOfTwo(SizeInBytes / 4);
 
-  CpuScopesBuffer<BUFFER_SIZE_OTHER_THREAD>* CastToOtherThreadEventBuffer(CpuScopesBufferBase* pEventBuffer)
-  {
-    EZ_ASSERT_DEV(!pEventBuffer->IsMainThread(), "Implementation error");
-    return static_cast<CpuScopesBuffer<BUFFER_SIZE_OTHER_THREAD>*>(pEventBuffer);
-  }
+    CpuScopesBuffer()
+    {
+      m_pScopes = m_Scopes;
+      m_uiCapacityMask = CAPACITY - 1;
+      m_pNames = m_Names;
+      m_uiNamesMask = NAMES_CAPACITY - 1;
+      m_pNameOffsets = m_NameOffsets;
+    }
+
+    ezProfilingSystem::CPUScope m_Scopes[CAPACITY];
+    ezUInt32 m_NameOffsets[CAPACITY];
+    char m_Names[NAMES_CAPACITY];
+  };
+
+  ezCVarBool cvar_ProfilingRecordCounters("Profiling.RecordCounters", true, ezCVarFlags::Default, "Record memory usage and the number of queued tasks as counter tracks once per frame.");
 
   ezCVarFloat cvar_ProfilingDiscardThresholdMS("Profiling.DiscardThresholdMS", 0.1f, ezCVarFlags::Default, "Discard profiling scopes if their duration is shorter than this in milliseconds.");
 
@@ -121,8 +378,9 @@ namespace
   static ezMutex s_ThreadInfosMutex;
 
 #  if EZ_ENABLED(EZ_PLATFORM_64BIT)
-  static_assert(sizeof(ezProfilingSystem::CPUScope) == 64);
+  static_assert(sizeof(ezProfilingSystem::CPUScope) == 32);
   static_assert(sizeof(ezProfilingSystem::GPUScope) == 64);
+  static_assert(sizeof(ezProfilingSystem::CounterSample) == 64);
 #  endif
 
   static thread_local CpuScopesBufferBase* s_CpuScopes = nullptr;
@@ -131,6 +389,301 @@ namespace
   static ezProfilingSystem::ScopeTimeoutDelegate s_ScopeTimeoutCallback;
 
   static ezDynamicArray<ezUniquePtr<GPUScopesBuffer>> s_GPUScopes;
+
+  static ezUniquePtr<CounterSamplesBuffer> s_pCounterSamples;
+  static ezMutex s_CounterSamplesMutex;
+  static ezUInt64 s_uiLastNumAllocations = 0;
+
+  static void RecordBuiltInCounters()
+  {
+    ezUInt64 uiAllocationSize = 0;
+    ezUInt64 uiNumAllocations = 0;
+
+    // child allocators allocate their memory from their parent, so only the root allocators have to be counted
+    for (auto it = ezMemoryTracker::GetIterator(); it.IsValid(); ++it)
+    {
+      if (it.ParentId().IsInvalidated())
+      {
+        uiAllocationSize += it.Stats().m_uiAllocationSize;
+        uiNumAllocations += it.Stats().m_uiNumAllocations;
+      }
+    }
+
+    ezProfilingSystem::AddCounterValue("Memory/Allocated [MB]", uiAllocationSize / (1024.0 * 1024.0));
+    ezProfilingSystem::AddCounterValue("Memory/Allocations per Frame", static_cast<double>(uiNumAllocations - ezMath::Min(s_uiLastNumAllocations, uiNumAllocations)));
+    s_uiLastNumAllocations = uiNumAllocations;
+
+    ezProfilingSystem::AddCounterValue("Tasks/Queued", ezTaskSystem::GetNumQueuedTasks());
+  }
+
+  ezCVarFloat cvar_ProfilingHitchThresholdMS("Profiling.HitchThresholdMS", 0.0f, ezCVarFlags::Default, "If a frame takes longer than this (in milliseconds), the last seconds of profiling data are written to ':appdata/Profiling'. Zero disables the hitch detection.");
+  ezCVarFloat cvar_ProfilingHitchCaptureSeconds("Profiling.HitchCaptureSeconds", 5.0f, ezCVarFlags::Default, "How many seconds of profiling data are written when a hitch is detected.");
+
+  static ezTime s_NextHitchCaptureTime;
+
+  class ezWriteHitchCaptureTask final : public ezTask
+  {
+  public:
+    ezProfilingSystem::ProfilingData m_Data;
+    ezString m_sPath;
+
+  private:
+    virtual void Execute() override
+    {
+      ezFileWriter file;
+      if (file.Open(m_sPath).Failed() || m_Data.Write(file).Failed())
+      {
+        ezLog::Error("Could not write hitch profiling capture to '{}'.", m_sPath);
+        return;
+      }
+
+      ezLog::Info("Hitch profiling capture saved to '{}'.", file.GetFilePathAbsolute().GetView());
+    }
+  };
+
+  template <typename T, typename Predicate>
+  static void RemoveProfilingDataIf(ezDynamicArray<T>& ref_data, Predicate pred)
+  {
+    ezUInt32 uiNumKept = 0;
+    for (ezUInt32 i = 0; i < ref_data.GetCount(); ++i)
+    {
+      if (!pred(ref_data[i]))
+      {
+        ref_data[uiNumKept] = ref_data[i];
+        ++uiNumKept;
+      }
+    }
+
+    ref_data.SetCountUninitialized(uiNumKept);
+  }
+
+  static void RemoveProfilingDataBefore(ezProfilingSystem::ProfilingData& ref_data, ezTime startTime)
+  {
+    for (auto& eventBuffer : ref_data.m_AllEventBuffers)
+    {
+      RemoveProfilingDataIf(eventBuffer.m_Data, [&](const ezProfilingSystem::CPUScope& scope)
+        { return scope.m_EndTime < startTime; });
+    }
+
+    RemoveProfilingDataIf(ref_data.m_FrameStartTimes, [&](ezTime frameStartTime)
+      { return frameStartTime < startTime; });
+
+    RemoveProfilingDataIf(ref_data.m_CounterSamples, [&](const ezProfilingSystem::CounterSample& sample)
+      { return sample.m_Time < startTime; });
+  }
+
+  static void SaveHitchCapture(ezTime frameDuration)
+  {
+    const ezTime captureDuration = ezTime::MakeFromSeconds(ezMath::Max(cvar_ProfilingHitchCaptureSeconds.GetValue(), 0.0f));
+    const ezTime now = ezTime::Now();
+
+    // don't write another capture for a hitch that is already contained in the previous one
+    s_NextHitchCaptureTime = now + captureDuration;
+
+    ezSharedPtr<ezWriteHitchCaptureTask> pTask = EZ_DEFAULT_NEW(ezWriteHitchCaptureTask);
+    ezProfilingSystem::Capture(pTask->m_Data);
+    RemoveProfilingDataBefore(pTask->m_Data, now - captureDuration);
+
+    ezStringBuilder sPath;
+    sPath.SetFormat(":appdata/Profiling/Hitch_Frame{}.json", ezProfilingSystem::GetFrameCount());
+    pTask->m_sPath = sPath;
+    pTask->ConfigureTask("Write Hitch Profiling Capture", ezTaskNesting::Never);
+
+    ezLog::Warning("Frame {} took {} ms, saving the last {} seconds of profiling data.", ezProfilingSystem::GetFrameCount(), ezArgF(frameDuration.GetMilliseconds(), 1), ezArgF(captureDuration.GetSeconds(), 1));
+
+    ezTaskSystem::StartSingleTask(pTask, ezTaskPriority::LongRunning);
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+
+  /// Appends everything that is written to it to a byte array, which the streaming thread writes to the file in one go.
+  class ezProfilingTraceBuffer : public ezStreamWriter
+  {
+  public:
+    virtual ezResult WriteBytes(const void* pWriteBuffer, ezUInt64 uiBytesToWrite) override
+    {
+      m_Data.PushBackRange(ezArrayPtr<const ezUInt8>(static_cast<const ezUInt8*>(pWriteBuffer), static_cast<ezUInt32>(uiBytesToWrite)));
+      return EZ_SUCCESS;
+    }
+
+    ezDynamicArray<ezUInt8> m_Data;
+  };
+
+  struct ezStreamedFrame
+  {
+    ezUInt64 m_uiFrame;
+    ezTime m_StartTime;
+  };
+
+  static std::atomic<bool> s_bStreaming = false;
+  static ezMutex s_StreamingMutex; // protects the data below, which is recorded by StartNewFrame() and AddCounterValue()
+  static ezDynamicArray<ezStreamedFrame> s_StreamedFrames;
+  static ezDynamicArray<ezProfilingSystem::CounterSample> s_StreamedCounterSamples;
+
+  class ezProfilingStreamThread : public ezThread
+  {
+  public:
+    ezProfilingStreamThread(const ezProfilingSystem::StreamingSettings& settings)
+      : ezThread("Profiling Stream")
+      , m_Settings(settings)
+    {
+    }
+
+    ezResult OpenNextFile()
+    {
+      m_File.Close();
+
+      ezStringBuilder sPath;
+      sPath.SetFormat("{}_{}.ezProfilingTrace", m_Settings.m_sOutputPath, m_uiNextFileIndex);
+      ++m_uiNextFileIndex;
+
+      if (m_File.Open(sPath, ezFileOpenMode::Write).Failed())
+      {
+        ezLog::Error("Could not open profiling trace '{}' for writing.", sPath);
+        return EZ_FAILURE;
+      }
+
+      m_WrittenFiles.PushBack(sPath);
+      if (m_Settings.m_uiMaxNumFiles > 0 && m_WrittenFiles.GetCount() > m_Settings.m_uiMaxNumFiles)
+      {
+        ezOSFile::DeleteFile(m_WrittenFiles.PeekFront()).IgnoreResult();
+        m_WrittenFiles.PopFront();
+      }
+
+      m_uiFileSize = 0;
+      m_FileStartTime = ezTime::Now();
+
+      // every file is a complete trace, names and thread infos are written again when they are first used
+#  if EZ_ENABLED(EZ_SUPPORTS_PROCESSES)
+      return m_TraceWriter.Begin(m_Buffer, ezProcess::GetCurrentProcessID());
+#  else
+      return m_TraceWriter.Begin(m_Buffer, 0);
+#  endif
+    }
+
+    void Stop()
+    {
+      m_bStop = true;
+      m_WakeUp.RaiseSignal();
+      Join();
+    }
+
+    /// Writes all scopes, frames and counter samples that were recorded since the last flush.
+    void Flush()
+    {
+      EZ_LOCK(m_FlushMutex);
+
+      if (!m_File.IsOpen())
+        return;
+
+      {
+        EZ_LOCK(s_ThreadInfosMutex);
+        for (const auto& threadInfo : s_ThreadInfos)
+        {
+          if (!m_TraceWriter.HasThreadInfo(threadInfo.m_uiThreadId))
+          {
+            m_TraceWriter.WriteThreadInfo(threadInfo).IgnoreResult();
+          }
+        }
+      }
+
+      ezUInt64 uiLostScopes = 0;
+
+      {
+        EZ_LOCK(s_AllCpuScopesMutex);
+        for (CpuScopesBufferBase* pEventBuffer : s_AllCpuScopes)
+        {
+          const ezUInt64 uiNumRecorded = pEventBuffer->m_uiNumRecorded.load(std::memory_order_acquire);
+          const ezUInt64 uiFirst = ezMath::Max(pEventBuffer->m_uiNumStreamed, pEventBuffer->GetFirstAvailable(uiNumRecorded));
+          uiLostScopes += uiFirst - pEventBuffer->m_uiNumStreamed;
+          pEventBuffer->m_uiNumStreamed = uiNumRecorded;
+
+          // The owning thread keeps recording while the scopes are copied, so the oldest ones may have been overwritten in the meantime.
+          m_Scopes.Clear();
+          m_Names.Clear();
+          uiLostScopes += pEventBuffer->CopyScopes(uiFirst, uiNumRecorded, m_Scopes, m_Names);
+
+          m_TraceWriter.WriteCPUScopes(pEventBuffer->m_uiThreadId, m_Scopes, m_Names).IgnoreResult();
+        }
+      }
+
+      {
+        EZ_LOCK(s_StreamingMutex);
+        m_Frames.Swap(s_StreamedFrames);
+        m_CounterSamples.Swap(s_StreamedCounterSamples);
+      }
+
+      for (const auto& frame : m_Frames)
+      {
+        m_TraceWriter.WriteFrame(frame.m_uiFrame, frame.m_StartTime).IgnoreResult();
+      }
+
+      for (const auto& sample : m_CounterSamples)
+      {
+        m_TraceWriter.WriteCounterSample(sample).IgnoreResult();
+      }
+
+      m_Frames.Clear();
+      m_CounterSamples.Clear();
+
+      if (uiLostScopes > 0)
+      {
+        // ends up in the next flush
+        ezProfilingSystem::AddCounterValue("Profiling/Lost Scopes", static_cast<double>(uiLostScopes));
+      }
+
+      if (!m_Buffer.m_Data.IsEmpty())
+      {
+        if (m_File.Write(m_Buffer.m_Data.GetData(), m_Buffer.m_Data.GetCount()).Failed())
+        {
+          ezLog::Error("Writing to profiling trace '{}' failed, streaming stops.", m_File.GetOpenFileName());
+          m_File.Close();
+        }
+
+        m_uiFileSize += m_Buffer.m_Data.GetCount();
+        m_Buffer.m_Data.Clear();
+      }
+
+      if (m_File.IsOpen() && (m_uiFileSize >= m_Settings.m_uiMaxFileSize || ezTime::Now() - m_FileStartTime >= m_Settings.m_MaxFileDuration))
+      {
+        OpenNextFile().IgnoreResult();
+      }
+    }
+
+  private:
+    virtual ezUInt32 Run() override
+    {
+      while (!m_bStop)
+      {
+        m_WakeUp.WaitForSignal(m_Settings.m_FlushInterval);
+        Flush();
+      }
+
+      m_File.Close();
+      return 0;
+    }
+
+    ezProfilingSystem::StreamingSettings m_Settings;
+    std::atomic<bool> m_bStop = false;
+    ezThreadSignal m_WakeUp;
+    ezMutex m_FlushMutex;
+
+    ezOSFile m_File;
+    ezUInt32 m_uiNextFileIndex = 0;
+    ezUInt64 m_uiFileSize = 0;
+    ezTime m_FileStartTime;
+    ezDeque<ezString> m_WrittenFiles;
+
+    ezProfilingTraceBuffer m_Buffer;
+    ezProfilingTraceWriter m_TraceWriter;
+
+    ezDynamicArray<ezProfilingSystem::CPUScope> m_Scopes;
+    ezDynamicArray<char> m_Names;
+    ezDynamicArray<ezStreamedFrame> m_Frames;
+    ezDynamicArray<ezProfilingSystem::CounterSample> m_CounterSamples;
+  };
+
+  static ezUniquePtr<ezProfilingStreamThread> s_pStreamThread;
 } // namespace
 
 void ezProfilingSystem::ProfilingData::Clear()
@@ -140,9 +693,11 @@ void ezProfilingSystem::ProfilingData::Clear()
   m_uiFrameCount = 0;
 
   m_AllEventBuffers.Clear();
+  m_NameStorage.Clear();
   m_FrameStartTimes.Clear();
   m_GPUScopes.Clear();
   m_ThreadInfos.Clear();
+  m_CounterSamples.Clear();
 }
 
 void ezProfilingSystem::ProfilingData::Merge(ProfilingData& out_merged, ezArrayPtr<const ProfilingData*> inputs)
@@ -155,10 +710,11 @@ void ezProfilingSystem::ProfilingData::Merge(ProfilingData& out_merged, ezArrayP
   out_merged.m_uiProcessID = inputs[0]->m_uiProcessID;
   out_merged.m_uiFramesThreadID = inputs[0]->m_uiFramesThreadID;
 
-  // concatenate m_FrameStartTimes and m_GPUScopes and m_uiFrameCount
+  // concatenate m_FrameStartTimes, m_GPUScopes, m_CounterSamples and m_uiFrameCount
   {
     ezUInt32 uiNumFrameStartTimes = 0;
     ezUInt32 uiNumGpuScopes = 0;
+    ezUInt32 uiNumCounterSamples = 0;
 
     for (const auto& pd : inputs)
     {
@@ -166,15 +722,18 @@ void ezProfilingSystem::ProfilingData::Merge(ProfilingData& out_merged, ezArrayP
 
       uiNumFrameStartTimes += pd->m_FrameStartTimes.GetCount();
       uiNumGpuScopes += pd->m_GPUScopes.GetCount();
+      uiNumCounterSamples += pd->m_CounterSamples.GetCount();
     }
 
     out_merged.m_FrameStartTimes.Reserve(uiNumFrameStartTimes);
     out_merged.m_GPUScopes.Reserve(uiNumGpuScopes);
+    out_merged.m_CounterSamples.Reserve(uiNumCounterSamples);
 
     for (const auto& pd : inputs)
     {
       out_merged.m_FrameStartTimes.PushBackRange(pd->m_FrameStartTimes);
       out_merged.m_GPUScopes.PushBackRange(pd->m_GPUScopes);
+      out_merged.m_CounterSamples.PushBackRange(pd->m_CounterSamples);
     }
   }
 
@@ -247,6 +806,12 @@ void ezProfilingSystem::ProfilingData::Merge(ProfilingData& out_merged, ezArrayP
         out_merged.m_AllEventBuffers[ebInfo.m_uiIndex].m_Data.PushBackRange(eb.m_Data);
       }
     }
+
+    // the merged scopes still point to the copied names of the inputs
+    for (const auto& pd : inputs)
+    {
+      out_merged.m_NameStorage.PushBackRange(pd->m_NameStorage);
+    }
   }
 }
 
@@ -426,7 +991,7 @@ ezResult ezProfilingSystem::ProfilingData::Write(ezStreamWriter& ref_outputStrea
       for (const CPUScope& e : sortedScopes)
       {
         writer.BeginObject();
-        writer.AddVariableString("name", static_cast<const char*>(e.m_szName));
+        writer.AddVariableString("name", e.m_szName);
         writer.AddVariableUInt32("pid", m_uiProcessID);
         writer.AddVariableUInt64("tid", uiThreadId);
         writer.AddVariableUInt64("ts", static_cast<ezUInt64>(e.m_BeginTime.GetMicroseconds()));
@@ -444,7 +1009,7 @@ ezResult ezProfilingSystem::ProfilingData::Write(ezStreamWriter& ref_outputStrea
         if (e.m_EndTime.IsPositive())
         {
           writer.BeginObject();
-          writer.AddVariableString("name", static_cast<const char*>(e.m_szName));
+          writer.AddVariableString("name", e.m_szName);
           writer.AddVariableUInt32("pid", m_uiProcessID);
           writer.AddVariableUInt64("tid", uiThreadId);
           writer.AddVariableUInt64("ts", static_cast<ezUInt64>(e.m_EndTime.GetMicroseconds()));
@@ -494,6 +1059,29 @@ ezResult ezProfilingSystem::ProfilingData::Write(ezStreamWriter& ref_outputStrea
       }
     }
 
+    // counter tracks
+    {
+      for (const CounterSample& sample : m_CounterSamples)
+      {
+        writer.BeginObject();
+        writer.AddVariableString("name", sample.GetName());
+        writer.AddVariableUInt32("pid", m_uiProcessID);
+        writer.AddVariableUInt64("ts", static_cast<ezUInt64>(sample.m_Time.GetMicroseconds()));
+        writer.AddVariableString("ph", "C");
+
+        writer.BeginObject("args");
+        writer.AddVariableDouble("value", sample.m_fValue);
+        writer.EndObject();
+
+        writer.EndObject();
+
+        if (writer.HadWriteError())
+        {
+          return EZ_FAILURE;
+        }
+      }
+    }
+
     // GPU data
     // Since there are no actual threads, we assign 1..gpuCount as the respective threadID
     {
@@ -547,14 +1135,7 @@ void ezProfilingSystem::Clear()
     EZ_LOCK(s_AllCpuScopesMutex);
     for (auto pEventBuffer : s_AllCpuScopes)
     {
-      if (pEventBuffer->IsMainThread())
-      {
-        CastToMainThreadEventBuffer(pEventBuffer)->m_Data.Clear();
-      }
-      else
-      {
-        CastToOtherThreadEventBuffer(pEventBuffer)->m_Data.Clear();
-      }
+      pEventBuffer->m_uiFirstValid = pEventBuffer->m_uiNumRecorded.load(std::memory_order_acquire);
     }
   }
 
@@ -567,6 +1148,14 @@ void ezProfilingSystem::Clear()
       gpuScopes->Clear();
     }
   }
+
+  {
+    EZ_LOCK(s_CounterSamplesMutex);
+    if (s_pCounterSamples != nullptr)
+    {
+      s_pCounterSamples->Clear();
+    }
+  }
 }
 
 // static
@@ -605,17 +1194,16 @@ void ezProfilingSystem::Capture(ezProfilingSystem::ProfilingData& ref_profilingD
 
       targetEventBuffer.m_uiThreadId = sourceEventBuffer->m_uiThreadId;
 
-      ezUInt32 uiSourceCount = sourceEventBuffer->IsMainThread() ? CastToMainThreadEventBuffer(sourceEventBuffer)->m_Data.GetCount() : CastToOtherThreadEventBuffer(sourceEventBuffer)->m_Data.GetCount();
-      targetEventBuffer.m_Data.SetCountUninitialized(uiSourceCount);
-      for (ezUInt32 j = 0; j < uiSourceCount; ++j)
-      {
-        const CPUScope& sourceEvent = sourceEventBuffer->IsMainThread() ? CastToMainThreadEventBuffer(sourceEventBuffer)->m_Data[j] : CastToOtherThreadEventBuffer(sourceEventBuffer)->m_Data[j];
+      const ezUInt64 uiNumRecorded = sourceEventBuffer->m_uiNumRecorded.load(std::memory_order_acquire);
+      const ezUInt64 uiFirst = ezMath::Max(sourceEventBuffer->m_uiFirstValid, sourceEventBuffer->GetFirstAvailable(uiNumRecorded));
 
-        CPUScope& copiedEvent = targetEventBuffer.m_Data[j];
-        copiedEvent.m_szFunctionName = sourceEvent.m_szFunctionName;
-        copiedEvent.m_BeginTime = sourceEvent.m_BeginTime;
-        copiedEvent.m_EndTime = sourceEvent.m_EndTime;
-        ezStringUtils::Copy(copiedEvent.m_szName, CPUScope::NAME_SIZE, sourceEvent.m_szName);
+      // each thread gets its own name storage, since the scopes point into it and it must not grow anymore afterwards
+      ezSharedPtr<NameStorage> pNames = EZ_DEFAULT_NEW(NameStorage);
+      sourceEventBuffer->CopyScopes(uiFirst, uiNumRecorded, targetEventBuffer.m_Data, pNames->m_Data);
+
+      if (!pNames->m_Data.IsEmpty())
+      {
+        ref_profilingData.m_NameStorage.PushBack(pNames);
       }
     }
   }
@@ -649,6 +1237,19 @@ void ezProfilingSystem::Capture(ezProfilingSystem::ProfilingData& ref_profilingD
     }
   }
 
+  {
+    EZ_LOCK(s_CounterSamplesMutex);
+
+    if (s_pCounterSamples != nullptr)
+    {
+      ref_profilingData.m_CounterSamples.SetCountUninitialized(s_pCounterSamples->GetCount());
+      for (ezUInt32 i = 0; i < s_pCounterSamples->GetCount(); ++i)
+      {
+        ref_profilingData.m_CounterSamples[i] = (*s_pCounterSamples)[i];
+      }
+    }
+  }
+
   if (bClearAfterCapture)
   {
     Clear();
@@ -677,18 +1278,137 @@ void ezProfilingSystem::StartNewFrame()
 {
   ++s_uiFrameCount;
 
+  const ezTime now = ezTime::Now();
+
+  if (cvar_ProfilingHitchThresholdMS > 0.0f && !s_FrameStartTimes.IsEmpty() && now >= s_NextHitchCaptureTime)
+  {
+    const ezTime frameDuration = now - s_FrameStartTimes.PeekBack();
+    if (frameDuration > ezTime::MakeFromMilliseconds(cvar_ProfilingHitchThresholdMS))
+    {
+      SaveHitchCapture(frameDuration);
+    }
+  }
+
   if (!s_FrameStartTimes.CanAppend())
   {
     s_FrameStartTimes.PopFront();
   }
 
-  s_FrameStartTimes.PushBack(ezTime::Now());
+  s_FrameStartTimes.PushBack(now);
+
+  if (s_bStreaming)
+  {
+    EZ_LOCK(s_StreamingMutex);
+    s_StreamedFrames.PushBack({s_uiFrameCount, now});
+  }
+
+  if (cvar_ProfilingRecordCounters)
+  {
+    RecordBuiltInCounters();
+  }
 
   EZ_PROFILER_FRAME_MARKER();
 }
 
 // static
-void ezProfilingSystem::AddCPUScope(ezStringView sName, const char* szFunctionName, ezTime beginTime, ezTime endTime, ezTime scopeTimeout)
+void ezProfilingSystem::AddCounterValue(ezStringView sName, double fValue, bool bInternName)
+{
+  CounterSample sample;
+  sample.m_szName = nullptr;
+  sample.m_szCopiedName[0] = '\0';
+
+  if (bInternName)
+  {
+    sample.m_szName = InternName(sName);
+  }
+  else
+  {
+    ezStringUtils::Copy(sample.m_szCopiedName, CounterSample::NAME_SIZE, sName.GetStartPointer(), sName.GetEndPointer());
+  }
+
+  sample.m_Time = ezTime::Now();
+  sample.m_fValue = fValue;
+
+  EZ_LOCK(s_CounterSamplesMutex);
+
+  if (s_pCounterSamples == nullptr)
+  {
+    s_pCounterSamples = EZ_DEFAULT_NEW(CounterSamplesBuffer);
+  }
+
+  if (!s_pCounterSamples->CanAppend())
+  {
+    s_pCounterSamples->PopFront();
+  }
+
+  s_pCounterSamples->PushBack(sample);
+
+  if (s_bStreaming)
+  {
+    EZ_LOCK(s_StreamingMutex);
+    s_StreamedCounterSamples.PushBack(sample);
+  }
+}
+
+// static
+ezResult ezProfilingSystem::StartStreaming(const StreamingSettings& settings)
+{
+  EZ_ASSERT_DEV(!settings.m_sOutputPath.IsEmpty(), "No output path for the profiling trace given.");
+
+  StopStreaming();
+
+  ezUniquePtr<ezProfilingStreamThread> pThread = EZ_DEFAULT_NEW(ezProfilingStreamThread, settings);
+  EZ_SUCCEED_OR_RETURN(pThread->OpenNextFile());
+
+  {
+    // only stream what gets recorded from now on
+    EZ_LOCK(s_AllCpuScopesMutex);
+    for (CpuScopesBufferBase* pEventBuffer : s_AllCpuScopes)
+    {
+      pEventBuffer->m_uiNumStreamed = pEventBuffer->m_uiNumRecorded.load(std::memory_order_acquire);
+    }
+  }
+
+  {
+    EZ_LOCK(s_StreamingMutex);
+    s_StreamedFrames.Clear();
+    s_StreamedCounterSamples.Clear();
+    s_bStreaming = true;
+  }
+
+  s_pStreamThread = std::move(pThread);
+  s_pStreamThread->Start();
+
+  return EZ_SUCCESS;
+}
+
+// static
+void ezProfilingSystem::StopStreaming()
+{
+  if (s_pStreamThread == nullptr)
+    return;
+
+  s_bStreaming = false;
+
+  // the thread flushes everything before it exits
+  s_pStreamThread->Stop();
+  s_pStreamThread.Clear();
+
+  EZ_LOCK(s_StreamingMutex);
+  s_StreamedFrames.Clear();
+  s_StreamedFrames.Compact();
+  s_StreamedCounterSamples.Clear();
+  s_StreamedCounterSamples.Compact();
+}
+
+// static
+bool ezProfilingSystem::IsStreaming()
+{
+  return s_bStreaming;
+}
+
+// static
+void ezProfilingSystem::AddCPUScope(ezStringView sName, const char* szFunctionName, ezTime beginTime, ezTime endTime, ezTime scopeTimeout, bool bInternName)
 {
   const ezTime duration = endTime - beginTime;
 
@@ -722,28 +1442,11 @@ void ezProfilingSystem::AddCPUScope(ezStringView sName, const char* szFunctionNa
   scope.m_szFunctionName = szFunctionName;
   scope.m_BeginTime = beginTime;
   scope.m_EndTime = endTime;
-  ezStringUtils::Copy(scope.m_szName, EZ_ARRAY_SIZE(scope.m_szName), sName.GetStartPointer(), sName.GetEndPointer());
-
-  if (ezThreadUtils::IsMainThread())
-  {
-    auto pMainThreadBuffer = CastToMainThreadEventBuffer(pScopes);
-    if (!pMainThreadBuffer->m_Data.CanAppend())
-    {
-      pMainThreadBuffer->m_Data.PopFront();
-    }
 
-    pMainThreadBuffer->m_Data.PushBack(scope);
-  }
-  else
-  {
-    auto pOtherThreadBuffer = CastToOtherThreadEventBuffer(pScopes);
-    if (!pOtherThreadBuffer->m_Data.CanAppend())
-    {
-      pOtherThreadBuffer->m_Data.PopFront();
-    }
+  ezUInt32 uiNameOffset = 0;
+  scope.m_szName = bInternName ? InternName(sName) : pScopes->RecordName(sName, uiNameOffset);
 
-    pOtherThreadBuffer->m_Data.PushBack(scope);
-  }
+  pScopes->Record(scope, uiNameOffset);
 
   if (scopeTimeout.IsPositive() && duration > scopeTimeout && s_ScopeTimeoutCallback.IsValid())
   {
@@ -755,13 +1458,17 @@ void ezProfilingSystem::AddCPUScope(ezStringView sName, const char* szFunctionNa
 void ezProfilingSystem::Initialize()
 {
   SetThreadName("Main Thread");
-
-  s_MainThreadId = (ezUInt64)ezThreadUtils::GetCurrentThreadID();
 }
 
 // static
 void ezProfilingSystem::Reset()
 {
+  if (s_pStreamThread != nullptr)
+  {
+    // the buffers of dead threads are deleted below, so whatever they still contain has to be written first
+    s_pStreamThread->Flush();
+  }
+
   EZ_LOCK(s_ThreadInfosMutex);
   EZ_LOCK(s_AllCpuScopesMutex);
   for (ezUInt32 i = 0; i < s_DeadThreadIDs.GetCount(); i++)
@@ -848,17 +1555,18 @@ void ezProfilingSystem::AddGPUScope(ezStringView sName, ezTime beginTime, ezTime
 
 //////////////////////////////////////////////////////////////////////////
 
-ezProfilingScope::ezProfilingScope(ezStringView sName, const char* szFunctionName, ezTime timeout)
+ezProfilingScope::ezProfilingScope(ezStringView sName, const char* szFunctionName, ezTime timeout, bool bInternName)
   : m_sName(sName)
   , m_szFunction(szFunctionName)
   , m_BeginTime(ezTime::Now())
   , m_Timeout(timeout)
+  , m_bInternName(bInternName)
 {
 }
 
 ezProfilingScope::~ezProfilingScope()
 {
-  ezProfilingSystem::AddCPUScope(m_sName, m_szFunction, m_BeginTime, ezTime::Now(), m_Timeout);
+  ezProfilingSystem::AddCPUScope(m_sName, m_szFunction, m_BeginTime, ezTime::Now(), m_Timeout, m_bInternName);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -921,9 +1629,31 @@ void ezProfilingSystem::SetDiscardThreshold(ezTime threshold)
 
 void ezProfilingSystem::StartNewFrame() {}
 
-void ezProfilingSystem::AddCPUScope(ezStringView sName, const char* szFunctionName, ezTime beginTime, ezTime endTime, ezTime scopeTimeout)
+void ezProfilingSystem::AddCounterValue(ezStringView sName, double fValue, bool bInternName)
+{
+  EZ_IGNORE_UNUSED(sName);
+  EZ_IGNORE_UNUSED(fValue);
+  EZ_IGNORE_UNUSED(bInternName);
+}
+
+ezResult ezProfilingSystem::StartStreaming(const StreamingSettings& settings)
+{
+  EZ_IGNORE_UNUSED(settings);
+
+  return EZ_FAILURE;
+}
+
+void ezProfilingSystem::StopStreaming() {}
+
+bool ezProfilingSystem::IsStreaming()
+{
+  return false;
+}
+
+void ezProfilingSystem::AddCPUScope(ezStringView sName, const char* szFunctionName, ezTime beginTime, ezTime endTime, ezTime scopeTimeout, bool bInternName)
 {
   EZ_IGNORE_UNUSED(sName);
+  EZ_IGNORE_UNUSED(bInternName);
   EZ_IGNORE_UNUSED(szFunctionName);
   EZ_IGNORE_UNUSED(beginTime);
   EZ_IGNORE_UNUSED(endTime);
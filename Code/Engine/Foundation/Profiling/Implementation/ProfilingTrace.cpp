@@ -0,0 +1,343 @@
+#include <Foundation/FoundationPCH.h>
+
+#include <Foundation/IO/Stream.h>
+#include <Foundation/Logging/Log.h>
+#include <Foundation/Profiling/ProfilingTrace.h>
+
+namespace
+{
+  static constexpr ezUInt32 s_uiTraceMagic = 0x54505A45; // 'EZPT'
+  static constexpr ezUInt8 s_uiTraceVersion = 1;
+
+  struct ezProfilingTraceRecord
+  {
+    enum Enum : ezUInt8
+    {
+      Name = 1,
+      Thread = 2,
+      CPUScopes = 3,
+      Frame = 4,
+      CounterSample = 5,
+    };
+  };
+} // namespace
+
+ezResult ezProfilingTraceWriter::Begin(ezStreamWriter& inout_stream, ezOsProcessID uiProcessID)
+{
+  m_pStream = &inout_stream;
+  m_uiNumNames = 0;
+  m_NameIndices.Clear();
+  m_CopiedNameIndices.Clear();
+  m_WrittenThreads.Clear();
+
+  inout_stream << s_uiTraceMagic;
+  inout_stream << s_uiTraceVersion;
+  inout_stream << static_cast<ezUInt32>(uiProcessID);
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezProfilingTraceWriter::WriteName(const char* szName, ezUInt32& out_uiNameIndex)
+{
+  if (szName == nullptr)
+  {
+    out_uiNameIndex = ezInvalidIndex;
+    return EZ_SUCCESS;
+  }
+
+  if (m_NameIndices.TryGetValue(szName, out_uiNameIndex))
+    return EZ_SUCCESS;
+
+  out_uiNameIndex = m_uiNumNames++;
+  m_NameIndices.Insert(szName, out_uiNameIndex);
+
+  return WriteNameRecord(out_uiNameIndex, szName);
+}
+
+ezResult ezProfilingTraceWriter::WriteCopiedName(const char* szName, ezUInt32& out_uiNameIndex)
+{
+  if (m_CopiedNameIndices.TryGetValue(szName, out_uiNameIndex))
+    return EZ_SUCCESS;
+
+  out_uiNameIndex = m_uiNumNames++;
+  m_CopiedNameIndices.Insert(szName, out_uiNameIndex);
+
+  return WriteNameRecord(out_uiNameIndex, szName);
+}
+
+ezResult ezProfilingTraceWriter::WriteNameRecord(ezUInt32 uiNameIndex, const char* szName)
+{
+  ezStreamWriter& stream = *m_pStream;
+  stream << static_cast<ezUInt8>(ezProfilingTraceRecord::Name);
+  stream << uiNameIndex;
+  return stream.WriteString(szName);
+}
+
+ezResult ezProfilingTraceWriter::WriteThreadInfo(const ezProfilingSystem::ThreadInfo& threadInfo)
+{
+  // the thread name is not interned, but it is only written once anyway
+  ezStreamWriter& stream = *m_pStream;
+  stream << static_cast<ezUInt8>(ezProfilingTraceRecord::Thread);
+  stream << threadInfo.m_uiThreadId;
+  EZ_SUCCEED_OR_RETURN(stream.WriteString(threadInfo.m_sName));
+
+  m_WrittenThreads.Insert(threadInfo.m_uiThreadId);
+  return EZ_SUCCESS;
+}
+
+ezResult ezProfilingTraceWriter::WriteCPUScopes(ezUInt64 uiThreadId, ezArrayPtr<const ezProfilingSystem::CPUScope> scopes, ezArrayPtr<const char> copiedNames)
+{
+  if (scopes.IsEmpty())
+    return EZ_SUCCESS;
+
+  // all names have to be known before the block of scopes starts
+  m_ScopeNameIndices.SetCountUninitialized(scopes.GetCount() * 2);
+  for (ezUInt32 i = 0; i < scopes.GetCount(); ++i)
+  {
+    const auto& scope = scopes[i];
+
+    if (scope.m_szName >= copiedNames.GetPtr() && scope.m_szName < copiedNames.GetEndPtr())
+    {
+      EZ_SUCCEED_OR_RETURN(WriteCopiedName(scope.m_szName, m_ScopeNameIndices[i * 2]));
+    }
+    else
+    {
+      EZ_SUCCEED_OR_RETURN(WriteName(scope.m_szName, m_ScopeNameIndices[i * 2]));
+    }
+
+    EZ_SUCCEED_OR_RETURN(WriteName(scope.m_szFunctionName, m_ScopeNameIndices[i * 2 + 1]));
+  }
+
+  ezStreamWriter& stream = *m_pStream;
+  stream << static_cast<ezUInt8>(ezProfilingTraceRecord::CPUScopes);
+  stream << uiThreadId;
+  stream << scopes.GetCount();
+
+  for (ezUInt32 i = 0; i < scopes.GetCount(); ++i)
+  {
+    const auto& scope = scopes[i];
+    stream << m_ScopeNameIndices[i * 2];
+    stream << m_ScopeNameIndices[i * 2 + 1];
+    stream << static_cast<ezInt64>(scope.m_BeginTime.GetNanoseconds());
+    stream << static_cast<ezInt64>(scope.m_EndTime.GetNanoseconds());
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezProfilingTraceWriter::WriteFrame(ezUInt64 uiFrame, ezTime startTime)
+{
+  ezStreamWriter& stream = *m_pStream;
+  stream << static_cast<ezUInt8>(ezProfilingTraceRecord::Frame);
+  stream << uiFrame;
+  stream << static_cast<ezInt64>(startTime.GetNanoseconds());
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezProfilingTraceWriter::WriteCounterSample(const ezProfilingSystem::CounterSample& sample)
+{
+  ezUInt32 uiNameIndex;
+  if (sample.m_szName != nullptr)
+  {
+    EZ_SUCCEED_OR_RETURN(WriteName(sample.m_szName, uiNameIndex));
+  }
+  else
+  {
+    EZ_SUCCEED_OR_RETURN(WriteCopiedName(sample.m_szCopiedName, uiNameIndex));
+  }
+
+  ezStreamWriter& stream = *m_pStream;
+  stream << static_cast<ezUInt8>(ezProfilingTraceRecord::CounterSample);
+  stream << uiNameIndex;
+  stream << static_cast<ezInt64>(sample.m_Time.GetNanoseconds());
+  stream << sample.m_fValue;
+
+  return EZ_SUCCESS;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+  template <typename T>
+  EZ_ALWAYS_INLINE bool ReadValue(ezStreamReader& inout_stream, T& out_value)
+  {
+    return inout_stream.ReadBytes(&out_value, sizeof(T)) == sizeof(T);
+  }
+
+  ezTime FromNanoseconds(ezInt64 iNanoseconds)
+  {
+    return ezTime::MakeFromNanoseconds(static_cast<double>(iNanoseconds));
+  }
+} // namespace
+
+ezResult ezProfilingTraceReader::Read(ezStreamReader& inout_stream, ezProfilingSystem::ProfilingData& out_data)
+{
+  ezUInt32 uiMagic = 0;
+  ezUInt8 uiVersion = 0;
+  ezUInt32 uiProcessID = 0;
+
+  if (!ReadValue(inout_stream, uiMagic) || uiMagic != s_uiTraceMagic)
+  {
+    ezLog::Error("Not a profiling trace.");
+    return EZ_FAILURE;
+  }
+
+  if (!ReadValue(inout_stream, uiVersion) || uiVersion > s_uiTraceVersion)
+  {
+    ezLog::Error("Unsupported profiling trace version {}.", uiVersion);
+    return EZ_FAILURE;
+  }
+
+  ReadValue(inout_stream, uiProcessID);
+  out_data.m_uiProcessID = uiProcessID;
+
+  ezDynamicArray<const char*> names;
+  ezStringBuilder sName;
+
+  auto GetName = [&](ezUInt32 uiIndex) -> const char*
+  { return uiIndex < names.GetCount() ? names[uiIndex] : nullptr; };
+
+  auto GetEventBuffer = [&](ezUInt64 uiThreadId) -> ezProfilingSystem::CPUScopesBufferFlat&
+  {
+    for (auto& eventBuffer : out_data.m_AllEventBuffers)
+    {
+      if (eventBuffer.m_uiThreadId == uiThreadId)
+        return eventBuffer;
+    }
+
+    auto& eventBuffer = out_data.m_AllEventBuffers.ExpandAndGetRef();
+    eventBuffer.m_uiThreadId = uiThreadId;
+    return eventBuffer;
+  };
+
+  while (true)
+  {
+    ezUInt8 uiRecord = 0;
+    if (!ReadValue(inout_stream, uiRecord))
+      break;
+
+    bool bComplete = false;
+
+    switch (uiRecord)
+    {
+      case ezProfilingTraceRecord::Name:
+      {
+        ezUInt32 uiIndex = 0;
+        if (!ReadValue(inout_stream, uiIndex) || inout_stream.ReadString(sName).Failed())
+          break;
+
+        names.EnsureCount(uiIndex + 1);
+        names[uiIndex] = ezProfilingSystem::InternName(sName);
+        bComplete = true;
+      }
+      break;
+
+      case ezProfilingTraceRecord::Thread:
+      {
+        ezProfilingSystem::ThreadInfo info;
+        if (!ReadValue(inout_stream, info.m_uiThreadId) || inout_stream.ReadString(sName).Failed())
+          break;
+
+        info.m_sName = sName;
+
+        bool bKnown = false;
+        for (const auto& knownInfo : out_data.m_ThreadInfos)
+        {
+          bKnown |= knownInfo.m_uiThreadId == info.m_uiThreadId;
+        }
+
+        if (!bKnown)
+        {
+          out_data.m_ThreadInfos.PushBack(info);
+        }
+
+        bComplete = true;
+      }
+      break;
+
+      case ezProfilingTraceRecord::CPUScopes:
+      {
+        ezUInt64 uiThreadId = 0;
+        ezUInt32 uiCount = 0;
+        if (!ReadValue(inout_stream, uiThreadId) || !ReadValue(inout_stream, uiCount))
+          break;
+
+        auto& eventBuffer = GetEventBuffer(uiThreadId);
+
+        ezUInt32 i = 0;
+        for (; i < uiCount; ++i)
+        {
+          ezUInt32 uiNameIndex, uiFunctionIndex;
+          ezInt64 iBegin, iEnd;
+          if (!ReadValue(inout_stream, uiNameIndex) || !ReadValue(inout_stream, uiFunctionIndex) || !ReadValue(inout_stream, iBegin) || !ReadValue(inout_stream, iEnd))
+            break;
+
+          auto& scope = eventBuffer.m_Data.ExpandAndGetRef();
+          scope.m_szName = GetName(uiNameIndex);
+          scope.m_szFunctionName = GetName(uiFunctionIndex);
+          scope.m_BeginTime = FromNanoseconds(iBegin);
+          scope.m_EndTime = FromNanoseconds(iEnd);
+
+          if (scope.m_szName == nullptr)
+          {
+            scope.m_szName = "<unknown>";
+          }
+        }
+
+        bComplete = (i == uiCount);
+      }
+      break;
+
+      case ezProfilingTraceRecord::Frame:
+      {
+        ezUInt64 uiFrame = 0;
+        ezInt64 iTime = 0;
+        if (!ReadValue(inout_stream, uiFrame) || !ReadValue(inout_stream, iTime))
+          break;
+
+        out_data.m_FrameStartTimes.PushBack(FromNanoseconds(iTime));
+        out_data.m_uiFrameCount = ezMath::Max(out_data.m_uiFrameCount, uiFrame);
+        bComplete = true;
+      }
+      break;
+
+      case ezProfilingTraceRecord::CounterSample:
+      {
+        ezUInt32 uiNameIndex = 0;
+        ezInt64 iTime = 0;
+        double fValue = 0.0;
+        if (!ReadValue(inout_stream, uiNameIndex) || !ReadValue(inout_stream, iTime) || !ReadValue(inout_stream, fValue))
+          break;
+
+        auto& sample = out_data.m_CounterSamples.ExpandAndGetRef();
+        sample.m_szName = GetName(uiNameIndex);
+        sample.m_Time = FromNanoseconds(iTime);
+        sample.m_fValue = fValue;
+
+        if (sample.m_szName == nullptr)
+        {
+          sample.m_szName = "<unknown>";
+        }
+
+        bComplete = true;
+      }
+      break;
+
+      default:
+        ezLog::Error("Unknown record type {} in profiling trace.", uiRecord);
+        return EZ_FAILURE;
+    }
+
+    if (!bComplete)
+    {
+      ezLog::Warning("Profiling trace ends with an incomplete record.");
+      break;
+    }
+  }
+
+  return EZ_SUCCESS;
+}
+
+EZ_STATICLINK_FILE(Foundation, Foundation_Profiling_Implementation_ProfilingTrace);
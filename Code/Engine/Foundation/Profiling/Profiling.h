@@ -5,6 +5,7 @@
 #include <Foundation/Containers/StaticRingBuffer.h>
 #include <Foundation/System/Process.h>
 #include <Foundation/Time/Time.h>
+#include <Foundation/Types/SharedPtr.h>
 
 class ezStreamWriter;
 class ezThread;
@@ -13,10 +14,26 @@ class ezThread;
 ///
 /// The constructor creates a new scope in the profiling system and the destructor pops the scope.
 /// You shouldn't need to use this directly, just use the macro EZ_PROFILE_SCOPE provided below.
+///
+/// Names that are string literals are interned through ezProfilingSystem::InternName(), so that the scope only needs to store a pointer.
+/// All other names may be formatted at runtime (e.g. "Frame 123"), so they are copied into a bounded per-thread buffer instead.
 class EZ_FOUNDATION_DLL ezProfilingScope
 {
 public:
-  ezProfilingScope(ezStringView sName, const char* szFunctionName, ezTime timeout);
+  template <size_t N>
+  ezProfilingScope(const char (&szName)[N], const char* szFunctionName, ezTime timeout)
+    : ezProfilingScope(ezStringView(szName), szFunctionName, timeout, true)
+  {
+  }
+
+  /// \brief A char array that is not const is usually a buffer that gets formatted at runtime, so its content is copied.
+  template <size_t N>
+  ezProfilingScope(char (&szName)[N], const char* szFunctionName, ezTime timeout)
+    : ezProfilingScope(ezStringView(szName), szFunctionName, timeout, false)
+  {
+  }
+
+  ezProfilingScope(ezStringView sName, const char* szFunctionName, ezTime timeout, bool bInternName = false);
   ~ezProfilingScope();
 
 protected:
@@ -24,6 +41,7 @@ protected:
   const char* m_szFunction;
   ezTime m_BeginTime;
   ezTime m_Timeout;
+  bool m_bInternName;
 };
 
 /// \brief This class implements a profiling scope similar to ezProfilingScope, but with additional sub-scopes which can be added easily without
@@ -69,12 +87,10 @@ public:
   {
     EZ_DECLARE_POD_TYPE();
 
-    static constexpr ezUInt32 NAME_SIZE = 40;
-
     const char* m_szFunctionName;
+    const char* m_szName; ///< Either interned through InternName() or a copy that is owned by the buffer that holds the scope.
     ezTime m_BeginTime;
     ezTime m_EndTime;
-    char m_szName[NAME_SIZE];
   };
 
   struct CPUScopesBufferFlat
@@ -95,6 +111,28 @@ public:
     char m_szName[NAME_SIZE];
   };
 
+  /// \brief One value of a counter track, see AddCounterValue().
+  struct CounterSample
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    static constexpr ezUInt32 NAME_SIZE = 40;
+
+    /// \brief Returns the name of the counter track, regardless of whether it was interned or copied.
+    const char* GetName() const { return m_szName != nullptr ? m_szName : m_szCopiedName; }
+
+    const char* m_szName; ///< Interned through InternName(), nullptr if the name is stored in m_szCopiedName
+    ezTime m_Time;
+    double m_fValue;
+    char m_szCopiedName[NAME_SIZE]; ///< Names that are not string literals are copied here, truncated to NAME_SIZE - 1 bytes
+  };
+
+  /// \brief Holds the copies of scope names that were not interned, see ezProfilingScope.
+  struct NameStorage : public ezRefCounted
+  {
+    ezDynamicArray<char> m_Data;
+  };
+
   struct EZ_FOUNDATION_DLL ProfilingData
   {
     ezUInt32 m_uiFramesThreadID = 0;
@@ -105,11 +143,16 @@ public:
 
     ezDynamicArray<CPUScopesBufferFlat> m_AllEventBuffers;
 
+    /// \brief Keeps the names alive that the scopes in m_AllEventBuffers reference, but that are not interned. Shared with merged data.
+    ezHybridArray<ezSharedPtr<NameStorage>, 1> m_NameStorage;
+
     ezUInt64 m_uiFrameCount = 0;
     ezDynamicArray<ezTime> m_FrameStartTimes;
 
     ezDynamicArray<ezDynamicArray<GPUScope>> m_GPUScopes;
 
+    ezDynamicArray<CounterSample> m_CounterSamples;
+
     /// \brief Writes profiling data as JSON to the output stream.
     ezResult Write(ezStreamWriter& ref_outputStream) const;
 
@@ -133,14 +176,79 @@ public:
   static void SetScopeTimeoutCallback(ScopeTimeoutDelegate callback);
 
   /// \brief Should be called once per frame to capture the timestamp of the new frame.
+  ///
+  /// If the CVar 'Profiling.HitchThresholdMS' is set and the previous frame took longer than that, the last
+  /// 'Profiling.HitchCaptureSeconds' seconds of profiling data are written to ':appdata/Profiling/Hitch_Frame<N>.json'.
   static void StartNewFrame();
 
   /// \brief Adds a new scoped event for the calling thread in the profiling system
-  static void AddCPUScope(ezStringView sName, const char* szFunctionName, ezTime beginTime, ezTime endTime, ezTime scopeTimeout);
+  ///
+  /// Only pass \a bInternName = true for names that are stable, e.g. string literals, see InternName().
+  /// Other names are copied (and truncated to 63 bytes) into a per-thread ring buffer, which doesn't take any lock.
+  static void AddCPUScope(ezStringView sName, const char* szFunctionName, ezTime beginTime, ezTime endTime, ezTime scopeTimeout, bool bInternName = false);
 
   /// \brief Get current frame counter
   static ezUInt64 GetFrameCount();
 
+  /// \brief Adds a value to the counter track with the given name. Counter tracks are written as counter events ("ph":"C") into the capture.
+  ///
+  /// Memory usage and the task system queue are recorded automatically once per frame, see the CVar 'Profiling.RecordCounters'.
+  /// Same as for scopes, only string literals are interned, see InternName(). All other names are copied into the sample.
+  template <size_t N>
+  static void AddCounterValue(const char (&szName)[N], double fValue)
+  {
+    AddCounterValue(ezStringView(szName), fValue, true);
+  }
+
+  template <size_t N>
+  static void AddCounterValue(char (&szName)[N], double fValue)
+  {
+    AddCounterValue(ezStringView(szName), fValue, false);
+  }
+
+  static void AddCounterValue(ezStringView sName, double fValue, bool bInternName = false);
+
+  /// \brief Returns a pointer to a zero-terminated copy of the given string that stays valid for the lifetime of the process.
+  ///
+  /// Equal strings always return the same pointer. Each thread caches the most recently interned strings by their address,
+  /// so interning the same string literal repeatedly doesn't need to take a lock.
+  /// Interned strings are never freed, so this must only be used for a limited set of names, never for names that are formatted at runtime.
+  static const char* InternName(ezStringView sName);
+
+  struct StreamingSettings
+  {
+    /// \brief Absolute path of the trace files without extension. The files are named '<path>_<index>.ezProfilingTrace'.
+    ezString m_sOutputPath;
+
+    /// \brief A new file is started, once the current one exceeds this size.
+    ezUInt64 m_uiMaxFileSize = 256 * 1024 * 1024;
+
+    /// \brief A new file is started, once the current one was written to for this long.
+    ezTime m_MaxFileDuration = ezTime::MakeFromMinutes(10);
+
+    /// \brief If more files than this were written, the oldest one is deleted. Zero keeps all files.
+    ezUInt32 m_uiMaxNumFiles = 0;
+
+    /// \brief How often the background thread writes the recorded data to disk.
+    ezTime m_FlushInterval = ezTime::MakeFromMilliseconds(100);
+  };
+
+  /// \brief Starts continuously writing all CPU scopes, frames and counter samples into binary trace files.
+  ///
+  /// A background thread picks up the recorded data from the per-thread buffers without blocking the threads that record scopes,
+  /// and writes it with ezProfilingTraceWriter. If a thread records so many scopes between two flushes that its buffer overflows,
+  /// the overwritten scopes are lost and the number of lost scopes is recorded in the counter track 'Profiling/Lost Scopes'.
+  /// GPU scopes are not streamed.
+  ///
+  /// Use ezProfilingTraceReader (or the ProfilingTraceConverter tool) to convert the traces to the Chrome trace format,
+  /// which can be opened with chrome://tracing or Perfetto.
+  static ezResult StartStreaming(const StreamingSettings& settings);
+
+  /// \brief Writes all remaining data and stops streaming.
+  static void StopStreaming();
+
+  static bool IsStreaming();
+
 private:
   EZ_MAKE_SUBSYSTEM_STARTUP_FRIEND(Foundation, ProfilingSystem);
   friend ezUInt32 RunThread(ezThread* pThread);
@@ -209,12 +317,19 @@ public:
 /// \brief Used to indicate that a frame is finished and another starts.
 #  define EZ_PROFILER_FRAME_MARKER()
 
+/// \brief Adds a value to a counter track in the profiling capture.
+///
+/// \sa ezProfilingSystem::AddCounterValue()
+#  define EZ_PROFILE_COUNTER(CounterName, Value) \
+    ezProfilingSystem::AddCounterValue(CounterName, static_cast<double>(Value))
+
 #else
 #  define EZ_PROFILE_SCOPE(ScopeName)
 #  define EZ_PROFILE_SCOPE_WITH_TIMEOUT(ScopeName, Timeout)
 #  define EZ_PROFILE_LIST_SCOPE(ListName, FirstSectionName)
 #  define EZ_PROFILE_LIST_NEXT_SECTION(NextSectionName)
 #  define EZ_PROFILER_FRAME_MARKER()
+#  define EZ_PROFILE_COUNTER(CounterName, Value)
 #endif
 
 // Let Tracy override the macros.
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <Foundation/Containers/HashSet.h>
+#include <Foundation/Containers/HashTable.h>
+#include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Strings/String.h>
+
+class ezStreamReader;
+
+/// \brief Writes profiling data in a compact binary format.
+///
+/// This is the format that ezProfilingSystem::StartStreaming() writes. Names are only written once per trace and are referenced by
+/// an index afterwards, so a scope takes up 24 bytes, compared to well over 100 bytes in the JSON format of
+/// ezProfilingSystem::ProfilingData::Write(). The trace consists of independent records, which means that a trace that got cut off
+/// (e.g. because the application crashed) can still be read up to the last complete record.
+///
+/// Use ezProfilingTraceReader to convert a trace back into ezProfilingSystem::ProfilingData.
+class EZ_FOUNDATION_DLL ezProfilingTraceWriter
+{
+public:
+  /// \brief Starts a new trace and writes its header. Resets all state from a previous trace.
+  ezResult Begin(ezStreamWriter& inout_stream, ezOsProcessID uiProcessID);
+
+  ezResult WriteThreadInfo(const ezProfilingSystem::ThreadInfo& threadInfo);
+  /// \brief Names that point into \a copiedNames are identified by their content instead of their address, since that memory is reused.
+  ezResult WriteCPUScopes(ezUInt64 uiThreadId, ezArrayPtr<const ezProfilingSystem::CPUScope> scopes, ezArrayPtr<const char> copiedNames = {});
+  ezResult WriteFrame(ezUInt64 uiFrame, ezTime startTime);
+  ezResult WriteCounterSample(const ezProfilingSystem::CounterSample& sample);
+
+  /// \brief Whether the given thread was already written to this trace.
+  bool HasThreadInfo(ezUInt64 uiThreadId) const { return m_WrittenThreads.Contains(uiThreadId); }
+
+private:
+  ezResult WriteName(const char* szName, ezUInt32& out_uiNameIndex);
+  ezResult WriteCopiedName(const char* szName, ezUInt32& out_uiNameIndex);
+  ezResult WriteNameRecord(ezUInt32 uiNameIndex, const char* szName);
+
+  ezStreamWriter* m_pStream = nullptr;
+  ezUInt32 m_uiNumNames = 0;
+  ezHashTable<const void*, ezUInt32> m_NameIndices; // the names are interned, so the pointer is enough to identify them
+  ezHashTable<ezString, ezUInt32> m_CopiedNameIndices;
+  ezDynamicArray<ezUInt32> m_ScopeNameIndices;
+  ezHashSet<ezUInt64> m_WrittenThreads;
+};
+
+/// \brief Reads traces that were written by ezProfilingTraceWriter.
+class EZ_FOUNDATION_DLL ezProfilingTraceReader
+{
+public:
+  /// \brief Reads the trace from the given stream and appends its content to \a out_data.
+  ///
+  /// All names are interned through ezProfilingSystem::InternName(). Returns EZ_FAILURE, if the stream does not contain a valid trace.
+  /// A trace that ends with an incomplete record is read up to that record.
+  static ezResult Read(ezStreamReader& inout_stream, ezProfilingSystem::ProfilingData& out_data);
+};
@@ -572,6 +572,24 @@ public:
   /// it is impossible to pass along a nullptr.
   virtual void Execute(void* pInstance, ezArrayPtr<ezVariant> arguments, ezVariant& out_returnValue) const = 0;
 
+  /// \brief Returns whether ExecuteTyped() can be used for this function.
+  ///
+  /// This is the case if all arguments are standard types that are passed by value or const reference and the return value
+  /// is either void or a standard type that is returned by value or const reference.
+  virtual bool SupportsTypedExecute() const { return false; }
+
+  /// \brief Calls the function without boxing arguments and return value into ezVariant. Only valid if SupportsTypedExecute() returns true.
+  ///
+  /// pArguments must hold GetArgumentCount() pointers and pArguments[i] must point to an instance of exactly GetArgumentType(i).
+  /// out_pReturnValue must point to an instance of exactly GetReturnType() or can be nullptr if the return value is not needed.
+  virtual void ExecuteTyped(void* pInstance, const void* const* pArguments, void* out_pReturnValue) const
+  {
+    EZ_IGNORE_UNUSED(pInstance);
+    EZ_IGNORE_UNUSED(pArguments);
+    EZ_IGNORE_UNUSED(out_pReturnValue);
+    EZ_REPORT_FAILURE("Function '{}' does not support typed execution", GetPropertyName());
+  }
+
   virtual const ezRTTI* GetSpecificType() const override { return GetReturnType(); }
 
   /// \brief Adds flags to the property. Returns itself to allow to be called during initialization.
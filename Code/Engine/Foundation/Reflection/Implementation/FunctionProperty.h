@@ -5,6 +5,22 @@
 #include <Foundation/Reflection/Implementation/AbstractProperty.h>
 #include <Foundation/Reflection/Implementation/VariantAdapter.h>
 
+/// \brief Determines whether a parameter or return value of type T can be passed as raw pointer to ezAbstractFunctionProperty::ExecuteTyped.
+template <class T>
+struct ezIsTypedExecuteParameter
+{
+  static constexpr bool value = ezIsStandardType<T>::value && !std::is_pointer<T>::value &&
+                                (!std::is_reference<T>::value || std::is_const<typename std::remove_reference<T>::type>::value);
+};
+
+template <>
+struct ezIsTypedExecuteParameter<void>
+{
+  static constexpr bool value = true;
+};
+
+template <class T>
+using ezTypedExecuteType = typename ezTypeTraits<T>::NonConstReferencePointerType;
 
 template <class R, class... Args>
 class ezTypedFunctionProperty : public ezAbstractFunctionProperty
@@ -20,6 +36,10 @@ public:
 
   virtual ezUInt32 GetArgumentCount() const override { return sizeof...(Args); }
 
+  static constexpr bool s_bSupportsTypedExecute = ezIsTypedExecuteParameter<R>::value && (ezIsTypedExecuteParameter<Args>::value && ...);
+
+  virtual bool SupportsTypedExecute() const override { return s_bSupportsTypedExecute; }
+
   template <std::size_t... I>
   const ezRTTI* GetParameterTypeImpl(ezUInt32 uiParamIndex, std::index_sequence<I...>) const
   {
@@ -91,6 +111,37 @@ public:
     ExecuteImpl(pInstance, out_returnValue, arguments, std::make_index_sequence<sizeof...(Args)>{});
   }
 
+  template <std::size_t... I>
+  EZ_FORCE_INLINE void ExecuteTypedImpl(void* pInstance, const void* const* pArguments, void* out_pReturnValue, std::index_sequence<I...>) const
+  {
+    CLASS* pTargetInstance = static_cast<CLASS*>(pInstance);
+    if constexpr (std::is_same<R, void>::value)
+    {
+      EZ_IGNORE_UNUSED(out_pReturnValue);
+      (pTargetInstance->*m_Function)(*static_cast<const ezTypedExecuteType<typename getArgument<I, Args...>::Type>*>(pArguments[I])...);
+    }
+    else if (out_pReturnValue != nullptr)
+    {
+      *static_cast<ezTypedExecuteType<R>*>(out_pReturnValue) = (pTargetInstance->*m_Function)(*static_cast<const ezTypedExecuteType<typename getArgument<I, Args...>::Type>*>(pArguments[I])...);
+    }
+    else
+    {
+      (pTargetInstance->*m_Function)(*static_cast<const ezTypedExecuteType<typename getArgument<I, Args...>::Type>*>(pArguments[I])...);
+    }
+  }
+
+  virtual void ExecuteTyped(void* pInstance, const void* const* pArguments, void* out_pReturnValue) const override
+  {
+    if constexpr (ezTypedFunctionProperty<R, Args...>::s_bSupportsTypedExecute)
+    {
+      ExecuteTypedImpl(pInstance, pArguments, out_pReturnValue, std::make_index_sequence<sizeof...(Args)>{});
+    }
+    else
+    {
+      ezAbstractFunctionProperty::ExecuteTyped(pInstance, pArguments, out_pReturnValue);
+    }
+  }
+
 private:
   TargetFunction m_Function;
 };
@@ -134,6 +185,37 @@ public:
     ExecuteImpl(pInstance, out_returnValue, arguments, std::make_index_sequence<sizeof...(Args)>{});
   }
 
+  template <std::size_t... I>
+  EZ_FORCE_INLINE void ExecuteTypedImpl(const void* pInstance, const void* const* pArguments, void* out_pReturnValue, std::index_sequence<I...>) const
+  {
+    const CLASS* pTargetInstance = static_cast<const CLASS*>(pInstance);
+    if constexpr (std::is_same<R, void>::value)
+    {
+      EZ_IGNORE_UNUSED(out_pReturnValue);
+      (pTargetInstance->*m_Function)(*static_cast<const ezTypedExecuteType<typename getArgument<I, Args...>::Type>*>(pArguments[I])...);
+    }
+    else if (out_pReturnValue != nullptr)
+    {
+      *static_cast<ezTypedExecuteType<R>*>(out_pReturnValue) = (pTargetInstance->*m_Function)(*static_cast<const ezTypedExecuteType<typename getArgument<I, Args...>::Type>*>(pArguments[I])...);
+    }
+    else
+    {
+      (pTargetInstance->*m_Function)(*static_cast<const ezTypedExecuteType<typename getArgument<I, Args...>::Type>*>(pArguments[I])...);
+    }
+  }
+
+  virtual void ExecuteTyped(void* pInstance, const void* const* pArguments, void* out_pReturnValue) const override
+  {
+    if constexpr (ezTypedFunctionProperty<R, Args...>::s_bSupportsTypedExecute)
+    {
+      ExecuteTypedImpl(pInstance, pArguments, out_pReturnValue, std::make_index_sequence<sizeof...(Args)>{});
+    }
+    else
+    {
+      ezAbstractFunctionProperty::ExecuteTyped(pInstance, pArguments, out_pReturnValue);
+    }
+  }
+
 private:
   TargetFunction m_Function;
 };
@@ -172,6 +254,37 @@ public:
     ExecuteImpl(ezTraitInt<std::is_same<R, void>::value>(), out_returnValue, arguments, std::make_index_sequence<sizeof...(Args)>{});
   }
 
+  template <std::size_t... I>
+  EZ_FORCE_INLINE void ExecuteTypedImpl(const void* const* pArguments, void* out_pReturnValue, std::index_sequence<I...>) const
+  {
+    if constexpr (std::is_same<R, void>::value)
+    {
+      EZ_IGNORE_UNUSED(out_pReturnValue);
+      (*m_Function)(*static_cast<const ezTypedExecuteType<typename getArgument<I, Args...>::Type>*>(pArguments[I])...);
+    }
+    else if (out_pReturnValue != nullptr)
+    {
+      *static_cast<ezTypedExecuteType<R>*>(out_pReturnValue) = (*m_Function)(*static_cast<const ezTypedExecuteType<typename getArgument<I, Args...>::Type>*>(pArguments[I])...);
+    }
+    else
+    {
+      (*m_Function)(*static_cast<const ezTypedExecuteType<typename getArgument<I, Args...>::Type>*>(pArguments[I])...);
+    }
+  }
+
+  virtual void ExecuteTyped(void* pInstance, const void* const* pArguments, void* out_pReturnValue) const override
+  {
+    if constexpr (ezTypedFunctionProperty<R, Args...>::s_bSupportsTypedExecute)
+    {
+      EZ_IGNORE_UNUSED(pInstance);
+      ExecuteTypedImpl(pArguments, out_pReturnValue, std::make_index_sequence<sizeof...(Args)>{});
+    }
+    else
+    {
+      ezAbstractFunctionProperty::ExecuteTyped(pInstance, pArguments, out_pReturnValue);
+    }
+  }
+
 private:
   TargetFunction m_Function;
 };
@@ -26,6 +26,10 @@ public:
   static ezResult Read(const ezOpenDdlReaderElement* pRootElement, ezAbstractObjectGraph* pGraph, ezAbstractObjectGraph* pTypesGraph = nullptr, bool bApplyPatches = true);
 
   static void WriteDocument(ezStreamWriter& inout_stream, const ezAbstractObjectGraph* pHeader, const ezAbstractObjectGraph* pGraph, const ezAbstractObjectGraph* pTypes, bool bCompactMode = true, ezOpenDdlWriter::TypeStringMode typeMode = ezOpenDdlWriter::TypeStringMode::Shortest);
+  /// \brief Writes the document with the given writer, e.g. one that is configured with ezOpenDdlWriter::SetBinaryMode().
+  ///
+  /// All read functions accept text and binary documents.
+  static void WriteDocument(ezOpenDdlWriter& ref_writer, const ezAbstractObjectGraph* pHeader, const ezAbstractObjectGraph* pGraph, const ezAbstractObjectGraph* pTypes);
   static ezResult ReadDocument(ezStreamReader& inout_stream, ezUniquePtr<ezAbstractObjectGraph>& ref_pHeader, ezUniquePtr<ezAbstractObjectGraph>& ref_pGraph, ezUniquePtr<ezAbstractObjectGraph>& ref_pTypes, bool bApplyPatches = true);
 
   static ezResult ReadHeader(ezStreamReader& inout_stream, ezAbstractObjectGraph* pGraph);
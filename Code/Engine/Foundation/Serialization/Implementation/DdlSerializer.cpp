@@ -262,11 +262,16 @@ void ezAbstractGraphDdlSerializer::WriteDocument(ezStreamWriter& inout_stream, c
   if (typeMode != ezOpenDdlWriter::TypeStringMode::Compliant)
     writer.SetIndentation(-1);
 
+  WriteDocument(writer, pHeader, pGraph, pTypes);
+}
+
+void ezAbstractGraphDdlSerializer::WriteDocument(ezOpenDdlWriter& ref_writer, const ezAbstractObjectGraph* pHeader, const ezAbstractObjectGraph* pGraph, const ezAbstractObjectGraph* pTypes)
+{
   ezStringBuilder sHeaderVersion;
   sHeaderVersion.SetFormat("HeaderV{0}", (int)EZ_DOCUMENT_VERSION);
-  WriteGraph(writer, pHeader, sHeaderVersion);
-  WriteGraph(writer, pGraph, "Objects");
-  WriteGraph(writer, pTypes, "Types");
+  WriteGraph(ref_writer, pHeader, sHeaderVersion);
+  WriteGraph(ref_writer, pGraph, "Objects");
+  WriteGraph(ref_writer, pTypes, "Types");
 }
 
 ezResult ezAbstractGraphDdlSerializer::ReadDocument(ezStreamReader& inout_stream, ezUniquePtr<ezAbstractObjectGraph>& ref_pHeader,
@@ -429,8 +434,12 @@ ezResult ezAbstractGraphDdlSerializer::ReadHeader(ezStreamReader& inout_stream,
     return EZ_FAILURE;
   }
 
+  // binary documents are read entirely, without going through the callbacks of HeaderReader
+  const ezOpenDdlReaderElement* pFirstChild = reader.GetRootElement()->GetFirstChild();
+  const bool bHasHeader = reader.m_bHasHeader || (pFirstChild != nullptr && pFirstChild->GetCustomType().StartsWith("HeaderV"));
+
   const ezOpenDdlReaderElement* pObjects = nullptr;
-  if (reader.m_bHasHeader)
+  if (bHasHeader)
   {
     pObjects = reader.GetRootElement()->GetFirstChild();
   }
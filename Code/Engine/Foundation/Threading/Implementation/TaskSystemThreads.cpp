@@ -193,6 +193,19 @@ double ezTaskSystem::GetThreadUtilization(ezWorkerThreadType::Enum type, ezUInt3
   return s_pThreadState->m_Workers[type][uiThreadIndex]->GetThreadUtilization(pNumTasksExecuted);
 }
 
+ezUInt32 ezTaskSystem::GetNumQueuedTasks()
+{
+  EZ_LOCK(s_TaskSystemMutex);
+
+  ezUInt32 uiNumTasks = 0;
+  for (ezUInt32 i = 0; i < ezTaskPriority::ENUM_COUNT; ++i)
+  {
+    uiNumTasks += s_pState->m_Tasks[i].GetCount();
+  }
+
+  return uiNumTasks;
+}
+
 void ezTaskSystem::DetermineTasksToExecuteOnThread(ezTaskPriority::Enum& out_FirstPriority, ezTaskPriority::Enum& out_LastPriority)
 {
   switch (tl_TaskWorkerInfo.m_WorkerType)
@@ -0,0 +1,547 @@
+#include <Foundation/FoundationPCH.h>
+
+#include <Foundation/Containers/HashTable.h>
+#include <Foundation/IO/JSONWriter.h>
+#include <Foundation/IO/Stream.h>
+#include <Foundation/Strings/HashedString.h>
+#include <Foundation/Strings/StringBuilder.h>
+#include <Foundation/Threading/Lock.h>
+#include <Foundation/Threading/Mutex.h>
+#include <Foundation/Utilities/Metrics.h>
+#include <Foundation/Utilities/Stats.h>
+
+#include <atomic>
+
+namespace ezMetricsDetail
+{
+  /// The storage for counters and histograms of one thread. Only the owning thread ever writes to it, so updates are plain
+  /// relaxed loads and stores. Snapshot() reads the slots of all blocks concurrently, which is why they are atomics.
+  struct ThreadBlock
+  {
+    std::atomic<ezInt64> m_Slots[ezMetrics::MaxThreadSlots] = {};
+    std::atomic<bool> m_bInUse = {false};
+    ThreadBlock* m_pNext = nullptr;
+  };
+
+  /// Blocks are never freed, when a thread terminates its block is handed to the next new thread, which simply keeps adding to the
+  /// existing (cumulative) values.
+  struct ThreadBlockOwner
+  {
+    ~ThreadBlockOwner()
+    {
+      if (m_pBlock)
+      {
+        m_pBlock->m_bInUse.store(false, std::memory_order_release);
+      }
+    }
+
+    ThreadBlock* m_pBlock = nullptr;
+  };
+
+  struct MetricInfo
+  {
+    ezHashedString m_sName;
+    ezHashedString m_sStatNames[3];
+    ezMetricType::Enum m_Type = ezMetricType::Counter;
+    ezUInt32 m_uiSlot = 0;
+    ezUInt32 m_uiNumBuckets = 0;
+    float m_fMinValue = 0.0f;
+    float m_fMaxValue = 0.0f;
+
+    // the following values are only accessed by the thread that calls Snapshot()
+    double m_fValue = 0.0;
+    ezInt64 m_iTotal = 0;
+    ezUInt64 m_uiSampleCount = 0;
+  };
+
+  struct RecordedFrame
+  {
+    double m_fTime = 0.0;
+    ezDynamicArray<double> m_Values;
+  };
+
+  static ezMutex s_Mutex;
+  static ezHashTable<ezHashedString, ezUInt32> s_NameToMetric;
+  static MetricInfo s_Metrics[ezMetrics::MaxMetrics];
+  static std::atomic<ezUInt32> s_uiNumMetrics = {0};
+  static ezUInt32 s_uiNumSlots = 0;
+
+  static std::atomic<double> s_GaugeValues[ezMetrics::MaxMetrics] = {};
+
+  static std::atomic<ThreadBlock*> s_pFirstBlock = {nullptr};
+  static thread_local ThreadBlockOwner s_ThreadBlock;
+
+  // per-slot totals summed over all threads, as of the previous snapshot, and the difference to the snapshot before that
+  static ezInt64 s_SlotTotals[ezMetrics::MaxThreadSlots] = {};
+  static ezInt64 s_SlotDeltas[ezMetrics::MaxThreadSlots] = {};
+  static double s_HistogramSums[ezMetrics::MaxMetrics] = {};
+
+  static bool s_bRecording = false;
+  static ezUInt32 s_uiMaxRecordedFrames = 0;
+  static ezUInt32 s_uiFirstRecordedFrame = 0;
+  static ezDynamicArray<RecordedFrame> s_RecordedFrames; // used as a ring buffer once it is full
+
+  static const RecordedFrame& GetRecordedFrame(ezUInt32 uiIndex)
+  {
+    return s_RecordedFrames[(s_uiFirstRecordedFrame + uiIndex) % s_RecordedFrames.GetCount()];
+  }
+
+  static ThreadBlock* AcquireThreadBlock()
+  {
+    // try to reuse the block of a thread that has terminated
+    for (ThreadBlock* pBlock = s_pFirstBlock.load(std::memory_order_acquire); pBlock != nullptr; pBlock = pBlock->m_pNext)
+    {
+      bool bExpected = false;
+      if (pBlock->m_bInUse.compare_exchange_strong(bExpected, true, std::memory_order_acquire))
+        return pBlock;
+    }
+
+    ThreadBlock* pBlock = EZ_NEW(ezFoundation::GetStaticsAllocator(), ThreadBlock);
+    pBlock->m_bInUse.store(true, std::memory_order_relaxed);
+
+    EZ_LOCK(s_Mutex);
+    pBlock->m_pNext = s_pFirstBlock.load(std::memory_order_relaxed);
+    s_pFirstBlock.store(pBlock, std::memory_order_release);
+    return pBlock;
+  }
+
+  EZ_ALWAYS_INLINE static std::atomic<ezInt64>* GetThreadSlots()
+  {
+    ThreadBlock* pBlock = s_ThreadBlock.m_pBlock;
+    if (pBlock == nullptr)
+    {
+      pBlock = AcquireThreadBlock();
+      s_ThreadBlock.m_pBlock = pBlock;
+    }
+
+    return pBlock->m_Slots;
+  }
+
+  EZ_ALWAYS_INLINE static double ToDouble(ezInt64 iBits)
+  {
+    double fValue;
+    ezMemoryUtils::RawByteCopy(&fValue, &iBits, sizeof(double));
+    return fValue;
+  }
+
+  EZ_ALWAYS_INLINE static ezInt64 ToBits(double fValue)
+  {
+    ezInt64 iBits;
+    ezMemoryUtils::RawByteCopy(&iBits, &fValue, sizeof(double));
+    return iBits;
+  }
+} // namespace ezMetricsDetail
+
+using namespace ezMetricsDetail;
+
+void ezMetricCounter::Add(ezInt64 iValue) const
+{
+  EZ_ASSERT_DEBUG(IsValid(), "Invalid metric handle");
+
+  std::atomic<ezInt64>& slot = GetThreadSlots()[m_uiSlot];
+  slot.store(slot.load(std::memory_order_relaxed) + iValue, std::memory_order_relaxed);
+}
+
+void ezMetricGauge::Set(double fValue) const
+{
+  EZ_ASSERT_DEBUG(IsValid(), "Invalid metric handle");
+
+  s_GaugeValues[m_uiMetric].store(fValue, std::memory_order_relaxed);
+}
+
+void ezMetricHistogram::Record(double fValue) const
+{
+  EZ_ASSERT_DEBUG(IsValid(), "Invalid metric handle");
+
+  // clamp before converting, the conversion of values that don't fit into an ezUInt32 is undefined. NaN fails the comparison and ends up in the first bucket.
+  const float fBucket = (static_cast<float>(fValue) - m_fMinValue) * m_fInvBucketSize;
+  const float fClampedBucket = fBucket > 0.0f ? ezMath::Min(fBucket, static_cast<float>(m_uiNumBuckets - 1)) : 0.0f;
+  const ezUInt32 uiBucket = static_cast<ezUInt32>(fClampedBucket);
+
+  std::atomic<ezInt64>* pSlots = GetThreadSlots() + m_uiSlot;
+
+  std::atomic<ezInt64>& bucket = pSlots[uiBucket];
+  bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+  if (!ezMath::IsFinite(fValue))
+    return;
+
+  std::atomic<ezInt64>& sum = pSlots[m_uiNumBuckets];
+  sum.store(ToBits(ToDouble(sum.load(std::memory_order_relaxed)) + fValue), std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+ezUInt32 ezMetrics::RegisterMetric(ezStringView sName, ezMetricType::Enum type, ezUInt32 uiNumSlots, float fMinValue, float fMaxValue)
+{
+  EZ_LOCK(s_Mutex);
+
+  ezHashedString sHashedName;
+  sHashedName.Assign(sName);
+
+  ezUInt32 uiMetric = ezInvalidIndex;
+  if (s_NameToMetric.TryGetValue(sHashedName, uiMetric))
+  {
+    if (s_Metrics[uiMetric].m_Type != type)
+    {
+      ezLog::Error("Metric '{}' is already registered with a different type.", sName);
+      return ezInvalidIndex;
+    }
+
+    return uiMetric;
+  }
+
+  uiMetric = s_uiNumMetrics.load(std::memory_order_relaxed);
+  if (uiMetric >= MaxMetrics || s_uiNumSlots + uiNumSlots > MaxThreadSlots)
+  {
+    ezLog::Error("Can't register metric '{}', the maximum number of metrics has been reached.", sName);
+    return ezInvalidIndex;
+  }
+
+  MetricInfo& info = s_Metrics[uiMetric];
+  info.m_sName = sHashedName;
+  info.m_Type = type;
+  info.m_uiSlot = s_uiNumSlots;
+  info.m_uiNumBuckets = type == ezMetricType::Histogram ? uiNumSlots - 1 : 0;
+  info.m_fMinValue = fMinValue;
+  info.m_fMaxValue = fMaxValue;
+
+  if (type == ezMetricType::Histogram)
+  {
+    ezStringBuilder sStatName;
+    sStatName.SetFormat("{}/Avg", sName);
+    info.m_sStatNames[0].Assign(sStatName);
+    sStatName.SetFormat("{}/P95", sName);
+    info.m_sStatNames[1].Assign(sStatName);
+    sStatName.SetFormat("{}/Samples", sName);
+    info.m_sStatNames[2].Assign(sStatName);
+  }
+
+  s_uiNumSlots += uiNumSlots;
+  s_NameToMetric.Insert(sHashedName, uiMetric);
+
+  // publish the new metric only once it is fully set up, Snapshot() does not take the mutex
+  s_uiNumMetrics.store(uiMetric + 1, std::memory_order_release);
+
+  return uiMetric;
+}
+
+ezMetricCounter ezMetrics::RegisterCounter(ezStringView sName)
+{
+  ezMetricCounter counter;
+  counter.m_uiMetric = RegisterMetric(sName, ezMetricType::Counter, 1, 0.0f, 0.0f);
+
+  if (counter.IsValid())
+  {
+    counter.m_uiSlot = s_Metrics[counter.m_uiMetric].m_uiSlot;
+  }
+
+  return counter;
+}
+
+ezMetricGauge ezMetrics::RegisterGauge(ezStringView sName)
+{
+  ezMetricGauge gauge;
+  gauge.m_uiMetric = RegisterMetric(sName, ezMetricType::Gauge, 0, 0.0f, 0.0f);
+  return gauge;
+}
+
+ezMetricHistogram ezMetrics::RegisterHistogram(ezStringView sName, float fMinValue, float fMaxValue, ezUInt32 uiNumBuckets)
+{
+  EZ_ASSERT_DEV(fMinValue < fMaxValue, "Invalid histogram range [{}, {}]", fMinValue, fMaxValue);
+  EZ_ASSERT_DEV(uiNumBuckets > 0, "A histogram needs at least one bucket");
+
+  ezMetricHistogram histogram;
+  histogram.m_uiMetric = RegisterMetric(sName, ezMetricType::Histogram, uiNumBuckets + 1, fMinValue, fMaxValue);
+
+  if (histogram.IsValid())
+  {
+    const MetricInfo& info = s_Metrics[histogram.m_uiMetric];
+    histogram.m_uiSlot = info.m_uiSlot;
+    histogram.m_uiNumBuckets = info.m_uiNumBuckets;
+    histogram.m_fMinValue = info.m_fMinValue;
+    histogram.m_fInvBucketSize = info.m_uiNumBuckets / (info.m_fMaxValue - info.m_fMinValue);
+  }
+
+  return histogram;
+}
+
+ezUInt32 ezMetrics::GetNumMetrics()
+{
+  return s_uiNumMetrics.load(std::memory_order_acquire);
+}
+
+ezStringView ezMetrics::GetName(ezUInt32 uiMetric)
+{
+  return s_Metrics[uiMetric].m_sName.GetView();
+}
+
+ezMetricType::Enum ezMetrics::GetType(ezUInt32 uiMetric)
+{
+  return s_Metrics[uiMetric].m_Type;
+}
+
+void ezMetrics::Snapshot()
+{
+  const ezUInt32 uiNumMetrics = GetNumMetrics();
+  if (uiNumMetrics == 0)
+    return;
+
+  const MetricInfo& lastMetric = s_Metrics[uiNumMetrics - 1];
+  const ezUInt32 uiNumSlots = lastMetric.m_uiSlot + (lastMetric.m_Type == ezMetricType::Histogram ? lastMetric.m_uiNumBuckets + 1 : (lastMetric.m_Type == ezMetricType::Counter ? 1 : 0));
+
+  ezInt64 newTotals[MaxThreadSlots];
+  ezMemoryUtils::ZeroFill(newTotals, uiNumSlots);
+
+  for (ThreadBlock* pBlock = s_pFirstBlock.load(std::memory_order_acquire); pBlock != nullptr; pBlock = pBlock->m_pNext)
+  {
+    for (ezUInt32 i = 0; i < uiNumSlots; ++i)
+    {
+      newTotals[i] += pBlock->m_Slots[i].load(std::memory_order_relaxed);
+    }
+  }
+
+  for (ezUInt32 i = 0; i < uiNumSlots; ++i)
+  {
+    s_SlotDeltas[i] = newTotals[i] - s_SlotTotals[i];
+    s_SlotTotals[i] = newTotals[i];
+  }
+
+  for (ezUInt32 uiMetric = 0; uiMetric < uiNumMetrics; ++uiMetric)
+  {
+    MetricInfo& info = s_Metrics[uiMetric];
+
+    switch (info.m_Type)
+    {
+      case ezMetricType::Counter:
+        info.m_iTotal = s_SlotTotals[info.m_uiSlot];
+        info.m_fValue = static_cast<double>(s_SlotDeltas[info.m_uiSlot]);
+        break;
+
+      case ezMetricType::Gauge:
+        info.m_fValue = s_GaugeValues[uiMetric].load(std::memory_order_relaxed);
+        break;
+
+      case ezMetricType::Histogram:
+      {
+        ezUInt64 uiSampleCount = 0;
+        for (ezUInt32 i = 0; i < info.m_uiNumBuckets; ++i)
+        {
+          uiSampleCount += s_SlotDeltas[info.m_uiSlot + i];
+        }
+
+        // the sum of all samples is stored as a double and therefore can't be accumulated like the integer slots
+        const ezUInt32 uiSumSlot = info.m_uiSlot + info.m_uiNumBuckets;
+        double fSum = 0.0;
+        for (ThreadBlock* pBlock = s_pFirstBlock.load(std::memory_order_acquire); pBlock != nullptr; pBlock = pBlock->m_pNext)
+        {
+          fSum += ToDouble(pBlock->m_Slots[uiSumSlot].load(std::memory_order_relaxed));
+        }
+
+        info.m_uiSampleCount = uiSampleCount;
+        info.m_fValue = uiSampleCount > 0 ? (fSum - s_HistogramSums[uiMetric]) / uiSampleCount : 0.0;
+        s_HistogramSums[uiMetric] = fSum;
+      }
+      break;
+    }
+  }
+
+  if (s_bRecording)
+  {
+    RecordedFrame* pFrame = nullptr;
+    if (s_RecordedFrames.GetCount() < s_uiMaxRecordedFrames)
+    {
+      pFrame = &s_RecordedFrames.ExpandAndGetRef();
+    }
+    else
+    {
+      // overwrite the oldest frame, its values array keeps its capacity
+      pFrame = &s_RecordedFrames[s_uiFirstRecordedFrame];
+      s_uiFirstRecordedFrame = (s_uiFirstRecordedFrame + 1) % s_RecordedFrames.GetCount();
+    }
+
+    pFrame->m_fTime = ezTime::Now().GetSeconds();
+    pFrame->m_Values.SetCountUninitialized(uiNumMetrics);
+
+    for (ezUInt32 uiMetric = 0; uiMetric < uiNumMetrics; ++uiMetric)
+    {
+      pFrame->m_Values[uiMetric] = s_Metrics[uiMetric].m_fValue;
+    }
+  }
+}
+
+double ezMetrics::GetValue(ezUInt32 uiMetric)
+{
+  EZ_ASSERT_DEBUG(uiMetric < GetNumMetrics(), "Invalid metric index {}", uiMetric);
+  return s_Metrics[uiMetric].m_fValue;
+}
+
+ezInt64 ezMetrics::GetTotal(const ezMetricCounter& counter)
+{
+  EZ_ASSERT_DEBUG(counter.IsValid(), "Invalid metric handle");
+  return s_Metrics[counter.m_uiMetric].m_iTotal;
+}
+
+ezUInt64 ezMetrics::GetSampleCount(const ezMetricHistogram& histogram)
+{
+  EZ_ASSERT_DEBUG(histogram.IsValid(), "Invalid metric handle");
+  return s_Metrics[histogram.m_uiMetric].m_uiSampleCount;
+}
+
+double ezMetrics::GetPercentile(const ezMetricHistogram& histogram, float fPercentile)
+{
+  EZ_ASSERT_DEBUG(histogram.IsValid(), "Invalid metric handle");
+
+  const MetricInfo& info = s_Metrics[histogram.m_uiMetric];
+  if (info.m_uiSampleCount == 0)
+    return 0.0;
+
+  const double fBucketSize = (info.m_fMaxValue - info.m_fMinValue) / static_cast<double>(info.m_uiNumBuckets);
+  const double fTargetCount = ezMath::Clamp(fPercentile, 0.0f, 1.0f) * static_cast<double>(info.m_uiSampleCount);
+
+  double fCount = 0.0;
+  for (ezUInt32 i = 0; i < info.m_uiNumBuckets; ++i)
+  {
+    const double fBucketCount = static_cast<double>(s_SlotDeltas[info.m_uiSlot + i]);
+    if (fBucketCount > 0.0 && fCount + fBucketCount >= fTargetCount)
+    {
+      const double fFraction = (fTargetCount - fCount) / fBucketCount;
+      return info.m_fMinValue + (i + fFraction) * fBucketSize;
+    }
+
+    fCount += fBucketCount;
+  }
+
+  return info.m_fMaxValue;
+}
+
+void ezMetrics::ExportToStats()
+{
+  const ezUInt32 uiNumMetrics = GetNumMetrics();
+  for (ezUInt32 uiMetric = 0; uiMetric < uiNumMetrics; ++uiMetric)
+  {
+    const MetricInfo& info = s_Metrics[uiMetric];
+
+    switch (info.m_Type)
+    {
+      case ezMetricType::Counter:
+        ezStats::SetStat(info.m_sName.GetView(), static_cast<ezInt64>(info.m_fValue));
+        break;
+
+      case ezMetricType::Gauge:
+        ezStats::SetStat(info.m_sName.GetView(), info.m_fValue);
+        break;
+
+      case ezMetricType::Histogram:
+      {
+        ezMetricHistogram histogram;
+        histogram.m_uiMetric = uiMetric;
+
+        ezStats::SetStat(info.m_sStatNames[0].GetView(), info.m_fValue);
+        ezStats::SetStat(info.m_sStatNames[1].GetView(), GetPercentile(histogram, 0.95f));
+        ezStats::SetStat(info.m_sStatNames[2].GetView(), info.m_uiSampleCount);
+      }
+      break;
+    }
+  }
+}
+
+void ezMetrics::StartRecording(ezUInt32 uiMaxFrames)
+{
+  EZ_ASSERT_DEV(uiMaxFrames > 0, "Invalid number of frames");
+
+  s_bRecording = true;
+  s_uiMaxRecordedFrames = uiMaxFrames;
+  s_uiFirstRecordedFrame = 0;
+  s_RecordedFrames.Clear();
+}
+
+void ezMetrics::StopRecording()
+{
+  s_bRecording = false;
+}
+
+bool ezMetrics::IsRecording()
+{
+  return s_bRecording;
+}
+
+ezUInt32 ezMetrics::GetNumRecordedFrames()
+{
+  return s_RecordedFrames.GetCount();
+}
+
+ezResult ezMetrics::WriteTimeSeriesCSV(ezStreamWriter& inout_stream)
+{
+  const ezUInt32 uiNumMetrics = GetNumMetrics();
+
+  ezStringBuilder sLine = "Time";
+  for (ezUInt32 uiMetric = 0; uiMetric < uiNumMetrics; ++uiMetric)
+  {
+    sLine.AppendFormat(",{}", GetName(uiMetric));
+  }
+  sLine.Append("\n");
+  EZ_SUCCEED_OR_RETURN(inout_stream.WriteBytes(sLine.GetData(), sLine.GetElementCount()));
+
+  for (ezUInt32 uiFrame = 0; uiFrame < s_RecordedFrames.GetCount(); ++uiFrame)
+  {
+    const RecordedFrame& frame = GetRecordedFrame(uiFrame);
+    sLine.SetFormat("{}", frame.m_fTime);
+
+    for (ezUInt32 uiMetric = 0; uiMetric < uiNumMetrics; ++uiMetric)
+    {
+      // metrics that were registered after this frame was recorded are left empty
+      if (uiMetric < frame.m_Values.GetCount())
+        sLine.AppendFormat(",{}", frame.m_Values[uiMetric]);
+      else
+        sLine.Append(",");
+    }
+
+    sLine.Append("\n");
+    EZ_SUCCEED_OR_RETURN(inout_stream.WriteBytes(sLine.GetData(), sLine.GetElementCount()));
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezMetrics::WriteTimeSeriesJSON(ezStreamWriter& inout_stream)
+{
+  const ezUInt32 uiNumMetrics = GetNumMetrics();
+
+  ezStandardJSONWriter json;
+  json.SetOutputStream(&inout_stream);
+
+  json.BeginObject();
+  {
+    json.BeginArray("Metrics");
+    for (ezUInt32 uiMetric = 0; uiMetric < uiNumMetrics; ++uiMetric)
+    {
+      json.WriteString(GetName(uiMetric));
+    }
+    json.EndArray();
+
+    json.BeginArray("Frames");
+    for (ezUInt32 uiFrame = 0; uiFrame < s_RecordedFrames.GetCount(); ++uiFrame)
+    {
+      const RecordedFrame& frame = GetRecordedFrame(uiFrame);
+
+      json.BeginObject();
+      json.AddVariableDouble("Time", frame.m_fTime);
+
+      json.BeginArray("Values");
+      for (double fValue : frame.m_Values)
+      {
+        json.WriteDouble(fValue);
+      }
+      json.EndArray();
+
+      json.EndObject();
+    }
+    json.EndArray();
+  }
+  json.EndObject();
+
+  return EZ_SUCCESS;
+}
+
+EZ_STATICLINK_FILE(Foundation, Foundation_Utilities_Implementation_Metrics);
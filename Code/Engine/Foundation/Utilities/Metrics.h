@@ -0,0 +1,170 @@
+#pragma once
+
+#include <Foundation/Basics.h>
+#include <Foundation/Strings/StringView.h>
+#include <Foundation/Time/Time.h>
+
+class ezStreamWriter;
+
+/// \brief The different kinds of metrics that can be registered with ezMetrics.
+struct ezMetricType
+{
+  using StorageType = ezUInt8;
+
+  enum Enum : StorageType
+  {
+    Counter,   ///< A value that only ever gets added to, e.g. the number of draw calls. Reported as the amount added during the last frame.
+    Gauge,     ///< A value that is set to an absolute value, e.g. the number of loaded resources. Reported as the last value that was set.
+    Histogram, ///< A distribution of recorded samples, e.g. the duration of a job. Reported as the average and percentiles of the last frame.
+
+    Default = Counter
+  };
+};
+
+/// \brief Handle to a counter metric. See ezMetrics::RegisterCounter().
+class EZ_FOUNDATION_DLL ezMetricCounter
+{
+public:
+  bool IsValid() const { return m_uiMetric != ezInvalidIndex; }
+
+  /// \brief Adds the given value to the counter. Lock-free, the value is accumulated in storage that is owned by the calling thread.
+  void Add(ezInt64 iValue = 1) const;
+
+private:
+  friend class ezMetrics;
+  ezUInt32 m_uiMetric = ezInvalidIndex;
+  ezUInt32 m_uiSlot = 0;
+};
+
+/// \brief Handle to a gauge metric. See ezMetrics::RegisterGauge().
+class EZ_FOUNDATION_DLL ezMetricGauge
+{
+public:
+  bool IsValid() const { return m_uiMetric != ezInvalidIndex; }
+
+  /// \brief Sets the current value of the gauge. Lock-free, if several threads set the same gauge, the last write wins.
+  void Set(double fValue) const;
+
+private:
+  friend class ezMetrics;
+  ezUInt32 m_uiMetric = ezInvalidIndex;
+};
+
+/// \brief Handle to a histogram metric. See ezMetrics::RegisterHistogram().
+class EZ_FOUNDATION_DLL ezMetricHistogram
+{
+public:
+  bool IsValid() const { return m_uiMetric != ezInvalidIndex; }
+
+  /// \brief Records one sample. Lock-free, the sample is accumulated in storage that is owned by the calling thread.
+  ///
+  /// Samples outside of the registered range are counted in the first or last bucket, but still contribute with their
+  /// exact value to the average. Infinite values and NaN are counted in the outer buckets as well, but only contribute zero to the
+  /// average, so that a single invalid sample doesn't turn it into NaN.
+  void Record(double fValue) const;
+
+private:
+  friend class ezMetrics;
+  ezUInt32 m_uiMetric = ezInvalidIndex;
+  ezUInt32 m_uiSlot = 0;
+  ezUInt32 m_uiNumBuckets = 0;
+  float m_fMinValue = 0.0f;
+  float m_fInvBucketSize = 0.0f;
+};
+
+/// \brief A registry of typed, pre-registered metrics that can be updated from hot code paths at very low cost.
+///
+/// Contrary to ezStats, updating a metric does not involve any string operations, locks or event broadcasts.
+/// Metrics are registered once (typically at startup) and are then identified by a small handle.
+/// Counters and histograms are accumulated per thread, so recording a value never contends with other threads.
+///
+/// Once per frame Snapshot() sums up the data of all threads (without blocking them) and computes the per-frame values.
+/// The result of the last snapshot can be queried through GetValue(), forwarded to ezStats (and thus to ezInspector)
+/// via ExportToStats(), or recorded into a time series that can be written out as CSV or JSON.
+class EZ_FOUNDATION_DLL ezMetrics
+{
+public:
+  /// \brief The maximum number of metrics that can be registered.
+  static constexpr ezUInt32 MaxMetrics = 512;
+
+  /// \brief The number of 64 bit slots that each thread reserves for counters and histograms.
+  ///
+  /// A counter takes up one slot, a histogram takes up one slot per bucket plus one for the sum of all samples.
+  static constexpr ezUInt32 MaxThreadSlots = 2048;
+
+  /// \brief Registers a counter. If a counter with the same name was already registered, its handle is returned.
+  ///
+  /// \a sName may contain slashes to define groups, just like the names of stats in ezStats.
+  /// Returns an invalid handle, if the name is already used by a different type of metric or if the registry is full.
+  static ezMetricCounter RegisterCounter(ezStringView sName);
+
+  /// \brief Registers a gauge. If a gauge with the same name was already registered, its handle is returned.
+  static ezMetricGauge RegisterGauge(ezStringView sName);
+
+  /// \brief Registers a histogram with \a uiNumBuckets buckets of equal size between \a fMinValue and \a fMaxValue.
+  ///
+  /// If a histogram with the same name was already registered, its handle is returned and the range parameters are ignored.
+  static ezMetricHistogram RegisterHistogram(ezStringView sName, float fMinValue, float fMaxValue, ezUInt32 uiNumBuckets = 32);
+
+  /// \brief Returns the number of registered metrics. Metrics are indexed from 0 to GetNumMetrics() - 1.
+  static ezUInt32 GetNumMetrics();
+
+  static ezStringView GetName(ezUInt32 uiMetric);
+  static ezMetricType::Enum GetType(ezUInt32 uiMetric);
+
+  /// \brief Gathers the values of all metrics from all threads and computes the per-frame values.
+  ///
+  /// Should be called exactly once per frame from the same thread, which ezGameApplicationBase does at the end of every frame.
+  /// Threads that record values concurrently are never blocked, their values simply end up in this or the next snapshot.
+  static void Snapshot();
+
+  /// \brief Returns the value of the given metric as computed by the last Snapshot().
+  ///
+  /// For counters this is the amount that was added since the previous snapshot, for gauges the last value that was set
+  /// and for histograms the average of all samples that were recorded since the previous snapshot.
+  static double GetValue(ezUInt32 uiMetric);
+
+  static double GetValue(const ezMetricCounter& counter) { return GetValue(counter.m_uiMetric); }
+  static double GetValue(const ezMetricGauge& gauge) { return GetValue(gauge.m_uiMetric); }
+  static double GetValue(const ezMetricHistogram& histogram) { return GetValue(histogram.m_uiMetric); }
+
+  /// \brief Returns the total amount that was added to the counter since it was registered, as of the last Snapshot().
+  static ezInt64 GetTotal(const ezMetricCounter& counter);
+
+  /// \brief Returns the number of samples that were recorded into the histogram during the last frame.
+  static ezUInt64 GetSampleCount(const ezMetricHistogram& histogram);
+
+  /// \brief Estimates the given percentile (0 to 1) of the samples that were recorded into the histogram during the last frame.
+  ///
+  /// The result is interpolated linearly within the bucket that contains the percentile, so its precision depends on the bucket size.
+  static double GetPercentile(const ezMetricHistogram& histogram, float fPercentile);
+
+  /// \brief Writes the values of the last Snapshot() to ezStats, which also makes them show up in ezInspector.
+  ///
+  /// Histograms are exported as "<name>/Avg", "<name>/P95" and "<name>/Samples".
+  static void ExportToStats();
+
+  /// \brief Starts recording the result of every Snapshot() into a time series. Only the last \a uiMaxFrames frames are kept.
+  static void StartRecording(ezUInt32 uiMaxFrames = 60 * 60);
+
+  /// \brief Stops recording snapshots. The already recorded time series is kept until the next call to StartRecording().
+  static void StopRecording();
+
+  static bool IsRecording();
+
+  /// \brief Returns the number of frames in the recorded time series.
+  static ezUInt32 GetNumRecordedFrames();
+
+  /// \brief Writes the recorded time series as CSV. The first column is the time of the snapshot in seconds, followed by one column per metric.
+  static ezResult WriteTimeSeriesCSV(ezStreamWriter& inout_stream);
+
+  /// \brief Writes the recorded time series as JSON, with an array of names and one array of values per frame.
+  static ezResult WriteTimeSeriesJSON(ezStreamWriter& inout_stream);
+
+private:
+  friend class ezMetricCounter;
+  friend class ezMetricGauge;
+  friend class ezMetricHistogram;
+
+  static ezUInt32 RegisterMetric(ezStringView sName, ezMetricType::Enum type, ezUInt32 uiNumSlots, float fMinValue, float fMaxValue);
+};
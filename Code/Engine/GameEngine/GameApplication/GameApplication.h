@@ -37,6 +37,7 @@ class EZ_GAMEENGINE_DLL ezGameApplication : public ezGameApplicationBase
 public:
   static ezCVarBool cvar_AppVSync;
   static ezCVarBool cvar_AppShowFPS;
+  static ezCVarBool cvar_AppParallelWorldUpdate;
 
 public:
   using SUPER = ezGameApplicationBase;
@@ -70,6 +71,16 @@ public:
   /// \brief Returns the project path that was given to the constructor (or modified by an overridden implementation).
   ezStringView GetAppProjectPath() const { return m_sAppProjectPath; }
 
+  /// \brief Adds a world that is updated every frame, even though no view renders it.
+  ///
+  /// This is meant for headless setups like a dedicated server that simulates many independent worlds in one process.
+  /// Worlds that are rendered by a main view are updated automatically and don't need to be added here.
+  /// All worlds are updated concurrently if multithreaded rendering or 'App.ParallelWorldUpdate' is enabled, see ezWorld::UpdateWorlds().
+  void AddWorldToUpdate(ezWorld* pWorld);
+
+  /// \brief Removes a world that was previously added with AddWorldToUpdate(). Must be called before the world is destroyed.
+  void RemoveWorldToUpdate(ezWorld* pWorld);
+
 protected:
   virtual void Init_ConfigureInput() override;
   virtual void Init_ConfigureAssetManagement() override;
@@ -97,6 +108,7 @@ protected:
 
   void UpdateWorldsAndExtractViews();
   ezSharedPtr<ezDelegateTask<void>> m_pUpdateTask;
+  ezHybridArray<ezWorld*, 4> m_AdditionalWorldsToUpdate;
 
   static ezDelegate<ezGALDevice*(const ezGALDeviceCreationDescription&)> s_DefaultDeviceCreator;
 
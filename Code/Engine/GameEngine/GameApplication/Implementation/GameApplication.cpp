@@ -33,6 +33,7 @@ ezDelegate<ezGALDevice*(const ezGALDeviceCreationDescription&)> ezGameApplicatio
 
 ezCVarBool ezGameApplication::cvar_AppVSync("App.VSync", false, ezCVarFlags::Save, "Enables V-Sync");
 ezCVarBool ezGameApplication::cvar_AppShowFPS("App.ShowFPS", false, ezCVarFlags::Save, "Show frames per second counter");
+ezCVarBool ezGameApplication::cvar_AppParallelWorldUpdate("App.ParallelWorldUpdate", false, ezCVarFlags::Default, "Update all worlds concurrently on the task system, even without multithreaded rendering");
 
 ezGameApplication::ezGameApplication(const char* szAppName, const char* szProjectPath /*= nullptr*/)
   : ezGameApplicationBase(szAppName)
@@ -221,26 +222,15 @@ void ezGameApplication::UpdateWorldsAndExtractViews()
     }
   }
 
-  if (ezRenderWorld::GetUseMultithreadedRendering())
+  for (ezWorld* pWorld : m_AdditionalWorldsToUpdate)
   {
-    ezTaskGroupID updateWorldsTaskID = ezTaskSystem::CreateTaskGroup(ezTaskPriority::EarlyThisFrame);
-    for (ezUInt32 i = 0; i < worldsToUpdate.GetCount(); ++i)
+    if (!worldsToUpdate.Contains(pWorld))
     {
-      ezTaskSystem::AddTaskToGroup(updateWorldsTaskID, worldsToUpdate[i]->GetUpdateTask());
+      worldsToUpdate.PushBack(pWorld);
     }
-    ezTaskSystem::StartTaskGroup(updateWorldsTaskID);
-    ezTaskSystem::WaitForGroup(updateWorldsTaskID);
   }
-  else
-  {
-    for (ezUInt32 i = 0; i < worldsToUpdate.GetCount(); ++i)
-    {
-      ezWorld* pWorld = worldsToUpdate[i];
-      EZ_LOCK(pWorld->GetWriteMarker());
 
-      pWorld->Update();
-    }
-  }
+  ezWorld::UpdateWorlds(worldsToUpdate, ezRenderWorld::GetUseMultithreadedRendering() || cvar_AppParallelWorldUpdate);
 
   Run_AfterWorldUpdate();
 
@@ -250,6 +240,19 @@ void ezGameApplication::UpdateWorldsAndExtractViews()
   ezRenderWorld::ExtractMainViews();
 }
 
+void ezGameApplication::AddWorldToUpdate(ezWorld* pWorld)
+{
+  if (!m_AdditionalWorldsToUpdate.Contains(pWorld))
+  {
+    m_AdditionalWorldsToUpdate.PushBack(pWorld);
+  }
+}
+
+void ezGameApplication::RemoveWorldToUpdate(ezWorld* pWorld)
+{
+  m_AdditionalWorldsToUpdate.RemoveAndCopy(pWorld);
+}
+
 void ezGameApplication::RenderFps()
 {
   EZ_PROFILE_SCOPE("RenderFps");
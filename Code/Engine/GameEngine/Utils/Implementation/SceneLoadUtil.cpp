@@ -1,6 +1,7 @@
 #include <GameEngine/GameEnginePCH.h>
 
 #include <Core/Collection/CollectionResource.h>
+#include <Foundation/Communication/GlobalEvent.h>
 #include <Foundation/Utilities/AssetFileHeader.h>
 #include <GameEngine/GameApplication/GameApplication.h>
 #include <GameEngine/Utils/SceneLoadUtil.h>
@@ -90,6 +91,29 @@ void ezSceneLoadUtility::LoadingFailed(const ezFormatString& reason)
   m_sFailureReason = reason.GetText(tmp);
 }
 
+void ezSceneLoadUtility::BroadcastPrefetchFiles(const ezCollectionResource& collection)
+{
+  EZ_PROFILE_SCOPE("BroadcastPrefetchFiles");
+
+  const auto& resources = collection.GetDescriptor().m_Resources;
+
+  ezVariantArray files;
+  files.Reserve(resources.GetCount() + 1);
+  files.PushBack(m_sRedirectedFile);
+
+  ezStringBuilder sFile;
+  for (const ezCollectionEntry& entry : resources)
+  {
+    // collections usually reference assets by GUID, the data directories know which file that is
+    if (ezFileSystem::ResolveAssetRedirection(entry.m_sResourceID, sFile))
+    {
+      files.PushBack(ezString(sFile));
+    }
+  }
+
+  ezGlobalEvent::Broadcast("SceneLoading_PrefetchFiles", files);
+}
+
 void ezSceneLoadUtility::TickSceneLoading()
 {
   switch (m_LoadingState)
@@ -115,6 +139,12 @@ void ezSceneLoadUtility::TickSceneLoading()
 
       if (pCollection.GetAcquireResult() == ezResourceAcquireResult::Final)
       {
+        if (!m_bBroadcastPrefetchFiles)
+        {
+          m_bBroadcastPrefetchFiles = true;
+          BroadcastPrefetchFiles(*pCollection.GetPointer());
+        }
+
         if (pCollection->PreloadResources())
         {
           EZ_REPORT_FAILURE("Failed to start preloading all resources.");
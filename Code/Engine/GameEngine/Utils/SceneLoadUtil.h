@@ -40,6 +40,9 @@ public:
   ///
   /// Using a collection will make loading in the background much smoother. Without it, most assets will be loaded once the scene gets updated
   /// for the first time, resulting in very long delays.
+  ///
+  /// Once the collection is available, the global event 'SceneLoading_PrefetchFiles' is broadcast with the scene file and the files of all
+  /// collection entries as an ezVariantArray of strings. This allows plugins that serve files over the network (e.g. Fileserve) to fetch them in bulk.
   void StartSceneLoading(ezStringView sSceneFile, ezStringView sPreloadCollectionFile);
 
   /// \brief This has to be called periodically (usually once per frame) to progress the scene loading.
@@ -60,6 +63,7 @@ public:
 
 private:
   void LoadingFailed(const ezFormatString& reason);
+  void BroadcastPrefetchFiles(const ezCollectionResource& collection);
 
   LoadingState m_LoadingState = LoadingState::NotStarted;
   float m_fLoadingProgress = 0.0f;
@@ -68,6 +72,7 @@ private:
   ezString m_sRequestedFile;
   ezString m_sRedirectedFile;
   ezCollectionResourceHandle m_hPreloadCollection;
+  bool m_bBroadcastPrefetchFiles = false;
   ezFileReader m_FileReader;
   ezWorldReader m_WorldReader;
   ezUniquePtr<ezWorld> m_pWorld;
@@ -0,0 +1,155 @@
+#include <RendererCore/RendererCorePCH.h>
+
+#include <RendererCore/Lights/ShadowAtlas.h>
+
+void ezShadowAtlasAllocator::Reset(ezUInt32 uiAtlasSize)
+{
+  EZ_ASSERT_DEBUG(ezMath::IsPowerOf2(uiAtlasSize), "Size must be power of 2");
+
+  m_uiAtlasSize = uiAtlasSize;
+
+  m_Cells.Clear();
+
+  Cell& rootCell = m_Cells.ExpandAndGetRef();
+  rootCell.m_Rect = ezRectU32(0, 0, uiAtlasSize, uiAtlasSize);
+  rootCell.m_uiFirstChildIndex = ezInvalidIndex;
+  rootCell.m_bUsed = false;
+}
+
+ezRectU32 ezShadowAtlasAllocator::Allocate(ezUInt32 uiShadowMapSize)
+{
+  EZ_ASSERT_DEBUG(ezMath::IsPowerOf2(uiShadowMapSize), "Size must be power of 2");
+
+  if (Cell* pCell = Insert(0, uiShadowMapSize))
+  {
+    EZ_ASSERT_DEBUG(pCell->IsLeaf() && pCell->m_bUsed, "Implementation error");
+    return pCell->m_Rect;
+  }
+
+  return ezRectU32(0, 0, 0, 0);
+}
+
+bool ezShadowAtlasAllocator::AllocateAt(const ezRectU32& rect)
+{
+  if (!rect.HasNonZeroArea() || rect.width != rect.height || !ezMath::IsPowerOf2(rect.width) || rect.x % rect.width != 0 || rect.y % rect.height != 0 || rect.Right() > m_uiAtlasSize || rect.Bottom() > m_uiAtlasSize)
+    return false;
+
+  return InsertAt(0, rect) != nullptr;
+}
+
+ezShadowAtlasAllocator::Cell* ezShadowAtlasAllocator::Insert(ezUInt32 uiCellIndex, ezUInt32 uiShadowMapSize)
+{
+  Cell* pCell = &m_Cells[uiCellIndex];
+
+  if (!pCell->IsLeaf())
+  {
+    const ezUInt32 uiFirstChildIndex = pCell->m_uiFirstChildIndex;
+    for (ezUInt32 i = 0; i < 4; ++i)
+    {
+      if (Cell* pNewCell = Insert(uiFirstChildIndex + i, uiShadowMapSize))
+      {
+        return pNewCell;
+      }
+    }
+
+    return nullptr;
+  }
+
+  if (pCell->m_bUsed)
+    return nullptr;
+
+  if (pCell->m_Rect.width < uiShadowMapSize || pCell->m_Rect.height < uiShadowMapSize)
+    return nullptr;
+
+  if (pCell->m_Rect.width == uiShadowMapSize && pCell->m_Rect.height == uiShadowMapSize)
+  {
+    pCell->m_bUsed = true;
+    return pCell;
+  }
+
+  Split(uiCellIndex);
+
+  return Insert(m_Cells[uiCellIndex].m_uiFirstChildIndex, uiShadowMapSize);
+}
+
+ezShadowAtlasAllocator::Cell* ezShadowAtlasAllocator::InsertAt(ezUInt32 uiCellIndex, const ezRectU32& rect)
+{
+  Cell* pCell = &m_Cells[uiCellIndex];
+
+  if (pCell->IsLeaf())
+  {
+    if (pCell->m_bUsed)
+      return nullptr;
+
+    if (pCell->m_Rect == rect)
+    {
+      pCell->m_bUsed = true;
+      return pCell;
+    }
+
+    Split(uiCellIndex);
+    pCell = &m_Cells[uiCellIndex];
+  }
+  else if (pCell->m_Rect.width <= rect.width)
+  {
+    // parts of the rect are already used
+    return nullptr;
+  }
+
+  // descend into the quadrant that contains the rect
+  const ezUInt32 uiHalfSize = pCell->m_Rect.width / 2;
+  const ezUInt32 uiQuadrant = (rect.x >= pCell->m_Rect.x + uiHalfSize ? 1 : 0) + (rect.y >= pCell->m_Rect.y + uiHalfSize ? 2 : 0);
+
+  return InsertAt(pCell->m_uiFirstChildIndex + uiQuadrant, rect);
+}
+
+void ezShadowAtlasAllocator::Split(ezUInt32 uiCellIndex)
+{
+  const ezRectU32 rect = m_Cells[uiCellIndex].m_Rect;
+  const ezUInt32 x = rect.x;
+  const ezUInt32 y = rect.y;
+  const ezUInt32 w = rect.width / 2;
+  const ezUInt32 h = rect.height / 2;
+
+  const ezUInt32 uiFirstChildIndex = m_Cells.GetCount();
+  const ezRectU32 childRects[4] = {ezRectU32(x, y, w, h), ezRectU32(x + w, y, w, h), ezRectU32(x, y + h, w, h), ezRectU32(x + w, y + h, w, h)};
+
+  for (ezUInt32 i = 0; i < 4; ++i)
+  {
+    Cell& childCell = m_Cells.ExpandAndGetRef();
+    childCell.m_Rect = childRects[i];
+    childCell.m_uiFirstChildIndex = ezInvalidIndex;
+    childCell.m_bUsed = false;
+  }
+
+  m_Cells[uiCellIndex].m_uiFirstChildIndex = uiFirstChildIndex;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+ezShadowViewCache::Mode ezShadowViewCache::Update(ezUInt64 uiSignature)
+{
+  if (uiSignature != m_uiSignature)
+  {
+    m_uiSignature = uiSignature;
+    m_Mode = Mode::RenderAll;
+  }
+  else if (m_Mode == Mode::RenderAll)
+  {
+    m_Mode = Mode::RenderAllAndFillCache;
+  }
+  else
+  {
+    m_Mode = Mode::UseCache;
+  }
+
+  return m_Mode;
+}
+
+void ezShadowViewCache::Invalidate()
+{
+  m_Mode = Mode::RenderAll;
+}
+
+
+EZ_STATICLINK_FILE(RendererCore, RendererCore_Lights_Implementation_ShadowAtlas);
@@ -2,13 +2,17 @@
 
 #include <Core/GameApplication/GameApplicationBase.h>
 #include <Core/Graphics/Camera.h>
+#include <Core/World/SpatialSystem.h>
+#include <Foundation/Algorithm/HashStream.h>
 #include <Foundation/Configuration/CVar.h>
 #include <Foundation/Configuration/Startup.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Utilities/Stats.h>
 #include <RendererCore/Debug/DebugRenderer.h>
 #include <RendererCore/Lights/DirectionalLightComponent.h>
 #include <RendererCore/Lights/Implementation/ShadowPool.h>
 #include <RendererCore/Lights/PointLightComponent.h>
+#include <RendererCore/Lights/ShadowAtlas.h>
 #include <RendererCore/Lights/SpotLightComponent.h>
 #include <RendererCore/Pipeline/View.h>
 #include <RendererCore/RenderWorld/RenderWorld.h>
@@ -52,6 +56,8 @@ EZ_RENDERERCORE_DLL ezCVarInt cvar_RenderingShadowsAtlasSize("Rendering.Shadows.
 EZ_RENDERERCORE_DLL ezCVarInt cvar_RenderingShadowsMaxShadowMapSize("Rendering.Shadows.MaxShadowMapSize", 1024, ezCVarFlags::RequiresDelayedSync, "The max shadow map size used.");
 EZ_RENDERERCORE_DLL ezCVarInt cvar_RenderingShadowsMinShadowMapSize("Rendering.Shadows.MinShadowMapSize", 64, ezCVarFlags::RequiresDelayedSync, "The min shadow map size used.");
 
+ezCVarBool cvar_RenderingShadowsCaching("Rendering.Shadows.Caching", true, ezCVarFlags::Default, "Reuses the static shadow casters of unchanged shadow maps from the previous frame and only renders the dynamic ones.");
+
 static ezUInt32 s_uiLastConfigModification = 0;
 static float s_fFadeOutScaleStart = 0.0f;
 static float s_fFadeOutScaleEnd = 0.0f;
@@ -62,9 +68,20 @@ struct ShadowView
   ezCamera m_Camera;
 };
 
+struct LightAndRefView
+{
+  EZ_DECLARE_POD_TYPE();
+
+  const ezLightComponent* m_pLight;
+  const ezView* m_pReferenceView;
+};
+
 struct ShadowData
 {
+  LightAndRefView m_Key;
   ezHybridArray<ezViewHandle, 6> m_Views;
+  ezHybridArray<ezViewHandle, 6> m_CacheViews; // only valid for views that fill the cache in this frame
+  ezHybridArray<ezShadowViewCache, 6> m_ViewCaches;
   ezUInt32 m_uiType;
   float m_fShadowMapScale;
   float m_fPenumbraSize;
@@ -74,14 +91,13 @@ struct ShadowData
   float m_fMinRange;
   float m_fActualRange;
   ezUInt32 m_uiPackedDataOffset; // in 16 bytes steps
-};
 
-struct LightAndRefView
-{
-  EZ_DECLARE_POD_TYPE();
-
-  const ezLightComponent* m_pLight;
-  const ezView* m_pReferenceView;
+  // Atlas placement, only valid during EndExtraction
+  ezUInt32 m_uiShadowMapSize;
+  float m_fFadeOutScaleStart;
+  float m_fFadeOutScaleEnd;
+  bool m_bInvalidateCache;
+  ezHybridArray<ezRectU32, 6> m_AtlasRects;
 };
 
 struct SortedShadowData
@@ -102,93 +118,39 @@ struct SortedShadowData
 
 static ezDynamicArray<SortedShadowData> s_SortedShadowData;
 
-struct AtlasCell
-{
-  EZ_DECLARE_POD_TYPE();
-
-  EZ_ALWAYS_INLINE AtlasCell()
-    : m_Rect(0, 0, 0, 0)
-  {
-    m_uiChildIndices[0] = m_uiChildIndices[1] = m_uiChildIndices[2] = m_uiChildIndices[3] = 0xFFFF;
-    m_uiDataIndex = ezInvalidIndex;
-  }
-
-  EZ_ALWAYS_INLINE bool IsLeaf() const
-  {
-    return m_uiChildIndices[0] == 0xFFFF && m_uiChildIndices[1] == 0xFFFF && m_uiChildIndices[2] == 0xFFFF && m_uiChildIndices[3] == 0xFFFF;
-  }
-
-  ezRectU32 m_Rect;
-  ezUInt16 m_uiChildIndices[4];
-  ezUInt32 m_uiDataIndex;
-};
-
-static ezDeque<AtlasCell> s_AtlasCells;
+static ezShadowAtlasAllocator s_AtlasAllocator;
 
-static AtlasCell* Insert(AtlasCell* pCell, ezUInt32 uiShadowMapSize, ezUInt32 uiDataIndex)
+static ezRectU32 FindAtlasRect(ezUInt32 uiShadowMapSize, const ezRectU32& previousRect)
 {
-  if (!pCell->IsLeaf())
-  {
-    for (ezUInt32 i = 0; i < 4; ++i)
-    {
-      AtlasCell* pChildCell = &s_AtlasCells[pCell->m_uiChildIndices[i]];
-      if (AtlasCell* pNewCell = Insert(pChildCell, uiShadowMapSize, uiDataIndex))
-      {
-        return pNewCell;
-      }
-    }
-
-    return nullptr;
-  }
-  else
-  {
-    if (pCell->m_uiDataIndex != ezInvalidIndex)
-      return nullptr;
+  // prefer the previous location, that keeps the atlas layout stable across frames
+  if (previousRect.width == uiShadowMapSize && s_AtlasAllocator.AllocateAt(previousRect))
+    return previousRect;
 
-    if (pCell->m_Rect.width < uiShadowMapSize || pCell->m_Rect.height < uiShadowMapSize)
-      return nullptr;
+  ezRectU32 atlasRect = s_AtlasAllocator.Allocate(uiShadowMapSize);
+  if (atlasRect.HasNonZeroArea())
+    return atlasRect;
 
-    if (pCell->m_Rect.width == uiShadowMapSize && pCell->m_Rect.height == uiShadowMapSize)
-    {
-      pCell->m_uiDataIndex = uiDataIndex;
-      return pCell;
-    }
-
-    // Split
-    ezUInt32 x = pCell->m_Rect.x;
-    ezUInt32 y = pCell->m_Rect.y;
-    ezUInt32 w = pCell->m_Rect.width / 2;
-    ezUInt32 h = pCell->m_Rect.height / 2;
-
-    ezUInt32 uiCellIndex = s_AtlasCells.GetCount();
-    s_AtlasCells.ExpandAndGetRef().m_Rect = ezRectU32(x, y, w, h);
-    s_AtlasCells.ExpandAndGetRef().m_Rect = ezRectU32(x + w, y, w, h);
-    s_AtlasCells.ExpandAndGetRef().m_Rect = ezRectU32(x, y + h, w, h);
-    s_AtlasCells.ExpandAndGetRef().m_Rect = ezRectU32(x + w, y + h, w, h);
-
-    for (ezUInt32 i = 0; i < 4; ++i)
-    {
-      pCell->m_uiChildIndices[i] = static_cast<ezUInt16>(uiCellIndex + i);
-    }
-
-    AtlasCell* pChildCell = &s_AtlasCells[pCell->m_uiChildIndices[0]];
-    return Insert(pChildCell, uiShadowMapSize, uiDataIndex);
-  }
+  ezLog::Warning("Shadow Pool is full. Not enough space for a {0}x{0} shadow map. The light will have no shadow.", uiShadowMapSize);
+  return ezRectU32(0, 0, 0, 0);
 }
 
-static ezRectU32 FindAtlasRect(ezUInt32 uiShadowMapSize, ezUInt32 uiDataIndex)
+static void ComputeShadowMapSize(ShadowData& ref_shadowData)
 {
-  EZ_ASSERT_DEBUG(ezMath::IsPowerOf2(uiShadowMapSize), "Size must be power of 2");
+  ezUInt32 uiShadowMapSize = cvar_RenderingShadowsMaxShadowMapSize;
+  float fadeOutStart = s_fFadeOutScaleStart;
+  float fadeOutEnd = s_fFadeOutScaleEnd;
 
-  AtlasCell* pCell = Insert(&s_AtlasCells[0], uiShadowMapSize, uiDataIndex);
-  if (pCell != nullptr)
+  // point lights use a lot of atlas space thus we cut the shadow map size in half
+  if (ref_shadowData.m_uiType == LIGHT_TYPE_POINT)
   {
-    EZ_ASSERT_DEBUG(pCell->IsLeaf() && pCell->m_uiDataIndex == uiDataIndex, "Implementation error");
-    return pCell->m_Rect;
+    uiShadowMapSize /= 2;
+    fadeOutStart *= 2.0f;
+    fadeOutEnd *= 2.0f;
   }
 
-  ezLog::Warning("Shadow Pool is full. Not enough space for a {0}x{0} shadow map. The light will have no shadow.", uiShadowMapSize);
-  return ezRectU32(0, 0, 0, 0);
+  ref_shadowData.m_uiShadowMapSize = ezMath::PowerOfTwo_Ceil((ezUInt32)(uiShadowMapSize * ezMath::Clamp(ref_shadowData.m_fShadowMapScale, fadeOutStart, 1.0f)));
+  ref_shadowData.m_fFadeOutScaleStart = fadeOutStart;
+  ref_shadowData.m_fFadeOutScaleEnd = fadeOutEnd;
 }
 
 static float AddSafeBorder(ezAngle fov, float fPenumbraSize)
@@ -239,6 +201,11 @@ struct ezShadowPool::Data
       ezRenderWorld::DeleteView(shadowView.m_hView);
     }
 
+    for (auto& shadowView : m_CacheViews)
+    {
+      ezRenderWorld::DeleteView(shadowView.m_hView);
+    }
+
     ezGALDevice* pDevice = ezGALDevice::GetDefaultDevice();
     if (!m_hShadowAtlasTexture.IsInvalidated())
     {
@@ -246,6 +213,12 @@ struct ezShadowPool::Data
       m_hShadowAtlasTexture.Invalidate();
     }
 
+    if (!m_hShadowCacheTexture.IsInvalidated())
+    {
+      pDevice->DestroyTexture(m_hShadowCacheTexture);
+      m_hShadowCacheTexture.Invalidate();
+    }
+
     if (!m_hShadowDataBuffer.IsInvalidated())
     {
       pDevice->DestroyBuffer(m_hShadowDataBuffer);
@@ -317,6 +290,18 @@ struct ezShadowPool::Data
     }
   }
 
+  void CreateShadowCacheTexture()
+  {
+    if (m_hShadowCacheTexture.IsInvalidated())
+    {
+      // same layout as the atlas, so that shadow maps can be copied between both at the same location
+      ezGALTextureCreationDescription desc;
+      desc.SetAsRenderTarget(cvar_RenderingShadowsAtlasSize, cvar_RenderingShadowsAtlasSize, ezGALResourceFormat::D16);
+
+      m_hShadowCacheTexture = ezGALDevice::GetDefaultDevice()->CreateTexture(desc);
+    }
+  }
+
   void CreateShadowDataBuffer()
   {
     if (m_hShadowDataBuffer.IsInvalidated())
@@ -331,18 +316,23 @@ struct ezShadowPool::Data
     }
   }
 
-  ezViewHandle CreateShadowView()
+  ezViewHandle CreateShadowView(bool bCacheView)
   {
     CreateShadowAtlasTexture();
     CreateShadowDataBuffer();
 
+    if (bCacheView)
+    {
+      CreateShadowCacheTexture();
+    }
+
     ezView* pView = nullptr;
     ezViewHandle hView = ezRenderWorld::CreateView("Unknown", pView);
 
     pView->SetCameraUsageHint(ezCameraUsageHint::Shadow);
 
     ezGALRenderTargets renderTargets;
-    renderTargets.m_hDSTarget = m_hShadowAtlasTexture;
+    renderTargets.m_hDSTarget = bCacheView ? m_hShadowCacheTexture : m_hShadowAtlasTexture;
     pView->SetRenderTargets(renderTargets);
 
     EZ_ASSERT_DEV(m_ShadowViewsMutex.IsLocked(), "m_ShadowViewsMutex must be locked at this point.");
@@ -365,26 +355,118 @@ struct ezShadowPool::Data
     return hView;
   }
 
-  ShadowView& GetShadowView(ezView*& out_pView)
+  ShadowView& GetShadowView(ezView*& out_pView, bool bCacheView = false)
   {
     EZ_LOCK(m_ShadowViewsMutex);
 
-    if (m_uiUsedViews == m_ShadowViews.GetCount())
+    ezDeque<ShadowView>& views = bCacheView ? m_CacheViews : m_ShadowViews;
+    ezUInt32& uiUsedViews = bCacheView ? m_uiUsedCacheViews : m_uiUsedViews;
+
+    if (uiUsedViews == views.GetCount())
     {
-      m_ShadowViews.ExpandAndGetRef().m_hView = CreateShadowView();
+      views.ExpandAndGetRef().m_hView = CreateShadowView(bCacheView);
     }
 
-    auto& shadowView = m_ShadowViews[m_uiUsedViews];
+    auto& shadowView = views[uiUsedViews];
     if (ezRenderWorld::TryGetView(shadowView.m_hView, out_pView))
     {
       out_pView->SetCamera(&shadowView.m_Camera);
       out_pView->SetLodCamera(nullptr);
+      out_pView->SetSpatialDataCategoryBitmask(ezDefaultSpatialDataCategories::RenderStatic.GetBitmask() | ezDefaultSpatialDataCategories::RenderDynamic.GetBitmask());
     }
 
-    m_uiUsedViews++;
+    uiUsedViews++;
     return shadowView;
   }
 
+  /// Everything that the static shadow casters of a shadow view depend on.
+  static ezUInt64 ComputeShadowViewSignature(const ShadowData& shadowData, const ezView& view)
+  {
+    const ezWorld* pWorld = view.GetWorld();
+    const ezCamera* pCamera = view.GetCamera();
+
+    ezHashStreamWriter64 stream;
+    stream.WriteBytes(&pWorld, sizeof(pWorld)).AssertSuccess();
+    stream << pCamera->GetPosition();
+    stream << pCamera->GetDirForwards();
+    stream << pCamera->GetDirUp();
+    stream << static_cast<ezUInt32>(pCamera->GetCameraMode());
+    stream << pCamera->GetFovOrDim();
+    stream << pCamera->GetNearPlane();
+    stream << pCamera->GetFarPlane();
+    stream << shadowData.m_fPenumbraSize;
+    stream << shadowData.m_fSlopeBias;
+    stream << shadowData.m_fConstantBias;
+
+    // the LOD selection of the static objects depends on the LOD camera
+    if (const ezCamera* pLodCamera = view.GetLodCamera())
+    {
+      stream << pLodCamera->GetPosition();
+    }
+
+    for (const ezTag& tag : view.m_ExcludeTags)
+    {
+      stream << tag.GetTagString();
+    }
+
+    ezFrustum frustum;
+    view.ComputeCullingFrustum(frustum);
+
+    ezVec3 corners[ezFrustum::FrustumCorner::CORNER_COUNT];
+    ezBoundingBox frustumBox = ezBoundingBox::MakeFromMinMax(ezVec3(-1000000.0f), ezVec3(1000000.0f));
+    if (frustum.ComputeCornerPoints(corners).Succeeded())
+    {
+      frustumBox = ezBoundingBox::MakeFromPoints(corners, ezFrustum::FrustumCorner::CORNER_COUNT);
+    }
+
+    {
+      EZ_LOCK(pWorld->GetReadMarker());
+      stream << pWorld->GetSpatialSystem()->GetChangeCounter(frustumBox, ezDefaultSpatialDataCategories::RenderStatic.GetBitmask());
+    }
+
+    // the spatial system doesn't know about changed meshes or materials, these are tracked by the render data cache
+    stream << ezRenderWorld::GetStaticRenderDataVersion(pWorld);
+
+    return stream.GetHashValue();
+  }
+
+  /// Decides whether the static shadow casters of the given view are rendered or taken from the cache.
+  /// Must be called after the camera of the view has been set up and before the view is added for rendering.
+  void UpdateViewCache(ShadowData& ref_shadowData, ezUInt32 uiViewIndex, ezView* pView)
+  {
+    const ezUInt32 uiStaticBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask();
+    const ezUInt32 uiDynamicBitmask = ezDefaultSpatialDataCategories::RenderDynamic.GetBitmask();
+
+    ezShadowViewCache& viewCache = ref_shadowData.m_ViewCaches[uiViewIndex];
+    if (!m_bCachingEnabled)
+    {
+      viewCache = ezShadowViewCache();
+      return;
+    }
+
+    const ezShadowViewCache::Mode mode = viewCache.Update(ComputeShadowViewSignature(ref_shadowData, *pView));
+    if (mode == ezShadowViewCache::Mode::UseCache)
+    {
+      pView->SetSpatialDataCategoryBitmask(uiDynamicBitmask);
+    }
+    else if (mode == ezShadowViewCache::Mode::RenderAllAndFillCache)
+    {
+      ezView* pCacheView = nullptr;
+      ShadowView& cacheView = GetShadowView(pCacheView, true);
+      ref_shadowData.m_CacheViews[uiViewIndex] = cacheView.m_hView;
+
+      cacheView.m_Camera = *pView->GetCamera();
+
+      pCacheView->SetName("ShadowCacheView");
+      pCacheView->SetWorld(pView->GetWorld());
+      pCacheView->SetLodCamera(pView->GetLodCamera());
+      pCacheView->m_ExcludeTags = pView->m_ExcludeTags;
+      pCacheView->SetSpatialDataCategoryBitmask(uiStaticBitmask);
+
+      ezRenderWorld::AddViewToRender(cacheView.m_hView);
+    }
+  }
+
   bool GetDataForExtraction(const ezLightComponent* pLight, const ezView* pReferenceView, float fShadowMapScale, ezUInt32 uiPackedDataSizeInBytes, ShadowData*& out_pData)
   {
     EZ_LOCK(m_ShadowDataMutex);
@@ -402,6 +484,7 @@ struct ezShadowPool::Data
     m_ShadowData.EnsureCount(m_uiUsedShadowData + 1);
 
     out_pData = &m_ShadowData[m_uiUsedShadowData];
+    out_pData->m_Key = key;
     out_pData->m_fShadowMapScale = fShadowMapScale;
     out_pData->m_fPenumbraSize = pLight->GetPenumbraSize();
     out_pData->m_fSlopeBias = pLight->GetSlopeBias() * 100.0f;       // map from user friendly range to real range
@@ -411,6 +494,13 @@ struct ezShadowPool::Data
     out_pData->m_fActualRange = 1.0f;
     out_pData->m_uiPackedDataOffset = m_uiUsedPackedShadowData;
 
+    if (!m_ShadowCache.TryGetValue(key, out_pData->m_ViewCaches))
+    {
+      out_pData->m_ViewCaches.Clear();
+    }
+
+    out_pData->m_CacheViews.Clear();
+
     m_LightToShadowDataTable.Insert(key, m_uiUsedShadowData);
 
     ++m_uiUsedShadowData;
@@ -422,6 +512,7 @@ struct ezShadowPool::Data
   void Clear()
   {
     m_uiUsedViews = 0;
+    m_uiUsedCacheViews = 0;
     m_uiUsedShadowData = 0;
 
     m_LightToShadowDataTable.Clear();
@@ -432,6 +523,8 @@ struct ezShadowPool::Data
   ezMutex m_ShadowViewsMutex;
   ezDeque<ShadowView> m_ShadowViews;
   ezUInt32 m_uiUsedViews = 0;
+  ezDeque<ShadowView> m_CacheViews;
+  ezUInt32 m_uiUsedCacheViews = 0;
 
   ezMutex m_ShadowDataMutex;
   ezDeque<ShadowData> m_ShadowData;
@@ -443,6 +536,18 @@ struct ezShadowPool::Data
 
   ezGALTextureHandle m_hShadowAtlasTexture;
   ezGALBufferHandle m_hShadowDataBuffer;
+
+  // Static shadow casters of the shadow maps that were not changed recently, at the same location as in the atlas.
+  ezGALTextureHandle m_hShadowCacheTexture;
+  ezHashTable<LightAndRefView, ezHybridArray<ezShadowViewCache, 6>> m_ShadowCache;
+  bool m_bCachingEnabled = false;
+
+  // Filled during extraction, executed before the shadow views are rendered
+  ezDynamicArray<ezRectU32> m_CacheToAtlasCopies[2]; // restores the static casters of cached shadow maps
+  ezDynamicArray<ezRectU32> m_AtlasToCacheCopies[2]; // clears the cache for shadow maps that are cached in this frame, the atlas was just cleared
+
+  ezUInt32 m_uiNumCachedViews = 0;
+  ezUInt32 m_uiNumCacheUpdates = 0;
 };
 
 //////////////////////////////////////////////////////////////////////////
@@ -476,6 +581,8 @@ ezUInt32 ezShadowPool::AddDirectionalLight(const ezDirectionalLightComponent* pD
   pData->m_fFadeOutStart = pDirLight->GetFadeOutStart();
   pData->m_fMinRange = pDirLight->GetMinShadowRange();
   pData->m_Views.SetCount(uiNumCascades);
+  pData->m_ViewCaches.SetCount(uiNumCascades);
+  pData->m_CacheViews.SetCount(uiNumCascades);
 
   // determine cascade ranges
   float fNearPlane = pReferenceCamera->GetNearPlane();
@@ -586,6 +693,8 @@ ezUInt32 ezShadowPool::AddDirectionalLight(const ezDirectionalLightComponent* pD
 #endif
     }
 
+    s_pData->UpdateViewCache(*pData, i, pView);
+
     ezRenderWorld::AddViewToRender(shadowView.m_hView);
   }
 
@@ -610,6 +719,8 @@ ezUInt32 ezShadowPool::AddPointLight(const ezPointLightComponent* pPointLight, f
 
   pData->m_uiType = LIGHT_TYPE_POINT;
   pData->m_Views.SetCount(6);
+  pData->m_ViewCaches.SetCount(6);
+  pData->m_CacheViews.SetCount(6);
 
   ezVec3 faceDirs[6] = {
     ezVec3(1.0f, 0.0f, 0.0f),
@@ -661,6 +772,8 @@ ezUInt32 ezShadowPool::AddPointLight(const ezPointLightComponent* pPointLight, f
       camera.SetCameraMode(ezCameraMode::PerspectiveFixedFovX, fFov, fNearPlane, fFarPlane);
     }
 
+    s_pData->UpdateViewCache(*pData, i, pView);
+
     ezRenderWorld::AddViewToRender(shadowView.m_hView);
   }
 
@@ -685,6 +798,8 @@ ezUInt32 ezShadowPool::AddSpotLight(const ezSpotLightComponent* pSpotLight, floa
 
   pData->m_uiType = LIGHT_TYPE_SPOT;
   pData->m_Views.SetCount(1);
+  pData->m_ViewCaches.SetCount(1);
+  pData->m_CacheViews.SetCount(1);
 
   ezView* pView = nullptr;
   ShadowView& shadowView = s_pData->GetShadowView(pView);
@@ -713,6 +828,8 @@ ezUInt32 ezShadowPool::AddSpotLight(const ezSpotLightComponent* pSpotLight, floa
     camera.SetCameraMode(ezCameraMode::PerspectiveFixedFovX, fFov, fNearPlane, fFarPlane);
   }
 
+  s_pData->UpdateViewCache(*pData, 0, pView);
+
   ezRenderWorld::AddViewToRender(shadowView.m_hView);
 
   return pData->m_uiPackedDataOffset;
@@ -757,6 +874,14 @@ void ezShadowPool::OnEngineShutdown()
 // static
 void ezShadowPool::OnExtractionEvent(const ezRenderWorldExtractionEvent& e)
 {
+  if (e.m_Type == ezRenderWorldExtractionEvent::Type::BeginExtraction)
+  {
+    // D3D11 can't copy parts of the atlas, so caching is not possible there
+    ezGALDevice* pDevice = ezGALDevice::GetDefaultDevice();
+    s_pData->m_bCachingEnabled = cvar_RenderingShadowsCaching && pDevice->GetCapabilities().m_bSupportsDepthStencilRegionCopy;
+    return;
+  }
+
   if (e.m_Type != ezRenderWorldExtractionEvent::Type::EndExtraction)
     return;
 
@@ -766,8 +891,19 @@ void ezShadowPool::OnExtractionEvent(const ezRenderWorldExtractionEvent& e)
   auto& packedShadowData = s_pData->m_PackedShadowData[uiDataIndex];
   packedShadowData.SetCountUninitialized(s_pData->m_uiUsedPackedShadowData);
 
+  auto& cacheToAtlasCopies = s_pData->m_CacheToAtlasCopies[uiDataIndex];
+  auto& atlasToCacheCopies = s_pData->m_AtlasToCacheCopies[uiDataIndex];
+  cacheToAtlasCopies.Clear();
+  atlasToCacheCopies.Clear();
+
+  s_pData->m_uiNumCachedViews = 0;
+  s_pData->m_uiNumCacheUpdates = 0;
+
   if (s_pData->m_uiUsedShadowData == 0)
+  {
+    s_pData->m_ShadowCache.Clear();
     return;
+  }
 
   // Sort by shadow map scale
   s_SortedShadowData.Clear();
@@ -784,8 +920,57 @@ void ezShadowPool::OnExtractionEvent(const ezRenderWorldExtractionEvent& e)
   s_SortedShadowData.Sort();
 
   // Prepare atlas
-  s_AtlasCells.Clear();
-  s_AtlasCells.ExpandAndGetRef().m_Rect = ezRectU32(0, 0, cvar_RenderingShadowsAtlasSize, cvar_RenderingShadowsAtlasSize);
+  s_AtlasAllocator.Reset(cvar_RenderingShadowsAtlasSize);
+
+  // Shadow maps that use cached content must stay at their previous location, so they are placed first.
+  // All views of a light share one size, thus the light keeps its previous size as long as any of its views uses the cache.
+  for (auto& sorted : s_SortedShadowData)
+  {
+    auto& shadowData = s_pData->m_ShadowData[sorted.m_uiIndex];
+
+    ComputeShadowMapSize(shadowData);
+    shadowData.m_bInvalidateCache = false;
+    shadowData.m_AtlasRects.Clear();
+    shadowData.m_AtlasRects.SetCount(shadowData.m_Views.GetCount(), ezRectU32(0, 0, 0, 0));
+
+    ezUInt32 uiCachedSize = 0;
+    for (const ezShadowViewCache& viewCache : shadowData.m_ViewCaches)
+    {
+      if (viewCache.m_Mode == ezShadowViewCache::Mode::UseCache)
+      {
+        uiCachedSize = viewCache.m_AtlasRect.width;
+        break;
+      }
+    }
+
+    if (uiCachedSize == 0)
+      continue;
+
+    if (uiCachedSize != shadowData.m_uiShadowMapSize)
+    {
+      // render at the new size once the cache has been refilled
+      shadowData.m_uiShadowMapSize = uiCachedSize;
+      shadowData.m_bInvalidateCache = true;
+    }
+
+    for (ezUInt32 uiViewIndex = 0; uiViewIndex < shadowData.m_Views.GetCount(); ++uiViewIndex)
+    {
+      ezShadowViewCache& viewCache = shadowData.m_ViewCaches[uiViewIndex];
+      if (viewCache.m_Mode != ezShadowViewCache::Mode::UseCache)
+        continue;
+
+      if (viewCache.m_AtlasRect.width == uiCachedSize && s_AtlasAllocator.AllocateAt(viewCache.m_AtlasRect))
+      {
+        shadowData.m_AtlasRects[uiViewIndex] = viewCache.m_AtlasRect;
+      }
+      else
+      {
+        // The cached rects were disjoint in the last frame, so this should not happen.
+        // The shadow map misses its static casters in this frame and is refilled afterwards.
+        viewCache.Invalidate();
+      }
+    }
+  }
 
   float fAtlasInvWidth = 1.0f / cvar_RenderingShadowsAtlasSize;
   float fAtlasInvHeight = 1.0f / cvar_RenderingShadowsAtlasSize;
@@ -810,22 +995,11 @@ void ezShadowPool::OnExtractionEvent(const ezRenderWorldExtractionEvent& e)
 
   for (auto& sorted : s_SortedShadowData)
   {
-    ezUInt32 uiShadowDataIndex = sorted.m_uiIndex;
-    auto& shadowData = s_pData->m_ShadowData[uiShadowDataIndex];
-
-    ezUInt32 uiShadowMapSize = cvar_RenderingShadowsMaxShadowMapSize;
-    float fadeOutStart = s_fFadeOutScaleStart;
-    float fadeOutEnd = s_fFadeOutScaleEnd;
-
-    // point lights use a lot of atlas space thus we cut the shadow map size in half
-    if (shadowData.m_uiType == LIGHT_TYPE_POINT)
-    {
-      uiShadowMapSize /= 2;
-      fadeOutStart *= 2.0f;
-      fadeOutEnd *= 2.0f;
-    }
+    auto& shadowData = s_pData->m_ShadowData[sorted.m_uiIndex];
 
-    uiShadowMapSize = ezMath::PowerOfTwo_Ceil((ezUInt32)(uiShadowMapSize * ezMath::Clamp(shadowData.m_fShadowMapScale, fadeOutStart, 1.0f)));
+    const ezUInt32 uiShadowMapSize = shadowData.m_uiShadowMapSize;
+    const float fadeOutStart = shadowData.m_fFadeOutScaleStart;
+    const float fadeOutEnd = shadowData.m_fFadeOutScaleEnd;
 
     ezHybridArray<ezView*, 8> shadowViews;
     ezHybridArray<ezRectU32, 8> atlasRects;
@@ -839,10 +1013,47 @@ void ezShadowPool::OnExtractionEvent(const ezRenderWorldExtractionEvent& e)
 
       EZ_ASSERT_DEV(pShadowView != nullptr, "Implementation error");
 
-      ezRectU32 atlasRect = FindAtlasRect(uiShadowMapSize, uiShadowDataIndex);
+      ezShadowViewCache& viewCache = shadowData.m_ViewCaches[uiViewIndex];
+      const ezShadowViewCache::Mode cacheMode = viewCache.m_Mode;
+
+      ezRectU32 atlasRect = shadowData.m_AtlasRects[uiViewIndex];
+      if (!atlasRect.HasNonZeroArea())
+      {
+        atlasRect = FindAtlasRect(uiShadowMapSize, viewCache.m_AtlasRect);
+      }
+
       atlasRects.PushBack(atlasRect);
 
-      pShadowView->SetViewport(ezRectFloat((float)atlasRect.x, (float)atlasRect.y, (float)atlasRect.width, (float)atlasRect.height));
+      const ezRectFloat viewport((float)atlasRect.x, (float)atlasRect.y, (float)atlasRect.width, (float)atlasRect.height);
+      pShadowView->SetViewport(viewport);
+
+      // Update cache
+      {
+        if (cacheMode == ezShadowViewCache::Mode::UseCache)
+        {
+          cacheToAtlasCopies.PushBack(atlasRect);
+          ++s_pData->m_uiNumCachedViews;
+        }
+
+        ezView* pCacheView = nullptr;
+        if (ezRenderWorld::TryGetView(shadowData.m_CacheViews[uiViewIndex], pCacheView))
+        {
+          pCacheView->SetViewport(viewport);
+
+          if (atlasRect.HasNonZeroArea())
+          {
+            atlasToCacheCopies.PushBack(atlasRect);
+            ++s_pData->m_uiNumCacheUpdates;
+          }
+        }
+
+        viewCache.m_AtlasRect = atlasRect;
+
+        if (!atlasRect.HasNonZeroArea() || shadowData.m_bInvalidateCache)
+        {
+          viewCache.Invalidate();
+        }
+      }
 
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
       if (cvar_RenderingShadowsShowPoolStats)
@@ -1031,9 +1242,28 @@ void ezShadowPool::OnExtractionEvent(const ezRenderWorldExtractionEvent& e)
   if (cvar_RenderingShadowsShowPoolStats)
   {
     ezDebugRenderer::DrawInfoText(debugContext, ezDebugTextPlacement::TopLeft, "ShadowPoolStats", ezFmt("Atlas Utilization: {0}%%", ezArgF(100.0 * (double)uiUsedAtlasSize / uiTotalAtlasSize, 2)), ezColor::LightSteelBlue);
+    ezDebugRenderer::DrawInfoText(debugContext, ezDebugTextPlacement::TopLeft, "ShadowPoolStats", ezFmt("Cached: {0} of {1} shadow maps only render dynamic casters, {2} cache updates", s_pData->m_uiNumCachedViews, s_pData->m_uiUsedViews, s_pData->m_uiNumCacheUpdates), ezColor::LightSteelBlue);
   }
 #endif
 
+  // Only lights that were used in this frame keep their cache
+  s_pData->m_ShadowCache.Clear();
+
+  if (s_pData->m_bCachingEnabled)
+  {
+    for (ezUInt32 uiShadowDataIndex = 0; uiShadowDataIndex < s_pData->m_uiUsedShadowData; ++uiShadowDataIndex)
+    {
+      const auto& shadowData = s_pData->m_ShadowData[uiShadowDataIndex];
+      s_pData->m_ShadowCache.Insert(shadowData.m_Key, shadowData.m_ViewCaches);
+    }
+  }
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  ezStats::SetStat("Shadows/Shadow Maps", s_pData->m_uiUsedViews);
+  ezStats::SetStat("Shadows/Cached Shadow Maps", s_pData->m_uiNumCachedViews);
+  ezStats::SetStat("Shadows/Shadow Cache Updates", s_pData->m_uiNumCacheUpdates);
+#endif
+
   s_pData->Clear();
 }
 
@@ -1071,6 +1301,30 @@ void ezShadowPool::OnRenderEvent(const ezRenderWorldRenderEvent& e)
   }
 
   pCommandEncoder->EndRendering();
+
+  const auto& cacheToAtlasCopies = s_pData->m_CacheToAtlasCopies[uiDataIndex];
+  const auto& atlasToCacheCopies = s_pData->m_AtlasToCacheCopies[uiDataIndex];
+  if (!s_pData->m_hShadowCacheTexture.IsInvalidated() && (!cacheToAtlasCopies.IsEmpty() || !atlasToCacheCopies.IsEmpty()))
+  {
+    EZ_PROFILE_SCOPE("Shadow Cache Copies");
+
+    const ezGALTextureSubresource subresource;
+
+    // Restore the static casters of the cached shadow maps, the dynamic casters are rendered on top
+    for (const ezRectU32& rect : cacheToAtlasCopies)
+    {
+      const ezBoundingBoxu32 box = ezBoundingBoxu32::MakeFromMinMax(ezVec3U32(rect.x, rect.y, 0), ezVec3U32(rect.Right(), rect.Bottom(), 1));
+      pCommandEncoder->CopyTextureRegion(s_pData->m_hShadowAtlasTexture, subresource, box.m_vMin, s_pData->m_hShadowCacheTexture, subresource, box);
+    }
+
+    // The atlas has just been cleared, use it to clear the cache for the shadow maps that are cached in this frame
+    for (const ezRectU32& rect : atlasToCacheCopies)
+    {
+      const ezBoundingBoxu32 box = ezBoundingBoxu32::MakeFromMinMax(ezVec3U32(rect.x, rect.y, 0), ezVec3U32(rect.Right(), rect.Bottom(), 1));
+      pCommandEncoder->CopyTextureRegion(s_pData->m_hShadowCacheTexture, subresource, box.m_vMin, s_pData->m_hShadowAtlasTexture, subresource, box);
+    }
+  }
+
   pDevice->EndCommands(pCommandEncoder);
 }
 
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <Foundation/Containers/Deque.h>
+#include <Foundation/Math/Rect.h>
+#include <RendererCore/RendererCoreDLL.h>
+
+/// \brief Packs square shadow maps with power of two sizes into the shadow atlas, using a quadtree.
+///
+/// Besides allocating any free rect, a rect that was returned before can be claimed again with AllocateAt().
+/// This keeps the placement of shadow maps stable across frames, which is needed to reuse their content.
+class EZ_RENDERERCORE_DLL ezShadowAtlasAllocator
+{
+public:
+  /// \brief Removes all allocations and sets the size of the atlas, which must be a power of two.
+  void Reset(ezUInt32 uiAtlasSize);
+
+  /// \brief Allocates a free rect of the given size, which must be a power of two. Returns a rect with zero area if the atlas is full.
+  ezRectU32 Allocate(ezUInt32 uiShadowMapSize);
+
+  /// \brief Allocates exactly the given rect, if it is still free.
+  ///
+  /// The rect must have been returned by Allocate() for an atlas of the same size before, otherwise it is not aligned to the quadtree.
+  bool AllocateAt(const ezRectU32& rect);
+
+  ezUInt32 GetAtlasSize() const { return m_uiAtlasSize; }
+
+private:
+  struct Cell
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    EZ_ALWAYS_INLINE bool IsLeaf() const { return m_uiFirstChildIndex == ezInvalidIndex; }
+
+    ezRectU32 m_Rect;
+    ezUInt32 m_uiFirstChildIndex; // the 4 children are stored consecutively
+    bool m_bUsed;
+  };
+
+  Cell* Insert(ezUInt32 uiCellIndex, ezUInt32 uiShadowMapSize);
+  Cell* InsertAt(ezUInt32 uiCellIndex, const ezRectU32& rect);
+  void Split(ezUInt32 uiCellIndex);
+
+  ezUInt32 m_uiAtlasSize = 0;
+  ezDeque<Cell> m_Cells;
+};
+
+/// \brief Decides per frame whether the static shadow casters of a shadow view have to be rendered or whether they can be taken from the cache.
+///
+/// The signature has to cover everything that the static part of the shadow map depends on, e.g. the light camera, the light settings,
+/// ezSpatialSystem::GetChangeCounter() of the static objects in the view frustum and ezRenderWorld::GetStaticRenderDataVersion().
+/// The cache is only filled after the signature did not change for one frame, so that shadows which change constantly,
+/// e.g. the cascades of a moving camera, don't pay for filling the cache.
+struct EZ_RENDERERCORE_DLL ezShadowViewCache
+{
+  enum class Mode : ezUInt8
+  {
+    RenderAll,             ///< Render static and dynamic casters, the cache is not used.
+    RenderAllAndFillCache, ///< Render static and dynamic casters and additionally render the static casters into the cache.
+    UseCache,              ///< Copy the static casters from the cache and only render the dynamic casters on top.
+  };
+
+  /// \brief Called once per frame with the current signature, returns how the shadow view has to be rendered in this frame.
+  Mode Update(ezUInt64 uiSignature);
+
+  /// \brief Discards the cached content, e.g. when the shadow map could not be placed at the cached atlas rect.
+  void Invalidate();
+
+  ezUInt64 m_uiSignature = 0;
+  ezRectU32 m_AtlasRect = ezRectU32(0, 0, 0, 0); ///< The atlas rect of the last frame, that is where the cached content is located.
+  Mode m_Mode = Mode::RenderAll;
+};
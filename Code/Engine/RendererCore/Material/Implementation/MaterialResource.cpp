@@ -905,6 +905,9 @@ void ezMaterialResource::UpdateConstantBuffer(ezShaderPermutationResource* pShad
   if (pLayout == nullptr)
     return;
 
+  // render passes may be recorded on several threads at the same time
+  EZ_LOCK(m_UpdateCacheMutex);
+
   auto pCachedValues = GetOrUpdateCachedValues();
 
   m_iLastConstantsUpdated = m_iLastConstantsModified;
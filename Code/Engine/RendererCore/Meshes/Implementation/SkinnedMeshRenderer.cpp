@@ -36,7 +36,13 @@ void ezSkinnedMeshRenderer::SetAdditionalData(const ezRenderViewContext& renderV
   {
     pContext->SetShaderPermutationVariable("VERTEX_SKINNING", "TRUE");
 
-    if (pSkinnedRenderData->m_bTransformsUpdated != nullptr && *pSkinnedRenderData->m_bTransformsUpdated == false)
+    if (pSkinnedRenderData->m_bTransformsUpdated != nullptr && pContext->GetCommandEncoder()->IsDeferred())
+    {
+      // passes that are recorded in parallel are replayed in pass order, not in the order in which they reached this point,
+      // so every recording has to upload the matrices itself
+      pContext->GetCommandEncoder()->UpdateBuffer(pSkinnedRenderData->m_hSkinningTransforms, 0, pSkinnedRenderData->m_pNewSkinningTransformData);
+    }
+    else if (pSkinnedRenderData->m_bTransformsUpdated != nullptr && *pSkinnedRenderData->m_bTransformsUpdated == false)
     {
       // if this is the first renderer that is supposed to actually render the skinned mesh, upload the skinning matrices
       *pSkinnedRenderData->m_bTransformsUpdated = true;
@@ -32,6 +32,11 @@ public:
   void AddRenderData(const ezRenderData* pRenderData, ezRenderData::Category category);
   void AddFrameData(const ezRenderData* pFrameData);
 
+  /// \brief Appends all render data of other to this. The sorting keys are taken over as they are, so both need to use the same camera.
+  ///
+  /// Frame data is not merged.
+  void MergeRenderData(const ezExtractedRenderData& other);
+
   void SortAndBatch();
 
   void Clear();
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <Foundation/Containers/Deque.h>
 #include <Foundation/Strings/HashedString.h>
+#include <Foundation/Threading/AtomicInteger.h>
+#include <RendererCore/Pipeline/ExtractedRenderData.h>
 #include <RendererCore/Pipeline/RenderData.h>
 
 class ezStreamWriter;
@@ -32,6 +35,8 @@ protected:
   bool FilterByViewTags(const ezView& view, const ezGameObject* pObject) const;
 
   /// \brief extracts the render data for the given object.
+  ///
+  /// Can be called from multiple threads at the same time, as long as every thread uses its own msg and extractedRenderData.
   void ExtractRenderData(const ezView& view, const ezGameObject* pObject, ezMsgExtractRenderData& msg, ezExtractedRenderData& extractedRenderData) const;
 
 private:
@@ -45,8 +50,8 @@ protected:
   ezHybridArray<ezHashedString, 4> m_DependsOn;
 
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
-  mutable ezUInt32 m_uiNumCachedRenderData;
-  mutable ezUInt32 m_uiNumUncachedRenderData;
+  mutable ezAtomicInteger32 m_iNumCachedRenderData;
+  mutable ezAtomicInteger32 m_iNumUncachedRenderData;
 #endif
 };
 
@@ -64,6 +69,10 @@ public:
 
   virtual ezResult Serialize(ezStreamWriter& inout_stream) const override;
   virtual ezResult Deserialize(ezStreamReader& inout_stream) override;
+
+private:
+  /// \brief Per chunk staging data for the multi-threaded extraction. The chunks are merged in order, so the result does not depend on the scheduling.
+  ezDeque<ezExtractedRenderData> m_ChunkData;
 };
 
 class EZ_RENDERERCORE_DLL ezSelectedObjectsExtractorBase : public ezExtractor
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <Foundation/Threading/Mutex.h>
 #include <RendererCore/Pipeline/Declarations.h>
 
 class EZ_RENDERERCORE_DLL ezFrameDataProviderBase : public ezReflectedClass
@@ -19,6 +20,7 @@ private:
   const ezRenderPipeline* m_pOwnerPipeline = nullptr;
   void* m_pData = nullptr;
   ezUInt64 m_uiLastUpdateFrame = 0;
+  ezMutex m_UpdateMutex; ///< Passes may be recorded on several threads, see ezRenderPipelinePass::SupportsParallelRecording().
 };
 
 template <typename T>
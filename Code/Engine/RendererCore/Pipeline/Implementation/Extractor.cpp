@@ -4,6 +4,8 @@
 #include <Core/World/World.h>
 #include <Foundation/Configuration/CVar.h>
 #include <Foundation/IO/TypeVersionContext.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Types/ScopeExit.h>
 #include <RendererCore/Debug/DebugRenderer.h>
 #include <RendererCore/Pipeline/ExtractedRenderData.h>
 #include <RendererCore/Pipeline/Extractor.h>
@@ -21,8 +23,13 @@ ezCVarString cvar_SpatialVisDataOnlyObject("Spatial.VisData.OnlyObject", "", ezC
 ezCVarBool cvar_SpatialExtractionShowStats("Spatial.Extraction.ShowStats", false, ezCVarFlags::Default, "Display some stats of the render data extraction");
 #endif
 
+ezCVarBool cvar_SpatialExtractionMultithreading("Spatial.Extraction.Multithreading", true, ezCVarFlags::Default, "Extracts the render data of the visible objects on multiple threads");
+
 namespace
 {
+  /// Below this number of visible objects, the overhead of the tasks outweighs the gain of the multi-threaded extraction.
+  constexpr ezUInt32 s_uiMinObjectsPerExtractionChunk = 256;
+
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
   void VisualizeSpatialData(const ezView& view)
   {
@@ -110,10 +117,6 @@ ezExtractor::ezExtractor(const char* szName)
   m_bActive = true;
   m_sName.Assign(szName);
 
-#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
-  m_uiNumCachedRenderData = 0;
-  m_uiNumUncachedRenderData = 0;
-#endif
 }
 
 ezExtractor::~ezExtractor() = default;
@@ -144,6 +147,13 @@ bool ezExtractor::FilterByViewTags(const ezView& view, const ezGameObject* pObje
 
 void ezExtractor::ExtractRenderData(const ezView& view, const ezGameObject* pObject, ezMsgExtractRenderData& msg, ezExtractedRenderData& extractedRenderData) const
 {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  ezUInt32 uiNumCachedRenderData = 0;
+  ezUInt32 uiNumUncachedRenderData = 0;
+
+  EZ_SCOPE_EXIT(m_iNumCachedRenderData.Add(uiNumCachedRenderData); m_iNumUncachedRenderData.Add(uiNumUncachedRenderData););
+#endif
+
   auto AddRenderDataFromMessage = [&](const ezMsgExtractRenderData& msg) {
     if (msg.m_OverrideCategory != ezInvalidRenderDataCategory)
     {
@@ -161,7 +171,7 @@ void ezExtractor::ExtractRenderData(const ezView& view, const ezGameObject* pObj
     }
 
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
-    m_uiNumUncachedRenderData += msg.m_ExtractedRenderData.GetCount();
+    uiNumUncachedRenderData += msg.m_ExtractedRenderData.GetCount();
 #endif
   };
 
@@ -197,7 +207,7 @@ void ezExtractor::ExtractRenderData(const ezView& view, const ezGameObject* pObj
           extractedRenderData.AddRenderData(cacheEntry.m_pRenderData, msg.m_OverrideCategory != ezInvalidRenderDataCategory ? msg.m_OverrideCategory : ezRenderData::Category(cacheEntry.m_uiCategory));
 
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
-          ++m_uiNumCachedRenderData;
+          ++uiNumCachedRenderData;
 #endif
         }
         ++uiCacheIndex;
@@ -291,24 +301,92 @@ ezVisibleObjectsExtractor::~ezVisibleObjectsExtractor() = default;
 
 void ezVisibleObjectsExtractor::Extract(const ezView& view, const ezDynamicArray<const ezGameObject*>& visibleObjects, ezExtractedRenderData& ref_extractedRenderData)
 {
-  ezMsgExtractRenderData msg;
-  msg.m_pView = &view;
-
   EZ_LOCK(view.GetWorld()->GetReadMarker());
 
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
   VisualizeSpatialData(view);
 
-  m_uiNumCachedRenderData = 0;
-  m_uiNumUncachedRenderData = 0;
+  m_iNumCachedRenderData = 0;
+  m_iNumUncachedRenderData = 0;
 #endif
 
-  for (auto pObject : visibleObjects)
+  const ezUInt32 uiNumObjects = visibleObjects.GetCount();
+  const ezUInt32 uiMaxChunks = ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks) * 4;
+  const ezUInt32 uiNumChunks = cvar_SpatialExtractionMultithreading ? ezMath::Clamp(uiNumObjects / s_uiMinObjectsPerExtractionChunk, 1u, ezMath::Max(uiMaxChunks, 1u)) : 1;
+
+  if (uiNumChunks == 1)
   {
-    ExtractRenderData(view, pObject, msg, ref_extractedRenderData);
+    ezMsgExtractRenderData msg;
+    msg.m_pView = &view;
+
+    for (auto pObject : visibleObjects)
+    {
+      ExtractRenderData(view, pObject, msg, ref_extractedRenderData);
+    }
+  }
+  else
+  {
+    // The workers only read from the world, which is already guarded by the read lock of this thread.
+    // The render data cache of the view supports concurrent lookups and insertions.
+    while (m_ChunkData.GetCount() < uiNumChunks)
+    {
+      m_ChunkData.ExpandAndGetRef();
+    }
+
+    for (ezUInt32 i = 0; i < uiNumChunks; ++i)
+    {
+      m_ChunkData[i].Clear();
+      m_ChunkData[i].SetCamera(ref_extractedRenderData.GetCamera());
+    }
+
+    struct ChunkContext
+    {
+      const ezVisibleObjectsExtractor* m_pExtractor;
+      const ezView* m_pView;
+      const ezDynamicArray<const ezGameObject*>* m_pVisibleObjects;
+      ezDeque<ezExtractedRenderData>* m_pChunkData;
+      ezUInt32 m_uiNumChunks;
+    };
+
+    ChunkContext context = {this, &view, &visibleObjects, &m_ChunkData, uiNumChunks};
+
+    ezParallelForParams params;
+    params.m_uiBinSize = 1;
+
+    ezTaskSystem::ParallelForIndexed(
+      0, uiNumChunks,
+      [&context](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex)
+      {
+        ezMsgExtractRenderData msg;
+        msg.m_pView = context.m_pView;
+
+        const ezUInt32 uiNumObjects = context.m_pVisibleObjects->GetCount();
+
+        for (ezUInt32 uiChunk = uiStartIndex; uiChunk < uiEndIndex; ++uiChunk)
+        {
+          ezExtractedRenderData& chunkData = (*context.m_pChunkData)[uiChunk];
+
+          const ezUInt32 uiFirstObject = static_cast<ezUInt32>(static_cast<ezUInt64>(uiNumObjects) * uiChunk / context.m_uiNumChunks);
+          const ezUInt32 uiLastObject = static_cast<ezUInt32>(static_cast<ezUInt64>(uiNumObjects) * (uiChunk + 1) / context.m_uiNumChunks);
+
+          for (ezUInt32 i = uiFirstObject; i < uiLastObject; ++i)
+          {
+            context.m_pExtractor->ExtractRenderData(*context.m_pView, (*context.m_pVisibleObjects)[i], msg, chunkData);
+          }
+        }
+      },
+      "ExtractVisibleObjects", ezTaskNesting::Never, params);
+
+    for (ezUInt32 i = 0; i < uiNumChunks; ++i)
+    {
+      ref_extractedRenderData.MergeRenderData(m_ChunkData[i]);
+    }
+  }
 
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
-    if (cvar_SpatialVisBounds || cvar_SpatialVisLocalBBox || cvar_SpatialVisData)
+  if (cvar_SpatialVisBounds || cvar_SpatialVisLocalBBox || cvar_SpatialVisData)
+  {
+    for (auto pObject : visibleObjects)
     {
       if ((cvar_SpatialVisDataOnlyObject.GetValue().IsEmpty() ||
             pObject->GetName().FindSubString_NoCase(cvar_SpatialVisDataOnlyObject.GetValue()) != nullptr) &&
@@ -317,10 +395,8 @@ void ezVisibleObjectsExtractor::Extract(const ezView& view, const ezDynamicArray
         VisualizeObject(view, pObject);
       }
     }
-#endif
   }
 
-#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
   const bool bIsMainView = (view.GetCameraUsageHint() == ezCameraUsageHint::MainView || view.GetCameraUsageHint() == ezCameraUsageHint::EditorView);
 
   if (cvar_SpatialExtractionShowStats && bIsMainView)
@@ -331,10 +407,13 @@ void ezVisibleObjectsExtractor::Extract(const ezView& view, const ezDynamicArray
 
     ezDebugRenderer::DrawInfoText(hView, ezDebugTextPlacement::TopLeft, "ExtractionStats", "Extraction Stats:");
 
-    sb.SetFormat("Num Cached Render Data: {0}", m_uiNumCachedRenderData);
+    sb.SetFormat("Num Cached Render Data: {0}", m_iNumCachedRenderData);
+    ezDebugRenderer::DrawInfoText(hView, ezDebugTextPlacement::TopLeft, "ExtractionStats", sb);
+
+    sb.SetFormat("Num Uncached Render Data: {0}", m_iNumUncachedRenderData);
     ezDebugRenderer::DrawInfoText(hView, ezDebugTextPlacement::TopLeft, "ExtractionStats", sb);
 
-    sb.SetFormat("Num Uncached Render Data: {0}", m_uiNumUncachedRenderData);
+    sb.SetFormat("Extraction Chunks: {0}", uiNumChunks);
     ezDebugRenderer::DrawInfoText(hView, ezDebugTextPlacement::TopLeft, "ExtractionStats", sb);
   }
 #endif
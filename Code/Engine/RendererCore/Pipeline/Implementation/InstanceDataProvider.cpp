@@ -95,10 +95,36 @@ ezInstanceDataProvider::ezInstanceDataProvider() = default;
 
 ezInstanceDataProvider::~ezInstanceDataProvider() = default;
 
+ezInstanceData* ezInstanceDataProvider::GetData(const ezRenderViewContext& renderViewContext)
+{
+  // always go through the base, it resets all instance data once per frame
+  ezInstanceData* pData = ezFrameDataProvider<ezInstanceData>::GetData(renderViewContext);
+
+  ezRenderContext* pRenderContext = renderViewContext.m_pRenderContext;
+  if (!pRenderContext->GetCommandEncoder()->IsDeferred())
+    return pData;
+
+  EZ_LOCK(m_DeferredDataMutex);
+
+  ezUniquePtr<ezInstanceData>& pDeferredData = m_DeferredData[pRenderContext];
+  if (pDeferredData == nullptr)
+  {
+    pDeferredData = EZ_DEFAULT_NEW(ezInstanceData);
+  }
+
+  return pDeferredData.Borrow();
+}
+
 void* ezInstanceDataProvider::UpdateData(const ezRenderViewContext& renderViewContext, const ezExtractedRenderData& extractedData)
 {
   m_Data.Reset();
 
+  EZ_LOCK(m_DeferredDataMutex);
+  for (auto it = m_DeferredData.GetIterator(); it.IsValid(); ++it)
+  {
+    it.Value()->Reset();
+  }
+
   return &m_Data;
 }
 
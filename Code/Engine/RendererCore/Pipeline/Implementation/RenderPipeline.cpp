@@ -10,8 +10,10 @@
 #include <Foundation/Math/Frustum.h>
 #include <Foundation/Reflection/ReflectionUtils.h>
 #include <Foundation/SimdMath/SimdBBox.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <Foundation/Time/Clock.h>
 #include <Foundation/Utilities/DGMLWriter.h>
+#include <Foundation/Utilities/Stats.h>
 #include <RendererCore/Components/AlwaysVisibleComponent.h>
 #include <RendererCore/Debug/DebugRenderer.h>
 #include <RendererCore/GPUResourcePool/GPUResourcePool.h>
@@ -23,6 +25,7 @@
 #include <RendererCore/Rasterizer/RasterizerView.h>
 #include <RendererCore/RenderContext/RenderContext.h>
 #include <RendererCore/RenderWorld/RenderWorld.h>
+#include <RendererFoundation/CommandEncoder/DeferredCommandEncoder.h>
 #include <RendererFoundation/Profiling/Profiling.h>
 #include <RendererFoundation/Resources/Texture.h>
 
@@ -36,6 +39,8 @@ ezCVarBool cvar_SpatialCullingOcclusionVisView("Spatial.Occlusion.VisView", fals
 ezCVarFloat cvar_SpatialCullingOcclusionBoundsInlation("Spatial.Occlusion.BoundsInflation", 0.5f, ezCVarFlags::Default, "How much to inflate bounds during occlusion check.");
 ezCVarFloat cvar_SpatialCullingOcclusionFarPlane("Spatial.Occlusion.FarPlane", 50.0f, ezCVarFlags::Default, "Far plane distance for finding occluders.");
 
+ezCVarBool cvar_RenderingParallelRecording("Rendering.ParallelRecording", false, ezCVarFlags::Default, "Records consecutive render passes that support it on multiple threads.");
+
 ezRenderPipeline::ezRenderPipeline()
 
 {
@@ -66,6 +71,12 @@ ezRenderPipeline::~ezRenderPipeline()
   {
     RemovePass(m_Passes.PeekBack().Borrow());
   }
+
+  for (PassRecorder& recorder : m_PassRecorders)
+  {
+    ezRenderContext::DestroyInstance(recorder.m_pRenderContext);
+  }
+  m_PassRecorders.Clear();
 }
 
 void ezRenderPipeline::AddPass(ezUniquePtr<ezRenderPipelinePass>&& pPass)
@@ -653,6 +664,45 @@ bool ezRenderPipeline::CreateRenderTargetUsage(const ezView& view)
   m_TextureUsageIdxSortedByFirstUsage.Sort(FirstUsageComparer(m_TextureUsage));
   m_TextureUsageIdxSortedByLastUsage.Sort(LastUsageComparer(m_TextureUsage));
 
+  // Plan which pool textures can be shared by textures with disjoint lifetimes.
+  {
+    ezGALDevice* pDevice = ezGALDevice::GetDefaultDevice();
+
+    ezDynamicArray<ezRenderTargetAliasingPlanner::Target> targets;
+    targets.Reserve(m_TextureUsageIdxSortedByFirstUsage.GetCount());
+
+    for (ezUInt16 uiUsageIdx : m_TextureUsageIdxSortedByFirstUsage)
+    {
+      const TextureUsageData& data = m_TextureUsage[uiUsageIdx];
+
+      auto& target = targets.ExpandAndGetRef();
+      target.m_Desc = data.m_UsedBy[0]->m_Desc;
+      target.m_uiMemorySize = pDevice ? pDevice->GetMemoryConsumptionForTexture(target.m_Desc) : 0;
+      target.m_uiFirstUsageIdx = data.m_uiFirstUsageIdx;
+      target.m_uiLastUsageIdx = data.m_uiLastUsageIdx;
+    }
+
+    m_AliasingPlanner.Plan(targets);
+
+    for (ezUInt32 i = 0; i < m_TextureUsageIdxSortedByFirstUsage.GetCount(); ++i)
+    {
+      m_TextureUsage[m_TextureUsageIdxSortedByFirstUsage[i]].m_uiAliasingSlot = m_AliasingPlanner.GetSlotForTarget(i);
+    }
+
+    m_AliasingSlotTextures.SetCount(m_AliasingPlanner.GetSlots().GetCount());
+
+    const float fToMB = 1.0f / (1024.0f * 1024.0f);
+    ezLog::Dev("{} transient textures in {} pool textures, peak memory {} MB (without aliasing: peak {} MB, total {} MB)", targets.GetCount(),
+      m_AliasingPlanner.GetSlots().GetCount(), ezArgF(m_AliasingPlanner.GetPeakMemory() * fToMB, 1),
+      ezArgF(m_AliasingPlanner.GetPeakMemoryWithoutAliasing() * fToMB, 1), ezArgF(m_AliasingPlanner.GetTotalMemoryWithoutAliasing() * fToMB, 1));
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+    ezStringBuilder sStatName;
+    sStatName.SetFormat("Render Pipeline/{}/Peak Transient Memory (MB)", m_sName);
+    ezStats::SetStat(sStatName, m_AliasingPlanner.GetPeakMemory() * fToMB);
+#endif
+  }
+
   return true;
 }
 
@@ -828,6 +878,8 @@ void ezRenderPipeline::ClearRenderPassGraphTextures()
   m_TextureUsage.Clear();
   m_TextureUsageIdxSortedByFirstUsage.Clear();
   m_TextureUsageIdxSortedByLastUsage.Clear();
+  m_AliasingPlanner.Clear();
+  m_AliasingSlotTextures.Clear();
 
   // ezGALDevice* pDevice = ezGALDevice::GetDefaultDevice();
 
@@ -897,6 +949,8 @@ bool ezRenderPipeline::ArePassThroughInputsDone(const ezRenderPipelinePass* pPas
 
 ezFrameDataProviderBase* ezRenderPipeline::GetFrameDataProvider(const ezRTTI* pRtti) const
 {
+  EZ_LOCK(m_DataProviderMutex);
+
   ezUInt32 uiIndex = 0;
   if (m_TypeToDataProviderIndex.TryGetValue(pRtti, uiIndex))
   {
@@ -1008,9 +1062,10 @@ void ezRenderPipeline::FindVisibleObjects(const ezView& view)
 #endif
 
   ezSpatialSystem::QueryParams queryParams;
-  queryParams.m_uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask() | ezDefaultSpatialDataCategories::RenderDynamic.GetBitmask();
+  queryParams.m_uiCategoryBitmask = view.GetSpatialDataCategoryBitmask();
   queryParams.m_pIncludeTags = &view.m_IncludeTags;
   queryParams.m_pExcludeTags = &view.m_ExcludeTags;
+  queryParams.m_pCoherentVisibilityKey = view.GetCoherentVisibility() ? &view : nullptr;
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
   queryParams.m_pStats = bRecordStats ? &stats : nullptr;
 #endif
@@ -1210,36 +1265,48 @@ void ezRenderPipeline::Render(ezRenderContext* pRenderContext)
       }
     }
 
+    const bool bParallelRecording = CanRecordPassesInParallel();
+    const ezUInt32 uiNumDataProviders = m_DataProviders.GetCount();
+
     ezUInt32 uiCurrentFirstUsageIdx = 0;
     ezUInt32 uiCurrentLastUsageIdx = 0;
-    for (ezUInt32 i = 0; i < m_Passes.GetCount(); ++i)
+    for (ezUInt32 i = 0; i < m_Passes.GetCount();)
     {
-      auto& pPass = m_Passes[i];
-      EZ_PROFILE_SCOPE(pPass->GetName());
-      ezLogBlock passBlock("Render Pass", pPass->GetName());
+      // Find the run of consecutive active passes that can be recorded in parallel, starting at this one.
+      ezUInt32 uiNumPasses = 1;
+      if (bParallelRecording)
+      {
+        uiNumPasses = 0;
+        while (i + uiNumPasses < m_Passes.GetCount() && m_Passes[i + uiNumPasses]->m_bActive && m_Passes[i + uiNumPasses]->SupportsParallelRecording())
+        {
+          ++uiNumPasses;
+        }
+      }
 
-      // Create pool textures
-      for (; uiCurrentFirstUsageIdx < m_TextureUsageIdxSortedByFirstUsage.GetCount();)
+      if (uiNumPasses >= 2)
       {
-        ezUInt16 uiCurrentUsageData = m_TextureUsageIdxSortedByFirstUsage[uiCurrentFirstUsageIdx];
-        TextureUsageData& usageData = m_TextureUsage[uiCurrentUsageData];
-        if (usageData.m_uiFirstUsageIdx == i)
+        for (ezUInt32 j = i; j < i + uiNumPasses; ++j)
         {
-          ezGALTextureHandle hTexture = ezGPUResourcePool::GetDefaultInstance()->GetRenderTarget(usageData.m_UsedBy[0]->m_Desc);
-          EZ_ASSERT_DEV(!hTexture.IsInvalidated(), "GPU pool returned an invalidated texture!");
-          for (ezRenderPipelinePassConnection* pConn : usageData.m_UsedBy)
-          {
-            pConn->m_TextureHandle = hTexture;
-          }
-          ++uiCurrentFirstUsageIdx;
+          AcquirePassTextures(j, uiCurrentFirstUsageIdx);
         }
-        else
+
+        RecordPassesInParallel(renderViewContext, pCommandEncoder, i, uiNumPasses);
+
+        for (ezUInt32 j = i; j < i + uiNumPasses; ++j)
         {
-          // The current usage data blocks m_uiFirstUsageIdx isn't reached yet so wait.
-          break;
+          ReleasePassTextures(j, uiCurrentLastUsageIdx);
         }
+
+        i += uiNumPasses;
+        continue;
       }
 
+      auto& pPass = m_Passes[i];
+      EZ_PROFILE_SCOPE(pPass->GetName());
+      ezLogBlock passBlock("Render Pass", pPass->GetName());
+
+      AcquirePassTextures(i, uiCurrentFirstUsageIdx);
+
       // Execute pass block
       {
         EZ_PROFILE_AND_MARKER(pCommandEncoder, pPass->GetName());
@@ -1255,27 +1322,12 @@ void ezRenderPipeline::Render(ezRenderContext* pRenderContext)
         }
       }
 
-      // Release pool textures
-      for (; uiCurrentLastUsageIdx < m_TextureUsageIdxSortedByLastUsage.GetCount();)
-      {
-        ezUInt16 uiCurrentUsageData = m_TextureUsageIdxSortedByLastUsage[uiCurrentLastUsageIdx];
-        TextureUsageData& usageData = m_TextureUsage[uiCurrentUsageData];
-        if (usageData.m_uiLastUsageIdx == i)
-        {
-          ezGPUResourcePool::GetDefaultInstance()->ReturnRenderTarget(usageData.m_UsedBy[0]->m_TextureHandle);
-          for (ezRenderPipelinePassConnection* pConn : usageData.m_UsedBy)
-          {
-            pConn->m_TextureHandle.Invalidate();
-          }
-          ++uiCurrentLastUsageIdx;
-        }
-        else
-        {
-          // The current usage data blocks m_uiLastUsageIdx isn't reached yet so wait.
-          break;
-        }
-      }
+      ReleasePassTextures(i, uiCurrentLastUsageIdx);
+      ++i;
     }
+
+    m_bDataProvidersChanged = m_DataProviders.GetCount() != uiNumDataProviders;
+
     EZ_ASSERT_DEV(uiCurrentFirstUsageIdx == m_TextureUsageIdxSortedByFirstUsage.GetCount(), "Rendering all passes should have moved us through all texture usage blocks!");
     EZ_ASSERT_DEV(uiCurrentLastUsageIdx == m_TextureUsageIdxSortedByLastUsage.GetCount(), "Rendering all passes should have moved us through all texture usage blocks!");
   }
@@ -1294,6 +1346,140 @@ void ezRenderPipeline::Render(ezRenderContext* pRenderContext)
   m_CurrentRenderThread = (ezThreadID)0;
 }
 
+void ezRenderPipeline::AcquirePassTextures(ezUInt32 uiPassIdx, ezUInt32& inout_uiCurrentFirstUsageIdx)
+{
+  for (; inout_uiCurrentFirstUsageIdx < m_TextureUsageIdxSortedByFirstUsage.GetCount();)
+  {
+    ezUInt16 uiCurrentUsageData = m_TextureUsageIdxSortedByFirstUsage[inout_uiCurrentFirstUsageIdx];
+    TextureUsageData& usageData = m_TextureUsage[uiCurrentUsageData];
+    if (usageData.m_uiFirstUsageIdx == uiPassIdx)
+    {
+      // Only the first texture in a slot acquires the pool texture, the following ones reuse it.
+      const ezRenderTargetAliasingPlanner::Slot& slot = m_AliasingPlanner.GetSlots()[usageData.m_uiAliasingSlot];
+      ezGALTextureHandle& hTexture = m_AliasingSlotTextures[usageData.m_uiAliasingSlot];
+      if (slot.m_uiFirstUsageIdx == uiPassIdx)
+      {
+        hTexture = ezGPUResourcePool::GetDefaultInstance()->GetRenderTarget(slot.m_Desc);
+      }
+      EZ_ASSERT_DEV(!hTexture.IsInvalidated(), "GPU pool returned an invalidated texture!");
+      for (ezRenderPipelinePassConnection* pConn : usageData.m_UsedBy)
+      {
+        pConn->m_TextureHandle = hTexture;
+      }
+      ++inout_uiCurrentFirstUsageIdx;
+    }
+    else
+    {
+      // The current usage data blocks m_uiFirstUsageIdx isn't reached yet so wait.
+      break;
+    }
+  }
+}
+
+void ezRenderPipeline::ReleasePassTextures(ezUInt32 uiPassIdx, ezUInt32& inout_uiCurrentLastUsageIdx)
+{
+  for (; inout_uiCurrentLastUsageIdx < m_TextureUsageIdxSortedByLastUsage.GetCount();)
+  {
+    ezUInt16 uiCurrentUsageData = m_TextureUsageIdxSortedByLastUsage[inout_uiCurrentLastUsageIdx];
+    TextureUsageData& usageData = m_TextureUsage[uiCurrentUsageData];
+    if (usageData.m_uiLastUsageIdx == uiPassIdx)
+    {
+      ezGALTextureHandle& hTexture = m_AliasingSlotTextures[usageData.m_uiAliasingSlot];
+      if (m_AliasingPlanner.GetSlots()[usageData.m_uiAliasingSlot].m_uiLastUsageIdx == uiPassIdx)
+      {
+        ezGPUResourcePool::GetDefaultInstance()->ReturnRenderTarget(hTexture);
+        hTexture.Invalidate();
+      }
+      for (ezRenderPipelinePassConnection* pConn : usageData.m_UsedBy)
+      {
+        pConn->m_TextureHandle.Invalidate();
+      }
+      ++inout_uiCurrentLastUsageIdx;
+    }
+    else
+    {
+      // The current usage data blocks m_uiLastUsageIdx isn't reached yet so wait.
+      break;
+    }
+  }
+}
+
+bool ezRenderPipeline::CanRecordPassesInParallel() const
+{
+  if (!cvar_RenderingParallelRecording)
+    return false;
+
+  // Data providers upload their data on the first call per frame, that has to happen on the main command encoder before the recording starts.
+  // New ones are created on first use, so wait until a frame was rendered without creating any.
+  if (m_bDataProvidersChanged)
+    return false;
+
+  // Recording creates resource views and samplers on worker threads.
+  return ezGALDevice::GetDefaultDevice()->GetCapabilities().m_bSupportsMultithreadedResourceCreation;
+}
+
+void ezRenderPipeline::RecordPassesInParallel(const ezRenderViewContext& renderViewContext, ezGALCommandEncoder* pCommandEncoder, ezUInt32 uiFirstPass, ezUInt32 uiNumPasses)
+{
+  EZ_PROFILE_SCOPE("RecordPassesInParallel");
+
+  ezRenderContext* pRenderContext = renderViewContext.m_pRenderContext;
+  ezGALDevice* pDevice = ezGALDevice::GetDefaultDevice();
+
+  // Update all data providers on the main command encoder, the recordings only read their data.
+  for (auto& pDataProvider : m_DataProviders)
+  {
+    pDataProvider->GetData(renderViewContext);
+  }
+
+  while (m_PassRecorders.GetCount() < uiNumPasses)
+  {
+    PassRecorder& recorder = m_PassRecorders.ExpandAndGetRef();
+    recorder.m_pCommandEncoder = EZ_DEFAULT_NEW(ezGALDeferredCommandEncoder, *pDevice);
+    recorder.m_pRenderContext = ezRenderContext::CreateInstance(recorder.m_pCommandEncoder.Borrow());
+  }
+
+  ezHybridArray<ConnectionData*, 16> connections;
+  for (ezUInt32 i = 0; i < uiNumPasses; ++i)
+  {
+    m_PassRecorders[i].m_pRenderContext->CopyContextState(*pRenderContext);
+    connections.PushBack(&m_Connections[m_Passes[uiFirstPass + i].Borrow()]);
+  }
+
+  ezTaskSystem::ParallelForIndexed(
+    0, uiNumPasses, [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex)
+    {
+      for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+      {
+        auto& pPass = m_Passes[uiFirstPass + i];
+        EZ_PROFILE_SCOPE(pPass->GetName());
+        ezLogBlock passBlock("Render Pass", pPass->GetName());
+
+        ezRenderViewContext passViewContext = renderViewContext;
+        passViewContext.m_pRenderContext = m_PassRecorders[i].m_pRenderContext;
+
+        pPass->Execute(passViewContext, connections[i]->m_Inputs, connections[i]->m_Outputs);
+      } },
+    "RecordRenderPasses");
+
+  for (ezUInt32 i = 0; i < uiNumPasses; ++i)
+  {
+    auto& pPass = m_Passes[uiFirstPass + i];
+    PassRecorder& recorder = m_PassRecorders[i];
+
+    {
+      EZ_PROFILE_AND_MARKER(pCommandEncoder, pPass->GetName());
+      recorder.m_pCommandEncoder->Replay(*pCommandEncoder);
+    }
+
+    // Releases the references to the recorded resources right away.
+    recorder.m_pCommandEncoder->Reset();
+    recorder.m_pRenderContext->ResetContextState();
+  }
+
+  // The replayed commands changed the GAL state behind the back of the main context.
+  pRenderContext->InvalidateContextState();
+}
+
 const ezExtractedRenderData& ezRenderPipeline::GetRenderData() const
 {
   return m_Data[ezRenderWorld::GetDataIndexForRendering()];
@@ -1338,6 +1524,10 @@ void ezRenderPipeline::CreateDgmlGraph(ezDGMLGraph& ref_graph)
         sFormat.SetFormat("Unknown Format {}", (int)pCon->m_Desc.m_Format);
       }
       sTmp.SetFormat("{} #{}: {}x{}:{}, MSAA:{}, {}Format: {}", data.m_pTextureProvider ? "External" : "PoolTexture", i, pCon->m_Desc.m_uiWidth, pCon->m_Desc.m_uiHeight, pCon->m_Desc.m_uiArraySize, (int)pCon->m_Desc.m_SampleCount, ezGALResourceFormat::IsDepthFormat(pCon->m_Desc.m_Format) ? "Depth" : "Color", sFormat);
+      if (data.m_uiAliasingSlot != 0xFFFF)
+      {
+        sTmp.AppendFormat(", Slot: {}", data.m_uiAliasingSlot);
+      }
       ezUInt32 uiTextureNode = ref_graph.AddNode(sTmp, &nd);
 
       ezUInt32 uiOutputNode = *nodeMap.GetValue(pCon->m_pOutput->m_pParent);
@@ -77,6 +77,7 @@ void ezRenderPipelinePass::RenderDataWithCategory(const ezRenderViewContext& ren
   EZ_PROFILE_AND_MARKER(renderViewContext.m_pRenderContext->GetCommandEncoder(), ezRenderData::GetCategoryName(category));
 
   auto batchList = m_pPipeline->GetRenderDataBatchesWithCategory(category, filter);
+  const bool bDeferred = renderViewContext.m_pRenderContext->GetCommandEncoder()->IsDeferred();
   const ezUInt32 uiBatchCount = batchList.GetBatchCount();
   for (ezUInt32 i = 0; i < uiBatchCount; ++i)
   {
@@ -88,7 +89,15 @@ void ezRenderPipelinePass::RenderDataWithCategory(const ezRenderViewContext& ren
 
       if (const ezRenderer* pRenderer = ezRenderData::GetCategoryRenderer(category, pType))
       {
-        pRenderer->RenderBatch(renderViewContext, this, batch);
+        if (bDeferred && !pRenderer->SupportsParallelRecording())
+        {
+          EZ_LOCK(pRenderer->m_ParallelRecordingMutex);
+          pRenderer->RenderBatch(renderViewContext, this, batch);
+        }
+        else
+        {
+          pRenderer->RenderBatch(renderViewContext, this, batch);
+        }
       }
     }
   }
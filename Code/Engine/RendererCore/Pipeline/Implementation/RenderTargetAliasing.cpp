@@ -0,0 +1,141 @@
+#include <RendererCore/RendererCorePCH.h>
+
+#include <RendererCore/Pipeline/RenderTargetAliasing.h>
+
+namespace
+{
+  ezUInt32 CalculateAliasingHash(const ezGALTextureCreationDescription& desc)
+  {
+    // the usage flags are merged, everything else has to match
+    ezGALTextureCreationDescription tmp = desc;
+    tmp.m_bAllowShaderResourceView = false;
+    tmp.m_bAllowUAV = false;
+    tmp.m_bCreateRenderTarget = false;
+    tmp.m_bAllowDynamicMipGeneration = false;
+    return tmp.CalculateHash();
+  }
+
+  /// Works for targets and slots, both have a lifetime and a size.
+  template <typename T>
+  ezUInt64 ComputeAliasingPeakMemory(ezArrayPtr<const T> ranges)
+  {
+    ezUInt32 uiNumPasses = 0;
+    for (const T& range : ranges)
+    {
+      uiNumPasses = ezMath::Max<ezUInt32>(uiNumPasses, range.m_uiLastUsageIdx + 1);
+    }
+
+    // memory that becomes alive / dead at each pass
+    ezDynamicArray<ezInt64> delta;
+    delta.SetCount(uiNumPasses + 1);
+
+    for (const T& range : ranges)
+    {
+      delta[range.m_uiFirstUsageIdx] += range.m_uiMemorySize;
+      delta[range.m_uiLastUsageIdx + 1] -= range.m_uiMemorySize;
+    }
+
+    ezInt64 iAlive = 0;
+    ezInt64 iPeak = 0;
+    for (ezUInt32 i = 0; i < uiNumPasses; ++i)
+    {
+      iAlive += delta[i];
+      iPeak = ezMath::Max(iPeak, iAlive);
+    }
+
+    return static_cast<ezUInt64>(iPeak);
+  }
+} // namespace
+
+void ezRenderTargetAliasingPlanner::Plan(ezArrayPtr<const Target> targets)
+{
+  Clear();
+
+  EZ_ASSERT_DEV(targets.GetCount() < 0xFFFF, "Too many render targets");
+
+  m_TargetToSlot.SetCount(targets.GetCount(), 0xFFFF);
+
+  ezDynamicArray<ezUInt32> slotHashes;
+  ezDynamicArray<ezUInt16> order;
+  order.SetCountUninitialized(targets.GetCount());
+
+  for (ezUInt32 i = 0; i < targets.GetCount(); ++i)
+  {
+    EZ_ASSERT_DEV(targets[i].m_uiFirstUsageIdx <= targets[i].m_uiLastUsageIdx, "Invalid target lifetime");
+
+    order[i] = static_cast<ezUInt16>(i);
+    m_uiTotalMemoryWithoutAliasing += targets[i].m_uiMemorySize;
+  }
+
+  // Handling the targets in the order in which they become alive and always reusing a free slot if there is one,
+  // needs the minimum number of slots per description (this is interval graph coloring).
+  order.Sort([&](ezUInt16 a, ezUInt16 b)
+    {
+      if (targets[a].m_uiFirstUsageIdx != targets[b].m_uiFirstUsageIdx)
+        return targets[a].m_uiFirstUsageIdx < targets[b].m_uiFirstUsageIdx;
+
+      return a < b; });
+
+  for (ezUInt16 uiTargetIdx : order)
+  {
+    const Target& target = targets[uiTargetIdx];
+    const bool bCanAlias = target.m_Desc.m_pExisitingNativeObject == nullptr;
+    const ezUInt32 uiHash = CalculateAliasingHash(target.m_Desc);
+
+    // take the free slot that was released last, that keeps the others free for longer
+    ezUInt32 uiBestSlot = ezInvalidIndex;
+    for (ezUInt32 s = 0; bCanAlias && s < m_Slots.GetCount(); ++s)
+    {
+      const Slot& slot = m_Slots[s];
+      if (slot.m_uiLastUsageIdx >= target.m_uiFirstUsageIdx || slotHashes[s] != uiHash || slot.m_Desc.m_pExisitingNativeObject != nullptr)
+        continue;
+
+      if (uiBestSlot == ezInvalidIndex || slot.m_uiLastUsageIdx > m_Slots[uiBestSlot].m_uiLastUsageIdx)
+        uiBestSlot = s;
+    }
+
+    if (uiBestSlot == ezInvalidIndex)
+    {
+      uiBestSlot = m_Slots.GetCount();
+      slotHashes.PushBack(uiHash);
+
+      Slot& slot = m_Slots.ExpandAndGetRef();
+      slot.m_Desc = target.m_Desc;
+      slot.m_uiMemorySize = target.m_uiMemorySize;
+      slot.m_uiFirstUsageIdx = target.m_uiFirstUsageIdx;
+    }
+
+    Slot& slot = m_Slots[uiBestSlot];
+    slot.m_Desc.m_bAllowShaderResourceView |= target.m_Desc.m_bAllowShaderResourceView;
+    slot.m_Desc.m_bAllowUAV |= target.m_Desc.m_bAllowUAV;
+    slot.m_Desc.m_bCreateRenderTarget |= target.m_Desc.m_bCreateRenderTarget;
+    slot.m_Desc.m_bAllowDynamicMipGeneration |= target.m_Desc.m_bAllowDynamicMipGeneration;
+    slot.m_uiMemorySize = ezMath::Max(slot.m_uiMemorySize, target.m_uiMemorySize);
+    slot.m_uiLastUsageIdx = target.m_uiLastUsageIdx;
+
+    m_TargetToSlot[uiTargetIdx] = static_cast<ezUInt16>(uiBestSlot);
+  }
+
+  m_uiPeakMemory = ComputeAliasingPeakMemory<Slot>(m_Slots);
+  m_uiPeakMemoryWithoutAliasing = ComputeAliasingPeakMemory<Target>(targets);
+}
+
+void ezRenderTargetAliasingPlanner::Clear()
+{
+  m_Slots.Clear();
+  m_TargetToSlot.Clear();
+  m_uiPeakMemory = 0;
+  m_uiPeakMemoryWithoutAliasing = 0;
+  m_uiTotalMemoryWithoutAliasing = 0;
+}
+
+bool ezRenderTargetAliasingPlanner::AreDescriptionsCompatible(const ezGALTextureCreationDescription& a, const ezGALTextureCreationDescription& b)
+{
+  if (a.m_pExisitingNativeObject != nullptr || b.m_pExisitingNativeObject != nullptr)
+    return false;
+
+  return CalculateAliasingHash(a) == CalculateAliasingHash(b);
+}
+
+
+EZ_STATICLINK_FILE(RendererCore, RendererCore_Pipeline_Implementation_RenderTargetAliasing);
@@ -79,6 +79,26 @@ EZ_ALWAYS_INLINE const ezRectFloat& ezView::GetViewport() const
   return m_Data.m_ViewPortRect;
 }
 
+EZ_ALWAYS_INLINE void ezView::SetCoherentVisibility(bool bEnable)
+{
+  m_bCoherentVisibility = bEnable;
+}
+
+EZ_ALWAYS_INLINE bool ezView::GetCoherentVisibility() const
+{
+  return m_bCoherentVisibility;
+}
+
+EZ_ALWAYS_INLINE void ezView::SetSpatialDataCategoryBitmask(ezUInt32 uiCategoryBitmask)
+{
+  m_uiSpatialDataCategoryBitmask = uiCategoryBitmask;
+}
+
+EZ_ALWAYS_INLINE ezUInt32 ezView::GetSpatialDataCategoryBitmask() const
+{
+  return m_uiSpatialDataCategoryBitmask;
+}
+
 EZ_ALWAYS_INLINE const ezViewData& ezView::GetData() const
 {
   UpdateCachedMatrices();
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <Foundation/Types/UniquePtr.h>
 #include <RendererCore/Declarations.h>
 #include <RendererCore/Pipeline/FrameDataProvider.h>
 #include <RendererCore/Shader/ConstantBufferStorage.h>
@@ -45,8 +46,17 @@ public:
   ezInstanceDataProvider();
   ~ezInstanceDataProvider();
 
+  /// \brief Returns the instance data for the render context of the given view context.
+  ///
+  /// Render contexts that record into a deferred command encoder get their own instance data,
+  /// so that passes that are recorded in parallel don't write into the same buffer.
+  ezInstanceData* GetData(const ezRenderViewContext& renderViewContext);
+
 private:
   virtual void* UpdateData(const ezRenderViewContext& renderViewContext, const ezExtractedRenderData& extractedData) override;
 
   ezInstanceData m_Data;
+
+  ezMutex m_DeferredDataMutex;
+  ezHashTable<const ezRenderContext*, ezUniquePtr<ezInstanceData>> m_DeferredData;
 };
@@ -11,6 +11,8 @@ public:
   ezSkyRenderPass(const char* szName = "SkyRenderPass");
   ~ezSkyRenderPass();
 
+  virtual bool SupportsParallelRecording() const override { return true; }
+
 protected:
   virtual void RenderObjects(const ezRenderViewContext& renderViewContext) override;
 };
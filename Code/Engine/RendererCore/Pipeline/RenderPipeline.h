@@ -4,8 +4,10 @@
 #include <Foundation/Containers/DynamicArray.h>
 #include <Foundation/Containers/HybridArray.h>
 #include <Foundation/Strings/HashedString.h>
+#include <Foundation/Threading/Mutex.h>
 #include <Foundation/Types/UniquePtr.h>
 #include <RendererCore/Pipeline/ExtractedRenderData.h>
+#include <RendererCore/Pipeline/RenderTargetAliasing.h>
 
 class ezProfilingId;
 class ezView;
@@ -15,6 +17,7 @@ struct ezPermutationVar;
 class ezDGMLGraph;
 class ezFrustum;
 class ezRasterizerView;
+class ezGALDeferredCommandEncoder;
 
 class EZ_RENDERERCORE_DLL ezRenderPipeline : public ezRefCounted
 {
@@ -59,6 +62,12 @@ public:
   ezRenderDataBatchList GetRenderDataBatchesWithCategory(
     ezRenderData::Category category, ezRenderDataBatch::Filter filter = ezRenderDataBatch::Filter()) const;
 
+  /// \brief Returns the schedule of the transient render targets, i.e. which targets share the same pool texture.
+  ///
+  /// The plan is computed whenever the pipeline is rebuilt. Its peak memory is the memory of all transient pool textures
+  /// that are in use at the same time while rendering this pipeline.
+  const ezRenderTargetAliasingPlanner& GetTransientTargetPlan() const { return m_AliasingPlanner; }
+
   /// \brief Creates a DGML graph of all passes and textures. Can be used to verify that no accidental temp textures are created due to poorly constructed pipelines or errors in code.
   void CreateDgmlGraph(ezDGMLGraph& ref_graph);
 
@@ -94,6 +103,13 @@ private:
 
   void Render(ezRenderContext* pRenderer);
 
+  void AcquirePassTextures(ezUInt32 uiPassIdx, ezUInt32& inout_uiCurrentFirstUsageIdx);
+  void ReleasePassTextures(ezUInt32 uiPassIdx, ezUInt32& inout_uiCurrentLastUsageIdx);
+  bool CanRecordPassesInParallel() const;
+
+  /// \brief Records the active passes [uiFirstPass, uiFirstPass + uiNumPasses) on worker threads and replays them in pass order into pCommandEncoder.
+  void RecordPassesInParallel(const ezRenderViewContext& renderViewContext, ezGALCommandEncoder* pCommandEncoder, ezUInt32 uiFirstPass, ezUInt32 uiNumPasses);
+
   ezRasterizerView* PrepareOcclusionCulling(const ezFrustum& frustum, const ezView& view);
   void PreviewOcclusionBuffer(const ezRasterizerView& rasterizer, const ezView& view);
 
@@ -132,6 +148,7 @@ private: // Member data
     ezHybridArray<ezRenderPipelinePassConnection*, 4> m_UsedBy;  ///< All the connections that use this texture. Due to passthrough pins, this can be larger than 1.
     ezUInt16 m_uiFirstUsageIdx;                                  ///< Used to decide when to acquire a temp texture.
     ezUInt16 m_uiLastUsageIdx;                                   ///< Used to decide when to return a temp texture.
+    ezUInt16 m_uiAliasingSlot = 0xFFFF;                          ///< The slot in m_AliasingPlanner that hosts this texture, if it is a transient pool texture.
     const ezRenderPipelineNodePin* m_pTextureProvider = nullptr; ///< If set, this node and parent pass provide an external texture to the pipeline. This could be a render target from an ezTargetPass or a history buffer that is preserved across frames. At the start of every frame the parent pass will be asked for the current value of the texture a this pin.
   };
   ezDynamicArray<TextureUsageData> m_TextureUsage;               ///< All unique textures used during the pipeline run.
@@ -140,13 +157,26 @@ private: // Member data
 
   ezHashTable<ezRenderPipelinePassConnection*, ezUInt32> m_ConnectionToTextureIndex;
 
+  ezRenderTargetAliasingPlanner m_AliasingPlanner;            ///< Decides which transient textures share the same pool texture.
+  ezDynamicArray<ezGALTextureHandle> m_AliasingSlotTextures; ///< The pool texture of each slot while it is alive during Render().
+
   // Extractors
   ezDynamicArray<ezUniquePtr<ezExtractor>> m_Extractors;
   ezDynamicArray<ezUniquePtr<ezExtractor>> m_SortedExtractors;
 
   // Data Providers
+  mutable ezMutex m_DataProviderMutex;
   mutable ezDynamicArray<ezUniquePtr<ezFrameDataProviderBase>> m_DataProviders;
   mutable ezHashTable<const ezRTTI*, ezUInt32> m_TypeToDataProviderIndex;
+  bool m_bDataProvidersChanged = true; ///< Whether the last Render() created new data providers. Passes are only recorded in parallel once all data providers exist.
+
+  // Parallel recording
+  struct PassRecorder
+  {
+    ezUniquePtr<ezGALDeferredCommandEncoder> m_pCommandEncoder;
+    ezRenderContext* m_pRenderContext = nullptr;
+  };
+  ezDynamicArray<PassRecorder> m_PassRecorders; ///< One per pass in the largest run of passes that was recorded in parallel so far.
 
   ezDynamicArray<ezPermutationVar> m_PermutationVars;
 
@@ -67,6 +67,12 @@ public:
   /// \brief Allows for the pass to write data back using ezView::SetRenderPassReadBackProperty. E.g. picking results etc.
   virtual void ReadBackProperties(ezView* pView);
 
+  /// \brief Whether Execute() may run on another thread and record into a deferred command encoder, in parallel to other passes.
+  ///
+  /// The pass must only use the render context of the given view context and must not read back any GPU results.
+  /// Renderers that don't support parallel recording are still called by only one thread at a time, see ezRenderer::SupportsParallelRecording().
+  virtual bool SupportsParallelRecording() const { return false; }
+
   virtual ezResult Serialize(ezStreamWriter& inout_stream) const;
   virtual ezResult Deserialize(ezStreamReader& inout_stream);
 
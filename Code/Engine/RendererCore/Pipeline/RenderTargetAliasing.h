@@ -0,0 +1,63 @@
+#pragma once
+
+#include <Foundation/Containers/DynamicArray.h>
+#include <RendererCore/RendererCoreDLL.h>
+#include <RendererFoundation/Descriptors/Descriptors.h>
+
+/// \brief Plans which transient render targets of a render pipeline can share the same texture.
+///
+/// Every target has a lifetime, the range of pass indices from its first to its last usage. Targets whose lifetimes don't overlap
+/// and whose descriptions only differ in their usage flags (SRV, UAV, render target, dynamic mip generation) are packed into the same slot.
+/// Each slot is one texture from the ezGPUResourcePool with the union of the usage flags of all targets it hosts.
+/// This turns the reuse of pool textures into a deterministic schedule instead of relying on exactly matching descriptions.
+///
+/// The planner only works on descriptions and sizes, so it does not need a GPU device.
+class EZ_RENDERERCORE_DLL ezRenderTargetAliasingPlanner
+{
+public:
+  struct Target
+  {
+    ezGALTextureCreationDescription m_Desc;
+    ezUInt64 m_uiMemorySize = 0; ///< Usually ezGALDevice::GetMemoryConsumptionForTexture() of m_Desc.
+    ezUInt16 m_uiFirstUsageIdx = 0;
+    ezUInt16 m_uiLastUsageIdx = 0;
+  };
+
+  struct Slot
+  {
+    ezGALTextureCreationDescription m_Desc; ///< The description of the first target, with the usage flags of all targets in this slot.
+    ezUInt64 m_uiMemorySize = 0;
+    ezUInt16 m_uiFirstUsageIdx = 0; ///< First usage of the first target, the texture has to be acquired before this pass.
+    ezUInt16 m_uiLastUsageIdx = 0;  ///< Last usage of the last target, the texture can be returned after this pass.
+  };
+
+  /// \brief Computes the slots for the given targets. Replaces the previous plan.
+  void Plan(ezArrayPtr<const Target> targets);
+
+  /// \brief Forgets the current plan.
+  void Clear();
+
+  ezArrayPtr<const Slot> GetSlots() const { return m_Slots; }
+
+  /// \brief Returns the slot that hosts the target with the given index, as passed to Plan().
+  ezUInt16 GetSlotForTarget(ezUInt32 uiTargetIdx) const { return m_TargetToSlot[uiTargetIdx]; }
+
+  /// \brief The maximum memory of all slots that are alive during the same pass.
+  ezUInt64 GetPeakMemory() const { return m_uiPeakMemory; }
+
+  /// \brief The maximum memory of all targets that are alive during the same pass, i.e. the best case without merging descriptions.
+  ezUInt64 GetPeakMemoryWithoutAliasing() const { return m_uiPeakMemoryWithoutAliasing; }
+
+  /// \brief The memory of all targets, if each of them had its own texture.
+  ezUInt64 GetTotalMemoryWithoutAliasing() const { return m_uiTotalMemoryWithoutAliasing; }
+
+  /// \brief Whether two targets can use the same texture, if their lifetimes don't overlap.
+  static bool AreDescriptionsCompatible(const ezGALTextureCreationDescription& a, const ezGALTextureCreationDescription& b);
+
+private:
+  ezDynamicArray<Slot> m_Slots;
+  ezDynamicArray<ezUInt16> m_TargetToSlot;
+  ezUInt64 m_uiPeakMemory = 0;
+  ezUInt64 m_uiPeakMemoryWithoutAliasing = 0;
+  ezUInt64 m_uiTotalMemoryWithoutAliasing = 0;
+};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <Foundation/Threading/Mutex.h>
 #include <RendererCore/Pipeline/RenderData.h>
 
 /// \brief This is the base class for types that handle rendering of different object types.
@@ -14,4 +15,15 @@ public:
   virtual void GetSupportedRenderDataCategories(ezHybridArray<ezRenderData::Category, 8>& ref_categories) const = 0;
 
   virtual void RenderBatch(const ezRenderViewContext& renderViewContext, const ezRenderPipelinePass* pPass, const ezRenderDataBatch& batch) const = 0;
+
+  /// \brief Whether RenderBatch() may be called by several threads at the same time, when passes are recorded in parallel.
+  ///
+  /// Renderers that return false are locked while they render a batch into a deferred command encoder.
+  /// Renderers that return true must not keep any state between calls and must not rely on the order in which batches are recorded.
+  virtual bool SupportsParallelRecording() const { return false; }
+
+private:
+  friend class ezRenderPipelinePass;
+
+  mutable ezMutex m_ParallelRecordingMutex;
 };
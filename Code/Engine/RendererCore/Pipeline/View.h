@@ -75,6 +75,19 @@ public:
   void SetViewport(const ezRectFloat& viewport);
   const ezRectFloat& GetViewport() const;
 
+  /// \brief Enables coherent visibility culling, which reuses the culling results of the previous frame for unchanged parts of the scene.
+  ///
+  /// Reduces the culling cost of views whose camera rarely moves, e.g. surveillance or spectator cameras.
+  /// Occlusion culling results may lag behind moving occluders by a few frames (see 'Spatial.Queries.CoherentRevalidationFrames').
+  void SetCoherentVisibility(bool bEnable);
+  bool GetCoherentVisibility() const;
+
+  /// \brief Sets which spatial data categories are rendered by this view.
+  ///
+  /// Defaults to ezDefaultSpatialDataCategories::RenderStatic and RenderDynamic. Can be used to e.g. only render the dynamic objects on top of cached content.
+  void SetSpatialDataCategoryBitmask(ezUInt32 uiCategoryBitmask);
+  ezUInt32 GetSpatialDataCategoryBitmask() const;
+
   /// \brief Forces the render pipeline to be rebuilt.
   void ForceUpdate();
 
@@ -182,6 +195,9 @@ private:
   ezDynamicArray<ezPermutationVar> m_PermutationVars;
   bool m_bPermutationVarsDirty = false;
 
+  bool m_bCoherentVisibility = false;
+  ezUInt32 m_uiSpatialDataCategoryBitmask = 0;
+
   void ApplyPermutationVars();
 
   struct PropertyValue
@@ -5,6 +5,7 @@
 #include <Foundation/Profiling/Profiling.h>
 #include <Foundation/SimdMath/SimdBBox.h>
 #include <Foundation/SimdMath/SimdConversion.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <RendererCore/Rasterizer/RasterizerObject.h>
 #include <RendererCore/Rasterizer/RasterizerView.h>
 #include <RendererCore/Rasterizer/Thirdparty/Occluder.h>
@@ -12,6 +13,7 @@
 
 ezCVarInt cvar_SpatialCullingOcclusionMaxResolution("Spatial.Occlusion.MaxResolution", 512, ezCVarFlags::Default, "Max resolution for occlusion buffers.");
 ezCVarInt cvar_SpatialCullingOcclusionMaxOccluders("Spatial.Occlusion.MaxOccluders", 64, ezCVarFlags::Default, "Max number of occluders to rasterize per frame.");
+ezCVarBool cvar_SpatialCullingOcclusionMultithreading("Spatial.Occlusion.Multithreading", true, ezCVarFlags::Default, "Rasterize the occlusion buffer in screen tiles on multiple threads.");
 
 ezRasterizerView::ezRasterizerView() = default;
 ezRasterizerView::~ezRasterizerView() = default;
@@ -75,6 +77,17 @@ void ezRasterizerView::RasterizeObjects(ezUInt32 uiMaxObjects)
 {
 #if EZ_ENABLED(EZ_RASTERIZER_SUPPORTED)
 
+  if (cvar_SpatialCullingOcclusionMultithreading)
+  {
+    const ezUInt32 uiNumTiles = ezMath::Min(ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks), m_uiResolutionY / 8);
+
+    if (uiNumTiles > 1)
+    {
+      RasterizeObjectsTiled(uiMaxObjects, uiNumTiles);
+      return;
+    }
+  }
+
   EZ_PROFILE_SCOPE("Occlusion::RasterizeObjects");
 
   for (const Instance& inst : m_Instances)
@@ -104,6 +117,120 @@ void ezRasterizerView::RasterizeObjects(ezUInt32 uiMaxObjects)
 #endif
 }
 
+void ezRasterizerView::RasterizeObjectsTiled(ezUInt32 uiMaxObjects, ezUInt32 uiNumTiles)
+{
+#if EZ_ENABLED(EZ_RASTERIZER_SUPPORTED)
+
+  EZ_PROFILE_SCOPE("Occlusion::RasterizeObjectsTiled");
+
+  const ezUInt32 uiNumInstances = m_Instances.GetCount();
+  m_TransformedInstances.SetCountUninitialized(uiNumInstances);
+
+  // transform the bounds of all occluders to screen space
+  ezTaskSystem::ParallelForIndexed(
+    0, uiNumInstances,
+    [this](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex)
+    {
+      for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+      {
+        const Instance& inst = m_Instances[i];
+        const Occluder& occluder = inst.m_pObject->m_Occluder;
+        TransformedInstance& transformed = m_TransformedInstances[i];
+
+        const ezMat4 mMVP = m_mViewProjection * inst.m_Transform.GetAsMat4();
+        m_pRasterizer->computeModelViewProjection(mMVP.m_fElementsCM, transformed.m_fModelViewProjection);
+
+        Rasterizer::ScreenBounds bounds;
+        transformed.m_bOnScreen = m_pRasterizer->projectBounds(transformed.m_fModelViewProjection, occluder.m_boundsMin, occluder.m_boundsMax, bounds);
+        transformed.m_bNeedsClipping = bounds.needsClipping;
+        transformed.m_uiMinX = bounds.minX;
+        transformed.m_uiMaxX = bounds.maxX;
+        transformed.m_uiMinY = bounds.minY;
+        transformed.m_uiMaxY = bounds.maxY;
+        transformed.m_uiMaxZ = bounds.maxZ;
+      }
+    },
+    "Occlusion::TransformOccluders", ezTaskNesting::Never);
+
+  // split the buffer into horizontal strips of whole 8x8 blocks
+  const ezUInt32 uiNumBlocksY = m_uiResolutionY / 8;
+  m_Tiles.SetCount(uiNumTiles);
+
+  for (ezUInt32 t = 0; t < uiNumTiles; ++t)
+  {
+    Tile& tile = m_Tiles[t];
+    tile.m_uiMinY = (uiNumBlocksY * t / uiNumTiles) * 8;
+    tile.m_uiMaxY = (uiNumBlocksY * (t + 1) / uiNumTiles) * 8 - 1;
+    tile.m_bAnyOccludersRasterized = false;
+    tile.m_Instances.Clear();
+  }
+
+  // Bin the closest occluders on screen into the strips they overlap, this keeps the front to back order within each strip.
+  // The limit has to be applied here, once for the whole view. Unlike in the single-threaded path, occluders that turn out to be hidden
+  // by closer ones still count towards it, since that is only known per strip.
+  ezUInt32 uiNumSelected = 0;
+  for (ezUInt32 i = 0; i < uiNumInstances && uiNumSelected < uiMaxObjects; ++i)
+  {
+    const TransformedInstance& transformed = m_TransformedInstances[i];
+
+    if (!transformed.m_bOnScreen)
+      continue;
+
+    ++uiNumSelected;
+
+    for (Tile& tile : m_Tiles)
+    {
+      if (transformed.m_uiMinY <= tile.m_uiMaxY && transformed.m_uiMaxY >= tile.m_uiMinY)
+      {
+        tile.m_Instances.PushBack(i);
+      }
+    }
+  }
+
+  // every strip only writes to its own blocks
+  ezTaskSystem::ParallelForIndexed(
+    0, uiNumTiles,
+    [this](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex)
+    {
+      const ezUInt32 uiNumBlocksX = m_uiResolutionX / 8;
+
+      for (ezUInt32 t = uiStartIndex; t < uiEndIndex; ++t)
+      {
+        Tile& tile = m_Tiles[t];
+
+        for (ezUInt32 i : tile.m_Instances)
+        {
+          const TransformedInstance& transformed = m_TransformedInstances[i];
+          const Occluder& occluder = m_Instances[i].m_pObject->m_Occluder;
+
+          if (transformed.m_bNeedsClipping)
+          {
+            m_pRasterizer->rasterize<true>(occluder, transformed.m_fModelViewProjection, 0, tile.m_uiMinY / 8, uiNumBlocksX, (tile.m_uiMaxY + 1) / 8);
+          }
+          else
+          {
+            const ezUInt32 uiMinY = ezMath::Max(transformed.m_uiMinY, tile.m_uiMinY);
+            const ezUInt32 uiMaxY = ezMath::Min(transformed.m_uiMaxY, tile.m_uiMaxY);
+
+            if (!m_pRasterizer->query2D(transformed.m_uiMinX, transformed.m_uiMaxX, uiMinY, uiMaxY, transformed.m_uiMaxZ))
+              continue;
+
+            m_pRasterizer->rasterize<false>(occluder, transformed.m_fModelViewProjection, 0, tile.m_uiMinY / 8, uiNumBlocksX, (tile.m_uiMaxY + 1) / 8);
+          }
+
+          tile.m_bAnyOccludersRasterized = true;
+        }
+      }
+    },
+    "Occlusion::RasterizeTiles", ezTaskNesting::Never);
+
+  for (const Tile& tile : m_Tiles)
+  {
+    m_bAnyOccludersRasterized |= tile.m_bAnyOccludersRasterized;
+  }
+#endif
+}
+
 void ezRasterizerView::UpdateViewProjectionMatrix()
 {
   ezMat4 mProjection;
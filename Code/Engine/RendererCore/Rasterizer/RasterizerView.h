@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Foundation/Containers/Deque.h>
+#include <Foundation/Containers/DynamicArray.h>
 #include <Foundation/Math/Transform.h>
 #include <Foundation/Threading/Mutex.h>
 #include <Foundation/Types/ArrayPtr.h>
@@ -65,6 +66,7 @@ public:
 private:
   void SortObjectsFrontToBack();
   void RasterizeObjects(ezUInt32 uiMaxObjects);
+  void RasterizeObjectsTiled(ezUInt32 uiMaxObjects, ezUInt32 uiNumTiles);
   void UpdateViewProjectionMatrix();
   void ApplyModelViewProjectionMatrix(const ezTransform& modelTransform);
 
@@ -83,6 +85,31 @@ private:
 
   ezDeque<Instance> m_Instances;
   ezMat4 m_mViewProjection;
+
+  /// \brief Per instance data that is computed up front for the multi-threaded rasterization.
+  struct TransformedInstance
+  {
+    float m_fModelViewProjection[16];
+    ezUInt32 m_uiMinX;
+    ezUInt32 m_uiMaxX;
+    ezUInt32 m_uiMinY;
+    ezUInt32 m_uiMaxY;
+    ezUInt16 m_uiMaxZ;
+    bool m_bOnScreen;
+    bool m_bNeedsClipping;
+  };
+
+  /// \brief A horizontal strip of the occlusion buffer, together with the sorted list of the instances that overlap it.
+  struct Tile
+  {
+    ezUInt32 m_uiMinY = 0;
+    ezUInt32 m_uiMaxY = 0;
+    bool m_bAnyOccludersRasterized = false;
+    ezDynamicArray<ezUInt32> m_Instances;
+  };
+
+  ezDynamicArray<TransformedInstance> m_TransformedInstances;
+  ezDynamicArray<Tile> m_Tiles;
 };
 
 class ezRasterizerViewPool
@@ -317,6 +317,18 @@ void Rasterizer::setModelViewProjection(const float* matrix)
   _mm_storeu_ps(m_modelViewProjectionRaw + 8, mat2);
   _mm_storeu_ps(m_modelViewProjectionRaw + 12, mat3);
 
+  computeModelViewProjection(matrix, m_modelViewProjection);
+}
+
+void Rasterizer::computeModelViewProjection(const float* matrix, float* target) const
+{
+  __m128 mat0 = _mm_loadu_ps(matrix + 0);
+  __m128 mat1 = _mm_loadu_ps(matrix + 4);
+  __m128 mat2 = _mm_loadu_ps(matrix + 8);
+  __m128 mat3 = _mm_loadu_ps(matrix + 12);
+
+  _MM_TRANSPOSE4_PS(mat0, mat1, mat2, mat3);
+
   // Bake viewport transform into matrix and 6shift by half a block
   mat0 = _mm_mul_ps(_mm_add_ps(mat0, mat3), _mm_set1_ps(m_width * 0.5f - 4.0f));
   mat1 = _mm_mul_ps(_mm_add_ps(mat1, mat3), _mm_set1_ps(m_height * 0.5f - 4.0f));
@@ -327,10 +339,10 @@ void Rasterizer::setModelViewProjection(const float* matrix)
   _MM_TRANSPOSE4_PS(mat0, mat1, mat2, mat3);
 
   // Store prebaked cols
-  _mm_storeu_ps(m_modelViewProjection + 0, mat0);
-  _mm_storeu_ps(m_modelViewProjection + 4, mat1);
-  _mm_storeu_ps(m_modelViewProjection + 8, mat2);
-  _mm_storeu_ps(m_modelViewProjection + 12, mat3);
+  _mm_storeu_ps(target + 0, mat0);
+  _mm_storeu_ps(target + 4, mat1);
+  _mm_storeu_ps(target + 8, mat2);
+  _mm_storeu_ps(target + 12, mat3);
 }
 
 void Rasterizer::clear()
@@ -350,6 +362,25 @@ void Rasterizer::clear()
 }
 
 bool Rasterizer::queryVisibility(__m128 boundsMin, __m128 boundsMax, bool& needsClipping)
+{
+  ScreenBounds bounds;
+  if (!projectBounds(m_modelViewProjection, boundsMin, boundsMax, bounds))
+  {
+    needsClipping = false;
+    return false;
+  }
+
+  needsClipping = bounds.needsClipping;
+
+  if (needsClipping)
+  {
+    return true;
+  }
+
+  return query2D(bounds.minX, bounds.maxX, bounds.minY, bounds.maxY, bounds.maxZ);
+}
+
+bool Rasterizer::projectBounds(const float* modelViewProjection, __m128 boundsMin, __m128 boundsMax, ScreenBounds& out) const
 {
   // Frustum culling is not necessary, because EZ only calls this functions for objects that are definitely inside the frustum
   //
@@ -398,10 +429,10 @@ bool Rasterizer::queryVisibility(__m128 boundsMin, __m128 boundsMax, bool& needs
   // }
 
   // Load prebaked projection matrix
-  __m128 col0 = _mm_loadu_ps(m_modelViewProjection + 0);
-  __m128 col1 = _mm_loadu_ps(m_modelViewProjection + 4);
-  __m128 col2 = _mm_loadu_ps(m_modelViewProjection + 8);
-  __m128 col3 = _mm_loadu_ps(m_modelViewProjection + 12);
+  __m128 col0 = _mm_loadu_ps(modelViewProjection + 0);
+  __m128 col1 = _mm_loadu_ps(modelViewProjection + 4);
+  __m128 col2 = _mm_loadu_ps(modelViewProjection + 8);
+  __m128 col3 = _mm_loadu_ps(modelViewProjection + 12);
 
   // Transform edges
   __m128 egde0 = _mm_mul_ps(col0, _mm_broadcastss_ps(extents));
@@ -439,11 +470,17 @@ bool Rasterizer::queryVisibility(__m128 boundsMin, __m128 boundsMax, bool& needs
   __m128 closeToNearPlane = _mm_or_ps(_mm_cmplt_ps(corners[3], nearPlaneEpsilon), _mm_cmplt_ps(corners[7], nearPlaneEpsilon));
   if (!_mm_testz_ps(closeToNearPlane, closeToNearPlane))
   {
-    needsClipping = true;
+    // The screen space bounds are unknown, assume the whole screen
+    out.minX = 0;
+    out.maxX = m_width - 1;
+    out.minY = 0;
+    out.maxY = m_height - 1;
+    out.maxZ = 0xFFFF;
+    out.needsClipping = true;
     return true;
   }
 
-  needsClipping = false;
+  out.needsClipping = false;
 
   // Perspective division
   corners[3] = _mm_rcp_ps(corners[3]);
@@ -500,19 +537,14 @@ bool Rasterizer::queryVisibility(__m128 boundsMin, __m128 boundsMax, bool& needs
     return false;
   }
 
-  uint32_t minX = bounds[0];
-  uint32_t maxX = bounds[1];
-  uint32_t minY = bounds[2];
-  uint32_t maxY = bounds[3];
+  out.minX = bounds[0];
+  out.maxX = bounds[1];
+  out.minY = bounds[2];
+  out.maxY = bounds[3];
 
   __m128i depth = packDepthPremultiplied(corners[2], corners[6]);
 
-  uint16_t maxZ = uint16_t(0xFFFF ^ _mm_extract_epi16(_mm_minpos_epu16(_mm_xor_si128(depth, _mm_set1_epi16(-1))), 0));
-
-  if (!query2D(minX, maxX, minY, maxY, maxZ))
-  {
-    return false;
-  }
+  out.maxZ = uint16_t(0xFFFF ^ _mm_extract_epi16(_mm_minpos_epu16(_mm_xor_si128(depth, _mm_set1_epi16(-1))), 0));
 
   return true;
 }
@@ -854,6 +886,12 @@ void Rasterizer::precomputeRasterizationTable()
 
 template <bool possiblyNearClipped>
 void Rasterizer::rasterize(const Occluder& occluder)
+{
+  rasterize<possiblyNearClipped>(occluder, m_modelViewProjection, 0, 0, m_blocksX, m_blocksY);
+}
+
+template <bool possiblyNearClipped>
+void Rasterizer::rasterize(const Occluder& occluder, const float* modelViewProjection, uint32_t blockMinX, uint32_t blockMinY, uint32_t blockMaxX, uint32_t blockMaxY)
 {
   const __m256i* vertexData = occluder.m_vertexData;
   size_t packetCount = occluder.m_packetCount;
@@ -862,10 +900,10 @@ void Rasterizer::rasterize(const Occluder& occluder)
   __m256i maskZ = _mm256_set1_epi32(1023);
 
   // Note that unaligned loads do not have a latency penalty on CPUs with SSE4 support
-  __m128 mat0 = _mm_loadu_ps(m_modelViewProjection + 0);
-  __m128 mat1 = _mm_loadu_ps(m_modelViewProjection + 4);
-  __m128 mat2 = _mm_loadu_ps(m_modelViewProjection + 8);
-  __m128 mat3 = _mm_loadu_ps(m_modelViewProjection + 12);
+  __m128 mat0 = _mm_loadu_ps(modelViewProjection + 0);
+  __m128 mat1 = _mm_loadu_ps(modelViewProjection + 4);
+  __m128 mat2 = _mm_loadu_ps(modelViewProjection + 8);
+  __m128 mat3 = _mm_loadu_ps(modelViewProjection + 12);
 
   __m128 boundsMin = occluder.m_refMin;
   __m128 boundsExtents = _mm_sub_ps(occluder.m_refMax, boundsMin);
@@ -1167,12 +1205,12 @@ void Rasterizer::rasterize(const Occluder& occluder)
       maxFy = _mm256_max_ps(_mm256_max_ps(y0, y1), _mm256_max_ps(y2, y3));
     }
 
-    // Clamp and round
+    // Clamp and round, only blocks within the given block range are touched
     __m256i minX, minY, maxX, maxY;
-    minX = _mm256_max_epi32(_mm256_cvttps_epi32(_mm256_add_ps(minFx, _mm256_set1_ps(4.9999f / 8.0f))), _mm256_setzero_si256());
-    minY = _mm256_max_epi32(_mm256_cvttps_epi32(_mm256_add_ps(minFy, _mm256_set1_ps(4.9999f / 8.0f))), _mm256_setzero_si256());
-    maxX = _mm256_min_epi32(_mm256_cvttps_epi32(_mm256_add_ps(maxFx, _mm256_set1_ps(11.0f / 8.0f))), _mm256_set1_epi32(m_blocksX));
-    maxY = _mm256_min_epi32(_mm256_cvttps_epi32(_mm256_add_ps(maxFy, _mm256_set1_ps(11.0f / 8.0f))), _mm256_set1_epi32(m_blocksY));
+    minX = _mm256_max_epi32(_mm256_cvttps_epi32(_mm256_add_ps(minFx, _mm256_set1_ps(4.9999f / 8.0f))), _mm256_set1_epi32(blockMinX));
+    minY = _mm256_max_epi32(_mm256_cvttps_epi32(_mm256_add_ps(minFy, _mm256_set1_ps(4.9999f / 8.0f))), _mm256_set1_epi32(blockMinY));
+    maxX = _mm256_min_epi32(_mm256_cvttps_epi32(_mm256_add_ps(maxFx, _mm256_set1_ps(11.0f / 8.0f))), _mm256_set1_epi32(blockMaxX));
+    maxY = _mm256_min_epi32(_mm256_cvttps_epi32(_mm256_add_ps(maxFy, _mm256_set1_ps(11.0f / 8.0f))), _mm256_set1_epi32(blockMaxY));
 
     // Check overlap between bounding box and frustum
     __m256i inFrustum = _mm256_and_si256(_mm256_cmpgt_epi32(maxX, minX), _mm256_cmpgt_epi32(maxY, minY));
@@ -1546,5 +1584,7 @@ void Rasterizer::rasterize(const Occluder& occluder)
 // Force template instantiations
 template void Rasterizer::rasterize<true>(const Occluder& occluder);
 template void Rasterizer::rasterize<false>(const Occluder& occluder);
+template void Rasterizer::rasterize<true>(const Occluder& occluder, const float* modelViewProjection, uint32_t blockMinX, uint32_t blockMinY, uint32_t blockMaxX, uint32_t blockMaxY);
+template void Rasterizer::rasterize<false>(const Occluder& occluder, const float* modelViewProjection, uint32_t blockMinX, uint32_t blockMinY, uint32_t blockMaxX, uint32_t blockMaxY);
 
 #endif
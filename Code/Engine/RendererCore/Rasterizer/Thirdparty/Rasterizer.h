@@ -13,15 +13,39 @@ class Rasterizer
 {
 public:
 #if EZ_ENABLED(EZ_RASTERIZER_SUPPORTED)
+  /// Pixel rectangle (inclusive) and nearest depth of a projected bounding box.
+  struct ScreenBounds
+  {
+    uint32_t minX;
+    uint32_t maxX;
+    uint32_t minY;
+    uint32_t maxY;
+    uint16_t maxZ;
+    bool needsClipping;
+  };
+
   Rasterizer(uint32_t width, uint32_t height);
   void setModelViewProjection(const float* matrix);
   void clear();
 
+  /// Writes the prebaked form of the given matrix, as used by rasterize() and projectBounds(), to target (16 floats).
+  /// Does not modify the rasterizer, so it may be called from multiple threads.
+  void computeModelViewProjection(const float* matrix, float* target) const;
+
   template <bool possiblyNearClipped>
   void rasterize(const Occluder& occluder);
 
+  /// Rasterizes the occluder with the given prebaked matrix, but only touches the blocks in [blockMin, blockMax).
+  /// Calls with disjoint block ranges may run concurrently.
+  template <bool possiblyNearClipped>
+  void rasterize(const Occluder& occluder, const float* modelViewProjection, uint32_t blockMinX, uint32_t blockMinY, uint32_t blockMaxX, uint32_t blockMaxY);
+
   bool queryVisibility(__m128 boundsMin, __m128 boundsMax, bool& needsClipping);
 
+  /// Projects the bounding box with the given prebaked matrix. Returns false, if it does not cover any pixel.
+  /// If the box is close to the near plane, the bounds cover the whole screen and needsClipping is set.
+  bool projectBounds(const float* modelViewProjection, __m128 boundsMin, __m128 boundsMax, ScreenBounds& out) const;
+
   bool query2D(uint32_t minX, uint32_t maxX, uint32_t minY, uint32_t maxY, uint32_t maxZ) const;
 
   void readBackDepth(void* target) const;
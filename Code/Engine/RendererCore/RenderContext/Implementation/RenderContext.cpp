@@ -21,6 +21,7 @@ ezRenderContext* ezRenderContext::s_pDefaultInstance = nullptr;
 ezGALCommandEncoder* ezRenderContext::s_pCommandEncoder = nullptr;
 ezHybridArray<ezRenderContext*, 4> ezRenderContext::s_Instances;
 
+ezMutex ezRenderContext::s_GALVertexDeclarationsMutex;
 ezMap<ezRenderContext::ShaderVertexDecl, ezGALVertexDeclarationHandle> ezRenderContext::s_GALVertexDeclarations;
 
 ezMutex ezRenderContext::s_ConstantBufferStorageMutex;
@@ -782,6 +783,42 @@ void ezRenderContext::ResetContextState()
   m_BoundConstantBuffers.Clear();
 }
 
+void ezRenderContext::CopyContextState(const ezRenderContext& source)
+{
+  EZ_ASSERT_DEV(!m_bRendering && !m_bCompute, "The state can't be copied inside a rendering or compute scope");
+
+  ResetContextState();
+
+  m_PermutationVariables = source.m_PermutationVariables;
+  m_hNewMaterial = source.m_hNewMaterial;
+  m_hActiveShader = source.m_hActiveShader;
+  m_ShaderBindFlags = source.m_ShaderBindFlags;
+  m_DefaultTextureFilter = source.m_DefaultTextureFilter;
+  m_bAllowAsyncShaderLoading = source.m_bAllowAsyncShaderLoading;
+
+  m_BoundTextures2D = source.m_BoundTextures2D;
+  m_BoundTextures3D = source.m_BoundTextures3D;
+  m_BoundTexturesCube = source.m_BoundTexturesCube;
+  m_BoundTextureUAVs = source.m_BoundTextureUAVs;
+  m_BoundSamplers = source.m_BoundSamplers;
+  m_BoundBuffer = source.m_BoundBuffer;
+  m_BoundBufferUAVs = source.m_BoundBufferUAVs;
+
+  // the global and push constants of the source are replaced by the storages of this context
+  for (auto it = source.m_BoundConstantBuffers.GetIterator(); it.IsValid(); ++it)
+  {
+    const ezConstantBufferStorageHandle hStorage = it.Value().m_hConstantBufferStorage;
+    if (hStorage != source.m_hGlobalConstantBufferStorage && hStorage != source.m_hPushConstantsStorage)
+    {
+      m_BoundConstantBuffers.Insert(it.Key(), it.Value());
+    }
+  }
+
+  WriteGlobalConstants() = source.ReadGlobalConstants();
+
+  m_DeferredConstantBufferHashes.Clear();
+}
+
 ezGlobalConstants& ezRenderContext::WriteGlobalConstants()
 {
   ezConstantBufferStorage<ezGlobalConstants>* pStorage = nullptr;
@@ -1012,6 +1049,8 @@ ezResult ezRenderContext::BuildVertexDeclaration(ezGALShaderHandle hShader, cons
   svd.m_hShader = hShader;
   svd.m_uiVertexDeclarationHash = decl.m_uiHash;
 
+  EZ_LOCK(s_GALVertexDeclarationsMutex);
+
   bool bExisted = false;
   auto it = s_GALVertexDeclarations.FindOrAdd(svd, &bExisted);
 
@@ -1076,7 +1115,25 @@ void ezRenderContext::UploadConstants()
     ezConstantBufferStorageBase* pConstantBufferStorage = nullptr;
     if (TryGetConstantBufferStorage(hConstantBufferStorage, pConstantBufferStorage))
     {
-      pConstantBufferStorage->UploadData(m_pGALCommandEncoder);
+      if (m_pGALCommandEncoder->IsDeferred() && hConstantBufferStorage != m_hGlobalConstantBufferStorage && hConstantBufferStorage != m_hPushConstantsStorage)
+      {
+        // Other contexts may record with the same storage at the same time, so the shared modification state can't be used.
+        bool bExisted = false;
+        ezUInt32& uiLastHash = m_DeferredConstantBufferHashes.FindOrAdd(hConstantBufferStorage.m_InternalId.m_Data, &bExisted);
+        if (!bExisted)
+        {
+          uiLastHash = 0;
+        }
+
+        if (!bExisted || pConstantBufferStorage->HasBeenModified())
+        {
+          pConstantBufferStorage->UploadData(m_pGALCommandEncoder, uiLastHash);
+        }
+      }
+      else
+      {
+        pConstantBufferStorage->UploadData(m_pGALCommandEncoder);
+      }
     }
   }
 }
@@ -193,6 +193,17 @@ public:
   ezResult ApplyContextStates(bool bForce = false);
   void ResetContextState();
 
+  /// \brief Copies the bindings, permutation variables, material, shader and global constants of another context.
+  ///
+  /// Used to start recording into a deferred command encoder with the same state that the high level code has set up on the main context.
+  /// Mesh buffers are not copied and all GAL states are set again on the next draw or dispatch.
+  void CopyContextState(const ezRenderContext& source);
+
+  /// \brief Marks all states as changed without resetting them, so that they are set again on the command encoder with the next draw or dispatch.
+  ///
+  /// Needs to be called when commands were sent to the command encoder that didn't go through this context, e.g. when replaying a deferred command encoder.
+  void InvalidateContextState() { m_StateFlags = ezRenderContextFlags::AllStatesInvalid; }
+
   ezGlobalConstants& WriteGlobalConstants();
   const ezGlobalConstants& ReadGlobalConstants() const;
 
@@ -361,6 +372,7 @@ private:
 
   static ezResult BuildVertexDeclaration(ezGALShaderHandle hShader, const ezVertexDeclarationInfo& decl, ezGALVertexDeclarationHandle& out_Declaration);
 
+  static ezMutex s_GALVertexDeclarationsMutex;
   static ezMap<ShaderVertexDecl, ezGALVertexDeclarationHandle> s_GALVertexDeclarations;
 
   static ezMutex s_ConstantBufferStorageMutex;
@@ -373,6 +385,9 @@ private: // Per Renderer States
   bool m_bRendering = false;
   bool m_bCompute = false;
 
+  // Hash of the last upload of each shared constant buffer storage, when recording into a deferred command encoder.
+  ezHashTable<ezUInt32, ezUInt32> m_DeferredConstantBufferHashes;
+
   // Member Functions
   void UploadConstants();
 
@@ -62,6 +62,8 @@ namespace
   using CachedRenderDataPerComponent = ezHybridArray<const ezRenderData*, 4>;
   static ezHashTable<ezComponentHandle, CachedRenderDataPerComponent> s_CachedRenderData;
   static ezDynamicArray<const ezRenderData*> s_DeletedRenderData;
+  static ezHashTable<ezUInt32, ezUInt32> s_StaticRenderDataVersions; // world index -> version, protected by s_CachedRenderDataMutex
+  static ezUInt32 s_uiAllStaticRenderDataVersion = 0;
 
   enum
   {
@@ -130,9 +132,14 @@ EZ_BEGIN_SUBSYSTEM_DECLARATION(RendererCore, RenderWorld)
     "Core"
   END_SUBSYSTEM_DEPENDENCIES
 
-  ON_HIGHLEVELSYSTEMS_STARTUP
+  ON_CORESYSTEMS_STARTUP
   {
-    ezRenderWorld::OnEngineStartup();
+    ezRenderWorld::OnCoreStartup();
+  }
+
+  ON_CORESYSTEMS_SHUTDOWN
+  {
+    ezRenderWorld::OnCoreShutdown();
   }
 
   ON_HIGHLEVELSYSTEMS_SHUTDOWN
@@ -307,6 +314,8 @@ void ezRenderWorld::DeleteAllCachedRenderData()
 
       cachedRenderDataPerComponent.Clear();
     }
+
+    ++s_uiAllStaticRenderDataVersion;
   }
 }
 
@@ -327,9 +336,17 @@ void ezRenderWorld::DeleteCachedRenderData(const ezGameObjectHandle& hOwnerObjec
     }
 
     s_CachedRenderData.Remove(hOwnerComponent);
+
+    IncreaseStaticRenderDataVersion(hOwnerObject);
   }
 }
 
+void ezRenderWorld::IncreaseStaticRenderDataVersion(const ezGameObjectHandle& hOwnerObject)
+{
+  // only called with s_CachedRenderDataMutex locked
+  ++s_StaticRenderDataVersions[hOwnerObject.GetInternalID().m_WorldIndex];
+}
+
 void ezRenderWorld::ResetRenderDataCache(ezView& ref_view)
 {
   ref_view.m_pRenderDataCache->m_PerObjectCaches.Clear();
@@ -366,6 +383,8 @@ void ezRenderWorld::DeleteCachedRenderDataForObject(const ezGameObject* pOwnerOb
       }
 
       s_CachedRenderData.Remove(hComponent);
+
+      IncreaseStaticRenderDataVersion(pOwnerObject->GetHandle());
     }
   }
 }
@@ -380,6 +399,15 @@ void ezRenderWorld::DeleteCachedRenderDataForObjectRecursive(const ezGameObject*
   }
 }
 
+ezUInt32 ezRenderWorld::GetStaticRenderDataVersion(const ezWorld* pWorld)
+{
+  EZ_LOCK(s_CachedRenderDataMutex);
+
+  ezUInt32 uiVersion = 0;
+  s_StaticRenderDataVersions.TryGetValue(pWorld->GetIndex(), uiVersion);
+  return uiVersion + s_uiAllStaticRenderDataVersion;
+}
+
 ezArrayPtr<const ezInternal::RenderDataCacheEntry> ezRenderWorld::GetCachedRenderData(const ezView& view, const ezGameObjectHandle& hOwner, ezUInt16 uiComponentVersion)
 {
   if (cvar_RenderingCachingStaticObjects)
@@ -714,6 +742,10 @@ void ezRenderWorld::UpdateRenderDataCache()
       if (uiNumCachedRenderData == 0) // Nothing cached yet
       {
         cachedRenderDataPerComponent = CachedRenderDataPerComponent(s_pCacheAllocator);
+
+        // the object might have been rendered with fallback resources before, e.g. while its mesh was still loading
+        EZ_LOCK(s_CachedRenderDataMutex);
+        IncreaseStaticRenderDataVersion(newEntries.m_hOwnerObject);
       }
 
       ezUInt32 uiCachedRenderDataIndex = 0;
@@ -802,13 +834,27 @@ void ezRenderWorld::RebuildPipelines()
   s_PipelinesToRebuild.Clear();
 }
 
-void ezRenderWorld::OnEngineStartup()
+void ezRenderWorld::OnCoreStartup()
 {
+  // The render data cache doesn't need a device, so views can already be created and extracted once the core systems are up, e.g. in tests.
   s_pCacheAllocator = EZ_DEFAULT_NEW(ezProxyAllocator, "Cached Render Data", ezFoundation::GetDefaultAllocator());
 
   s_CachedRenderData = ezHashTable<ezComponentHandle, CachedRenderDataPerComponent>(s_pCacheAllocator);
 }
 
+void ezRenderWorld::OnCoreShutdown()
+{
+  ClearRenderDataCache();
+
+  s_CachedRenderData.Clear();
+  s_CachedRenderData.Compact();
+
+  s_StaticRenderDataVersions.Clear();
+  s_StaticRenderDataVersions.Compact();
+
+  EZ_DEFAULT_DELETE(s_pCacheAllocator);
+}
+
 void ezRenderWorld::OnEngineShutdown()
 {
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
@@ -824,8 +870,6 @@ void ezRenderWorld::OnEngineShutdown()
 
   ClearRenderDataCache();
 
-  EZ_DEFAULT_DELETE(s_pCacheAllocator);
-
   s_FilteredRenderPipelines[0].Clear();
   s_FilteredRenderPipelines[1].Clear();
 
@@ -834,6 +878,7 @@ void ezRenderWorld::OnEngineShutdown()
   for (auto it = s_Views.GetIterator(); it.IsValid(); ++it)
   {
     ezView* pView = it.Value();
+    EZ_DELETE(s_pCacheAllocator, pView->m_pRenderDataCache);
     EZ_DEFAULT_DELETE(pView);
   }
 
@@ -61,6 +61,12 @@ public:
   static void ResetRenderDataCache(ezView& ref_view);
   static ezArrayPtr<const ezInternal::RenderDataCacheEntry> GetCachedRenderData(const ezView& view, const ezGameObjectHandle& hOwner, ezUInt16 uiComponentVersion);
 
+  /// \brief Returns a counter that changes whenever the cached render data of a static object in the given world is created or deleted.
+  ///
+  /// This happens e.g. when the mesh or material of a static object is swapped. Anything that is derived from the static objects
+  /// of a world without being re-extracted every frame (like cached shadow maps) can use this to detect that it has to be updated.
+  static ezUInt32 GetStaticRenderDataVersion(const ezWorld* pWorld);
+
   static void AddViewToRender(const ezViewHandle& hView);
 
   static void ExtractMainViews();
@@ -117,13 +123,15 @@ private:
   friend class ezRenderPipeline;
 
   static void DeleteCachedRenderDataInternal(const ezGameObjectHandle& hOwnerObject);
+  static void IncreaseStaticRenderDataVersion(const ezGameObjectHandle& hOwnerObject);
   static void ClearRenderDataCache();
   static void UpdateRenderDataCache();
 
   static void AddRenderPipelineToRebuild(ezRenderPipeline* pRenderPipeline, const ezViewHandle& hView);
   static void RebuildPipelines();
 
-  static void OnEngineStartup();
+  static void OnCoreStartup();
+  static void OnCoreShutdown();
   static void OnEngineShutdown();
 
   static ezEvent<const ezRenderWorldExtractionEvent&, ezMutex> s_ExtractionEvent;
@@ -70,6 +70,7 @@ EZ_STATICLINK_LIBRARY(RendererCore)
   EZ_STATICLINK_REFERENCE(RendererCore_Lights_Implementation_ReflectionProbeComponentBase);
   EZ_STATICLINK_REFERENCE(RendererCore_Lights_Implementation_ReflectionProbeData);
   EZ_STATICLINK_REFERENCE(RendererCore_Lights_Implementation_ReflectionProbeUpdater);
+  EZ_STATICLINK_REFERENCE(RendererCore_Lights_Implementation_ShadowAtlas);
   EZ_STATICLINK_REFERENCE(RendererCore_Lights_Implementation_ShadowPool);
   EZ_STATICLINK_REFERENCE(RendererCore_Lights_Implementation_SimplifiedDataExtractor);
   EZ_STATICLINK_REFERENCE(RendererCore_Lights_Implementation_SimplifiedDataProvider);
@@ -123,6 +124,7 @@ EZ_STATICLINK_LIBRARY(RendererCore)
   EZ_STATICLINK_REFERENCE(RendererCore_Pipeline_Implementation_RenderPipelinePass);
   EZ_STATICLINK_REFERENCE(RendererCore_Pipeline_Implementation_RenderPipelineResource);
   EZ_STATICLINK_REFERENCE(RendererCore_Pipeline_Implementation_RenderPipelineResourceLoader);
+  EZ_STATICLINK_REFERENCE(RendererCore_Pipeline_Implementation_RenderTargetAliasing);
   EZ_STATICLINK_REFERENCE(RendererCore_Pipeline_Implementation_View);
   EZ_STATICLINK_REFERENCE(RendererCore_Pipeline_Implementation_ViewRenderMode);
   EZ_STATICLINK_REFERENCE(RendererCore_Rasterizer_Implementation_RasterizerView);
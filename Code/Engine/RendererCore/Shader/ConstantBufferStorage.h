@@ -19,6 +19,14 @@ public:
 
   void UploadData(ezGALCommandEncoder* pCommandEncoder);
 
+  /// \brief Uploads the data if its hash differs from inout_uiLastHash, without touching the modification state of the storage.
+  ///
+  /// Used by render contexts that record into deferred command encoders. Several of them may use the same storage at the same time
+  /// and each recording needs its own upload, since the recordings can be replayed in a different order than they were recorded.
+  void UploadData(ezGALCommandEncoder* pCommandEncoder, ezUInt32& inout_uiLastHash) const;
+
+  EZ_ALWAYS_INLINE bool HasBeenModified() const { return m_bHasBeenModified; }
+
   EZ_ALWAYS_INLINE ezGALBufferHandle GetGALBufferHandle() const { return m_hGALConstantBuffer; }
 
 protected:
@@ -46,3 +46,13 @@ void ezConstantBufferStorageBase::UploadData(ezGALCommandEncoder* pCommandEncode
     m_uiLastHash = uiNewHash;
   }
 }
+
+void ezConstantBufferStorageBase::UploadData(ezGALCommandEncoder* pCommandEncoder, ezUInt32& inout_uiLastHash) const
+{
+  ezUInt32 uiNewHash = ezHashingUtils::xxHash32(m_Data.GetPtr(), m_Data.GetCount());
+  if (inout_uiLastHash != uiNewHash)
+  {
+    pCommandEncoder->UpdateBuffer(m_hGALConstantBuffer, 0, m_Data);
+    inout_uiLastHash = uiNewHash;
+  }
+}
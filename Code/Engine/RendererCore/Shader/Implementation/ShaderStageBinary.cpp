@@ -9,6 +9,7 @@
 
 //////////////////////////////////////////////////////////////////////////
 
+ezMutex ezShaderStageBinary::s_ShaderStageBinariesMutex;
 ezMap<ezUInt32, ezShaderStageBinary> ezShaderStageBinary::s_ShaderStageBinaries[ezGALShaderStage::ENUM_COUNT];
 
 ezShaderStageBinary::ezShaderStageBinary() = default;
@@ -227,39 +228,51 @@ ezResult ezShaderStageBinary::WriteStageBinary(ezLogInterface* pLog, ezStringVie
 // static
 ezShaderStageBinary* ezShaderStageBinary::LoadStageBinary(ezGALShaderStage::Enum Stage, ezUInt32 uiHash, ezStringView sPlatform)
 {
-  auto itStage = s_ShaderStageBinaries[Stage].Find(uiHash);
-
-  if (!itStage.IsValid())
   {
-    ezStringBuilder sShaderStageFile = ezShaderManager::GetCacheDirectory();
+    EZ_LOCK(s_ShaderStageBinariesMutex);
 
-    sShaderStageFile.AppendPath(sPlatform);
-    sShaderStageFile.AppendFormat("/{0}_{1}.ezShaderStage", ezGALShaderStage::Names[Stage], ezArgU(uiHash, 8, true, 16, true));
+    auto itStage = s_ShaderStageBinaries[Stage].Find(uiHash);
+    if (itStage.IsValid())
+      return &itStage.Value();
+  }
 
-    ezFileReader StageFileIn;
-    if (StageFileIn.Open(sShaderStageFile.GetData()).Failed())
-    {
-      ezLog::Debug("Could not open shader stage file '{0}' for reading", sShaderStageFile);
-      return nullptr;
-    }
+  // the file is read without holding the lock, shaders are compiled and loaded on multiple threads
+  ezStringBuilder sShaderStageFile = ezShaderManager::GetCacheDirectory();
 
-    ezShaderStageBinary shaderStageBinary;
-    if (shaderStageBinary.Read(StageFileIn).Failed())
-    {
-      ezLog::Error("Could not read shader stage file '{0}'", sShaderStageFile);
-      return nullptr;
-    }
+  sShaderStageFile.AppendPath(sPlatform);
+  sShaderStageFile.AppendFormat("/{0}_{1}.ezShaderStage", ezGALShaderStage::Names[Stage], ezArgU(uiHash, 8, true, 16, true));
 
-    itStage = ezShaderStageBinary::s_ShaderStageBinaries[Stage].Insert(uiHash, shaderStageBinary);
+  ezFileReader StageFileIn;
+  if (StageFileIn.Open(sShaderStageFile.GetData()).Failed())
+  {
+    ezLog::Debug("Could not open shader stage file '{0}' for reading", sShaderStageFile);
+    return nullptr;
   }
 
-  ezShaderStageBinary* pShaderStageBinary = &itStage.Value();
-  return pShaderStageBinary;
+  ezShaderStageBinary shaderStageBinary;
+  if (shaderStageBinary.Read(StageFileIn).Failed())
+  {
+    ezLog::Error("Could not read shader stage file '{0}'", sShaderStageFile);
+    return nullptr;
+  }
+
+  EZ_LOCK(s_ShaderStageBinariesMutex);
+
+  // if another thread loaded the same binary in the meantime, keep the existing one, someone may already reference it
+  auto itStage = s_ShaderStageBinaries[Stage].Find(uiHash);
+  if (!itStage.IsValid())
+  {
+    itStage = s_ShaderStageBinaries[Stage].Insert(uiHash, shaderStageBinary);
+  }
+
+  return &itStage.Value();
 }
 
 // static
 void ezShaderStageBinary::OnEngineShutdown()
 {
+  EZ_LOCK(s_ShaderStageBinariesMutex);
+
   for (ezUInt32 stage = 0; stage < ezGALShaderStage::ENUM_COUNT; ++stage)
   {
     s_ShaderStageBinaries[stage].Clear();
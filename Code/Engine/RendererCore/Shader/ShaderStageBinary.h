@@ -6,6 +6,7 @@
 #include <Foundation/Containers/Map.h>
 #include <Foundation/IO/Stream.h>
 #include <Foundation/Strings/HashedString.h>
+#include <Foundation/Threading/Mutex.h>
 #include <Foundation/Types/Enum.h>
 #include <Foundation/Types/SharedPtr.h>
 #include <RendererFoundation/Descriptors/Descriptors.h>
@@ -55,5 +56,6 @@ private: // statics
 
   static void OnEngineShutdown();
 
+  static ezMutex s_ShaderStageBinariesMutex;
   static ezMap<ezUInt32, ezShaderStageBinary> s_ShaderStageBinaries[ezGALShaderStage::ENUM_COUNT];
 };
@@ -3,9 +3,11 @@
 #include <Core/Interfaces/RemoteToolingInterface.h>
 #include <Foundation/Communication/RemoteInterface.h>
 #include <Foundation/Configuration/Singleton.h>
+#include <Foundation/Containers/HashSet.h>
 #include <Foundation/IO/FileSystem/DeferredFileWriter.h>
 #include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/OSFile.h>
+#include <Foundation/Threading/ConditionVariable.h>
 #include <Foundation/Types/UniquePtr.h>
 #include <RendererCore/ShaderCompiler/ShaderCompiler.h>
 #include <RendererCore/ShaderCompiler/ShaderManager.h>
@@ -94,8 +96,69 @@ namespace
   }
 
   static const char* s_szStageDefines[ezGALShaderStage::ENUM_COUNT] = {"VERTEX_SHADER", "HULL_SHADER", "DOMAIN_SHADER", "GEOMETRY_SHADER", "PIXEL_SHADER", "COMPUTE_SHADER"};
+
+  static ezConditionVariable s_StageClaimsSignal;
+  static ezHashSet<ezUInt64> s_ClaimedStages;
+
+  /// \brief Gives the current thread exclusive access to the cache entries of a set of shader stage hashes.
+  ///
+  /// Permutations may be compiled on multiple threads at once and many of them share the exact same stage source.
+  /// Only the thread that holds the claim for a stage hash may look it up, compile it and write it to disk.
+  /// Others wait until the claim is released and then find the finished binary in the cache.
+  /// All hashes of a permutation are claimed at once, so threads never hold one claim while waiting for another.
+  class ezShaderStageClaim
+  {
+  public:
+    ezShaderStageClaim(ezArrayPtr<const ezUInt64> stageKeys)
+      : m_StageKeys(stageKeys)
+    {
+      EZ_LOCK(s_StageClaimsSignal);
+
+      while (!TryClaim())
+      {
+        s_StageClaimsSignal.UnlockWaitForSignalAndLock();
+      }
+    }
+
+    ~ezShaderStageClaim()
+    {
+      EZ_LOCK(s_StageClaimsSignal);
+
+      for (ezUInt64 uiKey : m_StageKeys)
+      {
+        s_ClaimedStages.Remove(uiKey);
+      }
+
+      s_StageClaimsSignal.SignalAll();
+    }
+
+  private:
+    bool TryClaim()
+    {
+      for (ezUInt64 uiKey : m_StageKeys)
+      {
+        if (s_ClaimedStages.Contains(uiKey))
+          return false;
+      }
+
+      for (ezUInt64 uiKey : m_StageKeys)
+      {
+        s_ClaimedStages.Insert(uiKey);
+      }
+
+      return true;
+    }
+
+    ezArrayPtr<const ezUInt64> m_StageKeys;
+  };
 } // namespace
 
+void ezShaderProgramCompiler::GetCompilerVersion(ezStringBuilder& out_sVersion) const
+{
+  const ezRTTI* pRtti = GetDynamicRTTI();
+  out_sVersion.AppendFormat("{0} {1}", pRtti->GetTypeName(), pRtti->GetTypeVersion());
+}
+
 ezResult ezShaderCompiler::FileOpen(ezStringView sAbsoluteFile, ezDynamicArray<ezUInt8>& FileContent, ezTimestamp& out_FileModification)
 {
   if (sAbsoluteFile == "ShaderRenderState")
@@ -467,15 +530,34 @@ ezResult ezShaderCompiler::RunShaderCompiler(ezStringView sFile, ezStringView sP
       return EZ_FAILURE;
     }
 
-    // Load shader cache
+    // The stage binaries are a content-addressed cache. The preprocessed source already contains the effect of all defines,
+    // everything else that influences the byte code is hashed into the seed.
+    ezStringBuilder sCompilerKey;
+    pCompiler->GetCompilerVersion(sCompilerKey);
+    sCompilerKey.Append(" ", Platforms[p], spd.m_Flags.IsSet(ezShaderCompilerFlags::Debug) ? " DEBUG" : "");
+    const ezUInt32 uiHashSeed = ezHashingUtils::xxHash32String(sCompilerKey);
+
+    ezHybridArray<ezUInt64, ezGALShaderStage::ENUM_COUNT> stageKeys;
+
     for (ezUInt32 stage = ezGALShaderStage::VertexShader; stage < ezGALShaderStage::ENUM_COUNT; ++stage)
     {
       ezUInt32 uiSourceStringLen = spd.m_sShaderSource[stage].GetElementCount();
-      spd.m_uiSourceHash[stage] = uiSourceStringLen == 0 ? 0u : ezHashingUtils::xxHash32(spd.m_sShaderSource[stage].GetData(), uiSourceStringLen);
+      spd.m_uiSourceHash[stage] = uiSourceStringLen == 0 ? 0u : ezHashingUtils::xxHash32(spd.m_sShaderSource[stage].GetData(), uiSourceStringLen, uiHashSeed);
 
       if (spd.m_uiSourceHash[stage] != 0)
       {
-        ezShaderStageBinary* pBinary = ezShaderStageBinary::LoadStageBinary((ezGALShaderStage::Enum)stage, spd.m_uiSourceHash[stage], sPlatform);
+        stageKeys.PushBack((static_cast<ezUInt64>(stage) << 32) | spd.m_uiSourceHash[stage]);
+      }
+    }
+
+    ezShaderStageClaim stageClaim(stageKeys);
+
+    // Load shader cache
+    for (ezUInt32 stage = ezGALShaderStage::VertexShader; stage < ezGALShaderStage::ENUM_COUNT; ++stage)
+    {
+      if (spd.m_uiSourceHash[stage] != 0)
+      {
+        ezShaderStageBinary* pBinary = ezShaderStageBinary::LoadStageBinary((ezGALShaderStage::Enum)stage, spd.m_uiSourceHash[stage], Platforms[p]);
 
         if (pBinary)
         {
@@ -514,11 +596,13 @@ ezResult ezShaderCompiler::RunShaderCompiler(ezStringView sFile, ezStringView sP
         bin.m_uiSourceHash = spd.m_uiSourceHash[stage];
         bin.m_pGALByteCode = spd.m_ByteCode[stage];
 
-        if (bin.WriteStageBinary(pLog, sPlatform).Failed())
+        if (bin.WriteStageBinary(pLog, Platforms[p]).Failed())
         {
           ezLog::Error(pLog, "Writing stage {0} binary failed", stage);
           return EZ_FAILURE;
         }
+
+        EZ_LOCK(ezShaderStageBinary::s_ShaderStageBinariesMutex);
         ezShaderStageBinary::s_ShaderStageBinaries[stage].Insert(bin.m_uiSourceHash, bin);
       }
     }
@@ -34,6 +34,11 @@ public:
   /// \param pLog Logging interface to be used when outputting any errors.
   /// \return Returns whether the shader was compiled successfully. On failure, errors should be written to pLog.
   virtual ezResult Compile(ezShaderProgramData& inout_data, ezLogInterface* pLog) = 0;
+
+  /// Appends a string that identifies the compiler and its version. It is hashed together with the preprocessed shader source to form the key under which compiled shader stages are cached, so it needs to change whenever the same source would result in different byte code.
+  /// The default implementation uses the name and version of the reflected type.
+  /// \param out_sVersion The version string is appended to this.
+  virtual void GetCompilerVersion(ezStringBuilder& out_sVersion) const;
 };
 
 class EZ_RENDERERCORE_DLL ezShaderCompiler
@@ -135,17 +135,24 @@ public:
   // Internal
 
   EZ_ALWAYS_INLINE ezGALDevice& GetDevice() { return m_Device; }
+
+  /// \brief Returns true if the commands are recorded for a later replay, see ezGALDeferredCommandEncoder.
+  EZ_ALWAYS_INLINE bool IsDeferred() const { return m_bDeferred; }
+
   // Don't use light hearted ;)
   void InvalidateState();
 
 protected:
   friend class ezGALDevice;
+  friend class ezGALDeferredCommandEncoder;
 
   void AssertRenderingThread()
   {
-    EZ_ASSERT_DEV(ezThreadUtils::IsMainThread(), "This function can only be executed on the main thread.");
+    EZ_ASSERT_DEV(m_bDeferred || ezThreadUtils::IsMainThread(), "This function can only be executed on the main thread.");
   }
 
+  bool m_bDeferred = false;
+
 private:
   void ClearStatisticsCounters();
   void CountDispatchCall() { m_uiDispatchCalls++; }
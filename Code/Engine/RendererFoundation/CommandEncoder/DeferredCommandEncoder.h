@@ -0,0 +1,41 @@
+#pragma once
+
+#include <Foundation/Types/UniquePtr.h>
+#include <RendererFoundation/CommandEncoder/CommandEncoder.h>
+
+class ezGALDeferredCommandRecorder;
+
+/// \brief A command encoder that records all commands into memory instead of passing them to the GPU.
+///
+/// Unlike the command encoder of the device, a deferred encoder can be used on any thread, as long as only one thread uses it at a time.
+/// The commands are validated and the handles are resolved at record time, so all resources that are used must stay alive until the commands were replayed.
+/// Replay() sends the commands in the recorded order to another encoder, usually the one returned by ezGALDevice::BeginCommands().
+/// This allows to record several independent parts of a frame in parallel while submitting them in a deterministic order.
+///
+/// Commands that return a result immediately can't be recorded:
+/// InsertTimestamp() returns an invalid handle, occlusion queries, fences, UpdateTexture() and CopyTextureReadbackResult() are not supported.
+class EZ_RENDERERFOUNDATION_DLL ezGALDeferredCommandEncoder : public ezGALCommandEncoder
+{
+public:
+  ezGALDeferredCommandEncoder(ezGALDevice& ref_device);
+  ~ezGALDeferredCommandEncoder();
+
+  /// \brief Sends all recorded commands to the target encoder.
+  ///
+  /// Must be called on the main thread and outside of any rendering or compute scope of the target.
+  /// The recorded commands are kept, call Reset() before recording the next batch.
+  void Replay(ezGALCommandEncoder& ref_target) const;
+
+  /// \brief Discards all recorded commands and invalidates the cached state, so that the next recording sets all state again.
+  void Reset();
+
+  bool IsEmpty() const;
+
+  /// \brief The number of bytes that the recorded commands currently use.
+  ezUInt32 GetRecordedDataSize() const;
+
+private:
+  ezGALDeferredCommandEncoder(ezGALDevice& ref_device, ezGALDeferredCommandRecorder* pRecorder);
+
+  ezUniquePtr<ezGALDeferredCommandRecorder> m_pRecorder;
+};
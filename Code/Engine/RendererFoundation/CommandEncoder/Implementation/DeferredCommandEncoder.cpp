@@ -0,0 +1,820 @@
+#include <RendererFoundation/RendererFoundationPCH.h>
+
+#include <Foundation/Containers/Deque.h>
+#include <RendererFoundation/CommandEncoder/DeferredCommandEncoder.h>
+#include <RendererFoundation/Resources/RenderTargetSetup.h>
+#include <RendererFoundation/Shader/ShaderByteCode.h>
+
+namespace
+{
+  enum class ezGALDeferredCommandType : ezUInt8
+  {
+    SetShader,
+    SetConstantBuffer,
+    SetSamplerState,
+    SetTextureResourceView,
+    SetBufferResourceView,
+    SetTextureUnorderedAccessView,
+    SetBufferUnorderedAccessView,
+    SetPushConstants,
+    ClearTextureUnorderedAccessViewFloat,
+    ClearTextureUnorderedAccessViewUInt,
+    ClearBufferUnorderedAccessViewFloat,
+    ClearBufferUnorderedAccessViewUInt,
+    CopyBuffer,
+    CopyBufferRegion,
+    UpdateBuffer,
+    CopyTexture,
+    CopyTextureRegion,
+    ResolveTexture,
+    ReadbackTexture,
+    GenerateMipMaps,
+    Flush,
+    PushMarker,
+    PopMarker,
+    InsertEventMarker,
+    BeginCompute,
+    EndCompute,
+    Dispatch,
+    DispatchIndirect,
+    BeginRendering,
+    EndRendering,
+    Clear,
+    Draw,
+    DrawIndexed,
+    DrawIndexedInstanced,
+    DrawIndexedInstancedIndirect,
+    DrawInstanced,
+    DrawInstancedIndirect,
+    SetIndexBuffer,
+    SetVertexBuffer,
+    SetVertexDeclaration,
+    SetPrimitiveTopology,
+    SetBlendState,
+    SetDepthStencilState,
+    SetRasterizerState,
+    SetViewport,
+    SetScissorRect,
+  };
+} // namespace
+
+/// \brief Implements the platform interface by writing all commands with their arguments into one contiguous stream.
+///
+/// The arguments are stored as raw bytes, GAL objects as pointers. Bindings and rendering setups are not trivially copyable,
+/// so they are stored in separate containers and only referenced by index.
+class ezGALDeferredCommandRecorder : public ezGALCommandEncoderCommonPlatformInterface
+{
+public:
+  void Replay(ezGALCommandEncoderCommonPlatformInterface& target) const
+  {
+    ezUInt32 uiOffset = 0;
+    while (uiOffset < m_Stream.GetCount())
+    {
+      const auto type = Read<ezGALDeferredCommandType>(uiOffset);
+
+      switch (type)
+      {
+        case ezGALDeferredCommandType::SetShader:
+          target.SetShaderPlatform(Read<const ezGALShader*>(uiOffset));
+          break;
+        case ezGALDeferredCommandType::SetConstantBuffer:
+        {
+          const ezShaderResourceBinding& binding = ReadBinding(uiOffset);
+          target.SetConstantBufferPlatform(binding, Read<const ezGALBuffer*>(uiOffset));
+        }
+        break;
+        case ezGALDeferredCommandType::SetSamplerState:
+        {
+          const ezShaderResourceBinding& binding = ReadBinding(uiOffset);
+          target.SetSamplerStatePlatform(binding, Read<const ezGALSamplerState*>(uiOffset));
+        }
+        break;
+        case ezGALDeferredCommandType::SetTextureResourceView:
+        {
+          const ezShaderResourceBinding& binding = ReadBinding(uiOffset);
+          target.SetResourceViewPlatform(binding, Read<const ezGALTextureResourceView*>(uiOffset));
+        }
+        break;
+        case ezGALDeferredCommandType::SetBufferResourceView:
+        {
+          const ezShaderResourceBinding& binding = ReadBinding(uiOffset);
+          target.SetResourceViewPlatform(binding, Read<const ezGALBufferResourceView*>(uiOffset));
+        }
+        break;
+        case ezGALDeferredCommandType::SetTextureUnorderedAccessView:
+        {
+          const ezShaderResourceBinding& binding = ReadBinding(uiOffset);
+          target.SetUnorderedAccessViewPlatform(binding, Read<const ezGALTextureUnorderedAccessView*>(uiOffset));
+        }
+        break;
+        case ezGALDeferredCommandType::SetBufferUnorderedAccessView:
+        {
+          const ezShaderResourceBinding& binding = ReadBinding(uiOffset);
+          target.SetUnorderedAccessViewPlatform(binding, Read<const ezGALBufferUnorderedAccessView*>(uiOffset));
+        }
+        break;
+        case ezGALDeferredCommandType::SetPushConstants:
+          target.SetPushConstantsPlatform(ReadData(uiOffset));
+          break;
+        case ezGALDeferredCommandType::ClearTextureUnorderedAccessViewFloat:
+        {
+          auto pView = Read<const ezGALTextureUnorderedAccessView*>(uiOffset);
+          target.ClearUnorderedAccessViewPlatform(pView, Read<ezVec4>(uiOffset));
+        }
+        break;
+        case ezGALDeferredCommandType::ClearTextureUnorderedAccessViewUInt:
+        {
+          auto pView = Read<const ezGALTextureUnorderedAccessView*>(uiOffset);
+          target.ClearUnorderedAccessViewPlatform(pView, Read<ezVec4U32>(uiOffset));
+        }
+        break;
+        case ezGALDeferredCommandType::ClearBufferUnorderedAccessViewFloat:
+        {
+          auto pView = Read<const ezGALBufferUnorderedAccessView*>(uiOffset);
+          target.ClearUnorderedAccessViewPlatform(pView, Read<ezVec4>(uiOffset));
+        }
+        break;
+        case ezGALDeferredCommandType::ClearBufferUnorderedAccessViewUInt:
+        {
+          auto pView = Read<const ezGALBufferUnorderedAccessView*>(uiOffset);
+          target.ClearUnorderedAccessViewPlatform(pView, Read<ezVec4U32>(uiOffset));
+        }
+        break;
+        case ezGALDeferredCommandType::CopyBuffer:
+        {
+          auto pDestination = Read<const ezGALBuffer*>(uiOffset);
+          target.CopyBufferPlatform(pDestination, Read<const ezGALBuffer*>(uiOffset));
+        }
+        break;
+        case ezGALDeferredCommandType::CopyBufferRegion:
+        {
+          auto pDestination = Read<const ezGALBuffer*>(uiOffset);
+          auto uiDestOffset = Read<ezUInt32>(uiOffset);
+          auto pSource = Read<const ezGALBuffer*>(uiOffset);
+          auto uiSourceOffset = Read<ezUInt32>(uiOffset);
+          target.CopyBufferRegionPlatform(pDestination, uiDestOffset, pSource, uiSourceOffset, Read<ezUInt32>(uiOffset));
+        }
+        break;
+        case ezGALDeferredCommandType::UpdateBuffer:
+        {
+          auto pDestination = Read<const ezGALBuffer*>(uiOffset);
+          auto uiDestOffset = Read<ezUInt32>(uiOffset);
+          auto updateMode = Read<ezGALUpdateMode::Enum>(uiOffset);
+          target.UpdateBufferPlatform(pDestination, uiDestOffset, ReadData(uiOffset), updateMode);
+        }
+        break;
+        case ezGALDeferredCommandType::CopyTexture:
+        {
+          auto pDestination = Read<const ezGALTexture*>(uiOffset);
+          target.CopyTexturePlatform(pDestination, Read<const ezGALTexture*>(uiOffset));
+        }
+        break;
+        case ezGALDeferredCommandType::CopyTextureRegion:
+        {
+          auto pDestination = Read<const ezGALTexture*>(uiOffset);
+          auto destinationSubResource = Read<ezGALTextureSubresource>(uiOffset);
+          auto vDestinationPoint = Read<ezVec3U32>(uiOffset);
+          auto pSource = Read<const ezGALTexture*>(uiOffset);
+          auto sourceSubResource = Read<ezGALTextureSubresource>(uiOffset);
+          target.CopyTextureRegionPlatform(pDestination, destinationSubResource, vDestinationPoint, pSource, sourceSubResource, Read<ezBoundingBoxu32>(uiOffset));
+        }
+        break;
+        case ezGALDeferredCommandType::ResolveTexture:
+        {
+          auto pDestination = Read<const ezGALTexture*>(uiOffset);
+          auto destinationSubResource = Read<ezGALTextureSubresource>(uiOffset);
+          auto pSource = Read<const ezGALTexture*>(uiOffset);
+          target.ResolveTexturePlatform(pDestination, destinationSubResource, pSource, Read<ezGALTextureSubresource>(uiOffset));
+        }
+        break;
+        case ezGALDeferredCommandType::ReadbackTexture:
+          target.ReadbackTexturePlatform(Read<const ezGALTexture*>(uiOffset));
+          break;
+        case ezGALDeferredCommandType::GenerateMipMaps:
+          target.GenerateMipMapsPlatform(Read<const ezGALTextureResourceView*>(uiOffset));
+          break;
+        case ezGALDeferredCommandType::Flush:
+          target.FlushPlatform();
+          break;
+        case ezGALDeferredCommandType::PushMarker:
+          target.PushMarkerPlatform(reinterpret_cast<const char*>(ReadData(uiOffset).GetPtr()));
+          break;
+        case ezGALDeferredCommandType::PopMarker:
+          target.PopMarkerPlatform();
+          break;
+        case ezGALDeferredCommandType::InsertEventMarker:
+          target.InsertEventMarkerPlatform(reinterpret_cast<const char*>(ReadData(uiOffset).GetPtr()));
+          break;
+        case ezGALDeferredCommandType::BeginCompute:
+          target.BeginComputePlatform();
+          break;
+        case ezGALDeferredCommandType::EndCompute:
+          target.EndComputePlatform();
+          break;
+        case ezGALDeferredCommandType::Dispatch:
+        {
+          auto uiX = Read<ezUInt32>(uiOffset);
+          auto uiY = Read<ezUInt32>(uiOffset);
+          target.DispatchPlatform(uiX, uiY, Read<ezUInt32>(uiOffset)).IgnoreResult();
+        }
+        break;
+        case ezGALDeferredCommandType::DispatchIndirect:
+        {
+          auto pBuffer = Read<const ezGALBuffer*>(uiOffset);
+          target.DispatchIndirectPlatform(pBuffer, Read<ezUInt32>(uiOffset)).IgnoreResult();
+        }
+        break;
+        case ezGALDeferredCommandType::BeginRendering:
+          target.BeginRenderingPlatform(m_RenderingSetups[Read<ezUInt32>(uiOffset)]);
+          break;
+        case ezGALDeferredCommandType::EndRendering:
+          target.EndRenderingPlatform();
+          break;
+        case ezGALDeferredCommandType::Clear:
+        {
+          auto clearColor = Read<ezColor>(uiOffset);
+          auto uiClearMask = Read<ezUInt32>(uiOffset);
+          auto bClearDepth = Read<bool>(uiOffset);
+          auto bClearStencil = Read<bool>(uiOffset);
+          auto fDepthClear = Read<float>(uiOffset);
+          target.ClearPlatform(clearColor, uiClearMask, bClearDepth, bClearStencil, fDepthClear, Read<ezUInt8>(uiOffset));
+        }
+        break;
+        case ezGALDeferredCommandType::Draw:
+        {
+          auto uiVertexCount = Read<ezUInt32>(uiOffset);
+          target.DrawPlatform(uiVertexCount, Read<ezUInt32>(uiOffset)).IgnoreResult();
+        }
+        break;
+        case ezGALDeferredCommandType::DrawIndexed:
+        {
+          auto uiIndexCount = Read<ezUInt32>(uiOffset);
+          target.DrawIndexedPlatform(uiIndexCount, Read<ezUInt32>(uiOffset)).IgnoreResult();
+        }
+        break;
+        case ezGALDeferredCommandType::DrawIndexedInstanced:
+        {
+          auto uiIndexCount = Read<ezUInt32>(uiOffset);
+          auto uiInstanceCount = Read<ezUInt32>(uiOffset);
+          target.DrawIndexedInstancedPlatform(uiIndexCount, uiInstanceCount, Read<ezUInt32>(uiOffset)).IgnoreResult();
+        }
+        break;
+        case ezGALDeferredCommandType::DrawIndexedInstancedIndirect:
+        {
+          auto pBuffer = Read<const ezGALBuffer*>(uiOffset);
+          target.DrawIndexedInstancedIndirectPlatform(pBuffer, Read<ezUInt32>(uiOffset)).IgnoreResult();
+        }
+        break;
+        case ezGALDeferredCommandType::DrawInstanced:
+        {
+          auto uiVertexCount = Read<ezUInt32>(uiOffset);
+          auto uiInstanceCount = Read<ezUInt32>(uiOffset);
+          target.DrawInstancedPlatform(uiVertexCount, uiInstanceCount, Read<ezUInt32>(uiOffset)).IgnoreResult();
+        }
+        break;
+        case ezGALDeferredCommandType::DrawInstancedIndirect:
+        {
+          auto pBuffer = Read<const ezGALBuffer*>(uiOffset);
+          target.DrawInstancedIndirectPlatform(pBuffer, Read<ezUInt32>(uiOffset)).IgnoreResult();
+        }
+        break;
+        case ezGALDeferredCommandType::SetIndexBuffer:
+          target.SetIndexBufferPlatform(Read<const ezGALBuffer*>(uiOffset));
+          break;
+        case ezGALDeferredCommandType::SetVertexBuffer:
+        {
+          auto uiSlot = Read<ezUInt32>(uiOffset);
+          target.SetVertexBufferPlatform(uiSlot, Read<const ezGALBuffer*>(uiOffset));
+        }
+        break;
+        case ezGALDeferredCommandType::SetVertexDeclaration:
+          target.SetVertexDeclarationPlatform(Read<const ezGALVertexDeclaration*>(uiOffset));
+          break;
+        case ezGALDeferredCommandType::SetPrimitiveTopology:
+          target.SetPrimitiveTopologyPlatform(Read<ezGALPrimitiveTopology::Enum>(uiOffset));
+          break;
+        case ezGALDeferredCommandType::SetBlendState:
+        {
+          auto pBlendState = Read<const ezGALBlendState*>(uiOffset);
+          auto blendFactor = Read<ezColor>(uiOffset);
+          target.SetBlendStatePlatform(pBlendState, blendFactor, Read<ezUInt32>(uiOffset));
+        }
+        break;
+        case ezGALDeferredCommandType::SetDepthStencilState:
+        {
+          auto pDepthStencilState = Read<const ezGALDepthStencilState*>(uiOffset);
+          target.SetDepthStencilStatePlatform(pDepthStencilState, Read<ezUInt8>(uiOffset));
+        }
+        break;
+        case ezGALDeferredCommandType::SetRasterizerState:
+          target.SetRasterizerStatePlatform(Read<const ezGALRasterizerState*>(uiOffset));
+          break;
+        case ezGALDeferredCommandType::SetViewport:
+        {
+          auto rect = Read<ezRectFloat>(uiOffset);
+          auto fMinDepth = Read<float>(uiOffset);
+          target.SetViewportPlatform(rect, fMinDepth, Read<float>(uiOffset));
+        }
+        break;
+        case ezGALDeferredCommandType::SetScissorRect:
+          target.SetScissorRectPlatform(Read<ezRectU32>(uiOffset));
+          break;
+
+          EZ_DEFAULT_CASE_NOT_IMPLEMENTED;
+      }
+    }
+  }
+
+  void Reset()
+  {
+    m_Stream.Clear();
+    m_Bindings.Clear();
+    m_RenderingSetups.Clear();
+  }
+
+  bool IsEmpty() const { return m_Stream.IsEmpty(); }
+  ezUInt32 GetDataSize() const { return m_Stream.GetCount(); }
+
+  // State setting functions
+
+  virtual void SetShaderPlatform(const ezGALShader* pShader) override
+  {
+    Write(ezGALDeferredCommandType::SetShader);
+    Write(pShader);
+  }
+
+  virtual void SetConstantBufferPlatform(const ezShaderResourceBinding& binding, const ezGALBuffer* pBuffer) override
+  {
+    Write(ezGALDeferredCommandType::SetConstantBuffer);
+    WriteBinding(binding);
+    Write(pBuffer);
+  }
+
+  virtual void SetSamplerStatePlatform(const ezShaderResourceBinding& binding, const ezGALSamplerState* pSamplerState) override
+  {
+    Write(ezGALDeferredCommandType::SetSamplerState);
+    WriteBinding(binding);
+    Write(pSamplerState);
+  }
+
+  virtual void SetResourceViewPlatform(const ezShaderResourceBinding& binding, const ezGALTextureResourceView* pResourceView) override
+  {
+    Write(ezGALDeferredCommandType::SetTextureResourceView);
+    WriteBinding(binding);
+    Write(pResourceView);
+  }
+
+  virtual void SetResourceViewPlatform(const ezShaderResourceBinding& binding, const ezGALBufferResourceView* pResourceView) override
+  {
+    Write(ezGALDeferredCommandType::SetBufferResourceView);
+    WriteBinding(binding);
+    Write(pResourceView);
+  }
+
+  virtual void SetUnorderedAccessViewPlatform(const ezShaderResourceBinding& binding, const ezGALTextureUnorderedAccessView* pUnorderedAccessView) override
+  {
+    Write(ezGALDeferredCommandType::SetTextureUnorderedAccessView);
+    WriteBinding(binding);
+    Write(pUnorderedAccessView);
+  }
+
+  virtual void SetUnorderedAccessViewPlatform(const ezShaderResourceBinding& binding, const ezGALBufferUnorderedAccessView* pUnorderedAccessView) override
+  {
+    Write(ezGALDeferredCommandType::SetBufferUnorderedAccessView);
+    WriteBinding(binding);
+    Write(pUnorderedAccessView);
+  }
+
+  virtual void SetPushConstantsPlatform(ezArrayPtr<const ezUInt8> data) override
+  {
+    Write(ezGALDeferredCommandType::SetPushConstants);
+    WriteData(data);
+  }
+
+  // GPU -> CPU query functions
+
+  virtual ezGALTimestampHandle InsertTimestampPlatform() override
+  {
+    // The result of a timestamp is only known once the GPU executed it, which doesn't work with a handle that has to be returned now.
+    return {};
+  }
+
+  virtual ezGALOcclusionHandle BeginOcclusionQueryPlatform(ezEnum<ezGALQueryType> type) override
+  {
+    EZ_REPORT_FAILURE("Occlusion queries can't be recorded with a deferred command encoder.");
+    return {};
+  }
+
+  virtual void EndOcclusionQueryPlatform(ezGALOcclusionHandle hOcclusion) override
+  {
+    EZ_REPORT_FAILURE("Occlusion queries can't be recorded with a deferred command encoder.");
+  }
+
+  virtual ezGALFenceHandle InsertFencePlatform() override
+  {
+    EZ_REPORT_FAILURE("Fences can't be recorded with a deferred command encoder.");
+    return {};
+  }
+
+  // Resource update functions
+
+  virtual void ClearUnorderedAccessViewPlatform(const ezGALTextureUnorderedAccessView* pUnorderedAccessView, ezVec4 vClearValues) override
+  {
+    Write(ezGALDeferredCommandType::ClearTextureUnorderedAccessViewFloat);
+    Write(pUnorderedAccessView);
+    Write(vClearValues);
+  }
+
+  virtual void ClearUnorderedAccessViewPlatform(const ezGALTextureUnorderedAccessView* pUnorderedAccessView, ezVec4U32 vClearValues) override
+  {
+    Write(ezGALDeferredCommandType::ClearTextureUnorderedAccessViewUInt);
+    Write(pUnorderedAccessView);
+    Write(vClearValues);
+  }
+
+  virtual void ClearUnorderedAccessViewPlatform(const ezGALBufferUnorderedAccessView* pUnorderedAccessView, ezVec4 vClearValues) override
+  {
+    Write(ezGALDeferredCommandType::ClearBufferUnorderedAccessViewFloat);
+    Write(pUnorderedAccessView);
+    Write(vClearValues);
+  }
+
+  virtual void ClearUnorderedAccessViewPlatform(const ezGALBufferUnorderedAccessView* pUnorderedAccessView, ezVec4U32 vClearValues) override
+  {
+    Write(ezGALDeferredCommandType::ClearBufferUnorderedAccessViewUInt);
+    Write(pUnorderedAccessView);
+    Write(vClearValues);
+  }
+
+  virtual void CopyBufferPlatform(const ezGALBuffer* pDestination, const ezGALBuffer* pSource) override
+  {
+    Write(ezGALDeferredCommandType::CopyBuffer);
+    Write(pDestination);
+    Write(pSource);
+  }
+
+  virtual void CopyBufferRegionPlatform(const ezGALBuffer* pDestination, ezUInt32 uiDestOffset, const ezGALBuffer* pSource, ezUInt32 uiSourceOffset, ezUInt32 uiByteCount) override
+  {
+    Write(ezGALDeferredCommandType::CopyBufferRegion);
+    Write(pDestination);
+    Write(uiDestOffset);
+    Write(pSource);
+    Write(uiSourceOffset);
+    Write(uiByteCount);
+  }
+
+  virtual void UpdateBufferPlatform(const ezGALBuffer* pDestination, ezUInt32 uiDestOffset, ezArrayPtr<const ezUInt8> sourceData, ezGALUpdateMode::Enum updateMode) override
+  {
+    Write(ezGALDeferredCommandType::UpdateBuffer);
+    Write(pDestination);
+    Write(uiDestOffset);
+    Write(updateMode);
+    WriteData(sourceData);
+  }
+
+  virtual void CopyTexturePlatform(const ezGALTexture* pDestination, const ezGALTexture* pSource) override
+  {
+    Write(ezGALDeferredCommandType::CopyTexture);
+    Write(pDestination);
+    Write(pSource);
+  }
+
+  virtual void CopyTextureRegionPlatform(const ezGALTexture* pDestination, const ezGALTextureSubresource& destinationSubResource, const ezVec3U32& vDestinationPoint, const ezGALTexture* pSource, const ezGALTextureSubresource& sourceSubResource, const ezBoundingBoxu32& box) override
+  {
+    Write(ezGALDeferredCommandType::CopyTextureRegion);
+    Write(pDestination);
+    Write(destinationSubResource);
+    Write(vDestinationPoint);
+    Write(pSource);
+    Write(sourceSubResource);
+    Write(box);
+  }
+
+  virtual void UpdateTexturePlatform(const ezGALTexture* pDestination, const ezGALTextureSubresource& destinationSubResource, const ezBoundingBoxu32& destinationBox, const ezGALSystemMemoryDescription& sourceData) override
+  {
+    // The size of the source data depends on the platform specific layout of the texture format.
+    EZ_REPORT_FAILURE("UpdateTexture can't be recorded with a deferred command encoder.");
+  }
+
+  virtual void ResolveTexturePlatform(const ezGALTexture* pDestination, const ezGALTextureSubresource& destinationSubResource, const ezGALTexture* pSource, const ezGALTextureSubresource& sourceSubResource) override
+  {
+    Write(ezGALDeferredCommandType::ResolveTexture);
+    Write(pDestination);
+    Write(destinationSubResource);
+    Write(pSource);
+    Write(sourceSubResource);
+  }
+
+  virtual void ReadbackTexturePlatform(const ezGALTexture* pTexture) override
+  {
+    Write(ezGALDeferredCommandType::ReadbackTexture);
+    Write(pTexture);
+  }
+
+  virtual void CopyTextureReadbackResultPlatform(const ezGALTexture* pTexture, ezArrayPtr<ezGALTextureSubresource> sourceSubResource, ezArrayPtr<ezGALSystemMemoryDescription> targetData) override
+  {
+    EZ_REPORT_FAILURE("CopyTextureReadbackResult can't be recorded with a deferred command encoder.");
+  }
+
+  virtual void GenerateMipMapsPlatform(const ezGALTextureResourceView* pResourceView) override
+  {
+    Write(ezGALDeferredCommandType::GenerateMipMaps);
+    Write(pResourceView);
+  }
+
+  // Misc
+
+  virtual void FlushPlatform() override
+  {
+    Write(ezGALDeferredCommandType::Flush);
+  }
+
+  // Debug helper functions
+
+  virtual void PushMarkerPlatform(const char* szMarker) override
+  {
+    Write(ezGALDeferredCommandType::PushMarker);
+    WriteString(szMarker);
+  }
+
+  virtual void PopMarkerPlatform() override
+  {
+    Write(ezGALDeferredCommandType::PopMarker);
+  }
+
+  virtual void InsertEventMarkerPlatform(const char* szMarker) override
+  {
+    Write(ezGALDeferredCommandType::InsertEventMarker);
+    WriteString(szMarker);
+  }
+
+  // Compute Dispatch
+
+  virtual void BeginComputePlatform() override
+  {
+    Write(ezGALDeferredCommandType::BeginCompute);
+  }
+
+  virtual void EndComputePlatform() override
+  {
+    Write(ezGALDeferredCommandType::EndCompute);
+  }
+
+  virtual ezResult DispatchPlatform(ezUInt32 uiThreadGroupCountX, ezUInt32 uiThreadGroupCountY, ezUInt32 uiThreadGroupCountZ) override
+  {
+    Write(ezGALDeferredCommandType::Dispatch);
+    Write(uiThreadGroupCountX);
+    Write(uiThreadGroupCountY);
+    Write(uiThreadGroupCountZ);
+    return EZ_SUCCESS;
+  }
+
+  virtual ezResult DispatchIndirectPlatform(const ezGALBuffer* pIndirectArgumentBuffer, ezUInt32 uiArgumentOffsetInBytes) override
+  {
+    Write(ezGALDeferredCommandType::DispatchIndirect);
+    Write(pIndirectArgumentBuffer);
+    Write(uiArgumentOffsetInBytes);
+    return EZ_SUCCESS;
+  }
+
+  // Draw functions
+
+  virtual void BeginRenderingPlatform(const ezGALRenderingSetup& renderingSetup) override
+  {
+    Write(ezGALDeferredCommandType::BeginRendering);
+    Write(m_RenderingSetups.GetCount());
+    m_RenderingSetups.PushBack(renderingSetup);
+  }
+
+  virtual void EndRenderingPlatform() override
+  {
+    Write(ezGALDeferredCommandType::EndRendering);
+  }
+
+  virtual void ClearPlatform(const ezColor& clearColor, ezUInt32 uiRenderTargetClearMask, bool bClearDepth, bool bClearStencil, float fDepthClear, ezUInt8 uiStencilClear) override
+  {
+    Write(ezGALDeferredCommandType::Clear);
+    Write(clearColor);
+    Write(uiRenderTargetClearMask);
+    Write(bClearDepth);
+    Write(bClearStencil);
+    Write(fDepthClear);
+    Write(uiStencilClear);
+  }
+
+  virtual ezResult DrawPlatform(ezUInt32 uiVertexCount, ezUInt32 uiStartVertex) override
+  {
+    Write(ezGALDeferredCommandType::Draw);
+    Write(uiVertexCount);
+    Write(uiStartVertex);
+    return EZ_SUCCESS;
+  }
+
+  virtual ezResult DrawIndexedPlatform(ezUInt32 uiIndexCount, ezUInt32 uiStartIndex) override
+  {
+    Write(ezGALDeferredCommandType::DrawIndexed);
+    Write(uiIndexCount);
+    Write(uiStartIndex);
+    return EZ_SUCCESS;
+  }
+
+  virtual ezResult DrawIndexedInstancedPlatform(ezUInt32 uiIndexCountPerInstance, ezUInt32 uiInstanceCount, ezUInt32 uiStartIndex) override
+  {
+    Write(ezGALDeferredCommandType::DrawIndexedInstanced);
+    Write(uiIndexCountPerInstance);
+    Write(uiInstanceCount);
+    Write(uiStartIndex);
+    return EZ_SUCCESS;
+  }
+
+  virtual ezResult DrawIndexedInstancedIndirectPlatform(const ezGALBuffer* pIndirectArgumentBuffer, ezUInt32 uiArgumentOffsetInBytes) override
+  {
+    Write(ezGALDeferredCommandType::DrawIndexedInstancedIndirect);
+    Write(pIndirectArgumentBuffer);
+    Write(uiArgumentOffsetInBytes);
+    return EZ_SUCCESS;
+  }
+
+  virtual ezResult DrawInstancedPlatform(ezUInt32 uiVertexCountPerInstance, ezUInt32 uiInstanceCount, ezUInt32 uiStartVertex) override
+  {
+    Write(ezGALDeferredCommandType::DrawInstanced);
+    Write(uiVertexCountPerInstance);
+    Write(uiInstanceCount);
+    Write(uiStartVertex);
+    return EZ_SUCCESS;
+  }
+
+  virtual ezResult DrawInstancedIndirectPlatform(const ezGALBuffer* pIndirectArgumentBuffer, ezUInt32 uiArgumentOffsetInBytes) override
+  {
+    Write(ezGALDeferredCommandType::DrawInstancedIndirect);
+    Write(pIndirectArgumentBuffer);
+    Write(uiArgumentOffsetInBytes);
+    return EZ_SUCCESS;
+  }
+
+  // State functions
+
+  virtual void SetIndexBufferPlatform(const ezGALBuffer* pIndexBuffer) override
+  {
+    Write(ezGALDeferredCommandType::SetIndexBuffer);
+    Write(pIndexBuffer);
+  }
+
+  virtual void SetVertexBufferPlatform(ezUInt32 uiSlot, const ezGALBuffer* pVertexBuffer) override
+  {
+    Write(ezGALDeferredCommandType::SetVertexBuffer);
+    Write(uiSlot);
+    Write(pVertexBuffer);
+  }
+
+  virtual void SetVertexDeclarationPlatform(const ezGALVertexDeclaration* pVertexDeclaration) override
+  {
+    Write(ezGALDeferredCommandType::SetVertexDeclaration);
+    Write(pVertexDeclaration);
+  }
+
+  virtual void SetPrimitiveTopologyPlatform(ezGALPrimitiveTopology::Enum topology) override
+  {
+    Write(ezGALDeferredCommandType::SetPrimitiveTopology);
+    Write(topology);
+  }
+
+  virtual void SetBlendStatePlatform(const ezGALBlendState* pBlendState, const ezColor& blendFactor, ezUInt32 uiSampleMask) override
+  {
+    Write(ezGALDeferredCommandType::SetBlendState);
+    Write(pBlendState);
+    Write(blendFactor);
+    Write(uiSampleMask);
+  }
+
+  virtual void SetDepthStencilStatePlatform(const ezGALDepthStencilState* pDepthStencilState, ezUInt8 uiStencilRefValue) override
+  {
+    Write(ezGALDeferredCommandType::SetDepthStencilState);
+    Write(pDepthStencilState);
+    Write(uiStencilRefValue);
+  }
+
+  virtual void SetRasterizerStatePlatform(const ezGALRasterizerState* pRasterizerState) override
+  {
+    Write(ezGALDeferredCommandType::SetRasterizerState);
+    Write(pRasterizerState);
+  }
+
+  virtual void SetViewportPlatform(const ezRectFloat& rect, float fMinDepth, float fMaxDepth) override
+  {
+    Write(ezGALDeferredCommandType::SetViewport);
+    Write(rect);
+    Write(fMinDepth);
+    Write(fMaxDepth);
+  }
+
+  virtual void SetScissorRectPlatform(const ezRectU32& rect) override
+  {
+    Write(ezGALDeferredCommandType::SetScissorRect);
+    Write(rect);
+  }
+
+private:
+  template <typename T>
+  void Write(const T& value)
+  {
+    const ezUInt32 uiOffset = m_Stream.GetCount();
+    m_Stream.SetCountUninitialized(uiOffset + sizeof(T));
+    ezMemoryUtils::RawByteCopy(m_Stream.GetData() + uiOffset, &value, sizeof(T));
+  }
+
+  template <typename T>
+  T Read(ezUInt32& inout_uiOffset) const
+  {
+    T value;
+    ezMemoryUtils::RawByteCopy(&value, m_Stream.GetData() + inout_uiOffset, sizeof(T));
+    inout_uiOffset += sizeof(T);
+    return value;
+  }
+
+  void WriteData(ezArrayPtr<const ezUInt8> data)
+  {
+    Write(data.GetCount());
+    m_Stream.PushBackRange(data);
+  }
+
+  ezArrayPtr<const ezUInt8> ReadData(ezUInt32& inout_uiOffset) const
+  {
+    const ezUInt32 uiSize = Read<ezUInt32>(inout_uiOffset);
+    ezArrayPtr<const ezUInt8> data = m_Stream.GetArrayPtr().GetSubArray(inout_uiOffset, uiSize);
+    inout_uiOffset += uiSize;
+    return data;
+  }
+
+  void WriteString(const char* szString)
+  {
+    // includes the terminator, so that the data can be used as a string directly
+    WriteData(ezArrayPtr<const ezUInt8>(reinterpret_cast<const ezUInt8*>(szString), ezStringUtils::GetStringElementCount(szString) + 1));
+  }
+
+  void WriteBinding(const ezShaderResourceBinding& binding)
+  {
+    Write(m_Bindings.GetCount());
+    m_Bindings.PushBack(binding);
+  }
+
+  const ezShaderResourceBinding& ReadBinding(ezUInt32& inout_uiOffset) const
+  {
+    return m_Bindings[Read<ezUInt32>(inout_uiOffset)];
+  }
+
+  ezDynamicArray<ezUInt8> m_Stream;
+  ezDeque<ezShaderResourceBinding> m_Bindings;
+  ezDeque<ezGALRenderingSetup> m_RenderingSetups;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+ezGALDeferredCommandEncoder::ezGALDeferredCommandEncoder(ezGALDevice& ref_device)
+  : ezGALDeferredCommandEncoder(ref_device, EZ_DEFAULT_NEW(ezGALDeferredCommandRecorder))
+{
+}
+
+ezGALDeferredCommandEncoder::ezGALDeferredCommandEncoder(ezGALDevice& ref_device, ezGALDeferredCommandRecorder* pRecorder)
+  : ezGALCommandEncoder(ref_device, *pRecorder)
+  , m_pRecorder(pRecorder, ezFoundation::GetDefaultAllocator())
+{
+  m_bDeferred = true;
+}
+
+ezGALDeferredCommandEncoder::~ezGALDeferredCommandEncoder() = default;
+
+void ezGALDeferredCommandEncoder::Replay(ezGALCommandEncoder& ref_target) const
+{
+  EZ_ASSERT_DEV(ezThreadUtils::IsMainThread(), "Deferred commands can only be replayed on the main thread.");
+  EZ_ASSERT_DEV(!ref_target.IsDeferred(), "Deferred commands can't be replayed into another deferred command encoder.");
+  EZ_ASSERT_DEV(m_CurrentCommandEncoderType == CommandEncoderType::Invalid, "The recording is not finished, EndRendering or EndCompute is missing.");
+  EZ_ASSERT_DEV(ref_target.m_CurrentCommandEncoderType == CommandEncoderType::Invalid, "Deferred commands can't be replayed inside a rendering or compute scope.");
+
+  m_pRecorder->Replay(ref_target.m_CommonImpl);
+
+  ref_target.m_uiDrawCalls += m_uiDrawCalls;
+  ref_target.m_uiDispatchCalls += m_uiDispatchCalls;
+
+  // the recorded commands changed the state behind the back of the target
+  ref_target.InvalidateState();
+}
+
+void ezGALDeferredCommandEncoder::Reset()
+{
+  EZ_ASSERT_DEV(m_CurrentCommandEncoderType == CommandEncoderType::Invalid, "Can't reset a deferred command encoder while recording a rendering or compute scope.");
+
+  m_pRecorder->Reset();
+  ClearStatisticsCounters();
+  InvalidateState();
+}
+
+bool ezGALDeferredCommandEncoder::IsEmpty() const
+{
+  return m_pRecorder->IsEmpty();
+}
+
+ezUInt32 ezGALDeferredCommandEncoder::GetRecordedDataSize() const
+{
+  return m_pRecorder->GetDataSize();
+}
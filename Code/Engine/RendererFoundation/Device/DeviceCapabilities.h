@@ -62,5 +62,6 @@ struct EZ_RENDERERFOUNDATION_DLL ezGALDeviceCapabilities
 
   // Texture related capabilities
   bool m_bSupportsSharedTextures = false;
+  bool m_bSupportsDepthStencilRegionCopy = false; ///< Whether CopyTextureRegion() can copy parts of depth stencil textures. D3D11 only allows copying them as a whole.
   ezDynamicArray<ezBitflags<ezGALResourceFormatSupport>> m_FormatSupport;
 };
@@ -110,6 +110,10 @@ GPUTimingScope* ezProfilingScopeAndMarker::Start(ezGALCommandEncoder* pCommandEn
 {
   pCommandEncoder->PushMarker(szName);
 
+  // timestamps can't be recorded for a later replay, deferred encoders only get the marker
+  if (pCommandEncoder->IsDeferred())
+    return nullptr;
+
   auto& timingScope = GPUProfilingSystem::AllocateScope();
   timingScope.m_BeginTimestamp = pCommandEncoder->InsertTimestamp();
   ezStringUtils::Copy(timingScope.m_szName, EZ_ARRAY_SIZE(timingScope.m_szName), szName);
@@ -120,8 +124,12 @@ GPUTimingScope* ezProfilingScopeAndMarker::Start(ezGALCommandEncoder* pCommandEn
 void ezProfilingScopeAndMarker::Stop(ezGALCommandEncoder* pCommandEncoder, GPUTimingScope*& ref_pTimingScope)
 {
   pCommandEncoder->PopMarker();
-  ref_pTimingScope->m_EndTimestamp = pCommandEncoder->InsertTimestamp();
-  ref_pTimingScope = nullptr;
+
+  if (ref_pTimingScope != nullptr)
+  {
+    ref_pTimingScope->m_EndTimestamp = pCommandEncoder->InsertTimestamp();
+    ref_pTimingScope = nullptr;
+  }
 }
 
 ezProfilingScopeAndMarker::ezProfilingScopeAndMarker(ezGALCommandEncoder* pCommandEncoder, const char* szName)
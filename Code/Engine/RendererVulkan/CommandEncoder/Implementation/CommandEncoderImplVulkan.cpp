@@ -363,6 +363,12 @@ void ezGALCommandEncoderImplVulkan::CopyTextureRegionPlatform(const ezGALTexture
   const ezVec3U32& DestinationPoint, const ezGALTexture* pSource,
   const ezGALTextureSubresource& SourceSubResource, const ezBoundingBoxu32& Box)
 {
+  if (m_bRenderPassActive)
+  {
+    m_pCommandBuffer->endRenderPass();
+    m_bRenderPassActive = false;
+  }
+
   auto destination = static_cast<const ezGALTextureVulkan*>(pDestination->GetParentResource());
   auto source = static_cast<const ezGALTextureVulkan*>(pSource->GetParentResource());
 
@@ -375,6 +381,10 @@ void ezGALCommandEncoderImplVulkan::CopyTextureRegionPlatform(const ezGALTexture
 
   ezVec3U32 extent = Box.m_vMax - Box.m_vMin;
 
+  m_pPipelineBarrier->EnsureImageLayout(source, vk::ImageLayout::eTransferSrcOptimal, vk::PipelineStageFlagBits::eTransfer, vk::AccessFlagBits::eTransferRead);
+  m_pPipelineBarrier->EnsureImageLayout(destination, vk::ImageLayout::eTransferDstOptimal, vk::PipelineStageFlagBits::eTransfer, vk::AccessFlagBits::eTransferWrite);
+  m_pPipelineBarrier->Flush();
+
   vk::ImageCopy imageCopy = {};
   imageCopy.dstOffset.x = DestinationPoint.x;
   imageCopy.dstOffset.y = DestinationPoint.y;
@@ -390,11 +400,11 @@ void ezGALCommandEncoderImplVulkan::CopyTextureRegionPlatform(const ezGALTexture
   imageCopy.srcOffset.y = Box.m_vMin.y;
   imageCopy.srcOffset.z = Box.m_vMin.z;
   imageCopy.srcSubresource.aspectMask = imageAspect;
-  imageCopy.srcSubresource.baseArrayLayer = DestinationSubResource.m_uiArraySlice;
+  imageCopy.srcSubresource.baseArrayLayer = SourceSubResource.m_uiArraySlice;
   imageCopy.srcSubresource.layerCount = 1;
   imageCopy.srcSubresource.mipLevel = SourceSubResource.m_uiMipLevel;
 
-  m_pCommandBuffer->copyImage(source->GetImage(), vk::ImageLayout::eGeneral, destination->GetImage(), vk::ImageLayout::eGeneral, 1, &imageCopy);
+  m_pCommandBuffer->copyImage(source->GetImage(), vk::ImageLayout::eTransferSrcOptimal, destination->GetImage(), vk::ImageLayout::eTransferDstOptimal, 1, &imageCopy);
 }
 
 void ezGALCommandEncoderImplVulkan::UpdateTexturePlatform(const ezGALTexture* pDestination, const ezGALTextureSubresource& DestinationSubResource,
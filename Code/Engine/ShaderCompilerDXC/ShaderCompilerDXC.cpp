@@ -184,6 +184,20 @@ ezResult ezShaderCompilerDXC::Compile(ezShaderProgramData& inout_Data, ezLogInte
   return EZ_SUCCESS;
 }
 
+void ezShaderCompilerDXC::GetCompilerVersion(ezStringBuilder& out_sVersion) const
+{
+  SUPER::GetCompilerVersion(out_sVersion);
+
+  ezComPtr<IDxcVersionInfo> pVersionInfo;
+  if (s_pDxcCompiler != nullptr && SUCCEEDED(s_pDxcCompiler->QueryInterface(IID_PPV_ARGS(pVersionInfo.put()))))
+  {
+    UINT32 uiMajor = 0;
+    UINT32 uiMinor = 0;
+    pVersionInfo->GetVersion(&uiMajor, &uiMinor);
+    out_sVersion.AppendFormat(" DXC {0}.{1}", uiMajor, uiMinor);
+  }
+}
+
 void ezShaderCompilerDXC::ConfigureDxcArgs(ezDynamicArray<ezStringWChar>& inout_Args)
 {
   inout_Args.PushBack(L"-spirv");
@@ -238,8 +252,12 @@ ezResult ezShaderCompilerDXC::CompileSPIRVShader(ezStringView sFile, ezStringVie
     pszArgs[i] = args[i].GetData();
   }
 
+  // compiler instances must not be used by multiple threads at once, and shader permutations are compiled in parallel
+  ezComPtr<IDxcCompiler3> pCompiler;
+  DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(pCompiler.put()));
+
   ezComPtr<IDxcResult> pResults;
-  s_pDxcCompiler->Compile(&Source, pszArgs.GetData(), pszArgs.GetCount(), nullptr, IID_PPV_ARGS(pResults.put()));
+  pCompiler->Compile(&Source, pszArgs.GetData(), pszArgs.GetCount(), nullptr, IID_PPV_ARGS(pResults.put()));
 
   ezComPtr<IDxcBlobUtf8> pErrors;
   pResults->GetOutput(DXC_OUT_ERRORS, IID_PPV_ARGS(pErrors.put()), nullptr);
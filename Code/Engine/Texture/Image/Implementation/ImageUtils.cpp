@@ -5,6 +5,8 @@
 #include <Foundation/IO/MemoryStream.h>
 #include <Foundation/Profiling/Profiling.h>
 #include <Foundation/SimdMath/SimdVec4f.h>
+#include <Foundation/SimdMath/SimdVec4i.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <Foundation/Time/Timestamp.h>
 #include <Texture/Image/ImageConversion.h>
 #include <Texture/Image/ImageEnums.h>
@@ -740,6 +742,201 @@ inline static void FilterLine(
   }
 }
 
+static void LoadLineUNorm8(const ezUInt8* pSource, ezSimdVec4f* pTarget, ezUInt32 uiNumPixels)
+{
+  const ezSimdFloat fScale(1.0f / 255.0f);
+
+  for (ezUInt32 i = 0; i < uiNumPixels; ++i, pSource += 4)
+  {
+    pTarget[i] = ezSimdVec4i(pSource[0], pSource[1], pSource[2], pSource[3]).ToFloat() * fScale;
+  }
+}
+
+static void StoreLineUNorm8(const ezSimdVec4f* pSource, ezUInt8* pTarget, ezUInt32 uiNumPixels)
+{
+  const ezSimdVec4f vZero = ezSimdVec4f::MakeZero();
+  const ezSimdVec4f vOne(1.0f);
+  const ezSimdFloat fScale(255.0f);
+  const ezSimdVec4f vHalf(0.5f);
+
+  for (ezUInt32 i = 0; i < uiNumPixels; ++i, pTarget += 4)
+  {
+    // with the value as the first operand, NaNs are flushed to zero, same as in ezImageConversion
+    const ezSimdVec4f v = pSource[i].CompMax(vZero).CompMin(vOne);
+
+    const ezSimdVec4i iv = ezSimdVec4i::Truncate(v * fScale + vHalf);
+    pTarget[0] = static_cast<ezUInt8>(iv.x());
+    pTarget[1] = static_cast<ezUInt8>(iv.y());
+    pTarget[2] = static_cast<ezUInt8>(iv.z());
+    pTarget[3] = static_cast<ezUInt8>(iv.w());
+  }
+}
+
+namespace
+{
+  /// \brief One separable filter pass of Scale3D, which resamples all rows of an image along a single axis.
+  ///
+  /// The rows of the target image are independent of each other, so they are distributed across the task system.
+  /// Source and target are either RGBA32 float or RGBA8 UNORM, the latter is converted on the fly.
+  struct ezImageScalePass
+  {
+    void FilterRows(ezUInt32 uiFirstRow, ezUInt32 uiEndRow) const;
+    void FilterRowHorizontal(ezUInt32 y, ezUInt32 z, ezUInt32 uiFace, ezUInt32 uiArrayIndex, ezDynamicArray<ezSimdVec4f, ezAlignedAllocatorWrapper>& ref_buffer) const;
+    void FilterRowVertical(ezUInt32 y, ezUInt32 z, ezUInt32 uiFace, ezUInt32 uiArrayIndex) const;
+
+    const ezImageView* m_pSource = nullptr;
+    ezImage* m_pTarget = nullptr;
+    const ezImageFilterWeights* m_pWeights = nullptr;
+    ezArrayPtr<const ezInt32> m_FirstSampleIndices;
+    ezImageAddressMode::Enum m_AddressMode = ezImageAddressMode::Clamp;
+    ezSimdVec4f m_vBorderColor;
+    ezUInt32 m_uiAxis = 0; // 0 = X, 1 = Y, 2 = Z
+    ezUInt32 m_uiNumSourceElements = 0;
+    bool m_bSourceUNorm8 = false;
+    bool m_bTargetUNorm8 = false;
+  };
+
+  void ezImageScalePass::FilterRows(ezUInt32 uiFirstRow, ezUInt32 uiEndRow) const
+  {
+    const ezUInt32 uiHeight = m_pTarget->GetHeight();
+    const ezUInt32 uiDepth = m_pTarget->GetDepth();
+    const ezUInt32 uiNumFaces = m_pTarget->GetNumFaces();
+
+    ezDynamicArray<ezSimdVec4f, ezAlignedAllocatorWrapper> buffer;
+
+    for (ezUInt32 uiRow = uiFirstRow; uiRow < uiEndRow; ++uiRow)
+    {
+      ezUInt32 r = uiRow;
+      const ezUInt32 y = r % uiHeight;
+      r /= uiHeight;
+      const ezUInt32 z = r % uiDepth;
+      r /= uiDepth;
+      const ezUInt32 uiFace = r % uiNumFaces;
+      const ezUInt32 uiArrayIndex = r / uiNumFaces;
+
+      if (m_uiAxis == 0)
+        FilterRowHorizontal(y, z, uiFace, uiArrayIndex, buffer);
+      else
+        FilterRowVertical(y, z, uiFace, uiArrayIndex);
+    }
+  }
+
+  void ezImageScalePass::FilterRowHorizontal(ezUInt32 y, ezUInt32 z, ezUInt32 uiFace, ezUInt32 uiArrayIndex, ezDynamicArray<ezSimdVec4f, ezAlignedAllocatorWrapper>& ref_buffer) const
+  {
+    const ezUInt32 uiSourceWidth = m_uiNumSourceElements;
+    const ezUInt32 uiTargetWidth = m_pTarget->GetWidth();
+
+    ref_buffer.SetCountUninitialized((m_bSourceUNorm8 ? uiSourceWidth : 0) + (m_bTargetUNorm8 ? uiTargetWidth : 0));
+
+    const ezSimdVec4f* pSource;
+    if (m_bSourceUNorm8)
+    {
+      LoadLineUNorm8(m_pSource->GetPixelPointer<ezUInt8>(0, uiFace, uiArrayIndex, 0, y, z), ref_buffer.GetData(), uiSourceWidth);
+      pSource = ref_buffer.GetData();
+    }
+    else
+    {
+      pSource = m_pSource->GetPixelPointer<ezSimdVec4f>(0, uiFace, uiArrayIndex, 0, y, z);
+    }
+
+    if (m_bTargetUNorm8)
+    {
+      ezSimdVec4f* pTarget = ref_buffer.GetData() + (m_bSourceUNorm8 ? uiSourceWidth : 0);
+      FilterLine(uiSourceWidth, pSource, pTarget, 1, *m_pWeights, m_FirstSampleIndices, m_AddressMode, m_vBorderColor);
+      StoreLineUNorm8(pTarget, m_pTarget->GetPixelPointer<ezUInt8>(0, uiFace, uiArrayIndex, 0, y, z), uiTargetWidth);
+    }
+    else
+    {
+      FilterLine(uiSourceWidth, pSource, m_pTarget->GetPixelPointer<ezSimdVec4f>(0, uiFace, uiArrayIndex, 0, y, z), 1, *m_pWeights, m_FirstSampleIndices, m_AddressMode, m_vBorderColor);
+    }
+  }
+
+  void ezImageScalePass::FilterRowVertical(ezUInt32 y, ezUInt32 z, ezUInt32 uiFace, ezUInt32 uiArrayIndex) const
+  {
+    // A target row is the weighted sum of entire source rows, so instead of walking down columns with a large stride,
+    // all source rows are read sequentially, a chunk of pixels at a time.
+    constexpr ezUInt32 uiChunkSize = 64;
+
+    const ezUInt32 uiWidth = m_pTarget->GetWidth();
+    const ezUInt32 uiTargetIndex = (m_uiAxis == 1) ? y : z;
+    const ezUInt32 uiNumWeights = m_pWeights->GetNumWeights();
+    const auto weightsView = m_pWeights->ViewWeights();
+    const float* pWeights = weightsView.GetPtr() + (uiTargetIndex * uiNumWeights) % weightsView.GetCount();
+
+    // null for samples that use the border color
+    ezHybridArray<const ezUInt8*, 64> sourceRows;
+    sourceRows.SetCountUninitialized(uiNumWeights);
+    for (ezUInt32 w = 0; w < uiNumWeights; ++w)
+    {
+      bool bUseBorderColor = false;
+      const ezUInt32 uiIndex = ezImageUtils::GetSampleIndex(m_uiNumSourceElements, m_FirstSampleIndices[uiTargetIndex] + w, m_AddressMode, bUseBorderColor);
+
+      if (bUseBorderColor)
+        sourceRows[w] = nullptr;
+      else if (m_uiAxis == 1)
+        sourceRows[w] = m_pSource->GetPixelPointer<ezUInt8>(0, uiFace, uiArrayIndex, 0, uiIndex, z);
+      else
+        sourceRows[w] = m_pSource->GetPixelPointer<ezUInt8>(0, uiFace, uiArrayIndex, 0, y, uiIndex);
+    }
+
+    ezSimdVec4f total[uiChunkSize];
+    ezSimdVec4f converted[uiChunkSize];
+
+    for (ezUInt32 x0 = 0; x0 < uiWidth; x0 += uiChunkSize)
+    {
+      const ezUInt32 uiNumPixels = ezMath::Min(uiChunkSize, uiWidth - x0);
+
+      for (ezUInt32 x = 0; x < uiNumPixels; ++x)
+      {
+        total[x].SetZero();
+      }
+
+      for (ezUInt32 w = 0; w < uiNumWeights; ++w)
+      {
+        const ezSimdFloat fWeight(pWeights[w]);
+
+        if (sourceRows[w] == nullptr)
+        {
+          for (ezUInt32 x = 0; x < uiNumPixels; ++x)
+          {
+            total[x] = ezSimdVec4f::MulAdd(m_vBorderColor, fWeight, total[x]);
+          }
+          continue;
+        }
+
+        const ezSimdVec4f* pSource;
+        if (m_bSourceUNorm8)
+        {
+          LoadLineUNorm8(sourceRows[w] + x0 * 4, converted, uiNumPixels);
+          pSource = converted;
+        }
+        else
+        {
+          pSource = reinterpret_cast<const ezSimdVec4f*>(sourceRows[w]) + x0;
+        }
+
+        for (ezUInt32 x = 0; x < uiNumPixels; ++x)
+        {
+          total[x] = ezSimdVec4f::MulAdd(pSource[x], fWeight, total[x]);
+        }
+      }
+
+      if (m_bTargetUNorm8)
+      {
+        StoreLineUNorm8(total, m_pTarget->GetPixelPointer<ezUInt8>(0, uiFace, uiArrayIndex, x0, y, z), uiNumPixels);
+      }
+      else
+      {
+        ezSimdVec4f* pTarget = m_pTarget->GetPixelPointer<ezSimdVec4f>(0, uiFace, uiArrayIndex, x0, y, z);
+        for (ezUInt32 x = 0; x < uiNumPixels; ++x)
+        {
+          pTarget[x] = total[x];
+        }
+      }
+    }
+  }
+} // namespace
+
 static void DownScaleFastLine(ezUInt32 uiPixelStride, const ezUInt8* pSrc, ezUInt8* pDest, ezUInt32 uiLengthIn, ezUInt32 uiStrideIn, ezUInt32 uiLengthOut, ezUInt32 uiStrideOut)
 {
   const ezUInt32 downScaleFactor = uiLengthIn / uiLengthOut;
@@ -768,6 +965,24 @@ static void DownScaleFastLine(ezUInt32 uiPixelStride, const ezUInt8* pSrc, ezUIn
   }
 }
 
+/// \brief Same as DownScaleFastLine, but averages whole rows at once, which reads the source sequentially.
+static void DownScaleFastRows(const ezUInt8* pSrc, ezUInt64 uiSrcRowPitch, ezUInt32 uiNumSrcRows, ezUInt8* pDest, ezUInt32 uiNumBytes)
+{
+  const ezUInt32 downScaleFactorLog2 = ezMath::Log2i(uiNumSrcRows);
+  const ezUInt32 roundOffset = uiNumSrcRows / 2;
+
+  for (ezUInt32 i = 0; i < uiNumBytes; ++i)
+  {
+    ezUInt32 curChannel = roundOffset;
+    for (ezUInt32 row = 0; row < uiNumSrcRows; ++row)
+    {
+      curChannel += static_cast<ezUInt32>(pSrc[row * uiSrcRowPitch + i]);
+    }
+
+    pDest[i] = static_cast<ezUInt8>(curChannel >> downScaleFactorLog2);
+  }
+}
+
 static void DownScaleFast(const ezImageView& image, ezImage& out_result, ezUInt32 uiWidth, ezUInt32 uiHeight)
 {
   ezImageFormat::Enum format = image.GetImageFormat();
@@ -789,16 +1004,23 @@ static void DownScaleFast(const ezImageView& image, ezImage& out_result, ezUInt3
   ezImage intermediate;
   intermediate.ResetAndAlloc(intermediateHeader);
 
-  for (ezUInt32 arrayIndex = 0; arrayIndex < numArrayElements; arrayIndex++)
-  {
-    for (ezUInt32 face = 0; face < numFaces; face++)
+  ezParallelForParams params;
+  params.m_uiBinSize = ezMath::Max(1u, (64u * 1024u) / (originalWidth * pixelStride));
+
+  ezTaskSystem::ParallelForIndexed(
+    0, numArrayElements * numFaces * originalHeight,
+    [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex)
     {
-      for (ezUInt32 row = 0; row < originalHeight; row++)
+      for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
       {
+        const ezUInt32 row = i % originalHeight;
+        const ezUInt32 face = (i / originalHeight) % numFaces;
+        const ezUInt32 arrayIndex = i / (originalHeight * numFaces);
+
         DownScaleFastLine(pixelStride, image.GetPixelPointer<ezUInt8>(0, face, arrayIndex, 0, row), intermediate.GetPixelPointer<ezUInt8>(0, face, arrayIndex, 0, row), originalWidth, pixelStride, uiWidth, pixelStride);
       }
-    }
-  }
+    },
+    "DownScaleFast", ezTaskNesting::Never, params);
 
   // input and output images may be the same, so we can't access the original image below this point
 
@@ -806,24 +1028,28 @@ static void DownScaleFast(const ezImageView& image, ezImage& out_result, ezUInt3
   outHeader.SetWidth(uiWidth);
   outHeader.SetHeight(uiHeight);
   outHeader.SetNumArrayIndices(numArrayElements);
-  outHeader.SetNumArrayIndices(numFaces);
+  outHeader.SetNumFaces(numFaces);
   outHeader.SetImageFormat(format);
 
   out_result.ResetAndAlloc(outHeader);
 
-  EZ_ASSERT_DEBUG(intermediate.GetRowPitch() < ezMath::MaxValue<ezUInt32>(), "Row pitch exceeds ezUInt32 max value.");
-  EZ_ASSERT_DEBUG(out_result.GetRowPitch() < ezMath::MaxValue<ezUInt32>(), "Row pitch exceeds ezUInt32 max value.");
+  const ezUInt32 downScaleFactorY = originalHeight / uiHeight;
+  params.m_uiBinSize = ezMath::Max(1u, (64u * 1024u) / (uiWidth * pixelStride * downScaleFactorY));
 
-  for (ezUInt32 arrayIndex = 0; arrayIndex < numArrayElements; arrayIndex++)
-  {
-    for (ezUInt32 face = 0; face < numFaces; face++)
+  ezTaskSystem::ParallelForIndexed(
+    0, numArrayElements * numFaces * uiHeight,
+    [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex)
     {
-      for (ezUInt32 col = 0; col < uiWidth; col++)
+      for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
       {
-        DownScaleFastLine(pixelStride, intermediate.GetPixelPointer<ezUInt8>(0, face, arrayIndex, col), out_result.GetPixelPointer<ezUInt8>(0, face, arrayIndex, col), originalHeight, static_cast<ezUInt32>(intermediate.GetRowPitch()), uiHeight, static_cast<ezUInt32>(out_result.GetRowPitch()));
+        const ezUInt32 row = i % uiHeight;
+        const ezUInt32 face = (i / uiHeight) % numFaces;
+        const ezUInt32 arrayIndex = i / (uiHeight * numFaces);
+
+        DownScaleFastRows(intermediate.GetPixelPointer<ezUInt8>(0, face, arrayIndex, 0, row * downScaleFactorY), intermediate.GetRowPitch(), downScaleFactorY, out_result.GetPixelPointer<ezUInt8>(0, face, arrayIndex, 0, row), uiWidth * pixelStride);
       }
-    }
-  }
+    },
+    "DownScaleFast", ezTaskNesting::Never, params);
 }
 
 static float EvaluateAverageCoverage(ezBlobPtr<const ezColor> colors, float fAlphaThreshold)
@@ -989,7 +1215,14 @@ ezResult ezImageUtils::Scale3D(const ezImageView& source, ezImage& ref_target, e
     }
   };
 
-  if (format == ezImageFormat::R32G32B32A32_FLOAT)
+  // RGBA8 is read and written directly by the filter passes, all other formats are converted to float first.
+  // If the target is the source image, the last pass has to go into a scratch image instead.
+  const bool bTargetIsSource = static_cast<const ezImageView*>(&ref_target) == &source;
+  const bool bFilterFloat = format == ezImageFormat::R32G32B32A32_FLOAT;
+  const bool bFilterUNorm8 = format == ezImageFormat::R8G8B8A8_UNORM;
+  const bool bWriteTargetDirectly = (bFilterFloat || bFilterUNorm8) && !bTargetIsSource;
+
+  if (bFilterFloat || bFilterUNorm8)
   {
     stepSource = &source;
   }
@@ -1004,106 +1237,37 @@ ezResult ezImageUtils::Scale3D(const ezImageView& source, ezImage& ref_target, e
     stepSource = &conversionScratch;
   };
 
-  ezHybridArray<ezInt32, 256> firstSampleIndices;
-  firstSampleIndices.Reserve(ezMath::Max(uiWidth, uiHeight, uiDepth));
+  const ezUInt32 targetSize[3] = {uiWidth, uiHeight, uiDepth};
+  const ezUInt32 originalSize[3] = {originalWidth, originalHeight, originalDepth};
+  const ezImageAddressMode::Enum addressModes[3] = {addressModeU, addressModeV, addressModeW};
 
-  if (uiWidth != originalWidth)
+  ezUInt32 lastAxis = 0;
+  for (ezUInt32 axis = 0; axis < 3; ++axis)
   {
-    ezImageFilterWeights weights(*pFilter, originalWidth, uiWidth);
-    firstSampleIndices.SetCountUninitialized(uiWidth);
-    for (ezUInt32 x = 0; x < uiWidth; ++x)
-    {
-      firstSampleIndices[x] = weights.GetFirstSourceSampleIndex(x);
-    }
-
-    ezImage* stepTarget;
-    if (uiHeight == originalHeight && uiDepth == originalDepth && format == ezImageFormat::R32G32B32A32_FLOAT)
-    {
-      stepTarget = &ref_target;
-    }
-    else
-    {
-      stepTarget = &allocateScratch();
-    }
-
-    ezImageHeader stepHeader = stepSource->GetHeader();
-    stepHeader.SetWidth(uiWidth);
-    stepTarget->ResetAndAlloc(stepHeader);
-
-    for (ezUInt32 arrayIndex = 0; arrayIndex < numArrayElements; ++arrayIndex)
+    if (targetSize[axis] != originalSize[axis])
     {
-      for (ezUInt32 face = 0; face < numFaces; ++face)
-      {
-        for (ezUInt32 z = 0; z < originalDepth; ++z)
-        {
-          for (ezUInt32 y = 0; y < originalHeight; ++y)
-          {
-            const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
-            ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
-            FilterLine(originalWidth, filterSource, filterTarget, 1, weights, firstSampleIndices, addressModeU, ezSimdVec4f(borderColor.r, borderColor.g, borderColor.b, borderColor.a));
-          }
-        }
-      }
+      lastAxis = axis;
     }
-
-    releaseScratch(*stepSource);
-    stepSource = stepTarget;
   }
 
-  if (uiHeight != originalHeight)
-  {
-    ezImageFilterWeights weights(*pFilter, originalHeight, uiHeight);
-    firstSampleIndices.SetCount(uiHeight);
-    for (ezUInt32 y = 0; y < uiHeight; ++y)
-    {
-      firstSampleIndices[y] = weights.GetFirstSourceSampleIndex(y);
-    }
-
-    ezImage* stepTarget;
-    if (uiDepth == originalDepth && format == ezImageFormat::R32G32B32A32_FLOAT)
-    {
-      stepTarget = &ref_target;
-    }
-    else
-    {
-      stepTarget = &allocateScratch();
-    }
+  ezHybridArray<ezInt32, 256> firstSampleIndices;
 
-    ezImageHeader stepHeader = stepSource->GetHeader();
-    stepHeader.SetHeight(uiHeight);
-    stepTarget->ResetAndAlloc(stepHeader);
+  for (ezUInt32 axis = 0; axis < 3; ++axis)
+  {
+    if (targetSize[axis] == originalSize[axis])
+      continue;
 
-    for (ezUInt32 arrayIndex = 0; arrayIndex < numArrayElements; ++arrayIndex)
+    ezImageFilterWeights weights(*pFilter, originalSize[axis], targetSize[axis]);
+    firstSampleIndices.SetCountUninitialized(targetSize[axis]);
+    for (ezUInt32 i = 0; i < targetSize[axis]; ++i)
     {
-      for (ezUInt32 face = 0; face < numFaces; ++face)
-      {
-        for (ezUInt32 z = 0; z < originalDepth; ++z)
-        {
-          for (ezUInt32 x = 0; x < uiWidth; ++x)
-          {
-            const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, 0, z);
-            ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, 0, z);
-            FilterLine(originalHeight, filterSource, filterTarget, uiWidth, weights, firstSampleIndices, addressModeV, ezSimdVec4f(borderColor.r, borderColor.g, borderColor.b, borderColor.a));
-          }
-        }
-      }
+      firstSampleIndices[i] = weights.GetFirstSourceSampleIndex(i);
     }
 
-    releaseScratch(*stepSource);
-    stepSource = stepTarget;
-  }
-
-  if (uiDepth != originalDepth)
-  {
-    ezImageFilterWeights weights(*pFilter, originalDepth, uiDepth);
-    firstSampleIndices.SetCount(uiDepth);
-    for (ezUInt32 z = 0; z < uiDepth; ++z)
-    {
-      firstSampleIndices[z] = weights.GetFirstSourceSampleIndex(z);
-    }
+    const bool bIsLastPass = axis == lastAxis;
 
     ezImage* stepTarget;
-    if (format == ezImageFormat::R32G32B32A32_FLOAT)
+    if (bIsLastPass && bWriteTargetDirectly)
     {
       stepTarget = &ref_target;
     }
@@ -1113,24 +1277,34 @@ ezResult ezImageUtils::Scale3D(const ezImageView& source, ezImage& ref_target, e
     }
 
     ezImageHeader stepHeader = stepSource->GetHeader();
-    stepHeader.SetDepth(uiDepth);
+    stepHeader.SetWidth(axis == 0 ? uiWidth : stepHeader.GetWidth());
+    stepHeader.SetHeight(axis == 1 ? uiHeight : stepHeader.GetHeight());
+    stepHeader.SetDepth(axis == 2 ? uiDepth : stepHeader.GetDepth());
+    stepHeader.SetImageFormat(bIsLastPass && bWriteTargetDirectly ? format : ezImageFormat::R32G32B32A32_FLOAT);
     stepTarget->ResetAndAlloc(stepHeader);
 
-    for (ezUInt32 arrayIndex = 0; arrayIndex < numArrayElements; ++arrayIndex)
-    {
-      for (ezUInt32 face = 0; face < numFaces; ++face)
-      {
-        for (ezUInt32 y = 0; y < uiHeight; ++y)
-        {
-          for (ezUInt32 x = 0; x < uiWidth; ++x)
-          {
-            const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, y, 0);
-            ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, y, 0);
-            FilterLine(originalHeight, filterSource, filterTarget, uiWidth * uiHeight, weights, firstSampleIndices, addressModeW, ezSimdVec4f(borderColor.r, borderColor.g, borderColor.b, borderColor.a));
-          }
-        }
-      }
-    }
+    ezImageScalePass pass;
+    pass.m_pSource = stepSource;
+    pass.m_pTarget = stepTarget;
+    pass.m_pWeights = &weights;
+    pass.m_FirstSampleIndices = firstSampleIndices;
+    pass.m_AddressMode = addressModes[axis];
+    pass.m_vBorderColor = ezSimdVec4f(borderColor.r, borderColor.g, borderColor.b, borderColor.a);
+    pass.m_uiAxis = axis;
+    pass.m_uiNumSourceElements = originalSize[axis];
+    pass.m_bSourceUNorm8 = stepSource->GetImageFormat() == ezImageFormat::R8G8B8A8_UNORM;
+    pass.m_bTargetUNorm8 = stepHeader.GetImageFormat() == ezImageFormat::R8G8B8A8_UNORM;
+
+    const ezUInt32 numRows = stepHeader.GetHeight() * stepHeader.GetDepth() * numFaces * numArrayElements;
+    const ezUInt32 workPerRow = stepHeader.GetWidth() * weights.GetNumWeights();
+
+    ezParallelForParams params;
+    params.m_uiBinSize = ezMath::Max(1u, (16u * 1024u) / ezMath::Max(1u, workPerRow));
+
+    ezTaskSystem::ParallelForIndexed(
+      0, numRows, [&pass](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex)
+      { pass.FilterRows(uiStartIndex, uiEndIndex); },
+      "ezImageUtils::Scale3D", ezTaskNesting::Never, params);
 
     releaseScratch(*stepSource);
     stepSource = stepTarget;
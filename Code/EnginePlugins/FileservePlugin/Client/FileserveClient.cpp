@@ -9,6 +9,7 @@
 #include <Foundation/Logging/Log.h>
 #include <Foundation/Types/ScopeExit.h>
 #include <Foundation/Utilities/CommandLineUtils.h>
+#include <Foundation/Utilities/Compression.h>
 
 EZ_IMPLEMENT_SINGLETON(ezFileserveClient);
 
@@ -74,6 +75,8 @@ void ezFileserveClient::ClearState()
   m_CurFileRequestGuid = ezUuid();
   m_sCurFileRequest.Clear();
   m_Download.Clear();
+  m_PrefetchBatches.Clear();
+  m_PrefetchFallbackFiles.Clear();
 }
 
 ezResult ezFileserveClient::EnsureConnected(ezTime timeout)
@@ -347,6 +350,18 @@ void ezFileserveClient::NetworkMsgHandler(ezRemoteMessage& msg)
     return;
   }
 
+  if (msg.GetMessageID() == 'BTDL')
+  {
+    HandleBatchFileTransferMsg(msg);
+    return;
+  }
+
+  if (msg.GetMessageID() == 'BTFN')
+  {
+    HandleBatchFileTransferFinishedMsg(msg);
+    return;
+  }
+
   static bool s_bReloadResources = false;
 
   if (msg.GetMessageID() == 'RLDR')
@@ -354,7 +369,7 @@ void ezFileserveClient::NetworkMsgHandler(ezRemoteMessage& msg)
     s_bReloadResources = true;
   }
 
-  if (!m_bDownloading && s_bReloadResources)
+  if (!m_bDownloading && m_PrefetchBatches.IsEmpty() && s_bReloadResources)
   {
     EZ_BROADCAST_EVENT(ezResourceManager_ReloadAllResources);
     s_bReloadResources = false;
@@ -514,13 +529,20 @@ void ezFileserveClient::HandleFileTransferFinishedMsg(ezRemoteMessage& msg)
   ezUInt16 uiFoundInDataDir = 0;
   msg.GetReader() >> uiFoundInDataDir;
 
-  if (uiFoundInDataDir == 0xffff)         // file does not exist on server in any data dir
+  ApplyFileState(m_sCurFileRequest, fileState, iFileTimeStamp, uiFileHash, uiFoundInDataDir, m_Download);
+}
+
+void ezFileserveClient::ApplyFileState(ezStringView sFile, ezFileserveFileState fileState, ezInt64 iFileTimeStamp, ezUInt64 uiFileHash, ezUInt16 uiFoundInDataDir, ezArrayPtr<const ezUInt8> content)
+{
+  EZ_LOCK(m_Mutex);
+
+  if (uiFoundInDataDir == 0xffff) // file does not exist on server in any data dir
   {
-    m_FileDataDir[m_sCurFileRequest] = 0; // placeholder
+    m_FileDataDir[sFile] = 0;      // placeholder
 
     for (ezUInt32 i = 0; i < m_MountedDataDirs.GetCount(); ++i)
     {
-      auto& ref = m_MountedDataDirs[i].m_CacheStatus[m_sCurFileRequest];
+      auto& ref = m_MountedDataDirs[i].m_CacheStatus[sFile];
       ref.m_FileHash = 0;
       ref.m_TimeStamp = 0;
       ref.m_LastCheck = m_CurrentTime;
@@ -530,9 +552,9 @@ void ezFileserveClient::HandleFileTransferFinishedMsg(ezRemoteMessage& msg)
   }
   else
   {
-    m_FileDataDir[m_sCurFileRequest] = uiFoundInDataDir;
+    m_FileDataDir[sFile] = uiFoundInDataDir;
 
-    auto& ref = m_MountedDataDirs[uiFoundInDataDir].m_CacheStatus[m_sCurFileRequest];
+    auto& ref = m_MountedDataDirs[uiFoundInDataDir].m_CacheStatus[sFile];
     ref.m_FileHash = uiFileHash;
     ref.m_TimeStamp = iFileTimeStamp;
     ref.m_LastCheck = m_CurrentTime;
@@ -544,7 +566,7 @@ void ezFileserveClient::HandleFileTransferFinishedMsg(ezRemoteMessage& msg)
 
   const ezString& sMountPoint = m_MountedDataDirs[uiFoundInDataDir].m_sMountPoint;
   ezStringBuilder sCachedFile, sCachedMetaFile;
-  BuildPathInCache(m_sCurFileRequest, sMountPoint, &sCachedFile, &sCachedMetaFile);
+  BuildPathInCache(ezStringBuilder(sFile), sMountPoint, &sCachedFile, &sCachedMetaFile);
 
   if (fileState == ezFileserveFileState::NonExistant)
   {
@@ -562,12 +584,138 @@ void ezFileserveClient::HandleFileTransferFinishedMsg(ezRemoteMessage& msg)
 
   if (fileState == ezFileserveFileState::Different)
   {
-    WriteDownloadToDisk(sCachedFile);
+    WriteDownloadToDisk(sCachedFile, content);
     WriteMetaFile(sCachedMetaFile, iFileTimeStamp, uiFileHash);
   }
 }
 
 
+void ezFileserveClient::HandleBatchFileTransferMsg(ezRemoteMessage& msg)
+{
+  EZ_LOCK(m_Mutex);
+
+  ezUuid batchGuid;
+  msg.GetReader() >> batchGuid;
+
+  PrefetchBatch* pBatch = nullptr;
+  for (auto& batch : m_PrefetchBatches)
+  {
+    if (batch.m_BatchGuid == batchGuid)
+      pBatch = &batch;
+  }
+
+  if (pBatch == nullptr)
+  {
+    // ezLog::Debug("Fileserver is answering someone else");
+    return;
+  }
+
+  ezUInt32 uiFileIndex = 0;
+  msg.GetReader() >> uiFileIndex;
+
+  bool bCompressed = false;
+  msg.GetReader() >> bCompressed;
+
+  ezUInt32 uiStreamSize = 0;
+  msg.GetReader() >> uiStreamSize;
+
+  ezUInt32 uiChunkSize = 0;
+  msg.GetReader() >> uiChunkSize;
+
+  if (uiFileIndex >= pBatch->m_Files.GetCount())
+  {
+    ezLog::Error("Fileserve batch download references an invalid file index {0}", uiFileIndex);
+    return;
+  }
+
+  PrefetchFile& file = pBatch->m_Files[uiFileIndex];
+  file.m_bCompressed = bCompressed;
+
+  // make sure we don't need to reallocate
+  file.m_Data.Reserve(uiStreamSize);
+
+  if (uiChunkSize > 0)
+  {
+    const ezUInt32 uiStartPos = file.m_Data.GetCount();
+    file.m_Data.SetCountUninitialized(uiStartPos + uiChunkSize);
+    msg.GetReader().ReadBytes(&file.m_Data[uiStartPos], uiChunkSize);
+  }
+}
+
+void ezFileserveClient::HandleBatchFileTransferFinishedMsg(ezRemoteMessage& msg)
+{
+  EZ_LOCK(m_Mutex);
+
+  ezUuid batchGuid;
+  msg.GetReader() >> batchGuid;
+
+  ezUInt32 uiBatchIndex = ezInvalidIndex;
+  for (ezUInt32 i = 0; i < m_PrefetchBatches.GetCount(); ++i)
+  {
+    if (m_PrefetchBatches[i].m_BatchGuid == batchGuid)
+      uiBatchIndex = i;
+  }
+
+  if (uiBatchIndex == ezInvalidIndex)
+  {
+    // ezLog::Debug("Fileserver is answering someone else");
+    return;
+  }
+
+  PrefetchBatch batch = std::move(m_PrefetchBatches[uiBatchIndex]);
+  m_PrefetchBatches.RemoveAtAndCopy(uiBatchIndex);
+
+  ezUInt32 uiNumFiles = 0;
+  msg.GetReader() >> uiNumFiles;
+
+  if (uiNumFiles != batch.m_Files.GetCount())
+  {
+    ezLog::Warning("Fileserve batch answer contains {0} files, but {1} were requested. The remaining files are downloaded one by one.", uiNumFiles, batch.m_Files.GetCount());
+
+    for (ezUInt32 i = uiNumFiles; i < batch.m_Files.GetCount(); ++i)
+    {
+      m_PrefetchFallbackFiles.PushBack(batch.m_Files[i].m_sFile);
+    }
+
+    uiNumFiles = ezMath::Min(uiNumFiles, batch.m_Files.GetCount());
+  }
+
+  ezDynamicArray<ezUInt8> decompressed;
+
+  // the server answers with the state of all files in one message, this is the counterpart to the manifest that was sent with the request
+  for (ezUInt32 i = 0; i < uiNumFiles; ++i)
+  {
+    PrefetchFile& file = batch.m_Files[i];
+
+    ezInt8 iFileStatus = 0;
+    msg.GetReader() >> iFileStatus;
+
+    ezInt64 iFileTimeStamp = 0;
+    msg.GetReader() >> iFileTimeStamp;
+
+    ezUInt64 uiFileHash = 0;
+    msg.GetReader() >> uiFileHash;
+
+    ezUInt16 uiFoundInDataDir = 0;
+    msg.GetReader() >> uiFoundInDataDir;
+
+    ezArrayPtr<const ezUInt8> content = file.m_Data;
+
+    if (file.m_bCompressed)
+    {
+      if (ezCompressionUtils::Decompress(file.m_Data, ezCompressionMethod::ZStd, decompressed).Failed())
+      {
+        ezLog::Error("Failed to decompress '{0}' from the fileserver", file.m_sFile);
+        continue;
+      }
+
+      content = decompressed;
+    }
+
+    ApplyFileState(file.m_sFile, (ezFileserveFileState)iFileStatus, iFileTimeStamp, uiFileHash, uiFoundInDataDir, content);
+  }
+}
+
 void ezFileserveClient::WriteMetaFile(ezStringBuilder sCachedMetaFile, ezInt64 iFileTimeStamp, ezUInt64 uiFileHash)
 {
   ezOSFile file;
@@ -584,14 +732,13 @@ void ezFileserveClient::WriteMetaFile(ezStringBuilder sCachedMetaFile, ezInt64 i
   }
 }
 
-void ezFileserveClient::WriteDownloadToDisk(ezStringBuilder sCachedFile)
+void ezFileserveClient::WriteDownloadToDisk(ezStringBuilder sCachedFile, ezArrayPtr<const ezUInt8> content)
 {
-  EZ_LOCK(m_Mutex);
   ezOSFile file;
   if (file.Open(sCachedFile, ezFileOpenMode::Write).Succeeded())
   {
-    if (!m_Download.IsEmpty())
-      file.Write(m_Download.GetData(), m_Download.GetCount()).IgnoreResult();
+    if (!content.IsEmpty())
+      file.Write(content.GetPtr(), content.GetCount()).IgnoreResult();
 
     file.Close();
   }
@@ -689,6 +836,123 @@ ezResult ezFileserveClient::DownloadFile(ezUInt16 uiDataDirID, const char* szFil
   }
 }
 
+ezResult ezFileserveClient::PrefetchFiles(ezArrayPtr<const ezString> files)
+{
+  EZ_LOCK(m_Mutex);
+  if (m_bDownloading || !m_PrefetchBatches.IsEmpty())
+  {
+    ezLog::Warning("Trying to prefetch files over fileserve while another download is running. Recursive download is ignored.");
+    return EZ_FAILURE;
+  }
+
+  if (m_pNetwork == nullptr || !m_pNetwork->IsConnectedToServer())
+    return EZ_FAILURE;
+
+  m_PrefetchFallbackFiles.Clear();
+
+  // Small batches keep the server busy with the next batch while the client writes the previous one to disk.
+  // The number of batches in flight limits how much data piles up on the client.
+  constexpr ezUInt32 uiFilesPerBatch = 64;
+  constexpr ezUInt32 uiMaxBatchesInFlight = 4;
+
+  auto WaitForBatches = [&](ezUInt32 uiMaxBatches)
+  {
+    while (m_PrefetchBatches.GetCount() > uiMaxBatches && m_pNetwork->IsConnectedToServer())
+    {
+      m_pNetwork->UpdateRemoteInterface();
+      m_pNetwork->ExecuteAllMessageHandlers();
+    }
+  };
+
+  for (const ezString& sFile : files)
+  {
+    bool bCachedYet = false;
+    auto itFileDataDir = m_FileDataDir.FindOrAdd(sFile, &bCachedYet);
+    if (!bCachedYet)
+    {
+      FillFileStatusCache(sFile);
+    }
+
+    const FileCacheStatus& CacheStatus = m_MountedDataDirs[itFileDataDir.Value()].m_CacheStatus[sFile];
+
+    // same rule as in DownloadFile, files that were checked recently are not requested again
+    if (m_CurrentTime - CacheStatus.m_LastCheck < ezTime::MakeFromSeconds(5.0f))
+      continue;
+
+    if (m_PrefetchBatches.IsEmpty() || m_PrefetchBatches.PeekBack().m_Files.GetCount() >= uiFilesPerBatch)
+    {
+      if (!m_PrefetchBatches.IsEmpty())
+      {
+        SendPrefetchBatch();
+        WaitForBatches(uiMaxBatchesInFlight);
+      }
+
+      m_PrefetchBatches.ExpandAndGetRef().m_BatchGuid = ezUuid::MakeUuid();
+    }
+
+    m_PrefetchBatches.PeekBack().m_Files.ExpandAndGetRef().m_sFile = sFile;
+  }
+
+  if (!m_PrefetchBatches.IsEmpty())
+  {
+    SendPrefetchBatch();
+    WaitForBatches(0);
+  }
+
+  if (!m_PrefetchBatches.IsEmpty())
+  {
+    // lost the connection in between
+    m_PrefetchBatches.Clear();
+    m_PrefetchFallbackFiles.Clear();
+    return EZ_FAILURE;
+  }
+
+  // the server didn't answer for these in their batch, so fall back to the regular protocol
+  ezResult res = EZ_SUCCESS;
+  for (const ezString& sFile : m_PrefetchFallbackFiles)
+  {
+    if (DownloadFile(m_FileDataDir[sFile], sFile, false, nullptr).Failed() && !m_pNetwork->IsConnectedToServer())
+    {
+      res = EZ_FAILURE;
+      break;
+    }
+  }
+
+  m_PrefetchFallbackFiles.Clear();
+  return res;
+}
+
+void ezFileserveClient::SendPrefetchBatch()
+{
+  EZ_LOCK(m_Mutex);
+  const PrefetchBatch& batch = m_PrefetchBatches.PeekBack();
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  const bool bAllowCompression = true;
+#else
+  const bool bAllowCompression = false;
+#endif
+
+  ezRemoteMessage msg('FSRV', 'RDBT');
+  msg.GetWriter() << batch.m_BatchGuid;
+  msg.GetWriter() << bAllowCompression;
+  msg.GetWriter() << batch.m_Files.GetCount();
+
+  // the manifest of the local cache, the server only sends back the files for which this does not match anymore
+  for (const PrefetchFile& file : batch.m_Files)
+  {
+    const ezUInt16 uiUseDataDirCache = m_FileDataDir[file.m_sFile];
+    const FileCacheStatus& CacheStatus = m_MountedDataDirs[uiUseDataDirCache].m_CacheStatus[file.m_sFile];
+
+    msg.GetWriter() << uiUseDataDirCache;
+    msg.GetWriter() << file.m_sFile;
+    msg.GetWriter() << CacheStatus.m_TimeStamp;
+    msg.GetWriter() << CacheStatus.m_FileHash;
+  }
+
+  m_pNetwork->Send(ezRemoteTransmitMode::Reliable, msg);
+}
+
 void ezFileserveClient::DetermineCacheStatus(ezUInt16 uiDataDirID, const char* szFile, FileCacheStatus& out_Status) const
 {
   EZ_LOCK(m_Mutex);
@@ -905,6 +1169,33 @@ EZ_ON_GLOBAL_EVENT(GameApp_UpdatePlugins)
   }
 }
 
+EZ_ON_GLOBAL_EVENT(SceneLoading_PrefetchFiles)
+{
+  ezFileserveClient* pClient = ezFileserveClient::GetSingleton();
+  if (pClient == nullptr || !param0.IsA<ezVariantArray>())
+    return;
+
+  const ezVariantArray& fileVars = param0.Get<ezVariantArray>();
+
+  ezDynamicArray<ezString> files;
+  files.Reserve(fileVars.GetCount());
+
+  for (const ezVariant& file : fileVars)
+  {
+    if (file.IsA<ezString>())
+    {
+      files.PushBack(file.Get<ezString>());
+    }
+  }
+
+  EZ_LOG_BLOCK("Fileserve Prefetch");
+
+  if (pClient->PrefetchFiles(files).Failed())
+  {
+    ezLog::Dev("Prefetching {0} files over fileserve failed, they are downloaded on demand instead.", files.GetCount());
+  }
+}
+
 
 
 EZ_STATICLINK_FILE(FileservePlugin, FileservePlugin_Client_FileserveClient);
@@ -3,6 +3,7 @@
 #include <FileservePlugin/FileservePluginDLL.h>
 
 #include <Core/Interfaces/RemoteToolingInterface.h>
+#include <FileservePlugin/Fileserver/ClientContext.h>
 #include <Foundation/Communication/RemoteInterface.h>
 #include <Foundation/Configuration/Singleton.h>
 #include <Foundation/Types/UniquePtr.h>
@@ -66,6 +67,9 @@ public:
   /// Also achieved through the command line argument "-fs_off"
   static void DisabledFileserveClient() { s_bEnableFileserve = false; }
 
+  /// \brief Enables the file serving functionality again. Creating an ezFileserver disables the client, so this is needed to run both in one process.
+  static void EnableFileserveClient() { s_bEnableFileserve = true; }
+
   /// \brief Returns the address through which the Fileserve client tried to connect with the server last.
   const char* GetServerConnectionAddress() { return m_sServerConnectionAddress; }
 
@@ -85,6 +89,18 @@ public:
   /// \brief Adds an address that should be tried for connecting with the server.
   void AddServerAddressToTry(ezStringView sAddress);
 
+  /// \brief Brings all the given files into the local cache with as few round trips as possible.
+  ///
+  /// The paths are relative to the mounted data directories, just like the paths that are passed to the file system.
+  /// The client sends the cache state of all files (timestamp and hash) to the server in batches, without waiting for an answer in between.
+  /// The server checks them in bulk and streams back only the files that changed, compressed with zstd where that pays off.
+  /// Files that were checked recently are skipped entirely.
+  ///
+  /// Afterwards opening any of these files does not need to contact the server anymore.
+  /// This is meant to be called with a whole list of dependencies. ezSceneLoadUtility does that through the global event
+  /// 'SceneLoading_PrefetchFiles' with the files of the preload collection of a scene.
+  ezResult PrefetchFiles(ezArrayPtr<const ezString> files);
+
 private:
   friend class ezDataDirectory::FileserveType;
 
@@ -118,7 +134,11 @@ private:
   void HandleFileTransferMsg(ezRemoteMessage& msg);
   void HandleFileTransferFinishedMsg(ezRemoteMessage& msg);
   static void WriteMetaFile(ezStringBuilder sCachedMetaFile, ezInt64 iFileTimeStamp, ezUInt64 uiFileHash);
-  void WriteDownloadToDisk(ezStringBuilder sCachedFile);
+  void WriteDownloadToDisk(ezStringBuilder sCachedFile, ezArrayPtr<const ezUInt8> content);
+  void ApplyFileState(ezStringView sFile, ezFileserveFileState fileState, ezInt64 iFileTimeStamp, ezUInt64 uiFileHash, ezUInt16 uiFoundInDataDir, ezArrayPtr<const ezUInt8> content);
+  void HandleBatchFileTransferMsg(ezRemoteMessage& msg);
+  void HandleBatchFileTransferFinishedMsg(ezRemoteMessage& msg);
+  void SendPrefetchBatch();
   ezResult DownloadFile(ezUInt16 uiDataDirID, const char* szFile, bool bForceThisDataDir, ezStringBuilder* out_pFullPath);
   void DetermineCacheStatus(ezUInt16 uiDataDirID, const char* szFile, FileCacheStatus& out_Status) const;
   void UploadFile(ezUInt16 uiDataDirID, const char* szFile, const ezDynamicArray<ezUInt8>& fileContent);
@@ -145,4 +165,21 @@ private:
 
   ezMap<ezString, ezUInt16> m_FileDataDir;
   ezHybridArray<DataDir, 8> m_MountedDataDirs;
+
+  struct PrefetchFile
+  {
+    ezString m_sFile;
+    bool m_bCompressed = false;
+    ezDynamicArray<ezUInt8> m_Data;
+  };
+
+  struct PrefetchBatch
+  {
+    ezUuid m_BatchGuid;
+    ezDynamicArray<PrefetchFile> m_Files;
+  };
+
+  /// The batch that is currently being filled is always the last one, all others are waiting for the server.
+  ezDynamicArray<PrefetchBatch> m_PrefetchBatches;
+  ezDynamicArray<ezString> m_PrefetchFallbackFiles; ///< Files that a batch answer was missing, PrefetchFiles() downloads them one by one.
 };
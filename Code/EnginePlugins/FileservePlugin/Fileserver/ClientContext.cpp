@@ -1,7 +1,7 @@
 #include <FileservePlugin/FileservePluginPCH.h>
 
 #include <FileservePlugin/Fileserver/ClientContext.h>
-#include <Foundation/IO/FileSystem/FileReader.h>
+#include <Foundation/IO/OSFile.h>
 
 ezFileserveFileState ezFileserveClientContext::GetFileStatus(ezUInt16& inout_uiDataDirID, const char* szRequestedFile, FileStatus& inout_status,
   ezDynamicArray<ezUInt8>& out_fileContent, bool bForceThisDataDir) const
@@ -38,9 +38,10 @@ ezFileserveFileState ezFileserveClientContext::GetFileStatus(ezUInt16& inout_uiD
     inout_status.m_iTimestamp = iNewTimestamp;
 
     // read the entire file
+    // not through ezFileSystem, a client in the same process may hold the file system mutex while it waits for this answer
     {
-      ezFileReader file;
-      if (file.Open(sAbsPath).Failed())
+      ezOSFile file;
+      if (file.Open(sAbsPath, ezFileOpenMode::Read).Failed())
         continue;
 
       ezUInt64 uiNewHash = 1;
@@ -48,7 +49,7 @@ ezFileserveFileState ezFileserveClientContext::GetFileStatus(ezUInt16& inout_uiD
 
       if (!out_fileContent.IsEmpty())
       {
-        file.ReadBytes(out_fileContent.GetData(), out_fileContent.GetCount());
+        file.Read(out_fileContent.GetData(), out_fileContent.GetCount());
         uiNewHash = ezHashingUtils::xxHash64(out_fileContent.GetData(), (size_t)out_fileContent.GetCount(), uiNewHash);
 
         // if the file is empty, the hash will be zero, which could lead to an incorrect assumption that the hash is the same
@@ -6,6 +6,7 @@
 #include <Foundation/Communication/RemoteInterfaceEnet.h>
 #include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/Utilities/CommandLineUtils.h>
+#include <Foundation/Utilities/Compression.h>
 
 EZ_IMPLEMENT_SINGLETON(ezFileserver);
 
@@ -103,6 +104,12 @@ void ezFileserver::NetworkMsgHandler(ezRemoteMessage& msg)
     return;
   }
 
+  if (msg.GetMessageID() == 'RDBT')
+  {
+    HandleBatchFileRequest(client, msg);
+    return;
+  }
+
   if (msg.GetMessageID() == 'UPLH')
   {
     HandleUploadFileHeader(client, msg);
@@ -345,6 +352,110 @@ void ezFileserver::HandleFileRequest(ezFileserveClientContext& client, ezRemoteM
   }
 }
 
+void ezFileserver::HandleBatchFileRequest(ezFileserveClientContext& client, ezRemoteMessage& msg)
+{
+  ezUuid batchGuid;
+  msg.GetReader() >> batchGuid;
+
+  bool bAllowCompression = false;
+  msg.GetReader() >> bAllowCompression;
+
+  ezUInt32 uiNumFiles = 0;
+  msg.GetReader() >> uiNumFiles;
+
+  // the state of all files goes back in a single message at the end
+  ezRemoteMessage fin('FSRV', 'BTFN');
+  fin.GetWriter() << batchGuid;
+  fin.GetWriter() << uiNumFiles;
+
+  ezStringBuilder sRequestedFile;
+
+  for (ezUInt32 uiFileIndex = 0; uiFileIndex < uiNumFiles; ++uiFileIndex)
+  {
+    ezUInt16 uiDataDirID = 0;
+    msg.GetReader() >> uiDataDirID;
+    msg.GetReader() >> sRequestedFile;
+
+    ezFileserveClientContext::FileStatus status;
+    msg.GetReader() >> status.m_iTimestamp;
+    msg.GetReader() >> status.m_uiHash;
+
+    ezFileserverEvent e;
+    e.m_uiClientID = client.m_uiApplicationID;
+    e.m_szPath = sRequestedFile;
+    e.m_uiSentTotal = 0;
+
+    const ezFileserveFileState filestate = client.GetFileStatus(uiDataDirID, sRequestedFile, status, m_SendToClient, false);
+
+    {
+      e.m_Type = ezFileserverEvent::Type::FileDownloadRequest;
+      e.m_uiSizeTotal = m_SendToClient.GetCount();
+      e.m_FileState = filestate;
+      m_Events.Broadcast(e);
+    }
+
+    if (filestate == ezFileserveFileState::Different)
+    {
+      ezArrayPtr<const ezUInt8> stream = m_SendToClient;
+      bool bCompressed = false;
+
+      // only worth it, if the data actually shrinks, already compressed formats usually don't
+      if (bAllowCompression && m_SendToClient.GetCount() > 256 &&
+          ezCompressionUtils::Compress(m_SendToClient, ezCompressionMethod::ZStd, m_CompressedSendToClient).Succeeded() &&
+          m_CompressedSendToClient.GetCount() < m_SendToClient.GetCount())
+      {
+        stream = m_CompressedSendToClient;
+        bCompressed = true;
+      }
+
+      ezUInt32 uiNextByte = 0;
+      const ezUInt32 uiStreamSize = stream.GetCount();
+
+      // much larger packages than for single files, the messages are streamed back-to-back anyway
+      // send at least one package, even for empty files
+      do
+      {
+        const ezUInt32 uiChunkSize = ezMath::Min<ezUInt32>(64 * 1024, uiStreamSize - uiNextByte);
+
+        ezRemoteMessage ret;
+        ret.GetWriter() << batchGuid;
+        ret.GetWriter() << uiFileIndex;
+        ret.GetWriter() << bCompressed;
+        ret.GetWriter() << uiStreamSize;
+        ret.GetWriter() << uiChunkSize;
+
+        if (uiChunkSize > 0)
+          ret.GetWriter().WriteBytes(&stream[uiNextByte], uiChunkSize).IgnoreResult();
+
+        ret.SetMessageID('FSRV', 'BTDL');
+        m_pNetwork->Send(ezRemoteTransmitMode::Reliable, ret);
+
+        uiNextByte += uiChunkSize;
+
+        // reuse previous values
+        {
+          e.m_Type = ezFileserverEvent::Type::FileDownloading;
+          e.m_uiSentTotal = bCompressed ? (ezUInt32)((ezUInt64)m_SendToClient.GetCount() * uiNextByte / uiStreamSize) : uiNextByte;
+          m_Events.Broadcast(e);
+        }
+      } while (uiNextByte < uiStreamSize);
+    }
+
+    fin.GetWriter() << (ezInt8)filestate;
+    fin.GetWriter() << status.m_iTimestamp;
+    fin.GetWriter() << status.m_uiHash;
+    fin.GetWriter() << uiDataDirID;
+
+    // reuse previous values
+    {
+      e.m_Type = ezFileserverEvent::Type::FileDownloadFinished;
+      m_Events.Broadcast(e);
+    }
+  }
+
+  m_pNetwork->Send(ezRemoteTransmitMode::Reliable, fin);
+}
+
 void ezFileserver::HandleDeleteFileRequest(ezFileserveClientContext& client, ezRemoteMessage& msg)
 {
   ezUInt16 uiDataDirID = 0xffff;
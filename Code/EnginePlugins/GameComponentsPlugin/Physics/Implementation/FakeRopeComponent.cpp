@@ -333,7 +333,7 @@ void ezFakeRopeComponent::SendCurrentPose()
 {
   ezMsgRopePoseUpdated poseMsg;
 
-  ezDynamicArray<ezTransform> pieces(ezFrameAllocator::GetCurrentAllocator());
+  ezDynamicArray<ezTransform> pieces(GetWorld()->GetFrameAllocator());
 
   if (m_RopeSim.m_Nodes.GetCount() >= 2)
   {
@@ -2,6 +2,7 @@
 
 #include <Core/GameApplication/GameApplicationBase.h>
 #include <Foundation/Communication/Telemetry.h>
+#include <Foundation/Utilities/Metrics.h>
 #include <Foundation/Utilities/Stats.h>
 
 static void StatsEventHandler(const ezStats::StatsEventData& e)
@@ -127,6 +128,9 @@ static void PerFrameUpdateHandler(const ezGameApplicationExecutionEvent& e)
           ezStats::SetStat(s.GetData(), uiNumTasks);
         }
       }
+
+      // the values of the last metrics snapshot
+      ezMetrics::ExportToStats();
     }
     break;
 
@@ -762,7 +762,7 @@ void ezJoltRagdollComponent::ComputeLimbGlobalTransform(ezTransform& transform,
 
 void ezJoltRagdollComponent::CreateAllLimbs(const ezSkeletonResource& skeletonResource, const ezMsgAnimationPoseUpdated& pose, ezJoltWorldModule& worldModule, float fObjectScale)
 {
-  ezMap<ezUInt16, LimbConstructionInfo> limbConstructionInfos(ezFrameAllocator::GetCurrentAllocator());
+  ezMap<ezUInt16, LimbConstructionInfo> limbConstructionInfos(GetWorld()->GetFrameAllocator());
   limbConstructionInfos.FindOrAdd(ezInvalidJointIndex); // dummy root link
 
   ezUInt16 uiLastLimbIdx = ezInvalidJointIndex;
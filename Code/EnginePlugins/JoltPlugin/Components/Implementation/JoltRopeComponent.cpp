@@ -749,7 +749,7 @@ void ezJoltRopeComponent::Update()
   //  }
   //}
 
-  ezHybridArray<ezTransform, 32> poses(ezFrameAllocator::GetCurrentAllocator());
+  ezHybridArray<ezTransform, 32> poses(GetWorld()->GetFrameAllocator());
   poses.SetCountUninitialized(static_cast<ezUInt32>(m_pRagdoll->GetBodyCount()) + 1);
 
   ezMsgRopePoseUpdated poseMsg;
@@ -812,7 +812,7 @@ void ezJoltRopeComponent::SendPreviewPose()
   if (hAnchor1 == hAnchor2)
     return;
 
-  ezDynamicArray<ezTransform> pieces(ezFrameAllocator::GetCurrentAllocator());
+  ezDynamicArray<ezTransform> pieces(GetWorld()->GetFrameAllocator());
 
   ezMsgRopePoseUpdated poseMsg;
   float fPieceLength;
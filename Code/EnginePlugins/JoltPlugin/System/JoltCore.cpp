@@ -12,6 +12,7 @@
 #include <JoltPlugin/Shapes/Implementation/JoltCustomShapeInfo.h>
 #include <JoltPlugin/System/JoltCore.h>
 #include <JoltPlugin/System/JoltDebugRenderer.h>
+#include <JoltPlugin/System/JoltJobSystem.h>
 #include <RendererCore/Debug/DebugRenderer.h>
 #include <stdarg.h>
 
@@ -34,8 +35,12 @@ EZ_BEGIN_STATIC_REFLECTED_BITFLAGS(ezOnJoltContact, 1)
 EZ_END_STATIC_REFLECTED_BITFLAGS;
 // clang-format on
 
+ezCVarBool cvar_JoltUseTaskSystem("Jolt.UseTaskSystem", true, ezCVarFlags::Default, "Execute Jolt jobs on the ezTaskSystem worker threads instead of a separate thread pool.");
+
 ezJoltMaterial* ezJoltCore::s_pDefaultMaterial = nullptr;
 std::unique_ptr<JPH::JobSystem> ezJoltCore::s_pJobSystem;
+std::unique_ptr<JPH::JobSystem> ezJoltCore::s_pThreadPoolJobSystem;
+ezMutex ezJoltCore::s_ThreadPoolJobSystemMutex;
 ezUniquePtr<ezProxyAllocator> ezJoltCore::s_pAllocator;
 ezUniquePtr<ezProxyAllocator> ezJoltCore::s_pAllocatorAligned;
 
@@ -63,6 +68,22 @@ static bool JoltAssertFailed(const char* szInExpression, const char* szInMessage
 
 #endif // JPH_ENABLE_ASSERTS
 
+JPH::JobSystem* ezJoltCore::GetJoltJobSystem()
+{
+  if (cvar_JoltUseTaskSystem)
+    return s_pJobSystem.get();
+
+  // several worlds may simulate concurrently
+  EZ_LOCK(s_ThreadPoolJobSystemMutex);
+
+  if (s_pThreadPoolJobSystem == nullptr)
+  {
+    s_pThreadPoolJobSystem = std::make_unique<JPH::JobSystemThreadPool>(JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers, std::thread::hardware_concurrency() - 1);
+  }
+
+  return s_pThreadPoolJobSystem.get();
+}
+
 void ezJoltCore::DebugDraw(ezWorld* pWorld)
 {
 #ifdef JPH_DEBUG_RENDERER
@@ -128,8 +149,7 @@ void ezJoltCore::Startup()
 
   ezJoltCustomShapeInfo::sRegister();
 
-  // TODO: custom job system
-  s_pJobSystem = std::make_unique<JPH::JobSystemThreadPool>(JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers, std::thread::hardware_concurrency() - 1);
+  s_pJobSystem = std::make_unique<ezJoltJobSystem>(JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers);
 
   s_pDefaultMaterial = new ezJoltMaterial;
   s_pDefaultMaterial->AddRef();
@@ -154,6 +174,7 @@ void ezJoltCore::Shutdown()
   s_pDefaultMaterial = nullptr;
 
   s_pJobSystem = nullptr;
+  s_pThreadPoolJobSystem = nullptr;
 
   delete JPH::Factory::sInstance;
   JPH::Factory::sInstance = nullptr;
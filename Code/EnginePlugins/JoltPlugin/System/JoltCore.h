@@ -2,6 +2,7 @@
 
 #include <Foundation/Containers/HashTable.h>
 #include <Foundation/Memory/CommonAllocators.h>
+#include <Foundation/Threading/Mutex.h>
 #include <Foundation/Types/UniquePtr.h>
 #include <JoltPlugin/JoltPluginDLL.h>
 
@@ -18,7 +19,11 @@ namespace JPH
 class EZ_JOLTPLUGIN_DLL ezJoltCore
 {
 public:
-  static JPH::JobSystem* GetJoltJobSystem() { return s_pJobSystem.get(); }
+  /// \brief Returns the job system that executes the physics jobs, depending on the 'Jolt.UseTaskSystem' cvar.
+  ///
+  /// The cvar is checked every time, so it can be toggled at runtime to compare both job systems. The separate thread pool is only
+  /// created the first time it is needed.
+  static JPH::JobSystem* GetJoltJobSystem();
   static const ezJoltMaterial* GetDefaultMaterial() { return s_pDefaultMaterial; }
 
   static void DebugDraw(ezWorld* pWorld);
@@ -43,6 +48,8 @@ private:
 
   static ezJoltMaterial* s_pDefaultMaterial;
   static std::unique_ptr<JPH::JobSystem> s_pJobSystem;
+  static std::unique_ptr<JPH::JobSystem> s_pThreadPoolJobSystem;
+  static ezMutex s_ThreadPoolJobSystemMutex;
 
   static ezUniquePtr<ezProxyAllocator> s_pAllocator;
   static ezUniquePtr<ezProxyAllocator> s_pAllocatorAligned;
@@ -0,0 +1,140 @@
+#include <JoltPlugin/JoltPluginPCH.h>
+
+#include <JoltPlugin/System/JoltJobSystem.h>
+
+class ezJoltJobSystem::JobTask final : public ezTask
+{
+public:
+  Job* m_pJob = nullptr;
+
+protected:
+  virtual void Execute() override
+  {
+    Job* pJob = m_pJob;
+    m_pJob = nullptr;
+
+    // the job may already have been executed by a thread waiting on a barrier, in that case this does nothing
+    pJob->Execute();
+
+    // release the reference that was added when the job got queued
+    pJob->Release();
+  }
+};
+
+ezJoltJobSystem::ezJoltJobSystem(JPH::uint uiMaxJobs, JPH::uint uiMaxBarriers)
+{
+  JobSystemWithBarrier::Init(uiMaxBarriers);
+
+  m_Jobs.Init(uiMaxJobs, uiMaxJobs);
+}
+
+ezJoltJobSystem::~ezJoltJobSystem()
+{
+  // tasks that are still queued reference jobs from our free list and call back into this object
+  ezTaskSystem::WaitForCondition([this]()
+    { return m_iTasksInFlight == 0; });
+}
+
+int ezJoltJobSystem::GetMaxConcurrency() const
+{
+  // all worker threads for short tasks, plus the thread that waits on the barrier and helps out executing jobs
+  return static_cast<int>(ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks)) + 1;
+}
+
+JPH::JobHandle ezJoltJobSystem::CreateJob(const char* szInName, JPH::ColorArg inColor, const JobFunction& inJobFunction, JPH::uint32 uiInNumDependencies)
+{
+  Job* pJob = nullptr;
+
+  const JPH::uint32 uiIndex = m_Jobs.ConstructObject(szInName, inColor, this, inJobFunction, uiInNumDependencies);
+  if (uiIndex != AvailableJobs::cInvalidObjectIndex)
+  {
+    pJob = &m_Jobs.Get(uiIndex);
+  }
+  else
+  {
+    pJob = new Job(szInName, inColor, this, inJobFunction, uiInNumDependencies);
+
+    EZ_LOCK(m_OverflowJobsMutex);
+    m_OverflowJobs.Insert(pJob);
+
+    if (m_iNumOverflowJobs.Increment() == 1)
+    {
+      ezLog::Dev("The Jolt job pool is exhausted, additional jobs are allocated on the heap.");
+    }
+  }
+
+  // the handle keeps a reference, since the job may be queued and finished right away
+  JobHandle handle(pJob);
+
+  if (uiInNumDependencies == 0)
+  {
+    QueueJob(pJob);
+  }
+
+  return handle;
+}
+
+void ezJoltJobSystem::QueueJob(Job* pInJob)
+{
+  // the task owns a reference to the job until it has been executed
+  pInJob->AddRef();
+
+  ezSharedPtr<ezTask> pTask;
+
+  {
+    EZ_LOCK(m_TaskPoolMutex);
+
+    if (!m_FreeTasks.IsEmpty())
+    {
+      pTask = m_FreeTasks.PeekBack();
+      m_FreeTasks.PopBack();
+    }
+  }
+
+  if (pTask == nullptr)
+  {
+    pTask = EZ_DEFAULT_NEW(JobTask);
+    pTask->ConfigureTask("Jolt Job", ezTaskNesting::Never, ezMakeDelegate(&ezJoltJobSystem::OnTaskFinished, this));
+  }
+
+  static_cast<JobTask*>(pTask.Borrow())->m_pJob = pInJob;
+
+  m_iTasksInFlight.Increment();
+  ezTaskSystem::StartSingleTask(pTask, m_JobPriority);
+}
+
+void ezJoltJobSystem::QueueJobs(Job** pInJobs, JPH::uint uiInNumJobs)
+{
+  for (JPH::uint i = 0; i < uiInNumJobs; ++i)
+  {
+    QueueJob(pInJobs[i]);
+  }
+}
+
+void ezJoltJobSystem::FreeJob(Job* pInJob)
+{
+  // the counter is incremented before an overflow job is handed out, so pooled jobs skip the lookup most of the time
+  if (m_iNumOverflowJobs > 0)
+  {
+    EZ_LOCK(m_OverflowJobsMutex);
+
+    if (m_OverflowJobs.Remove(pInJob))
+    {
+      m_iNumOverflowJobs.Decrement();
+      delete pInJob;
+      return;
+    }
+  }
+
+  m_Jobs.DestructObject(pInJob);
+}
+
+void ezJoltJobSystem::OnTaskFinished(const ezSharedPtr<ezTask>& pTask)
+{
+  {
+    EZ_LOCK(m_TaskPoolMutex);
+    m_FreeTasks.PushBack(pTask);
+  }
+
+  m_iTasksInFlight.Decrement();
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <Foundation/Containers/HashSet.h>
+#include <Foundation/Threading/AtomicInteger.h>
+#include <Foundation/Threading/Mutex.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Jolt/Core/FixedSizeFreeList.h>
+#include <Jolt/Core/JobSystemWithBarrier.h>
+
+/// \brief Implementation of Jolt's job system that executes all Jolt jobs as tasks on the ezTaskSystem worker threads.
+///
+/// Jolt's own JobSystemThreadPool spawns a dedicated thread per core, which then competes with the ezTaskSystem workers
+/// for the same cores. This implementation instead wraps every job into a (pooled) ezTask, so that physics jobs are scheduled
+/// together with all other engine work and respect the configured ezTaskPriority.
+///
+/// Jobs come from a fixed size pool. When that is exhausted, additional jobs are allocated on the heap, instead of waiting for jobs
+/// to finish, which could dead-lock when the waiting thread is the one that would have to execute them.
+class ezJoltJobSystem final : public JPH::JobSystemWithBarrier
+{
+public:
+  JPH_OVERRIDE_NEW_DELETE
+
+  ezJoltJobSystem(JPH::uint uiMaxJobs, JPH::uint uiMaxBarriers);
+  ~ezJoltJobSystem();
+
+  /// \brief Sets the priority with which Jolt jobs are scheduled. Defaults to ezTaskPriority::EarlyThisFrame.
+  void SetJobPriority(ezTaskPriority::Enum priority) { m_JobPriority = priority; }
+  ezTaskPriority::Enum GetJobPriority() const { return m_JobPriority; }
+
+  // See JPH::JobSystem
+  virtual int GetMaxConcurrency() const override;
+  virtual JobHandle CreateJob(const char* szInName, JPH::ColorArg inColor, const JobFunction& inJobFunction, JPH::uint32 uiInNumDependencies = 0) override;
+
+protected:
+  // See JPH::JobSystem
+  virtual void QueueJob(Job* pInJob) override;
+  virtual void QueueJobs(Job** pInJobs, JPH::uint uiInNumJobs) override;
+  virtual void FreeJob(Job* pInJob) override;
+
+private:
+  class JobTask;
+
+  void OnTaskFinished(const ezSharedPtr<ezTask>& pTask);
+
+  using AvailableJobs = JPH::FixedSizeFreeList<Job>;
+  AvailableJobs m_Jobs;
+
+  ezMutex m_OverflowJobsMutex;
+  ezHashSet<Job*> m_OverflowJobs;
+  ezAtomicInteger32 m_iNumOverflowJobs;
+
+  ezTaskPriority::Enum m_JobPriority = ezTaskPriority::EarlyThisFrame;
+
+  ezMutex m_TaskPoolMutex;
+  ezDynamicArray<ezSharedPtr<ezTask>> m_FreeTasks;
+  ezAtomicInteger32 m_iTasksInFlight;
+};
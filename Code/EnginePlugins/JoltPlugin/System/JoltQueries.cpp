@@ -130,7 +130,7 @@ bool ezJoltWorldModule::RaycastAll(ezPhysicsCastResultArray& out_results, const
   ray.mDirection = ezJoltConversionUtils::ToVec3(vDir * fDistance);
 
   ezRayCastCollectorAll collector;
-  collector.m_Results = EZ_NEW_ARRAY(ezFrameAllocator::GetCurrentAllocator(), JPH::RayCastResult, 256);
+  collector.m_Results = EZ_NEW_ARRAY(GetWorld()->GetFrameAllocator(), JPH::RayCastResult, 256);
 
   ezJoltBroadPhaseLayerFilter broadphaseFilter(params.m_ShapeTypes);
   ezJoltBodyFilter bodyFilter(params.m_uiIgnoreObjectFilterID);
@@ -755,6 +755,8 @@ void ezJoltWorldModule::Simulate()
 
   m_RagdollsPutToSleep.Clear();
 
+  JPH::JobSystem* pJobSystem = ezJoltCore::GetJoltJobSystem();
+
   for (ezUInt32 i = 1; i < m_UpdateSteps.GetCount(); ++i)
   {
     EZ_PROFILE_SCOPE("Physics Sim Step");
@@ -768,14 +770,14 @@ void ezJoltWorldModule::Simulate()
       // do a single Update call with multiple sub-steps, if possible
       // this saves a bit of time compared to just doing multiple Update calls
 
-      m_pSystem->Update((uiSteps * tDelta).AsFloatInSeconds(), uiSteps, m_pTempAllocator.get(), ezJoltCore::GetJoltJobSystem());
+      m_pSystem->Update((uiSteps * tDelta).AsFloatInSeconds(), uiSteps, m_pTempAllocator.get(), pJobSystem);
 
       tDelta = m_UpdateSteps[i];
       uiSteps = 1;
     }
   }
 
-  m_pSystem->Update((uiSteps * tDelta).AsFloatInSeconds(), uiSteps, m_pTempAllocator.get(), ezJoltCore::GetJoltJobSystem());
+  m_pSystem->Update((uiSteps * tDelta).AsFloatInSeconds(), uiSteps, m_pTempAllocator.get(), pJobSystem);
 }
 
 void ezJoltWorldModule::UpdateSettingsCfg()
@@ -591,7 +591,7 @@ void ezPxRagdollComponent::SetupLimbBodiesAndGeometry(const ezSkeletonResource*
 {
   PxPhysics* pPxApi = ezPhysX::GetSingleton()->GetPhysXAPI();
 
-  ezMap<ezUInt16, LimbConfig> limbStructure(ezFrameAllocator::GetCurrentAllocator());
+  ezMap<ezUInt16, LimbConfig> limbStructure(GetWorld()->GetFrameAllocator());
   limbStructure.FindOrAdd(ezInvalidJointIndex); // dummy root link
 
   const auto& skeleton = pSkeleton->GetDescriptor().m_Skeleton;
@@ -551,7 +551,7 @@ void ezPxRopeComponent::Update()
   if (m_pArticulation->isSleeping())
     return;
 
-  ezHybridArray<ezTransform, 32> poses(ezFrameAllocator::GetCurrentAllocator());
+  ezHybridArray<ezTransform, 32> poses(GetWorld()->GetFrameAllocator());
   poses.SetCountUninitialized(m_ArticulationLinks.GetCount() + 1);
 
   ezMsgRopePoseUpdated poseMsg;
@@ -590,7 +590,7 @@ void ezPxRopeComponent::SendPreviewPose()
   if (!IsActiveAndInitialized() || IsActiveAndSimulating())
     return;
 
-  ezDynamicArray<ezTransform> pieces(ezFrameAllocator::GetCurrentAllocator());
+  ezDynamicArray<ezTransform> pieces(GetWorld()->GetFrameAllocator());
 
   ezMsgRopePoseUpdated poseMsg;
   float fPieceLength;
@@ -5,7 +5,6 @@
 #include <Core/Prefabs/PrefabResource.h>
 #include <Core/World/World.h>
 #include <Foundation/Configuration/CVar.h>
-#include <Foundation/Memory/FrameAllocator.h>
 #include <Foundation/Profiling/Profiling.h>
 #include <PhysXPlugin/Components/PxDynamicActorComponent.h>
 #include <PhysXPlugin/Components/PxQueryShapeActorComponent.h>
@@ -470,7 +469,7 @@ bool ezPhysXWorldModule::RaycastAll(ezPhysicsCastResultArray& out_results, const
     filterData.flags |= PxQueryFlag::eDYNAMIC;
   }
 
-  ezArrayPtr<PxRaycastHit> raycastHits = EZ_NEW_ARRAY(ezFrameAllocator::GetCurrentAllocator(), PxRaycastHit, 256);
+  ezArrayPtr<PxRaycastHit> raycastHits = EZ_NEW_ARRAY(GetWorld()->GetFrameAllocator(), PxRaycastHit, 256);
   PxRaycastBuffer allHits(raycastHits.GetPtr(), raycastHits.GetCount());
 
   ezPxQueryFilter queryFilter;
@@ -647,7 +646,7 @@ void ezPhysXWorldModule::QueryShapesInSphere(ezPhysicsOverlapResultArray& out_re
 
   PxTransform transform = ezPxConversionUtils::ToTransform(vPosition, ezQuat::MakeIdentity());
 
-  ezArrayPtr<PxOverlapHit> overlapHits = EZ_NEW_ARRAY(ezFrameAllocator::GetCurrentAllocator(), PxOverlapHit, 256);
+  ezArrayPtr<PxOverlapHit> overlapHits = EZ_NEW_ARRAY(GetWorld()->GetFrameAllocator(), PxOverlapHit, 256);
   PxOverlapBuffer overlapHitsBuffer(overlapHits.GetPtr(), overlapHits.GetCount());
 
   EZ_PX_READ_LOCK(*m_pPxScene);
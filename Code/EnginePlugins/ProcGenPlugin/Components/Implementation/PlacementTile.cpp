@@ -6,6 +6,7 @@
 #include <Foundation/SimdMath/SimdConversion.h>
 #include <ProcGenPlugin/Components/Implementation/PlacementTile.h>
 #include <ProcGenPlugin/Tasks/PlacementData.h>
+#include <ProcGenPlugin/WorldModule/ProcGenCacheWorldModule.h>
 
 using namespace ezProcGenInternal;
 
@@ -109,6 +110,12 @@ void PlacementTile::PreparePlacementData(const ezWorld* pWorld, const ezPhysicsW
   ref_placementData.m_TileBoundingBox = GetBoundingBox();
   ref_placementData.m_GlobalToLocalBoxTransforms = m_Desc.m_GlobalToLocalBoxTransforms;
 
+  if (auto pCache = pWorld->GetModuleReadOnly<ezProcGenCacheWorldModule>())
+  {
+    ref_placementData.m_uiCacheKey = pCache->ComputePlacementKey(*m_pOutput, m_Desc.m_iPosX, m_Desc.m_iPosY);
+    ref_placementData.m_pCache = ref_placementData.m_uiCacheKey != 0 ? pCache : nullptr;
+  }
+
   m_State = State::Scheduled;
 }
 
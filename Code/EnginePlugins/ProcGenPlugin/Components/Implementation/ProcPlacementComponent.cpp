@@ -12,6 +12,7 @@
 #include <ProcGenPlugin/Tasks/PlacementData.h>
 #include <ProcGenPlugin/Tasks/PlacementTask.h>
 #include <ProcGenPlugin/Tasks/PreparePlacementTask.h>
+#include <ProcGenPlugin/WorldModule/ProcGenCacheWorldModule.h>
 #include <RendererCore/Debug/DebugRenderer.h>
 #include <RendererCore/Pipeline/ExtractedRenderData.h>
 #include <RendererCore/Pipeline/View.h>
@@ -59,6 +60,9 @@ void ezProcPlacementComponentManager::Initialize()
   }
 
   ezResourceManager::GetResourceEvents().AddEventHandler(ezMakeDelegate(&ezProcPlacementComponentManager::OnResourceEvent, this));
+
+  // caching is only enabled for worlds that provide a geometry hash, see ezProcGenCacheWorldModule
+  GetWorld()->GetOrCreateModule<ezProcGenCacheWorldModule>();
 }
 
 void ezProcPlacementComponentManager::Deinitialize()
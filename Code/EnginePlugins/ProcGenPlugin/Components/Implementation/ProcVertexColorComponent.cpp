@@ -7,6 +7,7 @@
 #include <ProcGenPlugin/Components/ProcVertexColorComponent.h>
 #include <ProcGenPlugin/Components/ProcVolumeComponent.h>
 #include <ProcGenPlugin/Tasks/VertexColorTask.h>
+#include <ProcGenPlugin/WorldModule/ProcGenCacheWorldModule.h>
 #include <RendererCore/Meshes/CpuMeshResource.h>
 #include <RendererCore/RenderWorld/RenderWorld.h>
 #include <RendererFoundation/CommandEncoder/CommandEncoder.h>
@@ -80,6 +81,9 @@ void ezProcVertexColorComponentManager::Initialize()
 
   // TODO: also do this in ezProcPlacementComponentManager
   ezProcVolumeComponent::GetAreaInvalidatedEvent().AddEventHandler(ezMakeDelegate(&ezProcVertexColorComponentManager::OnAreaInvalidated, this));
+
+  // caching is only enabled for worlds that provide a geometry hash, see ezProcGenCacheWorldModule
+  GetWorld()->GetOrCreateModule<ezProcGenCacheWorldModule>();
 }
 
 void ezProcVertexColorComponentManager::Deinitialize()
@@ -165,6 +169,42 @@ void ezProcVertexColorComponentManager::UpdateComponentVertexColors(ezProcVertex
   if (sMesh.IsEmpty())
     return;
 
+  const ezUInt32 uiNumOutputs = pComponent->m_Outputs.GetCount();
+  const ezTransform& transform = pComponent->GetOwner()->GetGlobalTransform();
+
+  if (m_uiNextTaskIndex >= m_UpdateTasks.GetCount())
+  {
+    m_UpdateTasks.PushBack(EZ_DEFAULT_NEW(ezProcGenInternal::VertexColorTask));
+  }
+
+  auto& pUpdateTask = m_UpdateTasks[m_uiNextTaskIndex];
+
+  // The volumes are needed for the cache key as well, so extract them first
+  pUpdateTask->ExtractVolumes(*GetWorld(), transform, pComponent->m_Outputs);
+
+  const ezProcGenCacheWorldModule* pCache = GetWorld()->GetModuleReadOnly<ezProcGenCacheWorldModule>();
+  ezUInt64 uiCacheKey = 0;
+  if (pCache != nullptr)
+  {
+    uiCacheKey = pCache->ComputeVertexColorKey(pComponent->m_Outputs, outputMappings, sMesh, transform);
+    uiCacheKey = pCache->AddVolumesToKey(uiCacheKey, pUpdateTask->GetVolumeCollections());
+  }
+
+  // Try the cache first, on a hit neither the cpu mesh nor the graph needs to be evaluated and the task is re-used for the next component
+  if (uiCacheKey != 0)
+  {
+    auto allocateFunc = [&](ezUInt32 uiVertexColorCount) -> ezArrayPtr<ezUInt32>
+    {
+      if (uiVertexColorCount == 0 || uiVertexColorCount % uiNumOutputs != 0)
+        return {};
+
+      return AllocateVertexColors(pComponent, uiNumOutputs, uiVertexColorCount);
+    };
+
+    if (pCache->LoadVertexColors(uiCacheKey, allocateFunc).Succeeded())
+      return;
+  }
+
   ezCpuMeshResourceHandle hCpuMesh = ezResourceManager::LoadResource<ezCpuMeshResource>(sMesh);
   ezResourceLock<ezCpuMeshResource> pCpuMesh(hCpuMesh, ezResourceAcquireMode::BlockTillLoaded_NeverFail);
   if (pCpuMesh.GetAcquireResult() != ezResourceAcquireResult::Final)
@@ -174,9 +214,24 @@ void ezProcVertexColorComponentManager::UpdateComponentVertexColors(ezProcVertex
   }
 
   const auto& mbDesc = pCpuMesh->GetDescriptor().MeshBufferDesc();
-  const ezUInt32 uiNumOutputs = pComponent->m_Outputs.GetCount();
   const ezUInt32 uiVertexColorCount = mbDesc.GetVertexCount() * uiNumOutputs;
 
+  ezArrayPtr<ezUInt32> vertexColors = AllocateVertexColors(pComponent, uiNumOutputs, uiVertexColorCount);
+
+  ezStringBuilder taskName = "VertexColor ";
+  taskName.Append(pCpuMesh->GetResourceDescription().GetView());
+  pUpdateTask->ConfigureTask(taskName, ezTaskNesting::Never);
+
+  pUpdateTask->Prepare(mbDesc, transform, pComponent->m_Outputs, outputMappings, vertexColors);
+  pUpdateTask->SetCacheEntry(pCache, uiCacheKey);
+
+  ezTaskSystem::AddTaskToGroup(m_UpdateTaskGroupID, pUpdateTask);
+
+  ++m_uiNextTaskIndex;
+}
+
+ezArrayPtr<ezUInt32> ezProcVertexColorComponentManager::AllocateVertexColors(ezProcVertexColorComponent* pComponent, ezUInt32 uiNumOutputs, ezUInt32 uiVertexColorCount)
+{
   pComponent->m_hVertexColorBuffer = m_hVertexColorBuffer;
 
   if (pComponent->m_uiBufferAccessData == 0)
@@ -188,22 +243,7 @@ void ezProcVertexColorComponentManager::UpdateComponentVertexColors(ezProcVertex
   const ezUInt32 uiBufferOffset = pComponent->m_uiBufferAccessData & BUFFER_ACCESS_OFFSET_MASK;
   m_ModifiedDataRange.SetToIncludeRange(uiBufferOffset, uiBufferOffset + uiVertexColorCount - 1);
 
-  if (m_uiNextTaskIndex >= m_UpdateTasks.GetCount())
-  {
-    m_UpdateTasks.PushBack(EZ_DEFAULT_NEW(ezProcGenInternal::VertexColorTask));
-  }
-
-  auto& pUpdateTask = m_UpdateTasks[m_uiNextTaskIndex];
-
-  ezStringBuilder taskName = "VertexColor ";
-  taskName.Append(pCpuMesh->GetResourceDescription().GetView());
-  pUpdateTask->ConfigureTask(taskName, ezTaskNesting::Never);
-
-  pUpdateTask->Prepare(*GetWorld(), mbDesc, pComponent->GetOwner()->GetGlobalTransform(), pComponent->m_Outputs, outputMappings, m_VertexColorData.GetArrayPtr().GetSubArray(uiBufferOffset, uiVertexColorCount));
-
-  ezTaskSystem::AddTaskToGroup(m_UpdateTaskGroupID, pUpdateTask);
-
-  ++m_uiNextTaskIndex;
+  return m_VertexColorData.GetArrayPtr().GetSubArray(uiBufferOffset, uiVertexColorCount);
 }
 
 void ezProcVertexColorComponentManager::OnExtractionEvent(const ezRenderWorldExtractionEvent& e)
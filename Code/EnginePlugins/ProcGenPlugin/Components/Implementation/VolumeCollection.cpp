@@ -29,6 +29,21 @@ namespace
         return fInitialValue;
     }
   }
+
+  ezUInt64 HashShape(const ezVolumeCollection::Shape& shape, const void* pFadeOutData, ezUInt32 uiFadeOutDataSize, ezUInt64 uiSeed)
+  {
+    const ezUInt32 shapeData[] = {
+      shape.m_Type.GetValue(),
+      shape.m_BlendMode.GetValue(),
+      shape.m_fValue.GetRawData(),
+      shape.m_uiSortingKey,
+    };
+
+    // the three transform rows are stored next to each other
+    ezUInt64 uiHash = ezHashingUtils::xxHash64(&shape.m_GlobalToLocalTransform0, sizeof(ezVec4) * 3, uiSeed);
+    uiHash = ezHashingUtils::xxHash64(shapeData, sizeof(shapeData), uiHash);
+    return ezHashingUtils::xxHash64(pFadeOutData, uiFadeOutDataSize, uiHash);
+  }
 } // namespace
 
 static_assert(sizeof(ezVolumeCollection::Sphere) == 64);
@@ -141,6 +156,31 @@ float ezVolumeCollection::EvaluateAtGlobalPosition(const ezSimdVec4f& vPosition,
   return fValue;
 }
 
+ezUInt64 ezVolumeCollection::ComputeHash() const
+{
+  // The spatial system doesn't return the volumes in a fixed order and volumes with equal sorting keys stay in that order,
+  // so the shape hashes are summed up instead of chained.
+  ezUInt64 uiSum = 0;
+
+  for (const Sphere& sphere : m_Spheres)
+  {
+    uiSum += HashShape(sphere, &sphere.m_fFadeOutScale, sizeof(float) * 2, 0);
+  }
+
+  for (const Box& box : m_Boxes)
+  {
+    uiSum += HashShape(box, &box.m_vFadeOutScale, sizeof(ezVec3) * 2, 1);
+  }
+
+  for (const Image& image : m_Images)
+  {
+    const ezUInt64 uiImageHash = ezHashingUtils::xxHash64String(image.m_Image.GetResourceID());
+    uiSum += HashShape(image, &image.m_vFadeOutScale, sizeof(ezVec3) * 2, uiImageHash);
+  }
+
+  return ezHashingUtils::xxHash64(&uiSum, sizeof(uiSum), m_SortedShapes.GetCount());
+}
+
 // static
 void ezVolumeCollection::ExtractVolumesInBox(const ezWorld& world, const ezBoundingBox& box, ezSpatialData::Category spatialCategory,
   const ezTagSet& includeTags, ezVolumeCollection& out_collection, const ezRTTI* pComponentBaseType)
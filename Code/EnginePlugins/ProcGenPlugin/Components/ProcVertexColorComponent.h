@@ -37,6 +37,7 @@ private:
 
   void UpdateVertexColors(const ezWorldModule::UpdateContext& context);
   void UpdateComponentVertexColors(ezProcVertexColorComponent* pComponent);
+  ezArrayPtr<ezUInt32> AllocateVertexColors(ezProcVertexColorComponent* pComponent, ezUInt32 uiNumOutputs, ezUInt32 uiVertexColorCount);
   void OnExtractionEvent(const ezRenderWorldExtractionEvent& e);
   void OnRenderEvent(const ezRenderWorldRenderEvent& e);
 
@@ -66,6 +66,11 @@ public:
 
   float EvaluateAtGlobalPosition(const ezSimdVec4f& vPosition, float fInitialValue, ezProcVolumeImageMode::Enum imgMode, const ezColor& refColor) const;
 
+  /// \brief Computes a hash over the transforms, values, blend modes and fall-offs of all volumes in this collection.
+  ///
+  /// The hash doesn't depend on the order in which the volumes were extracted.
+  ezUInt64 ComputeHash() const;
+
   static void ExtractVolumesInBox(const ezWorld& world, const ezBoundingBox& box, ezSpatialData::Category spatialCategory, const ezTagSet& includeTags, ezVolumeCollection& out_collection, const ezRTTI* pComponentBaseType = nullptr);
 
   void AddSphere(const ezSimdTransform& transform, float fRadius, ezEnum<ezProcGenBlendMode> blendMode, float fSortOrder, float fValue, float fFadeOutStart);
@@ -170,11 +170,12 @@ namespace ezProcGenInternal
     virtual ~GraphSharedDataBase();
   };
 
-  struct Output : public ezRefCounted
+  struct EZ_PROCGENPLUGIN_DLL Output : public ezRefCounted
   {
     virtual ~Output();
 
     ezHashedString m_sName;
+    ezUInt64 m_uiGraphHash = 0; ///< Asset hash of the graph this output belongs to, zero if the output must not be cached.
 
     ezHybridArray<ezUInt8, 4> m_VolumeTagSetIndices;
     ezSharedPtr<const GraphSharedDataBase> m_pGraphSharedData;
@@ -127,6 +127,7 @@ ezResourceLoadDesc ezProcGenGraphResource::UpdateContent(ezStreamReader* Stream)
 
           ezSharedPtr<PlacementOutput> pOutput = EZ_DEFAULT_NEW(PlacementOutput);
           pOutput->m_pByteCode = std::move(pByteCode);
+          pOutput->m_uiGraphHash = AssetHash.GetFileHash();
 
           chunk >> pOutput->m_sName;
           chunk.ReadArray(pOutput->m_VolumeTagSetIndices).IgnoreResult();
@@ -209,6 +210,7 @@ ezResourceLoadDesc ezProcGenGraphResource::UpdateContent(ezStreamReader* Stream)
 
           ezSharedPtr<VertexColorOutput> pOutput = EZ_DEFAULT_NEW(VertexColorOutput);
           pOutput->m_pByteCode = std::move(pByteCode);
+          pOutput->m_uiGraphHash = AssetHash.GetFileHash();
 
           chunk >> pOutput->m_sName;
           chunk.ReadArray(pOutput->m_VolumeTagSetIndices).IgnoreResult();
@@ -20,5 +20,10 @@ namespace ezProcGenInternal
 
     m_VolumeCollections.Clear();
     m_GlobalData.Clear();
+
+    m_pCache = nullptr;
+    m_uiCacheKey = 0;
+    m_bLoadedFromCache = false;
+    m_CachedTransforms.Clear();
   }
 } // namespace ezProcGenInternal
@@ -9,6 +9,7 @@
 #include <ProcGenPlugin/Tasks/PlacementData.h>
 #include <ProcGenPlugin/Tasks/PlacementTask.h>
 #include <ProcGenPlugin/Tasks/Utils.h>
+#include <ProcGenPlugin/WorldModule/ProcGenCacheWorldModule.h>
 
 using namespace ezProcGenInternal;
 
@@ -36,12 +37,23 @@ void PlacementTask::Clear()
 
 void PlacementTask::Execute()
 {
+  if (m_pData->m_bLoadedFromCache)
+  {
+    m_OutputTransforms.Swap(m_pData->m_CachedTransforms);
+    return;
+  }
+
   FindPlacementPoints();
 
   if (!m_InputPoints.IsEmpty())
   {
     ExecuteVM();
   }
+
+  if (m_pData->m_pCache != nullptr)
+  {
+    m_pData->m_pCache->StorePlacement(m_pData->m_uiCacheKey, m_OutputTransforms);
+  }
 }
 
 void PlacementTask::FindPlacementPoints()
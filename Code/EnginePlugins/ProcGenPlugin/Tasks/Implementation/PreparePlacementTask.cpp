@@ -4,6 +4,7 @@
 #include <ProcGenPlugin/Tasks/PlacementData.h>
 #include <ProcGenPlugin/Tasks/PreparePlacementTask.h>
 #include <ProcGenPlugin/Tasks/Utils.h>
+#include <ProcGenPlugin/WorldModule/ProcGenCacheWorldModule.h>
 
 using namespace ezProcGenInternal;
 
@@ -22,5 +23,17 @@ void PreparePlacementTask::Execute()
   const Output& output = *m_pData->m_pOutput;
 
   ezProcGenInternal::ExtractVolumeCollections(world, box, output, m_pData->m_VolumeCollections, m_pData->m_GlobalData);
+
+  if (m_pData->m_pCache != nullptr)
+  {
+    // The volumes can be moved or changed at runtime, so their state is part of the key
+    m_pData->m_uiCacheKey = m_pData->m_pCache->AddVolumesToKey(m_pData->m_uiCacheKey, m_pData->m_VolumeCollections);
+
+    // Nothing else to prepare if the placement result is already cached
+    m_pData->m_bLoadedFromCache = m_pData->m_pCache->LoadPlacement(m_pData->m_uiCacheKey, m_pData->m_CachedTransforms).Succeeded();
+    if (m_pData->m_bLoadedFromCache)
+      return;
+  }
+
   ezProcGenInternal::SetInstanceSeed(m_pData->m_uiTileSeed, m_pData->m_GlobalData);
 }
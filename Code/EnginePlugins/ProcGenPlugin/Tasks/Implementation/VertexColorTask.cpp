@@ -4,6 +4,7 @@
 #include <ProcGenPlugin/Components/VolumeCollection.h>
 #include <ProcGenPlugin/Tasks/Utils.h>
 #include <ProcGenPlugin/Tasks/VertexColorTask.h>
+#include <ProcGenPlugin/WorldModule/ProcGenCacheWorldModule.h>
 #include <RendererCore/Meshes/MeshBufferResource.h>
 #include <RendererCore/Meshes/MeshBufferUtils.h>
 
@@ -38,7 +39,29 @@ VertexColorTask::VertexColorTask()
 
 VertexColorTask::~VertexColorTask() = default;
 
-void VertexColorTask::Prepare(const ezWorld& world, const ezMeshBufferResourceDescriptor& desc, const ezTransform& transform, ezArrayPtr<ezSharedPtr<const VertexColorOutput>> outputs, ezArrayPtr<ezProcVertexColorMapping> outputMappings, ezArrayPtr<ezUInt32> outputVertexColors)
+void VertexColorTask::ExtractVolumes(const ezWorld& world, const ezTransform& transform, ezArrayPtr<ezSharedPtr<const VertexColorOutput>> outputs)
+{
+  // TODO:
+  // ezBoundingBox box = mbDesc.GetBounds();
+  ezBoundingBox box = ezBoundingBox::MakeFromMinMax(ezVec3(-1000), ezVec3(1000));
+  box.TransformFromOrigin(transform.GetAsMat4());
+
+  m_VolumeCollections.Clear();
+  m_GlobalData.Clear();
+
+  for (auto& pOutput : outputs)
+  {
+    if (pOutput != nullptr)
+    {
+      ezProcGenInternal::ExtractVolumeCollections(world, box, *pOutput, m_VolumeCollections, m_GlobalData);
+    }
+  }
+
+  const ezUInt32 uiTransformHash = ezHashingUtils::xxHash32(&transform, sizeof(ezTransform));
+  ezProcGenInternal::SetInstanceSeed(uiTransformHash, m_GlobalData);
+}
+
+void VertexColorTask::Prepare(const ezMeshBufferResourceDescriptor& desc, const ezTransform& transform, ezArrayPtr<ezSharedPtr<const VertexColorOutput>> outputs, ezArrayPtr<ezProcVertexColorMapping> outputMappings, ezArrayPtr<ezUInt32> outputVertexColors)
 {
   EZ_PROFILE_SCOPE("VertexColorPrepare");
 
@@ -121,27 +144,12 @@ void VertexColorTask::Prepare(const ezWorld& world, const ezMeshBufferResourceDe
   m_Outputs = outputs;
   m_OutputMappings = outputMappings;
   m_OutputVertexColors = outputVertexColors;
+}
 
-  //////////////////////////////////////////////////////////////////////////
-
-  // TODO:
-  // ezBoundingBox box = mbDesc.GetBounds();
-  ezBoundingBox box = ezBoundingBox::MakeFromMinMax(ezVec3(-1000), ezVec3(1000));
-  box.TransformFromOrigin(transform.GetAsMat4());
-
-  m_VolumeCollections.Clear();
-  m_GlobalData.Clear();
-
-  for (auto& pOutput : outputs)
-  {
-    if (pOutput != nullptr)
-    {
-      ezProcGenInternal::ExtractVolumeCollections(world, box, *pOutput, m_VolumeCollections, m_GlobalData);
-    }
-  }
-
-  const ezUInt32 uiTransformHash = ezHashingUtils::xxHash32(&transform, sizeof(ezTransform));
-  ezProcGenInternal::SetInstanceSeed(uiTransformHash, m_GlobalData);
+void VertexColorTask::SetCacheEntry(const ezProcGenCacheWorldModule* pCache, ezUInt64 uiCacheKey)
+{
+  m_pCache = uiCacheKey != 0 ? pCache : nullptr;
+  m_uiCacheKey = uiCacheKey;
 }
 
 void VertexColorTask::Execute()
@@ -209,4 +217,9 @@ void VertexColorTask::Execute()
       m_OutputVertexColors[i * uiNumOutputs + uiOutputIndex] = *reinterpret_cast<ezUInt32*>(&vertexColor.r);
     }
   }
+
+  if (m_pCache != nullptr)
+  {
+    m_pCache->StoreVertexColors(m_uiCacheKey, m_OutputVertexColors);
+  }
 }
@@ -4,6 +4,7 @@
 #include <ProcGenPlugin/Declarations.h>
 
 class ezPhysicsWorldModuleInterface;
+class ezProcGenCacheWorldModule;
 class ezVolumeCollection;
 
 namespace ezProcGenInternal
@@ -26,5 +27,10 @@ namespace ezProcGenInternal
 
     ezDeque<ezVolumeCollection> m_VolumeCollections;
     ezExpression::GlobalData m_GlobalData;
+
+    const ezProcGenCacheWorldModule* m_pCache = nullptr;
+    ezUInt64 m_uiCacheKey = 0;
+    bool m_bLoadedFromCache = false;
+    ezDynamicArray<PlacementTransform, ezAlignedAllocatorWrapper> m_CachedTransforms;
   };
 } // namespace ezProcGenInternal
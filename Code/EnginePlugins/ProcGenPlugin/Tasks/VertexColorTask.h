@@ -5,6 +5,7 @@
 #include <ProcGenPlugin/Declarations.h>
 
 struct ezMeshBufferResourceDescriptor;
+class ezProcGenCacheWorldModule;
 class ezVolumeCollection;
 
 namespace ezProcGenInternal
@@ -15,9 +16,16 @@ namespace ezProcGenInternal
     VertexColorTask();
     ~VertexColorTask();
 
-    void Prepare(const ezWorld& world, const ezMeshBufferResourceDescriptor& desc, const ezTransform& transform,
-      ezArrayPtr<ezSharedPtr<const VertexColorOutput>> outputs, ezArrayPtr<ezProcVertexColorMapping> outputMappings,
-      ezArrayPtr<ezUInt32> outputVertexColors);
+    /// \brief Extracts the volumes that affect the given outputs. Has to be called before Prepare().
+    void ExtractVolumes(const ezWorld& world, const ezTransform& transform, ezArrayPtr<ezSharedPtr<const VertexColorOutput>> outputs);
+
+    const ezDeque<ezVolumeCollection>& GetVolumeCollections() const { return m_VolumeCollections; }
+
+    void Prepare(const ezMeshBufferResourceDescriptor& desc, const ezTransform& transform, ezArrayPtr<ezSharedPtr<const VertexColorOutput>> outputs,
+      ezArrayPtr<ezProcVertexColorMapping> outputMappings, ezArrayPtr<ezUInt32> outputVertexColors);
+
+    /// \brief If set, the computed vertex colors are written to the given cache after execution.
+    void SetCacheEntry(const ezProcGenCacheWorldModule* pCache, ezUInt64 uiCacheKey);
 
   private:
     virtual void Execute() override;
@@ -40,6 +48,9 @@ namespace ezProcGenInternal
     ezDynamicArray<ezColor> m_TempData;
     ezArrayPtr<ezUInt32> m_OutputVertexColors;
 
+    const ezProcGenCacheWorldModule* m_pCache = nullptr;
+    ezUInt64 m_uiCacheKey = 0;
+
     ezDeque<ezVolumeCollection> m_VolumeCollections;
     ezExpression::GlobalData m_GlobalData;
 
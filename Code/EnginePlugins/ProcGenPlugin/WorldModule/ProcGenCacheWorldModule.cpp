@@ -0,0 +1,409 @@
+#include <ProcGenPlugin/ProcGenPluginPCH.h>
+
+#include <Core/World/World.h>
+#include <Foundation/Configuration/CVar.h>
+#include <Foundation/IO/FileSystem/FileReader.h>
+#include <Foundation/IO/FileSystem/FileSystem.h>
+#include <Foundation/IO/MemoryMappedFile.h>
+#include <Foundation/IO/OSFile.h>
+#include <Foundation/SimdMath/SimdConversion.h>
+#include <Foundation/Utilities/AssetFileHeader.h>
+#include <Foundation/Utilities/Stats.h>
+#include <ProcGenPlugin/Components/VolumeCollection.h>
+#include <ProcGenPlugin/WorldModule/ProcGenCacheWorldModule.h>
+
+ezCVarBool cvar_ProcGenCacheEnable("ProcGen.Cache.Enable", true, ezCVarFlags::Default, "Enables the persistent procedural generation cache for worlds that provide a geometry hash");
+ezCVarString cvar_ProcGenCacheDirectory("ProcGen.Cache.Directory", ":appdata/ProcGenCache", ezCVarFlags::Save, "Directory in which procedural generation results are cached");
+
+// clang-format off
+EZ_IMPLEMENT_WORLD_MODULE(ezProcGenCacheWorldModule);
+EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezProcGenCacheWorldModule, 1, ezRTTINoAllocator)
+EZ_END_DYNAMIC_REFLECTED_TYPE;
+// clang-format on
+
+using namespace ezProcGenInternal;
+
+namespace
+{
+  constexpr ezUInt32 s_uiCacheFileMagic = 0x45434750; // 'PGCE'
+  constexpr ezUInt32 s_uiCacheFileVersion = 1;
+
+  constexpr ezStringView s_sPlacementExtension = "ezProcGenTile";
+  constexpr ezStringView s_sVertexColorExtension = "ezProcGenColors";
+
+  struct CacheFileHeader
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt32 m_uiMagic;
+    ezUInt32 m_uiVersion;
+    ezUInt64 m_uiKey;
+    ezUInt32 m_uiElementCount;
+    ezUInt32 m_uiElementSize;
+  };
+
+  static_assert(sizeof(CacheFileHeader) == 24);
+
+  /// Compact on-disk representation of a PlacementTransform (52 instead of 64 bytes)
+  struct CachedPlacementTransform
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezVec3 m_vPosition;
+    ezQuat m_qRotation;
+    ezVec3 m_vScale;
+    ezColorLinear16f m_ObjectColor;
+    ezUInt16 m_uiPointIndex;
+    ezUInt8 m_uiObjectIndex;
+    ezUInt8 m_uiHasValidColor;
+  };
+
+  static_assert(sizeof(CachedPlacementTransform) == 52);
+
+  ezAtomicInteger32 s_iTempFileCounter;
+
+  const CacheFileHeader* ValidateEntry(const void* pData, ezUInt64 uiDataSize, ezUInt64 uiKey, ezUInt32 uiElementSize)
+  {
+    if (uiDataSize < sizeof(CacheFileHeader))
+      return nullptr;
+
+    auto pHeader = static_cast<const CacheFileHeader*>(pData);
+    if (pHeader->m_uiMagic != s_uiCacheFileMagic || pHeader->m_uiVersion != s_uiCacheFileVersion || pHeader->m_uiKey != uiKey || pHeader->m_uiElementSize != uiElementSize)
+      return nullptr;
+
+    if (uiDataSize < sizeof(CacheFileHeader) + ezUInt64(pHeader->m_uiElementCount) * uiElementSize)
+      return nullptr;
+
+    return pHeader;
+  }
+
+  /// Maps the given entry into memory, validates it and passes the element count and data to the given callback.
+  template <typename Callback>
+  ezResult ReadEntry(ezStringView sPath, ezUInt64 uiKey, ezUInt32 uiElementSize, Callback callback)
+  {
+    if (!ezOSFile::ExistsFile(sPath))
+      return EZ_FAILURE;
+
+#if EZ_ENABLED(EZ_SUPPORTS_MEMORY_MAPPED_FILE)
+    ezMemoryMappedFile file;
+    EZ_SUCCEED_OR_RETURN(file.Open(sPath, ezMemoryMappedFile::Mode::ReadOnly));
+
+    const void* pData = file.GetReadPointer();
+    const ezUInt64 uiDataSize = file.GetFileSize();
+#else
+    ezOSFile file;
+    EZ_SUCCEED_OR_RETURN(file.Open(sPath, ezFileOpenMode::Read));
+
+    ezDynamicArray<ezUInt8> content;
+    file.ReadAll(content);
+
+    const void* pData = content.GetData();
+    const ezUInt64 uiDataSize = content.GetCount();
+#endif
+
+    const CacheFileHeader* pHeader = ValidateEntry(pData, uiDataSize, uiKey, uiElementSize);
+    if (pHeader == nullptr)
+      return EZ_FAILURE;
+
+    return callback(pHeader->m_uiElementCount, reinterpret_cast<const ezUInt8*>(pHeader + 1));
+  }
+
+  void WriteEntry(ezStringView sPath, ezUInt64 uiKey, ezUInt32 uiElementSize, ezArrayPtr<const ezUInt8> elements)
+  {
+    CacheFileHeader header;
+    header.m_uiMagic = s_uiCacheFileMagic;
+    header.m_uiVersion = s_uiCacheFileVersion;
+    header.m_uiKey = uiKey;
+    header.m_uiElementCount = elements.GetCount() / uiElementSize;
+    header.m_uiElementSize = uiElementSize;
+
+    // write to a temp file first and then move it into place, so that readers never see partially written entries
+    ezStringBuilder sTempPath = sPath;
+    sTempPath.AppendFormat(".{}.tmp", s_iTempFileCounter.Increment());
+
+    {
+      ezOSFile file;
+      if (file.Open(sTempPath, ezFileOpenMode::Write).Failed())
+        return;
+
+      if (file.Write(&header, sizeof(header)).Failed() || file.Write(elements.GetPtr(), elements.GetCount()).Failed())
+      {
+        file.Close();
+        ezOSFile::DeleteFile(sTempPath).IgnoreResult();
+        return;
+      }
+    }
+
+    if (ezOSFile::MoveFileOrDirectory(sTempPath, sPath).Failed())
+    {
+      ezOSFile::DeleteFile(sTempPath).IgnoreResult();
+    }
+  }
+} // namespace
+
+ezProcGenCacheWorldModule::ezProcGenCacheWorldModule(ezWorld* pWorld)
+  : ezWorldModule(pWorld)
+{
+}
+
+ezProcGenCacheWorldModule::~ezProcGenCacheWorldModule() = default;
+
+void ezProcGenCacheWorldModule::Initialize()
+{
+  SUPER::Initialize();
+
+  // Worlds loaded through ezSceneLoadUtility are named after the scene file. Its asset hash changes whenever the scene
+  // or anything it depends on is transformed again, so it identifies the static geometry.
+  const ezStringView sWorldName = GetWorld()->GetName();
+  if (m_uiWorldGeometryHash == 0 && sWorldName.HasExtension("ezBinScene"))
+  {
+    ezFileReader file;
+    ezAssetFileHeader header;
+    if (file.Open(sWorldName).Succeeded() && header.Read(file).Succeeded() && header.GetFileHash() != 0xFFFFFFFFFFFFFFFF)
+    {
+      SetWorldGeometryHash(header.GetFileHash());
+    }
+  }
+
+  {
+    auto desc = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(ezProcGenCacheWorldModule::PublishStats, this);
+    desc.m_Phase = ezWorldModule::UpdateFunctionDesc::Phase::PostAsync;
+
+    RegisterUpdateFunction(desc);
+  }
+}
+
+void ezProcGenCacheWorldModule::Deinitialize()
+{
+  if (m_bStatsPublished)
+  {
+    ezStringBuilder sStatName;
+    for (ezStringView sCounter : {"Hits", "Misses", "Stores"})
+    {
+      GetStatName(sCounter, sStatName);
+      ezStats::RemoveStat(sStatName);
+    }
+  }
+
+  SUPER::Deinitialize();
+}
+
+void ezProcGenCacheWorldModule::SetWorldGeometryHash(ezUInt64 uiHash)
+{
+  m_uiWorldGeometryHash = uiHash;
+}
+
+bool ezProcGenCacheWorldModule::IsEnabled() const
+{
+  return cvar_ProcGenCacheEnable && m_uiWorldGeometryHash != 0;
+}
+
+ezUInt64 ezProcGenCacheWorldModule::ComputePlacementKey(const PlacementOutput& output, ezInt32 iTileX, ezInt32 iTileY) const
+{
+  if (!IsEnabled() || output.m_uiGraphHash == 0)
+    return 0;
+
+  const ezUInt64 hashData[] = {
+    output.m_uiGraphHash,
+    output.m_sName.GetHash(),
+    m_uiWorldGeometryHash,
+    (static_cast<ezUInt64>(static_cast<ezUInt32>(iTileX)) << 32) | static_cast<ezUInt32>(iTileY),
+  };
+
+  return ezHashingUtils::xxHash64(hashData, sizeof(hashData), s_uiCacheFileVersion);
+}
+
+ezUInt64 ezProcGenCacheWorldModule::ComputeVertexColorKey(ezArrayPtr<const ezSharedPtr<const VertexColorOutput>> outputs,
+  ezArrayPtr<const ezProcVertexColorMapping> outputMappings, ezStringView sMesh, const ezTransform& transform) const
+{
+  if (!IsEnabled())
+    return 0;
+
+  ezUInt64 uiKey = ezHashingUtils::xxHash64(&m_uiWorldGeometryHash, sizeof(ezUInt64), s_uiCacheFileVersion);
+  uiKey = ezHashingUtils::xxHash64String(sMesh, uiKey);
+  uiKey = ezHashingUtils::xxHash64(&transform, sizeof(ezTransform), uiKey);
+
+  for (ezUInt32 i = 0; i < outputs.GetCount(); ++i)
+  {
+    const ezUInt64 uiGraphHash = outputs[i] != nullptr ? outputs[i]->m_uiGraphHash : 0;
+    const ezUInt64 uiNameHash = outputs[i] != nullptr ? outputs[i]->m_sName.GetHash() : 0;
+    if (outputs[i] != nullptr && uiGraphHash == 0)
+      return 0;
+
+    const ezUInt8 mapping[] = {outputMappings[i].m_R, outputMappings[i].m_G, outputMappings[i].m_B, outputMappings[i].m_A};
+
+    uiKey = ezHashingUtils::xxHash64(&uiGraphHash, sizeof(ezUInt64), uiKey);
+    uiKey = ezHashingUtils::xxHash64(&uiNameHash, sizeof(ezUInt64), uiKey);
+    uiKey = ezHashingUtils::xxHash64(mapping, sizeof(mapping), uiKey);
+  }
+
+  return uiKey;
+}
+
+ezUInt64 ezProcGenCacheWorldModule::AddVolumesToKey(ezUInt64 uiKey, const ezDeque<ezVolumeCollection>& volumeCollections) const
+{
+  if (uiKey == 0)
+    return 0;
+
+  for (const ezVolumeCollection& volumeCollection : volumeCollections)
+  {
+    const ezUInt64 uiVolumesHash = volumeCollection.ComputeHash();
+    uiKey = ezHashingUtils::xxHash64(&uiVolumesHash, sizeof(ezUInt64), uiKey);
+  }
+
+  // zero means 'not cacheable'
+  return uiKey != 0 ? uiKey : 1;
+}
+
+bool ezProcGenCacheWorldModule::HasPlacement(ezUInt64 uiKey) const
+{
+  ezStringBuilder sPath;
+  GetEntryPath(uiKey, s_sPlacementExtension, sPath);
+
+  return !sPath.IsEmpty() && ezOSFile::ExistsFile(sPath);
+}
+
+ezResult ezProcGenCacheWorldModule::LoadPlacement(ezUInt64 uiKey, ezDynamicArray<PlacementTransform, ezAlignedAllocatorWrapper>& out_transforms) const
+{
+  ezStringBuilder sPath;
+  GetEntryPath(uiKey, s_sPlacementExtension, sPath);
+
+  ezResult res = ReadEntry(sPath, uiKey, sizeof(CachedPlacementTransform), [&](ezUInt32 uiCount, const ezUInt8* pElements)
+    {
+    auto cachedTransforms = ezMakeArrayPtr(reinterpret_cast<const CachedPlacementTransform*>(pElements), uiCount);
+
+    out_transforms.SetCountUninitialized(uiCount);
+    for (ezUInt32 i = 0; i < uiCount; ++i)
+    {
+      const auto& src = cachedTransforms[i];
+      auto& dst = out_transforms[i];
+
+      dst.m_Transform = ezSimdConversion::ToTransform(ezTransform(src.m_vPosition, src.m_qRotation, src.m_vScale));
+      dst.m_ObjectColor = src.m_ObjectColor;
+      dst.m_uiPointIndex = src.m_uiPointIndex;
+      dst.m_uiObjectIndex = src.m_uiObjectIndex;
+      dst.m_bHasValidColor = src.m_uiHasValidColor != 0;
+      dst.m_uiPadding = 0;
+    }
+
+    return EZ_SUCCESS; });
+
+  (res.Succeeded() ? m_iHits : m_iMisses).Increment();
+  return res;
+}
+
+void ezProcGenCacheWorldModule::StorePlacement(ezUInt64 uiKey, ezArrayPtr<const PlacementTransform> transforms) const
+{
+  ezStringBuilder sPath;
+  GetEntryPath(uiKey, s_sPlacementExtension, sPath);
+  if (sPath.IsEmpty())
+    return;
+
+  ezDynamicArray<CachedPlacementTransform> cachedTransforms;
+  cachedTransforms.SetCountUninitialized(transforms.GetCount());
+
+  for (ezUInt32 i = 0; i < transforms.GetCount(); ++i)
+  {
+    const auto& src = transforms[i];
+    auto& dst = cachedTransforms[i];
+
+    const ezTransform t = ezSimdConversion::ToTransform(src.m_Transform);
+    dst.m_vPosition = t.m_vPosition;
+    dst.m_qRotation = t.m_qRotation;
+    dst.m_vScale = t.m_vScale;
+    dst.m_ObjectColor = src.m_ObjectColor;
+    dst.m_uiPointIndex = src.m_uiPointIndex;
+    dst.m_uiObjectIndex = src.m_uiObjectIndex;
+    dst.m_uiHasValidColor = src.m_bHasValidColor ? 1 : 0;
+  }
+
+  WriteEntry(sPath, uiKey, sizeof(CachedPlacementTransform), cachedTransforms.GetByteArrayPtr());
+  m_iStores.Increment();
+}
+
+ezResult ezProcGenCacheWorldModule::LoadVertexColors(ezUInt64 uiKey, AllocateVertexColorsFunc allocateFunc) const
+{
+  ezStringBuilder sPath;
+  GetEntryPath(uiKey, s_sVertexColorExtension, sPath);
+
+  ezResult res = ReadEntry(sPath, uiKey, sizeof(ezUInt32), [&](ezUInt32 uiCount, const ezUInt8* pElements)
+    {
+    ezArrayPtr<ezUInt32> vertexColors = allocateFunc(uiCount);
+    if (vertexColors.GetCount() != uiCount || uiCount == 0)
+      return EZ_FAILURE;
+
+    vertexColors.CopyFrom(ezMakeArrayPtr(reinterpret_cast<const ezUInt32*>(pElements), uiCount));
+    return EZ_SUCCESS; });
+
+  (res.Succeeded() ? m_iHits : m_iMisses).Increment();
+  return res;
+}
+
+void ezProcGenCacheWorldModule::StoreVertexColors(ezUInt64 uiKey, ezArrayPtr<const ezUInt32> vertexColors) const
+{
+  ezStringBuilder sPath;
+  GetEntryPath(uiKey, s_sVertexColorExtension, sPath);
+  if (sPath.IsEmpty())
+    return;
+
+  WriteEntry(sPath, uiKey, sizeof(ezUInt32), vertexColors.ToByteArray());
+  m_iStores.Increment();
+}
+
+ezProcGenCacheWorldModule::Stats ezProcGenCacheWorldModule::GetStats() const
+{
+  Stats stats;
+  stats.m_uiHits = static_cast<ezUInt32>(m_iHits);
+  stats.m_uiMisses = static_cast<ezUInt32>(m_iMisses);
+  stats.m_uiStores = static_cast<ezUInt32>(m_iStores);
+  return stats;
+}
+
+void ezProcGenCacheWorldModule::PublishStats(const ezWorldModule::UpdateContext& context)
+{
+  const Stats stats = GetStats();
+  if (m_bStatsPublished && stats.m_uiHits == m_PublishedStats.m_uiHits && stats.m_uiMisses == m_PublishedStats.m_uiMisses &&
+      stats.m_uiStores == m_PublishedStats.m_uiStores)
+    return;
+
+  if (!m_bStatsPublished && stats.m_uiHits == 0 && stats.m_uiMisses == 0 && stats.m_uiStores == 0)
+    return;
+
+  ezStringBuilder sStatName;
+
+  GetStatName("Hits", sStatName);
+  ezStats::SetStat(sStatName, stats.m_uiHits);
+
+  GetStatName("Misses", sStatName);
+  ezStats::SetStat(sStatName, stats.m_uiMisses);
+
+  GetStatName("Stores", sStatName);
+  ezStats::SetStat(sStatName, stats.m_uiStores);
+
+  m_PublishedStats = stats;
+  m_bStatsPublished = true;
+}
+
+void ezProcGenCacheWorldModule::GetStatName(ezStringView sCounter, ezStringBuilder& out_sName) const
+{
+  // world names are usually file paths, so use the index to keep the stats of multiple worlds apart
+  out_sName.SetFormat("ProcGen/Cache/World {}/{}", GetWorld()->GetIndex(), sCounter);
+}
+
+void ezProcGenCacheWorldModule::GetEntryPath(ezUInt64 uiKey, ezStringView sExtension, ezStringBuilder& out_sPath) const
+{
+  out_sPath.Clear();
+
+  if (uiKey == 0)
+    return;
+
+  // the entries are accessed through ezOSFile, so absolute directories don't need to be inside a data directory
+  ezStringBuilder sDirectory = cvar_ProcGenCacheDirectory.GetValue();
+  if (!ezPathUtils::IsAbsolutePath(sDirectory) && ezFileSystem::ResolvePath(cvar_ProcGenCacheDirectory.GetValue(), &sDirectory, nullptr).Failed())
+    return;
+
+  sDirectory.MakeCleanPath();
+
+  // spread the entries over 256 sub-folders to keep directory sizes reasonable
+  out_sPath.SetFormat("{}/{}/{}.{}", sDirectory, ezArgU(static_cast<ezUInt32>(uiKey & 0xFF), 2, true, 16), ezArgU(uiKey, 16, true, 16), sExtension);
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <Core/World/WorldModule.h>
+#include <Foundation/Containers/Deque.h>
+#include <Foundation/Threading/AtomicInteger.h>
+#include <Foundation/Types/Delegate.h>
+#include <ProcGenPlugin/Declarations.h>
+
+class ezVolumeCollection;
+
+/// \brief Optional persistent on-disk cache for procedural placement and vertex color results.
+///
+/// Procedural generation is deterministic for a given graph and world, so for static worlds the output of
+/// placement tiles and vertex color graphs can be stored on disk and re-used the next time a tile comes into range
+/// or a mesh is loaded.
+///
+/// The module is created by the placement and vertex color component managers. Worlds that were loaded from a scene file
+/// (see ezSceneLoadUtility) use the asset hash of that file as the world geometry hash, for all other worlds the cache stays disabled
+/// unless a hash that uniquely identifies the static geometry is passed in manually:
+///
+///   pWorld->GetOrCreateModule<ezProcGenCacheWorldModule>()->SetWorldGeometryHash(uiSceneHash);
+///
+/// Cache entries are keyed by the graph asset hash, the output, the tile coordinate (or mesh and transform for vertex colors),
+/// the world geometry hash and the state of the overlapping volumes. Each entry is stored as a small binary file in the directory
+/// configured via the 'ProcGen.Cache.Directory' cvar and is memory mapped when it is read back.
+/// The hit, miss and store counts are published as stats under 'ProcGen/Cache'.
+class EZ_PROCGENPLUGIN_DLL ezProcGenCacheWorldModule : public ezWorldModule
+{
+  EZ_DECLARE_WORLD_MODULE();
+  EZ_ADD_DYNAMIC_REFLECTION(ezProcGenCacheWorldModule, ezWorldModule);
+
+public:
+  ezProcGenCacheWorldModule(ezWorld* pWorld);
+  ~ezProcGenCacheWorldModule();
+
+  /// \brief Sets the hash of the static world geometry. A hash of zero disables the cache.
+  void SetWorldGeometryHash(ezUInt64 uiHash);
+  ezUInt64 GetWorldGeometryHash() const { return m_uiWorldGeometryHash; }
+
+  /// \brief Returns whether the cache is enabled for this world.
+  bool IsEnabled() const;
+
+  /// \brief Computes the cache key for the given placement output and tile. Returns 0 if the output can't be cached.
+  ///
+  /// The key still has to be combined with the overlapping volumes via AddVolumesToKey() before it is used.
+  ezUInt64 ComputePlacementKey(const ezProcGenInternal::PlacementOutput& output, ezInt32 iTileX, ezInt32 iTileY) const;
+
+  /// \brief Computes the cache key for the given vertex color outputs on a mesh. Returns 0 if the outputs can't be cached.
+  ezUInt64 ComputeVertexColorKey(ezArrayPtr<const ezSharedPtr<const ezProcGenInternal::VertexColorOutput>> outputs,
+    ezArrayPtr<const ezProcVertexColorMapping> outputMappings, ezStringView sMesh, const ezTransform& transform) const;
+
+  /// \brief Folds the state of the given volumes into the key, so that moving a volume or changing its value or blend mode
+  /// results in a different entry. Returns 0 if the given key is 0.
+  ezUInt64 AddVolumesToKey(ezUInt64 uiKey, const ezDeque<ezVolumeCollection>& volumeCollections) const;
+
+  /// \brief Returns true if an entry with the given key exists on disk.
+  bool HasPlacement(ezUInt64 uiKey) const;
+  ezResult LoadPlacement(ezUInt64 uiKey, ezDynamicArray<ezProcGenInternal::PlacementTransform, ezAlignedAllocatorWrapper>& out_transforms) const;
+  void StorePlacement(ezUInt64 uiKey, ezArrayPtr<const ezProcGenInternal::PlacementTransform> transforms) const;
+
+  using AllocateVertexColorsFunc = ezDelegate<ezArrayPtr<ezUInt32>(ezUInt32)>;
+
+  /// \brief Maps the entry with the given key and copies its vertex colors to the array returned by the given function.
+  ///
+  /// The function is called with the number of stored vertex colors, so the destination can be sized from the entry itself.
+  /// It may return an empty array to reject the entry, which then counts as a miss.
+  ezResult LoadVertexColors(ezUInt64 uiKey, AllocateVertexColorsFunc allocateFunc) const;
+  void StoreVertexColors(ezUInt64 uiKey, ezArrayPtr<const ezUInt32> vertexColors) const;
+
+  struct Stats
+  {
+    ezUInt32 m_uiHits = 0;
+    ezUInt32 m_uiMisses = 0;
+    ezUInt32 m_uiStores = 0;
+  };
+
+  Stats GetStats() const;
+
+protected:
+  virtual void Initialize() override;
+  virtual void Deinitialize() override;
+
+private:
+  void PublishStats(const ezWorldModule::UpdateContext& context);
+  void GetStatName(ezStringView sCounter, ezStringBuilder& out_sName) const;
+  void GetEntryPath(ezUInt64 uiKey, ezStringView sExtension, ezStringBuilder& out_sPath) const;
+
+  ezUInt64 m_uiWorldGeometryHash = 0;
+
+  mutable ezAtomicInteger32 m_iHits;
+  mutable ezAtomicInteger32 m_iMisses;
+  mutable ezAtomicInteger32 m_iStores;
+
+  Stats m_PublishedStats;
+  bool m_bStatsPublished = false;
+};
@@ -261,6 +261,9 @@ public:
   template <typename T>
   void SetData(DataOffset dataOffset, const T& value);
 
+  const void* GetRawData(DataOffset dataOffset) const;
+  void* GetWritableRawData(DataOffset dataOffset);
+
   ezTypedPointer GetPointerData(DataOffset dataOffset);
 
   template <typename T>
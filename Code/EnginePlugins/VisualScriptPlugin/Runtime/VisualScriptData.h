@@ -113,6 +113,10 @@ public:
   template <typename T>
   void SetData(DataOffset dataOffset, const T& value);
 
+  /// \brief Returns a pointer to the raw storage at the given data offset. Must not be used for pointer data types.
+  const void* GetRawData(DataOffset dataOffset) const;
+  void* GetWritableRawData(DataOffset dataOffset);
+
   ezTypedPointer GetPointerData(DataOffset dataOffset, ezUInt32 uiExecutionCounter) const;
 
   template <typename T>
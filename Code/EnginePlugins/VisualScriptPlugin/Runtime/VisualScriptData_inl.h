@@ -60,6 +60,24 @@ T& ezVisualScriptDataStorage::GetWritableData(DataOffset dataOffset)
   return *reinterpret_cast<T*>(m_Storage.GetByteBlobPtr().GetPtr() + dataOffset.m_uiByteOffset);
 }
 
+EZ_FORCE_INLINE const void* ezVisualScriptDataStorage::GetRawData(DataOffset dataOffset) const
+{
+  EZ_ASSERT_DEBUG(ezVisualScriptDataType::IsPointer(dataOffset.GetType()) == false, "Use GetPointerData instead");
+
+  m_pDesc->CheckOffset(dataOffset, nullptr);
+
+  return m_Storage.GetByteBlobPtr().GetPtr() + dataOffset.m_uiByteOffset;
+}
+
+EZ_FORCE_INLINE void* ezVisualScriptDataStorage::GetWritableRawData(DataOffset dataOffset)
+{
+  EZ_ASSERT_DEBUG(ezVisualScriptDataType::IsPointer(dataOffset.GetType()) == false, "Use SetPointerData instead");
+
+  m_pDesc->CheckOffset(dataOffset, nullptr);
+
+  return m_Storage.GetByteBlobPtr().GetPtr() + dataOffset.m_uiByteOffset;
+}
+
 template <typename T>
 void ezVisualScriptDataStorage::SetData(DataOffset dataOffset, const T& value)
 {
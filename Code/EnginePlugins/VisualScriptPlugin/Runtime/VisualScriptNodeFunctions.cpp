@@ -77,6 +77,32 @@ namespace
     return EZ_SUCCESS;
   }
 
+  static EZ_FORCE_INLINE bool CanUseTypedDataOffset(ezVisualScriptDataDescription::DataOffset dataOffset, const ezRTTI* pType)
+  {
+    const auto dataType = dataOffset.GetType();
+    return ezVisualScriptDataType::IsPointer(dataType) == false && ezVisualScriptDataType::GetRtti(dataType) == pType;
+  }
+
+  /// Fills out_args with pointers directly into the script data storage. Fails if any argument needs a conversion,
+  /// in which case the caller has to fall back to FillFunctionArgs.
+  static EZ_FORCE_INLINE ezResult FillTypedFunctionArgs(ezVisualScriptExecutionContext& inout_context, const ezVisualScriptGraphDescription::Node& node, const ezAbstractFunctionProperty* pFunction, ezUInt32 uiStartSlot, ezDynamicArray<const void*>& out_args)
+  {
+    const ezUInt32 uiArgCount = pFunction->GetArgumentCount();
+    if (uiArgCount != node.m_NumInputDataOffsets - uiStartSlot)
+      return EZ_FAILURE;
+
+    for (ezUInt32 i = 0; i < uiArgCount; ++i)
+    {
+      auto dataOffset = node.GetInputDataOffset(uiStartSlot + i);
+      if (CanUseTypedDataOffset(dataOffset, pFunction->GetArgumentType(i)) == false)
+        return EZ_FAILURE;
+
+      out_args.PushBack(inout_context.GetRawData(dataOffset));
+    }
+
+    return EZ_SUCCESS;
+  }
+
   static EZ_FORCE_INLINE ezScriptWorldModule* GetScriptModule(ezVisualScriptExecutionContext& inout_context)
   {
     ezWorld* pWorld = inout_context.GetInstance().GetWorld();
@@ -116,6 +142,23 @@ namespace
       ++uiSlot;
     }
 
+    // Fast path: pass pointers into the script data storage directly if no argument or return value needs a conversion
+    if (pFunction->SupportsTypedExecute())
+    {
+      auto dataOffsetR = node.GetOutputDataOffset(0);
+      const bool bUseReturnValue = dataOffsetR.IsValid();
+
+      ezHybridArray<const void*, 8> typedArgs;
+      if ((bUseReturnValue == false || CanUseTypedDataOffset(dataOffsetR, pFunction->GetReturnType())) &&
+          FillTypedFunctionArgs(inout_context, node, pFunction, uiSlot, typedArgs).Succeeded())
+      {
+        void* pReturnValue = bUseReturnValue ? inout_context.GetWritableRawData(dataOffsetR) : nullptr;
+        pFunction->ExecuteTyped(pInstance.m_pObject, typedArgs.GetData(), pReturnValue);
+
+        return ExecResult::RunNext(0);
+      }
+    }
+
     ezHybridArray<ezVariant, 8> args;
     if (FillFunctionArgs(inout_context, node, pFunction, uiSlot, args).Failed())
     {
@@ -163,6 +163,17 @@ EZ_FORCE_INLINE void ezVisualScriptExecutionContext::SetData(DataOffset dataOffs
   return m_DataStorage[dataOffset.m_uiSource]->SetData<T>(dataOffset, value);
 }
 
+EZ_FORCE_INLINE const void* ezVisualScriptExecutionContext::GetRawData(DataOffset dataOffset) const
+{
+  return m_DataStorage[dataOffset.m_uiSource]->GetRawData(dataOffset);
+}
+
+EZ_FORCE_INLINE void* ezVisualScriptExecutionContext::GetWritableRawData(DataOffset dataOffset)
+{
+  EZ_ASSERT_DEBUG(dataOffset.IsConstant() == false, "Outputs can't set constant data");
+  return m_DataStorage[dataOffset.m_uiSource]->GetWritableRawData(dataOffset);
+}
+
 EZ_FORCE_INLINE ezTypedPointer ezVisualScriptExecutionContext::GetPointerData(DataOffset dataOffset)
 {
   EZ_ASSERT_DEBUG(dataOffset.IsConstant() == false, "Pointers can't be constant data");
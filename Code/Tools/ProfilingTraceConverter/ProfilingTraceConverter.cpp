@@ -0,0 +1,214 @@
+#include <Foundation/Application/Application.h>
+#include <Foundation/IO/FileSystem/FileSystem.h>
+#include <Foundation/IO/FileSystem/FileWriter.h>
+#include <Foundation/IO/MemoryStream.h>
+#include <Foundation/IO/OSFile.h>
+#include <Foundation/Logging/ConsoleWriter.h>
+#include <Foundation/Logging/Log.h>
+#include <Foundation/Logging/VisualStudioWriter.h>
+#include <Foundation/Profiling/ProfilingTrace.h>
+#include <Foundation/Strings/StringBuilder.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <Foundation/Utilities/CommandLineOptions.h>
+
+/* ProfilingTraceConverter command line options:
+
+<paths>
+    One or multiple .ezProfilingTrace files, as written by ezProfilingSystem::StartStreaming().
+    All files are merged into one capture, so pass all files of one streaming session to get a continuous timeline.
+
+-out <path>
+    Path of the JSON file to write. The file will be overwritten, if it already exists.
+
+    If no -out is specified, the first input file with the extension changed to '.json' is used.
+
+Description:
+    Converts binary profiling traces into the Chrome trace event format,
+    which can be opened with chrome://tracing or https://ui.perfetto.dev.
+
+Examples:
+    ezProfilingTraceConverter.exe "C:/Traces/Game_0.ezProfilingTrace" "C:/Traces/Game_1.ezProfilingTrace"
+      Writes the content of both traces into "C:/Traces/Game_0.json"
+*/
+
+ezCommandLineOptionPath opt_Out("_ProfilingTraceConverter", "-out", "\
+Path of the JSON file to write. The file will be overwritten, if it already exists.\n\
+\n\
+If no -out is specified, the first input file with the extension changed to '.json' is used.\n\
+",
+  "");
+
+ezCommandLineOptionDoc opt_Desc("_ProfilingTraceConverter", "Description:", "", "\
+Converts binary profiling traces (.ezProfilingTrace) into the Chrome trace event format,\n\
+which can be opened with chrome://tracing or https://ui.perfetto.dev.\n\
+All input files are merged into one capture.\n\
+",
+  "");
+
+ezCommandLineOptionDoc opt_Examples("_ProfilingTraceConverter", "Examples:", "", "\
+ezProfilingTraceConverter.exe \"C:/Traces/Game_0.ezProfilingTrace\" \"C:/Traces/Game_1.ezProfilingTrace\"\n\
+  Writes the content of both traces into \"C:/Traces/Game_0.json\"\n\
+",
+  "");
+
+class ezProfilingTraceConverter : public ezApplication
+{
+public:
+  using SUPER = ezApplication;
+
+  ezDynamicArray<ezString> m_sInputs;
+  ezString m_sOutput;
+
+  ezProfilingTraceConverter()
+    : ezApplication("ProfilingTraceConverter")
+  {
+  }
+
+  ezResult ParseArguments()
+  {
+    if (GetArgumentCount() <= 1)
+    {
+      ezLog::Error("No arguments given");
+      return EZ_FAILURE;
+    }
+
+    m_sOutput = opt_Out.GetOptionValue(ezCommandLineOption::LogMode::Always);
+
+    for (ezUInt32 a = 1; a < GetArgumentCount(); ++a)
+    {
+      const ezStringView sArg = GetArgument(a);
+
+      if (sArg.IsEqual_NoCase("-out"))
+        break;
+
+      m_sInputs.PushBack(ezOSFile::MakePathAbsoluteWithCWD(sArg));
+
+      if (!ezOSFile::ExistsFile(m_sInputs.PeekBack()))
+      {
+        ezLog::Error("Input file does not exist: '{}'", m_sInputs.PeekBack());
+        return EZ_FAILURE;
+      }
+    }
+
+    if (m_sInputs.IsEmpty())
+    {
+      ezLog::Error("No input files given");
+      return EZ_FAILURE;
+    }
+
+    if (m_sOutput.IsEmpty())
+    {
+      ezStringBuilder sOutput = m_sInputs[0];
+      sOutput.ChangeFileExtension("json");
+      m_sOutput = sOutput;
+    }
+
+    m_sOutput = ezOSFile::MakePathAbsoluteWithCWD(m_sOutput);
+
+    return EZ_SUCCESS;
+  }
+
+  virtual void AfterCoreSystemsStartup() override
+  {
+    // Add the empty data directory to access files via absolute paths
+    ezFileSystem::AddDataDirectory("", "App", ":", ezDataDirUsage::AllowWrites).IgnoreResult();
+
+    ezGlobalLog::AddLogWriter(ezLogWriter::Console::LogMessageHandler);
+    ezGlobalLog::AddLogWriter(ezLogWriter::VisualStudio::LogMessageHandler);
+  }
+
+  virtual void BeforeCoreSystemsShutdown() override
+  {
+    // prevent further output during shutdown
+    ezGlobalLog::RemoveLogWriter(ezLogWriter::Console::LogMessageHandler);
+    ezGlobalLog::RemoveLogWriter(ezLogWriter::VisualStudio::LogMessageHandler);
+
+    SUPER::BeforeCoreSystemsShutdown();
+  }
+
+  ezResult Convert()
+  {
+    ezDynamicArray<ezProfilingSystem::ProfilingData> traces;
+    traces.SetCount(m_sInputs.GetCount());
+
+    ezDynamicArray<ezUInt8> content;
+
+    for (ezUInt32 i = 0; i < m_sInputs.GetCount(); ++i)
+    {
+      ezLog::Info("Reading '{}'", m_sInputs[i]);
+
+      ezOSFile file;
+      if (file.Open(m_sInputs[i], ezFileOpenMode::Read).Failed())
+      {
+        ezLog::Error("Could not open '{}'", m_sInputs[i]);
+        return EZ_FAILURE;
+      }
+
+      content.Clear();
+      file.ReadAll(content);
+
+      ezRawMemoryStreamReader reader(content);
+      if (ezProfilingTraceReader::Read(reader, traces[i]).Failed())
+      {
+        ezLog::Error("'{}' is not a valid profiling trace", m_sInputs[i]);
+        return EZ_FAILURE;
+      }
+    }
+
+    ezHybridArray<const ezProfilingSystem::ProfilingData*, 16> inputs;
+    for (const auto& trace : traces)
+    {
+      inputs.PushBack(&trace);
+    }
+
+    ezProfilingSystem::ProfilingData merged;
+    ezProfilingSystem::ProfilingData::Merge(merged, inputs);
+
+    ezLog::Info("Writing '{}'", m_sOutput);
+
+    ezFileWriter output;
+    if (output.Open(m_sOutput).Failed() || merged.Write(output).Failed())
+    {
+      ezLog::Error("Could not write '{}'", m_sOutput);
+      return EZ_FAILURE;
+    }
+
+    return EZ_SUCCESS;
+  }
+
+  virtual void Run() override
+  {
+    {
+      ezStringBuilder cmdHelp;
+      if (ezCommandLineOption::LogAvailableOptionsToBuffer(cmdHelp, ezCommandLineOption::LogAvailableModes::IfHelpRequested, "_ProfilingTraceConverter"))
+      {
+        ezLog::Print(cmdHelp);
+        RequestApplicationQuit();
+        return;
+      }
+    }
+
+    ezStopwatch sw;
+
+    if (ParseArguments().Failed())
+    {
+      SetReturnCode(1);
+      RequestApplicationQuit();
+      return;
+    }
+
+    if (Convert().Failed())
+    {
+      ezLog::Error("Converting the profiling traces failed");
+      SetReturnCode(2);
+    }
+    else
+    {
+      ezLog::Success("Finished converting profiling traces in {}", sw.GetRunningTotal());
+    }
+
+    RequestApplicationQuit();
+  }
+};
+
+EZ_APPLICATION_ENTRY_POINT(ezProfilingTraceConverter);
@@ -2,6 +2,8 @@
 #include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/OSFile.h>
 #include <Foundation/Logging/Log.h>
+#include <Foundation/Logging/LogEntry.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <Foundation/Utilities/CommandLineOptions.h>
 #include <RendererCore/ShaderCompiler/ShaderCompiler.h>
 #include <RendererCore/ShaderCompiler/ShaderManager.h>
@@ -119,23 +121,73 @@ ezResult ezShaderCompilerApplication::CompileShader(ezStringView sShaderFile)
   if (ExtractPermutationVarValues(sShaderFile).Failed())
     return EZ_FAILURE;
 
-  ezHybridArray<ezPermutationVar, 16> PermVars;
-
   const ezUInt32 uiMaxPerms = m_PermutationGenerator.GetPermutationCount();
 
   ezLog::Info("Shader has {0} permutations", uiMaxPerms);
 
+  struct PermutationResult
+  {
+    ezResult m_Result = EZ_FAILURE;
+    ezDynamicArray<ezLogEntry> m_Log;
+  };
+
+  ezDynamicArray<PermutationResult> results;
+  results.SetCount(uiMaxPerms);
+
+  const ezTime tStart = ezTime::Now();
+
+  // Every permutation uses its own ezShaderCompiler. Permutations that share the same stage source are only compiled once,
+  // because the stage binary cache lets only one of them compile a stage at a time, the others then find it in the cache.
+  // The log output is collected per permutation, so that it can be printed in order afterwards.
+  ezTaskSystem::ParallelForIndexed(
+    0, uiMaxPerms,
+    [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex)
+    {
+      ezHybridArray<ezPermutationVar, 16> PermVars;
+
+      for (ezUInt32 perm = uiStartIndex; perm < uiEndIndex; ++perm)
+      {
+        PermutationResult& res = results[perm];
+
+        ezLogEntryDelegate logger([&res](ezLogEntry& ref_entry)
+          { res.m_Log.PushBack(std::move(ref_entry)); },
+          ezLog::GetDefaultLogLevel());
+        ezLogSystemScope logScope(&logger);
+
+        m_PermutationGenerator.GetPermutation(perm, PermVars);
+        ezShaderCompiler sc;
+        res.m_Result = sc.CompileShaderPermutationForPlatforms(sShaderFile, PermVars, &logger, m_sPlatforms);
+      }
+    },
+    "CompileShaderPermutations");
+
+  const ezTime tCompile = ezTime::Now() - tStart;
+
+  ezUInt32 uiFailed = 0;
+
   for (ezUInt32 perm = 0; perm < uiMaxPerms; ++perm)
   {
     EZ_LOG_BLOCK("Compiling Permutation");
 
-    m_PermutationGenerator.GetPermutation(perm, PermVars);
-    ezShaderCompiler sc;
-    if (sc.CompileShaderPermutationForPlatforms(sShaderFile, PermVars, ezLog::GetThreadLocalLogSystem(), m_sPlatforms).Failed())
-      return EZ_FAILURE;
+    for (const ezLogEntry& entry : results[perm].m_Log)
+    {
+      if (entry.m_Type.GetValue() >= ezLogMsgType::ErrorMsg)
+      {
+        ezLog::BroadcastLoggingEvent(ezLog::GetThreadLocalLogSystem(), entry.m_Type, entry.m_sMsg);
+      }
+    }
+
+    if (results[perm].m_Result.Failed())
+      ++uiFailed;
+  }
+
+  if (uiFailed > 0)
+  {
+    ezLog::Error("{0} of {1} permutations of '{2}' failed to compile", uiFailed, uiMaxPerms, sShaderFile);
+    return EZ_FAILURE;
   }
 
-  ezLog::Success("Compiled Shader '{0}'", sShaderFile);
+  ezLog::Success("Compiled Shader '{0}' ({1} permutations in {2})", sShaderFile, uiMaxPerms, tCompile);
   return EZ_SUCCESS;
 }
 
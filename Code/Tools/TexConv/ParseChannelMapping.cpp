@@ -26,7 +26,7 @@ static ezStringView ToString(ezTexConvChannelValue::Enum e)
   return "";
 }
 
-ezResult ezTexConv::ParseChannelMappings()
+ezResult ezTexConvJob::ParseChannelMappings()
 {
   if (m_Processor.m_Descriptor.m_OutputType == ezTexConvOutputType::Atlas)
     return EZ_SUCCESS;
@@ -63,9 +63,9 @@ ezResult ezTexConv::ParseChannelMappings()
   return EZ_SUCCESS;
 }
 
-ezResult ezTexConv::ParseChannelSliceMapping(ezInt32 iSlice)
+ezResult ezTexConvJob::ParseChannelSliceMapping(ezInt32 iSlice)
 {
-  const auto pCmd = ezCommandLineUtils::GetGlobalInstance();
+  const auto pCmd = m_pCmd;
   auto& mappings = m_Processor.m_Descriptor.m_ChannelMappings;
   ezStringBuilder tmp, param;
 
@@ -159,7 +159,7 @@ ezResult ezTexConv::ParseChannelSliceMapping(ezInt32 iSlice)
   return EZ_SUCCESS;
 }
 
-ezResult ezTexConv::ParseChannelMappingConfig(ezTexConvChannelMapping& out_mapping, ezStringView sCfg, ezInt32 iChannelIndex, bool bSingleChannel)
+ezResult ezTexConvJob::ParseChannelMappingConfig(ezTexConvChannelMapping& out_mapping, ezStringView sCfg, ezInt32 iChannelIndex, bool bSingleChannel)
 {
   out_mapping.m_iInputImageIndex = -1;
   out_mapping.m_ChannelValue = ezTexConvChannelValue::White;
@@ -115,9 +115,9 @@ ezCommandLineOptionInt opt_CompareThreshold("_TexConv", "-cmpMSE", "The error th
 ezCommandLineOptionBool opt_CompareRelaxed("_TexConv", "-cmpRelaxed", "Use a more lenient comparison method.\nUseful for images with single-pixel wide rasterized lines.", false);
 
 
-ezResult ezTexConv::ParseCommandLine()
+ezResult ezTexConvJob::ParseCommandLine()
 {
-  if (ezCommandLineOption::LogAvailableOptions(ezCommandLineOption::LogAvailableModes::IfHelpRequested, "_TexConv"))
+  if (ezCommandLineOption::LogAvailableOptions(ezCommandLineOption::LogAvailableModes::IfHelpRequested, "_TexConv", m_pCmd))
     return EZ_FAILURE;
 
   EZ_SUCCEED_OR_RETURN(ParseMode());
@@ -149,9 +149,9 @@ ezResult ezTexConv::ParseCommandLine()
   return EZ_SUCCESS;
 }
 
-ezResult ezTexConv::ParseMode()
+ezResult ezTexConvJob::ParseMode()
 {
-  switch (opt_Mode.GetOptionValue(ezCommandLineOption::LogMode::FirstTime))
+  switch (opt_Mode.GetOptionValue(ezCommandLineOption::LogMode::FirstTime, m_pCmd))
   {
     case 0:
       m_Mode = ezTexConvMode::Convert;
@@ -166,24 +166,24 @@ ezResult ezTexConv::ParseMode()
   return EZ_FAILURE;
 }
 
-ezResult ezTexConv::ParseCompareMode()
+ezResult ezTexConvJob::ParseCompareMode()
 {
-  m_sOutputFile = opt_Out.GetOptionValue(ezCommandLineOption::LogMode::Always);
+  m_sOutputFile = opt_Out.GetOptionValue(ezCommandLineOption::LogMode::Always, m_pCmd);
 
   if (m_sOutputFile.IsEmpty())
   {
     ezLog::Warning("Output path is not specified. Use option '-out \"path\"' to set the prefix path for the output files.");
   }
 
-  m_sHtmlTitle = opt_CompareHtmlTitle.GetOptionValue(ezCommandLineOption::LogMode::FirstTime);
+  m_sHtmlTitle = opt_CompareHtmlTitle.GetOptionValue(ezCommandLineOption::LogMode::FirstTime, m_pCmd);
 
   ezStringBuilder tmp, res;
-  const auto pCmd = ezCommandLineUtils::GetGlobalInstance();
+  const auto pCmd = m_pCmd;
 
-  m_Comparer.m_Descriptor.m_sActualFile = opt_CompareActual.GetOptionValue(ezCommandLineOption::LogMode::FirstTime);
-  m_Comparer.m_Descriptor.m_sExpectedFile = opt_CompareExpected.GetOptionValue(ezCommandLineOption::LogMode::FirstTime);
-  m_Comparer.m_Descriptor.m_MeanSquareErrorThreshold = opt_CompareThreshold.GetOptionValue(ezCommandLineOption::LogMode::FirstTime);
-  m_Comparer.m_Descriptor.m_bRelaxedComparison = opt_CompareRelaxed.GetOptionValue(ezCommandLineOption::LogMode::FirstTime);
+  m_Comparer.m_Descriptor.m_sActualFile = opt_CompareActual.GetOptionValue(ezCommandLineOption::LogMode::FirstTime, m_pCmd);
+  m_Comparer.m_Descriptor.m_sExpectedFile = opt_CompareExpected.GetOptionValue(ezCommandLineOption::LogMode::FirstTime, m_pCmd);
+  m_Comparer.m_Descriptor.m_MeanSquareErrorThreshold = opt_CompareThreshold.GetOptionValue(ezCommandLineOption::LogMode::FirstTime, m_pCmd);
+  m_Comparer.m_Descriptor.m_bRelaxedComparison = opt_CompareRelaxed.GetOptionValue(ezCommandLineOption::LogMode::FirstTime, m_pCmd);
 
   if (m_Comparer.m_Descriptor.m_sActualFile.IsEmpty())
   {
@@ -200,7 +200,7 @@ ezResult ezTexConv::ParseCompareMode()
   return EZ_SUCCESS;
 }
 
-ezResult ezTexConv::ParseOutputType()
+ezResult ezTexConvJob::ParseOutputType()
 {
   if (m_sOutputFile.IsEmpty())
   {
@@ -208,7 +208,7 @@ ezResult ezTexConv::ParseOutputType()
     return EZ_SUCCESS;
   }
 
-  ezInt32 value = opt_Type.GetOptionValue(ezCommandLineOption::LogMode::Always);
+  ezInt32 value = opt_Type.GetOptionValue(ezCommandLineOption::LogMode::Always, m_pCmd);
 
   m_Processor.m_Descriptor.m_OutputType = static_cast<ezTexConvOutputType::Enum>(value);
 
@@ -256,13 +256,13 @@ ezResult ezTexConv::ParseOutputType()
   return EZ_SUCCESS;
 }
 
-ezResult ezTexConv::ParseInputFiles()
+ezResult ezTexConvJob::ParseInputFiles()
 {
   if (m_Processor.m_Descriptor.m_OutputType == ezTexConvOutputType::Atlas)
     return EZ_SUCCESS;
 
   ezStringBuilder tmp, res;
-  const auto pCmd = ezCommandLineUtils::GetGlobalInstance();
+  const auto pCmd = m_pCmd;
 
   auto& files = m_Processor.m_Descriptor.m_InputFiles;
 
@@ -342,39 +342,39 @@ ezResult ezTexConv::ParseInputFiles()
   return EZ_SUCCESS;
 }
 
-ezResult ezTexConv::ParseOutputFiles()
+ezResult ezTexConvJob::ParseOutputFiles()
 {
-  m_sOutputFile = opt_Out.GetOptionValue(ezCommandLineOption::LogMode::Always);
+  m_sOutputFile = opt_Out.GetOptionValue(ezCommandLineOption::LogMode::Always, m_pCmd);
 
-  m_sOutputThumbnailFile = opt_ThumbnailOut.GetOptionValue(ezCommandLineOption::LogMode::Always);
+  m_sOutputThumbnailFile = opt_ThumbnailOut.GetOptionValue(ezCommandLineOption::LogMode::Always, m_pCmd);
 
   if (!m_sOutputThumbnailFile.IsEmpty())
   {
-    m_Processor.m_Descriptor.m_uiThumbnailOutputResolution = opt_ThumbnailRes.GetOptionValue(ezCommandLineOption::LogMode::Always);
+    m_Processor.m_Descriptor.m_uiThumbnailOutputResolution = opt_ThumbnailRes.GetOptionValue(ezCommandLineOption::LogMode::Always, m_pCmd);
   }
 
-  m_sOutputLowResFile = opt_LowOut.GetOptionValue(ezCommandLineOption::LogMode::Always);
+  m_sOutputLowResFile = opt_LowOut.GetOptionValue(ezCommandLineOption::LogMode::Always, m_pCmd);
 
   if (!m_sOutputLowResFile.IsEmpty())
   {
-    m_Processor.m_Descriptor.m_uiLowResMipmaps = opt_LowMips.GetOptionValue(ezCommandLineOption::LogMode::Always);
+    m_Processor.m_Descriptor.m_uiLowResMipmaps = opt_LowMips.GetOptionValue(ezCommandLineOption::LogMode::Always, m_pCmd);
   }
 
   return EZ_SUCCESS;
 }
 
-ezResult ezTexConv::ParseUsage()
+ezResult ezTexConvJob::ParseUsage()
 {
   if (m_Processor.m_Descriptor.m_OutputType == ezTexConvOutputType::Atlas)
     return EZ_SUCCESS;
 
-  const ezInt32 value = opt_Usage.GetOptionValue(ezCommandLineOption::LogMode::Always);
+  const ezInt32 value = opt_Usage.GetOptionValue(ezCommandLineOption::LogMode::Always, m_pCmd);
 
   m_Processor.m_Descriptor.m_Usage = static_cast<ezTexConvUsage::Enum>(value);
   return EZ_SUCCESS;
 }
 
-ezResult ezTexConv::ParseMipmapMode()
+ezResult ezTexConvJob::ParseMipmapMode()
 {
   if (!m_bOutputSupportsMipmaps)
   {
@@ -384,29 +384,29 @@ ezResult ezTexConv::ParseMipmapMode()
     return EZ_SUCCESS;
   }
 
-  const ezInt32 value = opt_Mipmaps.GetOptionValue(ezCommandLineOption::LogMode::Always);
+  const ezInt32 value = opt_Mipmaps.GetOptionValue(ezCommandLineOption::LogMode::Always, m_pCmd);
 
   m_Processor.m_Descriptor.m_MipmapMode = static_cast<ezTexConvMipmapMode::Enum>(value);
 
-  m_Processor.m_Descriptor.m_bPreserveMipmapCoverage = opt_MipsPreserveCoverage.GetOptionValue(ezCommandLineOption::LogMode::Always);
+  m_Processor.m_Descriptor.m_bPreserveMipmapCoverage = opt_MipsPreserveCoverage.GetOptionValue(ezCommandLineOption::LogMode::Always, m_pCmd);
 
   if (m_Processor.m_Descriptor.m_bPreserveMipmapCoverage)
   {
-    m_Processor.m_Descriptor.m_fMipmapAlphaThreshold = opt_MipsAlphaThreshold.GetOptionValue(ezCommandLineOption::LogMode::Always);
+    m_Processor.m_Descriptor.m_fMipmapAlphaThreshold = opt_MipsAlphaThreshold.GetOptionValue(ezCommandLineOption::LogMode::Always, m_pCmd);
   }
 
   return EZ_SUCCESS;
 }
 
-ezResult ezTexConv::ParseTargetPlatform()
+ezResult ezTexConvJob::ParseTargetPlatform()
 {
-  ezInt32 value = opt_Platform.GetOptionValue(ezCommandLineOption::LogMode::AlwaysIfSpecified);
+  ezInt32 value = opt_Platform.GetOptionValue(ezCommandLineOption::LogMode::AlwaysIfSpecified, m_pCmd);
 
   m_Processor.m_Descriptor.m_TargetPlatform = static_cast<ezTexConvTargetPlatform::Enum>(value);
   return EZ_SUCCESS;
 }
 
-ezResult ezTexConv::ParseCompressionMode()
+ezResult ezTexConvJob::ParseCompressionMode()
 {
   if (!m_bOutputSupportsCompression)
   {
@@ -416,37 +416,37 @@ ezResult ezTexConv::ParseCompressionMode()
     return EZ_SUCCESS;
   }
 
-  const ezInt32 value = opt_Compression.GetOptionValue(ezCommandLineOption::LogMode::Always);
+  const ezInt32 value = opt_Compression.GetOptionValue(ezCommandLineOption::LogMode::Always, m_pCmd);
 
   m_Processor.m_Descriptor.m_CompressionMode = static_cast<ezTexConvCompressionMode::Enum>(value);
   return EZ_SUCCESS;
 }
 
-ezResult ezTexConv::ParseWrapModes()
+ezResult ezTexConvJob::ParseWrapModes()
 {
   // cubemaps do not require any wrap mode settings
   if (m_Processor.m_Descriptor.m_OutputType == ezTexConvOutputType::Cubemap || m_Processor.m_Descriptor.m_OutputType == ezTexConvOutputType::Atlas || m_Processor.m_Descriptor.m_OutputType == ezTexConvOutputType::None)
     return EZ_SUCCESS;
 
   {
-    ezInt32 value = opt_AddressU.GetOptionValue(ezCommandLineOption::LogMode::Always);
+    ezInt32 value = opt_AddressU.GetOptionValue(ezCommandLineOption::LogMode::Always, m_pCmd);
     m_Processor.m_Descriptor.m_AddressModeU = static_cast<ezImageAddressMode::Enum>(value);
   }
   {
-    ezInt32 value = opt_AddressV.GetOptionValue(ezCommandLineOption::LogMode::Always);
+    ezInt32 value = opt_AddressV.GetOptionValue(ezCommandLineOption::LogMode::Always, m_pCmd);
     m_Processor.m_Descriptor.m_AddressModeV = static_cast<ezImageAddressMode::Enum>(value);
   }
 
   if (m_Processor.m_Descriptor.m_OutputType == ezTexConvOutputType::Volume)
   {
-    ezInt32 value = opt_AddressW.GetOptionValue(ezCommandLineOption::LogMode::AlwaysIfSpecified);
+    ezInt32 value = opt_AddressW.GetOptionValue(ezCommandLineOption::LogMode::AlwaysIfSpecified, m_pCmd);
     m_Processor.m_Descriptor.m_AddressModeW = static_cast<ezImageAddressMode::Enum>(value);
   }
 
   return EZ_SUCCESS;
 }
 
-ezResult ezTexConv::ParseFilterModes()
+ezResult ezTexConvJob::ParseFilterModes()
 {
   if (!m_bOutputSupportsFiltering)
   {
@@ -454,61 +454,61 @@ ezResult ezTexConv::ParseFilterModes()
     return EZ_SUCCESS;
   }
 
-  ezInt32 value = opt_Filter.GetOptionValue(ezCommandLineOption::LogMode::Always);
+  ezInt32 value = opt_Filter.GetOptionValue(ezCommandLineOption::LogMode::Always, m_pCmd);
 
   m_Processor.m_Descriptor.m_FilterMode = static_cast<ezTextureFilterSetting::Enum>(value);
   return EZ_SUCCESS;
 }
 
-ezResult ezTexConv::ParseResolutionModifiers()
+ezResult ezTexConvJob::ParseResolutionModifiers()
 {
   if (m_Processor.m_Descriptor.m_OutputType == ezTexConvOutputType::None)
     return EZ_SUCCESS;
 
-  m_Processor.m_Descriptor.m_uiMinResolution = opt_MinRes.GetOptionValue(ezCommandLineOption::LogMode::Always);
-  m_Processor.m_Descriptor.m_uiMaxResolution = opt_MaxRes.GetOptionValue(ezCommandLineOption::LogMode::Always);
-  m_Processor.m_Descriptor.m_uiDownscaleSteps = opt_Downscale.GetOptionValue(ezCommandLineOption::LogMode::Always);
+  m_Processor.m_Descriptor.m_uiMinResolution = opt_MinRes.GetOptionValue(ezCommandLineOption::LogMode::Always, m_pCmd);
+  m_Processor.m_Descriptor.m_uiMaxResolution = opt_MaxRes.GetOptionValue(ezCommandLineOption::LogMode::Always, m_pCmd);
+  m_Processor.m_Descriptor.m_uiDownscaleSteps = opt_Downscale.GetOptionValue(ezCommandLineOption::LogMode::Always, m_pCmd);
 
   return EZ_SUCCESS;
 }
 
-ezResult ezTexConv::ParseMiscOptions()
+ezResult ezTexConvJob::ParseMiscOptions()
 {
   if (m_Processor.m_Descriptor.m_OutputType == ezTexConvOutputType::Texture2D || m_Processor.m_Descriptor.m_OutputType == ezTexConvOutputType::None)
   {
-    m_Processor.m_Descriptor.m_bFlipHorizontal = opt_FlipHorz.GetOptionValue(ezCommandLineOption::LogMode::Always);
+    m_Processor.m_Descriptor.m_bFlipHorizontal = opt_FlipHorz.GetOptionValue(ezCommandLineOption::LogMode::Always, m_pCmd);
 
-    m_Processor.m_Descriptor.m_bPremultiplyAlpha = opt_Premulalpha.GetOptionValue(ezCommandLineOption::LogMode::Always);
+    m_Processor.m_Descriptor.m_bPremultiplyAlpha = opt_Premulalpha.GetOptionValue(ezCommandLineOption::LogMode::Always, m_pCmd);
 
-    if (opt_Dilate.GetOptionValue(ezCommandLineOption::LogMode::Always))
+    if (opt_Dilate.GetOptionValue(ezCommandLineOption::LogMode::Always, m_pCmd))
     {
-      m_Processor.m_Descriptor.m_uiDilateColor = static_cast<ezUInt8>(opt_DilateStrength.GetOptionValue(ezCommandLineOption::LogMode::Always));
+      m_Processor.m_Descriptor.m_uiDilateColor = static_cast<ezUInt8>(opt_DilateStrength.GetOptionValue(ezCommandLineOption::LogMode::Always, m_pCmd));
     }
   }
 
   if (m_Processor.m_Descriptor.m_Usage == ezTexConvUsage::Hdr)
   {
-    m_Processor.m_Descriptor.m_fHdrExposureBias = opt_HdrExposure.GetOptionValue(ezCommandLineOption::LogMode::Always);
+    m_Processor.m_Descriptor.m_fHdrExposureBias = opt_HdrExposure.GetOptionValue(ezCommandLineOption::LogMode::Always, m_pCmd);
   }
 
-  m_Processor.m_Descriptor.m_fMaxValue = opt_Clamp.GetOptionValue(ezCommandLineOption::LogMode::Always);
+  m_Processor.m_Descriptor.m_fMaxValue = opt_Clamp.GetOptionValue(ezCommandLineOption::LogMode::Always, m_pCmd);
 
   return EZ_SUCCESS;
 }
 
-ezResult ezTexConv::ParseAssetHeader()
+ezResult ezTexConvJob::ParseAssetHeader()
 {
   const ezStringView ext = ezPathUtils::GetFileExtension(m_sOutputFile);
 
   if (!ext.StartsWith_NoCase("ez"))
     return EZ_SUCCESS;
 
-  m_Processor.m_Descriptor.m_uiAssetVersion = (ezUInt16)opt_AssetVersion.GetOptionValue(ezCommandLineOption::LogMode::Always);
+  m_Processor.m_Descriptor.m_uiAssetVersion = (ezUInt16)opt_AssetVersion.GetOptionValue(ezCommandLineOption::LogMode::Always, m_pCmd);
 
   ezUInt32 uiHashLow = 0;
   ezUInt32 uiHashHigh = 0;
-  if (ezConversionUtils::ConvertHexStringToUInt32(opt_AssetHashLow.GetOptionValue(ezCommandLineOption::LogMode::Always), uiHashLow).Failed() ||
-      ezConversionUtils::ConvertHexStringToUInt32(opt_AssetHashHigh.GetOptionValue(ezCommandLineOption::LogMode::Always), uiHashHigh).Failed())
+  if (ezConversionUtils::ConvertHexStringToUInt32(opt_AssetHashLow.GetOptionValue(ezCommandLineOption::LogMode::Always, m_pCmd), uiHashLow).Failed() ||
+      ezConversionUtils::ConvertHexStringToUInt32(opt_AssetHashHigh.GetOptionValue(ezCommandLineOption::LogMode::Always, m_pCmd), uiHashHigh).Failed())
   {
     ezLog::Error("'-assetHashLow 0xHEX32' and '-assetHashHigh 0xHEX32' have not been specified correctly.");
     return EZ_FAILURE;
@@ -525,9 +525,9 @@ ezResult ezTexConv::ParseAssetHeader()
   return EZ_SUCCESS;
 }
 
-ezResult ezTexConv::ParseBumpMapFilter()
+ezResult ezTexConvJob::ParseBumpMapFilter()
 {
-  const ezInt32 value = opt_BumpMapFilter.GetOptionValue(ezCommandLineOption::LogMode::Always);
+  const ezInt32 value = opt_BumpMapFilter.GetOptionValue(ezCommandLineOption::LogMode::Always, m_pCmd);
 
   m_Processor.m_Descriptor.m_BumpMapFilter = static_cast<ezTexConvBumpMapFilter::Enum>(value);
   return EZ_SUCCESS;
@@ -2,9 +2,9 @@
 
 #include <TexConv/TexConv.h>
 
-ezResult ezTexConv::ParseUIntOption(ezStringView sOption, ezInt32 iMinValue, ezInt32 iMaxValue, ezUInt32& ref_uiResult) const
+ezResult ezTexConvJob::ParseUIntOption(ezStringView sOption, ezInt32 iMinValue, ezInt32 iMaxValue, ezUInt32& ref_uiResult) const
 {
-  const auto pCmd = ezCommandLineUtils::GetGlobalInstance();
+  const auto pCmd = m_pCmd;
   const ezUInt32 uiDefault = ref_uiResult;
 
   const ezInt32 val = pCmd->GetIntOption(sOption, ref_uiResult);
@@ -28,9 +28,9 @@ ezResult ezTexConv::ParseUIntOption(ezStringView sOption, ezInt32 iMinValue, ezI
   return EZ_SUCCESS;
 }
 
-ezResult ezTexConv::ParseStringOption(ezStringView sOption, const ezDynamicArray<KeyEnumValuePair>& allowed, ezInt32& ref_iResult) const
+ezResult ezTexConvJob::ParseStringOption(ezStringView sOption, const ezDynamicArray<KeyEnumValuePair>& allowed, ezInt32& ref_iResult) const
 {
-  const auto pCmd = ezCommandLineUtils::GetGlobalInstance();
+  const auto pCmd = m_pCmd;
   const ezStringBuilder sValue = pCmd->GetStringOption(sOption, 0);
 
   if (sValue.IsEmpty())
@@ -59,7 +59,7 @@ ezResult ezTexConv::ParseStringOption(ezStringView sOption, const ezDynamicArray
   return EZ_FAILURE;
 }
 
-void ezTexConv::PrintOptionValues(ezStringView sOption, const ezDynamicArray<KeyEnumValuePair>& allowed) const
+void ezTexConvJob::PrintOptionValues(ezStringView sOption, const ezDynamicArray<KeyEnumValuePair>& allowed) const
 {
   ezLog::Info("Valid values for option '{}' are:", sOption);
 
@@ -69,7 +69,7 @@ void ezTexConv::PrintOptionValues(ezStringView sOption, const ezDynamicArray<Key
   }
 }
 
-void ezTexConv::PrintOptionValuesHelp(ezStringView sOption, const ezDynamicArray<KeyEnumValuePair>& allowed) const
+void ezTexConvJob::PrintOptionValuesHelp(ezStringView sOption, const ezDynamicArray<KeyEnumValuePair>& allowed) const
 {
   ezStringBuilder out(sOption, " ");
 
@@ -84,9 +84,9 @@ void ezTexConv::PrintOptionValuesHelp(ezStringView sOption, const ezDynamicArray
   ezLog::Info(out);
 }
 
-bool ezTexConv::ParseFile(ezStringView sOption, ezString& ref_sResult) const
+bool ezTexConvJob::ParseFile(ezStringView sOption, ezString& ref_sResult) const
 {
-  const auto pCmd = ezCommandLineUtils::GetGlobalInstance();
+  const auto pCmd = m_pCmd;
   ref_sResult = pCmd->GetAbsolutePathOption(sOption);
 
   if (!ref_sResult.IsEmpty())
@@ -4,6 +4,7 @@
 #include <Foundation/Utilities/AssetFileHeader.h>
 #include <TexConv/TexConv.h>
 #include <Texture/Image/Formats/DdsFileFormat.h>
+#include <Texture/Image/Formats/ImageFileFormat.h>
 #include <Texture/Image/Formats/StbImageFileFormats.h>
 #include <Texture/Image/ImageUtils.h>
 #include <Texture/ezTexFormat/ezTexFormat.h>
@@ -37,7 +38,7 @@ void ezTexConv::BeforeCoreSystemsShutdown()
   SUPER::BeforeCoreSystemsShutdown();
 }
 
-ezResult ezTexConv::DetectOutputFormat()
+ezResult ezTexConvJob::DetectOutputFormat()
 {
   if (m_sOutputFile.IsEmpty())
   {
@@ -130,14 +131,14 @@ ezResult ezTexConv::DetectOutputFormat()
   return EZ_FAILURE;
 }
 
-bool ezTexConv::IsTexFormat() const
+bool ezTexConvJob::IsTexFormat() const
 {
   const ezStringView ext = ezPathUtils::GetFileExtension(m_sOutputFile);
 
   return ext.StartsWith_NoCase("ez");
 }
 
-ezResult ezTexConv::WriteTexFile(ezStreamWriter& inout_stream, const ezImage& image)
+ezResult ezTexConvJob::WriteTexFile(ezStreamWriter& inout_stream, const ezImage& image)
 {
   ezAssetFileHeader asset;
   asset.SetFileHashAndVersion(m_Processor.m_Descriptor.m_uiAssetHash, m_Processor.m_Descriptor.m_uiAssetVersion);
@@ -163,7 +164,7 @@ ezResult ezTexConv::WriteTexFile(ezStreamWriter& inout_stream, const ezImage& im
   return EZ_SUCCESS;
 }
 
-ezResult ezTexConv::WriteOutputFile(ezStringView sFile, const ezImage& image)
+ezResult ezTexConvJob::WriteOutputFile(ezStringView sFile, const ezImage& image)
 {
   if (sFile.HasExtension("ezBinImageData"))
   {
@@ -209,133 +210,196 @@ ezResult ezTexConv::WriteOutputFile(ezStringView sFile, const ezImage& image)
   }
 }
 
-void ezTexConv::Run()
+ezTexConvJob::ezTexConvJob(const ezCommandLineUtils* pCmd)
+  : m_pCmd(pCmd)
 {
-  SetReturnCode(-1);
+}
 
-  if (ParseCommandLine().Failed())
-  {
-    RequestApplicationQuit();
-    return;
-  }
+ezUInt64 ezTexConvJob::EstimateMemoryUsage() const
+{
+  // input images are converted to RGBA32F, scaled, get a mip chain and are converted to the output format,
+  // so a job holds roughly three float copies of its inputs at the same time
+  const ezUInt64 uiCopiesInFlight = 3;
 
-  if (m_Mode == ezTexConvMode::Compare)
+  ezUInt64 uiTotal = 0;
+
+  ezImageHeader header;
+  for (const ezString& sFile : m_Processor.m_Descriptor.m_InputFiles)
   {
-    if (m_Comparer.Compare().Failed())
+    if (ezImageFileFormat::ReadImageHeader(sFile, header).Succeeded())
     {
-      RequestApplicationQuit();
-      return;
+      uiTotal += static_cast<ezUInt64>(header.GetWidth()) * header.GetHeight() * header.GetDepth() * header.GetNumFaces() * header.GetNumArrayIndices() * sizeof(ezColor) * uiCopiesInFlight;
     }
+  }
 
-    SetReturnCode(0);
+  return uiTotal;
+}
 
-    if (m_Comparer.m_bExceededMSE)
-    {
-      SetReturnCode(m_Comparer.m_OutputMSE);
+ezInt32 ezTexConvJob::Execute()
+{
+  if (m_Mode == ezTexConvMode::Compare)
+    return ExecuteCompare();
 
-      if (!m_sOutputFile.IsEmpty())
-      {
-        ezStringBuilder tmp;
+  return ExecuteConvert();
+}
+
+ezInt32 ezTexConvJob::ExecuteCompare()
+{
+  if (m_Comparer.Compare().Failed())
+    return -1;
+
+  if (!m_Comparer.m_bExceededMSE)
+    return 0;
+
+  if (!m_sOutputFile.IsEmpty())
+  {
+    ezStringBuilder tmp;
 
-        tmp.Set(m_sOutputFile, "-rgb.png");
-        m_Comparer.m_OutputImageDiffRgb.SaveTo(tmp).IgnoreResult();
+    tmp.Set(m_sOutputFile, "-rgb.png");
+    m_Comparer.m_OutputImageDiffRgb.SaveTo(tmp).IgnoreResult();
 
-        tmp.Set(m_sOutputFile, "-alpha.png");
-        m_Comparer.m_OutputImageDiffAlpha.SaveTo(tmp).IgnoreResult();
+    tmp.Set(m_sOutputFile, "-alpha.png");
+    m_Comparer.m_OutputImageDiffAlpha.SaveTo(tmp).IgnoreResult();
 
-        if (!m_sHtmlTitle.IsEmpty())
-        {
-          tmp.Set(m_sOutputFile, ".htm");
+    if (!m_sHtmlTitle.IsEmpty())
+    {
+      tmp.Set(m_sOutputFile, ".htm");
 
-          ezFileWriter file;
-          if (file.Open(tmp).Succeeded())
-          {
-            ezStringBuilder html;
+      ezFileWriter file;
+      if (file.Open(tmp).Succeeded())
+      {
+        ezStringBuilder html;
 
-            ezImageUtils::CreateImageDiffHtml(html, m_sHtmlTitle, m_Comparer.m_ExtractedExpectedRgb, m_Comparer.m_ExtractedExpectedAlpha, m_Comparer.m_ExtractedActualRgb, m_Comparer.m_ExtractedActualAlpha, m_Comparer.m_OutputImageDiffRgb, m_Comparer.m_OutputImageDiffAlpha, m_Comparer.m_OutputMSE, m_Comparer.m_Descriptor.m_MeanSquareErrorThreshold, m_Comparer.m_uiOutputMinDiffRgb, m_Comparer.m_uiOutputMaxDiffRgb, m_Comparer.m_uiOutputMinDiffAlpha, m_Comparer.m_uiOutputMaxDiffAlpha);
+        ezImageUtils::CreateImageDiffHtml(html, m_sHtmlTitle, m_Comparer.m_ExtractedExpectedRgb, m_Comparer.m_ExtractedExpectedAlpha, m_Comparer.m_ExtractedActualRgb, m_Comparer.m_ExtractedActualAlpha, m_Comparer.m_OutputImageDiffRgb, m_Comparer.m_OutputImageDiffAlpha, m_Comparer.m_OutputMSE, m_Comparer.m_Descriptor.m_MeanSquareErrorThreshold, m_Comparer.m_uiOutputMinDiffRgb, m_Comparer.m_uiOutputMaxDiffRgb, m_Comparer.m_uiOutputMinDiffAlpha, m_Comparer.m_uiOutputMaxDiffAlpha);
 
-            file.WriteBytes(html.GetData(), html.GetElementCount()).AssertSuccess();
-          }
-        }
+        file.WriteBytes(html.GetData(), html.GetElementCount()).AssertSuccess();
       }
     }
   }
-  else
+
+  return m_Comparer.m_OutputMSE;
+}
+
+ezInt32 ezTexConvJob::ExecuteConvert()
+{
+  // all outputs are cached together, so that a hit restores exactly what a conversion would write
+  const ezString cachedOutputs[] = {m_sOutputFile, m_sOutputThumbnailFile, m_sOutputLowResFile};
+
+  // atlases reference more images through their description file, which the cache key does not cover
+  ezUInt64 uiCacheKey = 0;
+  const bool bUseCache = m_pCache != nullptr && !m_sOutputFile.IsEmpty() && m_Processor.m_Descriptor.m_OutputType != ezTexConvOutputType::Atlas && ComputeCacheKey(uiCacheKey).Succeeded();
+
+  if (bUseCache)
   {
-    if (m_Processor.Process().Failed())
+    if (m_pCache->Restore(uiCacheKey, cachedOutputs).Succeeded())
     {
-      RequestApplicationQuit();
-      return;
+      ezLog::Success("Restored '{}' from the cache ({})", m_sOutputFile, ezArgU(uiCacheKey, 16, true, 16, true));
+      return 0;
     }
 
-    if (m_Processor.m_Descriptor.m_OutputType == ezTexConvOutputType::Atlas)
-    {
-      ezDeferredFileWriter file;
-      file.SetOutput(m_sOutputFile);
+    ezLog::Dev("Cache miss for '{}' ({})", m_sOutputFile, ezArgU(uiCacheKey, 16, true, 16, true));
+  }
 
-      ezAssetFileHeader header;
-      header.SetFileHashAndVersion(m_Processor.m_Descriptor.m_uiAssetHash, m_Processor.m_Descriptor.m_uiAssetVersion);
+  if (m_Processor.Process().Failed())
+    return -1;
 
-      header.Write(file).IgnoreResult();
+  if (m_Processor.m_Descriptor.m_OutputType == ezTexConvOutputType::Atlas)
+  {
+    ezDeferredFileWriter file;
+    file.SetOutput(m_sOutputFile);
 
-      m_Processor.m_TextureAtlas.CopyToStream(file).IgnoreResult();
+    ezAssetFileHeader header;
+    header.SetFileHashAndVersion(m_Processor.m_Descriptor.m_uiAssetHash, m_Processor.m_Descriptor.m_uiAssetVersion);
 
-      if (file.Close().Succeeded())
-      {
-        SetReturnCode(0);
-      }
-      else
-      {
-        ezLog::Error("Failed to write atlas output image.");
-      }
+    header.Write(file).IgnoreResult();
+
+    m_Processor.m_TextureAtlas.CopyToStream(file).IgnoreResult();
 
-      RequestApplicationQuit();
-      return;
+    if (file.Close().Failed())
+    {
+      ezLog::Error("Failed to write atlas output image.");
+      return -1;
     }
 
-    if (!m_sOutputFile.IsEmpty() && m_Processor.m_OutputImage.IsValid())
+    return 0;
+  }
+
+  if (!m_sOutputFile.IsEmpty() && m_Processor.m_OutputImage.IsValid())
+  {
+    if (WriteOutputFile(m_sOutputFile, m_Processor.m_OutputImage).Failed())
     {
-      if (WriteOutputFile(m_sOutputFile, m_Processor.m_OutputImage).Failed())
-      {
-        ezLog::Error("Failed to write main result to '{}'", m_sOutputFile);
-        RequestApplicationQuit();
-        return;
-      }
+      ezLog::Error("Failed to write main result to '{}'", m_sOutputFile);
+      return -1;
+    }
 
-      ezLog::Success("Wrote main result to '{}'", m_sOutputFile);
+    ezLog::Success("Wrote main result to '{}'", m_sOutputFile);
+  }
+
+  if (!m_sOutputThumbnailFile.IsEmpty() && m_Processor.m_ThumbnailOutputImage.IsValid())
+  {
+    if (m_Processor.m_ThumbnailOutputImage.SaveTo(m_sOutputThumbnailFile).Failed())
+    {
+      ezLog::Error("Failed to write thumbnail result to '{}'", m_sOutputThumbnailFile);
+      return -1;
     }
 
-    if (!m_sOutputThumbnailFile.IsEmpty() && m_Processor.m_ThumbnailOutputImage.IsValid())
+    ezLog::Success("Wrote thumbnail to '{}'", m_sOutputThumbnailFile);
+  }
+
+  if (!m_sOutputLowResFile.IsEmpty())
+  {
+    // the image may not exist, if we do not have enough mips, so make sure any old low-res file is cleaned up
+    ezOSFile::DeleteFile(m_sOutputLowResFile).IgnoreResult();
+
+    if (m_Processor.m_LowResOutputImage.IsValid())
     {
-      if (m_Processor.m_ThumbnailOutputImage.SaveTo(m_sOutputThumbnailFile).Failed())
+      if (WriteOutputFile(m_sOutputLowResFile, m_Processor.m_LowResOutputImage).Failed())
       {
-        ezLog::Error("Failed to write thumbnail result to '{}'", m_sOutputThumbnailFile);
-        RequestApplicationQuit();
-        return;
+        ezLog::Error("Failed to write low-res result to '{}'", m_sOutputLowResFile);
+        return -1;
       }
 
-      ezLog::Success("Wrote thumbnail to '{}'", m_sOutputThumbnailFile);
+      ezLog::Success("Wrote low-res result to '{}'", m_sOutputLowResFile);
     }
+  }
 
-    if (!m_sOutputLowResFile.IsEmpty())
-    {
-      // the image may not exist, if we do not have enough mips, so make sure any old low-res file is cleaned up
-      ezOSFile::DeleteFile(m_sOutputLowResFile).IgnoreResult();
+  if (bUseCache)
+  {
+    m_pCache->Store(uiCacheKey, cachedOutputs);
+  }
 
-      if (m_Processor.m_LowResOutputImage.IsValid())
-      {
-        if (WriteOutputFile(m_sOutputLowResFile, m_Processor.m_LowResOutputImage).Failed())
-        {
-          ezLog::Error("Failed to write low-res result to '{}'", m_sOutputLowResFile);
-          RequestApplicationQuit();
-          return;
-        }
-
-        ezLog::Success("Wrote low-res result to '{}'", m_sOutputLowResFile);
-      }
+  return 0;
+}
+
+void ezTexConv::Run()
+{
+  SetReturnCode(-1);
+
+  m_pCache = ezTexConvCache::CreateFromCommandLine();
+
+  const ezString sManifest = GetBatchManifestFile();
+
+  if (!sManifest.IsEmpty())
+  {
+    SetReturnCode(RunBatch(sManifest));
+  }
+  else
+  {
+    ezTexConvJob job;
+    job.SetCache(m_pCache.Borrow());
+
+    if (job.ParseCommandLine().Succeeded())
+    {
+      SetReturnCode(job.Execute());
     }
+  }
 
-    SetReturnCode(0);
+  if (m_pCache)
+  {
+    // a single job runs once per texture, e.g. from the editor, there the trimming is throttled
+    m_pCache->Trim(!sManifest.IsEmpty());
+    m_pCache->LogStatistics();
+    m_pCache.Clear();
   }
 
   RequestApplicationQuit();
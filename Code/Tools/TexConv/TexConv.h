@@ -1,6 +1,8 @@
 #pragma once
 
 #include <Foundation/Application/Application.h>
+#include <Foundation/Utilities/CommandLineUtils.h>
+#include <TexConv/TexConvCache.h>
 #include <Texture/TexConv/TexComparer.h>
 
 class ezStreamWriter;
@@ -18,11 +20,14 @@ struct ezTexConvMode
   };
 };
 
-class ezTexConv : public ezApplication
+/// \brief Holds the options and the processor for a single conversion or comparison.
+///
+/// The options are read from an ezCommandLineUtils instance, which is the process command line, or one line of a batch manifest.
+class ezTexConvJob
 {
-public:
-  using SUPER = ezApplication;
+  EZ_DISALLOW_COPY_AND_ASSIGN(ezTexConvJob);
 
+public:
   struct KeyEnumValuePair
   {
     KeyEnumValuePair(ezStringView sKey, ezInt32 iVal)
@@ -35,14 +40,27 @@ public:
     ezInt32 m_iEnumValue = -1;
   };
 
-  ezTexConv();
+  ezTexConvJob(const ezCommandLineUtils* pCmd = ezCommandLineUtils::GetGlobalInstance());
 
-public:
-  virtual void Run() override;
-  virtual ezResult BeforeCoreSystemsStartup() override;
-  virtual void AfterCoreSystemsStartup() override;
-  virtual void BeforeCoreSystemsShutdown() override;
+  /// \brief Runs the conversion or comparison and writes all output files.
+  ///
+  /// Returns the exit code that TexConv reports for this job: 0 on success, -1 on failure and the MSE for failed comparisons.
+  ezInt32 Execute();
+
+  /// \brief Returns a rough upper bound for the memory that Execute() needs, based on the headers of the input files.
+  ezUInt64 EstimateMemoryUsage() const;
+
+  const ezString& GetOutputFile() const { return m_sOutputFile; }
+
+  /// \brief If set, conversions first look for their outputs in the cache and add them to it otherwise. The cache must outlive the job.
+  void SetCache(ezTexConvCache* pCache) { m_pCache = pCache; }
+
+  /// \brief Computes a hash of the content of all input files and of all options that affect the output. Fails, if an input file can't be read.
+  ///
+  /// Implemented in TexConvCache.cpp
+  ezResult ComputeCacheKey(ezUInt64& out_uiKey) const;
 
+public:
   ezResult ParseCommandLine();
   ezResult ParseMode();
   ezResult ParseCompareMode();
@@ -75,6 +93,12 @@ public:
   ezResult WriteOutputFile(ezStringView sFile, const ezImage& image);
 
 private:
+  ezInt32 ExecuteCompare();
+  ezInt32 ExecuteConvert();
+
+  const ezCommandLineUtils* m_pCmd = nullptr;
+  ezTexConvCache* m_pCache = nullptr;
+
   ezString m_sOutputFile;
   ezString m_sOutputThumbnailFile;
   ezString m_sOutputLowResFile;
@@ -95,3 +119,28 @@ private:
   ezTexComparer m_Comparer;
   ezString m_sHtmlTitle;
 };
+
+class ezTexConv : public ezApplication
+{
+public:
+  using SUPER = ezApplication;
+
+  ezTexConv();
+
+public:
+  virtual void Run() override;
+  virtual ezResult BeforeCoreSystemsStartup() override;
+  virtual void AfterCoreSystemsStartup() override;
+  virtual void BeforeCoreSystemsShutdown() override;
+
+private:
+  // Batch mode, implemented in TexConvBatch.cpp
+
+  /// \brief Returns the manifest file passed with '-batch', or an empty string, if only a single job is given on the command line.
+  ezString GetBatchManifestFile() const;
+
+  /// \brief Reads one job per line from the manifest file and runs all of them concurrently. Returns 0 if all jobs succeeded, 1 otherwise.
+  ezInt32 RunBatch(ezStringView sManifestFile);
+
+  ezUniquePtr<ezTexConvCache> m_pCache;
+};
@@ -0,0 +1,349 @@
+#include <TexConv/TexConvPCH.h>
+
+#include <Foundation/IO/FileSystem/FileReader.h>
+#include <Foundation/IO/FileSystem/FileWriter.h>
+#include <Foundation/IO/OSFile.h>
+#include <Foundation/Logging/LogEntry.h>
+#include <Foundation/Threading/ConditionVariable.h>
+#include <Foundation/Threading/DelegateTask.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Time/Time.h>
+#include <Foundation/Types/UniquePtr.h>
+#include <Foundation/Utilities/CommandLineOptions.h>
+#include <TexConv/TexConv.h>
+
+ezCommandLineOptionPath opt_Batch("_TexConv", "-batch", "\
+Path to a manifest file with one job per line.\n\
+Each line holds the same options that TexConv takes on the command line, e.g. '-out \"file.dds\" -in0 \"file.png\" -rgba in0'.\n\
+Relative paths are resolved against the working directory. Empty lines and lines starting with '#' are ignored.\n\
+All jobs run concurrently in this process. The return code is 0 if all jobs succeeded and 1 otherwise, the number of failed jobs is logged.",
+  "");
+
+ezCommandLineOptionInt opt_BatchMemoryBudget("_TexConv", "-batchMemoryMB", "\
+In batch mode, jobs are only started while the estimated memory use of all running jobs stays within this budget.\n\
+A job that exceeds the budget on its own is run when no other job is running.",
+  4096, 64, 1024 * 1024);
+
+ezCommandLineOptionPath opt_BatchLogDir("_TexConv", "-batchLogDir", "\
+In batch mode, the full log of every job is written to this folder, as 'JobXXXXX.log'.\n\
+Without it, only warnings and errors of each job are printed.",
+  "");
+
+namespace
+{
+  struct ezTexConvBatchJob
+  {
+    ezString m_sCommandLine;
+    ezCommandLineUtils m_CommandLine;
+    ezUniquePtr<ezTexConvJob> m_pJob;
+    ezDynamicArray<ezLogEntry> m_Log;
+    ezUInt64 m_uiEstimatedMemory = 0;
+    ezInt32 m_iExitCode = -1;
+    ezTime m_Duration;
+  };
+
+  /// \brief Splits a manifest line into arguments. Arguments are separated by whitespace, quotes allow whitespace inside of arguments and are removed.
+  void SplitTexConvManifestLine(ezStringView sLine, ezDynamicArray<ezString>& out_args)
+  {
+    ezStringBuilder sArg;
+    bool bInQuotes = false;
+    bool bHasArg = false;
+
+    for (auto it = sLine.GetIteratorFront(); it.IsValid(); ++it)
+    {
+      const ezUInt32 c = it.GetCharacter();
+
+      if (c == '\"')
+      {
+        bInQuotes = !bInQuotes;
+        bHasArg = true;
+      }
+      else if (!bInQuotes && ezStringUtils::IsWhiteSpace(c))
+      {
+        if (bHasArg)
+        {
+          out_args.PushBack(sArg);
+          sArg.Clear();
+          bHasArg = false;
+        }
+      }
+      else
+      {
+        sArg.Append(c);
+        bHasArg = true;
+      }
+    }
+
+    if (bHasArg)
+    {
+      out_args.PushBack(sArg);
+    }
+  }
+
+  void WriteTexConvJobLog(ezStringView sFile, const ezTexConvBatchJob& job)
+  {
+    ezFileWriter file;
+    if (file.Open(sFile).Failed())
+    {
+      ezLog::Warning("Failed to write log file '{}'", sFile);
+      return;
+    }
+
+    ezStringBuilder sLine;
+    sLine.SetFormat("TexConv {}\n\n", job.m_sCommandLine);
+    file.WriteBytes(sLine.GetData(), sLine.GetElementCount()).IgnoreResult();
+
+    for (const ezLogEntry& entry : job.m_Log)
+    {
+      sLine.Clear();
+      sLine.Append(ezStringView("                                ", ezMath::Min<ezUInt32>(entry.m_uiIndentation * 2, 32)));
+
+      switch (entry.m_Type)
+      {
+        case ezLogMsgType::BeginGroup:
+          sLine.AppendFormat("+++++ {} +++++\n", entry.m_sMsg);
+          break;
+        case ezLogMsgType::EndGroup:
+          sLine.AppendFormat("----- {} -----\n", entry.m_sMsg);
+          break;
+        case ezLogMsgType::ErrorMsg:
+          sLine.AppendFormat("Error: {}\n", entry.m_sMsg);
+          break;
+        case ezLogMsgType::SeriousWarningMsg:
+          sLine.AppendFormat("Seriously: {}\n", entry.m_sMsg);
+          break;
+        case ezLogMsgType::WarningMsg:
+          sLine.AppendFormat("Warning: {}\n", entry.m_sMsg);
+          break;
+        default:
+          sLine.AppendFormat("{}\n", entry.m_sMsg);
+          break;
+      }
+
+      file.WriteBytes(sLine.GetData(), sLine.GetElementCount()).IgnoreResult();
+    }
+
+    sLine.SetFormat("\nExit code: {} ({})\n", job.m_iExitCode, job.m_Duration);
+    file.WriteBytes(sLine.GetData(), sLine.GetElementCount()).IgnoreResult();
+  }
+
+  void PrintTexConvJobWarnings(const ezTexConvBatchJob& job, ezStringView sLogDir)
+  {
+    // without a log folder, the warnings and errors of each job are the only place to find out what went wrong
+    if (!sLogDir.IsEmpty())
+      return;
+
+    for (const ezLogEntry& entry : job.m_Log)
+    {
+      if (entry.m_Type == ezLogMsgType::ErrorMsg || entry.m_Type == ezLogMsgType::SeriousWarningMsg || entry.m_Type == ezLogMsgType::WarningMsg)
+      {
+        ezLog::BroadcastLoggingEvent(ezLog::GetThreadLocalLogSystem(), entry.m_Type, entry.m_sMsg);
+      }
+    }
+  }
+
+  /// \brief Runs the jobs of a manifest on the task system, while keeping the estimated memory use of all running jobs within a budget.
+  class ezTexConvBatch
+  {
+  public:
+    ezResult ReadManifest(ezStringView sManifestFile);
+    void ParseJobs(ezTexConvCache* pCache);
+    void RunJobs(ezUInt64 uiMemoryBudget);
+    ezUInt32 ReportResults(ezStringView sLogDir) const;
+
+  private:
+    void RunJob(const ezUInt32& uiJob);
+
+    ezDynamicArray<ezTexConvBatchJob> m_Jobs;
+    ezTime m_Duration;
+
+    ezConditionVariable m_JobFinished;
+    ezUInt64 m_uiMemoryInFlight = 0;
+    ezUInt32 m_uiJobsInFlight = 0;
+  };
+
+  ezResult ezTexConvBatch::ReadManifest(ezStringView sManifestFile)
+  {
+    ezFileReader file;
+    if (file.Open(sManifestFile).Failed())
+    {
+      ezLog::Error("Failed to open batch manifest '{}'", sManifestFile);
+      return EZ_FAILURE;
+    }
+
+    ezStringBuilder sContent;
+    sContent.ReadAll(file);
+
+    ezDynamicArray<ezStringView> lines;
+    sContent.Split(false, lines, "\n", "\r");
+
+    for (ezStringView sLine : lines)
+    {
+      sLine.Trim(" \t");
+
+      if (sLine.IsEmpty() || sLine.StartsWith("#"))
+        continue;
+
+      ezTexConvBatchJob& job = m_Jobs.ExpandAndGetRef();
+      job.m_sCommandLine = sLine;
+
+      // the first argument is expected to be the executable
+      ezDynamicArray<ezString> args;
+      args.PushBack("TexConv");
+      SplitTexConvManifestLine(sLine, args);
+      job.m_CommandLine.SetCommandLine(args);
+    }
+
+    ezLog::Info("Read {} jobs from batch manifest '{}'", m_Jobs.GetCount(), sManifestFile);
+    return EZ_SUCCESS;
+  }
+
+  void ezTexConvBatch::ParseJobs(ezTexConvCache* pCache)
+  {
+    // the command line options are not thread-safe, so all jobs are parsed up front
+    for (ezTexConvBatchJob& job : m_Jobs)
+    {
+      ezLogEntryDelegate logger([&job](ezLogEntry& ref_entry)
+        { job.m_Log.PushBack(std::move(ref_entry)); });
+      ezLogSystemScope logScope(&logger);
+
+      job.m_pJob = EZ_DEFAULT_NEW(ezTexConvJob, &job.m_CommandLine);
+      job.m_pJob->SetCache(pCache);
+
+      if (job.m_pJob->ParseCommandLine().Failed())
+      {
+        job.m_pJob.Clear();
+        continue;
+      }
+
+      job.m_uiEstimatedMemory = job.m_pJob->EstimateMemoryUsage();
+    }
+  }
+
+  void ezTexConvBatch::RunJobs(ezUInt64 uiMemoryBudget)
+  {
+    const ezTime tStart = ezTime::Now();
+
+    for (ezUInt32 i = 0; i < m_Jobs.GetCount(); ++i)
+    {
+      const ezTexConvBatchJob& job = m_Jobs[i];
+
+      if (job.m_pJob == nullptr)
+        continue;
+
+      {
+        EZ_LOCK(m_JobFinished);
+
+        while (m_uiJobsInFlight > 0 && m_uiMemoryInFlight + job.m_uiEstimatedMemory > uiMemoryBudget)
+        {
+          m_JobFinished.UnlockWaitForSignalAndLock();
+        }
+
+        m_uiMemoryInFlight += job.m_uiEstimatedMemory;
+        ++m_uiJobsInFlight;
+      }
+
+      // the jobs use parallel loops themselves, so they have to be allowed to wait for other tasks
+      ezSharedPtr<ezTask> pTask = EZ_DEFAULT_NEW(ezDelegateTask<ezUInt32>, "TexConvJob", ezTaskNesting::Maybe, ezMakeDelegate(&ezTexConvBatch::RunJob, this), i);
+      ezTaskSystem::StartSingleTask(pTask, ezTaskPriority::LongRunning);
+    }
+
+    {
+      EZ_LOCK(m_JobFinished);
+
+      while (m_uiJobsInFlight > 0)
+      {
+        m_JobFinished.UnlockWaitForSignalAndLock();
+      }
+    }
+
+    m_Duration = ezTime::Now() - tStart;
+  }
+
+  void ezTexConvBatch::RunJob(const ezUInt32& uiJob)
+  {
+    ezTexConvBatchJob& job = m_Jobs[uiJob];
+
+    {
+      ezLogEntryDelegate logger([&job](ezLogEntry& ref_entry)
+        { job.m_Log.PushBack(std::move(ref_entry)); });
+      ezLogSystemScope logScope(&logger);
+
+      const ezTime tStart = ezTime::Now();
+      job.m_iExitCode = job.m_pJob->Execute();
+      job.m_Duration = ezTime::Now() - tStart;
+    }
+
+    // release the images right away, the memory budget relies on it
+    job.m_pJob.Clear();
+
+    EZ_LOCK(m_JobFinished);
+    m_uiMemoryInFlight -= job.m_uiEstimatedMemory;
+    --m_uiJobsInFlight;
+    m_JobFinished.SignalAll();
+  }
+
+  ezUInt32 ezTexConvBatch::ReportResults(ezStringView sLogDir) const
+  {
+    if (!sLogDir.IsEmpty() && ezOSFile::CreateDirectoryStructure(sLogDir).Failed())
+    {
+      ezLog::Warning("Failed to create log folder '{}'", sLogDir);
+    }
+
+    ezUInt32 uiFailed = 0;
+    ezTime tTotalJobTime;
+    ezStringBuilder sLogFile;
+
+    for (ezUInt32 i = 0; i < m_Jobs.GetCount(); ++i)
+    {
+      const ezTexConvBatchJob& job = m_Jobs[i];
+      tTotalJobTime += job.m_Duration;
+
+      if (job.m_iExitCode != 0)
+        ++uiFailed;
+
+      if (!sLogDir.IsEmpty())
+      {
+        sLogFile.SetFormat("{}/Job{}.log", sLogDir, ezArgU(i, 5, true));
+        WriteTexConvJobLog(sLogFile, job);
+      }
+
+      if (job.m_iExitCode == 0)
+      {
+        ezLog::Dev("Job {}: succeeded ({})", i, job.m_Duration);
+        PrintTexConvJobWarnings(job, sLogDir);
+      }
+      else
+      {
+        EZ_LOG_BLOCK("Job failed", job.m_sCommandLine);
+        PrintTexConvJobWarnings(job, sLogDir);
+        ezLog::Error("Job {}: exit code {}", i, job.m_iExitCode);
+      }
+    }
+
+    const double fSeconds = ezMath::Max(m_Duration.GetSeconds(), 0.001);
+    ezLog::Info("Batch finished: {} of {} jobs succeeded in {} ({} jobs/s, {} summed job time)", m_Jobs.GetCount() - uiFailed, m_Jobs.GetCount(), m_Duration, ezArgF(m_Jobs.GetCount() / fSeconds, 2), tTotalJobTime);
+
+    return uiFailed;
+  }
+} // namespace
+
+ezString ezTexConv::GetBatchManifestFile() const
+{
+  return opt_Batch.GetOptionValue(ezCommandLineOption::LogMode::FirstTimeIfSpecified);
+}
+
+ezInt32 ezTexConv::RunBatch(ezStringView sManifestFile)
+{
+  ezTexConvBatch batch;
+
+  if (batch.ReadManifest(sManifestFile).Failed())
+    return 1;
+
+  batch.ParseJobs(m_pCache.Borrow());
+  batch.RunJobs(static_cast<ezUInt64>(opt_BatchMemoryBudget.GetOptionValue(ezCommandLineOption::LogMode::Always)) * 1024 * 1024);
+
+  // the number of failed jobs is already logged, as an exit code it would wrap around at 256
+  const ezUInt32 uiFailed = batch.ReportResults(opt_BatchLogDir.GetOptionValue(ezCommandLineOption::LogMode::Always));
+  return uiFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,348 @@
+#include <TexConv/TexConvPCH.h>
+
+#include <Foundation/Algorithm/HashStream.h>
+#include <Foundation/IO/FileSystem/FileReader.h>
+#include <Foundation/IO/OSFile.h>
+#include <Foundation/Types/Uuid.h>
+#include <Foundation/Utilities/CommandLineOptions.h>
+#include <TexConv/TexConv.h>
+
+ezCommandLineOptionPath opt_Cache("_TexConv", "-cache", "\
+Path to a folder that is used as a cache for the output files.\n\
+Before a texture is converted, TexConv hashes the content of all input files together with all options that affect the output.\n\
+If the cache has an entry for that hash, the output files are copied from there, instead of running the conversion.\n\
+The cache can be shared by any number of TexConv processes.",
+  "");
+
+ezCommandLineOptionInt opt_CacheMaxSize("_TexConv", "-cacheMaxMB", "\
+The size limit of the cache folder. Once the cache grows beyond it, the least recently used entries are deleted.",
+  2048, 1, 1024 * 1024);
+
+namespace
+{
+  /// \brief Increase this, whenever a change to TexConv or the Texture library changes the output for the same input and options.
+  /// All existing cache entries are ignored afterwards and eventually get evicted.
+  constexpr ezUInt32 s_uiTexConvCacheVersion = 1;
+
+  constexpr ezStringView s_sTexConvCacheMarker = "LastUsed"_ezsv;
+
+  /// \brief Lives in the cache folder itself, its modification time is the last time any process trimmed the cache.
+  constexpr ezStringView s_sTexConvCacheLastTrim = "LastTrim"_ezsv;
+  constexpr ezInt64 s_iTexConvCacheTrimIntervalSeconds = 60;
+
+  struct ezTexConvCacheEntry
+  {
+    ezStringBuilder m_sFolder;
+    ezInt64 m_iLastUsed = ezMath::MinValue<ezInt64>();
+    ezUInt64 m_uiSize = 0;
+  };
+} // namespace
+
+ezTexConvCache::ezTexConvCache(ezStringView sFolder, ezUInt64 uiMaxSize)
+  : m_sFolder(sFolder)
+  , m_uiMaxSize(uiMaxSize)
+{
+}
+
+ezUniquePtr<ezTexConvCache> ezTexConvCache::CreateFromCommandLine()
+{
+  const ezString sFolder = opt_Cache.GetOptionValue(ezCommandLineOption::LogMode::FirstTimeIfSpecified);
+
+  if (sFolder.IsEmpty())
+    return nullptr;
+
+  const ezUInt64 uiMaxSize = static_cast<ezUInt64>(opt_CacheMaxSize.GetOptionValue(ezCommandLineOption::LogMode::FirstTime)) * 1024 * 1024;
+
+  return EZ_DEFAULT_NEW(ezTexConvCache, sFolder, uiMaxSize);
+}
+
+void ezTexConvCache::GetEntryFolder(ezUInt64 uiKey, ezStringBuilder& out_sFolder) const
+{
+  out_sFolder.SetFormat("{}/{}", m_sFolder, ezArgU(uiKey, 16, true, 16, true));
+}
+
+ezResult ezTexConvCache::Restore(ezUInt64 uiKey, ezArrayPtr<const ezString> outputFiles)
+{
+  ezStringBuilder sEntry, sMarker, sFile;
+  GetEntryFolder(uiKey, sEntry);
+  sMarker.SetPath(sEntry, s_sTexConvCacheMarker);
+
+  // the marker stores which of the outputs were produced
+  ezHybridArray<ezUInt8, 4> produced;
+  {
+    ezOSFile marker;
+    if (marker.Open(sMarker, ezFileOpenMode::Read).Failed() || marker.ReadAll(produced) != outputFiles.GetCount())
+    {
+      m_iMisses.Increment();
+      return EZ_FAILURE;
+    }
+  }
+
+  for (ezUInt32 i = 0; i < outputFiles.GetCount(); ++i)
+  {
+    if (outputFiles[i].IsEmpty())
+      continue;
+
+    if (produced[i] == 0)
+    {
+      // same as for a conversion, which cleans up outputs that it does not produce
+      ezOSFile::DeleteFile(outputFiles[i]).IgnoreResult();
+      continue;
+    }
+
+    sFile.SetFormat("{}/Output{}", sEntry, i);
+
+    // the entry may have been evicted by another process in the meantime
+    if (ezOSFile::CopyFile(sFile, outputFiles[i]).Failed())
+    {
+      m_iMisses.Increment();
+      return EZ_FAILURE;
+    }
+  }
+
+  // rewriting the marker updates its modification time, which is what the LRU eviction looks at
+  {
+    ezOSFile marker;
+    if (marker.Open(sMarker, ezFileOpenMode::Write).Succeeded())
+    {
+      marker.Write(produced.GetData(), produced.GetCount()).IgnoreResult();
+    }
+  }
+
+  m_iHits.Increment();
+  return EZ_SUCCESS;
+}
+
+void ezTexConvCache::Store(ezUInt64 uiKey, ezArrayPtr<const ezString> outputFiles)
+{
+  ezStringBuilder sEntry, sTempEntry, sFile;
+  GetEntryFolder(uiKey, sEntry);
+
+  ezUInt64 uiUuidLow, uiUuidHigh;
+  ezUuid::MakeUuid().GetValues(uiUuidLow, uiUuidHigh);
+  sTempEntry.SetFormat("{}-{}.tmp", sEntry, ezArgU(uiUuidLow ^ uiUuidHigh, 16, true, 16, true));
+
+  ezHybridArray<ezUInt8, 4> produced;
+  produced.SetCount(outputFiles.GetCount(), 0);
+
+  for (ezUInt32 i = 0; i < outputFiles.GetCount(); ++i)
+  {
+    if (outputFiles[i].IsEmpty() || !ezOSFile::ExistsFile(outputFiles[i]))
+      continue;
+
+    sFile.SetFormat("{}/Output{}", sTempEntry, i);
+
+    if (ezOSFile::CopyFile(outputFiles[i], sFile).Failed())
+    {
+      ezLog::Warning("Failed to add '{}' to the TexConv cache", outputFiles[i]);
+      ezOSFile::DeleteFolder(sTempEntry).IgnoreResult();
+      return;
+    }
+
+    produced[i] = 1;
+  }
+
+  sFile.SetPath(sTempEntry, s_sTexConvCacheMarker);
+
+  {
+    ezOSFile marker;
+    if (marker.Open(sFile, ezFileOpenMode::Write).Failed() || marker.Write(produced.GetData(), produced.GetCount()).Failed())
+    {
+      ezLog::Warning("Failed to write TexConv cache entry '{}'", sFile);
+      marker.Close();
+      ezOSFile::DeleteFolder(sTempEntry).IgnoreResult();
+      return;
+    }
+  }
+
+  // fails, if another job stored the same entry first, which is fine, since it has the same content
+  if (ezOSFile::MoveFileOrDirectory(sTempEntry, sEntry).Failed())
+  {
+    ezOSFile::DeleteFolder(sTempEntry).IgnoreResult();
+    return;
+  }
+
+  m_iStored.Increment();
+}
+
+void ezTexConvCache::Trim(bool bForce)
+{
+  ezStringBuilder sLastTrim;
+  sLastTrim.SetPath(m_sFolder, s_sTexConvCacheLastTrim);
+
+  if (!bForce)
+  {
+    // without new entries the cache can't have grown
+    if (m_iStored == 0)
+      return;
+
+    ezFileStats stats;
+    if (ezOSFile::GetFileStats(sLastTrim, stats).Succeeded())
+    {
+      const ezInt64 iNow = ezTimestamp::CurrentTimestamp().GetInt64(ezSIUnitOfTime::Second);
+      if (iNow - stats.m_LastModificationTime.GetInt64(ezSIUnitOfTime::Second) < s_iTexConvCacheTrimIntervalSeconds)
+        return;
+    }
+  }
+
+  // update the time stamp first, so that processes that finish at the same time skip their trim
+  {
+    ezOSFile file;
+    file.Open(sLastTrim, ezFileOpenMode::Write).IgnoreResult();
+  }
+
+  m_bTrimmed = true;
+
+  ezDynamicArray<ezFileStats> items;
+  ezOSFile::GatherAllItemsInFolder(items, m_sFolder, ezFileSystemIteratorFlags::ReportFolders);
+
+  ezDynamicArray<ezTexConvCacheEntry> entries;
+  entries.Reserve(items.GetCount());
+
+  m_uiSize = 0;
+
+  ezDynamicArray<ezFileStats> files;
+  for (const ezFileStats& folder : items)
+  {
+    ezTexConvCacheEntry& entry = entries.ExpandAndGetRef();
+    folder.GetFullPath(entry.m_sFolder);
+
+    files.Clear();
+    ezOSFile::GatherAllItemsInFolder(files, entry.m_sFolder, ezFileSystemIteratorFlags::ReportFiles);
+
+    for (const ezFileStats& file : files)
+    {
+      const ezInt64 iModified = file.m_LastModificationTime.GetInt64(ezSIUnitOfTime::Microsecond);
+
+      // temporary entries of crashed processes have no marker, they get the time of their newest file
+      if (file.m_sName == s_sTexConvCacheMarker || iModified > entry.m_iLastUsed)
+      {
+        entry.m_iLastUsed = iModified;
+      }
+
+      entry.m_uiSize += file.m_uiFileSize;
+    }
+
+    m_uiSize += entry.m_uiSize;
+  }
+
+  if (m_uiSize <= m_uiMaxSize)
+    return;
+
+  entries.Sort([](const ezTexConvCacheEntry& lhs, const ezTexConvCacheEntry& rhs)
+    { return lhs.m_iLastUsed < rhs.m_iLastUsed; });
+
+  for (const ezTexConvCacheEntry& entry : entries)
+  {
+    if (m_uiSize <= m_uiMaxSize)
+      break;
+
+    // another process may be trimming at the same time
+    if (ezOSFile::DeleteFolder(entry.m_sFolder).Succeeded())
+    {
+      ++m_uiEvictedEntries;
+      m_uiEvictedSize += entry.m_uiSize;
+    }
+
+    m_uiSize -= entry.m_uiSize;
+  }
+}
+
+void ezTexConvCache::LogStatistics() const
+{
+  const ezInt32 iHits = m_iHits;
+  const ezInt32 iMisses = m_iMisses;
+  const ezInt32 iStored = m_iStored;
+  const double fHitRate = (iHits + iMisses) > 0 ? 100.0 * iHits / (iHits + iMisses) : 0.0;
+
+  if (m_bTrimmed)
+  {
+    ezLog::Info("TexConv cache: {} hits, {} misses ({}%% hit rate), {} entries added, {} entries evicted ({}), {} of {} in use", iHits, iMisses, ezArgF(fHitRate, 1), iStored, m_uiEvictedEntries, ezArgFileSize(m_uiEvictedSize), ezArgFileSize(m_uiSize), ezArgFileSize(m_uiMaxSize));
+  }
+  else
+  {
+    ezLog::Info("TexConv cache: {} hits, {} misses ({}%% hit rate), {} entries added, not trimmed", iHits, iMisses, ezArgF(fHitRate, 1), iStored);
+  }
+}
+
+ezResult ezTexConvJob::ComputeCacheKey(ezUInt64& out_uiKey) const
+{
+  const ezTexConvDesc& desc = m_Processor.m_Descriptor;
+
+  ezHashStreamWriter64 stream(s_uiTexConvCacheVersion);
+
+  // the content of the input files, their names and locations do not matter
+  {
+    ezDynamicArray<ezUInt8> buffer;
+    buffer.SetCountUninitialized(1024 * 64);
+
+    stream << desc.m_InputFiles.GetCount();
+
+    for (const ezString& sFile : desc.m_InputFiles)
+    {
+      ezFileReader file;
+      if (file.Open(sFile).Failed())
+        return EZ_FAILURE;
+
+      stream << file.GetFileSize();
+
+      while (true)
+      {
+        const ezUInt64 uiRead = file.ReadBytes(buffer.GetData(), buffer.GetCount());
+
+        if (uiRead == 0)
+          break;
+
+        EZ_SUCCEED_OR_RETURN(stream.WriteBytes(buffer.GetData(), uiRead));
+      }
+    }
+  }
+
+  stream << desc.m_ChannelMappings.GetCount();
+  for (const ezTexConvSliceChannelMapping& slice : desc.m_ChannelMappings)
+  {
+    for (const ezTexConvChannelMapping& channel : slice.m_Channel)
+    {
+      stream << channel.m_iInputImageIndex;
+      stream << static_cast<ezUInt8>(channel.m_ChannelValue);
+    }
+  }
+
+  // the output files determine the output formats
+  for (ezStringView sFile : {m_sOutputFile.GetView(), m_sOutputThumbnailFile.GetView(), m_sOutputLowResFile.GetView()})
+  {
+    ezStringBuilder sExt = sFile.GetFileExtension();
+    sExt.ToLower();
+    stream << sExt;
+  }
+
+  stream << desc.m_OutputType;
+  stream << desc.m_TargetPlatform;
+  stream << desc.m_uiLowResMipmaps;
+  stream << desc.m_uiThumbnailOutputResolution;
+  stream << desc.m_Usage;
+  stream << desc.m_CompressionMode;
+  stream << desc.m_uiMinResolution;
+  stream << desc.m_uiMaxResolution;
+  stream << desc.m_uiDownscaleSteps;
+  stream << desc.m_MipmapMode;
+  stream << desc.m_FilterMode;
+  stream << desc.m_AddressModeU;
+  stream << desc.m_AddressModeV;
+  stream << desc.m_AddressModeW;
+  stream << desc.m_bPreserveMipmapCoverage;
+  stream << desc.m_fMipmapAlphaThreshold;
+  stream << desc.m_uiDilateColor;
+  stream << desc.m_bFlipHorizontal;
+  stream << desc.m_bPremultiplyAlpha;
+  stream << desc.m_fHdrExposureBias;
+  stream << desc.m_fMaxValue;
+  stream << desc.m_BumpMapFilter;
+
+  // the asset hash and version are written into the ez file headers
+  stream << desc.m_uiAssetHash;
+  stream << desc.m_uiAssetVersion;
+
+  out_uiKey = stream.GetHashValue();
+  return EZ_SUCCESS;
+}
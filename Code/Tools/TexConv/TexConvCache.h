@@ -0,0 +1,56 @@
+#pragma once
+
+#include <Foundation/Strings/String.h>
+#include <Foundation/Threading/AtomicInteger.h>
+#include <Foundation/Types/UniquePtr.h>
+
+/// \brief A local, content-addressed cache for the output files of TexConv.
+///
+/// Every entry is a folder that is named after the hash of everything that influences the output (see ezTexConvJob::ComputeCacheKey()),
+/// and that holds a copy of each output file. When a job finds its key in the cache, the files are copied to their destinations instead of
+/// running the conversion. Entries are written to a temporary folder and then renamed, so other TexConv processes never see incomplete entries.
+///
+/// A small marker file in each entry is rewritten whenever the entry is used. Trim() uses its modification time to remove the least recently
+/// used entries, once the cache grows beyond its size limit.
+class ezTexConvCache
+{
+  EZ_DISALLOW_COPY_AND_ASSIGN(ezTexConvCache);
+
+public:
+  ezTexConvCache(ezStringView sFolder, ezUInt64 uiMaxSize);
+
+  /// \brief Returns a cache for the folder passed with '-cache', or nullptr, if the cache is not enabled.
+  static ezUniquePtr<ezTexConvCache> CreateFromCommandLine();
+
+  /// \brief Copies the cached outputs for the key to the given files and deletes those files that the cached conversion did not produce.
+  ///
+  /// Empty paths are skipped. Fails, if there is no complete entry for the key. Thread-safe.
+  ezResult Restore(ezUInt64 uiKey, ezArrayPtr<const ezString> outputFiles);
+
+  /// \brief Adds the given output files as the entry for the key. Files that do not exist are recorded as not produced. Thread-safe.
+  void Store(ezUInt64 uiKey, ezArrayPtr<const ezString> outputFiles);
+
+  /// \brief Deletes the least recently used entries until the cache is within its size limit.
+  ///
+  /// This has to look at every entry, which takes much longer than converting a single small texture. Therefore, unless bForce is set,
+  /// nothing is done when this process didn't add any entries, or when any TexConv process trimmed the same cache within the last minute.
+  void Trim(bool bForce);
+
+  /// \brief Logs the number of hits, misses and evicted entries.
+  void LogStatistics() const;
+
+private:
+  void GetEntryFolder(ezUInt64 uiKey, ezStringBuilder& out_sFolder) const;
+
+  ezString m_sFolder;
+  ezUInt64 m_uiMaxSize = 0;
+
+  ezAtomicInteger32 m_iHits;
+  ezAtomicInteger32 m_iMisses;
+  ezAtomicInteger32 m_iStored;
+
+  ezUInt32 m_uiEvictedEntries = 0;
+  ezUInt64 m_uiEvictedSize = 0;
+  ezUInt64 m_uiSize = 0;
+  bool m_bTrimmed = false;
+};
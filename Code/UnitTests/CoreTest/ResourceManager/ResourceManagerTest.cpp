@@ -1,6 +1,10 @@
 #include <CoreTest/CoreTestPCH.h>
 
 #include <Core/ResourceManager/ResourceManager.h>
+#include <Foundation/Configuration/CVar.h>
+#include <Foundation/IO/FileSystem/FileSystem.h>
+#include <Foundation/IO/OSFile.h>
+#include <Foundation/Time/Stopwatch.h>
 #include <Foundation/Types/ScopeExit.h>
 
 EZ_CREATE_SIMPLE_TEST_GROUP(ResourceManager);
@@ -40,6 +44,12 @@ namespace
 
       ezStreamReader& s = *Stream;
 
+      // ezResourceLoaderFromFile writes the path of the file in front of its content
+      if (GetResourceID().StartsWith("File-"))
+      {
+        s >> m_sFilePath;
+      }
+
       ezUInt32 uiNumElements = 0;
       s >> uiNumElements;
 
@@ -76,9 +86,13 @@ namespace
   public:
     void Test() { EZ_TEST_BOOL(!m_Data.IsEmpty()); }
 
+    ezStringView GetFilePath() const { return m_sFilePath; }
+    ezArrayPtr<const ezUInt32> GetData() const { return m_Data; }
+
   private:
     TestResourceHandle m_hNested;
     ezDynamicArray<ezUInt32> m_Data;
+    ezString m_sFilePath;
   };
 
   class TestResourceTypeLoader : public ezResourceTypeLoader
@@ -286,3 +300,117 @@ EZ_CREATE_SIMPLE_TEST(ResourceManager, NestedLoading)
     EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
   }
 }
+
+EZ_CREATE_SIMPLE_TEST(ResourceManager, FileLoading)
+{
+  // no type loader, so all resources are read from files by ezResourceLoaderFromFile, which reads ahead in the loading queue
+  ezResourceManager::AllowResourceTypeAcquireDuringUpdateContent<TestResource, TestResource>();
+
+  ezStringBuilder sFolder = ezTestFramework::GetInstance()->GetAbsOutputPath();
+  sFolder.AppendPath("ResourceManagerFiles");
+
+  ezOSFile::DeleteFolder(sFolder).IgnoreResult();
+  if (!EZ_TEST_BOOL(ezOSFile::CreateDirectoryStructure(sFolder).Succeeded()))
+    return;
+
+  const ezUInt32 uiNumResources = 300;
+
+  ezStringBuilder sFile;
+  for (ezUInt32 i = 0; i < uiNumResources; ++i)
+  {
+    ezDynamicArray<ezUInt32> data;
+    data.PushBack(i * 10 + 1);
+    for (ezUInt32 e = 0; e < i * 10 + 1; ++e)
+    {
+      data.PushBack(i + e);
+    }
+
+    sFile.SetFormat("{}/File-{}.bin", sFolder, i);
+
+    ezOSFile file;
+    EZ_TEST_BOOL(file.Open(sFile, ezFileOpenMode::Write).Succeeded());
+    EZ_TEST_BOOL(file.Write(data.GetData(), data.GetCount() * sizeof(ezUInt32)).Succeeded());
+  }
+
+  EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(sFolder, "ResourceManagerTest").Succeeded());
+  EZ_SCOPE_EXIT(ezFileSystem::RemoveDataDirectoryGroup("ResourceManagerTest"));
+
+  ezCVarInt* pPrefetchFiles = static_cast<ezCVarInt*>(ezCVar::FindCVarByName("Resource.PrefetchFiles"));
+  if (!EZ_TEST_BOOL(pPrefetchFiles != nullptr))
+    return;
+
+  const ezInt32 iPrefetchFiles = *pPrefetchFiles;
+  EZ_SCOPE_EXIT(*pPrefetchFiles = iPrefetchFiles);
+
+  auto LoadAll = [&]()
+  {
+    ezDynamicArray<TestResourceHandle> hResources;
+
+    ezStringBuilder sResourceID;
+    for (ezUInt32 i = 0; i < uiNumResources; ++i)
+    {
+      sResourceID.SetFormat("File-{}.bin", i);
+      hResources.PushBack(ezResourceManager::LoadResource<TestResource>(sResourceID));
+      ezResourceManager::PreloadResource(hResources.PeekBack());
+    }
+
+    for (ezUInt32 i = 0; i < uiNumResources; ++i)
+    {
+      ezResourceLock<TestResource> pTestResource(hResources[i], ezResourceAcquireMode::BlockTillLoaded_NeverFail);
+
+      if (!EZ_TEST_BOOL(pTestResource.GetAcquireResult() == ezResourceAcquireResult::Final))
+        continue;
+
+      sFile.SetFormat("{}/File-{}.bin", sFolder, i);
+      sFile.MakeCleanPath();
+      EZ_TEST_STRING(pTestResource->GetFilePath(), sFile);
+
+      ezArrayPtr<const ezUInt32> data = pTestResource->GetData();
+      EZ_TEST_INT(data.GetCount(), i * 10 + 1);
+
+      for (ezUInt32 e = 0; e < data.GetCount(); ++e)
+      {
+        if (data[e] != i + e)
+        {
+          EZ_TEST_INT(data[e], i + e);
+          break;
+        }
+      }
+    }
+
+    hResources.Clear();
+
+    while (ezResourceManager::IsAnyLoadingInProgress())
+    {
+      ezThreadUtils::Sleep(ezTime::MakeFromMilliseconds(10));
+    }
+
+    ezResourceManager::FreeAllUnusedResources();
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
+  };
+
+  ezTime tLoadDirect, tLoadPrefetched;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Load")
+  {
+    *pPrefetchFiles = 0;
+
+    ezStopwatch sw;
+    LoadAll();
+    tLoadDirect = sw.GetRunningTotal();
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Load (Prefetch)")
+  {
+    // also on a single core, to test the prefetching itself
+    *pPrefetchFiles = 2;
+
+    ezStopwatch sw;
+    LoadAll();
+    tLoadPrefetched = sw.GetRunningTotal();
+  }
+
+  ezTestFramework::Output(ezTestOutput::Duration, "Loading %u files: %.2fms direct, %.2fms with prefetching", uiNumResources, tLoadDirect.GetMilliseconds(), tLoadPrefetched.GetMilliseconds());
+
+  ezOSFile::DeleteFolder(sFolder).IgnoreResult();
+}
@@ -1,6 +1,8 @@
 #include <CoreTest/CoreTestPCH.h>
 
 #include <Core/Messages/UpdateLocalBoundsMessage.h>
+#include <Core/World/SpatialSystem_Bvh.h>
+#include <Core/World/SpatialSystem_RegularGrid.h>
 #include <Core/World/World.h>
 #include <Foundation/Containers/HashSet.h>
 #include <Foundation/IO/FileSystem/DataDirTypeFolder.h>
@@ -8,6 +10,7 @@
 #include <Foundation/IO/FileSystem/FileWriter.h>
 #include <Foundation/Profiling/Profiling.h>
 #include <Foundation/Profiling/ProfilingUtils.h>
+#include <Foundation/Time/Stopwatch.h>
 #include <Foundation/Utilities/GraphicsUtils.h>
 
 namespace
@@ -25,13 +28,17 @@ namespace
 
     void OnUpdateLocalBounds(ezMsgUpdateLocalBounds& ref_msg)
     {
-      auto& rng = GetWorld()->GetRandomNumberGenerator();
+      ezVec3 vHalfExtents = m_vHalfExtents;
+      if (vHalfExtents.IsZero())
+      {
+        auto& rng = GetWorld()->GetRandomNumberGenerator();
 
-      float x = (float)rng.DoubleMinMax(1.0, 100.0);
-      float y = (float)rng.DoubleMinMax(1.0, 100.0);
-      float z = (float)rng.DoubleMinMax(1.0, 100.0);
+        vHalfExtents.x = (float)rng.DoubleMinMax(1.0, 100.0);
+        vHalfExtents.y = (float)rng.DoubleMinMax(1.0, 100.0);
+        vHalfExtents.z = (float)rng.DoubleMinMax(1.0, 100.0);
+      }
 
-      ezBoundingBox bounds = ezBoundingBox::MakeFromCenterAndHalfExtents(ezVec3::MakeZero(), ezVec3(x, y, z));
+      ezBoundingBox bounds = ezBoundingBox::MakeFromCenterAndHalfExtents(ezVec3::MakeZero(), vHalfExtents);
 
       ezSpatialData::Category category = m_SpecialCategory;
       if (category == ezInvalidSpatialDataCategory)
@@ -43,6 +50,9 @@ namespace
     }
 
     ezSpatialData::Category m_SpecialCategory = ezInvalidSpatialDataCategory;
+
+    // random extents if zero
+    ezVec3 m_vHalfExtents = ezVec3::MakeZero();
   };
 
   // clang-format off
@@ -58,10 +68,11 @@ namespace
   // clang-format on
 } // namespace
 
-EZ_CREATE_SIMPLE_TEST(World, SpatialSystem)
+static void TestSpatialSystem(ezUniquePtr<ezSpatialSystem> pSpatialSystem)
 {
   ezWorldDesc worldDesc("Test");
   worldDesc.m_uiRandomNumberGeneratorSeed = 5;
+  worldDesc.m_pSpatialSystem = std::move(pSpatialSystem);
 
   ezWorld world(worldDesc);
   EZ_LOCK(world.GetWriteMarker());
@@ -281,6 +292,155 @@ EZ_CREATE_SIMPLE_TEST(World, SpatialSystem)
     }
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "CoherentVisibility")
+  {
+    queryParams.m_uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask() | ezDefaultSpatialDataCategories::RenderDynamic.GetBitmask();
+
+    ezSpatialSystem::QueryParams coherentQueryParams = queryParams;
+    coherentQueryParams.m_pCoherentVisibilityKey = &coherentQueryParams;
+
+    const ezMat4 projection = ezGraphicsUtils::CreatePerspectiveProjectionMatrixFromFovX(ezAngle::MakeFromDegree(80.0f), 1.0f, 1.0f, 10000.0f);
+
+    // deterministic stand-in for an occlusion buffer
+    ezSpatialSystem::IsOccludedFunc isOccluded = [](const ezSimdBBox& box)
+    { return box.m_Min.z() > 0.0f; };
+
+    ezDynamicArray<const ezGameObject*> visibleObjects;
+    ezDynamicArray<const ezGameObject*> coherentVisibleObjects;
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+    ezUInt32 uiNumObjectsTested = 0;
+    ezUInt32 uiNumObjectsTestedCoherent = 0;
+#endif
+
+    for (ezUInt32 uiFrame = 0; uiFrame < 40; ++uiFrame)
+    {
+      // static camera first, then a slowly rotating one
+      const ezAngle rotation = ezAngle::MakeFromDegree(uiFrame < 10 ? 0.0f : (uiFrame - 10) * 0.5f);
+      const ezVec3 vDir = ezQuat::MakeFromAxisAndAngle(ezVec3::MakeAxisZ(), rotation) * ezVec3::MakeAxisX();
+
+      const ezMat4 lookAt = ezGraphicsUtils::CreateLookAtViewMatrix(ezVec3::MakeZero(), vDir, ezVec3::MakeAxisZ());
+      const ezFrustum frustum = ezFrustum::MakeFromMVP(projection * lookAt);
+
+      // the occlusion callback is only used while the camera is static
+      const bool bUseOcclusion = (uiFrame >= 5 && uiFrame < 10);
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+      ezSpatialSystem::QueryStats stats;
+      ezSpatialSystem::QueryStats coherentStats;
+      queryParams.m_pStats = &stats;
+      coherentQueryParams.m_pStats = &coherentStats;
+#endif
+
+      visibleObjects.Clear();
+      world.GetSpatialSystem()->FindVisibleObjects(frustum, queryParams, visibleObjects, bUseOcclusion ? isOccluded : ezSpatialSystem::IsOccludedFunc(), ezVisibilityState::Direct);
+
+      coherentVisibleObjects.Clear();
+      world.GetSpatialSystem()->FindVisibleObjects(frustum, coherentQueryParams, coherentVisibleObjects, bUseOcclusion ? isOccluded : ezSpatialSystem::IsOccludedFunc(), ezVisibilityState::Direct);
+
+      visibleObjects.Sort();
+      coherentVisibleObjects.Sort();
+      EZ_TEST_BOOL(visibleObjects == coherentVisibleObjects);
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+      // the first query has to test everything, afterwards most cells are reused while the camera is static
+      if (uiFrame >= 1 && uiFrame < 5)
+      {
+        uiNumObjectsTested += stats.m_uiNumObjectsTested;
+        uiNumObjectsTestedCoherent += coherentStats.m_uiNumObjectsTested;
+      }
+#endif
+
+      // move some objects, which invalidates their cells
+      if (uiFrame >= 5 && uiFrame % 4 == 3)
+      {
+        for (auto it = world.GetObjects(); it.IsValid(); ++it)
+        {
+          if (it->IsDynamic() && rng.Bool())
+          {
+            constexpr const double range = 500.0f;
+
+            ezVec3 pos = it->GetLocalPosition();
+            pos.x += (float)rng.DoubleMinMax(-range, range);
+            pos.y += (float)rng.DoubleMinMax(-range, range);
+            it->SetLocalPosition(pos);
+          }
+        }
+      }
+
+      world.Update();
+    }
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+    queryParams.m_pStats = nullptr;
+
+    // other spatial systems may ignore the coherency hint
+    if (world.GetSpatialSystem()->IsInstanceOf<ezSpatialSystem_RegularGrid>())
+    {
+      EZ_TEST_BOOL(uiNumObjectsTestedCoherent * 2 < uiNumObjectsTested);
+    }
+#endif
+
+    // visible objects of reused cells are marked as visible as well
+    for (const ezGameObject* pObject : coherentVisibleObjects)
+    {
+      EZ_TEST_BOOL(pObject->GetVisibilityState() == ezVisibilityState::Direct);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "ChangeCounter")
+  {
+    const ezSpatialSystem* pSpatialSystem = world.GetSpatialSystem();
+    const ezUInt32 uiStaticBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask();
+    const ezUInt32 uiDynamicBitmask = ezDefaultSpatialDataCategories::RenderDynamic.GetBitmask();
+
+    const ezVec3 vPos = objects[0]->GetGlobalPosition();
+    const ezBoundingBox worldBox = ezBoundingBox::MakeFromMinMax(ezVec3(-20000.0f), ezVec3(20000.0f));
+    const ezBoundingBox box = ezBoundingBox::MakeFromCenterAndHalfExtents(vPos, ezVec3(200.0f));
+    const ezBoundingBox farBox = ezBoundingBox::MakeFromCenterAndHalfExtents(ezVec3(50000.0f), ezVec3(200.0f));
+
+    const ezUInt64 uiStaticCounter = pSpatialSystem->GetChangeCounter(box, uiStaticBitmask);
+    const ezUInt64 uiFarCounter = pSpatialSystem->GetChangeCounter(farBox, uiStaticBitmask);
+    const ezUInt64 uiDynamicCounter = pSpatialSystem->GetChangeCounter(worldBox, uiDynamicBitmask);
+
+    // nothing changes without modifications
+    world.Update();
+    EZ_TEST_BOOL(pSpatialSystem->GetChangeCounter(box, uiStaticBitmask) == uiStaticCounter);
+    EZ_TEST_BOOL(pSpatialSystem->GetChangeCounter(worldBox, uiDynamicBitmask) == uiDynamicCounter);
+
+    // moving dynamic objects doesn't affect the static category
+    for (ezUInt32 i = 500; i < objects.GetCount(); ++i)
+    {
+      objects[i]->SetLocalPosition(objects[i]->GetLocalPosition() + ezVec3(10.0f, 0.0f, 0.0f));
+    }
+
+    world.Update();
+    EZ_TEST_BOOL(pSpatialSystem->GetChangeCounter(box, uiStaticBitmask) == uiStaticCounter);
+    EZ_TEST_BOOL(pSpatialSystem->GetChangeCounter(worldBox, uiDynamicBitmask) != uiDynamicCounter);
+
+    // adding a static object does
+    {
+      ezGameObjectDesc desc;
+      desc.m_LocalPosition = vPos;
+
+      ezGameObject* pObject = nullptr;
+      world.CreateObject(desc, pObject);
+
+      TestBoundsComponent* pComponent = nullptr;
+      TestBoundsComponent::CreateComponent(pObject, pComponent);
+      pComponent->m_vHalfExtents.Set(1.0f);
+    }
+
+    world.Update();
+    EZ_TEST_BOOL(pSpatialSystem->GetChangeCounter(box, uiStaticBitmask) != uiStaticCounter);
+
+    // other spatial systems may report changes outside of the box
+    if (pSpatialSystem->IsInstanceOf<ezSpatialSystem_RegularGrid>())
+    {
+      EZ_TEST_BOOL(pSpatialSystem->GetChangeCounter(farBox, uiStaticBitmask) == uiFarCounter);
+    }
+  }
+
   if (false)
   {
     ezStringBuilder outputPath = ezTestFramework::GetInstance()->GetAbsOutputPath();
@@ -319,3 +479,242 @@ EZ_CREATE_SIMPLE_TEST(World, SpatialSystem)
     world.Update();
   }
 }
+
+EZ_CREATE_SIMPLE_TEST(World, SpatialSystem)
+{
+  TestSpatialSystem(nullptr);
+}
+
+EZ_CREATE_SIMPLE_TEST(World, SpatialSystem_Bvh)
+{
+  TestSpatialSystem(EZ_NEW(ezFoundation::GetAlignedAllocator(), ezSpatialSystem_Bvh));
+}
+
+EZ_CREATE_SIMPLE_TEST(World, Profile_CoherentVisibility)
+{
+  ezWorldDesc worldDesc("Test");
+  worldDesc.m_uiRandomNumberGeneratorSeed = 7;
+
+  ezWorld world(worldDesc);
+  EZ_LOCK(world.GetWriteMarker());
+
+  auto& rng = world.GetRandomNumberGenerator();
+
+  constexpr ezUInt32 uiNumObjects = 50000;
+  for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+  {
+    constexpr const double range = 1500.0;
+
+    ezGameObjectDesc desc;
+    desc.m_LocalPosition = ezVec3((float)rng.DoubleMinMax(-range, range), (float)rng.DoubleMinMax(-range, range), (float)rng.DoubleMinMax(-200.0, 200.0));
+
+    ezGameObject* pObject = nullptr;
+    world.CreateObject(desc, pObject);
+
+    TestBoundsComponent* pComponent = nullptr;
+    TestBoundsComponent::CreateComponent(pObject, pComponent);
+  }
+
+  world.Update();
+
+  const ezMat4 projection = ezGraphicsUtils::CreatePerspectiveProjectionMatrixFromFovX(ezAngle::MakeFromDegree(80.0f), 1.0f, 1.0f, 5000.0f);
+
+  auto MeasureCulling = [&](const char* szName, bool bCoherent, float fDegreesPerFrame)
+  {
+    constexpr ezUInt32 uiNumFrames = 100;
+
+    ezSpatialSystem::QueryParams queryParams;
+    queryParams.m_uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask();
+    queryParams.m_pCoherentVisibilityKey = bCoherent ? &queryParams : nullptr;
+
+    ezDynamicArray<const ezGameObject*> visibleObjects;
+    ezTime tTotal;
+
+    for (ezUInt32 uiFrame = 0; uiFrame < uiNumFrames; ++uiFrame)
+    {
+      const ezVec3 vDir = ezQuat::MakeFromAxisAndAngle(ezVec3::MakeAxisZ(), ezAngle::MakeFromDegree(uiFrame * fDegreesPerFrame)) * ezVec3::MakeAxisX();
+      const ezMat4 lookAt = ezGraphicsUtils::CreateLookAtViewMatrix(ezVec3::MakeZero(), vDir, ezVec3::MakeAxisZ());
+      const ezFrustum frustum = ezFrustum::MakeFromMVP(projection * lookAt);
+
+      ezStopwatch sw;
+
+      visibleObjects.Clear();
+      world.GetSpatialSystem()->FindVisibleObjects(frustum, queryParams, visibleObjects, {}, ezVisibilityState::Direct);
+
+      // the first frame has to test everything in both modes
+      if (uiFrame > 0)
+      {
+        tTotal += sw.GetRunningTotal();
+      }
+
+      world.Update();
+    }
+
+    ezTestFramework::Output(ezTestOutput::Duration, "%s: %.3fms per frame (%u visible objects)", szName, tTotal.GetMilliseconds() / (uiNumFrames - 1), visibleObjects.GetCount());
+  };
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Static Camera")
+  {
+    MeasureCulling("Regular culling, static camera", false, 0.0f);
+    MeasureCulling("Coherent culling, static camera", true, 0.0f);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Slowly Moving Camera")
+  {
+    MeasureCulling("Regular culling, moving camera", false, 0.2f);
+    MeasureCulling("Coherent culling, moving camera", true, 0.2f);
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(World, Profile_SpatialSystems)
+{
+  struct Result
+  {
+    ezUInt32 m_uiNumVisibleObjects = 0;
+    ezUInt32 m_uiNumObjectsInBoxes = 0;
+    ezUInt32 m_uiNumObjectsInSpheres = 0;
+  };
+
+  // A non-uniform scene: huge terrain chunks, dense clusters of small props and small moving objects spread over the whole level
+  auto Measure = [&](const char* szName, ezUniquePtr<ezSpatialSystem> pSpatialSystem)
+  {
+    ezWorldDesc worldDesc("Test");
+    worldDesc.m_uiRandomNumberGeneratorSeed = 11;
+    worldDesc.m_pSpatialSystem = std::move(pSpatialSystem);
+
+    ezWorld world(worldDesc);
+    EZ_LOCK(world.GetWriteMarker());
+
+    auto& rng = world.GetRandomNumberGenerator();
+
+    auto CreateObject = [&](const ezVec3& vPosition, const ezVec3& vHalfExtents, bool bDynamic)
+    {
+      ezGameObjectDesc desc;
+      desc.m_bDynamic = bDynamic;
+      desc.m_LocalPosition = vPosition;
+
+      ezGameObject* pObject = nullptr;
+      world.CreateObject(desc, pObject);
+
+      TestBoundsComponent* pComponent = nullptr;
+      TestBoundsComponent::CreateComponent(pObject, pComponent);
+      pComponent->m_vHalfExtents = vHalfExtents;
+    };
+
+    constexpr float fLevelSize = 4000.0f;
+
+    for (ezInt32 y = -4; y < 4; ++y)
+    {
+      for (ezInt32 x = -4; x < 4; ++x)
+      {
+        CreateObject(ezVec3((x + 0.5f) * 1000.0f, (y + 0.5f) * 1000.0f, -20.0f), ezVec3(500.0f, 500.0f, 20.0f), false);
+      }
+    }
+
+    for (ezUInt32 uiCluster = 0; uiCluster < 40; ++uiCluster)
+    {
+      const ezVec3 vCenter((float)rng.DoubleMinMax(-fLevelSize, fLevelSize), (float)rng.DoubleMinMax(-fLevelSize, fLevelSize), 0.0f);
+
+      for (ezUInt32 i = 0; i < 1000; ++i)
+      {
+        const ezVec3 vOffset((float)rng.DoubleMinMax(-30.0, 30.0), (float)rng.DoubleMinMax(-30.0, 30.0), (float)rng.DoubleMinMax(0.0, 10.0));
+        CreateObject(vCenter + vOffset, ezVec3((float)rng.DoubleMinMax(0.2, 2.0)), false);
+      }
+    }
+
+    ezDynamicArray<ezGameObject*> dynamicObjects;
+    for (ezUInt32 i = 0; i < 5000; ++i)
+    {
+      CreateObject(ezVec3((float)rng.DoubleMinMax(-fLevelSize, fLevelSize), (float)rng.DoubleMinMax(-fLevelSize, fLevelSize), 2.0f), ezVec3(1.0f), true);
+    }
+
+    for (auto it = world.GetObjects(); it.IsValid(); ++it)
+    {
+      if (it->IsDynamic())
+      {
+        dynamicObjects.PushBack(it);
+      }
+    }
+
+    world.Update();
+
+    constexpr ezUInt32 uiNumFrames = 50;
+    constexpr ezUInt32 uiNumShapeQueries = 200;
+
+    ezSpatialSystem::QueryParams queryParams;
+    queryParams.m_uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask() | ezDefaultSpatialDataCategories::RenderDynamic.GetBitmask();
+
+    const ezMat4 projection = ezGraphicsUtils::CreatePerspectiveProjectionMatrixFromFovX(ezAngle::MakeFromDegree(80.0f), 1.0f, 1.0f, 5000.0f);
+
+    Result result;
+    ezTime tUpdate, tVisibility, tBoxes, tSpheres;
+    ezDynamicArray<const ezGameObject*> visibleObjects;
+    ezDynamicArray<ezGameObject*> objectsInShape;
+
+    for (ezUInt32 uiFrame = 0; uiFrame < uiNumFrames; ++uiFrame)
+    {
+      for (ezGameObject* pObject : dynamicObjects)
+      {
+        pObject->SetLocalPosition(pObject->GetLocalPosition() + ezVec3((float)rng.DoubleMinMax(-5.0, 5.0), (float)rng.DoubleMinMax(-5.0, 5.0), 0.0f));
+      }
+
+      {
+        ezStopwatch sw;
+        world.Update();
+        tUpdate += sw.GetRunningTotal();
+      }
+
+      {
+        const ezVec3 vDir = ezQuat::MakeFromAxisAndAngle(ezVec3::MakeAxisZ(), ezAngle::MakeFromDegree(uiFrame * 7.0f)) * ezVec3(1, 0, -0.2f);
+        const ezMat4 lookAt = ezGraphicsUtils::CreateLookAtViewMatrix(ezVec3(0, 0, 50.0f), ezVec3(0, 0, 50.0f) + vDir, ezVec3::MakeAxisZ());
+        const ezFrustum frustum = ezFrustum::MakeFromMVP(projection * lookAt);
+
+        ezStopwatch sw;
+        visibleObjects.Clear();
+        world.GetSpatialSystem()->FindVisibleObjects(frustum, queryParams, visibleObjects, {}, ezVisibilityState::Direct);
+        tVisibility += sw.GetRunningTotal();
+
+        result.m_uiNumVisibleObjects += visibleObjects.GetCount();
+      }
+
+      for (ezUInt32 i = 0; i < uiNumShapeQueries; ++i)
+      {
+        const ezVec3 vCenter((float)rng.DoubleMinMax(-fLevelSize, fLevelSize), (float)rng.DoubleMinMax(-fLevelSize, fLevelSize), 0.0f);
+
+        {
+          ezStopwatch sw;
+          objectsInShape.Clear();
+          world.GetSpatialSystem()->FindObjectsInBox(ezBoundingBox::MakeFromCenterAndHalfExtents(vCenter, ezVec3(50.0f)), queryParams, objectsInShape);
+          tBoxes += sw.GetRunningTotal();
+
+          result.m_uiNumObjectsInBoxes += objectsInShape.GetCount();
+        }
+
+        {
+          ezStopwatch sw;
+          objectsInShape.Clear();
+          world.GetSpatialSystem()->FindObjectsInSphere(ezBoundingSphere::MakeFromCenterAndRadius(vCenter, 50.0f), queryParams, objectsInShape);
+          tSpheres += sw.GetRunningTotal();
+
+          result.m_uiNumObjectsInSpheres += objectsInShape.GetCount();
+        }
+      }
+    }
+
+    ezTestFramework::Output(ezTestOutput::Duration, "%s: update %.3fms, visibility %.3fms, box queries %.3fms, sphere queries %.3fms per frame",
+      szName, tUpdate.GetMilliseconds() / uiNumFrames, tVisibility.GetMilliseconds() / uiNumFrames, tBoxes.GetMilliseconds() / uiNumFrames, tSpheres.GetMilliseconds() / uiNumFrames);
+
+    return result;
+  };
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Regular Grid vs. BVH")
+  {
+    const Result gridResult = Measure("Regular grid", EZ_NEW(ezFoundation::GetAlignedAllocator(), ezSpatialSystem_RegularGrid));
+    const Result bvhResult = Measure("BVH", EZ_NEW(ezFoundation::GetAlignedAllocator(), ezSpatialSystem_Bvh));
+
+    // both see the same scene, so they have to find the same objects
+    EZ_TEST_INT(gridResult.m_uiNumVisibleObjects, bvhResult.m_uiNumVisibleObjects);
+    EZ_TEST_INT(gridResult.m_uiNumObjectsInBoxes, bvhResult.m_uiNumObjectsInBoxes);
+    EZ_TEST_INT(gridResult.m_uiNumObjectsInSpheres, bvhResult.m_uiNumObjectsInSpheres);
+  }
+}
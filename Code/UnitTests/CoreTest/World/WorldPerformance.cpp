@@ -288,3 +288,60 @@ EZ_CREATE_SIMPLE_TEST(World, Profile_Update)
     }
   }
 }
+
+EZ_CREATE_SIMPLE_TEST(World, Profile_MultiWorldUpdate)
+{
+  EZ_TEST_BLOCK(EnableInRelease, "Update 32 worlds with 10,000 dynamic objects each")
+  {
+    constexpr ezUInt32 uiNumWorlds = 32;
+
+    ezHybridArray<ezUniquePtr<ezWorld>, uiNumWorlds> worlds;
+    ezHybridArray<ezWorld*, uiNumWorlds> worldPtrs;
+
+    for (ezUInt32 i = 0; i < uiNumWorlds; ++i)
+    {
+      ezStringBuilder sName;
+      sName.SetFormat("Match{}", i);
+
+      ezWorldDesc worldDesc(sName);
+      worlds.PushBack(EZ_DEFAULT_NEW(ezWorld, worldDesc));
+      worldPtrs.PushBack(worlds.PeekBack().Borrow());
+
+      EZ_LOCK(worlds.PeekBack()->GetWriteMarker());
+      AddObjectsToWorld(*worlds.PeekBack(), true, 100, 1, 2, 2);
+    }
+
+    const ezUInt32 uiNumWorkerThreads = ezTaskSystem::GetNumAllocatedWorkerThreads(ezWorkerThreadType::ShortTasks);
+
+    ezUInt32 uiNumObjectsPerWorld = 0;
+    {
+      EZ_LOCK(worldPtrs[0]->GetReadMarker());
+      uiNumObjectsPerWorld = worldPtrs[0]->GetObjectCount();
+    }
+
+    for (bool bInParallel : {false, true})
+    {
+      // first round always has some overhead
+      ezWorld::UpdateWorlds(worldPtrs, bInParallel);
+
+      ezStopwatch sw;
+
+      constexpr ezUInt32 uiNumFrames = 10;
+      for (ezUInt32 i = 0; i < uiNumFrames; ++i)
+      {
+        ezWorld::UpdateWorlds(worldPtrs, bInParallel);
+      }
+
+      const ezTime tDiff = sw.Checkpoint() / (double)uiNumFrames;
+
+      ezTestFramework::Output(ezTestOutput::Duration, "Updating %u worlds with %u objects each (%s, %u worker threads): %.2fms", uiNumWorlds,
+        uiNumObjectsPerWorld, bInParallel ? "parallel" : "sequential", uiNumWorkerThreads, tDiff.GetMilliseconds());
+    }
+
+    for (ezWorld* pWorld : worldPtrs)
+    {
+      EZ_LOCK(pWorld->GetReadMarker());
+      EZ_TEST_INT(pWorld->GetUpdateCounter(), 22);
+    }
+  }
+}
@@ -1,6 +1,7 @@
 #include <CoreTest/CoreTestPCH.h>
 
 #include <Core/World/World.h>
+#include <Foundation/Memory/FrameAllocator.h>
 #include <Foundation/Time/Clock.h>
 #include <Foundation/Utilities/GraphicsUtils.h>
 
@@ -624,6 +625,46 @@ EZ_CREATE_SIMPLE_TEST(World, World)
     EZ_TEST_BOOL(!world2.TryGetObjectWithGlobalKey(ezTempHashedString("Deschd"), pObj2));
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Frame Allocator")
+  {
+    struct DestructionCounter
+    {
+      DestructionCounter(ezUInt32* pCounter)
+        : m_pCounter(pCounter)
+      {
+      }
+
+      ~DestructionCounter() { ++(*m_pCounter); }
+
+      ezUInt32* m_pCounter;
+    };
+
+    ezWorldDesc worldDesc1("Test1");
+    ezWorld world1(worldDesc1);
+    EZ_LOCK(world1.GetWriteMarker());
+
+    ezWorldDesc worldDesc2("Test2");
+    ezWorld world2(worldDesc2);
+    EZ_LOCK(world2.GetWriteMarker());
+
+    ezAllocator* pAllocator = world1.GetFrameAllocator();
+    EZ_TEST_BOOL(pAllocator != world2.GetFrameAllocator());
+    EZ_TEST_BOOL(pAllocator != ezFrameAllocator::GetCurrentAllocator());
+
+    ezUInt32 uiNumDestructions = 0;
+    EZ_NEW(pAllocator, DestructionCounter, &uiNumDestructions);
+
+    // allocations stay valid until the end of the next update of the same world
+    world1.Update();
+    world2.Update();
+    EZ_TEST_BOOL(world1.GetFrameAllocator() != pAllocator);
+    EZ_TEST_INT(uiNumDestructions, 0);
+
+    world1.Update();
+    EZ_TEST_BOOL(world1.GetFrameAllocator() == pAllocator);
+    EZ_TEST_INT(uiNumDestructions, 1);
+  }
+
   EZ_TEST_BLOCK(ezTestBlock::Enabled, "Custom coordinate system")
   {
     ezWorldDesc worldDesc("Test");
@@ -62,16 +62,27 @@ public:
 
   std::optional<ezDynamicArray<ezUInt8>> WaitForMessage(ezTime timeout)
   {
-    ezResult res = m_pChannel->WaitForMessages(timeout);
-    if (res.Succeeded())
+    // several messages may arrive while nobody waits, but they only raise the signal once
+    ezStopwatch sw;
+    while (true)
     {
-      EZ_LOCK(m_Mutex);
-      if (m_ReceivedMessages.GetCount() > 0)
-      {
-        auto res2 = m_ReceivedMessages.PeekFront();
-        m_ReceivedMessages.PopFront();
-        return res2;
-      }
+      if (auto res = PopMessage())
+        return res;
+
+      const ezTime remaining = timeout - sw.GetRunningTotal();
+      if (!remaining.IsPositive() || m_pChannel->WaitForMessages(remaining).Failed())
+        return PopMessage();
+    }
+  }
+
+  std::optional<ezDynamicArray<ezUInt8>> PopMessage()
+  {
+    EZ_LOCK(m_Mutex);
+    if (m_ReceivedMessages.GetCount() > 0)
+    {
+      auto res = m_ReceivedMessages.PeekFront();
+      m_ReceivedMessages.PopFront();
+      return res;
     }
     return {};
   }
@@ -259,4 +270,196 @@ EZ_CREATE_SIMPLE_TEST(Communication, IpcChannel_Pipe)
   pServer.Clear();
 }
 
+EZ_CREATE_SIMPLE_TEST(Communication, IpcChannel_SharedMemory)
+{
+  ezUniquePtr<ezIpcChannel> pServer = ezIpcChannel::CreateSharedMemoryChannel("ezEngine_unit_test_shm_channel", ezIpcChannel::Mode::Server);
+  ezUniquePtr<ChannelTester> pServerTester = EZ_DEFAULT_NEW(ChannelTester, pServer.Borrow(), true);
+
+  ezUniquePtr<ezIpcChannel> pClient = ezIpcChannel::CreateSharedMemoryChannel("ezEngine_unit_test_shm_channel", ezIpcChannel::Mode::Client);
+  ezUniquePtr<ChannelTester> pClientTester = EZ_DEFAULT_NEW(ChannelTester, pClient.Borrow(), false);
+
+  TestIPCChannel(pServer.Borrow(), pServerTester.Borrow(), pClient.Borrow(), pClientTester.Borrow());
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Large messages")
+  {
+    pServer->Connect();
+    EZ_TEST_BOOL(pServerTester->WaitForEvents(ezTime::MakeFromSeconds(1)).has_value());
+    pClient->Connect();
+    EZ_TEST_BOOL(pClientTester->WaitForEvents(ezTime::MakeFromSeconds(1)).has_value());
+    EZ_TEST_BOOL(pServerTester->WaitForEvents(ezTime::MakeFromSeconds(1)).has_value());
+    EZ_TEST_BOOL(pClientTester->WaitForEvents(ezTime::MakeFromSeconds(1)).has_value());
+
+    if (EZ_TEST_BOOL(pClient->IsConnected() && pServer->IsConnected()))
+    {
+      // Some messages are bigger than the ring buffers and have to be streamed through them, others wrap around their end.
+      const ezUInt32 uiSizes[] = {3 * 1024 * 1024, 100, 7 * 1024 * 1024 + 13, 12 * 1024 * 1024, 0, 5 * 1024 * 1024 + 1};
+
+      for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(uiSizes); ++i)
+      {
+        ezDynamicArray<ezUInt8> msg;
+        msg.SetCountUninitialized(uiSizes[i]);
+        for (ezUInt32 b = 0; b < uiSizes[i]; ++b)
+        {
+          msg[b] = static_cast<ezUInt8>(b * 13 + i);
+        }
+
+        EZ_TEST_BOOL(pClient->Send(msg));
+      }
+
+      for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(uiSizes); ++i)
+      {
+        // the server echoes every message
+        auto res = pClientTester->WaitForMessage(ezTime::MakeFromSeconds(10));
+
+        if (!EZ_TEST_BOOL(res.has_value()))
+          break;
+
+        const ezDynamicArray<ezUInt8>& msg = res.value();
+        EZ_TEST_INT(msg.GetCount(), uiSizes[i]);
+
+        bool bContentMatches = msg.GetCount() == uiSizes[i];
+        for (ezUInt32 b = 0; bContentMatches && b < uiSizes[i]; ++b)
+        {
+          bContentMatches = msg[b] == static_cast<ezUInt8>(b * 13 + i);
+        }
+
+        EZ_TEST_BOOL(bContentMatches);
+      }
+    }
+
+    pClient->Disconnect();
+    EZ_TEST_BOOL(pServerTester->WaitForEvents(ezTime::MakeFromSeconds(1)).has_value());
+  }
+
+  pClientTester.Clear();
+  pClient.Clear();
+
+  pServerTester.Clear();
+  pServer.Clear();
+}
+
+namespace
+{
+  struct IpcChannelProfileReceiver
+  {
+    void OnMessage(ezArrayPtr<const ezUInt8> data)
+    {
+      m_iBytes.Add(data.GetCount());
+
+      if (m_iMessages.Increment() == m_iExpectedMessages)
+      {
+        m_AllReceived.RaiseSignal();
+      }
+    }
+
+    ezAtomicInteger64 m_iBytes;
+    ezAtomicInteger32 m_iMessages;
+    ezInt32 m_iExpectedMessages = 0;
+    ezThreadSignal m_AllReceived;
+  };
+
+  bool ConnectIpcChannelProfileChannels(ezIpcChannel* pServer, ezIpcChannel* pClient)
+  {
+    pServer->Connect();
+
+    ezStopwatch sw;
+    while (pServer->GetConnectionState() != ezIpcChannel::ConnectionState::Connecting)
+    {
+      if (sw.GetRunningTotal() > ezTime::MakeFromSeconds(2))
+        return false;
+
+      ezThreadUtils::Sleep(ezTime::MakeFromMilliseconds(1));
+    }
+
+    pClient->Connect();
+
+    while (!pServer->IsConnected() || !pClient->IsConnected())
+    {
+      if (sw.GetRunningTotal() > ezTime::MakeFromSeconds(2))
+        return false;
+
+      ezThreadUtils::Sleep(ezTime::MakeFromMilliseconds(1));
+    }
+
+    return true;
+  }
+
+  /// Sends the messages from the client to the server and returns the time until all of them arrived.
+  ezTime MeasureIpcChannelTransfer(ezIpcChannel* pClient, IpcChannelProfileReceiver& ref_receiver, ezUInt32 uiMessageSize, ezUInt32 uiNumMessages)
+  {
+    ezDynamicArray<ezUInt8> msg;
+    msg.SetCount(uiMessageSize, 0x7F);
+
+    ref_receiver.m_iBytes = 0;
+    ref_receiver.m_iMessages = 0;
+    ref_receiver.m_iExpectedMessages = static_cast<ezInt32>(uiNumMessages);
+    ref_receiver.m_AllReceived.ClearSignal();
+
+    ezStopwatch sw;
+
+    for (ezUInt32 i = 0; i < uiNumMessages; ++i)
+    {
+      pClient->Send(msg);
+    }
+
+    if (ref_receiver.m_AllReceived.WaitForSignal(ezTime::MakeFromSeconds(30)) == ezThreadSignal::WaitResult::Timeout)
+      return ezTime::MakeZero();
+
+    const ezTime tDuration = sw.GetRunningTotal();
+    EZ_TEST_INT(ref_receiver.m_iBytes, static_cast<ezInt64>(uiMessageSize) * uiNumMessages);
+    return tDuration;
+  }
+
+  void ProfileIpcChannel(const char* szName, ezUniquePtr<ezIpcChannel> pServer, ezUniquePtr<ezIpcChannel> pClient)
+  {
+    if (pServer == nullptr || pClient == nullptr)
+      return;
+
+    IpcChannelProfileReceiver receiver;
+    pServer->SetReceiveCallback(ezMakeDelegate(&IpcChannelProfileReceiver::OnMessage, &receiver));
+
+    if (ConnectIpcChannelProfileChannels(pServer.Borrow(), pClient.Borrow()))
+    {
+      // many small messages, as sent for object changes and input, and few large ones, as sent for viewport images
+      constexpr ezUInt32 uiSmallSize = 64;
+      constexpr ezUInt32 uiNumSmall = 100000;
+      constexpr ezUInt32 uiLargeSize = 4 * 1024 * 1024;
+      constexpr ezUInt32 uiNumLarge = 64;
+
+      const ezTime tSmall = MeasureIpcChannelTransfer(pClient.Borrow(), receiver, uiSmallSize, uiNumSmall);
+      const ezTime tLarge = MeasureIpcChannelTransfer(pClient.Borrow(), receiver, uiLargeSize, uiNumLarge);
+
+      if (EZ_TEST_BOOL(tSmall.IsPositive() && tLarge.IsPositive()))
+      {
+        ezTestFramework::Output(ezTestOutput::Duration, "%s: %u x %u bytes in %.2fms, %.0f messages/s", szName, uiNumSmall, uiSmallSize,
+          tSmall.GetMilliseconds(), uiNumSmall / tSmall.GetSeconds());
+        ezTestFramework::Output(ezTestOutput::Duration, "%s: %u x %u MB in %.2fms, %.0f MB/s", szName, uiNumLarge, uiLargeSize / (1024 * 1024),
+          tLarge.GetMilliseconds(), (static_cast<double>(uiLargeSize) * uiNumLarge / (1024.0 * 1024.0)) / tLarge.GetSeconds());
+      }
+    }
+    else
+    {
+      ezTestFramework::Output(ezTestOutput::Details, "%s: could not connect in process, skipped", szName);
+    }
+
+    pClient->Disconnect();
+    pServer->Disconnect();
+    pServer->SetReceiveCallback({});
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(Communication, IpcChannel_Profile)
+{
+  ProfileIpcChannel("Pipe", ezIpcChannel::CreatePipeChannel("ezEngine_unit_test_profile_pipe", ezIpcChannel::Mode::Server),
+    ezIpcChannel::CreatePipeChannel("ezEngine_unit_test_profile_pipe", ezIpcChannel::Mode::Client));
+
+  ProfileIpcChannel("Shared memory", ezIpcChannel::CreateSharedMemoryChannel("ezEngine_unit_test_profile_shm", ezIpcChannel::Mode::Server),
+    ezIpcChannel::CreateSharedMemoryChannel("ezEngine_unit_test_profile_shm", ezIpcChannel::Mode::Client));
+
+#  ifdef BUILDSYSTEM_ENABLE_ENET_SUPPORT
+  ProfileIpcChannel("Network", ezIpcChannel::CreateNetworkChannel("127.0.0.1:1051", ezIpcChannel::Mode::Server),
+    ezIpcChannel::CreateNetworkChannel("127.0.0.1:1051", ezIpcChannel::Mode::Client));
+#  endif
+}
+
 #endif
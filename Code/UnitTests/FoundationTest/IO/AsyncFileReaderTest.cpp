@@ -0,0 +1,281 @@
+#include <FoundationTest/FoundationTestPCH.h>
+
+#include <Foundation/IO/AsyncFileReader.h>
+#include <Foundation/IO/OSFile.h>
+#include <Foundation/Time/Stopwatch.h>
+
+namespace
+{
+  struct AsyncFileReaderTestResults
+  {
+    ezMutex m_Mutex;
+    ezDynamicArray<ezResult> m_Results;
+    ezDynamicArray<ezDynamicArray<ezUInt8>> m_Data;
+    ezAtomicInteger32 m_iNumCallbacks;
+
+    void Reset(ezUInt32 uiNumRequests)
+    {
+      m_Results.Clear();
+      m_Results.SetCount(uiNumRequests, EZ_FAILURE);
+      m_Data.Clear();
+      m_Data.SetCount(uiNumRequests);
+      m_iNumCallbacks = 0;
+    }
+
+    void OnFinished(ezAsyncFileReadResult& ref_result)
+    {
+      m_iNumCallbacks.Increment();
+
+      EZ_LOCK(m_Mutex);
+      m_Results[ref_result.m_uiRequestIndex] = ref_result.m_Result;
+      m_Data[ref_result.m_uiRequestIndex] = std::move(ref_result.m_Data);
+    }
+  };
+
+  ezResult WriteAsyncFileReaderTestFile(ezStringView sPath, ezUInt32 uiSize, ezUInt8 uiSeed)
+  {
+    ezDynamicArray<ezUInt8> data;
+    data.SetCountUninitialized(uiSize);
+    for (ezUInt32 i = 0; i < uiSize; ++i)
+    {
+      data[i] = static_cast<ezUInt8>(i * 7 + uiSeed);
+    }
+
+    ezOSFile file;
+    EZ_SUCCEED_OR_RETURN(file.Open(sPath, ezFileOpenMode::Write));
+    return data.IsEmpty() ? EZ_SUCCESS : file.Write(data.GetData(), data.GetCount());
+  }
+
+  bool CheckAsyncFileReaderTestData(ezArrayPtr<const ezUInt8> data, ezUInt32 uiOffset, ezUInt32 uiSize, ezUInt8 uiSeed)
+  {
+    if (data.GetCount() != uiSize)
+      return false;
+
+    for (ezUInt32 i = 0; i < uiSize; ++i)
+    {
+      if (data[i] != static_cast<ezUInt8>((uiOffset + i) * 7 + uiSeed))
+        return false;
+    }
+
+    return true;
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(IO, AsyncFileReader)
+{
+  ezStringBuilder sFolder = ezTestFramework::GetInstance()->GetAbsOutputPath();
+  sFolder.MakeCleanPath();
+  sFolder.AppendPath("IO", "AsyncFileReader");
+
+  ezOSFile::DeleteFolder(sFolder).IgnoreResult();
+  if (!EZ_TEST_BOOL(ezOSFile::CreateDirectoryStructure(sFolder).Succeeded()))
+    return;
+
+  ezAsyncFileReader reader;
+  ezTestFramework::Output(ezTestOutput::Details, "Native read queue: %s", reader.IsUsingNativeQueue() ? "yes" : "no");
+
+  AsyncFileReaderTestResults results;
+
+  const ezUInt32 uiFileSizes[] = {0, 1, 4095, 4096, 100 * 1000, 3 * 1024 * 1024 + 17};
+
+  ezStringBuilder sFile;
+  ezDynamicArray<ezAsyncFileReadRequest> requests;
+
+  for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(uiFileSizes); ++i)
+  {
+    sFile.SetFormat("{}/File{}.dat", sFolder, i);
+    EZ_TEST_BOOL(WriteAsyncFileReaderTestFile(sFile, uiFileSizes[i], static_cast<ezUInt8>(i)).Succeeded());
+
+    ezAsyncFileReadRequest& request = requests.ExpandAndGetRef();
+    request.m_sAbsolutePath = sFile;
+    request.m_OnFinished = ezMakeDelegate(&AsyncFileReaderTestResults::OnFinished, &results);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Whole files")
+  {
+    results.Reset(requests.GetCount());
+    ezTaskSystem::WaitForGroup(reader.ReadBatch(requests));
+
+    EZ_TEST_INT(results.m_iNumCallbacks, requests.GetCount());
+
+    for (ezUInt32 i = 0; i < requests.GetCount(); ++i)
+    {
+      EZ_TEST_BOOL(results.m_Results[i].Succeeded());
+      EZ_TEST_BOOL(CheckAsyncFileReaderTestData(results.m_Data[i], 0, uiFileSizes[i], static_cast<ezUInt8>(i)));
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Ranges")
+  {
+    ezDynamicArray<ezAsyncFileReadRequest> ranges;
+    ranges.PushBack(requests[5]);
+    ranges.PushBack(requests[5]);
+    ranges.PushBack(requests[5]);
+    ranges.PushBack(requests[4]);
+
+    ranges[0].m_uiOffset = 1000;
+    ranges[0].m_uiSize = 1024 * 1024;
+    ranges[1].m_uiOffset = uiFileSizes[5] - 10;
+    ranges[2].m_uiOffset = uiFileSizes[5] + 10;
+    ranges[3].m_uiOffset = 99 * 1000;
+    ranges[3].m_uiSize = 5000;
+
+    results.Reset(ranges.GetCount());
+    ezTaskSystem::WaitForGroup(reader.ReadBatch(ranges));
+
+    EZ_TEST_BOOL(CheckAsyncFileReaderTestData(results.m_Data[0], 1000, 1024 * 1024, 5));
+    EZ_TEST_BOOL(CheckAsyncFileReaderTestData(results.m_Data[1], uiFileSizes[5] - 10, 10, 5));
+    EZ_TEST_BOOL(results.m_Results[2].Succeeded());
+    EZ_TEST_INT(results.m_Data[2].GetCount(), 0);
+    EZ_TEST_BOOL(CheckAsyncFileReaderTestData(results.m_Data[3], 99 * 1000, 1000, 4));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Missing file")
+  {
+    ezDynamicArray<ezAsyncFileReadRequest> missing;
+    missing.PushBack(requests[3]);
+    missing.PushBack(requests[3]);
+    missing[0].m_sAbsolutePath = ezStringBuilder(sFolder, "/DoesNotExist.dat");
+
+    results.Reset(missing.GetCount());
+    ezTaskSystem::WaitForGroup(reader.ReadBatch(missing));
+
+    EZ_TEST_BOOL(results.m_Results[0].Failed());
+    EZ_TEST_BOOL(results.m_Results[1].Succeeded());
+    EZ_TEST_BOOL(CheckAsyncFileReaderTestData(results.m_Data[1], 0, uiFileSizes[3], 3));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Concurrent batches")
+  {
+    // more requests than reads in flight, spread over several batches that run at the same time
+    reader.SetMaxReadsInFlight(4);
+
+    ezDynamicArray<ezAsyncFileReadRequest> many;
+    for (ezUInt32 i = 0; i < 200; ++i)
+    {
+      many.PushBack(requests[i % requests.GetCount()]);
+    }
+
+    results.Reset(many.GetCount() * 2);
+
+    AsyncFileReaderTestResults results2;
+    results2.Reset(many.GetCount());
+
+    reader.ReadBatch(many);
+
+    for (auto& request : many)
+    {
+      request.m_OnFinished = ezMakeDelegate(&AsyncFileReaderTestResults::OnFinished, &results2);
+    }
+
+    reader.ReadBatch(many);
+    reader.WaitForAll();
+
+    EZ_TEST_INT(results.m_iNumCallbacks, many.GetCount());
+    EZ_TEST_INT(results2.m_iNumCallbacks, many.GetCount());
+
+    for (ezUInt32 i = 0; i < many.GetCount(); ++i)
+    {
+      const ezUInt32 uiFile = i % requests.GetCount();
+      EZ_TEST_BOOL(CheckAsyncFileReaderTestData(results.m_Data[i], 0, uiFileSizes[uiFile], static_cast<ezUInt8>(uiFile)));
+      EZ_TEST_BOOL(CheckAsyncFileReaderTestData(results2.m_Data[i], 0, uiFileSizes[uiFile], static_cast<ezUInt8>(uiFile)));
+    }
+
+    reader.SetMaxReadsInFlight(64);
+  }
+
+  ezOSFile::DeleteFolder(sFolder).IgnoreResult();
+}
+
+EZ_CREATE_SIMPLE_TEST(IO, AsyncFileReader_Profile)
+{
+  // a typical asset folder, thousands of small files and some larger ones
+  constexpr ezUInt32 uiNumFiles = 4000;
+
+  ezStringBuilder sFolder = ezTestFramework::GetInstance()->GetAbsOutputPath();
+  sFolder.MakeCleanPath();
+  sFolder.AppendPath("IO", "AsyncFileReaderProfile");
+
+  ezOSFile::DeleteFolder(sFolder).IgnoreResult();
+  if (!EZ_TEST_BOOL(ezOSFile::CreateDirectoryStructure(sFolder).Succeeded()))
+    return;
+
+  ezDynamicArray<ezAsyncFileReadRequest> requests;
+  ezUInt64 uiTotalSize = 0;
+
+  ezStringBuilder sFile;
+  for (ezUInt32 i = 0; i < uiNumFiles; ++i)
+  {
+    const ezUInt32 uiSize = (i % 50 == 0) ? 1024 * 1024 : 4096 + (i * 1237) % (64 * 1024);
+    uiTotalSize += uiSize;
+
+    sFile.SetFormat("{}/File{}.dat", sFolder, i);
+    if (!EZ_TEST_BOOL(WriteAsyncFileReaderTestFile(sFile, uiSize, static_cast<ezUInt8>(i)).Succeeded()))
+      return;
+
+    requests.ExpandAndGetRef().m_sAbsolutePath = sFile;
+  }
+
+  ezAtomicInteger64 iBytesRead;
+  for (auto& request : requests)
+  {
+    request.m_OnFinished = [&](ezAsyncFileReadResult& ref_result)
+    { iBytesRead.Add(ref_result.m_Data.GetCount()); };
+  }
+
+  // the files were just written, so all variants read from the page cache and mostly measure the per-file overhead
+  ezTime tBlocking;
+  {
+    ezStopwatch sw;
+
+    ezDynamicArray<ezUInt8> data;
+    ezUInt64 uiBytesRead = 0;
+    for (const auto& request : requests)
+    {
+      ezOSFile file;
+      if (file.Open(request.m_sAbsolutePath, ezFileOpenMode::Read).Succeeded())
+      {
+        uiBytesRead += file.ReadAll(data);
+      }
+    }
+
+    tBlocking = sw.GetRunningTotal();
+    EZ_TEST_INT(uiBytesRead, uiTotalSize);
+  }
+
+  ezAsyncFileReader reader;
+
+  ezTime tAsync;
+  {
+    ezStopwatch sw;
+
+    ezTaskSystem::WaitForGroup(reader.ReadBatch(requests));
+
+    tAsync = sw.GetRunningTotal();
+    EZ_TEST_INT(iBytesRead, uiTotalSize);
+  }
+
+  ezTime tAsyncBatches;
+  {
+    iBytesRead = 0;
+    ezStopwatch sw;
+
+    // many small batches, as they are created by the resource manager
+    for (ezUInt32 i = 0; i < requests.GetCount(); i += 32)
+    {
+      reader.ReadBatch(requests.GetArrayPtr().GetSubArray(i, ezMath::Min(32u, requests.GetCount() - i)));
+    }
+
+    reader.WaitForAll();
+
+    tAsyncBatches = sw.GetRunningTotal();
+    EZ_TEST_INT(iBytesRead, uiTotalSize);
+  }
+
+  ezTestFramework::Output(ezTestOutput::Details, "%u files, %.1f MB, native read queue: %s", uiNumFiles, uiTotalSize / (1024.0 * 1024.0), reader.IsUsingNativeQueue() ? "yes" : "no");
+  ezTestFramework::Output(ezTestOutput::Duration, "Blocking reads: %.2fms", tBlocking.GetMilliseconds());
+  ezTestFramework::Output(ezTestOutput::Duration, "One batch: %.2fms", tAsync.GetMilliseconds());
+  ezTestFramework::Output(ezTestOutput::Duration, "Batches of 32: %.2fms", tAsyncBatches.GetMilliseconds());
+
+  ezOSFile::DeleteFolder(sFolder).IgnoreResult();
+}
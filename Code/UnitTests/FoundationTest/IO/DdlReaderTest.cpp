@@ -50,6 +50,13 @@ static void WriteObjectToDDL(const ezOpenDdlReaderElement* pElement, ezOpenDdlWr
 
     ref_writer.BeginPrimitiveList(type, pElement->GetName(), pElement->IsNameGlobal());
 
+    if (pElement->GetNumPrimitives() == 0)
+    {
+      // the writer doesn't accept empty arrays
+      ref_writer.EndPrimitiveList();
+      return;
+    }
+
     switch (type)
     {
       case ezOpenDdlPrimitiveType::Bool:
@@ -294,6 +301,115 @@ unsigned_int64{0,100002111,300040222,560000003333,70000844444,1000009555555,1000
     EZ_TEST_BOOL(!doc.HadFatalParsingError());
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Binary")
+  {
+    const char* szTestData = "\
+Node\n\
+{\n\
+	float %MyFloats{1.2,3,40,0.5,60}\n\
+	double $MyDoubles{1.2,3,40,0.5,60}\n\
+	Empty\n\
+	{\n\
+		int32{}\n\
+		string{}\n\
+	}\n\
+}\n\
+bool{true,false,true,true,false}\n\
+string $Strings{\"s1\",\"\\n\\t\\r\",\"\"}\n\
+int8{0,12,34,56,78,109,127,-14,-56,-127}\n\
+int16{0,102,3040,5600,7008,109,10207,-1004,-5060,-10207}\n\
+int64{0,100002111,300040222,560000003333,70000844444,1000009555555,100000207666666,-1000000047777777,-50600000008888888,-102070000099999}\n\
+unsigned_int8{0,12,34,56,78,109,127,255,156,207}\n\
+unsigned_int16{0,102,3040,56000,7008,109,10207,40004,50600,10207}\n\
+unsigned_int32{0,100002,300040,56000000,700008,1000009,100000207,100000004,2000001000,1020700000}\n\
+";
+
+    StringStream stream(szTestData);
+
+    ezOpenDdlReader textDoc;
+    EZ_TEST_BOOL(textDoc.ParseDocument(stream).Succeeded());
+
+    ezContiguousMemoryStreamStorage storage;
+    {
+      ezMemoryStreamWriter output(&storage);
+
+      ezOpenDdlWriter writer;
+      writer.SetOutputStream(&output);
+      writer.SetBinaryMode(true);
+
+      for (auto pChild = textDoc.GetRootElement()->GetFirstChild(); pChild != nullptr; pChild = pChild->GetSibling())
+      {
+        ezOpenDdlUtils::StoreElement(writer, pChild);
+      }
+    }
+
+    const ezConstByteArrayPtr binaryData(storage.GetData(), storage.GetStorageSize32());
+    EZ_TEST_BOOL(ezOpenDdlReader::IsBinaryDocument(binaryData));
+    EZ_TEST_BOOL(!ezOpenDdlReader::IsBinaryDocument(ezMakeArrayPtr(reinterpret_cast<const ezUInt8*>(szTestData), 16u)));
+
+    // binary documents are detected automatically
+    {
+      ezMemoryStreamReader input(&storage);
+
+      ezOpenDdlReader doc;
+      EZ_TEST_BOOL(doc.ParseDocument(input).Succeeded());
+
+      TestDoc(doc, szTestData);
+      EZ_TEST_BOOL(doc.FindElement("MyDoubles") != nullptr);
+      EZ_TEST_BOOL(doc.FindElement("Strings") != nullptr);
+      EZ_TEST_BOOL(doc.FindElement("MyFloats") == nullptr);
+    }
+
+    // reading from memory doesn't copy the primitives
+    {
+      ezOpenDdlReader doc;
+      EZ_TEST_BOOL(doc.ParseBinaryDocument(binaryData).Succeeded());
+
+      TestDoc(doc, szTestData);
+
+      const ezOpenDdlReaderElement* pDoubles = doc.FindElement("MyDoubles");
+      if (EZ_TEST_BOOL(pDoubles != nullptr && pDoubles->HasPrimitives(ezOpenDdlPrimitiveType::Double, 5)))
+      {
+        const ezUInt8* pData = reinterpret_cast<const ezUInt8*>(pDoubles->GetPrimitivesDouble());
+        EZ_TEST_BOOL(pData > binaryData.GetPtr() && pData < binaryData.GetPtr() + binaryData.GetCount());
+        EZ_TEST_BOOL(ezMemoryUtils::IsAligned(pData, sizeof(double)));
+        EZ_TEST_DOUBLE(pDoubles->GetPrimitivesDouble()[3], 0.5, 0.0);
+      }
+
+      // strings are zero terminated, just like in text documents
+      const ezOpenDdlReaderElement* pStrings = doc.FindElement("Strings");
+      if (EZ_TEST_BOOL(pStrings != nullptr && pStrings->HasPrimitives(ezOpenDdlPrimitiveType::String, 3)))
+      {
+        EZ_TEST_STRING(pStrings->GetPrimitivesString()[0].GetStartPointer(), "s1");
+        EZ_TEST_STRING(pStrings->GetPrimitivesString()[1], "\n\t\r");
+        EZ_TEST_BOOL(pStrings->GetPrimitivesString()[2].IsEmpty());
+      }
+    }
+
+    // misaligned data is copied
+    {
+      ezDynamicArray<ezUInt8> misaligned;
+      misaligned.SetCount(binaryData.GetCount() + 1);
+      ezMemoryUtils::Copy(misaligned.GetData() + 1, binaryData.GetPtr(), binaryData.GetCount());
+
+      ezOpenDdlReader doc;
+      EZ_TEST_BOOL(doc.ParseBinaryDocument(misaligned.GetArrayPtr().GetSubArray(1)).Succeeded());
+
+      TestDoc(doc, szTestData);
+    }
+
+    // truncated documents are rejected
+    {
+      ezMuteLog log;
+
+      for (ezUInt32 uiSize : {9u, 20u, binaryData.GetCount() - 1})
+      {
+        ezOpenDdlReader doc;
+        EZ_TEST_BOOL(doc.ParseBinaryDocument(binaryData.GetSubArray(0, uiSize), &log).Failed());
+      }
+    }
+  }
+
   EZ_TEST_BLOCK(ezTestBlock::Enabled, "Errors")
   {
     const char* szTestData = "\
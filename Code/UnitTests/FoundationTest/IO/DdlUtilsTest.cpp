@@ -638,6 +638,59 @@ TempHashedString $v14 { uint64 { 2720389094277464445 } }\
       EZ_TEST_BOOL(var == result);
     }
   }
+
+  //////////////////////////////////////////////////////////////////////////
+  //////////////////////////////////////////////////////////////////////////
+  //////////////////////////////////////////////////////////////////////////
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "ConvertToBinary / ConvertToText")
+  {
+    const char* szText = "\
+Transform $t\n\
+{\n\
+\tfloat{0x3F800000,0,0xC0490FDB,0x7F7FFFFF}\n\
+\tdouble %d{0x400921FB54442D18,0}\n\
+}\n\
+Values\n\
+{\n\
+\tstring{\"first\",\"second \\\"quoted\\\"\",\"\"}\n\
+\tuint64{18446744073709551615,0}\n\
+\tint16{}\n\
+\tEmpty{}\n\
+}\n\
+";
+
+    ezContiguousMemoryStreamStorage textStorage;
+    ezContiguousMemoryStreamStorage binaryStorage;
+    ezContiguousMemoryStreamStorage textStorage2;
+
+    {
+      StringStream input(szText);
+      ezMemoryStreamWriter output(&binaryStorage);
+      EZ_TEST_BOOL(ezOpenDdlUtils::ConvertToBinary(input, output).Succeeded());
+    }
+
+    EZ_TEST_BOOL(ezOpenDdlReader::IsBinaryDocument(ezConstByteArrayPtr(binaryStorage.GetData(), binaryStorage.GetStorageSize32())));
+
+    {
+      ezMemoryStreamReader input(&binaryStorage);
+      ezMemoryStreamWriter output(&textStorage);
+      EZ_TEST_BOOL(ezOpenDdlUtils::ConvertToText(input, output).Succeeded());
+    }
+
+    ezStringBuilder sRoundTrip;
+    sRoundTrip.SetSubString_ElementCount(reinterpret_cast<const char*>(textStorage.GetData()), textStorage.GetStorageSize32());
+    EZ_TEST_STRING(sRoundTrip, szText);
+
+    // text to text works as well
+    {
+      ezMemoryStreamReader input(&textStorage);
+      ezMemoryStreamWriter output(&textStorage2);
+      EZ_TEST_BOOL(ezOpenDdlUtils::ConvertToText(input, output).Succeeded());
+    }
+
+    EZ_TEST_INT(textStorage2.GetStorageSize32(), textStorage.GetStorageSize32());
+  }
 }
 
 static ezVariant CreateVariant(ezVariant::Type::Enum t, const void* pData)
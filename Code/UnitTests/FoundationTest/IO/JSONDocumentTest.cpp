@@ -0,0 +1,382 @@
+#include <FoundationTest/FoundationTestPCH.h>
+
+// NOTE: always save as Unicode UTF-8 with signature
+
+#include <Foundation/IO/JSONDocument.h>
+#include <Foundation/IO/JSONReader.h>
+#include <Foundation/IO/MemoryStream.h>
+#include <Foundation/Types/Variant.h>
+
+namespace JSONDocumentTestDetail
+{
+  void CompareVariants(const ezVariant& expected, const ezVariant& actual)
+  {
+    if (!EZ_TEST_BOOL(expected.GetType() == actual.GetType()))
+      return;
+
+    switch (expected.GetType())
+    {
+      case ezVariant::Type::VariantDictionary:
+      {
+        const ezVariantDictionary& expectedDict = expected.Get<ezVariantDictionary>();
+        const ezVariantDictionary& actualDict = actual.Get<ezVariantDictionary>();
+
+        EZ_TEST_INT(expectedDict.GetCount(), actualDict.GetCount());
+
+        for (auto it = expectedDict.GetIterator(); it.IsValid(); ++it)
+        {
+          const ezVariant* pActual = actualDict.GetValue(it.Key());
+          if (EZ_TEST_BOOL_MSG(pActual != nullptr, "Member '%s' is missing", it.Key().GetData()))
+          {
+            CompareVariants(it.Value(), *pActual);
+          }
+        }
+      }
+      break;
+
+      case ezVariant::Type::VariantArray:
+      {
+        const ezVariantArray& expectedArray = expected.Get<ezVariantArray>();
+        const ezVariantArray& actualArray = actual.Get<ezVariantArray>();
+
+        if (EZ_TEST_INT(expectedArray.GetCount(), actualArray.GetCount()))
+        {
+          for (ezUInt32 i = 0; i < expectedArray.GetCount(); ++i)
+          {
+            CompareVariants(expectedArray[i], actualArray[i]);
+          }
+        }
+      }
+      break;
+
+      case ezVariant::Type::Double:
+        EZ_TEST_DOUBLE(expected.Get<double>(), actual.Get<double>(), ezMath::Abs(expected.Get<double>()) * 1e-12);
+        break;
+
+      default:
+        EZ_TEST_BOOL(expected == actual);
+        break;
+    }
+  }
+
+  ezVariant ReadWithJSONReader(ezStringView sJson)
+  {
+    ezRawMemoryStreamReader stream(sJson.GetStartPointer(), sJson.GetElementCount());
+
+    ezJSONReader reader;
+    if (reader.Parse(stream).Failed())
+      return ezVariant();
+
+    if (reader.GetTopLevelElementType() == ezJSONReader::ElementType::Array)
+      return reader.GetTopLevelArray();
+
+    return reader.GetTopLevelObject();
+  }
+
+  /// Generates documents with deep nesting and strings with lots of escape sequences and runs of backslashes,
+  /// so that all cases of the structural index end up at the boundary of a 64 byte block at some point.
+  class DocumentGenerator
+  {
+  public:
+    explicit DocumentGenerator(ezUInt32 uiSeed)
+      : m_uiState(uiSeed)
+    {
+    }
+
+    void GenerateObject(ezStringBuilder& inout_sJson, ezUInt32 uiDepth)
+    {
+      inout_sJson.Append("{");
+      Whitespace(inout_sJson);
+
+      const ezUInt32 uiNumMembers = Random(uiDepth < 4 ? 6 : 2);
+      for (ezUInt32 i = 0; i < uiNumMembers; ++i)
+      {
+        if (i > 0)
+        {
+          inout_sJson.Append(",");
+          Whitespace(inout_sJson);
+        }
+
+        // the index keeps member names unique, the reader and the document would keep different duplicates otherwise
+        inout_sJson.AppendFormat("\"{}", i);
+        String(inout_sJson);
+        inout_sJson.Append(":");
+        Whitespace(inout_sJson);
+        Value(inout_sJson, uiDepth + 1);
+      }
+
+      Whitespace(inout_sJson);
+      inout_sJson.Append("}");
+    }
+
+  private:
+    ezUInt32 Random(ezUInt32 uiRange)
+    {
+      m_uiState = m_uiState * 1664525u + 1013904223u;
+      return (m_uiState >> 8) % uiRange;
+    }
+
+    void Whitespace(ezStringBuilder& inout_sJson)
+    {
+      static const char* s_Whitespace[] = {"", " ", "\n", "\t", "\r\n  ", "    "};
+      inout_sJson.Append(s_Whitespace[Random(EZ_ARRAY_SIZE(s_Whitespace))]);
+    }
+
+    // appends the rest of a string, the opening quote must already be there
+    void String(ezStringBuilder& inout_sJson)
+    {
+      static const char* s_Parts[] = {"a", "text", " ", "\\\"", "\\\\", "\\\\\\\\", "\\\\\\\"", "\\n", "\\t", "\\/", "\\u00e4", "\\uD83D\\uDE00", "\xC3\xB6", "{", "}", "[", "]", ",", ":", "//", "/*"};
+
+      const ezUInt32 uiNumParts = Random(12);
+      for (ezUInt32 i = 0; i < uiNumParts; ++i)
+      {
+        inout_sJson.Append(s_Parts[Random(EZ_ARRAY_SIZE(s_Parts))]);
+      }
+
+      inout_sJson.Append("\"");
+    }
+
+    void Value(ezStringBuilder& inout_sJson, ezUInt32 uiDepth)
+    {
+      switch (Random(uiDepth < 5 ? 9 : 7))
+      {
+        case 0:
+          inout_sJson.Append("true");
+          break;
+        case 1:
+          inout_sJson.Append("false");
+          break;
+        case 2:
+          inout_sJson.Append("null");
+          break;
+        case 3:
+          inout_sJson.AppendFormat("{}", static_cast<ezInt32>(Random(2000000)) - 1000000);
+          break;
+        case 4:
+          inout_sJson.AppendFormat("{}.5e{}", Random(1000), static_cast<ezInt32>(Random(10)) - 5);
+          break;
+        case 5:
+        case 6:
+          inout_sJson.Append("\"");
+          String(inout_sJson);
+          break;
+        case 7:
+          GenerateObject(inout_sJson, uiDepth);
+          break;
+        case 8:
+        {
+          inout_sJson.Append("[");
+          const ezUInt32 uiNumElements = Random(6);
+          for (ezUInt32 i = 0; i < uiNumElements; ++i)
+          {
+            if (i > 0)
+              inout_sJson.Append(",");
+
+            Whitespace(inout_sJson);
+            Value(inout_sJson, uiDepth + 1);
+          }
+          inout_sJson.Append("]");
+        }
+        break;
+      }
+    }
+
+    ezUInt32 m_uiState;
+  };
+} // namespace JSONDocumentTestDetail
+
+EZ_CREATE_SIMPLE_TEST(IO, JSONDocument)
+{
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Values")
+  {
+    const char* szJson = R"({
+  "name": "Document",
+  "count": 42,
+  "scale": -1.25e2,
+  "enabled": true,
+  "disabled": false,
+  "nothing": null,
+  "list": [1, "two", [3], {"four": 4}],
+  "empty": {},
+  "escaped": "line\nbreak \"quoted\" \u00e4"
+})";
+
+    ezJSONDocument doc;
+    EZ_TEST_BOOL(doc.Parse(szJson).Succeeded());
+
+    const ezJSONValue root = doc.GetRoot();
+    EZ_TEST_BOOL(root.IsObject());
+    EZ_TEST_INT(root.GetCount(), 9);
+
+    // strings without escape sequences point into the parsed text
+    EZ_TEST_STRING(root["name"].GetRawString(), "Document");
+    EZ_TEST_BOOL(root["name"].GetRawString().GetStartPointer() > szJson);
+    EZ_TEST_BOOL(!root["name"].HasEscapeSequences());
+
+    EZ_TEST_DOUBLE(root["count"].GetNumber(), 42.0, 0.0);
+    EZ_TEST_DOUBLE(root["scale"].GetNumber(), -125.0, 0.0);
+    EZ_TEST_BOOL(root["enabled"].GetBool() == true);
+    EZ_TEST_BOOL(root["disabled"].IsBool());
+    EZ_TEST_BOOL(root["disabled"].GetBool(true) == false);
+    EZ_TEST_BOOL(root["nothing"].IsNull());
+    EZ_TEST_BOOL(root["empty"].IsObject());
+    EZ_TEST_INT(root["empty"].GetCount(), 0);
+
+    // missing members and wrong types return the defaults
+    EZ_TEST_BOOL(!root["missing"].IsValid());
+    EZ_TEST_BOOL(root["missing"].GetType() == ezJSONValueType::Invalid);
+    EZ_TEST_DOUBLE(root["name"].GetNumber(7.0), 7.0, 0.0);
+    EZ_TEST_INT(root["count"].GetCount(), 0);
+
+    const ezJSONValue list = root["list"];
+    EZ_TEST_BOOL(list.IsArray());
+    EZ_TEST_INT(list.GetCount(), 4);
+    EZ_TEST_DOUBLE(list[0].GetNumber(), 1.0, 0.0);
+    EZ_TEST_STRING(list[1].GetRawString(), "two");
+    EZ_TEST_DOUBLE(list[2][0].GetNumber(), 3.0, 0.0);
+    EZ_TEST_DOUBLE(list[3]["four"].GetNumber(), 4.0, 0.0);
+    EZ_TEST_BOOL(!list[4].IsValid());
+
+    ezUInt32 uiNumElements = 0;
+    for (ezJSONValue element : list.GetElements())
+    {
+      EZ_TEST_BOOL(element.IsValid());
+      ++uiNumElements;
+    }
+    EZ_TEST_INT(uiNumElements, 4);
+
+    ezStringBuilder sStorage;
+    ezUInt32 uiNumMembers = 0;
+    for (const ezJSONMember& member : root.GetMembers())
+    {
+      EZ_TEST_BOOL(member.m_Name.IsString());
+      EZ_TEST_BOOL(member.m_Value.IsValid());
+
+      if (uiNumMembers == 0)
+      {
+        EZ_TEST_STRING(member.m_Name.GetString(sStorage), "name");
+      }
+
+      ++uiNumMembers;
+    }
+    EZ_TEST_INT(uiNumMembers, 9);
+
+    const ezJSONValue escaped = root["escaped"];
+    EZ_TEST_BOOL(escaped.HasEscapeSequences());
+    EZ_TEST_STRING(escaped.GetRawString(), "line\\nbreak \\\"quoted\\\" \\u00e4");
+    EZ_TEST_STRING(escaped.GetString(sStorage), "line\nbreak \"quoted\" \xC3\xA4");
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Numbers")
+  {
+    ezJSONDocument doc;
+    EZ_TEST_BOOL(doc.Parse("[0, -0.5, 1e3, 2E-2, +7, .5, 123456789012345678901234, 0.1, 1.7976931348623157e308, 5e-324, 1.5e+2]").Succeeded());
+
+    const double expected[] = {0.0, -0.5, 1000.0, 0.02, 7.0, 0.5, 1.23456789012345678e23, 0.1, 1.7976931348623157e308, 5e-324, 150.0};
+
+    const ezJSONValue root = doc.GetRoot();
+    if (EZ_TEST_INT(root.GetCount(), EZ_ARRAY_SIZE(expected)))
+    {
+      for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(expected); ++i)
+      {
+        EZ_TEST_DOUBLE(root[i].GetNumber(), expected[i], ezMath::Abs(expected[i]) * 1e-12);
+      }
+    }
+
+    // numbers with up to 15 digits are converted exactly
+    EZ_TEST_BOOL(root[7].GetNumber() == 0.1);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Comments and trailing commas")
+  {
+    ezStringBuilder sJson = R"(// leading comment
+{
+  /* block
+     comment */ "a": 1, // line comment
+  "b": "not // a comment",
+  "c": [1, 2, /* inline */ 3,],
+})";
+
+    ezJSONDocument doc;
+    EZ_TEST_BOOL(doc.Parse(sJson).Succeeded());
+
+    const ezJSONValue root = doc.GetRoot();
+    EZ_TEST_INT(root.GetCount(), 3);
+    EZ_TEST_DOUBLE(root["a"].GetNumber(), 1.0, 0.0);
+    EZ_TEST_STRING(root["b"].GetRawString(), "not // a comment");
+    EZ_TEST_INT(root["c"].GetCount(), 3);
+    EZ_TEST_DOUBLE(root["c"][2].GetNumber(), 3.0, 0.0);
+
+    // the comments are removed in a copy, the original text stays untouched
+    EZ_TEST_BOOL(sJson.StartsWith("// leading comment"));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Empty document")
+  {
+    ezJSONDocument doc;
+    EZ_TEST_BOOL(doc.Parse("").Succeeded());
+    EZ_TEST_BOOL(!doc.GetRoot().IsValid());
+
+    EZ_TEST_BOOL(doc.Parse("  \n\t ").Succeeded());
+    EZ_TEST_BOOL(!doc.GetRoot().IsValid());
+    EZ_TEST_INT(doc.GetNumNodes(), 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Errors")
+  {
+    const char* szInvalid[] = {
+      "{\"a\": 1",
+      "{\"a\" 1}",
+      "{\"a\": tru}",
+      "{\"a\": \"unterminated}",
+      "[1, 2}",
+      "[1 2]",
+      "{\"a\": 1}}",
+      "{1: 2}",
+      "[\"bad escape \\x\"]",
+      "[\"bad unicode \\u12\"]",
+      "[1.2.3]",
+      "[,]",
+    };
+
+    ezMuteLog logErrorSink;
+
+    for (const char* szJson : szInvalid)
+    {
+      ezJSONDocument doc;
+      EZ_TEST_BOOL_MSG(doc.Parse(szJson, &logErrorSink).Failed(), "'%s' should not be parsed successfully", szJson);
+      EZ_TEST_BOOL(!doc.GetRoot().IsValid());
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Parse from stream")
+  {
+    const char* szJson = "{\"values\": [1, 2, 3]}";
+
+    ezRawMemoryStreamReader stream(szJson, ezStringUtils::GetStringElementCount(szJson));
+
+    ezJSONDocument doc;
+    EZ_TEST_BOOL(doc.Parse(stream).Succeeded());
+
+    // the document owns the text now
+    EZ_TEST_BOOL(doc.GetRoot()["values"].IsArray());
+    EZ_TEST_DOUBLE(doc.GetRoot()["values"][2].GetNumber(), 3.0, 0.0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Compare with ezJSONReader")
+  {
+    for (ezUInt32 uiSeed = 1; uiSeed <= 200; ++uiSeed)
+    {
+      JSONDocumentTestDetail::DocumentGenerator generator(uiSeed);
+
+      ezStringBuilder sJson;
+      generator.GenerateObject(sJson, 0);
+
+      ezJSONDocument doc;
+      if (!EZ_TEST_BOOL_MSG(doc.Parse(sJson).Succeeded(), "Seed %u", uiSeed))
+        continue;
+
+      JSONDocumentTestDetail::CompareVariants(JSONDocumentTestDetail::ReadWithJSONReader(sJson), doc.GetRoot().ToVariant());
+    }
+  }
+}
@@ -3,8 +3,131 @@
 #include <Foundation/IO/FileSystem/DataDirTypeFolder.h>
 #include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/FileSystem/FileSystem.h>
+#include <Foundation/Math/Random.h>
+#include <Texture/Image/ImageConversion.h>
 #include <Texture/Image/ImageUtils.h>
 
+namespace
+{
+  // Straightforward evaluation of one axis of the separable filter, one pixel and one weight at a time.
+  void ReferenceScaleAxis(const ezImage& source, ezImage& ref_target, ezUInt32 uiAxis, ezUInt32 uiNewSize, const ezImageFilter& filter, ezImageAddressMode::Enum addressMode, const ezColor& borderColor)
+  {
+    const ezUInt32 uiSourceSize[3] = {source.GetWidth(), source.GetHeight(), source.GetDepth()};
+
+    if (uiSourceSize[uiAxis] == uiNewSize)
+    {
+      ref_target.ResetAndCopy(source);
+      return;
+    }
+
+    ezUInt32 uiTargetSize[3] = {uiSourceSize[0], uiSourceSize[1], uiSourceSize[2]};
+    uiTargetSize[uiAxis] = uiNewSize;
+
+    ezImageHeader header = source.GetHeader();
+    header.SetWidth(uiTargetSize[0]);
+    header.SetHeight(uiTargetSize[1]);
+    header.SetDepth(uiTargetSize[2]);
+    ref_target.ResetAndAlloc(header);
+
+    ezImageFilterWeights weights(filter, uiSourceSize[uiAxis], uiNewSize);
+
+    for (ezUInt32 arrayIndex = 0; arrayIndex < header.GetNumArrayIndices(); ++arrayIndex)
+    {
+      for (ezUInt32 face = 0; face < header.GetNumFaces(); ++face)
+      {
+        for (ezUInt32 z = 0; z < uiTargetSize[2]; ++z)
+        {
+          for (ezUInt32 y = 0; y < uiTargetSize[1]; ++y)
+          {
+            for (ezUInt32 x = 0; x < uiTargetSize[0]; ++x)
+            {
+              ezUInt32 coord[3] = {x, y, z};
+              const ezInt32 iFirstSample = weights.GetFirstSourceSampleIndex(coord[uiAxis]);
+
+              ezColor sum(0, 0, 0, 0);
+
+              for (ezUInt32 i = 0; i < weights.GetNumWeights(); ++i)
+              {
+                bool bUseBorderColor = false;
+                ezUInt32 sourceCoord[3] = {x, y, z};
+                sourceCoord[uiAxis] = ezImageUtils::GetSampleIndex(uiSourceSize[uiAxis], iFirstSample + ezInt32(i), addressMode, bUseBorderColor);
+
+                const ezColor sample = bUseBorderColor ? borderColor : *source.GetPixelPointer<ezColor>(0, face, arrayIndex, sourceCoord[0], sourceCoord[1], sourceCoord[2]);
+                sum += sample * float(weights.GetWeight(coord[uiAxis], i));
+              }
+
+              *ref_target.GetPixelPointer<ezColor>(0, face, arrayIndex, x, y, z) = sum;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  void ReferenceScale3D(const ezImage& source, ezImage& ref_target, ezUInt32 uiWidth, ezUInt32 uiHeight, ezUInt32 uiDepth, const ezImageFilter& filter, ezImageAddressMode::Enum addressMode, const ezColor& borderColor)
+  {
+    ezImage floatImage, scaledX, scaledY, scaledZ;
+    ezImageConversion::Convert(source, floatImage, ezImageFormat::R32G32B32A32_FLOAT).AssertSuccess();
+
+    ReferenceScaleAxis(floatImage, scaledX, 0, uiWidth, filter, addressMode, borderColor);
+    ReferenceScaleAxis(scaledX, scaledY, 1, uiHeight, filter, addressMode, borderColor);
+    ReferenceScaleAxis(scaledY, scaledZ, 2, uiDepth, filter, addressMode, borderColor);
+
+    ezImageConversion::Convert(scaledZ, ref_target, source.GetImageFormat()).AssertSuccess();
+  }
+
+  void CreateRandomImage(ezImage& ref_image, ezImageFormat::Enum format, ezUInt32 uiWidth, ezUInt32 uiHeight, ezUInt32 uiDepth, ezUInt32 uiNumFaces = 1)
+  {
+    ezImageHeader header;
+    header.SetImageFormat(format);
+    header.SetWidth(uiWidth);
+    header.SetHeight(uiHeight);
+    header.SetDepth(uiDepth);
+    header.SetNumFaces(uiNumFaces);
+    ref_image.ResetAndAlloc(header);
+
+    ezRandom rng;
+    rng.Initialize(uiWidth * 1000 + uiHeight * 10 + uiDepth);
+
+    if (format == ezImageFormat::R32G32B32A32_FLOAT)
+    {
+      for (ezColor& color : ref_image.GetBlobPtr<ezColor>())
+      {
+        color.SetRGBA((float)rng.FloatMinMax(-1.0, 4.0), (float)rng.FloatMinMax(0.0, 1.0), (float)rng.FloatMinMax(0.0, 1.0), (float)rng.FloatMinMax(0.0, 1.0));
+      }
+    }
+    else
+    {
+      for (ezUInt8& value : ref_image.GetBlobPtr<ezUInt8>())
+      {
+        value = static_cast<ezUInt8>(rng.UIntInRange(256));
+      }
+    }
+  }
+
+  // returns the largest difference of any channel in any pixel
+  float CompareImages(const ezImageView& imageA, const ezImageView& imageB)
+  {
+    ezImage floatA, floatB;
+    ezImageConversion::Convert(imageA, floatA, ezImageFormat::R32G32B32A32_FLOAT).AssertSuccess();
+    ezImageConversion::Convert(imageB, floatB, ezImageFormat::R32G32B32A32_FLOAT).AssertSuccess();
+
+    if (floatA.GetHeader() != floatB.GetHeader())
+      return ezMath::Infinity<float>();
+
+    ezBlobPtr<const float> valuesA = floatA.GetBlobPtr<float>();
+    ezBlobPtr<const float> valuesB = floatB.GetBlobPtr<float>();
+
+    float fMaxDiff = 0.0f;
+    for (ezUInt64 i = 0; i < valuesA.GetCount(); ++i)
+    {
+      fMaxDiff = ezMath::Max(fMaxDiff, ezMath::Abs(valuesA[i] - valuesB[i]));
+    }
+
+    return fMaxDiff;
+  }
+} // namespace
+
 
 EZ_CREATE_SIMPLE_TEST(Image, ImageUtils)
 {
@@ -116,5 +239,114 @@ EZ_CREATE_SIMPLE_TEST(Image, ImageUtils)
     EZ_TEST_INT(uiError, 1433);
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Scale RGBA32F")
+  {
+    ezImageFilterBox box;
+    ezImageFilterTriangle triangle;
+    ezImageFilterSincWithKaiserWindow sinc;
+    const ezImageFilter* filters[] = {&box, &triangle, &sinc};
+
+    const ezImageAddressMode::Enum addressModes[] = {ezImageAddressMode::Clamp, ezImageAddressMode::Repeat, ezImageAddressMode::Mirror, ezImageAddressMode::ClampBorder};
+    const ezColor borderColor(0.25f, 0.5f, 0.75f, 1.0f);
+
+    const ezUInt32 sizes[][2] = {{67, 45}, {33, 45}, {67, 19}, {16, 11}, {130, 90}, {1, 1}, {200, 7}};
+
+    ezImage source, scaled, reference;
+    CreateRandomImage(source, ezImageFormat::R32G32B32A32_FLOAT, 67, 45, 1);
+
+    for (const ezImageFilter* pFilter : filters)
+    {
+      for (ezImageAddressMode::Enum addressMode : addressModes)
+      {
+        for (auto size : sizes)
+        {
+          EZ_TEST_BOOL(ezImageUtils::Scale(source, scaled, size[0], size[1], pFilter, addressMode, addressMode, borderColor).Succeeded());
+          ReferenceScale3D(source, reference, size[0], size[1], 1, *pFilter, addressMode, borderColor);
+
+          EZ_TEST_FLOAT(CompareImages(scaled, reference), 0.0f, 1e-5f);
+        }
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Scale RGBA8")
+  {
+    ezImageFilterSincWithKaiserWindow sinc;
+    const ezUInt32 sizes[][2] = {{29, 70}, {12, 31}, {61, 20}, {8, 8}, {250, 180}};
+
+    ezImage source, scaled, reference;
+    CreateRandomImage(source, ezImageFormat::R8G8B8A8_UNORM, 61, 45, 1);
+
+    for (auto size : sizes)
+    {
+      EZ_TEST_BOOL(ezImageUtils::Scale(source, scaled, size[0], size[1], &sinc, ezImageAddressMode::Repeat, ezImageAddressMode::Repeat).Succeeded());
+      EZ_TEST_BOOL(scaled.GetImageFormat() == ezImageFormat::R8G8B8A8_UNORM);
+      ReferenceScale3D(source, reference, size[0], size[1], 1, sinc, ezImageAddressMode::Repeat, ezColor::Black);
+
+      EZ_TEST_FLOAT(CompareImages(scaled, reference), 0.0f, 1.0f / 255.0f + 1e-5f);
+    }
+
+    // sRGB and other formats go through RGBA32F
+    ezImage sourceSrgb;
+    CreateRandomImage(sourceSrgb, ezImageFormat::R8G8B8A8_UNORM_SRGB, 61, 45, 1);
+
+    EZ_TEST_BOOL(ezImageUtils::Scale(sourceSrgb, scaled, 40, 33, &sinc).Succeeded());
+    ReferenceScale3D(sourceSrgb, reference, 40, 33, 1, sinc, ezImageAddressMode::Clamp, ezColor::Black);
+
+    EZ_TEST_FLOAT(CompareImages(scaled, reference), 0.0f, 1.0f / 255.0f + 1e-5f);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Scale3D")
+  {
+    ezImageFilterTriangle triangle;
+    const ezColor borderColor(1.0f, 0.0f, 0.5f, 0.0f);
+
+    const ezUInt32 sizes[][3] = {{9, 7, 3}, {17, 13, 12}, {9, 13, 5}, {20, 3, 1}, {1, 1, 1}};
+
+    ezImage source, scaled, reference;
+    CreateRandomImage(source, ezImageFormat::R32G32B32A32_FLOAT, 17, 13, 5);
+
+    for (ezImageAddressMode::Enum addressMode : {ezImageAddressMode::Clamp, ezImageAddressMode::ClampBorder})
+    {
+      for (auto size : sizes)
+      {
+        EZ_TEST_BOOL(ezImageUtils::Scale3D(source, scaled, size[0], size[1], size[2], &triangle, addressMode, addressMode, addressMode, borderColor).Succeeded());
+        ReferenceScale3D(source, reference, size[0], size[1], size[2], triangle, addressMode, borderColor);
+
+        EZ_TEST_FLOAT(CompareImages(scaled, reference), 0.0f, 1e-5f);
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "GenerateMipMaps")
+  {
+    ezImageFilterSincWithKaiserWindow sinc;
+
+    ezImage source, mipMaps;
+    CreateRandomImage(source, ezImageFormat::R32G32B32A32_FLOAT, 96, 40, 1, 6);
+
+    ezImageUtils::MipMapOptions options;
+    options.m_filter = &sinc;
+    ezImageUtils::GenerateMipMaps(source, mipMaps, options);
+
+    EZ_TEST_INT(mipMaps.GetNumMipLevels(), 7);
+
+    for (ezUInt32 face = 0; face < 6; ++face)
+    {
+      ezImage reference;
+      reference.ResetAndCopy(source.GetSubImageView(0, face));
+
+      for (ezUInt32 mip = 1; mip < mipMaps.GetNumMipLevels(); ++mip)
+      {
+        ezImage nextReference;
+        ReferenceScale3D(reference, nextReference, ezMath::Max(1u, reference.GetWidth() / 2), ezMath::Max(1u, reference.GetHeight() / 2), 1, sinc, ezImageAddressMode::Clamp, ezColor::Black);
+
+        EZ_TEST_FLOAT(CompareImages(mipMaps.GetSubImageView(mip, face), nextReference), 0.0f, 1e-5f);
+
+        reference.ResetAndMove(std::move(nextReference));
+      }
+    }
+  }
+
   ezFileSystem::RemoveDataDirectoryGroup("ImageTest");
 }
@@ -2,8 +2,11 @@
 
 #include <Foundation/Communication/Message.h>
 #include <Foundation/Logging/Log.h>
+#include <Foundation/Profiling/Profiling.h>
 #include <Foundation/Reflection/Reflection.h>
 #include <Foundation/Time/Time.h>
+#include <Foundation/Utilities/Metrics.h>
+#include <Foundation/Utilities/Stats.h>
 
 /* Performance Statistics:
 
@@ -110,6 +113,7 @@ class Derived1 : public Base
 public:
   EZ_NO_INLINE ezInt32 EZ_FASTCALL FastCall() { return 1; }
   EZ_NO_INLINE ezInt32 NonVirtual() { return 1; }
+  EZ_NO_INLINE ezInt32 Add(ezInt32 iValue, const ezVec3& vOffset) const { return iValue + (ezInt32)vOffset.x; }
   EZ_NO_INLINE virtual ezInt32 Virtual() override { return 1; }
   EZ_NO_INLINE void OnGetValueMessage(GetValueMessage& ref_msg) { ref_msg.m_iValue = 1; }
 };
@@ -468,4 +472,130 @@ EZ_CREATE_SIMPLE_TEST(Performance, Basics)
 
     ezLog::Info("[test]64 Bit Double Multiplication: {0}ns", ezArgF(t, 2), iResult);
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Reflected Function Calls")
+  {
+    ezFunctionProperty<decltype(&Derived1::Add)> func("Add", &Derived1::Add);
+    EZ_TEST_BOOL(func.SupportsTypedExecute());
+
+    const ezInt32 iNumCalls = iNumObjects / 2;
+    const ezVec3 vOffset(1.0f, 0.0f, 0.0f);
+
+    ezTime tVariant;
+    {
+      ezInt32 iResult = 0;
+      ezHybridArray<ezVariant, 2> args;
+      args.SetCount(2);
+      args[1] = vOffset;
+      ezVariant returnValue;
+
+      ezTime t0 = ezTime::Now();
+
+      for (ezInt32 i = 0; i < iNumCalls; ++i)
+      {
+        args[0] = iResult;
+        func.Execute(&Der1[i], args, returnValue);
+        iResult = returnValue.Get<ezInt32>();
+      }
+
+      tVariant = ezTime::Now() - t0;
+
+      EZ_TEST_INT(iResult, iNumCalls);
+    }
+
+    ezTime tTyped;
+    {
+      ezInt32 iResult = 0;
+      const void* args[] = {&iResult, &vOffset};
+
+      ezTime t0 = ezTime::Now();
+
+      for (ezInt32 i = 0; i < iNumCalls; ++i)
+      {
+        func.ExecuteTyped(&Der1[i], args, &iResult);
+      }
+
+      tTyped = ezTime::Now() - t0;
+
+      EZ_TEST_INT(iResult, iNumCalls);
+    }
+
+    ezLog::Info("[test]Reflected Function Calls (Variant): {0}ns", ezArgF(tVariant.GetNanoseconds() / (double)iNumCalls, 2));
+    ezLog::Info("[test]Reflected Function Calls (Typed): {0}ns", ezArgF(tTyped.GetNanoseconds() / (double)iNumCalls, 2));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Metrics Recording")
+  {
+    const ezInt32 iNumCalls = 1000000;
+
+    ezMetricCounter counter = ezMetrics::RegisterCounter("PerformanceTest/Counter");
+    ezMetricHistogram histogram = ezMetrics::RegisterHistogram("PerformanceTest/Histogram", 0.0f, 1000.0f);
+
+    ezTime tStats;
+    {
+      ezTime t0 = ezTime::Now();
+
+      for (ezInt32 i = 0; i < iNumCalls; ++i)
+      {
+        ezStats::SetStat("PerformanceTest/Stat", i);
+      }
+
+      tStats = ezTime::Now() - t0;
+      ezStats::RemoveStat("PerformanceTest/Stat");
+    }
+
+    ezTime tCounter;
+    {
+      ezTime t0 = ezTime::Now();
+
+      for (ezInt32 i = 0; i < iNumCalls; ++i)
+      {
+        counter.Add();
+      }
+
+      tCounter = ezTime::Now() - t0;
+    }
+
+    ezTime tHistogram;
+    {
+      ezTime t0 = ezTime::Now();
+
+      for (ezInt32 i = 0; i < iNumCalls; ++i)
+      {
+        histogram.Record(i % 1000);
+      }
+
+      tHistogram = ezTime::Now() - t0;
+    }
+
+    ezMetrics::Snapshot();
+    EZ_TEST_DOUBLE(ezMetrics::GetValue(counter), iNumCalls, 0.0);
+    EZ_TEST_INT(ezMetrics::GetSampleCount(histogram), iNumCalls);
+
+    ezLog::Info("[test]ezStats::SetStat: {0}ns", ezArgF(tStats.GetNanoseconds() / (double)iNumCalls, 2));
+    ezLog::Info("[test]ezMetricCounter::Add: {0}ns", ezArgF(tCounter.GetNanoseconds() / (double)iNumCalls, 2));
+    ezLog::Info("[test]ezMetricHistogram::Record: {0}ns", ezArgF(tHistogram.GetNanoseconds() / (double)iNumCalls, 2));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Profiling Scopes")
+  {
+    const ezInt32 iNumScopes = 1000000;
+
+    // record every scope, no matter how short
+    ezProfilingSystem::SetDiscardThreshold(ezTime::MakeZero());
+
+    ezTime t0 = ezTime::Now();
+
+    for (ezInt32 i = 0; i < iNumScopes; ++i)
+    {
+      EZ_PROFILE_SCOPE("PerformanceTest Scope");
+    }
+
+    ezTime tdiff = ezTime::Now() - t0;
+
+    ezProfilingSystem::SetDiscardThreshold(ezTime::MakeFromMilliseconds(0.1));
+    ezProfilingSystem::Clear();
+
+    ezLog::Info("[test]Profiling Scope: {0}ns, {1} million scopes per second", ezArgF(tdiff.GetNanoseconds() / (double)iNumScopes, 2), ezArgF(iNumScopes / tdiff.GetSeconds() / 1000000.0, 2));
+  }
 }
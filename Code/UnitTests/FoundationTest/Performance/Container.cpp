@@ -1,11 +1,13 @@
 #include <FoundationTest/FoundationTestPCH.h>
 
 #include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Containers/FlatHashMap.h>
 #include <Foundation/Logging/Log.h>
 #include <Foundation/Reflection/Reflection.h>
 #include <Foundation/Strings/String.h>
 #include <Foundation/Time/Time.h>
 
+#include <unordered_map>
 #include <vector>
 
 namespace
@@ -75,6 +77,73 @@ namespace
 
   ezUInt32 SomeBigObject::constructionCount = 0;
   ezUInt32 SomeBigObject::destructionCount = 0;
+
+  struct StdUnorderedMapAdapter
+  {
+    void Insert(ezUInt64 uiKey, ezUInt32 uiValue) { m_Map[uiKey] = uiValue; }
+
+    const ezUInt32* GetValue(ezUInt64 uiKey) const
+    {
+      auto it = m_Map.find(uiKey);
+      return it != m_Map.end() ? &it->second : nullptr;
+    }
+
+    bool Remove(ezUInt64 uiKey) { return m_Map.erase(uiKey) != 0; }
+
+    std::unordered_map<ezUInt64, ezUInt32> m_Map;
+  };
+
+  /// Measures the average time per operation for inserting, finding existing keys, finding missing keys and removing keys.
+  template <typename MapType>
+  void BenchmarkMap(const char* szName, const ezDynamicArray<ezUInt64>& keys, const ezDynamicArray<ezUInt64>& missingKeys, ezUInt32 uiNumSamples)
+  {
+    ezUInt64 sum = 0;
+    ezTime tInsert, tFindHit, tFindMiss, tRemove;
+
+    for (ezUInt32 n = 0; n < uiNumSamples; ++n)
+    {
+      MapType map;
+
+      ezTime t0 = ezTime::Now();
+      for (ezUInt32 i = 0; i < keys.GetCount(); ++i)
+      {
+        map.Insert(keys[i], i);
+      }
+
+      ezTime t1 = ezTime::Now();
+      for (ezUInt64 key : keys)
+      {
+        if (const ezUInt32* pValue = map.GetValue(key))
+          sum += *pValue;
+      }
+
+      ezTime t2 = ezTime::Now();
+      for (ezUInt64 key : missingKeys)
+      {
+        if (map.GetValue(key) != nullptr)
+          ++sum;
+      }
+
+      ezTime t3 = ezTime::Now();
+      for (ezUInt64 key : keys)
+      {
+        if (map.Remove(key))
+          ++sum;
+      }
+
+      ezTime t4 = ezTime::Now();
+
+      tInsert += t1 - t0;
+      tFindHit += t2 - t1;
+      tFindMiss += t3 - t2;
+      tRemove += t4 - t3;
+    }
+
+    const double fNumOps = static_cast<double>(uiNumSamples) * keys.GetCount();
+    ezLog::Info("[test]{0} size = {1}: insert {2}ns, find-hit {3}ns, find-miss {4}ns, erase {5}ns ({6})", szName, keys.GetCount(),
+      ezArgF(tInsert.GetNanoseconds() / fNumOps, 2), ezArgF(tFindHit.GetNanoseconds() / fNumOps, 2), ezArgF(tFindMiss.GetNanoseconds() / fNumOps, 2),
+      ezArgF(tRemove.GetNanoseconds() / fNumOps, 2), sum);
+  }
 } // namespace
 
 // Enable when needed
@@ -419,4 +488,33 @@ EZ_CREATE_SIMPLE_TEST(Performance, Container)
         ezArgF((t1 - t0).GetMilliseconds() / static_cast<double>(NUM_SAMPLES), 4), sum);
     }
   }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Hash Maps Insert/Find/Erase")
+  {
+    for (ezUInt32 uiSize : {1000u, 100000u, 1000000u})
+    {
+      ezDynamicArray<ezUInt64> keys;
+      ezDynamicArray<ezUInt64> missingKeys;
+      keys.SetCountUninitialized(uiSize);
+      missingKeys.SetCountUninitialized(uiSize);
+
+      // xorshift, even numbers are used as keys, odd numbers are guaranteed to be missing
+      ezUInt64 uiState = 0x9E3779B97F4A7C15ull;
+      for (ezUInt32 i = 0; i < uiSize; ++i)
+      {
+        uiState ^= uiState << 13;
+        uiState ^= uiState >> 7;
+        uiState ^= uiState << 17;
+        keys[i] = uiState & ~1ull;
+        missingKeys[i] = uiState | 1ull;
+      }
+
+      const ezUInt32 uiNumSamples = ezMath::Max(1u, (NUM_SAMPLES * 1000u) / uiSize);
+
+      BenchmarkMap<ezFlatHashMap<ezUInt64, ezUInt32>>("ezFlatHashMap", keys, missingKeys, uiNumSamples);
+      BenchmarkMap<ezHashTable<ezUInt64, ezUInt32>>("ezHashTable", keys, missingKeys, uiNumSamples);
+      BenchmarkMap<ezMap<ezUInt64, ezUInt32>>("ezMap", keys, missingKeys, uiNumSamples);
+      BenchmarkMap<StdUnorderedMapAdapter>("std::unordered_map", keys, missingKeys, uiNumSamples);
+    }
+  }
 }
@@ -0,0 +1,128 @@
+#include <FoundationTest/FoundationTestPCH.h>
+
+#include <Foundation/Time/Time.h>
+#include <Texture/Image/Image.h>
+#include <Texture/Image/ImageConversion.h>
+#include <Texture/Image/ImageFilter.h>
+#include <Texture/Image/ImageUtils.h>
+
+namespace
+{
+  enum ImageConstants
+  {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+    IMAGE_SIZE = 1024,
+    NUM_IMAGE_SAMPLES = 1
+#else
+    IMAGE_SIZE = 4096,
+    NUM_IMAGE_SAMPLES = 3
+#endif
+  };
+
+  void CreateTestImage(ezImage& out_image)
+  {
+    ezImageHeader header;
+    header.SetImageFormat(ezImageFormat::R8G8B8A8_UNORM);
+    header.SetWidth(IMAGE_SIZE);
+    header.SetHeight(IMAGE_SIZE);
+    out_image.ResetAndAlloc(header);
+
+    for (ezUInt32 y = 0; y < IMAGE_SIZE; ++y)
+    {
+      ezUInt8* pRow = out_image.GetPixelPointer<ezUInt8>(0, 0, 0, 0, y);
+      for (ezUInt32 x = 0; x < IMAGE_SIZE; ++x)
+      {
+        pRow[x * 4 + 0] = static_cast<ezUInt8>(x);
+        pRow[x * 4 + 1] = static_cast<ezUInt8>(y);
+        pRow[x * 4 + 2] = static_cast<ezUInt8>(x ^ y);
+        pRow[x * 4 + 3] = static_cast<ezUInt8>((x * 7 + y * 13) >> 2);
+      }
+    }
+  }
+} // namespace
+
+#define EZ_PERFORMANCE_TESTS_STATE ezTestBlock::DisabledNoWarning
+
+EZ_CREATE_SIMPLE_TEST(Performance, Image)
+{
+  ezImage imageRGBA8;
+  CreateTestImage(imageRGBA8);
+
+  ezImage imageRGBA32F;
+  EZ_TEST_BOOL(ezImageConversion::Convert(imageRGBA8, imageRGBA32F, ezImageFormat::R32G32B32A32_FLOAT).Succeeded());
+
+  ezImageFilterSincWithKaiserWindow filter;
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Scale RGBA8")
+  {
+    ezImage target;
+    ezTime tTotal;
+
+    for (ezUInt32 i = 0; i < NUM_IMAGE_SAMPLES; ++i)
+    {
+      ezTime t0 = ezTime::Now();
+
+      EZ_TEST_BOOL(ezImageUtils::Scale(imageRGBA8, target, IMAGE_SIZE * 3 / 4, IMAGE_SIZE * 3 / 4, &filter).Succeeded());
+
+      tTotal += ezTime::Now() - t0;
+    }
+
+    ezLog::Info("[test]Scale RGBA8 {0}x{0} -> {1}x{1}: {2}ms", (ezUInt32)IMAGE_SIZE, (ezUInt32)IMAGE_SIZE * 3 / 4, ezArgF(tTotal.GetMilliseconds() / NUM_IMAGE_SAMPLES, 2));
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Scale RGBA32F")
+  {
+    ezImage target;
+    ezTime tTotal;
+
+    for (ezUInt32 i = 0; i < NUM_IMAGE_SAMPLES; ++i)
+    {
+      ezTime t0 = ezTime::Now();
+
+      EZ_TEST_BOOL(ezImageUtils::Scale(imageRGBA32F, target, IMAGE_SIZE * 3 / 4, IMAGE_SIZE * 3 / 4, &filter).Succeeded());
+
+      tTotal += ezTime::Now() - t0;
+    }
+
+    ezLog::Info("[test]Scale RGBA32F {0}x{0} -> {1}x{1}: {2}ms", (ezUInt32)IMAGE_SIZE, (ezUInt32)IMAGE_SIZE * 3 / 4, ezArgF(tTotal.GetMilliseconds() / NUM_IMAGE_SAMPLES, 2));
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "DownScaleFast RGBA8")
+  {
+    ezImage target;
+    ezTime tTotal;
+
+    for (ezUInt32 i = 0; i < NUM_IMAGE_SAMPLES; ++i)
+    {
+      ezTime t0 = ezTime::Now();
+
+      EZ_TEST_BOOL(ezImageUtils::Scale(imageRGBA8, target, IMAGE_SIZE / 2, IMAGE_SIZE / 2).Succeeded());
+
+      tTotal += ezTime::Now() - t0;
+    }
+
+    ezLog::Info("[test]DownScaleFast RGBA8 {0}x{0} -> {1}x{1}: {2}ms", (ezUInt32)IMAGE_SIZE, (ezUInt32)IMAGE_SIZE / 2, ezArgF(tTotal.GetMilliseconds() / NUM_IMAGE_SAMPLES, 2));
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "GenerateMipMaps")
+  {
+    ezImageUtils::MipMapOptions options;
+    options.m_filter = &filter;
+
+    ezImage target;
+    ezTime tTotal;
+
+    for (ezUInt32 i = 0; i < NUM_IMAGE_SAMPLES; ++i)
+    {
+      ezTime t0 = ezTime::Now();
+
+      ezImageUtils::GenerateMipMaps(imageRGBA32F, target, options);
+
+      tTotal += ezTime::Now() - t0;
+    }
+
+    EZ_TEST_INT(target.GetNumMipLevels(), imageRGBA32F.GetHeader().ComputeNumberOfMipMaps());
+
+    ezLog::Info("[test]GenerateMipMaps RGBA32F {0}x{0}: {1}ms", (ezUInt32)IMAGE_SIZE, ezArgF(tTotal.GetMilliseconds() / NUM_IMAGE_SAMPLES, 2));
+  }
+}
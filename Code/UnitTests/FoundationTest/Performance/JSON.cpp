@@ -0,0 +1,148 @@
+#include <FoundationTest/FoundationTestPCH.h>
+
+#include <Foundation/IO/JSONDocument.h>
+#include <Foundation/IO/JSONReader.h>
+#include <Foundation/IO/MemoryStream.h>
+#include <Foundation/Time/Time.h>
+
+namespace
+{
+  enum JSONConstants
+  {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+    NUM_JSON_OBJECTS = 1024 * 2,
+    NUM_JSON_SAMPLES = 1
+#else
+    NUM_JSON_OBJECTS = 1024 * 8,
+    NUM_JSON_SAMPLES = 4
+#endif
+  };
+
+  // creates a document that looks like a typical scene or asset description, with a mix of short strings, numbers and nesting
+  void GenerateJSON(ezStringBuilder& out_sJson)
+  {
+    out_sJson = "{\n  \"objects\": [\n";
+
+    for (ezUInt32 i = 0; i < NUM_JSON_OBJECTS; ++i)
+    {
+      out_sJson.AppendFormat("    {\n      \"name\": \"Object_{0}\",\n      \"guid\": \"{1}-{2}\",\n      \"active\": {3},\n", i, ezArgU(i * 2654435761u, 8, true, 16), i, (i % 3) != 0 ? "true" : "false");
+      out_sJson.AppendFormat("      \"position\": [{0}, {1}, {2}],\n", i * 0.25f, -0.5f * i, 100.125f);
+      out_sJson.Append("      \"rotation\": [0.0, 0.7071067811865476, 0.0, 0.7071067811865476],\n      \"scale\": 1.5,\n");
+      out_sJson.AppendFormat("      \"components\": [{\"type\": \"ezMeshComponent\", \"mesh\": \"{ 9d8a6d4c-0000-0000-0000-{0} }\", \"tint\": null}],\n", ezArgU(i, 12, true));
+      out_sJson.AppendFormat("      \"description\": \"line one\\nline \\\"two\\\"\"\n    }{0}\n", (i + 1 < NUM_JSON_OBJECTS) ? "," : "");
+    }
+
+    out_sJson.Append("  ]\n}\n");
+  }
+
+  double SumNumbers(const ezJSONValue& value)
+  {
+    switch (value.GetType())
+    {
+      case ezJSONValueType::Number:
+        return value.GetNumber();
+
+      case ezJSONValueType::Array:
+      {
+        double fSum = 0.0;
+        for (ezJSONValue element : value.GetElements())
+          fSum += SumNumbers(element);
+        return fSum;
+      }
+
+      case ezJSONValueType::Object:
+      {
+        double fSum = 0.0;
+        for (const ezJSONMember& member : value.GetMembers())
+          fSum += SumNumbers(member.m_Value);
+        return fSum;
+      }
+
+      default:
+        return 0.0;
+    }
+  }
+} // namespace
+
+#define EZ_PERFORMANCE_TESTS_STATE ezTestBlock::DisabledNoWarning
+
+EZ_CREATE_SIMPLE_TEST(Performance, JSON)
+{
+  ezStringBuilder sJson;
+  GenerateJSON(sJson);
+
+  const double fMegaBytes = sJson.GetElementCount() / (1024.0 * 1024.0);
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "ezJSONReader")
+  {
+    ezTime tTotal;
+
+    for (ezUInt32 i = 0; i < NUM_JSON_SAMPLES; ++i)
+    {
+      ezRawMemoryStreamReader stream(sJson.GetData(), sJson.GetElementCount());
+
+      ezTime t0 = ezTime::Now();
+
+      ezJSONReader reader;
+      EZ_TEST_BOOL(reader.Parse(stream).Succeeded());
+
+      tTotal += ezTime::Now() - t0;
+
+      EZ_TEST_INT(reader.GetTopLevelObject().GetValue("objects")->Get<ezVariantArray>().GetCount(), NUM_JSON_OBJECTS);
+    }
+
+    const double fMilliseconds = tTotal.GetMilliseconds() / NUM_JSON_SAMPLES;
+    ezLog::Info("[test]ezJSONReader: {0}MB in {1}ms ({2}MB/s)", ezArgF(fMegaBytes, 2), ezArgF(fMilliseconds, 2), ezArgF(fMegaBytes * 1000.0 / fMilliseconds, 1));
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "ezJSONDocument")
+  {
+    ezJSONDocument doc;
+    ezTime tParse;
+    ezTime tTraverse;
+    double fSum = 0.0;
+
+    for (ezUInt32 i = 0; i < NUM_JSON_SAMPLES; ++i)
+    {
+      ezTime t0 = ezTime::Now();
+
+      EZ_TEST_BOOL(doc.Parse(sJson).Succeeded());
+
+      ezTime t1 = ezTime::Now();
+
+      fSum = SumNumbers(doc.GetRoot());
+
+      ezTime t2 = ezTime::Now();
+
+      tParse += t1 - t0;
+      tTraverse += t2 - t1;
+
+      EZ_TEST_INT(doc.GetRoot()["objects"].GetCount(), NUM_JSON_OBJECTS);
+    }
+
+    const double fMilliseconds = tParse.GetMilliseconds() / NUM_JSON_SAMPLES;
+    ezLog::Info("[test]ezJSONDocument: {0}MB in {1}ms ({2}MB/s), traversal {3}ms ({4})", ezArgF(fMegaBytes, 2), ezArgF(fMilliseconds, 2), ezArgF(fMegaBytes * 1000.0 / fMilliseconds, 1), ezArgF(tTraverse.GetMilliseconds() / NUM_JSON_SAMPLES, 2), fSum);
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "ezJSONDocument::ToVariant")
+  {
+    ezJSONDocument doc;
+    ezTime tTotal;
+
+    for (ezUInt32 i = 0; i < NUM_JSON_SAMPLES; ++i)
+    {
+      ezTime t0 = ezTime::Now();
+
+      EZ_TEST_BOOL(doc.Parse(sJson).Succeeded());
+      ezVariant result = doc.GetRoot().ToVariant();
+
+      tTotal += ezTime::Now() - t0;
+
+      EZ_TEST_INT(result.Get<ezVariantDictionary>().GetValue("objects")->Get<ezVariantArray>().GetCount(), NUM_JSON_OBJECTS);
+    }
+
+    // this is what code gets that still needs the ezVariant structure of ezJSONReader
+    const double fMilliseconds = tTotal.GetMilliseconds() / NUM_JSON_SAMPLES;
+    ezLog::Info("[test]ezJSONDocument + ToVariant: {0}MB in {1}ms ({2}MB/s)", ezArgF(fMegaBytes, 2), ezArgF(fMilliseconds, 2), ezArgF(fMegaBytes * 1000.0 / fMilliseconds, 1));
+  }
+}
@@ -0,0 +1,146 @@
+#include <FoundationTest/FoundationTestPCH.h>
+
+#include <Foundation/IO/MemoryStream.h>
+#include <Foundation/IO/OpenDdlReader.h>
+#include <Foundation/IO/OpenDdlUtils.h>
+#include <Foundation/IO/OpenDdlWriter.h>
+#include <Foundation/Time/Time.h>
+#include <Foundation/Types/Uuid.h>
+
+namespace
+{
+  enum OpenDdlConstants
+  {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+    NUM_DDL_OBJECTS = 1024 * 2,
+    NUM_DDL_SAMPLES = 1
+#else
+    NUM_DDL_OBJECTS = 1024 * 16,
+    NUM_DDL_SAMPLES = 4
+#endif
+  };
+
+  // writes a document that is structured like a scene written by ezAbstractGraphDdlSerializer
+  void GenerateScene(ezOpenDdlWriter& ref_writer)
+  {
+    ref_writer.BeginObject("Objects");
+
+    for (ezUInt32 i = 0; i < NUM_DDL_OBJECTS; ++i)
+    {
+      ref_writer.BeginObject("o");
+      ezOpenDdlUtils::StoreUuid(ref_writer, ezUuid(i, 0x9d8a6d4c), "id");
+      ezOpenDdlUtils::StoreString(ref_writer, "ezGameObject", "t");
+      ezOpenDdlUtils::StoreUInt32(ref_writer, 1, "v");
+
+      ref_writer.BeginObject("p");
+      {
+        ezOpenDdlUtils::StoreString(ref_writer, "Object", "Name");
+        ezOpenDdlUtils::StoreBool(ref_writer, (i % 3) != 0, "Active");
+        ezOpenDdlUtils::StoreVec3(ref_writer, ezVec3(i * 0.25f, -0.5f * i, 100.125f), "LocalPosition");
+        ezOpenDdlUtils::StoreQuat(ref_writer, ezQuat(0.0f, 0.7071068f, 0.0f, 0.7071068f), "LocalRotation");
+        ezOpenDdlUtils::StoreVec3(ref_writer, ezVec3(1.0f), "LocalScaling");
+        ezOpenDdlUtils::StoreUuid(ref_writer, ezUuid(i / 16, 0x9d8a6d4c), "Parent");
+
+        ref_writer.BeginPrimitiveList(ezOpenDdlPrimitiveType::Float, "Weights");
+        float weights[16];
+        for (ezUInt32 w = 0; w < EZ_ARRAY_SIZE(weights); ++w)
+          weights[w] = static_cast<float>(w + i) / 7.0f;
+        ref_writer.WriteFloat(weights, EZ_ARRAY_SIZE(weights));
+        ref_writer.EndPrimitiveList();
+      }
+      ref_writer.EndObject();
+
+      ref_writer.EndObject();
+    }
+
+    ref_writer.EndObject();
+  }
+
+  void WriteScene(ezContiguousMemoryStreamStorage& ref_storage, bool bBinary)
+  {
+    ezMemoryStreamWriter output(&ref_storage);
+
+    ezOpenDdlWriter writer;
+    writer.SetOutputStream(&output);
+    writer.SetCompactMode(true);
+    writer.SetPrimitiveTypeStringMode(ezOpenDdlWriter::TypeStringMode::Shortest);
+    writer.SetBinaryMode(bBinary);
+
+    GenerateScene(writer);
+  }
+} // namespace
+
+#define EZ_PERFORMANCE_TESTS_STATE ezTestBlock::DisabledNoWarning
+
+EZ_CREATE_SIMPLE_TEST(Performance, OpenDdl)
+{
+  ezContiguousMemoryStreamStorage textStorage;
+  ezContiguousMemoryStreamStorage binaryStorage;
+  WriteScene(textStorage, false);
+  WriteScene(binaryStorage, true);
+
+  const double fTextMB = textStorage.GetStorageSize64() / (1024.0 * 1024.0);
+  const double fBinaryMB = binaryStorage.GetStorageSize64() / (1024.0 * 1024.0);
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Text")
+  {
+    ezTime tTotal;
+
+    for (ezUInt32 i = 0; i < NUM_DDL_SAMPLES; ++i)
+    {
+      ezMemoryStreamReader input(&textStorage);
+
+      ezTime t0 = ezTime::Now();
+
+      ezOpenDdlReader reader;
+      EZ_TEST_BOOL(reader.ParseDocument(input).Succeeded());
+
+      tTotal += ezTime::Now() - t0;
+
+      EZ_TEST_INT(reader.GetRootElement()->GetFirstChild()->GetNumChildObjects(), NUM_DDL_OBJECTS);
+    }
+
+    ezLog::Info("[test]OpenDDL text: {0}MB in {1}ms", ezArgF(fTextMB, 2), ezArgF(tTotal.GetMilliseconds() / NUM_DDL_SAMPLES, 2));
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Binary from Stream")
+  {
+    ezTime tTotal;
+
+    for (ezUInt32 i = 0; i < NUM_DDL_SAMPLES; ++i)
+    {
+      ezMemoryStreamReader input(&binaryStorage);
+
+      ezTime t0 = ezTime::Now();
+
+      ezOpenDdlReader reader;
+      EZ_TEST_BOOL(reader.ParseDocument(input).Succeeded());
+
+      tTotal += ezTime::Now() - t0;
+
+      EZ_TEST_INT(reader.GetRootElement()->GetFirstChild()->GetNumChildObjects(), NUM_DDL_OBJECTS);
+    }
+
+    ezLog::Info("[test]OpenDDL binary (stream): {0}MB in {1}ms", ezArgF(fBinaryMB, 2), ezArgF(tTotal.GetMilliseconds() / NUM_DDL_SAMPLES, 2));
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Binary in Place")
+  {
+    ezTime tTotal;
+
+    for (ezUInt32 i = 0; i < NUM_DDL_SAMPLES; ++i)
+    {
+      ezTime t0 = ezTime::Now();
+
+      // this is what reading from an ezMemoryMappedFile costs
+      ezOpenDdlReader reader;
+      EZ_TEST_BOOL(reader.ParseBinaryDocument(ezConstByteArrayPtr(binaryStorage.GetData(), binaryStorage.GetStorageSize32())).Succeeded());
+
+      tTotal += ezTime::Now() - t0;
+
+      EZ_TEST_INT(reader.GetRootElement()->GetFirstChild()->GetNumChildObjects(), NUM_DDL_OBJECTS);
+    }
+
+    ezLog::Info("[test]OpenDDL binary (in place): {0}MB in {1}ms", ezArgF(fBinaryMB, 2), ezArgF(tTotal.GetMilliseconds() / NUM_DDL_SAMPLES, 2));
+  }
+}
@@ -2,7 +2,10 @@
 
 #include <Foundation/IO/FileSystem/FileSystem.h>
 #include <Foundation/IO/FileSystem/FileWriter.h>
+#include <Foundation/IO/MemoryStream.h>
+#include <Foundation/IO/OSFile.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Profiling/ProfilingTrace.h>
 #include <Foundation/Threading/ThreadUtils.h>
 
 namespace
@@ -52,4 +55,321 @@ EZ_CREATE_SIMPLE_TEST(Profiling, Profiling)
 
     WriteOutProfilingCapture(":output/profilingScopes.json");
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Interned names")
+  {
+    const char* szName = ezProfilingSystem::InternName("Interned Name");
+    EZ_TEST_STRING(szName, "Interned Name");
+
+    // equal strings from different buffers share the same pointer
+    ezStringBuilder sName = "Interned Name";
+    EZ_TEST_BOOL(ezProfilingSystem::InternName(sName) == szName);
+    EZ_TEST_BOOL(ezProfilingSystem::InternName(ezStringView("Interned Name")) == szName);
+
+    // reusing a buffer for a different string must not return the cached result
+    sName = "Interned Nome";
+    const char* szOtherName = ezProfilingSystem::InternName(sName);
+    EZ_TEST_BOOL(szOtherName != szName);
+    EZ_TEST_STRING(szOtherName, "Interned Nome");
+
+    // views don't need to be zero-terminated
+    EZ_TEST_STRING(ezProfilingSystem::InternName(ezStringView("Interned Name").GetSubString(0, 8)), "Interned");
+
+    // names are not truncated
+    ezStringBuilder sLongName;
+    for (ezUInt32 i = 0; i < 10; ++i)
+    {
+      sLongName.Append("A long scope name ");
+    }
+
+    EZ_TEST_STRING(ezProfilingSystem::InternName(sLongName), sLongName);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Copied names")
+  {
+    ezProfilingSystem::Clear();
+
+    {
+      EZ_PROFILE_SCOPE("Literal Scope");
+      ezThreadUtils::Sleep(ezTime::MakeFromMilliseconds(1));
+    }
+
+    // names that are formatted at runtime are copied into a bounded ring instead of being interned,
+    // so recording many of them overwrites the oldest ones instead of growing without bounds
+    const ezUInt32 uiNumScopes = 100000;
+    ezStringBuilder sName;
+    for (ezUInt32 i = 0; i < uiNumScopes; ++i)
+    {
+      sName.SetFormat("Copied Scope {}", i);
+      ezProfilingSystem::AddCPUScope(sName, nullptr, ezTime::MakeFromMilliseconds(i), ezTime::MakeFromMilliseconds(i + 1), ezTime::MakeZero());
+    }
+
+    ezProfilingSystem::ProfilingData merged;
+
+    {
+      ezProfilingSystem::ProfilingData profilingData;
+      ezProfilingSystem::Capture(profilingData);
+
+      const ezProfilingSystem::ProfilingData* inputs[] = {&profilingData};
+      ezProfilingSystem::ProfilingData::Merge(merged, ezMakeArrayPtr(inputs));
+    }
+
+    // the merged data keeps the copied names alive
+    const char* szLiteralName = ezProfilingSystem::InternName("Literal Scope");
+    bool bFoundLiteral = false;
+    ezUInt32 uiNumCopied = 0;
+    ezUInt32 uiNumMismatches = 0;
+    bool bFoundLast = false;
+
+    for (const auto& eventBuffer : merged.m_AllEventBuffers)
+    {
+      for (const auto& scope : eventBuffer.m_Data)
+      {
+        bFoundLiteral |= (scope.m_szName == szLiteralName);
+
+        if (!ezStringUtils::StartsWith(scope.m_szName, "Copied Scope "))
+          continue;
+
+        const ezUInt32 uiIndex = static_cast<ezUInt32>(ezMath::Round(scope.m_BeginTime.GetMilliseconds()));
+        sName.SetFormat("Copied Scope {}", uiIndex);
+        uiNumMismatches += (sName != scope.m_szName) ? 1 : 0;
+        bFoundLast |= (uiIndex == uiNumScopes - 1);
+        ++uiNumCopied;
+      }
+    }
+
+    EZ_TEST_BOOL(bFoundLiteral);
+    EZ_TEST_BOOL(bFoundLast);
+    EZ_TEST_BOOL(uiNumCopied > 0 && uiNumCopied < uiNumScopes);
+    EZ_TEST_INT(uiNumMismatches, 0);
+
+    ezProfilingSystem::Clear();
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Counter tracks")
+  {
+    ezProfilingSystem::Clear();
+
+    for (ezUInt32 i = 0; i < 4; ++i)
+    {
+      EZ_PROFILE_COUNTER("Test/Counter", i);
+
+      // names that are formatted at runtime must not end up in the interned names
+      ezStringBuilder sName;
+      sName.SetFormat("Test/Counter {}", i);
+      EZ_PROFILE_COUNTER(sName, i);
+    }
+
+    ezProfilingSystem::ProfilingData profilingData;
+    ezProfilingSystem::Capture(profilingData);
+
+    ezUInt32 uiNumSamples = 0;
+    ezUInt32 uiFormattedSamples = 0;
+    for (const auto& sample : profilingData.m_CounterSamples)
+    {
+      if (ezStringUtils::IsEqual(sample.GetName(), "Test/Counter"))
+      {
+        EZ_TEST_DOUBLE(sample.m_fValue, static_cast<double>(uiNumSamples), 0.0);
+        EZ_TEST_BOOL(sample.m_szName == ezProfilingSystem::InternName("Test/Counter"));
+        ++uiNumSamples;
+      }
+      else if (ezStringUtils::StartsWith(sample.GetName(), "Test/Counter "))
+      {
+        ezStringBuilder sExpected;
+        sExpected.SetFormat("Test/Counter {}", uiFormattedSamples);
+        EZ_TEST_STRING(sample.GetName(), sExpected);
+        EZ_TEST_BOOL(sample.m_szName == nullptr);
+        ++uiFormattedSamples;
+      }
+    }
+
+    EZ_TEST_INT(uiNumSamples, 4);
+    EZ_TEST_INT(uiFormattedSamples, 4);
+
+    ezContiguousMemoryStreamStorage storage;
+    ezMemoryStreamWriter writer(&storage);
+    EZ_TEST_BOOL(profilingData.Write(writer).Succeeded());
+
+    ezStringBuilder sJSON;
+    sJSON.SetSubString_ElementCount(reinterpret_cast<const char*>(storage.GetData()), storage.GetStorageSize32());
+    EZ_TEST_BOOL(sJSON.FindSubString("\"name\":\"Test/Counter\"") != nullptr);
+    EZ_TEST_BOOL(sJSON.FindSubString("\"name\":\"Test/Counter 3\"") != nullptr);
+    EZ_TEST_BOOL(sJSON.FindSubString("\"ph\":\"C\"") != nullptr);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Trace round-trip")
+  {
+    ezProfilingSystem::ThreadInfo threadInfo;
+    threadInfo.m_uiThreadId = 42;
+    threadInfo.m_sName = "Trace Thread";
+
+    ezProfilingSystem::CPUScope scopes[3];
+    for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(scopes); ++i)
+    {
+      scopes[i].m_szName = ezProfilingSystem::InternName(i == 1 ? "Trace/Other" : "Trace/Scope");
+      scopes[i].m_szFunctionName = i == 2 ? nullptr : "TraceFunction";
+      scopes[i].m_BeginTime = ezTime::MakeFromMicroseconds(i * 10.0);
+      scopes[i].m_EndTime = ezTime::MakeFromMicroseconds(i * 10.0 + 5.0);
+    }
+
+    ezProfilingSystem::CounterSample sample;
+    sample.m_szName = ezProfilingSystem::InternName("Trace/Counter");
+    sample.m_Time = ezTime::MakeFromMicroseconds(7.0);
+    sample.m_fValue = 3.5;
+
+    ezProfilingSystem::CounterSample copiedSample = sample;
+    copiedSample.m_szName = nullptr;
+    ezStringUtils::Copy(copiedSample.m_szCopiedName, ezProfilingSystem::CounterSample::NAME_SIZE, "Trace/Copied Counter");
+
+    ezContiguousMemoryStreamStorage storage;
+    {
+      ezMemoryStreamWriter writer(&storage);
+
+      ezProfilingTraceWriter traceWriter;
+      EZ_TEST_BOOL(traceWriter.Begin(writer, 123).Succeeded());
+      EZ_TEST_BOOL(!traceWriter.HasThreadInfo(42));
+      EZ_TEST_BOOL(traceWriter.WriteThreadInfo(threadInfo).Succeeded());
+      EZ_TEST_BOOL(traceWriter.HasThreadInfo(42));
+      EZ_TEST_BOOL(traceWriter.WriteCPUScopes(42, ezMakeArrayPtr(scopes)).Succeeded());
+      EZ_TEST_BOOL(traceWriter.WriteFrame(5, ezTime::MakeFromMicroseconds(1.0)).Succeeded());
+      EZ_TEST_BOOL(traceWriter.WriteCounterSample(sample).Succeeded());
+      EZ_TEST_BOOL(traceWriter.WriteCounterSample(copiedSample).Succeeded());
+    }
+
+    {
+      ezRawMemoryStreamReader reader(storage.GetData(), storage.GetStorageSize64());
+
+      ezProfilingSystem::ProfilingData profilingData;
+      EZ_TEST_BOOL(ezProfilingTraceReader::Read(reader, profilingData).Succeeded());
+
+      EZ_TEST_INT(profilingData.m_uiProcessID, 123);
+      EZ_TEST_INT(profilingData.m_uiFrameCount, 5);
+      EZ_TEST_INT(profilingData.m_FrameStartTimes.GetCount(), 1);
+
+      EZ_TEST_INT(profilingData.m_ThreadInfos.GetCount(), 1);
+      EZ_TEST_STRING(profilingData.m_ThreadInfos[0].m_sName, "Trace Thread");
+
+      if (EZ_TEST_INT(profilingData.m_AllEventBuffers.GetCount(), 1))
+      {
+        const auto& eventBuffer = profilingData.m_AllEventBuffers[0];
+        EZ_TEST_INT(eventBuffer.m_uiThreadId, 42);
+
+        if (EZ_TEST_INT(eventBuffer.m_Data.GetCount(), 3))
+        {
+          for (ezUInt32 i = 0; i < 3; ++i)
+          {
+            // names come back interned
+            EZ_TEST_BOOL(eventBuffer.m_Data[i].m_szName == scopes[i].m_szName);
+            EZ_TEST_DOUBLE(eventBuffer.m_Data[i].m_BeginTime.GetMicroseconds(), scopes[i].m_BeginTime.GetMicroseconds(), 0.001);
+            EZ_TEST_DOUBLE(eventBuffer.m_Data[i].m_EndTime.GetMicroseconds(), scopes[i].m_EndTime.GetMicroseconds(), 0.001);
+          }
+
+          EZ_TEST_STRING(eventBuffer.m_Data[0].m_szFunctionName, "TraceFunction");
+          EZ_TEST_BOOL(eventBuffer.m_Data[2].m_szFunctionName == nullptr);
+        }
+      }
+
+      if (EZ_TEST_INT(profilingData.m_CounterSamples.GetCount(), 2))
+      {
+        EZ_TEST_BOOL(profilingData.m_CounterSamples[0].m_szName == sample.m_szName);
+        EZ_TEST_DOUBLE(profilingData.m_CounterSamples[0].m_fValue, 3.5, 0.0);
+        EZ_TEST_STRING(profilingData.m_CounterSamples[1].GetName(), "Trace/Copied Counter");
+      }
+    }
+
+    {
+      ezMuteLog logErrorSink;
+      ezLogSystemScope ls(&logErrorSink);
+
+      // a cut off trace is read up to the last complete record
+      ezRawMemoryStreamReader reader(storage.GetData(), storage.GetStorageSize64() - 4);
+
+      ezProfilingSystem::ProfilingData profilingData;
+      EZ_TEST_BOOL(ezProfilingTraceReader::Read(reader, profilingData).Succeeded());
+      EZ_TEST_INT(profilingData.m_AllEventBuffers.GetCount(), 1);
+      EZ_TEST_INT(profilingData.m_CounterSamples.GetCount(), 1);
+
+      // anything else is rejected
+      const char szNoTrace[] = "{ \"traceEvents\": [] }";
+      ezRawMemoryStreamReader reader2(szNoTrace, sizeof(szNoTrace));
+      EZ_TEST_BOOL(ezProfilingTraceReader::Read(reader2, profilingData).Failed());
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Streaming")
+  {
+    ezStringBuilder sOutputPath = ezTestFramework::GetInstance()->GetAbsOutputPath();
+    sOutputPath.AppendPath("ProfilingStream");
+
+    ezStringBuilder sTraceFile = sOutputPath;
+    sTraceFile.Append("_0.ezProfilingTrace");
+    ezOSFile::DeleteFile(sTraceFile).IgnoreResult();
+
+    ezProfilingSystem::StreamingSettings settings;
+    settings.m_sOutputPath = sOutputPath;
+    settings.m_FlushInterval = ezTime::MakeFromMilliseconds(10);
+
+    EZ_TEST_BOOL(ezProfilingSystem::StartStreaming(settings).Succeeded());
+    EZ_TEST_BOOL(ezProfilingSystem::IsStreaming());
+
+    ezStringBuilder sFrameName;
+    for (ezUInt32 i = 0; i < 5; ++i)
+    {
+      {
+        // copied names are written by content, the stream thread reuses its buffer for them
+        sFrameName.SetFormat("Streamed frame {}", i);
+        EZ_PROFILE_SCOPE(sFrameName);
+        EZ_PROFILE_SCOPE("Streamed scope");
+        ezThreadUtils::Sleep(ezTime::MakeFromMilliseconds(5));
+      }
+
+      EZ_PROFILE_COUNTER("Test/Streamed Counter", i);
+      ezProfilingSystem::StartNewFrame();
+    }
+
+    ezProfilingSystem::StopStreaming();
+    EZ_TEST_BOOL(!ezProfilingSystem::IsStreaming());
+
+    ezOSFile file;
+    if (EZ_TEST_BOOL(file.Open(sTraceFile, ezFileOpenMode::Read).Succeeded()))
+    {
+      ezDynamicArray<ezUInt8> content;
+      file.ReadAll(content);
+      file.Close();
+
+      ezRawMemoryStreamReader reader(content);
+
+      ezProfilingSystem::ProfilingData profilingData;
+      EZ_TEST_BOOL(ezProfilingTraceReader::Read(reader, profilingData).Succeeded());
+      EZ_TEST_INT(profilingData.m_FrameStartTimes.GetCount(), 5);
+
+      const char* szScopeName = ezProfilingSystem::InternName("Streamed scope");
+      ezUInt32 uiNumScopes = 0;
+      ezUInt32 uiFrameScopes = 0;
+      for (const auto& eventBuffer : profilingData.m_AllEventBuffers)
+      {
+        for (const auto& scope : eventBuffer.m_Data)
+        {
+          uiNumScopes += (scope.m_szName == szScopeName) ? 1 : 0;
+
+          for (ezUInt32 i = 0; i < 5; ++i)
+          {
+            sFrameName.SetFormat("Streamed frame {}", i);
+            uiFrameScopes |= (sFrameName == scope.m_szName) ? (1u << i) : 0;
+          }
+        }
+      }
+
+      EZ_TEST_INT(uiNumScopes, 5);
+      EZ_TEST_INT(uiFrameScopes, 0x1F);
+
+      ezUInt32 uiNumSamples = 0;
+      for (const auto& sample : profilingData.m_CounterSamples)
+      {
+        uiNumSamples += ezStringUtils::IsEqual(sample.GetName(), "Test/Streamed Counter") ? 1 : 0;
+      }
+
+      EZ_TEST_INT(uiNumSamples, 5);
+    }
+  }
 }
@@ -288,6 +288,8 @@ struct FunctionTest
 
   static int StaticFunction2() { return 42; }
 
+  float TypedFunction(float f, const ezVec3& v) const { return f + v.GetLength(); }
+
   bool m_bPtrAreNull = false;
   ezDynamicArray<ezVariant> m_values;
 };
@@ -813,6 +815,42 @@ EZ_CREATE_SIMPLE_TEST(Reflection, Functions)
     EZ_TEST_BOOL(ret == 42);
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Typed Execute")
+  {
+    ezFunctionProperty<decltype(&FunctionTest::StandardTypeFunction)> funccall("", &FunctionTest::StandardTypeFunction);
+    EZ_TEST_BOOL(!funccall.SupportsTypedExecute());
+
+    ezFunctionProperty<decltype(&FunctionTest::StaticFunction)> funccall2("", &FunctionTest::StaticFunction);
+    EZ_TEST_BOOL(funccall2.SupportsTypedExecute());
+
+    bool b = true;
+    ezVariant v = 4.0f;
+    const void* args[] = {&b, &v};
+    funccall2.ExecuteTyped(nullptr, args, nullptr);
+
+    ezFunctionProperty<decltype(&FunctionTest::StaticFunction2)> funccall3("", &FunctionTest::StaticFunction2);
+    EZ_TEST_BOOL(funccall3.SupportsTypedExecute());
+
+    int iRet = 0;
+    funccall3.ExecuteTyped(nullptr, nullptr, &iRet);
+    EZ_TEST_INT(iRet, 42);
+    funccall3.ExecuteTyped(nullptr, nullptr, nullptr);
+
+    ezFunctionProperty<decltype(&FunctionTest::TypedFunction)> funccall4("", &FunctionTest::TypedFunction);
+    EZ_TEST_BOOL(funccall4.SupportsTypedExecute());
+
+    FunctionTest test;
+    float f = 1.0f;
+    ezVec3 vec(3, 4, 0);
+    const void* args2[] = {&f, &vec};
+    float fRet = 0.0f;
+    funccall4.ExecuteTyped(&test, args2, &fRet);
+    EZ_TEST_FLOAT(fRet, 6.0f, 0.0f);
+
+    ezConstructorFunctionProperty<ezVec3, float, float, float> constructor;
+    EZ_TEST_BOOL(!constructor.SupportsTypedExecute());
+  }
+
   EZ_TEST_BLOCK(ezTestBlock::Enabled, "Constructor Functions - StandardTypes")
   {
     ezConstructorFunctionProperty<ezVec4, float, float, float, float> funccall;
@@ -98,6 +98,29 @@ void TestSerialize(T* pObject)
     sData2.SetSubString_ElementCount((const char*)storage2.GetData(), storage2.GetStorageSize32());
 
     EZ_TEST_BOOL(sData == sData2);
+
+    // the binary OpenDDL encoding has to result in exactly the same graph
+    ezContiguousMemoryStreamStorage storage3;
+    ezMemoryStreamWriter writer3(&storage3);
+    ezMemoryStreamReader reader3(&storage3);
+
+    ezOpenDdlWriter binaryWriter;
+    binaryWriter.SetOutputStream(&writer3);
+    binaryWriter.SetBinaryMode(true);
+    ezAbstractGraphDdlSerializer::Write(binaryWriter, &graph);
+
+    ezAbstractObjectGraph graph3;
+    EZ_TEST_BOOL(ezAbstractGraphDdlSerializer::Read(reader3, &graph3).Succeeded());
+
+    ezContiguousMemoryStreamStorage storage4;
+    ezMemoryStreamWriter writer4(&storage4);
+
+    ezAbstractGraphDdlSerializer::Write(writer4, &graph3);
+
+    ezStringBuilder sData3;
+    sData3.SetSubString_ElementCount((const char*)storage4.GetData(), storage4.GetStorageSize32());
+
+    EZ_TEST_BOOL(sData == sData3);
   }
 
   {
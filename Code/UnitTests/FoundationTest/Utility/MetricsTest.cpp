@@ -0,0 +1,224 @@
+#include <FoundationTest/FoundationTestPCH.h>
+
+#include <Foundation/IO/MemoryStream.h>
+#include <Foundation/Logging/Log.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Utilities/Metrics.h>
+#include <Foundation/Utilities/Stats.h>
+
+EZ_CREATE_SIMPLE_TEST(Utility, Metrics)
+{
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Registration")
+  {
+    ezMetricCounter counter = ezMetrics::RegisterCounter("MetricsTest/Registration");
+    EZ_TEST_BOOL(counter.IsValid());
+
+    const ezUInt32 uiNumMetrics = ezMetrics::GetNumMetrics();
+
+    // registering the same name again returns the same metric
+    ezMetricCounter counter2 = ezMetrics::RegisterCounter("MetricsTest/Registration");
+    EZ_TEST_BOOL(counter2.IsValid());
+    EZ_TEST_INT(ezMetrics::GetNumMetrics(), uiNumMetrics);
+    EZ_TEST_STRING(ezMetrics::GetName(uiNumMetrics - 1), "MetricsTest/Registration");
+    EZ_TEST_BOOL(ezMetrics::GetType(uiNumMetrics - 1) == ezMetricType::Counter);
+
+    {
+      ezMuteLog logErrorSink;
+      ezLogSystemScope ls(&logErrorSink);
+
+      // but not with a different type
+      ezMetricGauge gauge = ezMetrics::RegisterGauge("MetricsTest/Registration");
+      EZ_TEST_BOOL(!gauge.IsValid());
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Counter")
+  {
+    ezMetricCounter counter = ezMetrics::RegisterCounter("MetricsTest/Counter");
+
+    ezMetrics::Snapshot();
+    EZ_TEST_DOUBLE(ezMetrics::GetValue(counter), 0.0, 0.0);
+    EZ_TEST_INT(ezMetrics::GetTotal(counter), 0);
+
+    counter.Add();
+    counter.Add(9);
+
+    ezMetrics::Snapshot();
+    EZ_TEST_DOUBLE(ezMetrics::GetValue(counter), 10.0, 0.0);
+    EZ_TEST_INT(ezMetrics::GetTotal(counter), 10);
+
+    // the value is the amount that was added since the last snapshot
+    counter.Add(5);
+
+    ezMetrics::Snapshot();
+    EZ_TEST_DOUBLE(ezMetrics::GetValue(counter), 5.0, 0.0);
+    EZ_TEST_INT(ezMetrics::GetTotal(counter), 15);
+
+    ezMetrics::Snapshot();
+    EZ_TEST_DOUBLE(ezMetrics::GetValue(counter), 0.0, 0.0);
+    EZ_TEST_INT(ezMetrics::GetTotal(counter), 15);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Counter (Multi-Threaded)")
+  {
+    ezMetricCounter counter = ezMetrics::RegisterCounter("MetricsTest/CounterMT");
+
+    ezParallelForParams params;
+    params.m_uiBinSize = 100;
+
+    ezTaskSystem::ParallelForIndexed(
+      0u, 10000u, [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex)
+      {
+        for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+        {
+          counter.Add(2);
+        }
+      },
+      "MetricsTest", ezTaskNesting::Never, params);
+
+    ezMetrics::Snapshot();
+    EZ_TEST_DOUBLE(ezMetrics::GetValue(counter), 20000.0, 0.0);
+    EZ_TEST_INT(ezMetrics::GetTotal(counter), 20000);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Gauge")
+  {
+    ezMetricGauge gauge = ezMetrics::RegisterGauge("MetricsTest/Gauge");
+
+    gauge.Set(3.0);
+    gauge.Set(7.5);
+
+    ezMetrics::Snapshot();
+    EZ_TEST_DOUBLE(ezMetrics::GetValue(gauge), 7.5, 0.0);
+
+    // a gauge keeps its value
+    ezMetrics::Snapshot();
+    EZ_TEST_DOUBLE(ezMetrics::GetValue(gauge), 7.5, 0.0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Histogram")
+  {
+    ezMetricHistogram histogram = ezMetrics::RegisterHistogram("MetricsTest/Histogram", 0.0f, 100.0f, 100);
+
+    for (ezUInt32 i = 0; i < 100; ++i)
+    {
+      histogram.Record(i + 0.5);
+    }
+
+    ezMetrics::Snapshot();
+    EZ_TEST_INT(ezMetrics::GetSampleCount(histogram), 100);
+    EZ_TEST_DOUBLE(ezMetrics::GetValue(histogram), 50.0, 0.0001);
+    EZ_TEST_DOUBLE(ezMetrics::GetPercentile(histogram, 0.5f), 50.0, 0.0001);
+    EZ_TEST_DOUBLE(ezMetrics::GetPercentile(histogram, 0.95f), 95.0, 0.0001);
+
+    // samples outside of the range end up in the outer buckets
+    histogram.Record(-10.0);
+    histogram.Record(1000.0);
+
+    ezMetrics::Snapshot();
+    EZ_TEST_INT(ezMetrics::GetSampleCount(histogram), 2);
+    EZ_TEST_DOUBLE(ezMetrics::GetValue(histogram), 495.0, 0.0001);
+    EZ_TEST_DOUBLE(ezMetrics::GetPercentile(histogram, 0.0f), 0.0, 0.0001);
+    EZ_TEST_DOUBLE(ezMetrics::GetPercentile(histogram, 1.0f), 100.0, 0.0001);
+
+    // values that don't fit into the bucket index at all
+    histogram.Record(1e30);
+    histogram.Record(-1e30);
+    histogram.Record(ezMath::Infinity<double>());
+    histogram.Record(-ezMath::Infinity<double>());
+    histogram.Record(ezMath::NaN<double>());
+    histogram.Record(50.5);
+
+    ezMetrics::Snapshot();
+    EZ_TEST_INT(ezMetrics::GetSampleCount(histogram), 6);
+    EZ_TEST_BOOL(ezMath::IsFinite(ezMetrics::GetValue(histogram)));
+    EZ_TEST_DOUBLE(ezMetrics::GetPercentile(histogram, 0.0f), 0.0, 0.0001);
+    EZ_TEST_DOUBLE(ezMetrics::GetPercentile(histogram, 1.0f), 100.0, 0.0001);
+    EZ_TEST_DOUBLE(ezMetrics::GetPercentile(histogram, 0.5f), 1.0, 0.0001);
+
+    ezMetrics::Snapshot();
+    EZ_TEST_INT(ezMetrics::GetSampleCount(histogram), 0);
+    EZ_TEST_DOUBLE(ezMetrics::GetValue(histogram), 0.0, 0.0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "ExportToStats")
+  {
+    ezMetricCounter counter = ezMetrics::RegisterCounter("MetricsTest/ExportCounter");
+    ezMetricHistogram histogram = ezMetrics::RegisterHistogram("MetricsTest/ExportHistogram", 0.0f, 10.0f, 10);
+
+    counter.Add(3);
+    histogram.Record(2.0);
+    histogram.Record(4.0);
+
+    ezMetrics::Snapshot();
+    ezMetrics::ExportToStats();
+
+    EZ_TEST_INT(ezStats::GetStat("MetricsTest/ExportCounter").ConvertTo<ezInt32>(), 3);
+    EZ_TEST_DOUBLE(ezStats::GetStat("MetricsTest/ExportHistogram/Avg").ConvertTo<double>(), 3.0, 0.0001);
+    EZ_TEST_INT(ezStats::GetStat("MetricsTest/ExportHistogram/Samples").ConvertTo<ezInt32>(), 2);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Time Series")
+  {
+    ezMetricCounter counter = ezMetrics::RegisterCounter("MetricsTest/TimeSeries");
+
+    ezMetrics::StartRecording(3);
+    EZ_TEST_BOOL(ezMetrics::IsRecording());
+
+    for (ezUInt32 i = 1; i <= 5; ++i)
+    {
+      counter.Add(i);
+      ezMetrics::Snapshot();
+    }
+
+    ezMetrics::StopRecording();
+    EZ_TEST_BOOL(!ezMetrics::IsRecording());
+
+    // only the last three frames are kept
+    EZ_TEST_INT(ezMetrics::GetNumRecordedFrames(), 3);
+
+    ezMetrics::Snapshot();
+    EZ_TEST_INT(ezMetrics::GetNumRecordedFrames(), 3);
+
+    const ezUInt32 uiColumn = ezMetrics::GetNumMetrics() - 1;
+
+    {
+      ezContiguousMemoryStreamStorage storage;
+      ezMemoryStreamWriter writer(&storage);
+      EZ_TEST_BOOL(ezMetrics::WriteTimeSeriesCSV(writer).Succeeded());
+
+      ezStringBuilder sCSV;
+      sCSV.SetSubString_ElementCount(reinterpret_cast<const char*>(storage.GetData()), storage.GetStorageSize32());
+
+      ezDynamicArray<ezStringView> lines;
+      sCSV.Split(false, lines, "\n");
+      EZ_TEST_INT(lines.GetCount(), 4);
+
+      ezDynamicArray<ezStringView> columns;
+      lines[0].Split(false, columns, ",");
+      EZ_TEST_STRING(columns[0], "Time");
+      EZ_TEST_STRING(columns[uiColumn + 1], "MetricsTest/TimeSeries");
+
+      for (ezUInt32 i = 1; i < 4; ++i)
+      {
+        lines[i].Split(true, columns, ",");
+        EZ_TEST_INT(columns.GetCount(), ezMetrics::GetNumMetrics() + 1);
+
+        ezStringBuilder sExpected;
+        sExpected.SetFormat("{}", i + 2);
+        EZ_TEST_STRING(columns[uiColumn + 1], sExpected);
+      }
+    }
+
+    {
+      ezContiguousMemoryStreamStorage storage;
+      ezMemoryStreamWriter writer(&storage);
+      EZ_TEST_BOOL(ezMetrics::WriteTimeSeriesJSON(writer).Succeeded());
+
+      ezStringBuilder sJSON;
+      sJSON.SetSubString_ElementCount(reinterpret_cast<const char*>(storage.GetData()), storage.GetStorageSize32());
+      EZ_TEST_BOOL(sJSON.FindSubString("\"MetricsTest/TimeSeries\"") != nullptr);
+      EZ_TEST_BOOL(sJSON.FindSubString("\"Frames\"") != nullptr);
+    }
+  }
+}
@@ -8,7 +8,21 @@
 #include <Foundation/System/MiniDumpUtils.h>
 #include <Foundation/System/Process.h>
 #include <GameEngineTest/SubstanceTest/SubstanceTest.h>
+#include <Foundation/Time/Stopwatch.h>
 #include <RendererCore/Components/SkyBoxComponent.h>
+#include <Foundation/Reflection/ReflectionUtils.h>
+#include <RendererCore/Pipeline/Extractor.h>
+#include <RendererCore/Pipeline/Implementation/RenderPipelineResourceLoader.h>
+#include <RendererCore/Pipeline/Passes/AOPass.h>
+#include <RendererCore/Pipeline/Passes/DepthOnlyPass.h>
+#include <RendererCore/Pipeline/Passes/OpaqueForwardRenderPass.h>
+#include <RendererCore/Pipeline/Passes/SkyRenderPass.h>
+#include <RendererCore/Pipeline/Passes/SourcePass.h>
+#include <RendererCore/Pipeline/Passes/TargetPass.h>
+#include <RendererCore/Pipeline/Passes/TransparentForwardRenderPass.h>
+#include <RendererCore/Pipeline/RenderPipeline.h>
+#include <RendererCore/Pipeline/View.h>
+#include <Texture/Image/ImageUtils.h>
 #include <RendererCore/RenderContext/RenderContext.h>
 #include <RendererCore/RenderWorld/RenderWorld.h>
 #include <RendererCore/Textures/TextureCubeResource.h>
@@ -254,11 +268,13 @@ ezGameEngineTestApplication* ezGameEngineTestBasics::CreateApplication()
 void ezGameEngineTestBasics::SetupSubTests()
 {
   AddSubTest("Many Meshes", SubTests::ManyMeshes);
+  AddSubTest("Parallel Extraction", SubTests::ParallelExtraction);
   AddSubTest("Skybox", SubTests::Skybox);
   AddSubTest("Debug Rendering", SubTests::DebugRendering);
   AddSubTest("Debug Rendering - No Lines", SubTests::DebugRendering2);
   AddSubTest("Load Scene", SubTests::LoadScene);
   AddSubTest("GameObject References", SubTests::GameObjectReferences);
+  AddSubTest("Parallel Recording", SubTests::ParallelRecording);
 }
 
 ezResult ezGameEngineTestBasics::InitializeSubTest(ezInt32 iIdentifier)
@@ -273,6 +289,12 @@ ezResult ezGameEngineTestBasics::InitializeSubTest(ezInt32 iIdentifier)
     return EZ_SUCCESS;
   }
 
+  if (iIdentifier == SubTests::ParallelExtraction)
+  {
+    m_pOwnApplication->SubTestParallelExtractionSetup();
+    return EZ_SUCCESS;
+  }
+
   if (iIdentifier == SubTests::Skybox)
   {
     m_pOwnApplication->SubTestSkyboxSetup();
@@ -297,6 +319,12 @@ ezResult ezGameEngineTestBasics::InitializeSubTest(ezInt32 iIdentifier)
     return EZ_SUCCESS;
   }
 
+  if (iIdentifier == SubTests::ParallelRecording)
+  {
+    m_pOwnApplication->SubTestManyMeshesSetup();
+    return EZ_SUCCESS;
+  }
+
   return EZ_FAILURE;
 }
 
@@ -307,6 +335,9 @@ ezTestAppRun ezGameEngineTestBasics::RunSubTest(ezInt32 iIdentifier, ezUInt32 ui
   if (iIdentifier == SubTests::ManyMeshes)
     return m_pOwnApplication->SubTestManyMeshesExec(m_iFrame);
 
+  if (iIdentifier == SubTests::ParallelExtraction)
+    return m_pOwnApplication->SubTestParallelExtractionExec(m_iFrame);
+
   if (iIdentifier == SubTests::Skybox)
     return m_pOwnApplication->SubTestSkyboxExec(m_iFrame);
 
@@ -322,6 +353,9 @@ ezTestAppRun ezGameEngineTestBasics::RunSubTest(ezInt32 iIdentifier, ezUInt32 ui
   if (iIdentifier == SubTests::GameObjectReferences)
     return m_pOwnApplication->SubTestGoReferenceExec(m_iFrame);
 
+  if (iIdentifier == SubTests::ParallelRecording)
+    return m_pOwnApplication->SubTestParallelRecordingExec(m_iFrame);
+
   EZ_ASSERT_NOT_IMPLEMENTED;
   return ezTestAppRun::Quit;
 }
@@ -392,6 +426,174 @@ ezTestAppRun ezGameEngineTestApplication_Basics::SubTestManyMeshesExec(ezInt32 i
 
 //////////////////////////////////////////////////////////////////////////
 
+void ezGameEngineTestApplication_Basics::SubTestParallelExtractionSetup()
+{
+  EZ_LOCK(m_pWorld->GetWriteMarker());
+
+  m_pWorld->Clear();
+
+  ezMeshResourceHandle hMesh = ezResourceManager::LoadResource<ezMeshResource>("Meshes/MissingMesh.ezBinMesh");
+
+  // 29^3 = 24389 mesh components
+  ezInt32 dim = 14;
+
+  for (ezInt32 z = -dim; z <= dim; ++z)
+  {
+    for (ezInt32 y = -dim; y <= dim; ++y)
+    {
+      for (ezInt32 x = -dim; x <= dim; ++x)
+      {
+        ezGameObjectDesc go;
+        go.m_LocalPosition.Set(x * 5.0f, y * 5.0f, z * 5.0f);
+        // every other object is dynamic, so both the cached and the uncached extraction path are used
+        go.m_bDynamic = (x & 1) != 0;
+
+        ezGameObject* pObject;
+        m_pWorld->CreateObject(go, pObject);
+
+        ezMeshComponent* pMesh;
+        m_pWorld->GetOrCreateComponentManager<ezMeshComponentManager>()->CreateComponent(pObject, pMesh);
+
+        pMesh->SetMesh(hMesh);
+      }
+    }
+  }
+}
+
+ezTestAppRun ezGameEngineTestApplication_Basics::SubTestParallelExtractionExec(ezInt32 iCurFrame)
+{
+  ezResourceManager::ForceNoFallbackAcquisition(3);
+
+  Run();
+  if (ShouldApplicationQuit())
+    return ezTestAppRun::Quit;
+
+  // make sure the mesh is loaded, the extraction itself doesn't touch the GPU
+  if (iCurFrame < 3)
+    return ezTestAppRun::Continue;
+
+  ezCVarBool* pMultithreading = static_cast<ezCVarBool*>(ezCVar::FindCVarByName("Spatial.Extraction.Multithreading"));
+  if (!EZ_TEST_BOOL(pMultithreading != nullptr))
+    return ezTestAppRun::Quit;
+
+  const bool bPrevMultithreading = *pMultithreading;
+  EZ_SCOPE_EXIT(*pMultithreading = bPrevMultithreading);
+
+  ezCamera camera;
+  camera.SetCameraMode(ezCameraMode::PerspectiveFixedFovY, 100.0f, 1.0f, 1000.0f);
+  camera.LookAt(ezVec3::MakeZero(), ezVec3(1, 0, 0), ezVec3(0, 0, 1));
+
+  ezView* pView = nullptr;
+  ezViewHandle hView = ezRenderWorld::CreateView("ParallelExtraction", pView);
+  EZ_SCOPE_EXIT(ezRenderWorld::DeleteView(hView));
+
+  pView->SetWorld(m_pWorld.Borrow());
+  pView->SetCamera(&camera);
+
+  ezDynamicArray<const ezGameObject*> objects;
+  {
+    EZ_LOCK(m_pWorld->GetReadMarker());
+
+    for (auto it = m_pWorld->GetObjects(); it.IsValid(); ++it)
+    {
+      objects.PushBack(it);
+    }
+  }
+
+  EZ_TEST_BOOL(objects.GetCount() >= 20000);
+
+  ezVisibleObjectsExtractor extractor;
+  ezExtractedRenderData serialData;
+  ezExtractedRenderData parallelData;
+
+  auto Extract = [&](bool bMultithreading, ezExtractedRenderData& ref_data) -> ezTime
+  {
+    *pMultithreading = bMultithreading;
+
+    ref_data.Clear();
+    ref_data.SetCamera(camera);
+
+    ezStopwatch sw;
+    extractor.Extract(*pView, objects, ref_data);
+    return sw.GetRunningTotal();
+  };
+
+  // warm up, this also fills the render data cache for the static objects
+  Extract(false, serialData);
+
+  const ezUInt32 uiNumRuns = 5;
+  ezTime serialTime;
+  ezTime parallelTime;
+
+  for (ezUInt32 i = 0; i < uiNumRuns; ++i)
+  {
+    serialTime += Extract(false, serialData);
+    parallelTime += Extract(true, parallelData);
+  }
+
+  ezTestFramework::Output(ezTestOutput::Duration, "Extracting %u objects: serial %.2fms, parallel %.2fms (%u worker threads)", objects.GetCount(),
+    serialTime.GetMilliseconds() / uiNumRuns, parallelTime.GetMilliseconds() / uiNumRuns, ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks));
+
+  serialData.SortAndBatch();
+  parallelData.SortAndBatch();
+
+  // the chunks are merged in order, so the result has to be identical to the serial one, down to the order within each batch
+  ezDynamicArray<ezHashedString> categoryNames;
+  ezRenderData::GetAllCategoryNames(categoryNames);
+
+  ezUInt32 uiNumRenderData = 0;
+  ezUInt32 uiNumMismatches = 0;
+
+  for (const ezHashedString& sCategoryName : categoryNames)
+  {
+    const ezRenderData::Category category = ezRenderData::FindCategory(sCategoryName);
+
+    ezRenderDataBatchList serialBatches = serialData.GetRenderDataBatchesWithCategory(category);
+    ezRenderDataBatchList parallelBatches = parallelData.GetRenderDataBatchesWithCategory(category);
+
+    if (!EZ_TEST_INT(parallelBatches.GetBatchCount(), serialBatches.GetBatchCount()))
+      continue;
+
+    for (ezUInt32 uiBatch = 0; uiBatch < serialBatches.GetBatchCount(); ++uiBatch)
+    {
+      ezRenderDataBatch serialBatch = serialBatches.GetBatch(uiBatch);
+      ezRenderDataBatch parallelBatch = parallelBatches.GetBatch(uiBatch);
+
+      if (!EZ_TEST_INT(parallelBatch.GetCount(), serialBatch.GetCount()))
+        continue;
+
+      auto itSerial = serialBatch.GetIterator<ezRenderData>();
+      auto itParallel = parallelBatch.GetIterator<ezRenderData>();
+
+      for (; itSerial.IsValid() && itParallel.IsValid(); itSerial.Next(), itParallel.Next())
+      {
+        const ezRenderData* pSerial = itSerial;
+        const ezRenderData* pParallel = itParallel;
+
+        // dynamic render data is allocated anew on every extraction, so compare the content
+        const bool bEqual = pSerial == pParallel ||
+                            (pSerial->GetDynamicRTTI() == pParallel->GetDynamicRTTI() && pSerial->m_hOwner == pParallel->m_hOwner &&
+                              pSerial->m_uiBatchId == pParallel->m_uiBatchId && pSerial->m_uiSortingKey == pParallel->m_uiSortingKey &&
+                              pSerial->m_GlobalTransform.IsIdentical(pParallel->m_GlobalTransform));
+
+        if (!bEqual)
+        {
+          ++uiNumMismatches;
+        }
+
+        ++uiNumRenderData;
+      }
+    }
+  }
+
+  EZ_TEST_INT(uiNumMismatches, 0);
+  EZ_TEST_BOOL(uiNumRenderData >= objects.GetCount());
+
+  return ezTestAppRun::Quit;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
 
 void ezGameEngineTestApplication_Basics::SubTestSkyboxSetup()
 {
@@ -654,3 +856,173 @@ ezTestAppRun ezGameEngineTestApplication_Basics::SubTestGoReferenceExec(ezInt32
 
   return ezTestAppRun::Continue;
 }
+
+//////////////////////////////////////////////////////////////////////////
+
+static ezRenderPipelineResourceHandle CreateParallelRecordingPipeline()
+{
+  // Same order as the forward passes of the default pipelines: depth pre-pass, AO, opaque, sky and transparent pass can all be recorded in parallel.
+  ezUniquePtr<ezRenderPipeline> pRenderPipeline = EZ_DEFAULT_NEW(ezRenderPipeline);
+
+  auto SetProperty = [](ezRenderPipelinePass* pPass, const char* szProperty, const ezVariant& value)
+  {
+    auto pProperty = static_cast<const ezAbstractMemberProperty*>(pPass->GetDynamicRTTI()->FindPropertyByName(szProperty));
+    ezReflectionUtils::SetMemberPropertyValue(pProperty, pPass, value);
+  };
+
+  ezSourcePass* pColorSourcePass = nullptr;
+  {
+    ezUniquePtr<ezSourcePass> pPass = EZ_DEFAULT_NEW(ezSourcePass, "ColorSource");
+    pColorSourcePass = pPass.Borrow();
+    SetProperty(pColorSourcePass, "Clear", true);
+    pRenderPipeline->AddPass(std::move(pPass));
+  }
+
+  ezSourcePass* pDepthSourcePass = nullptr;
+  {
+    ezUniquePtr<ezSourcePass> pPass = EZ_DEFAULT_NEW(ezSourcePass, "DepthStencil");
+    pDepthSourcePass = pPass.Borrow();
+    SetProperty(pDepthSourcePass, "Format", ezInt64(ezSourceFormat::Depth24BitStencil8Bit));
+    SetProperty(pDepthSourcePass, "Clear", true);
+    pRenderPipeline->AddPass(std::move(pPass));
+  }
+
+  ezDepthOnlyPass* pDepthPass = nullptr;
+  {
+    ezUniquePtr<ezDepthOnlyPass> pPass = EZ_DEFAULT_NEW(ezDepthOnlyPass);
+    pDepthPass = pPass.Borrow();
+    pRenderPipeline->AddPass(std::move(pPass));
+  }
+
+  ezAOPass* pAOPass = nullptr;
+  {
+    ezUniquePtr<ezAOPass> pPass = EZ_DEFAULT_NEW(ezAOPass);
+    pAOPass = pPass.Borrow();
+    pRenderPipeline->AddPass(std::move(pPass));
+  }
+
+  ezOpaqueForwardRenderPass* pOpaquePass = nullptr;
+  {
+    ezUniquePtr<ezOpaqueForwardRenderPass> pPass = EZ_DEFAULT_NEW(ezOpaqueForwardRenderPass);
+    pOpaquePass = pPass.Borrow();
+    pRenderPipeline->AddPass(std::move(pPass));
+  }
+
+  ezSkyRenderPass* pSkyPass = nullptr;
+  {
+    ezUniquePtr<ezSkyRenderPass> pPass = EZ_DEFAULT_NEW(ezSkyRenderPass);
+    pSkyPass = pPass.Borrow();
+    pRenderPipeline->AddPass(std::move(pPass));
+  }
+
+  ezTransparentForwardRenderPass* pTransparentPass = nullptr;
+  {
+    ezUniquePtr<ezTransparentForwardRenderPass> pPass = EZ_DEFAULT_NEW(ezTransparentForwardRenderPass);
+    pTransparentPass = pPass.Borrow();
+    pRenderPipeline->AddPass(std::move(pPass));
+  }
+
+  ezTargetPass* pTargetPass = nullptr;
+  {
+    ezUniquePtr<ezTargetPass> pPass = EZ_DEFAULT_NEW(ezTargetPass);
+    pTargetPass = pPass.Borrow();
+    pRenderPipeline->AddPass(std::move(pPass));
+  }
+
+  EZ_VERIFY(pRenderPipeline->Connect(pDepthSourcePass, "Output", pDepthPass, "DepthStencil"), "Connect failed!");
+  EZ_VERIFY(pRenderPipeline->Connect(pColorSourcePass, "Output", pOpaquePass, "Color"), "Connect failed!");
+  EZ_VERIFY(pRenderPipeline->Connect(pDepthPass, "DepthStencil", pAOPass, "DepthInput"), "Connect failed!");
+  EZ_VERIFY(pRenderPipeline->Connect(pDepthPass, "DepthStencil", pOpaquePass, "DepthStencil"), "Connect failed!");
+  EZ_VERIFY(pRenderPipeline->Connect(pAOPass, "Output", pOpaquePass, "SSAO"), "Connect failed!");
+  EZ_VERIFY(pRenderPipeline->Connect(pOpaquePass, "Color", pSkyPass, "Color"), "Connect failed!");
+  EZ_VERIFY(pRenderPipeline->Connect(pOpaquePass, "DepthStencil", pSkyPass, "DepthStencil"), "Connect failed!");
+  EZ_VERIFY(pRenderPipeline->Connect(pSkyPass, "Color", pTransparentPass, "Color"), "Connect failed!");
+  EZ_VERIFY(pRenderPipeline->Connect(pSkyPass, "DepthStencil", pTransparentPass, "DepthStencil"), "Connect failed!");
+  EZ_VERIFY(pRenderPipeline->Connect(pTransparentPass, "Color", pTargetPass, "Color0"), "Connect failed!");
+
+  ezRenderPipelineResourceDescriptor desc;
+  ezRenderPipelineResourceLoader::CreateRenderPipelineResourceDescriptor(pRenderPipeline.Borrow(), desc);
+
+  return ezResourceManager::GetOrCreateResource<ezRenderPipelineResource>("ParallelRecordingTestPipeline", std::move(desc), "ParallelRecordingTestPipeline");
+}
+
+ezTestAppRun ezGameEngineTestApplication_Basics::SubTestParallelRecordingExec(ezInt32 iCurFrame)
+{
+  ezCVarBool* pParallelRecording = static_cast<ezCVarBool*>(ezCVar::FindCVarByName("Rendering.ParallelRecording"));
+  if (!EZ_TEST_BOOL(pParallelRecording != nullptr))
+    return ezTestAppRun::Quit;
+
+  ezView* pView = nullptr;
+  if (!EZ_TEST_BOOL(ezRenderWorld::TryGetView(ezDynamicCast<ezGameEngineTestGameState*>(GetActiveGameState())->GetMainViewHandle(), pView)))
+    return ezTestAppRun::Quit;
+
+  if (iCurFrame == 0)
+  {
+    auto pCamera = ezDynamicCast<ezGameState*>(GetActiveGameState())->GetMainCamera();
+    pCamera->SetCameraMode(ezCameraMode::PerspectiveFixedFovY, 100.0f, 1.0f, 1000.0f);
+    pCamera->LookAt(ezVec3::MakeZero(), ezVec3(1, 0, 0), ezVec3(0, 0, 1));
+
+    ezRenderContext::GetDefaultInstance()->SetAllowAsyncShaderLoading(false);
+
+    m_hPrevRenderPipeline = pView->GetRenderPipelineResource();
+    pView->SetRenderPipelineResource(CreateParallelRecordingPipeline());
+
+    m_bPrevParallelRecording = *pParallelRecording;
+    *pParallelRecording = false;
+  }
+  else if (iCurFrame == 5)
+  {
+    // the screenshot is taken every frame, keep the serially recorded one as the reference
+    m_SerialRecordingImage.ResetAndCopy(GetLastScreenshot());
+
+    *pParallelRecording = true;
+    ezProfilingSystem::Clear();
+  }
+
+  Run();
+  if (ShouldApplicationQuit())
+    return ezTestAppRun::Quit;
+
+  if (iCurFrame < 10)
+    return ezTestAppRun::Continue;
+
+  ezProfilingSystem::ProfilingData profilingData;
+  ezProfilingSystem::Capture(profilingData);
+
+  pView->SetRenderPipelineResource(m_hPrevRenderPipeline);
+  *pParallelRecording = m_bPrevParallelRecording;
+
+#if EZ_ENABLED(EZ_USE_PROFILING)
+  // Otherwise CanRecordPassesInParallel() always takes the serial path and the comparison below is meaningless.
+  if (ezGALDevice::GetDefaultDevice()->GetCapabilities().m_bSupportsMultithreadedResourceCreation)
+  {
+    bool bRecordedInParallel = false;
+    for (const auto& eventBuffer : profilingData.m_AllEventBuffers)
+    {
+      for (const auto& scope : eventBuffer.m_Data)
+      {
+        bRecordedInParallel |= ezStringUtils::IsEqual(scope.m_szName, "RecordPassesInParallel");
+      }
+    }
+
+    EZ_TEST_BOOL_MSG(bRecordedInParallel, "The passes were not recorded in parallel.");
+  }
+  else
+  {
+    ezTestFramework::Output(ezTestOutput::Details, "The device doesn't support multi-threaded resource creation, the passes are always recorded serially.");
+  }
+#endif
+
+  const ezImage& parallelRecordingImage = GetLastScreenshot();
+
+  if (!EZ_TEST_INT(parallelRecordingImage.GetWidth(), m_SerialRecordingImage.GetWidth()) ||
+      !EZ_TEST_INT(parallelRecordingImage.GetHeight(), m_SerialRecordingImage.GetHeight()))
+    return ezTestAppRun::Quit;
+
+  // both recordings issue the same draw calls in the same order, so the result has to be identical
+  ezImage difference;
+  ezImageUtils::ComputeImageDifferenceABS(m_SerialRecordingImage, parallelRecordingImage, difference);
+  EZ_TEST_INT(ezImageUtils::ComputeMeanSquareError(difference, 32), 0);
+
+  return ezTestAppRun::Quit;
+}
@@ -3,6 +3,7 @@
 #include <GameEngineTest/GameEngineTestPCH.h>
 
 #include "../TestClass/TestClass.h"
+#include <RendererCore/Pipeline/RenderPipelineResource.h>
 
 class ezGameEngineTestApplication_Basics : public ezGameEngineTestApplication
 {
@@ -12,6 +13,9 @@ public:
   void SubTestManyMeshesSetup();
   ezTestAppRun SubTestManyMeshesExec(ezInt32 iCurFrame);
 
+  void SubTestParallelExtractionSetup();
+  ezTestAppRun SubTestParallelExtractionExec(ezInt32 iCurFrame);
+
   void SubTestSkyboxSetup();
   ezTestAppRun SubTestSkyboxExec(ezInt32 iCurFrame);
 
@@ -25,6 +29,13 @@ public:
 
   void SubTestGoReferenceSetup();
   ezTestAppRun SubTestGoReferenceExec(ezInt32 iCurFrame);
+
+  ezTestAppRun SubTestParallelRecordingExec(ezInt32 iCurFrame);
+
+private:
+  ezImage m_SerialRecordingImage;
+  ezRenderPipelineResourceHandle m_hPrevRenderPipeline;
+  bool m_bPrevParallelRecording = false;
 };
 
 class ezGameEngineTestBasics : public ezGameEngineTest
@@ -39,11 +50,13 @@ private:
   enum SubTests
   {
     ManyMeshes,
+    ParallelExtraction,
     Skybox,
     DebugRendering,
     DebugRendering2,
     LoadScene,
     GameObjectReferences,
+    ParallelRecording,
   };
 
   virtual void SetupSubTests() override;
@@ -0,0 +1,244 @@
+#include <GameEngineTest/GameEngineTestPCH.h>
+
+#ifdef BUILDSYSTEM_ENABLE_ENET_SUPPORT
+
+#  include <FileservePlugin/Client/FileserveClient.h>
+#  include <FileservePlugin/Fileserver/Fileserver.h>
+#  include <Foundation/Communication/GlobalEvent.h>
+#  include <Foundation/IO/FileSystem/FileReader.h>
+#  include <Foundation/IO/FileSystem/FileSystem.h>
+#  include <Foundation/IO/OSFile.h>
+#  include <Foundation/Threading/Thread.h>
+#  include <Foundation/Time/Stopwatch.h>
+
+EZ_CREATE_SIMPLE_TEST_GROUP(Fileserve);
+
+namespace
+{
+  class FileserveTestServerThread : public ezThread
+  {
+  public:
+    FileserveTestServerThread()
+      : ezThread("Fileserve Test Server")
+    {
+    }
+
+    ezAtomicBool m_bKeepRunning = true;
+
+  private:
+    virtual ezUInt32 Run() override
+    {
+      while (m_bKeepRunning)
+      {
+        if (!ezFileserver::GetSingleton()->UpdateServer())
+        {
+          ezThreadUtils::YieldTimeSlice();
+        }
+      }
+
+      return 0;
+    }
+  };
+
+  void CreateFileserveTestFileContent(ezUInt32 uiFile, ezUInt32 uiSeed, ezDynamicArray<ezUInt8>& out_content)
+  {
+    // text-like data of varying size, so that compression has something to do
+    const ezUInt32 uiSize = (uiFile % 100 == 0) ? 256 * 1024 : 512 + (uiFile * 1237) % (16 * 1024);
+
+    ezStringBuilder sLine;
+    out_content.Clear();
+    out_content.Reserve(uiSize);
+
+    while (out_content.GetCount() < uiSize)
+    {
+      sLine.SetFormat("File {} line {} seed {}\n", uiFile, out_content.GetCount() / 32, uiSeed);
+      out_content.PushBackRange(ezArrayPtr<const ezUInt8>(reinterpret_cast<const ezUInt8*>(sLine.GetData()), sLine.GetElementCount()));
+    }
+
+    out_content.SetCount(uiSize);
+  }
+
+  bool ReadFileserveTestFile(ezStringView sFile, ezDynamicArray<ezUInt8>& out_content)
+  {
+    ezFileReader file;
+    if (file.Open(sFile).Failed())
+      return false;
+
+    out_content.SetCountUninitialized(static_cast<ezUInt32>(file.GetFileSize()));
+    return file.ReadBytes(out_content.GetData(), out_content.GetCount()) == out_content.GetCount();
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(Fileserve, Prefetch)
+{
+  if (ezFileserveClient::GetSingleton() != nullptr || ezFileserver::GetSingleton() != nullptr)
+  {
+    ezTestFramework::Output(ezTestOutput::Details, "Fileserve is already in use by this process, skipping the loopback test.");
+    return;
+  }
+
+  constexpr ezUInt32 uiNumFiles = 1000;
+
+  // every run writes new content, so that the client cache of a previous run is outdated and everything gets transferred
+  const ezUInt32 uiSeed = static_cast<ezUInt32>(ezTime::Now().GetMicroseconds());
+
+  ezStringBuilder sFolder = ezTestFramework::GetInstance()->GetAbsOutputPath();
+  sFolder.MakeCleanPath();
+  sFolder.AppendPath("Fileserve", "Prefetch");
+
+  ezOSFile::DeleteFolder(sFolder).IgnoreResult();
+
+  // one set of files for each protocol
+  ezDynamicArray<ezString> filesSingle, filesBatch;
+  ezDynamicArray<ezUInt8> content;
+  ezUInt64 uiTotalSize = 0;
+
+  {
+    ezStringBuilder sFile;
+    for (ezUInt32 i = 0; i < uiNumFiles * 2; ++i)
+    {
+      CreateFileserveTestFileContent(i, uiSeed, content);
+      uiTotalSize += (i < uiNumFiles) ? content.GetCount() : 0;
+
+      sFile.SetFormat("Set{}/File{}.txt", i < uiNumFiles ? "Single" : "Batch", i);
+      (i < uiNumFiles ? filesSingle : filesBatch).PushBack(sFile);
+
+      sFile.Prepend(sFolder, "/");
+
+      ezOSFile file;
+      if (!EZ_TEST_BOOL(ezOSFile::CreateDirectoryStructure(sFile.GetFileDirectory()).Succeeded() && file.Open(sFile, ezFileOpenMode::Write).Succeeded()))
+        return;
+
+      EZ_TEST_BOOL(file.Write(content.GetData(), content.GetCount()).Succeeded());
+    }
+  }
+
+  ezFileSystem::SetSpecialDirectory("fileservetest", sFolder);
+
+  ezFileserver server;
+  server.SetPort(1142);
+  server.StartServer();
+
+  // creating the server switched the client off
+  ezFileserveClient::EnableFileserveClient();
+
+  ezFileserveClient* pClient = EZ_DEFAULT_NEW(ezFileserveClient);
+  pClient->AddServerAddressToTry("localhost:1142");
+
+  FileserveTestServerThread serverThread;
+  serverThread.Start();
+
+  EZ_SCOPE_EXIT(
+    ezFileSystem::RemoveDataDirectoryGroup("FileserveTest");
+    EZ_DEFAULT_DELETE(pClient);
+    serverThread.m_bKeepRunning = false;
+    serverThread.Join();
+    server.StopServer();
+    ezFileSystem::SetSpecialDirectory("fileservetest", {}););
+
+  if (!EZ_TEST_BOOL(pClient->EnsureConnected(ezTime::MakeFromSeconds(10)).Succeeded()))
+    return;
+
+  if (!EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(">fileservetest/", "FileserveTest", "fstest", ezDataDirUsage::ReadOnly).Succeeded()))
+    return;
+
+  ezStringBuilder sFile;
+  ezDynamicArray<ezUInt8> expected;
+
+  ezTime tSingle;
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "One request per file")
+  {
+    ezStopwatch sw;
+
+    for (ezUInt32 i = 0; i < uiNumFiles; ++i)
+    {
+      sFile.Set(":fstest/", filesSingle[i]);
+      EZ_TEST_BOOL(ReadFileserveTestFile(sFile, content));
+    }
+
+    tSingle = sw.GetRunningTotal();
+
+    for (ezUInt32 i = 0; i < uiNumFiles; i += 97)
+    {
+      sFile.Set(":fstest/", filesSingle[i]);
+      CreateFileserveTestFileContent(i, uiSeed, expected);
+      EZ_TEST_BOOL(ReadFileserveTestFile(sFile, content) && content == expected);
+    }
+  }
+
+  ezTime tBatch;
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Prefetch")
+  {
+    ezStopwatch sw;
+
+    EZ_TEST_BOOL(pClient->PrefetchFiles(filesBatch).Succeeded());
+
+    // all files are in the local cache now, opening them doesn't need the server anymore
+    for (ezUInt32 i = 0; i < uiNumFiles; ++i)
+    {
+      sFile.Set(":fstest/", filesBatch[i]);
+      EZ_TEST_BOOL(ReadFileserveTestFile(sFile, content));
+    }
+
+    tBatch = sw.GetRunningTotal();
+
+    for (ezUInt32 i = 0; i < uiNumFiles; ++i)
+    {
+      sFile.Set(":fstest/", filesBatch[i]);
+      CreateFileserveTestFileContent(uiNumFiles + i, uiSeed, expected);
+      EZ_TEST_BOOL(ReadFileserveTestFile(sFile, content) && content == expected);
+    }
+
+    // the files were just checked, so this does not send anything
+    EZ_TEST_BOOL(pClient->PrefetchFiles(filesBatch).Succeeded());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Missing files")
+  {
+    ezDynamicArray<ezString> missing;
+    missing.PushBack("SetBatch/DoesNotExist.txt");
+    missing.PushBack(filesBatch[0]);
+
+    EZ_TEST_BOOL(pClient->PrefetchFiles(missing).Succeeded());
+    EZ_TEST_BOOL(!ezFileSystem::ExistsFile(":fstest/SetBatch/DoesNotExist.txt"));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Scene loading event")
+  {
+    // this is what ezSceneLoadUtility broadcasts with the files of the preload collection
+    ezVariantArray eventFiles;
+
+    for (ezUInt32 i = 0; i < 100; ++i)
+    {
+      CreateFileserveTestFileContent(i, uiSeed + 1, content);
+
+      sFile.SetFormat("SetEvent/File{}.txt", i);
+      eventFiles.PushBack(ezString(sFile));
+
+      sFile.Prepend(sFolder, "/");
+
+      ezOSFile file;
+      if (EZ_TEST_BOOL(ezOSFile::CreateDirectoryStructure(sFile.GetFileDirectory()).Succeeded() && file.Open(sFile, ezFileOpenMode::Write).Succeeded()))
+      {
+        EZ_TEST_BOOL(file.Write(content.GetData(), content.GetCount()).Succeeded());
+      }
+    }
+
+    ezGlobalEvent::Broadcast("SceneLoading_PrefetchFiles", eventFiles);
+
+    for (ezUInt32 i = 0; i < eventFiles.GetCount(); ++i)
+    {
+      sFile.Set(":fstest/", eventFiles[i].Get<ezString>());
+      CreateFileserveTestFileContent(i, uiSeed + 1, expected);
+      EZ_TEST_BOOL(ReadFileserveTestFile(sFile, content) && content == expected);
+    }
+  }
+
+  ezTestFramework::Output(ezTestOutput::Details, "%u files, %.1f MB per protocol", uiNumFiles, uiTotalSize / (1024.0 * 1024.0));
+  ezTestFramework::Output(ezTestOutput::Duration, "One request per file: %.2fms (%.0f files/sec)", tSingle.GetMilliseconds(), uiNumFiles / tSingle.GetSeconds());
+  ezTestFramework::Output(ezTestOutput::Duration, "Prefetch: %.2fms (%.0f files/sec)", tBatch.GetMilliseconds(), uiNumFiles / tBatch.GetSeconds());
+
+  ezOSFile::DeleteFolder(sFolder).IgnoreResult();
+}
+
+#endif
@@ -0,0 +1,122 @@
+#include <GameEngineTest/GameEngineTestPCH.h>
+
+#include <Core/World/World.h>
+#include <Foundation/Configuration/CVar.h>
+#include <Foundation/System/SystemInformation.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <Foundation/Types/ScopeExit.h>
+#include <JoltPlugin/Actors/JoltDynamicActorComponent.h>
+#include <JoltPlugin/Actors/JoltStaticActorComponent.h>
+#include <JoltPlugin/Shapes/JoltShapeBoxComponent.h>
+
+EZ_CREATE_SIMPLE_TEST_GROUP(Jolt);
+
+EZ_CREATE_SIMPLE_TEST(Jolt, Profile_BodyStack)
+{
+  ezCVarBool* pUseTaskSystem = static_cast<ezCVarBool*>(ezCVar::FindCVarByName("Jolt.UseTaskSystem"));
+  if (!EZ_TEST_BOOL(pUseTaskSystem != nullptr))
+    return;
+
+  const bool bPrevUseTaskSystem = *pUseTaskSystem;
+  EZ_SCOPE_EXIT(*pUseTaskSystem = bPrevUseTaskSystem);
+
+  // 16 x 16 columns with 12 boxes each
+  constexpr ezInt32 iColumns = 16;
+  constexpr ezUInt32 uiHeight = 12;
+  constexpr ezUInt32 uiNumFrames = 120;
+
+  // builds the same scene from scratch and returns the average time per frame
+  auto SimulateStack = [&](bool bUseTaskSystem) -> ezTime
+  {
+    *pUseTaskSystem = bUseTaskSystem;
+
+    ezWorldDesc worldDesc("JoltBodyStack");
+    ezWorld world(worldDesc);
+    EZ_LOCK(world.GetWriteMarker());
+
+    world.GetClock().SetFixedTimeStep(ezTime::MakeFromSeconds(1.0 / 60.0));
+
+    {
+      ezGameObjectDesc go;
+      go.m_LocalPosition.Set(0, 0, -0.5f);
+
+      ezGameObject* pGround;
+      world.CreateObject(go, pGround);
+
+      ezJoltStaticActorComponent* pActor;
+      ezJoltStaticActorComponent::CreateComponent(pGround, pActor);
+
+      ezJoltShapeBoxComponent* pShape;
+      ezJoltShapeBoxComponent::CreateComponent(pGround, pShape);
+      pShape->SetHalfExtents(ezVec3(iColumns * 2.0f, iColumns * 2.0f, 0.5f));
+    }
+
+    ezDynamicArray<ezGameObjectHandle> boxes;
+
+    for (ezInt32 y = -iColumns / 2; y < iColumns / 2; ++y)
+    {
+      for (ezInt32 x = -iColumns / 2; x < iColumns / 2; ++x)
+      {
+        for (ezUInt32 z = 0; z < uiHeight; ++z)
+        {
+          ezGameObjectDesc go;
+          go.m_LocalPosition.Set(x * 2.0f, y * 2.0f, 0.5f + z * 1.01f);
+          go.m_bDynamic = true;
+
+          ezGameObject* pBox;
+          boxes.PushBack(world.CreateObject(go, pBox));
+
+          ezJoltDynamicActorComponent* pActor;
+          ezJoltDynamicActorComponent::CreateComponent(pBox, pActor);
+
+          ezJoltShapeBoxComponent* pShape;
+          ezJoltShapeBoxComponent::CreateComponent(pBox, pShape);
+          pShape->SetHalfExtents(ezVec3(0.5f));
+        }
+      }
+    }
+
+    // the first update adds all bodies to the simulation
+    world.Update();
+
+    ezStopwatch sw;
+
+    for (ezUInt32 i = 0; i < uiNumFrames; ++i)
+    {
+      world.Update();
+    }
+
+    const ezTime tFrame = sw.GetRunningTotal() / uiNumFrames;
+
+    // the stacks have to settle, so the gaps between the boxes close, but nothing may fall through the ground or get pushed away
+    float fMinHeight = ezMath::MaxValue<float>();
+    float fMaxHeight = 0.0f;
+
+    for (ezGameObjectHandle hBox : boxes)
+    {
+      ezGameObject* pBox;
+      if (EZ_TEST_BOOL(world.TryGetObject(hBox, pBox)))
+      {
+        fMinHeight = ezMath::Min(fMinHeight, pBox->GetGlobalPosition().z);
+        fMaxHeight = ezMath::Max(fMaxHeight, pBox->GetGlobalPosition().z);
+      }
+    }
+
+    EZ_TEST_BOOL(fMinHeight > 0.4f);
+    EZ_TEST_BOOL(fMaxHeight > uiHeight - 1.0f);
+    EZ_TEST_BOOL(fMaxHeight < uiHeight - 0.4f);
+
+    return tFrame;
+  };
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Task System vs. Thread Pool")
+  {
+    const ezTime tTaskSystem = SimulateStack(true);
+    const ezTime tThreadPool = SimulateStack(false);
+
+    ezTestFramework::Output(ezTestOutput::Duration, "Simulating %u bodies: task system %.2fms, thread pool %.2fms per frame (%u worker threads, %u cores)",
+      iColumns * iColumns * uiHeight, tTaskSystem.GetMilliseconds(), tThreadPool.GetMilliseconds(),
+      ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks), ezSystemInformation::Get().GetCPUCoreCount());
+  }
+}
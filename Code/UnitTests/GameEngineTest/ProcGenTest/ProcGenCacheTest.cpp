@@ -0,0 +1,229 @@
+#include <GameEngineTest/GameEngineTestPCH.h>
+
+#include <Core/World/World.h>
+#include <Foundation/CodeUtils/Expression/ExpressionByteCode.h>
+#include <Foundation/Configuration/CVar.h>
+#include <Foundation/IO/OSFile.h>
+#include <Foundation/Math/Random.h>
+#include <Foundation/SimdMath/SimdConversion.h>
+#include <Foundation/Types/ScopeExit.h>
+#include <ProcGenPlugin/Components/VolumeCollection.h>
+#include <ProcGenPlugin/WorldModule/ProcGenCacheWorldModule.h>
+
+using namespace ezProcGenInternal;
+
+EZ_CREATE_SIMPLE_TEST_GROUP(ProcGen);
+
+EZ_CREATE_SIMPLE_TEST(ProcGen, Cache)
+{
+  ezCVarString* pDirectory = static_cast<ezCVarString*>(ezCVar::FindCVarByName("ProcGen.Cache.Directory"));
+  if (!EZ_TEST_BOOL(pDirectory != nullptr))
+    return;
+
+  const ezString sPrevDirectory = *pDirectory;
+  EZ_SCOPE_EXIT(*pDirectory = sPrevDirectory);
+
+  ezStringBuilder sCacheDirectory = ezTestFramework::GetInstance()->GetAbsOutputPath();
+  sCacheDirectory.MakeCleanPath();
+  sCacheDirectory.AppendPath("ProcGen", "Cache");
+
+  ezOSFile::DeleteFolder(sCacheDirectory).IgnoreResult();
+  *pDirectory = sCacheDirectory;
+
+  ezWorldDesc worldDesc("ProcGenCache");
+  ezWorld world(worldDesc);
+  EZ_LOCK(world.GetWriteMarker());
+
+  ezProcGenCacheWorldModule* pCache = world.GetOrCreateModule<ezProcGenCacheWorldModule>();
+
+  PlacementOutput placementOutput;
+  placementOutput.m_sName.Assign("Trees");
+  placementOutput.m_uiGraphHash = 0x1234;
+
+  ezSharedPtr<VertexColorOutput> pVertexColorOutput = EZ_DEFAULT_NEW(VertexColorOutput);
+  pVertexColorOutput->m_sName.Assign("Moss");
+  pVertexColorOutput->m_uiGraphHash = 0x5678;
+
+  const ezSharedPtr<const VertexColorOutput> vertexColorOutputs[] = {pVertexColorOutput};
+  const ezProcVertexColorMapping vertexColorMappings[1] = {};
+
+  const ezTransform meshTransform = ezTransform::Make(ezVec3(1, 2, 3));
+
+  ezDeque<ezVolumeCollection> noVolumes;
+
+  auto ComputePlacementKey = [&](ezInt32 iTileX, ezInt32 iTileY, const ezDeque<ezVolumeCollection>& volumes)
+  {
+    return pCache->AddVolumesToKey(pCache->ComputePlacementKey(placementOutput, iTileX, iTileY), volumes);
+  };
+
+  auto ComputeVertexColorKey = [&](const ezDeque<ezVolumeCollection>& volumes)
+  {
+    return pCache->AddVolumesToKey(pCache->ComputeVertexColorKey(vertexColorOutputs, vertexColorMappings, "Meshes/Rock", meshTransform), volumes);
+  };
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Disabled without geometry hash")
+  {
+    EZ_TEST_BOOL(!pCache->IsEnabled());
+    EZ_TEST_INT(ComputePlacementKey(0, 0, noVolumes), 0);
+    EZ_TEST_INT(ComputeVertexColorKey(noVolumes), 0);
+  }
+
+  pCache->SetWorldGeometryHash(42);
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Placement Round-Trip")
+  {
+    const ezUInt64 uiKey = ComputePlacementKey(3, -7, noVolumes);
+    EZ_TEST_BOOL(uiKey != 0);
+
+    ezDynamicArray<PlacementTransform, ezAlignedAllocatorWrapper> loadedTransforms;
+    EZ_TEST_BOOL(pCache->LoadPlacement(uiKey, loadedTransforms).Failed());
+
+    ezRandom rng;
+    rng.Initialize(42);
+
+    ezDynamicArray<PlacementTransform, ezAlignedAllocatorWrapper> transforms;
+    for (ezUInt32 i = 0; i < 100; ++i)
+    {
+      const ezVec3 vPosition(rng.FloatMinMax(-50.0f, 50.0f), rng.FloatMinMax(-50.0f, 50.0f), rng.FloatMinMax(0.0f, 10.0f));
+      const ezQuat qRotation = ezQuat::MakeFromAxisAndAngle(ezVec3(0, 0, 1), ezAngle::MakeFromDegree(rng.FloatMinMax(0.0f, 360.0f)));
+
+      auto& transform = transforms.ExpandAndGetRef();
+      transform.m_Transform = ezSimdConversion::ToTransform(ezTransform(vPosition, qRotation, ezVec3(rng.FloatMinMax(0.5f, 2.0f))));
+      transform.m_ObjectColor = ezColor(rng.FloatZeroToOneInclusive(), rng.FloatZeroToOneInclusive(), rng.FloatZeroToOneInclusive());
+      transform.m_uiPointIndex = static_cast<ezUInt16>(i * 3);
+      transform.m_uiObjectIndex = static_cast<ezUInt8>(i % 4);
+      transform.m_bHasValidColor = (i % 3) != 0;
+      transform.m_uiPadding = 0;
+    }
+
+    pCache->StorePlacement(uiKey, transforms);
+    EZ_TEST_BOOL(pCache->HasPlacement(uiKey));
+
+    if (EZ_TEST_BOOL(pCache->LoadPlacement(uiKey, loadedTransforms).Succeeded()) && EZ_TEST_INT(loadedTransforms.GetCount(), transforms.GetCount()))
+    {
+      for (ezUInt32 i = 0; i < transforms.GetCount(); ++i)
+      {
+        const ezTransform expected = ezSimdConversion::ToTransform(transforms[i].m_Transform);
+        const ezTransform loaded = ezSimdConversion::ToTransform(loadedTransforms[i].m_Transform);
+
+        EZ_TEST_BOOL(loaded.IsEqual(expected, 0.0001f));
+        EZ_TEST_BOOL(loadedTransforms[i].m_ObjectColor.ToLinearFloat() == transforms[i].m_ObjectColor.ToLinearFloat());
+        EZ_TEST_INT(loadedTransforms[i].m_uiPointIndex, transforms[i].m_uiPointIndex);
+        EZ_TEST_INT(loadedTransforms[i].m_uiObjectIndex, transforms[i].m_uiObjectIndex);
+        EZ_TEST_BOOL(loadedTransforms[i].m_bHasValidColor == transforms[i].m_bHasValidColor);
+      }
+    }
+
+    const ezProcGenCacheWorldModule::Stats stats = pCache->GetStats();
+    EZ_TEST_INT(stats.m_uiHits, 1);
+    EZ_TEST_INT(stats.m_uiMisses, 1);
+    EZ_TEST_INT(stats.m_uiStores, 1);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Vertex Color Round-Trip")
+  {
+    const ezUInt64 uiKey = ComputeVertexColorKey(noVolumes);
+    EZ_TEST_BOOL(uiKey != 0);
+
+    ezUInt32 uiNumAllocations = 0;
+    ezDynamicArray<ezUInt32> loadedColors;
+    auto allocateFunc = [&](ezUInt32 uiCount) -> ezArrayPtr<ezUInt32>
+    {
+      ++uiNumAllocations;
+      loadedColors.SetCount(uiCount);
+      return loadedColors;
+    };
+
+    EZ_TEST_BOOL(pCache->LoadVertexColors(uiKey, allocateFunc).Failed());
+    EZ_TEST_INT(uiNumAllocations, 0);
+
+    ezDynamicArray<ezUInt32> colors;
+    for (ezUInt32 i = 0; i < 1000; ++i)
+    {
+      colors.PushBack(i * 0x01020304u);
+    }
+
+    pCache->StoreVertexColors(uiKey, colors);
+
+    // the destination is sized from the entry itself
+    EZ_TEST_BOOL(pCache->LoadVertexColors(uiKey, allocateFunc).Succeeded());
+    EZ_TEST_INT(uiNumAllocations, 1);
+    EZ_TEST_BOOL(loadedColors == colors);
+
+    // rejecting the entry counts as a miss
+    auto rejectFunc = [](ezUInt32 uiCount) -> ezArrayPtr<ezUInt32>
+    { return {}; };
+    EZ_TEST_BOOL(pCache->LoadVertexColors(uiKey, rejectFunc).Failed());
+
+    const ezProcGenCacheWorldModule::Stats stats = pCache->GetStats();
+    EZ_TEST_INT(stats.m_uiHits, 2);
+    EZ_TEST_INT(stats.m_uiMisses, 3);
+    EZ_TEST_INT(stats.m_uiStores, 2);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Invalidation")
+  {
+    const ezUInt64 uiKey = ComputePlacementKey(3, -7, noVolumes);
+
+    // other tiles and uncacheable graphs
+    EZ_TEST_BOOL(ComputePlacementKey(3, -6, noVolumes) != uiKey);
+    EZ_TEST_BOOL(ComputePlacementKey(-7, 3, noVolumes) != uiKey);
+
+    placementOutput.m_uiGraphHash = 0;
+    EZ_TEST_INT(ComputePlacementKey(3, -7, noVolumes), 0);
+    placementOutput.m_uiGraphHash = 0x1234;
+
+    // volumes
+    const ezSimdTransform volumeTransform(ezSimdVec4f(10, 0, 0));
+
+    auto CreateVolumes = [&](const ezSimdTransform& transform, ezProcGenBlendMode::Enum blendMode, float fValue, bool bReverseOrder, ezDeque<ezVolumeCollection>& out_volumes)
+    {
+      out_volumes.Clear();
+      ezVolumeCollection& volumes = out_volumes.ExpandAndGetRef();
+
+      if (bReverseOrder)
+      {
+        volumes.AddBox(volumeTransform, ezVec3(4.0f), ezProcGenBlendMode::Add, 0.0f, 0.5f, ezVec3(0.5f));
+        volumes.AddSphere(transform, 5.0f, blendMode, 0.0f, fValue, 0.5f);
+        volumes.AddSphere(volumeTransform, 2.0f, ezProcGenBlendMode::Max, 0.0f, 1.0f, 0.5f);
+      }
+      else
+      {
+        volumes.AddSphere(volumeTransform, 2.0f, ezProcGenBlendMode::Max, 0.0f, 1.0f, 0.5f);
+        volumes.AddSphere(transform, 5.0f, blendMode, 0.0f, fValue, 0.5f);
+        volumes.AddBox(volumeTransform, ezVec3(4.0f), ezProcGenBlendMode::Add, 0.0f, 0.5f, ezVec3(0.5f));
+      }
+    };
+
+    ezDeque<ezVolumeCollection> volumes;
+    CreateVolumes(volumeTransform, ezProcGenBlendMode::Set, 1.0f, false, volumes);
+    const ezUInt64 uiVolumeKey = ComputePlacementKey(3, -7, volumes);
+    EZ_TEST_BOOL(uiVolumeKey != uiKey);
+    ezDynamicArray<PlacementTransform, ezAlignedAllocatorWrapper> loadedTransforms;
+    EZ_TEST_BOOL(pCache->LoadPlacement(uiVolumeKey, loadedTransforms).Failed());
+
+    // the order in which the volumes were found doesn't matter
+    CreateVolumes(volumeTransform, ezProcGenBlendMode::Set, 1.0f, true, volumes);
+    EZ_TEST_INT(ComputePlacementKey(3, -7, volumes), uiVolumeKey);
+
+    CreateVolumes(ezSimdTransform(ezSimdVec4f(11, 0, 0)), ezProcGenBlendMode::Set, 1.0f, false, volumes);
+    EZ_TEST_BOOL(ComputePlacementKey(3, -7, volumes) != uiVolumeKey);
+
+    CreateVolumes(volumeTransform, ezProcGenBlendMode::Multiply, 1.0f, false, volumes);
+    EZ_TEST_BOOL(ComputePlacementKey(3, -7, volumes) != uiVolumeKey);
+
+    CreateVolumes(volumeTransform, ezProcGenBlendMode::Set, 0.5f, false, volumes);
+    EZ_TEST_BOOL(ComputePlacementKey(3, -7, volumes) != uiVolumeKey);
+
+    EZ_TEST_BOOL(ComputeVertexColorKey(volumes) != ComputeVertexColorKey(noVolumes));
+
+    // new geometry invalidates all entries
+    pCache->SetWorldGeometryHash(43);
+    EZ_TEST_BOOL(ComputePlacementKey(3, -7, noVolumes) != uiKey);
+
+    EZ_TEST_BOOL(pCache->LoadPlacement(ComputePlacementKey(3, -7, noVolumes), loadedTransforms).Failed());
+
+    pCache->SetWorldGeometryHash(42);
+    EZ_TEST_BOOL(pCache->LoadPlacement(uiKey, loadedTransforms).Succeeded());
+  }
+}
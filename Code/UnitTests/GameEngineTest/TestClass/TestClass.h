@@ -12,6 +12,8 @@ class ezGameEngineTestGameState : public ezGameState
 public:
   virtual void ProcessInput() override;
   virtual void ConfigureInputActions() override;
+
+  ezViewHandle GetMainViewHandle() const { return m_hMainView; }
 };
 
 class ezGameEngineTestApplication : public ezGameApplication
@@ -0,0 +1,290 @@
+#include <RendererTest/RendererTestPCH.h>
+
+#include <Core/Graphics/Camera.h>
+#include <Core/World/World.h>
+#include <Foundation/Configuration/CVar.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <Foundation/Types/ScopeExit.h>
+#include <RendererCore/Pipeline/ExtractedRenderData.h>
+#include <RendererCore/Pipeline/Extractor.h>
+#include <RendererCore/Pipeline/View.h>
+#include <RendererCore/RenderWorld/RenderWorld.h>
+
+namespace
+{
+  class ezExtractionTestRenderData : public ezRenderData
+  {
+    EZ_ADD_DYNAMIC_REFLECTION(ezExtractionTestRenderData, ezRenderData);
+
+  public:
+    ezUInt32 m_uiPart = 0;
+  };
+
+  // clang-format off
+  EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezExtractionTestRenderData, 1, ezRTTIDefaultAllocator<ezExtractionTestRenderData>)
+  EZ_END_DYNAMIC_REFLECTED_TYPE;
+  // clang-format on
+
+  class ezExtractionTestComponentManager;
+
+  /// \brief Emits a few render data per object without touching any resources, so the extraction runs without a device.
+  class ezExtractionTestComponent : public ezComponent
+  {
+    EZ_DECLARE_COMPONENT_TYPE(ezExtractionTestComponent, ezComponent, ezExtractionTestComponentManager);
+
+  public:
+    void OnMsgExtractRenderData(ezMsgExtractRenderData& msg) const
+    {
+      const ezUInt32 uiId = GetOwner()->GetHandle().GetInternalID().m_InstanceIndex;
+
+      for (ezUInt32 uiPart = 0; uiPart < m_uiNumParts; ++uiPart)
+      {
+        ezExtractionTestRenderData* pRenderData = ezCreateRenderDataForThisFrame<ezExtractionTestRenderData>(GetOwner());
+        pRenderData->m_GlobalTransform = GetOwner()->GetGlobalTransform();
+        pRenderData->m_uiPart = uiPart;
+
+        // few batches with many equal sorting keys, so the order within a batch matters
+        pRenderData->m_uiBatchId = uiId % 7;
+        pRenderData->m_uiSortingKey = uiId % 13;
+
+        msg.AddRenderData(pRenderData, uiPart == 0 ? ezDefaultRenderDataCategories::LitOpaque : ezDefaultRenderDataCategories::LitTransparent,
+          ezRenderData::Caching::IfStatic);
+      }
+    }
+
+    ezUInt32 m_uiNumParts = 1;
+  };
+
+  class ezExtractionTestComponentManager : public ezComponentManager<ezExtractionTestComponent, ezBlockStorageType::Compact>
+  {
+  public:
+    ezExtractionTestComponentManager(ezWorld* pWorld)
+      : ezComponentManager<ezExtractionTestComponent, ezBlockStorageType::Compact>(pWorld)
+    {
+    }
+  };
+
+  // clang-format off
+  EZ_BEGIN_COMPONENT_TYPE(ezExtractionTestComponent, 1, ezComponentMode::Static)
+  {
+    EZ_BEGIN_MESSAGEHANDLERS
+    {
+      EZ_MESSAGE_HANDLER(ezMsgExtractRenderData, OnMsgExtractRenderData),
+    }
+    EZ_END_MESSAGEHANDLERS;
+  }
+  EZ_END_COMPONENT_TYPE;
+  // clang-format on
+
+  ezUInt32 CompareExtractedRenderData(const ezExtractedRenderData& serialData, const ezExtractedRenderData& parallelData, ezUInt32& out_uiNumRenderData)
+  {
+    ezDynamicArray<ezHashedString> categoryNames;
+    ezRenderData::GetAllCategoryNames(categoryNames);
+
+    ezUInt32 uiNumMismatches = 0;
+    out_uiNumRenderData = 0;
+
+    for (const ezHashedString& sCategoryName : categoryNames)
+    {
+      const ezRenderData::Category category = ezRenderData::FindCategory(sCategoryName);
+
+      ezRenderDataBatchList serialBatches = serialData.GetRenderDataBatchesWithCategory(category);
+      ezRenderDataBatchList parallelBatches = parallelData.GetRenderDataBatchesWithCategory(category);
+
+      if (!EZ_TEST_INT(parallelBatches.GetBatchCount(), serialBatches.GetBatchCount()))
+      {
+        ++uiNumMismatches;
+        continue;
+      }
+
+      for (ezUInt32 uiBatch = 0; uiBatch < serialBatches.GetBatchCount(); ++uiBatch)
+      {
+        ezRenderDataBatch serialBatch = serialBatches.GetBatch(uiBatch);
+        ezRenderDataBatch parallelBatch = parallelBatches.GetBatch(uiBatch);
+
+        if (!EZ_TEST_INT(parallelBatch.GetCount(), serialBatch.GetCount()))
+        {
+          ++uiNumMismatches;
+          continue;
+        }
+
+        auto itSerial = serialBatch.GetIterator<ezExtractionTestRenderData>();
+        auto itParallel = parallelBatch.GetIterator<ezExtractionTestRenderData>();
+
+        for (; itSerial.IsValid() && itParallel.IsValid(); itSerial.Next(), itParallel.Next())
+        {
+          const ezExtractionTestRenderData* pSerial = itSerial;
+          const ezExtractionTestRenderData* pParallel = itParallel;
+
+          // the render data is allocated anew on every extraction, so compare the content
+          if (pSerial->m_hOwner != pParallel->m_hOwner || pSerial->m_uiPart != pParallel->m_uiPart || pSerial->m_uiBatchId != pParallel->m_uiBatchId ||
+              pSerial->m_uiSortingKey != pParallel->m_uiSortingKey)
+          {
+            ++uiNumMismatches;
+          }
+
+          ++out_uiNumRenderData;
+        }
+      }
+    }
+
+    return uiNumMismatches;
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST_GROUP(Extraction);
+
+EZ_CREATE_SIMPLE_TEST(Extraction, VisibleObjectsExtractor)
+{
+  ezCVarBool* pMultithreading = static_cast<ezCVarBool*>(ezCVar::FindCVarByName("Spatial.Extraction.Multithreading"));
+  if (!EZ_TEST_BOOL(pMultithreading != nullptr))
+    return;
+
+  const bool bPrevMultithreading = *pMultithreading;
+  EZ_SCOPE_EXIT(*pMultithreading = bPrevMultithreading);
+
+  ezWorldDesc worldDesc("Extraction");
+  ezWorld world(worldDesc);
+
+  // 24^3 = 13824 objects, every other one is dynamic, so both the static path with its cache insertions and the dynamic path are used
+  const ezInt32 iDim = 12;
+  {
+    EZ_LOCK(world.GetWriteMarker());
+
+    ezExtractionTestComponentManager* pManager = world.GetOrCreateComponentManager<ezExtractionTestComponentManager>();
+
+    for (ezInt32 z = -iDim; z < iDim; ++z)
+    {
+      for (ezInt32 y = -iDim; y < iDim; ++y)
+      {
+        for (ezInt32 x = -iDim; x < iDim; ++x)
+        {
+          ezGameObjectDesc go;
+          go.m_LocalPosition.Set(x * 5.0f, y * 5.0f, z * 5.0f);
+          go.m_bDynamic = (x & 1) != 0;
+
+          ezGameObject* pObject;
+          world.CreateObject(go, pObject);
+
+          ezExtractionTestComponent* pComponent;
+          pManager->CreateComponent(pObject, pComponent);
+          pComponent->m_uiNumParts = 1 + ((y + iDim) % 3);
+        }
+      }
+    }
+
+    world.Update();
+  }
+
+  ezCamera camera;
+  camera.SetCameraMode(ezCameraMode::PerspectiveFixedFovY, 100.0f, 1.0f, 1000.0f);
+  camera.LookAt(ezVec3::MakeZero(), ezVec3(1, 0, 0), ezVec3(0, 0, 1));
+
+  // views don't need a device, only the render data cache, which is set up with the core systems
+  ezView* pView = nullptr;
+  ezViewHandle hView = ezRenderWorld::CreateView("Extraction", pView);
+  EZ_SCOPE_EXIT(ezRenderWorld::DeleteView(hView));
+
+  pView->SetWorld(&world);
+  pView->SetCamera(&camera);
+
+  ezDynamicArray<const ezGameObject*> objects;
+  {
+    EZ_LOCK(world.GetReadMarker());
+
+    const ezWorld& constWorld = world;
+    for (auto it = constWorld.GetObjects(); it.IsValid(); ++it)
+    {
+      objects.PushBack(it);
+    }
+  }
+
+  ezVisibleObjectsExtractor extractor;
+  ezExtractedRenderData serialData;
+  ezExtractedRenderData parallelData;
+
+  auto Extract = [&](bool bMultithreading, ezExtractedRenderData& ref_data) -> ezTime
+  {
+    *pMultithreading = bMultithreading;
+
+    ref_data.Clear();
+    ref_data.SetCamera(camera);
+
+    ezStopwatch sw;
+    extractor.Extract(*pView, objects, ref_data);
+    return sw.GetRunningTotal();
+  };
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Serial vs. Parallel")
+  {
+    // warm up
+    Extract(false, serialData);
+
+    const ezUInt32 uiNumRuns = 5;
+    ezTime serialTime;
+    ezTime parallelTime;
+
+    for (ezUInt32 i = 0; i < uiNumRuns; ++i)
+    {
+      serialTime += Extract(false, serialData);
+      parallelTime += Extract(true, parallelData);
+    }
+
+    ezTestFramework::Output(ezTestOutput::Duration, "Extracting %u objects: serial %.2fms, parallel %.2fms (%u worker threads)", objects.GetCount(),
+      serialTime.GetMilliseconds() / uiNumRuns, parallelTime.GetMilliseconds() / uiNumRuns, ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks));
+
+    serialData.SortAndBatch();
+    parallelData.SortAndBatch();
+
+    // the chunks are merged in order, so the result has to be identical to the serial one, down to the order within each batch
+    ezUInt32 uiNumRenderData = 0;
+    EZ_TEST_INT(CompareExtractedRenderData(serialData, parallelData, uiNumRenderData), 0);
+
+    // 1 to 3 parts per object
+    EZ_TEST_INT(uiNumRenderData, objects.GetCount() * 2);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Other Camera")
+  {
+    // the chunks have to take over the camera of the target data, otherwise the sorting keys would differ
+    ezCamera otherCamera = camera;
+    otherCamera.LookAt(ezVec3(100, 0, 0), ezVec3::MakeZero(), ezVec3(0, 0, 1));
+
+    serialData.Clear();
+    serialData.SetCamera(otherCamera);
+    *pMultithreading = false;
+    extractor.Extract(*pView, objects, serialData);
+
+    parallelData.Clear();
+    parallelData.SetCamera(otherCamera);
+    *pMultithreading = true;
+    extractor.Extract(*pView, objects, parallelData);
+
+    serialData.SortAndBatch();
+    parallelData.SortAndBatch();
+
+    ezUInt32 uiNumRenderData = 0;
+    EZ_TEST_INT(CompareExtractedRenderData(serialData, parallelData, uiNumRenderData), 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Static Render Data Version")
+  {
+    // the cache is only filled at the end of a rendered frame, so nothing has been cached for this world yet
+    const ezUInt32 uiVersion = ezRenderWorld::GetStaticRenderDataVersion(&world);
+
+    for (const ezGameObject* pObject : objects)
+    {
+      if (pObject->IsStatic())
+      {
+        ezRenderWorld::DeleteCachedRenderData(pObject->GetHandle(), pObject->GetComponents()[0]->GetHandle());
+        break;
+      }
+    }
+
+    EZ_TEST_INT(ezRenderWorld::GetStaticRenderDataVersion(&world), uiVersion);
+
+    ezRenderWorld::DeleteAllCachedRenderData();
+    EZ_TEST_BOOL(ezRenderWorld::GetStaticRenderDataVersion(&world) != uiVersion);
+  }
+}
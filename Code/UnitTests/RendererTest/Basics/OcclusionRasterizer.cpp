@@ -0,0 +1,173 @@
+#include <RendererTest/RendererTestPCH.h>
+
+#include <Core/Graphics/Camera.h>
+#include <Foundation/Configuration/CVar.h>
+#include <Foundation/Math/Random.h>
+#include <Foundation/SimdMath/SimdBBox.h>
+#include <Foundation/SimdMath/SimdConversion.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <RendererCore/Rasterizer/RasterizerObject.h>
+#include <RendererCore/Rasterizer/RasterizerView.h>
+
+EZ_CREATE_SIMPLE_TEST_GROUP(Occlusion);
+
+EZ_CREATE_SIMPLE_TEST(Occlusion, RasterizerView)
+{
+#if EZ_ENABLED(EZ_RASTERIZER_SUPPORTED)
+  ezCVarBool* pMultithreading = static_cast<ezCVarBool*>(ezCVar::FindCVarByName("Spatial.Occlusion.Multithreading"));
+  ezCVarInt* pMaxOccluders = static_cast<ezCVarInt*>(ezCVar::FindCVarByName("Spatial.Occlusion.MaxOccluders"));
+
+  if (!EZ_TEST_BOOL(pMultithreading != nullptr && pMaxOccluders != nullptr))
+    return;
+
+  const bool bPrevMultithreading = *pMultithreading;
+  const int iPrevMaxOccluders = *pMaxOccluders;
+  EZ_SCOPE_EXIT(*pMultithreading = bPrevMultithreading; *pMaxOccluders = iPrevMaxOccluders;);
+
+  const ezUInt32 uiNumOccluders = 400;
+  const ezUInt32 uiNumQueries = 4000;
+  const ezUInt32 uiNumRuns = 10;
+
+  // The tiled path selects the closest occluders on screen up front, while the serial path skips occluders that are hidden by closer ones
+  // and doesn't count them. So only without a limit both paths rasterize the same occluders.
+  *pMaxOccluders = uiNumOccluders;
+
+  ezCamera camera;
+  camera.SetCameraMode(ezCameraMode::PerspectiveFixedFovX, 90.0f, 0.1f, 1000.0f);
+  camera.LookAt(ezVec3::MakeZero(), ezVec3(1, 0, 0), ezVec3(0, 0, 1));
+
+  ezRandom rng;
+  rng.Initialize(42);
+
+  struct OccluderInstance
+  {
+    ezSharedPtr<const ezRasterizerObject> m_pObject;
+    ezTransform m_Transform;
+  };
+
+  ezDynamicArray<OccluderInstance> occluders;
+  for (ezUInt32 i = 0; i < uiNumOccluders; ++i)
+  {
+    const ezVec3 vExtents(rng.FloatMinMax(0.5f, 2.0f), rng.FloatMinMax(1.0f, 8.0f), rng.FloatMinMax(1.0f, 8.0f));
+    const ezVec3 vPosition(rng.FloatMinMax(5.0f, 60.0f), rng.FloatMinMax(-40.0f, 40.0f), rng.FloatMinMax(-20.0f, 20.0f));
+
+    auto& occluder = occluders.ExpandAndGetRef();
+    occluder.m_pObject = ezRasterizerObject::CreateBox(vExtents);
+    occluder.m_Transform = ezTransform::Make(vPosition);
+  }
+
+  ezDynamicArray<ezSimdBBox> queries;
+  for (ezUInt32 i = 0; i < uiNumQueries; ++i)
+  {
+    const ezVec3 vHalfExtents(rng.FloatMinMax(0.1f, 1.0f), rng.FloatMinMax(0.1f, 1.0f), rng.FloatMinMax(0.1f, 1.0f));
+    const ezVec3 vCenter(rng.FloatMinMax(5.0f, 100.0f), rng.FloatMinMax(-60.0f, 60.0f), rng.FloatMinMax(-30.0f, 30.0f));
+
+    queries.PushBack(ezSimdBBox::MakeFromCenterAndHalfExtents(ezSimdConversion::ToVec3(vCenter), ezSimdConversion::ToVec3(vHalfExtents)));
+  }
+
+  ezRasterizerView view;
+  view.SetResolution(512, 256, 0.0f);
+  view.SetCamera(&camera);
+
+  auto Rasterize = [&](bool bMultithreading, ezDynamicArray<bool>& out_visible) -> ezTime
+  {
+    *pMultithreading = bMultithreading;
+
+    ezTime duration;
+    for (ezUInt32 uiRun = 0; uiRun < uiNumRuns; ++uiRun)
+    {
+      ezStopwatch sw;
+
+      view.BeginScene();
+
+      for (const OccluderInstance& occluder : occluders)
+      {
+        view.AddObject(occluder.m_pObject.Borrow(), occluder.m_Transform);
+      }
+
+      view.EndScene();
+
+      duration += sw.GetRunningTotal();
+    }
+
+    EZ_TEST_BOOL(view.HasRasterizedAnyOccluders());
+
+    out_visible.SetCount(uiNumQueries);
+    for (ezUInt32 i = 0; i < uiNumQueries; ++i)
+    {
+      out_visible[i] = view.IsVisible(queries[i]);
+    }
+
+    return duration / uiNumRuns;
+  };
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Serial vs. Tiled")
+  {
+    ezDynamicArray<bool> serialVisible;
+    ezDynamicArray<bool> tiledVisible;
+
+    const ezTime serialTime = Rasterize(false, serialVisible);
+    const ezTime tiledTime = Rasterize(true, tiledVisible);
+
+    const ezUInt32 uiNumWorkers = ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks);
+    ezTestFramework::Output(ezTestOutput::Duration, "Rasterizing %u occluders at %ux%u: serial %.3fms, tiled %.3fms (%u worker threads)", uiNumOccluders,
+      view.GetResolutionX(), view.GetResolutionY(), serialTime.GetMilliseconds(), tiledTime.GetMilliseconds(), uiNumWorkers);
+
+    if (uiNumWorkers <= 1)
+    {
+      ezTestFramework::Output(ezTestOutput::Details, "Only one worker thread, the tiled path falls back to serial rasterization.");
+    }
+
+    ezUInt32 uiNumMismatches = 0;
+    ezUInt32 uiNumOccluded = 0;
+
+    for (ezUInt32 i = 0; i < uiNumQueries; ++i)
+    {
+      if (serialVisible[i] != tiledVisible[i])
+        ++uiNumMismatches;
+
+      if (!serialVisible[i])
+        ++uiNumOccluded;
+    }
+
+    EZ_TEST_INT(uiNumMismatches, 0);
+
+    // make sure the scene actually tests something
+    EZ_TEST_BOOL(uiNumOccluded > 0);
+    EZ_TEST_BOOL(uiNumOccluded < uiNumQueries);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Occluder Limit")
+  {
+    const ezUInt32 uiMaxOccluders = 16;
+    *pMaxOccluders = uiMaxOccluders;
+
+    ezDynamicArray<bool> serialVisible;
+    ezDynamicArray<bool> tiledVisible;
+
+    Rasterize(false, serialVisible);
+    Rasterize(true, tiledVisible);
+
+    // The limit applies to the whole view, not to each strip. The occluders that the serial path rasterizes in addition to the tiled one are
+    // the ones that the tiled path selected, but that turned out to be hidden, so the tiled path can only ever occlude less.
+    ezUInt32 uiNumOnlyTiledOccluded = 0;
+    ezUInt32 uiNumSerialOccluded = 0;
+    ezUInt32 uiNumTiledOccluded = 0;
+
+    for (ezUInt32 i = 0; i < uiNumQueries; ++i)
+    {
+      if (!tiledVisible[i] && serialVisible[i])
+        ++uiNumOnlyTiledOccluded;
+
+      uiNumSerialOccluded += serialVisible[i] ? 0 : 1;
+      uiNumTiledOccluded += tiledVisible[i] ? 0 : 1;
+    }
+
+    ezTestFramework::Output(ezTestOutput::Details, "%u of %u occluders: serial occludes %u queries, tiled %u", uiMaxOccluders, uiNumOccluders, uiNumSerialOccluded, uiNumTiledOccluded);
+
+    EZ_TEST_INT(uiNumOnlyTiledOccluded, 0);
+    EZ_TEST_BOOL(uiNumTiledOccluded > 0);
+  }
+#endif
+}
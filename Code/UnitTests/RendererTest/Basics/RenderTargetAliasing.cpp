@@ -0,0 +1,142 @@
+#include <RendererTest/RendererTestPCH.h>
+
+#include <RendererCore/Pipeline/RenderTargetAliasing.h>
+
+EZ_CREATE_SIMPLE_TEST_GROUP(RenderPipeline);
+
+namespace
+{
+  ezRenderTargetAliasingPlanner::Target CreateAliasingTarget(ezUInt32 uiWidth, ezGALResourceFormat::Enum format, ezUInt16 uiFirst, ezUInt16 uiLast, ezUInt64 uiMemory = 100)
+  {
+    ezRenderTargetAliasingPlanner::Target target;
+    target.m_Desc.m_uiWidth = uiWidth;
+    target.m_Desc.m_uiHeight = uiWidth;
+    target.m_Desc.m_Format = format;
+    target.m_Desc.m_bCreateRenderTarget = true;
+    target.m_Desc.m_bAllowShaderResourceView = true;
+    target.m_uiMemorySize = uiMemory;
+    target.m_uiFirstUsageIdx = uiFirst;
+    target.m_uiLastUsageIdx = uiLast;
+    return target;
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(RenderPipeline, RenderTargetAliasing)
+{
+  ezRenderTargetAliasingPlanner planner;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Disjoint lifetimes")
+  {
+    ezDynamicArray<ezRenderTargetAliasingPlanner::Target> targets;
+    targets.PushBack(CreateAliasingTarget(256, ezGALResourceFormat::RGBAHalf, 0, 1));
+    targets.PushBack(CreateAliasingTarget(256, ezGALResourceFormat::RGBAHalf, 2, 3));
+    targets.PushBack(CreateAliasingTarget(256, ezGALResourceFormat::RGBAHalf, 4, 4));
+
+    planner.Plan(targets);
+
+    EZ_TEST_INT(planner.GetSlots().GetCount(), 1);
+    EZ_TEST_INT(planner.GetSlotForTarget(0), 0);
+    EZ_TEST_INT(planner.GetSlotForTarget(1), 0);
+    EZ_TEST_INT(planner.GetSlotForTarget(2), 0);
+    EZ_TEST_INT(planner.GetSlots()[0].m_uiFirstUsageIdx, 0);
+    EZ_TEST_INT(planner.GetSlots()[0].m_uiLastUsageIdx, 4);
+
+    EZ_TEST_INT(planner.GetPeakMemory(), 100);
+    EZ_TEST_INT(planner.GetPeakMemoryWithoutAliasing(), 100);
+    EZ_TEST_INT(planner.GetTotalMemoryWithoutAliasing(), 300);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Overlapping lifetimes")
+  {
+    ezDynamicArray<ezRenderTargetAliasingPlanner::Target> targets;
+    targets.PushBack(CreateAliasingTarget(256, ezGALResourceFormat::RGBAHalf, 0, 2));
+    targets.PushBack(CreateAliasingTarget(256, ezGALResourceFormat::RGBAHalf, 2, 3)); // the last usage of the first one is the same pass
+    targets.PushBack(CreateAliasingTarget(256, ezGALResourceFormat::RGBAHalf, 1, 5));
+    targets.PushBack(CreateAliasingTarget(256, ezGALResourceFormat::RGBAHalf, 4, 5));
+
+    planner.Plan(targets);
+
+    EZ_TEST_INT(planner.GetSlots().GetCount(), 3);
+    EZ_TEST_BOOL(planner.GetSlotForTarget(0) != planner.GetSlotForTarget(1));
+    EZ_TEST_BOOL(planner.GetSlotForTarget(0) != planner.GetSlotForTarget(2));
+    EZ_TEST_BOOL(planner.GetSlotForTarget(1) != planner.GetSlotForTarget(2));
+
+    // the fourth target can take the slot of the first or the second one, prefer the one that was released last
+    EZ_TEST_INT(planner.GetSlotForTarget(3), planner.GetSlotForTarget(1));
+
+    EZ_TEST_INT(planner.GetPeakMemory(), 300);
+    EZ_TEST_INT(planner.GetPeakMemoryWithoutAliasing(), 300);
+    EZ_TEST_INT(planner.GetTotalMemoryWithoutAliasing(), 400);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Usage flags are merged")
+  {
+    ezDynamicArray<ezRenderTargetAliasingPlanner::Target> targets;
+    targets.PushBack(CreateAliasingTarget(128, ezGALResourceFormat::RGBAUByteNormalized, 0, 0));
+    targets.PushBack(CreateAliasingTarget(128, ezGALResourceFormat::RGBAUByteNormalized, 1, 1));
+    targets[1].m_Desc.m_bAllowUAV = true;
+
+    EZ_TEST_BOOL(ezRenderTargetAliasingPlanner::AreDescriptionsCompatible(targets[0].m_Desc, targets[1].m_Desc));
+
+    planner.Plan(targets);
+
+    EZ_TEST_INT(planner.GetSlots().GetCount(), 1);
+    EZ_TEST_BOOL(planner.GetSlots()[0].m_Desc.m_bAllowUAV);
+    EZ_TEST_BOOL(planner.GetSlots()[0].m_Desc.m_bCreateRenderTarget);
+    EZ_TEST_BOOL(planner.GetSlots()[0].m_Desc.m_bAllowShaderResourceView);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Incompatible descriptions")
+  {
+    ezDynamicArray<ezRenderTargetAliasingPlanner::Target> targets;
+    targets.PushBack(CreateAliasingTarget(128, ezGALResourceFormat::RGBAUByteNormalized, 0, 0, 64));
+    targets.PushBack(CreateAliasingTarget(128, ezGALResourceFormat::RGBAHalf, 1, 1, 128));
+    targets.PushBack(CreateAliasingTarget(256, ezGALResourceFormat::RGBAUByteNormalized, 2, 2, 256));
+    targets.PushBack(CreateAliasingTarget(128, ezGALResourceFormat::RGBAUByteNormalized, 3, 3, 64));
+    targets[3].m_Desc.m_SampleCount = ezGALMSAASampleCount::FourSamples;
+
+    EZ_TEST_BOOL(!ezRenderTargetAliasingPlanner::AreDescriptionsCompatible(targets[0].m_Desc, targets[1].m_Desc));
+    EZ_TEST_BOOL(!ezRenderTargetAliasingPlanner::AreDescriptionsCompatible(targets[0].m_Desc, targets[2].m_Desc));
+    EZ_TEST_BOOL(!ezRenderTargetAliasingPlanner::AreDescriptionsCompatible(targets[0].m_Desc, targets[3].m_Desc));
+
+    planner.Plan(targets);
+
+    EZ_TEST_INT(planner.GetSlots().GetCount(), 4);
+
+    // the slots are still only alive during their own pass
+    EZ_TEST_INT(planner.GetPeakMemory(), 256);
+    EZ_TEST_INT(planner.GetTotalMemoryWithoutAliasing(), 512);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Typical pipeline")
+  {
+    // a simplified forward pipeline: depth pre-pass, opaque, bloom chain, tonemap
+    ezDynamicArray<ezRenderTargetAliasingPlanner::Target> targets;
+    targets.PushBack(CreateAliasingTarget(1024, ezGALResourceFormat::D24S8, 0, 2, 4));    // depth
+    targets.PushBack(CreateAliasingTarget(1024, ezGALResourceFormat::RGBAHalf, 1, 3, 8)); // scene color
+    targets.PushBack(CreateAliasingTarget(512, ezGALResourceFormat::RGBAHalf, 3, 4, 2));  // bloom down
+    targets.PushBack(CreateAliasingTarget(512, ezGALResourceFormat::RGBAHalf, 4, 5, 2));  // bloom blur
+    targets.PushBack(CreateAliasingTarget(512, ezGALResourceFormat::RGBAHalf, 5, 6, 2));  // bloom up
+    targets.PushBack(CreateAliasingTarget(1024, ezGALResourceFormat::RGBAHalf, 4, 6, 8)); // scene color with bloom, shares with scene color
+    targets.PushBack(CreateAliasingTarget(1024, ezGALResourceFormat::RGBAHalf, 7, 8, 8)); // tonemapped, shares with scene color
+
+    planner.Plan(targets);
+
+    EZ_TEST_INT(planner.GetSlotForTarget(6), planner.GetSlotForTarget(1));
+    EZ_TEST_INT(planner.GetSlotForTarget(4), planner.GetSlotForTarget(2));
+    EZ_TEST_INT(planner.GetSlotForTarget(5), planner.GetSlotForTarget(1));
+    EZ_TEST_INT(planner.GetSlots().GetCount(), 4);
+
+    EZ_TEST_INT(planner.GetTotalMemoryWithoutAliasing(), 34);
+    EZ_TEST_INT(planner.GetPeakMemoryWithoutAliasing(), 12);
+    EZ_TEST_INT(planner.GetPeakMemory(), 12);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Clear")
+  {
+    planner.Clear();
+
+    EZ_TEST_BOOL(planner.GetSlots().IsEmpty());
+    EZ_TEST_INT(planner.GetPeakMemory(), 0);
+  }
+}
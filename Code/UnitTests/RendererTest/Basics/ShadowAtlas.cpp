@@ -0,0 +1,139 @@
+#include <RendererTest/RendererTestPCH.h>
+
+#include <RendererCore/Lights/ShadowAtlas.h>
+
+EZ_CREATE_SIMPLE_TEST_GROUP(Shadows);
+
+EZ_CREATE_SIMPLE_TEST(Shadows, ShadowAtlas)
+{
+  ezShadowAtlasAllocator allocator;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Allocate")
+  {
+    allocator.Reset(1024);
+    EZ_TEST_INT(allocator.GetAtlasSize(), 1024);
+
+    ezHybridArray<ezRectU32, 4> rects;
+    for (ezUInt32 i = 0; i < 4; ++i)
+    {
+      ezRectU32 rect = allocator.Allocate(512);
+      EZ_TEST_INT(rect.width, 512);
+      EZ_TEST_INT(rect.height, 512);
+
+      for (const ezRectU32& otherRect : rects)
+      {
+        EZ_TEST_BOOL(!rect.Overlaps(otherRect));
+      }
+
+      rects.PushBack(rect);
+    }
+
+    // full
+    EZ_TEST_BOOL(!allocator.Allocate(512).HasNonZeroArea());
+    EZ_TEST_BOOL(!allocator.Allocate(64).HasNonZeroArea());
+
+    allocator.Reset(1024);
+    EZ_TEST_BOOL(!allocator.Allocate(2048).HasNonZeroArea());
+    EZ_TEST_BOOL(allocator.Allocate(1024) == ezRectU32(0, 0, 1024, 1024));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "AllocateAt")
+  {
+    allocator.Reset(1024);
+    const ezRectU32 rect0 = allocator.Allocate(256);
+    const ezRectU32 rect1 = allocator.Allocate(128);
+    const ezRectU32 rect2 = allocator.Allocate(512);
+
+    // the same rects can be claimed again in a different order, as it happens when the placement of the last frame is restored
+    allocator.Reset(1024);
+    EZ_TEST_BOOL(allocator.AllocateAt(rect2));
+    EZ_TEST_BOOL(allocator.AllocateAt(rect1));
+    EZ_TEST_BOOL(allocator.AllocateAt(rect0));
+
+    // already used
+    EZ_TEST_BOOL(!allocator.AllocateAt(rect0));
+    EZ_TEST_BOOL(!allocator.AllocateAt(ezRectU32(rect2.x, rect2.y, 256, 256)));
+    EZ_TEST_BOOL(!allocator.AllocateAt(ezRectU32(0, 0, 1024, 1024)));
+
+    // not aligned to the quadtree or outside of the atlas
+    EZ_TEST_BOOL(!allocator.AllocateAt(ezRectU32(0, 0, 0, 0)));
+    EZ_TEST_BOOL(!allocator.AllocateAt(ezRectU32(768, 768, 128, 64)));
+    EZ_TEST_BOOL(!allocator.AllocateAt(ezRectU32(832, 768, 128, 128)));
+    EZ_TEST_BOOL(!allocator.AllocateAt(ezRectU32(1024, 0, 128, 128)));
+
+    // new allocations don't overlap the claimed rects
+    for (ezUInt32 i = 0; i < 8; ++i)
+    {
+      ezRectU32 rect = allocator.Allocate(128);
+      if (!rect.HasNonZeroArea())
+        break;
+
+      EZ_TEST_BOOL(!rect.Overlaps(rect0));
+      EZ_TEST_BOOL(!rect.Overlaps(rect1));
+      EZ_TEST_BOOL(!rect.Overlaps(rect2));
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Stable Placement")
+  {
+    // a light that needs a different size doesn't displace the others
+    allocator.Reset(2048);
+    const ezRectU32 rectA = allocator.Allocate(1024);
+    allocator.Allocate(512);
+    const ezRectU32 rectC = allocator.Allocate(512);
+
+    allocator.Reset(2048);
+    EZ_TEST_BOOL(allocator.AllocateAt(rectC));
+    EZ_TEST_BOOL(allocator.AllocateAt(rectA));
+    const ezRectU32 rectB2 = allocator.Allocate(256);
+    EZ_TEST_BOOL(rectB2.HasNonZeroArea());
+    EZ_TEST_BOOL(!rectB2.Overlaps(rectA));
+    EZ_TEST_BOOL(!rectB2.Overlaps(rectC));
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(Shadows, ShadowViewCache)
+{
+  using Mode = ezShadowViewCache::Mode;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Update")
+  {
+    ezShadowViewCache viewCache;
+
+    // the cache is only filled once the signature did not change for one frame
+    EZ_TEST_BOOL(viewCache.Update(1) == Mode::RenderAll);
+    EZ_TEST_BOOL(viewCache.Update(1) == Mode::RenderAllAndFillCache);
+    EZ_TEST_BOOL(viewCache.Update(1) == Mode::UseCache);
+    EZ_TEST_BOOL(viewCache.Update(1) == Mode::UseCache);
+
+    // any change renders everything again
+    EZ_TEST_BOOL(viewCache.Update(2) == Mode::RenderAll);
+    EZ_TEST_BOOL(viewCache.Update(1) == Mode::RenderAll);
+    EZ_TEST_BOOL(viewCache.Update(1) == Mode::RenderAllAndFillCache);
+    EZ_TEST_BOOL(viewCache.Update(1) == Mode::UseCache);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Constantly changing")
+  {
+    ezShadowViewCache viewCache;
+
+    // e.g. the cascades of a moving camera never pay for filling the cache
+    for (ezUInt64 i = 1; i < 10; ++i)
+    {
+      EZ_TEST_BOOL(viewCache.Update(i) == Mode::RenderAll);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Invalidate")
+  {
+    ezShadowViewCache viewCache;
+    viewCache.Update(5);
+    viewCache.Update(5);
+    EZ_TEST_BOOL(viewCache.Update(5) == Mode::UseCache);
+
+    // e.g. the shadow map lost its atlas location, the same signature fills the cache again right away
+    viewCache.Invalidate();
+    EZ_TEST_BOOL(viewCache.Update(5) == Mode::RenderAllAndFillCache);
+    EZ_TEST_BOOL(viewCache.Update(5) == Mode::UseCache);
+  }
+}